@@ -0,0 +1,194 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// @file DelphesO2LutAccumulator.h
+/// @brief Accumulation of the LUT cells of the DelphesO2 track smearer from the full simulation.
+///        The mean covariance matrix of the reconstructed tracks and the efficiency are accumulated per
+///        (nch, radius, eta, pt) cell, with a running (Welford) mean which does not lose precision over
+///        many tracks, and the LUT is written in the binary format read by TrackSmearer::loadTable,
+///        with the eigen decomposition of the covariance matrix computed as in DelphesO2/src/lutWrite.cc.
+///        Accumulators filled in parallel can be combined with merge().
+///
+
+#ifndef ALICE3_CORE_DELPHESO2LUTACCUMULATOR_H_
+#define ALICE3_CORE_DELPHESO2LUTACCUMULATOR_H_
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "TMatrixD.h"
+#include "TMatrixDSym.h"
+#include "TMatrixDSymEigen.h"
+#include "TVectorD.h"
+
+#include "ALICE3/Core/DelphesO2TrackSmearer.h"
+
+namespace o2
+{
+namespace delphes
+{
+
+class LutAccumulator
+{
+ public:
+  /// Sets the header of the LUT and empties the cells
+  void init(int pdg, float mass, float field, const map_t& nchmap, const map_t& radmap, const map_t& etamap, const map_t& ptmap)
+  {
+    mHeader = lutHeader_t{};
+    mHeader.pdg = pdg;
+    mHeader.mass = mass;
+    mHeader.field = field;
+    mHeader.nchmap = nchmap;
+    mHeader.radmap = radmap;
+    mHeader.etamap = etamap;
+    mHeader.ptmap = ptmap;
+    mCells.assign(static_cast<std::size_t>(nchmap.nbins) * radmap.nbins * etamap.nbins * ptmap.nbins, Cell{});
+  }
+
+  /// Adds the covariance matrix of a reconstructed track, in the 15 elements order of o2::track::TrackParCov
+  void fillCovariance(float nch, float radius, float eta, float pt, const std::array<float, 15>& covm)
+  {
+    auto& cell = getCell(nch, radius, eta, pt);
+    cell.nTracks++;
+    for (int i = 0; i < 15; ++i) {
+      cell.covm[i] += (covm[i] - cell.covm[i]) / cell.nTracks;
+    }
+  }
+
+  /// Counts a generated particle for the efficiency
+  void fillEfficiency(float nch, float radius, float eta, float pt, bool isReconstructed)
+  {
+    auto& cell = getCell(nch, radius, eta, pt);
+    cell.nGenerated++;
+    if (isReconstructed) {
+      cell.nReconstructed++;
+    }
+  }
+
+  /// Adds the cells of another accumulator with the same binning
+  void merge(const LutAccumulator& other)
+  {
+    if (other.mCells.size() != mCells.size()) {
+      std::cout << " --- cannot merge LUT accumulators with different binnings" << std::endl;
+      return;
+    }
+    for (std::size_t iCell = 0; iCell < mCells.size(); ++iCell) {
+      auto& cell = mCells[iCell];
+      const auto& otherCell = other.mCells[iCell];
+      const int64_t nTracks = cell.nTracks + otherCell.nTracks;
+      if (nTracks > 0) {
+        for (int i = 0; i < 15; ++i) {
+          cell.covm[i] += (otherCell.covm[i] - cell.covm[i]) * otherCell.nTracks / nTracks;
+        }
+      }
+      cell.nTracks = nTracks;
+      cell.nGenerated += otherCell.nGenerated;
+      cell.nReconstructed += otherCell.nReconstructed;
+    }
+  }
+
+  /// Writes the LUT, with the entries in the (nch, radius, eta, pt) order of TrackSmearer::getEntry
+  bool write(const char* filename)
+  {
+    std::ofstream lutFile(filename, std::ofstream::binary);
+    if (!lutFile.is_open()) {
+      std::cout << " --- cannot open covariance matrix file for writing: " << filename << std::endl;
+      return false;
+    }
+    lutFile.write(reinterpret_cast<char*>(&mHeader), sizeof(lutHeader_t));
+    lutEntry_t entry;
+    std::size_t iCell = 0;
+    for (int inch = 0; inch < mHeader.nchmap.nbins; ++inch) {
+      for (int irad = 0; irad < mHeader.radmap.nbins; ++irad) {
+        for (int ieta = 0; ieta < mHeader.etamap.nbins; ++ieta) {
+          for (int ipt = 0; ipt < mHeader.ptmap.nbins; ++ipt) {
+            fillEntry(mCells[iCell++], entry);
+            entry.nch = mHeader.nchmap.eval(inch);
+            entry.eta = mHeader.etamap.eval(ieta);
+            entry.pt = mHeader.ptmap.eval(ipt);
+            lutFile.write(reinterpret_cast<char*>(&entry), sizeof(lutEntry_t));
+          }
+        }
+      }
+    }
+    if (!lutFile.good()) {
+      std::cout << " --- troubles writing covariance matrix file: " << filename << std::endl;
+      return false;
+    }
+    std::cout << " --- written covariance matrix table for PDG " << mHeader.pdg << ": " << filename << std::endl;
+    mHeader.print();
+    return true;
+  }
+
+ private:
+  struct Cell {
+    int64_t nTracks = 0;                // reconstructed tracks with their covariance matrix
+    int64_t nGenerated = 0;             // generated particles for the efficiency
+    int64_t nReconstructed = 0;         // reconstructed generated particles
+    std::array<double, 15> covm = {0.}; // running mean of the covariance matrix
+  };
+
+  Cell& getCell(float nch, float radius, float eta, float pt)
+  {
+    const int inch = mHeader.nchmap.find(nch);
+    const int irad = mHeader.radmap.find(radius);
+    const int ieta = mHeader.etamap.find(eta);
+    const int ipt = mHeader.ptmap.find(pt);
+    return mCells[((static_cast<std::size_t>(inch) * mHeader.radmap.nbins + irad) * mHeader.etamap.nbins + ieta) * mHeader.ptmap.nbins + ipt];
+  }
+
+  /// Fills the efficiency, the covariance matrix and its eigen decomposition of an entry
+  static void fillEntry(const Cell& cell, lutEntry_t& entry)
+  {
+    entry = lutEntry_t{};
+    entry.eff = cell.nGenerated > 0 ? static_cast<float>(cell.nReconstructed) / cell.nGenerated : 0.f;
+    entry.eff2 = entry.eff;
+    entry.valid = cell.nTracks > 0;
+    if (!entry.valid) {
+      return;
+    }
+    TMatrixDSym m(5);
+    for (int i = 0, k = 0; i < 5; ++i) {
+      for (int j = 0; j < i + 1; ++j, ++k) {
+        entry.covm[k] = cell.covm[k];
+        m(i, j) = cell.covm[k];
+        m(j, i) = cell.covm[k];
+      }
+    }
+    TMatrixDSymEigen eigen(m);
+    const TVectorD eigenVal = eigen.GetEigenValues();
+    TMatrixD eigenVec = eigen.GetEigenVectors();
+    for (int i = 0; i < 5; ++i) {
+      entry.eigval[i] = eigenVal[i];
+      for (int j = 0; j < 5; ++j) {
+        entry.eigvec[i][j] = eigenVec[i][j];
+      }
+    }
+    eigenVec.Invert();
+    for (int i = 0; i < 5; ++i) {
+      for (int j = 0; j < 5; ++j) {
+        entry.eiginv[i][j] = eigenVec[i][j];
+      }
+    }
+  }
+
+  lutHeader_t mHeader;
+  std::vector<Cell> mCells; // cells in the (nch, radius, eta, pt) order of the entries
+};
+
+} // namespace delphes
+} // namespace o2
+
+#endif // ALICE3_CORE_DELPHESO2LUTACCUMULATOR_H_
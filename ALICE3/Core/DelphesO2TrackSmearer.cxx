@@ -34,6 +34,11 @@
 // #include <iostream>
 // #include <fstream>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "ALICE3/Core/DelphesO2TrackSmearer.h"
 
 namespace o2
@@ -50,7 +55,10 @@ bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
     std::cout << " --- LUT table for PDG " << pdg << " has been already loaded with index " << ipdg << std::endl;
     return false;
   }
+  delete mLUTHeader[ipdg];
   mLUTHeader[ipdg] = new lutHeader_t;
+  mLUTEntry[ipdg] = nullptr;
+  mLUTMapping[ipdg].reset();
 
   std::ifstream lutFile(filename, std::ifstream::binary);
   if (!lutFile.is_open()) {
@@ -82,28 +90,37 @@ bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
   const int nrad = mLUTHeader[ipdg]->radmap.nbins;
   const int neta = mLUTHeader[ipdg]->etamap.nbins;
   const int npt = mLUTHeader[ipdg]->ptmap.nbins;
-  mLUTEntry[ipdg] = new lutEntry_t****[nnch];
-  for (int inch = 0; inch < nnch; ++inch) {
-    mLUTEntry[ipdg][inch] = new lutEntry_t***[nrad];
-    for (int irad = 0; irad < nrad; ++irad) {
-      mLUTEntry[ipdg][inch][irad] = new lutEntry_t**[neta];
-      for (int ieta = 0; ieta < neta; ++ieta) {
-        mLUTEntry[ipdg][inch][irad][ieta] = new lutEntry_t*[npt];
-        for (int ipt = 0; ipt < npt; ++ipt) {
-          mLUTEntry[ipdg][inch][irad][ieta][ipt] = new lutEntry_t;
-          lutFile.read(reinterpret_cast<char*>(mLUTEntry[ipdg][inch][irad][ieta][ipt]), sizeof(lutEntry_t));
-          if (lutFile.gcount() != sizeof(lutEntry_t)) {
-            std::cout << " --- troubles reading covariance matrix entry for PDG " << pdg << ": " << filename << std::endl;
-            return false;
-          }
-        }
-      }
+  lutFile.close();
+
+  // the entries are stored one after the other after the header, in the order of getEntry:
+  // they are mapped instead of read, so that the devices of a node using the same LUT share one copy in memory
+  static_assert(sizeof(lutHeader_t) % alignof(lutEntry_t) == 0, "LUT entries would not be aligned in the mapped file");
+  const std::size_t nEntries = static_cast<std::size_t>(nnch) * nrad * neta * npt;
+  const std::size_t mappedSize = sizeof(lutHeader_t) + nEntries * sizeof(lutEntry_t);
+  const int fd = open(filename, O_RDONLY);
+  struct stat fileStat;
+  if (fd < 0 || fstat(fd, &fileStat) != 0 || static_cast<std::size_t>(fileStat.st_size) < mappedSize) {
+    std::cout << " --- troubles reading covariance matrix entries for PDG " << pdg << ": " << filename << std::endl;
+    if (fd >= 0) {
+      close(fd);
     }
+    delete mLUTHeader[ipdg];
+    mLUTHeader[ipdg] = nullptr;
+    return false;
+  }
+  void* mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    std::cout << " --- cannot map covariance matrix file for PDG " << pdg << ": " << filename << std::endl;
+    delete mLUTHeader[ipdg];
+    mLUTHeader[ipdg] = nullptr;
+    return false;
   }
+  mLUTMapping[ipdg].reset(mapping, [mappedSize](void* p) { munmap(p, mappedSize); });
+  mLUTEntry[ipdg] = reinterpret_cast<lutEntry_t*>(static_cast<char*>(mapping) + sizeof(lutHeader_t));
   std::cout << " --- read covariance matrix table for PDG " << pdg << ": " << filename << std::endl;
   mLUTHeader[ipdg]->print();
 
-  lutFile.close();
   return true;
 }
 
@@ -126,42 +143,42 @@ lutEntry_t*
     if (fraction > 0.5) {
       if (mWhatEfficiency == 1) {
         if (inch < mLUTHeader[ipdg]->nchmap.nbins - 1) {
-          interpolatedEff = (1.5f - fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff + (-0.5f + fraction) * mLUTEntry[ipdg][inch + 1][irad][ieta][ipt]->eff;
+          interpolatedEff = (1.5f - fraction) * getEntry(ipdg, inch, irad, ieta, ipt)->eff + (-0.5f + fraction) * getEntry(ipdg, inch + 1, irad, ieta, ipt)->eff;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+          interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff;
         }
       }
       if (mWhatEfficiency == 2) {
         if (inch < mLUTHeader[ipdg]->nchmap.nbins - 1) {
-          interpolatedEff = (1.5f - fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2 + (-0.5f + fraction) * mLUTEntry[ipdg][inch + 1][irad][ieta][ipt]->eff2;
+          interpolatedEff = (1.5f - fraction) * getEntry(ipdg, inch, irad, ieta, ipt)->eff2 + (-0.5f + fraction) * getEntry(ipdg, inch + 1, irad, ieta, ipt)->eff2;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+          interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff2;
         }
       }
     } else {
       float comparisonValue = mLUTHeader[ipdg]->nchmap.log ? log10(nch) : nch;
       if (mWhatEfficiency == 1) {
         if (inch > 0 && comparisonValue < mLUTHeader[ipdg]->nchmap.max) {
-          interpolatedEff = (0.5f + fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff + (0.5f - fraction) * mLUTEntry[ipdg][inch - 1][irad][ieta][ipt]->eff;
+          interpolatedEff = (0.5f + fraction) * getEntry(ipdg, inch, irad, ieta, ipt)->eff + (0.5f - fraction) * getEntry(ipdg, inch - 1, irad, ieta, ipt)->eff;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+          interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff;
         }
       }
       if (mWhatEfficiency == 2) {
         if (inch > 0 && comparisonValue < mLUTHeader[ipdg]->nchmap.max) {
-          interpolatedEff = (0.5f + fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2 + (0.5f - fraction) * mLUTEntry[ipdg][inch - 1][irad][ieta][ipt]->eff2;
+          interpolatedEff = (0.5f + fraction) * getEntry(ipdg, inch, irad, ieta, ipt)->eff2 + (0.5f - fraction) * getEntry(ipdg, inch - 1, irad, ieta, ipt)->eff2;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+          interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff2;
         }
       }
     }
   } else {
     if (mWhatEfficiency == 1)
-      interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+      interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff;
     if (mWhatEfficiency == 2)
-      interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+      interpolatedEff = getEntry(ipdg, inch, irad, ieta, ipt)->eff2;
   }
-  return mLUTEntry[ipdg][inch][irad][ieta][ipt];
+  return getEntry(ipdg, inch, irad, ieta, ipt);
 } //;
 
 /*****************************************************************/
@@ -27,6 +27,7 @@
 #include <map>
 #include <iostream>
 #include <fstream>
+#include <memory>
 
 #include "TRandom.h"
 #include "ReconstructionDataFormats/Track.h"
@@ -222,7 +223,16 @@ class TrackSmearer
  protected:
   static constexpr unsigned int nLUTs = 8; // Number of LUT available
   lutHeader_t* mLUTHeader[nLUTs] = {nullptr};
-  lutEntry_t***** mLUTEntry[nLUTs] = {nullptr};
+  lutEntry_t* mLUTEntry[nLUTs] = {nullptr}; // entries of each LUT, contiguous in the (nch, radius, eta, pt) order of the LUT file
+  std::shared_ptr<void> mLUTMapping[nLUTs];  // copy-on-write mapping of each LUT file, holding the entries; its pages are shared by all the processes mapping the file
+
+  /// entry of the LUT at the given bins
+  lutEntry_t* getEntry(int ipdg, int inch, int irad, int ieta, int ipt)
+  {
+    const lutHeader_t* header = mLUTHeader[ipdg];
+    return &mLUTEntry[ipdg][((inch * header->radmap.nbins + irad) * header->etamap.nbins + ieta) * header->ptmap.nbins + ipt];
+  }
+
   bool mUseEfficiency = true;
   bool mInterpolateEfficiency = false;
   bool mSkipUnreconstructed = true; // don't smear tracks that are not reco'ed
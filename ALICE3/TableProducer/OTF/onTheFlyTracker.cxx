@@ -81,6 +81,7 @@ struct OnTheFlyTracker {
 
   Configurable<bool> processUnreconstructedTracks{"processUnreconstructedTracks", false, "process (smear) unreco-ed tracks"};
   Configurable<bool> doExtraQA{"doExtraQA", false, "do extra 2D QA plots"};
+  Configurable<int> seedPerEvent{"seedPerEvent", -1, "if >= 0, reseed the random generator for each MC collision from this seed and the MC collision index, for results independent of the data frame splitting"};
   Configurable<bool> extraQAwithoutDecayDaughters{"extraQAwithoutDecayDaughters", false, "remove decay daughters from qa plots (yes/no)"};
 
   Configurable<std::string> lutEl{"lutEl", "lutCovm.el.dat", "LUT for electrons"};
@@ -263,6 +264,12 @@ struct OnTheFlyTracker {
     new (&o2track)(o2::track::TrackParCov)(x, particle.phi(), params, covm);
   }
 
+  /// \return the seed of the random generator for an MC collision, never 0 as TRandom3 then seeds from the time
+  static ULong_t getEventSeed(int seed, int64_t mcCollisionIndex)
+  {
+    return static_cast<ULong_t>(seed) * 1000003UL + static_cast<ULong_t>(mcCollisionIndex) + 1UL;
+  }
+
   float dNdEta = 0.f; // Charged particle multiplicity to use in the efficiency evaluation
   void process(aod::McCollision const& mcCollision, aod::McParticles const& mcParticles)
   {
@@ -273,6 +280,11 @@ struct OnTheFlyTracker {
     o2::dataformats::DCA dcaInfo;
     o2::dataformats::VertexBase vtx;
 
+    if (seedPerEvent >= 0) {
+      // gRandom is used by the interaction sampler, the smearer and the track times
+      gRandom->SetSeed(getEventSeed(seedPerEvent, mcCollision.globalIndex()));
+    }
+
     // generate collision time
     auto ir = irSampler.generateCollisionTime();
 
@@ -23,6 +23,7 @@
 #include <map>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 #include "Framework/runDataProcessing.h"
 #include "Framework/RunningWorkflowInfo.h"
@@ -217,6 +218,7 @@ struct alice3decayFinder {
   Configurable<bool> doDCAplotsLc{"doDCAplotsLc", true, "do daughter prong DCA plots for Lc baryons"};
   Configurable<bool> mcSameMotherCheck{"mcSameMotherCheck", true, "check if tracks come from the same MC mother"};
   Configurable<float> dcaDaughtersSelection{"dcaDaughtersSelection", 1000.0f, "DCA between daughters (cm)"};
+  Configurable<float> massWindowPrefit{"massWindowPrefit", -1.0f, "if > 0, max distance of the invariant mass from the prong momenta at the DCA to the D/Lc mass, checked before the vertex fit (GeV/c^{2})"};
 
   Configurable<float> piFromD_dcaXYconstant{"piFromD_dcaXYconstant", -1.0f, "[0] in |DCAxy| > [0]+[1]/pT"};
   Configurable<float> piFromD_dcaXYpTdep{"piFromD_dcaXYpTdep", 0.0, "[1] in |DCAxy| > [0]+[1]/pT"};
@@ -298,17 +300,41 @@ struct alice3decayFinder {
     float eta;
   } lcbaryon;
 
-  template <typename TTrackType>
-  bool buildDecayCandidateTwoBody(TTrackType const& posTrackRow, TTrackType const& negTrackRow, float posMass, float negMass)
+  // prong of the candidates, with its parametrisation built once per collision instead of once per combination
+  struct Prong {
+    o2::track::TrackParCov trackParCov;
+    std::array<float, 3> pVec; // momentum at the DCA to the primary vertex
+  };
+  std::vector<Prong> prongsPos, prongsNeg, prongsThird;
+
+  template <typename TTracks>
+  void fillProngs(TTracks const& tracks, std::vector<Prong>& prongs)
+  {
+    prongs.clear();
+    prongs.reserve(tracks.size());
+    for (auto const& track : tracks) {
+      auto& prong = prongs.emplace_back(Prong{getTrackParCov(track), {}});
+      prong.trackParCov.getPxPyPzGlo(prong.pVec);
+    }
+  }
+
+  /// \return whether the invariant mass from the prong momenta at the DCA is too far from the mother mass to be worth fitting
+  template <typename TMomenta, typename TMasses>
+  bool rejectPrefit(TMomenta const& pVecs, TMasses const& masses, double motherMass)
   {
-    o2::track::TrackParCov posTrack = getTrackParCov(posTrackRow);
-    o2::track::TrackParCov negTrack = getTrackParCov(negTrackRow);
+    return massWindowPrefit > 0.f && std::abs(RecoDecay::m(pVecs, masses) - motherMass) > massWindowPrefit;
+  }
+
+  bool buildDecayCandidateTwoBody(Prong const& posProng, Prong const& negProng, float posMass, float negMass)
+  {
+    o2::track::TrackParCov posTrack;
+    o2::track::TrackParCov negTrack;
 
     //}-{}-{}-{}-{}-{}-{}-{}-{}-{}
     // Move close to minima
     int nCand = 0;
     try {
-      nCand = fitter.process(posTrack, negTrack);
+      nCand = fitter.process(posProng.trackParCov, negProng.trackParCov);
     } catch (...) {
       return false;
     }
@@ -335,18 +361,17 @@ struct alice3decayFinder {
     return true;
   }
 
-  template <typename TTrackType>
-  bool buildDecayCandidateThreeBody(TTrackType const& prong0, TTrackType const& prong1, TTrackType const& prong2, float p0mass, float p1mass, float p2mass)
+  bool buildDecayCandidateThreeBody(Prong const& prong0, Prong const& prong1, Prong const& prong2, float p0mass, float p1mass, float p2mass)
   {
-    o2::track::TrackParCov t0 = getTrackParCov(prong0);
-    o2::track::TrackParCov t1 = getTrackParCov(prong1);
-    o2::track::TrackParCov t2 = getTrackParCov(prong2);
+    o2::track::TrackParCov t0;
+    o2::track::TrackParCov t1;
+    o2::track::TrackParCov t2;
 
     //}-{}-{}-{}-{}-{}-{}-{}-{}-{}
     // Move close to minima
     int nCand = 0;
     try {
-      nCand = fitter3.process(t0, t1, t2);
+      nCand = fitter3.process(prong0.trackParCov, prong1.trackParCov, prong2.trackParCov);
     } catch (...) {
       return false;
     }
@@ -355,9 +380,9 @@ struct alice3decayFinder {
     }
     //}-{}-{}-{}-{}-{}-{}-{}-{}-{}
 
-    t0 = fitter.getTrack(0);
-    t1 = fitter.getTrack(1);
-    t2 = fitter.getTrack(2);
+    t0 = fitter3.getTrack(0);
+    t1 = fitter3.getTrack(1);
+    t2 = fitter3.getTrack(2);
     std::array<float, 3> P0;
     std::array<float, 3> P1;
     std::array<float, 3> P2;
@@ -499,22 +524,38 @@ struct alice3decayFinder {
     }
 
     // D mesons
+    fillProngs(tracksPiPlusFromDgrouped, prongsPos);
+    fillProngs(tracksKaMinusFromDgrouped, prongsNeg);
+    size_t iPos = 0;
     for (auto const& posTrackRow : tracksPiPlusFromDgrouped) {
+      auto const& posProng = prongsPos[iPos++];
+      size_t iNeg = 0;
       for (auto const& negTrackRow : tracksKaMinusFromDgrouped) {
+        auto const& negProng = prongsNeg[iNeg++];
+        if (rejectPrefit(array{posProng.pVec, negProng.pVec}, array{o2::constants::physics::MassPionCharged, o2::constants::physics::MassKaonCharged}, o2::constants::physics::MassD0))
+          continue;
         if (mcSameMotherCheck && !checkSameMother(posTrackRow, negTrackRow))
           continue;
-        if (!buildDecayCandidateTwoBody(posTrackRow, negTrackRow, o2::constants::physics::MassPionCharged, o2::constants::physics::MassKaonCharged))
+        if (!buildDecayCandidateTwoBody(posProng, negProng, o2::constants::physics::MassPionCharged, o2::constants::physics::MassKaonCharged))
           continue;
         histos.fill(HIST("hMassD"), dmeson.mass);
         histos.fill(HIST("h3dRecD"), dmeson.pt, dmeson.eta, dmeson.mass);
       }
     }
     // D mesons
+    fillProngs(tracksKaPlusFromDgrouped, prongsPos);
+    fillProngs(tracksPiMinusFromDgrouped, prongsNeg);
+    iPos = 0;
     for (auto const& posTrackRow : tracksKaPlusFromDgrouped) {
+      auto const& posProng = prongsPos[iPos++];
+      size_t iNeg = 0;
       for (auto const& negTrackRow : tracksPiMinusFromDgrouped) {
+        auto const& negProng = prongsNeg[iNeg++];
+        if (rejectPrefit(array{posProng.pVec, negProng.pVec}, array{o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged}, o2::constants::physics::MassD0))
+          continue;
         if (mcSameMotherCheck && !checkSameMother(posTrackRow, negTrackRow))
           continue;
-        if (!buildDecayCandidateTwoBody(posTrackRow, negTrackRow, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged))
+        if (!buildDecayCandidateTwoBody(posProng, negProng, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged))
           continue;
         histos.fill(HIST("hMassDbar"), dmeson.mass);
         histos.fill(HIST("h3dRecDbar"), dmeson.pt, dmeson.eta, dmeson.mass);
@@ -551,14 +592,25 @@ struct alice3decayFinder {
     }
 
     // Lc+ baryons +4122 -> +2212 -321 +211
+    fillProngs(tracksPrPlusFromLcgrouped, prongsPos);
+    fillProngs(tracksPiPlusFromLcgrouped, prongsThird);
+    fillProngs(tracksKaMinusFromLcgrouped, prongsNeg);
+    size_t iProton = 0;
     for (auto const& proton : tracksPrPlusFromLcgrouped) {
+      auto const& protonProng = prongsPos[iProton++];
+      size_t iPion = 0;
       for (auto const& pion : tracksPiPlusFromLcgrouped) {
+        auto const& pionProng = prongsThird[iPion++];
         if (pion.globalIndex() == proton.globalIndex())
           continue; // avoid self
+        size_t iKaon = 0;
         for (auto const& kaon : tracksKaMinusFromLcgrouped) {
+          auto const& kaonProng = prongsNeg[iKaon++];
+          if (rejectPrefit(array{protonProng.pVec, kaonProng.pVec, pionProng.pVec}, array{o2::constants::physics::MassProton, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged}, o2::constants::physics::MassLambdaCPlus))
+            continue;
           if (mcSameMotherCheck && (!checkSameMother(proton, kaon) || !checkSameMother(proton, pion)))
             continue;
-          if (!buildDecayCandidateThreeBody(proton, kaon, pion, o2::constants::physics::MassProton, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged))
+          if (!buildDecayCandidateThreeBody(protonProng, kaonProng, pionProng, o2::constants::physics::MassProton, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged))
             continue;
           histos.fill(HIST("hMassLc"), lcbaryon.mass);
           histos.fill(HIST("h3dRecLc"), lcbaryon.pt, lcbaryon.eta, lcbaryon.mass);
@@ -566,14 +618,25 @@ struct alice3decayFinder {
       }
     }
     // Lc- baryons -4122 -> -2212 +321 -211
+    fillProngs(tracksPrMinusFromLcgrouped, prongsPos);
+    fillProngs(tracksPiMinusFromLcgrouped, prongsThird);
+    fillProngs(tracksKaPlusFromLcgrouped, prongsNeg);
+    iProton = 0;
     for (auto const& proton : tracksPrMinusFromLcgrouped) {
+      auto const& protonProng = prongsPos[iProton++];
+      size_t iPion = 0;
       for (auto const& pion : tracksPiMinusFromLcgrouped) {
+        auto const& pionProng = prongsThird[iPion++];
         if (pion.globalIndex() == proton.globalIndex())
           continue; // avoid self
+        size_t iKaon = 0;
         for (auto const& kaon : tracksKaPlusFromLcgrouped) {
+          auto const& kaonProng = prongsNeg[iKaon++];
+          if (rejectPrefit(array{protonProng.pVec, kaonProng.pVec, pionProng.pVec}, array{o2::constants::physics::MassProton, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged}, o2::constants::physics::MassLambdaCPlus))
+            continue;
           if (mcSameMotherCheck && (!checkSameMother(proton, kaon) || !checkSameMother(proton, pion)))
             continue;
-          if (!buildDecayCandidateThreeBody(proton, kaon, pion, o2::constants::physics::MassProton, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged))
+          if (!buildDecayCandidateThreeBody(protonProng, kaonProng, pionProng, o2::constants::physics::MassProton, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged))
             continue;
           histos.fill(HIST("hMassLcbar"), lcbaryon.mass);
           histos.fill(HIST("h3dRecLcbar"), lcbaryon.pt, lcbaryon.eta, lcbaryon.mass);
@@ -15,8 +15,11 @@
 
 // O2 includes
 #include "Framework/AnalysisTask.h"
+#include "Framework/CallbackService.h"
+#include "Framework/EndOfStreamContext.h"
 #include "ReconstructionDataFormats/Track.h"
 #include "SimulationDataFormat/MCUtils.h"
+#include "ALICE3/Core/DelphesO2LutAccumulator.h"
 
 using namespace o2;
 using namespace framework;
@@ -61,10 +64,28 @@ struct Alice3LutMaker {
   Configurable<float> ptMax{"ptMax", 2.f, "Upper limit in pT"};
   Configurable<int> ptLog{"ptLog", 1, "Flag to use a logarithmic pT axis, in this case the pT limits are the expontents"};
 
+  Configurable<std::string> lutFile{"lutFile", "", "If not empty, file where the LUT (eta and pT binning as above) is written at the end of the processing"};
+  Configurable<float> lutField{"lutField", 0.5f, "Magnetic field written in the LUT header (T)"};
+
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
+  o2::delphes::LutAccumulator lut;
+  std::vector<bool> isReconstructed; // per MC particle, buffer of the efficiency
 
-  void init(InitContext&)
+  void init(InitContext& initContext)
   {
+    if (!lutFile.value.empty()) {
+      map_t etamap, ptmap;
+      etamap.nbins = etaBins;
+      etamap.min = etaMin;
+      etamap.max = etaMax;
+      ptmap.nbins = ptBins;
+      ptmap.min = ptMin;
+      ptmap.max = ptMax;
+      ptmap.log = ptLog;
+      lut.init(pdg, o2::track::pid_constants::sMasses[particle], lutField, map_t{}, map_t{}, etamap, ptmap);
+      initContext.services().get<CallbackService>().set<CallbackService::Id::EndOfStream>([this](EndOfStreamContext&) { lut.write(lutFile.value.c_str()); });
+    }
+
     const TString commonTitle = Form(" PDG %i", pdg);
     AxisSpec axisPt{ptBins, ptMin, ptMax, "#it{p}_{T} GeV/#it{c}"};
     if (ptLog) {
@@ -202,7 +223,8 @@ struct Alice3LutMaker {
                const o2::soa::Join<o2::aod::Tracks, o2::aod::TracksCov, o2::aod::McTrackLabels>& tracks,
                const o2::aod::McCollisions&)
   {
-    std::vector<int64_t> recoTracks(tracks.size());
+    isReconstructed.assign(mcParticles.size(), false);
+    const bool fillLut = !lutFile.value.empty();
     int ntrks = 0;
 
     for (const auto& track : tracks) {
@@ -216,7 +238,11 @@ struct Alice3LutMaker {
         continue;
       }
 
-      recoTracks[ntrks++] = mcParticle.globalIndex();
+      ntrks++;
+      isReconstructed[mcParticle.globalIndex() - mcParticles.offset()] = true;
+      if (fillLut) {
+        lut.fillCovariance(0.f, 0.f, mcParticle.eta(), mcParticle.pt(), {track.cYY(), track.cZY(), track.cZZ(), track.cSnpY(), track.cSnpZ(), track.cSnpSnp(), track.cTglY(), track.cTglZ(), track.cTglSnp(), track.cTglTgl(), track.c1PtY(), track.c1PtZ(), track.c1PtSnp(), track.c1PtTgl(), track.c1Pt21Pt2()});
+      }
 
       histos.fill(HIST("pt"), mcParticle.pt());
       histos.fill(HIST("eta"), mcParticle.eta());
@@ -299,10 +325,10 @@ struct Alice3LutMaker {
         continue;
       }
 
-      if (std::find(recoTracks.begin(), recoTracks.end(), mcParticle.globalIndex()) != recoTracks.end()) {
-        histos.fill(HIST("Efficiency"), mcParticle.pt(), mcParticle.eta(), 1.);
-      } else {
-        histos.fill(HIST("Efficiency"), mcParticle.pt(), mcParticle.eta(), 0.);
+      const bool isReco = isReconstructed[mcParticle.globalIndex() - mcParticles.offset()];
+      histos.fill(HIST("Efficiency"), mcParticle.pt(), mcParticle.eta(), isReco ? 1. : 0.);
+      if (fillLut) {
+        lut.fillEfficiency(0.f, 0.f, mcParticle.eta(), mcParticle.pt(), isReco);
       }
     }
   }
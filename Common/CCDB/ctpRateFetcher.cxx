@@ -26,6 +26,18 @@ namespace o2
 using framework::Service;
 
 double ctpRateFetcher::fetch(Service<o2::ccdb::BasicCCDBManager>& ccdb, uint64_t timeStamp, int runNumber, std::string sourceName)
+{
+  setupRun(runNumber);
+  if (timeStamp == mLastTimeStamp && sourceName == mLastSourceName) {
+    return mLastRate;
+  }
+  mLastRate = fetchRate(ccdb, timeStamp, runNumber, sourceName);
+  mLastTimeStamp = timeStamp;
+  mLastSourceName = sourceName;
+  return mLastRate;
+}
+
+double ctpRateFetcher::fetchRate(Service<o2::ccdb::BasicCCDBManager>& ccdb, uint64_t timeStamp, int runNumber, const std::string& sourceName)
 {
   if (sourceName.find("ZNC") != std::string::npos) {
     if (runNumber < 544448) {
@@ -52,18 +64,25 @@ double ctpRateFetcher::fetchCTPratesClasses(Service<o2::ccdb::BasicCCDBManager>&
 {
   getCTPscalers(ccdb, timeStamp, runNumber);
   getCTPconfig(ccdb, timeStamp, runNumber);
+  getLHCIFdata(ccdb, timeStamp, runNumber);
 
-  std::vector<ctp::CTPClass> ctpcls = mConfig->getCTPClasses();
-  std::vector<int> clslist = mConfig->getTriggerClassList();
+  auto cachedIndex = mClassIndices.find(className);
   int classIndex = -1;
-  for (size_t i = 0; i < clslist.size(); i++) {
-    if (ctpcls[i].name == className) {
-      classIndex = i;
-      break;
+  if (cachedIndex != mClassIndices.end()) {
+    classIndex = cachedIndex->second;
+  } else {
+    const std::vector<ctp::CTPClass>& ctpcls = mConfig->getCTPClasses();
+    size_t nClasses = mConfig->getTriggerClassList().size();
+    for (size_t i = 0; i < nClasses; i++) {
+      if (ctpcls[i].name == className) {
+        classIndex = i;
+        break;
+      }
     }
-  }
-  if (classIndex == -1) {
-    LOG(fatal) << "Trigger class " << className << " not found in CTPConfiguration";
+    if (classIndex == -1) {
+      LOG(fatal) << "Trigger class " << className << " not found in CTPConfiguration";
+    }
+    mClassIndices[className] = classIndex;
   }
 
   auto rate{mScalers->getRateGivenT(timeStamp, classIndex, inputType)};
@@ -76,7 +95,7 @@ double ctpRateFetcher::fetchCTPratesInputs(Service<o2::ccdb::BasicCCDBManager>&
   getCTPscalers(ccdb, timeStamp, runNumber);
   getLHCIFdata(ccdb, timeStamp, runNumber);
 
-  std::vector<ctp::CTPScalerRecordO2> recs = mScalers->getScalerRecordO2();
+  const std::vector<ctp::CTPScalerRecordO2>& recs = mScalers->getScalerRecordO2();
   if (recs[0].scalersInps.size() == 48) {
     return pileUpCorrection(mScalers->getRateGivenT(timeStamp, input, 7).second);
   } else {
@@ -85,6 +104,23 @@ double ctpRateFetcher::fetchCTPratesInputs(Service<o2::ccdb::BasicCCDBManager>&
   }
 }
 
+void ctpRateFetcher::setupRun(int runNumber)
+{
+  if (runNumber == mRunNumber) {
+    return;
+  }
+  // the objects of the previous run are dropped and fetched again on demand
+  mRunNumber = runNumber;
+  mConfig = nullptr;
+  mScalers = nullptr;
+  mLHCIFdata = nullptr;
+  mNFilledBCs = 0.;
+  mClassIndices.clear();
+  mLastTimeStamp = 0;
+  mLastSourceName.clear();
+  mLastRate = -1.;
+}
+
 void ctpRateFetcher::getCTPscalers(Service<o2::ccdb::BasicCCDBManager>& ccdb, uint64_t timeStamp, int runNumber)
 {
   if (runNumber == mRunNumber && mScalers != nullptr) {
@@ -109,6 +145,7 @@ void ctpRateFetcher::getLHCIFdata(Service<o2::ccdb::BasicCCDBManager>& ccdb, uin
   if (mLHCIFdata == nullptr) {
     LOG(fatal) << "GRPLHCIFData not in database, timestamp:" << timeStamp;
   }
+  mNFilledBCs = mLHCIFdata->getBunchFilling().getFilledBCs().size();
 }
 
 void ctpRateFetcher::getCTPconfig(Service<o2::ccdb::BasicCCDBManager>& ccdb, uint64_t timeStamp, int runNumber)
@@ -126,9 +163,7 @@ void ctpRateFetcher::getCTPconfig(Service<o2::ccdb::BasicCCDBManager>& ccdb, uin
 
 double ctpRateFetcher::pileUpCorrection(double triggerRate)
 {
-  auto bfilling = mLHCIFdata->getBunchFilling();
-  std::vector<int> bcs = bfilling.getFilledBCs();
-  double nbc = bcs.size();
+  double nbc = mNFilledBCs;
   double nTriggersPerFilledBC = triggerRate / nbc / constants::lhc::LHCRevFreq;
   double mu = -std::log(1 - nTriggersPerFilledBC);
   return mu * nbc * constants::lhc::LHCRevFreq;
@@ -12,6 +12,7 @@
 #ifndef COMMON_CCDB_CTPRATEFETCHER_H_
 #define COMMON_CCDB_CTPRATEFETCHER_H_
 
+#include <map>
 #include <string>
 
 #include "CCDB/BasicCCDBManager.h"
@@ -38,6 +39,8 @@ class ctpRateFetcher
   double fetch(framework::Service<o2::ccdb::BasicCCDBManager>& ccdb, uint64_t timeStamp, int runNumber, std::string sourceName);
 
  private:
+  double fetchRate(framework::Service<o2::ccdb::BasicCCDBManager>& ccdb, uint64_t timeStamp, int runNumber, const std::string& sourceName);
+  void setupRun(int runNumber);
   void getCTPconfig(framework::Service<o2::ccdb::BasicCCDBManager>& ccdb, uint64_t timeStamp, int runNumber);
   void getCTPscalers(framework::Service<o2::ccdb::BasicCCDBManager>& ccdb, uint64_t timeStamp, int runNumber);
   void getLHCIFdata(framework::Service<o2::ccdb::BasicCCDBManager>& ccdb, uint64_t timeStamp, int runNumber);
@@ -49,6 +52,11 @@ class ctpRateFetcher
   ctp::CTPConfiguration* mConfig = nullptr;
   ctp::CTPRunScalers* mScalers = nullptr;
   parameters::GRPLHCIFData* mLHCIFdata = nullptr;
+  double mNFilledBCs = 0.;                  // number of filled BCs of the run, for the pile-up correction
+  std::map<std::string, int> mClassIndices; // indices of the trigger classes already looked up in the run
+  uint64_t mLastTimeStamp = 0;              // timestamp of the last fetched rate, shared by the collisions of the same millisecond
+  std::string mLastSourceName;              // source of the last fetched rate
+  double mLastRate = -1.;                   // last fetched rate
 };
 } // namespace o2
 
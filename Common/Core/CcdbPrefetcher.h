@@ -0,0 +1,133 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CcdbPrefetcher.h
+/// \brief  Background retrieval of the run-dependent CCDB objects of a task
+///
+/// The objects are requested per run, e.g. for all the runs found in the BC table when a time frame arrives,
+/// and each request is retrieved in its own thread with its own CcdbApi, so that the objects of several
+/// paths and runs are downloaded in parallel instead of one after the other at the first use. get() waits
+/// for the retrieval if it is not finished yet, or retrieves the object if it was not requested before.
+/// The objects belong to the prefetcher and stay valid until clear() is called.
+///
+/// Usage:
+///   o2::analysis::CcdbPrefetcher prefetcher;
+///   // in init(): prefetcher.init(ccdbUrl, createdNotAfter);
+///   // in process(), with the BC table of the time frame:
+///   for (const auto& [runNumber, timestamp] : prefetcher.findNewRuns(bcs)) {
+///     prefetcher.prefetch<o2::parameters::GRPMagField>(grpmagPath, runNumber, timestamp);
+///   }
+///   auto grpmag = prefetcher.get<o2::parameters::GRPMagField>(grpmagPath, bc.runNumber(), bc.timestamp());
+///
+
+#ifndef COMMON_CORE_CCDBPREFETCHER_H_
+#define COMMON_CORE_CCDBPREFETCHER_H_
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CCDB/CcdbApi.h"
+#include "Framework/Logger.h"
+
+namespace o2::analysis
+{
+
+class CcdbPrefetcher
+{
+ public:
+  /// \param url url of the ccdb repository
+  /// \param createdNotAfter only objects created before this timestamp (ms) are retrieved, if positive
+  void init(const std::string& url, int64_t createdNotAfter = -1)
+  {
+    mUrl = url;
+    mCreatedNotAfter = createdNotAfter > 0 ? std::to_string(createdNotAfter) : "";
+  }
+
+  /// Starts the retrieval of an object in the background, if not done yet for this path and run
+  template <typename T>
+  void prefetch(const std::string& path, int runNumber, int64_t timestamp)
+  {
+    auto& entry = mEntries[{path, runNumber}];
+    if (entry.valid()) {
+      return;
+    }
+    auto retrieve = [url = mUrl, createdNotAfter = mCreatedNotAfter, path, timestamp]() {
+      o2::ccdb::CcdbApi api;
+      api.init(url);
+      std::map<std::string, std::string> metadata;
+      T* object = api.retrieveFromTFileAny<T>(path, metadata, timestamp, nullptr, "", createdNotAfter);
+      return std::shared_ptr<void>(object, [](void* ptr) { delete static_cast<T*>(ptr); });
+    };
+    entry = std::async(std::launch::async, retrieve).share();
+  }
+
+  /// \return object of the path for the run, waiting for its retrieval if needed, nullptr if not found
+  template <typename T>
+  T* get(const std::string& path, int runNumber, int64_t timestamp)
+  {
+    prefetch<T>(path, runNumber, timestamp);
+    auto object = mEntries[{path, runNumber}].get();
+    if (!object) {
+      LOGP(error, "CCDB object {} not found for run {} at timestamp {}", path, runNumber, timestamp);
+    }
+    return static_cast<T*>(object.get());
+  }
+
+  /// \return runs of the BC table not seen before, with the timestamp of their first BC
+  template <typename TBCs>
+  const std::vector<std::pair<int, int64_t>>& findNewRuns(TBCs const& bcs)
+  {
+    mNewRuns.clear();
+    int lastRun = -1;
+    for (const auto& bc : bcs) {
+      if (bc.runNumber() == lastRun) {
+        continue;
+      }
+      lastRun = bc.runNumber();
+      if (mRuns.insert(lastRun).second) {
+        mNewRuns.emplace_back(lastRun, bc.timestamp());
+      }
+    }
+    return mNewRuns;
+  }
+
+  /// Releases the objects, waiting for the pending retrievals
+  void clear()
+  {
+    for (auto& [key, entry] : mEntries) {
+      if (entry.valid()) {
+        entry.wait();
+      }
+    }
+    mEntries.clear();
+    mRuns.clear();
+  }
+
+  ~CcdbPrefetcher() { clear(); }
+
+ private:
+  std::string mUrl{"http://alice-ccdb.cern.ch"};
+  std::string mCreatedNotAfter{};
+  std::map<std::pair<std::string, int>, std::shared_future<std::shared_ptr<void>>> mEntries; // objects by path and run
+  std::set<int> mRuns;                                                                       // runs returned by findNewRuns
+  std::vector<std::pair<int, int64_t>> mNewRuns;                                             // buffer of findNewRuns
+};
+
+} // namespace o2::analysis
+
+#endif // COMMON_CORE_CCDBPREFETCHER_H_
@@ -20,8 +20,11 @@
 #ifndef COMMON_CORE_COLLISIONASSOCIATION_H_
 #define COMMON_CORE_COLLISIONASSOCIATION_H_
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 #include <memory>
+#include <thread>
 #include <utility>
 
 #include "CommonConstants/LHCConstants.h"
@@ -57,6 +60,7 @@ class CollisionAssociation
   void setIncludeUnassigned(bool enable = true) { mIncludeUnassigned = enable; }
   void setFillTableOfCollIdsPerTrack(bool fill = true) { mFillTableOfCollIdsPerTrack = fill; }
   void setBcWindow(int bcWindow = 115) { mBcWindowForOneSigma = bcWindow; }
+  void setNumThreads(int nThreads = 1) { mNumThreads = nThreads; }
 
   template <typename TTracks, typename Slice, typename Assoc, typename RevIndices>
   void runStandardAssoc(o2::aod::Collisions const& collisions,
@@ -125,99 +129,80 @@ class CollisionAssociation
                         Assoc& association,
                         RevIndices& reverseIndices)
   {
-    // cache globalBC and track time in BC for optimization
+    // cache the BC of the ambiguous tracks, indexed by track, to avoid searching the ambiguous track table for each track
+    std::vector<int64_t> ambiguousBC;
+    if (mIncludeUnassigned) {
+      ambiguousBC.assign(tracksUnfiltered.size(), -2); // -2: not ambiguous, -1: ambiguous without BC
+      for (const auto& ambTrack : ambiguousTracks) {
+        if constexpr (isCentralBarrel) { // FIXME: to be removed as soon as it is possible to use getId<Table>() for joined tables
+          const auto trackId = ambTrack.trackId();
+          if (ambiguousBC[trackId] != -2) {
+            continue;
+          }
+          ambiguousBC[trackId] = (!ambTrack.has_bc() || ambTrack.bc().size() == 0) ? -1 : ambTrack.bc().begin().globalBC();
+        } else {
+          const auto trackId = ambTrack.template getId<TTracks>();
+          if (ambiguousBC[trackId] != -2) {
+            continue;
+          }
+          ambiguousBC[trackId] = ambTrack.bc().begin().globalBC();
+        }
+      }
+    }
+
+    // cache globalBC and track time in BC, and build an index of the tracks sorted by their time in BC
     std::vector<int64_t> globalBC;
-    std::vector<int64_t> trackBCCache;
-    std::vector<std::pair<typename TTracks::iterator, typename TTracks::iterator>> trackIterationWindows; // continous regions in which we can count on increasing globalBC numbers
+    std::vector<std::pair<int64_t, int64_t>> tracksByBC; // (track time in BC, filtered index)
     globalBC.reserve(tracks.size());
-    trackBCCache.reserve(tracks.size());
-    auto trackBegin = tracks.begin();
-    int lastCollisionId = 0;
-    if (tracks.size() > 0) {
-      lastCollisionId = trackBegin.collisionId();
-    }
-    auto track = trackBegin;
-    for (; track != tracks.end(); ++track) {
+    tracksByBC.reserve(tracks.size());
+    for (const auto& track : tracks) {
       int64_t trackBC = -1;
       if (track.has_collision()) {
         trackBC = track.collision().bc().globalBC();
       } else if (mIncludeUnassigned) {
-        for (const auto& ambTrack : ambiguousTracks) {
-          if constexpr (isCentralBarrel) { // FIXME: to be removed as soon as it is possible to use getId<Table>() for joined tables
-            if (ambTrack.trackId() == track.globalIndex()) {
-              if (!ambTrack.has_bc() || ambTrack.bc().size() == 0) {
-                break;
-              }
-              trackBC = ambTrack.bc().begin().globalBC();
-              break;
-            }
-          } else {
-            if (ambTrack.template getId<TTracks>() == track.globalIndex()) {
-              trackBC = ambTrack.bc().begin().globalBC();
-              break;
-            }
-          }
-        }
+        trackBC = std::max<int64_t>(ambiguousBC[track.globalIndex()], -1);
       }
       globalBC.push_back(trackBC);
-      trackBCCache.push_back(trackBC + track.trackTime() / o2::constants::lhc::LHCBunchSpacingNS);
-      // find uniform blocks
-      if ((track.collisionId() < lastCollisionId) || (lastCollisionId < 0 && track.collisionId() >= 0)) {
-        if (lastCollisionId >= 0 || mIncludeUnassigned) {
-          LOGP(debug, "Found track block from {} to {}, current id {}, last id {}", trackBegin.filteredIndex(), track.filteredIndex() - 1, track.collisionId(), lastCollisionId);
-          trackIterationWindows.push_back(std::make_pair(trackBegin, track));
-        }
-        trackBegin = track;
+      if (trackBC >= 0) {
+        tracksByBC.emplace_back(trackBC + track.trackTime() / o2::constants::lhc::LHCBunchSpacingNS, track.filteredIndex());
       }
-      lastCollisionId = track.collisionId();
-    }
-    // trackIterationWindows.push_back(std::make_pair(trackBegin, tracks.end()));
-    if (lastCollisionId >= 0 || mIncludeUnassigned) {
-      LOGP(debug, "Found track block from {} to {}", trackBegin.filteredIndex(), tracks.size() - 1);
-      trackIterationWindows.push_back(std::make_pair(trackBegin, track));
     }
+    std::sort(tracksByBC.begin(), tracksByBC.end());
 
     // define vector of vectors to store indices of compatible collisions per track
     std::vector<std::unique_ptr<std::vector<int>>> collsPerTrack(tracksUnfiltered.size());
 
     // loop over collisions to find time-compatible tracks
     int64_t bcOffsetMax = mBcWindowForOneSigma * mNumSigmaForTimeCompat + mTimeMargin / o2::constants::lhc::LHCBunchSpacingNS;
-    for (const auto& collision : collisions) {
-      const float collTime = collision.collisionTime();
-      const float collTimeRes2 = collision.collisionTimeRes() * collision.collisionTimeRes();
-      uint64_t collBC = collision.bc().globalBC();
+    // the collisions are split in contiguous chunks, processed in parallel if more threads are enabled
+    // each chunk collects its (collision, track) pairs locally, the chunks are then merged in collision order
+    const int64_t nCollisions = collisions.size();
+    const int nChunks = std::max<int64_t>(1, std::min<int64_t>(mNumThreads, nCollisions));
+    const int64_t chunkSize = (nCollisions + nChunks - 1) / nChunks;
+    std::vector<std::vector<std::pair<int, int>>> assocPerChunk(nChunks);
+    auto processChunk = [&](int iChunk) {
+      std::vector<int64_t> compatibleTracks;
+      auto& assocPairs = assocPerChunk[iChunk];
+      auto track = tracks.begin();
+      const int64_t lastCollision = std::min(nCollisions, (iChunk + 1) * chunkSize);
+      for (int64_t iCollision = iChunk * chunkSize; iCollision < lastCollision; ++iCollision) {
+        const auto collision = collisions.iteratorAt(iCollision);
+        const float collTime = collision.collisionTime();
+        const float collTimeRes2 = collision.collisionTimeRes() * collision.collisionTimeRes();
+        uint64_t collBC = collision.bc().globalBC();
 
-      // This is done per block to allow optimization below. Within each block the globalBC increase continously
-      for (auto& iterationWindow : trackIterationWindows) {
-        bool iteratorMoved = false;
-        const bool isAssignedTrackWindow = (iterationWindow.first != iterationWindow.second) ? iterationWindow.first.has_collision() : false;
-        for (auto track = iterationWindow.first; track != iterationWindow.second; ++track) {
-          int64_t trackBC = globalBC[track.filteredIndex()];
-          if (trackBC < 0) {
-            continue;
-          }
+        // select with a binary search the tracks within the maximum BC window, then process them in table order
+        compatibleTracks.clear();
+        auto trackByBC = std::lower_bound(tracksByBC.begin(), tracksByBC.end(), std::make_pair((int64_t)collBC - bcOffsetMax, std::numeric_limits<int64_t>::min()));
+        for (; trackByBC != tracksByBC.end() && trackByBC->first <= (int64_t)collBC + bcOffsetMax; ++trackByBC) {
+          compatibleTracks.push_back(trackByBC->second);
+        }
+        std::sort(compatibleTracks.begin(), compatibleTracks.end());
 
-          // Optimization to avoid looping over the full track list each time. This builds on that tracks are sorted by BCs (which they should be because collisions are sorted by BCs)
+        for (const auto trackFilteredIndex : compatibleTracks) {
+          track.setCursor(trackFilteredIndex);
+          int64_t trackBC = globalBC[trackFilteredIndex];
           const int64_t bcOffset = trackBC - (int64_t)collBC;
-          if constexpr (isCentralBarrel) {
-            // only for blocks with collision association
-            if (isAssignedTrackWindow) {
-              constexpr int margin = 200;
-              if (!iteratorMoved && bcOffset > -bcOffsetMax - margin) {
-                iterationWindow.first.setCursor(track.filteredIndex());
-                iteratorMoved = true;
-                LOGP(debug, "Moving iterator begin {}", track.filteredIndex());
-              } else if (bcOffset > bcOffsetMax + margin) {
-                LOGP(debug, "Stopping iterator {}", track.filteredIndex());
-                break;
-              }
-            }
-          }
-
-          int64_t bcOffsetWindow = trackBCCache[track.filteredIndex()] - (int64_t)collBC;
-          if (std::abs(bcOffsetWindow) > bcOffsetMax) {
-            continue;
-          }
 
           float trackTime = 0;
           float trackTimeRes = 0;
@@ -252,17 +237,38 @@ class CollisionAssociation
           }
 
           if (std::abs(deltaTime) < thresholdTime) {
-            const auto collIdx = collision.globalIndex();
-            const auto trackIdx = track.globalIndex();
-            LOGP(debug, "Filling track id {} for coll id {}", trackIdx, collIdx);
-            association(collIdx, trackIdx);
-            if (mFillTableOfCollIdsPerTrack) {
-              if (collsPerTrack[trackIdx] == nullptr) {
-                collsPerTrack[trackIdx] = std::make_unique<std::vector<int>>();
-              }
-              collsPerTrack[trackIdx].get()->push_back(collIdx);
-            }
+            LOGP(debug, "Filling track id {} for coll id {}", track.globalIndex(), collision.globalIndex());
+            assocPairs.emplace_back(collision.globalIndex(), track.globalIndex());
+          }
+        }
+      }
+    };
+    if (nChunks == 1) {
+      processChunk(0);
+    } else {
+      std::vector<std::thread> workers;
+      for (int iChunk = 0; iChunk < nChunks; ++iChunk) {
+        workers.emplace_back(processChunk, iChunk);
+      }
+      for (auto& worker : workers) {
+        worker.join();
+      }
+    }
+
+    // fill the association table and the compatible collisions per track
+    std::size_t nAssociations = 0;
+    for (const auto& assocPairs : assocPerChunk) {
+      nAssociations += assocPairs.size();
+    }
+    association.reserve(nAssociations);
+    for (const auto& assocPairs : assocPerChunk) {
+      for (const auto& [collIdx, trackIdx] : assocPairs) {
+        association(collIdx, trackIdx);
+        if (mFillTableOfCollIdsPerTrack) {
+          if (collsPerTrack[trackIdx] == nullptr) {
+            collsPerTrack[trackIdx] = std::make_unique<std::vector<int>>();
           }
+          collsPerTrack[trackIdx].get()->push_back(collIdx);
         }
       }
     }
@@ -289,6 +295,7 @@ class CollisionAssociation
   bool mIncludeUnassigned{true};                                                     // include tracks that were originally not assigned to any collision
   bool mFillTableOfCollIdsPerTrack{false};                                           // fill additional table with vectors of compatible collisions per track
   int mBcWindowForOneSigma{115};                                                     // BC window to be multiplied by the number of sigmas to define maximum window to be considered
+  int mNumThreads{1};                                                                // number of threads for the time-based association
 };
 
 #endif // COMMON_CORE_COLLISIONASSOCIATION_H_
@@ -12,6 +12,12 @@
 #ifndef ANALYSIS_CORE_EVENTMIXING_H_
 #define ANALYSIS_CORE_EVENTMIXING_H_
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
 namespace eventmixing
 {
 /// Calculate hash for an element based on 2 properties and their bins.
@@ -26,25 +32,121 @@ template <typename T1, typename T2>
 static int getMixingBin(const T1& vtxBins, const T1& multBins, const T2& vtx, const T2& mult)
 {
   // underflow
-  if (vtx < vtxBins.at(0)) {
+  if (vtxBins.empty() || multBins.empty() || vtx < vtxBins[0] || mult < multBins[0]) {
     return -1;
   }
-  if (mult < multBins.at(0)) {
+  // index of the first edge above the value, the bins being sorted
+  const std::size_t i = std::upper_bound(vtxBins.begin(), vtxBins.end(), vtx) - vtxBins.begin();
+  const std::size_t j = std::upper_bound(multBins.begin(), multBins.end(), mult) - multBins.begin();
+  // overflow
+  if (i == vtxBins.size() || j == multBins.size()) {
     return -1;
   }
+  return i + j * (vtxBins.size() + 1);
+}
 
-  for (unsigned int i = 1; i < vtxBins.size(); i++) {
-    if (vtx < vtxBins.at(i)) {
-      for (unsigned int j = 1; j < multBins.size(); j++) {
-        if (mult < multBins.at(j)) {
-          return i + j * (vtxBins.size() + 1);
+/// Binning of the event mixing in N variables (e.g. z-vertex, multiplicity, event plane, occupancy)
+/// The bins of each variable are given by their edges. The bin of a variable is computed directly when
+/// its bins are uniform and by binary search otherwise, and the bins of the N variables are flattened in
+/// a compact index in [0, getNBins()), or -1 if one of the variables is outside of its bins.
+/// Usage:
+///   MixingBinning<2> binning({vtxBins, multBins}); // e.g. in init()
+///   int bin = binning.getBin({collision.posZ(), collision.multFT0M()});
+template <std::size_t N>
+class MixingBinning
+{
+ public:
+  MixingBinning() = default;
+  explicit MixingBinning(const std::array<std::vector<float>, N>& edges) { setEdges(edges); }
+
+  /// Sets the bin edges of the variables, each sorted in increasing order with at least two edges
+  void setEdges(const std::array<std::vector<float>, N>& edges)
+  {
+    mNBins = 1;
+    for (std::size_t iVar = N; iVar-- > 0;) {
+      auto& axis = mAxes[iVar];
+      axis.edges = edges[iVar];
+      const int nBins = axis.edges.size() > 1 ? axis.edges.size() - 1 : 0;
+      axis.stride = mNBins;
+      mNBins *= nBins;
+      axis.isUniform = nBins > 0;
+      if (nBins > 0) {
+        const float width = (axis.edges.back() - axis.edges.front()) / nBins;
+        for (int iBin = 0; iBin < nBins && axis.isUniform; iBin++) {
+          axis.isUniform = std::abs(axis.edges[iBin + 1] - axis.edges[iBin] - width) <= 1.e-5f * std::abs(width);
         }
+        axis.invWidth = 1.f / width;
       }
     }
   }
-  // overflow
-  return -1;
-}
+
+  /// Number of flattened bins
+  int getNBins() const { return mNBins; }
+
+  /// Bin of the value of the variable iVar, in [0, number of bins of the variable), or -1 if outside of the bins
+  int getAxisBin(std::size_t iVar, float value) const
+  {
+    const auto& axis = mAxes[iVar];
+    if (axis.edges.size() < 2 || !(value >= axis.edges.front()) || value >= axis.edges.back()) {
+      return -1;
+    }
+    const int nBins = axis.edges.size() - 1;
+    if (axis.isUniform) {
+      int bin = static_cast<int>((value - axis.edges.front()) * axis.invWidth);
+      // the rounding of the product may move a value at an edge to the neighbouring bin
+      if (bin >= nBins || value < axis.edges[bin]) {
+        bin--;
+      } else if (value >= axis.edges[bin + 1]) {
+        bin++;
+      }
+      return bin;
+    }
+    return std::upper_bound(axis.edges.begin(), axis.edges.end(), value) - axis.edges.begin() - 1;
+  }
+
+  /// Flattened bin of the values of the N variables, or -1 if one of them is outside of its bins
+  int getBin(const std::array<float, N>& values) const
+  {
+    int bin = 0;
+    for (std::size_t iVar = 0; iVar < N; iVar++) {
+      const int axisBin = getAxisBin(iVar, values[iVar]);
+      if (axisBin < 0) {
+        return -1;
+      }
+      bin += axisBin * mAxes[iVar].stride;
+    }
+    return bin;
+  }
+
+  /// Flattened bins of a block of n collisions, given the columns of the N variables
+  /// \param columns pointers to the n values of each variable
+  /// \param bins output flattened bins of the n collisions
+  void getBins(std::size_t n, const std::array<const float*, N>& columns, int* bins) const
+  {
+    std::fill(bins, bins + n, 0);
+    for (std::size_t iVar = 0; iVar < N; iVar++) {
+      const int stride = mAxes[iVar].stride;
+      for (std::size_t i = 0; i < n; i++) {
+        if (bins[i] < 0) {
+          continue;
+        }
+        const int axisBin = getAxisBin(iVar, columns[iVar][i]);
+        bins[i] = axisBin < 0 ? -1 : bins[i] + axisBin * stride;
+      }
+    }
+  }
+
+ private:
+  struct Axis {
+    std::vector<float> edges;
+    bool isUniform{false};
+    float invWidth{0.f};
+    int stride{0}; // stride of the variable in the flattened bin
+  };
+
+  std::array<Axis, N> mAxes;
+  int mNBins{0};
+};
 }; // namespace eventmixing
 
 #endif /* ANALYSIS_CORE_EVENTMIXING_H_ */
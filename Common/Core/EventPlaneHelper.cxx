@@ -136,8 +136,7 @@ void EventPlaneHelper::DoCorrections(float& qx, float& qy,
   qy -= corrections[1];
 
   // Twisting of the Qx-Qy distribution.
-  qx = (qx - corrections[3] * qy) / (1.0 - corrections[3] * corrections[2]);
-  qy = (qy - corrections[2] * qx) / (1.0 - corrections[3] * corrections[2]);
+  DoTwist(qx, qy, corrections[2], corrections[3]);
 
   // Rescaling of the Qx-Qy into a circle.
   if (fabs(corrections[4]) > 1e-8) {
@@ -156,8 +155,10 @@ void EventPlaneHelper::DoRecenter(float& qx, float& qy, float x0, float y0)
 
 void EventPlaneHelper::DoTwist(float& qx, float& qy, float lp, float lm)
 {
-  qx = (qx - lm * qy) / (1.0 - lm * lp);
-  qy = (qy - lp * qx) / (1.0 - lm * lp);
+  // Both components are corrected from the untwisted (qx, qy).
+  const float qx0 = qx;
+  qx = (qx0 - lm * qy) / (1.0 - lm * lp);
+  qy = (qy - lp * qx0) / (1.0 - lm * lp);
 }
 
 void EventPlaneHelper::DoRescale(float& qx, float& qy, float ap, float am)
@@ -199,6 +200,13 @@ void EventPlaneHelper::GetCorrTwistRecale(const std::shared_ptr<TH2> histQ,
   lambdaMinus = b / aMinus;
 }
 
+void EventPlaneHelper::GetCorrections(const std::shared_ptr<TH2> histQ, std::vector<float>& corrections)
+{
+  corrections.resize(6);
+  GetCorrRecentering(histQ, corrections[0], corrections[1]);
+  GetCorrTwistRecale(histQ, corrections[4], corrections[5], corrections[2], corrections[3]);
+}
+
 float EventPlaneHelper::GetEventPlane(const float qx, const float qy, int nmode)
 {
   return (1. / nmode) * (TMath::ATan2(qy, qx));
@@ -89,6 +89,13 @@ class EventPlaneHelper
                           float& aPlus, float& aMinus,
                           float& lambdaPlus, float& lambdaMinus);
 
+  // Method to get all the corrections on the Qx-Qy distribution from the uncorrected
+  // distribution, in the layout used by DoCorrections: {x0, y0, lambdaPlus, lambdaMinus,
+  // aPlus, aMinus}. The twist and rescale corrections depend only on the widths and
+  // correlation of the distribution, which the recentering does not change, so that
+  // the three corrections are obtained from a single pass over the data.
+  void GetCorrections(const std::shared_ptr<TH2> histQ, std::vector<float>& corrections);
+
   // Method to calculate the event plane from the provided (Qx, Qy), for n = 2.
   float GetEventPlane(const float qx, const float qy, int nmode = 2);
 
@@ -0,0 +1,151 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   McParticleFamily.h
+/// \brief  Flat index of the MC particles of a time frame by MC collision, with their mothers and daughters
+///
+/// Filled once per time frame from the MC particle table, it stores the range of the particles of each MC
+/// collision and, in compressed sparse row arrays, the mothers and the daughters of each particle, following
+/// the index ranges of mothersIds() and daughtersIds(). Indices outside the table are dropped when filling,
+/// so that the decay trees can be traversed on contiguous arrays, without accessing the table or checking
+/// the indices again. All the indices are global indices of the MC particle table.
+///
+/// Usage:
+///   McParticleFamily family;
+///   // in process(), with the full tables:
+///   family.fill(mcParticles, mcCollisions.size());
+///   for (auto iPart = family.getFirstParticle(iMcColl); iPart < family.getLastParticle(iMcColl); ++iPart) { ... }
+///   family.forEachDescendant(iPart, [&](int64_t iDaughter) { ... });
+///
+
+#ifndef COMMON_CORE_MCPARTICLEFAMILY_H_
+#define COMMON_CORE_MCPARTICLEFAMILY_H_
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+class McParticleFamily
+{
+ public:
+  /// Fills the index from a table of MC particles.
+  /// \param particlesMC  table with MC particles, sorted by MC collision
+  /// \param nMcCollisions  number of MC collisions of the time frame
+  template <typename T>
+  void fill(const T& particlesMC, int64_t nMcCollisions)
+  {
+    const int64_t nParticles = particlesMC.size();
+    mOffset = particlesMC.offset();
+    mCollisionFirst.assign(nMcCollisions, 0);
+    mCollisionLast.assign(nMcCollisions, 0);
+    mMotherOffsets.assign(1, 0);
+    mDaughterOffsets.assign(1, 0);
+    mMotherOffsets.reserve(nParticles + 1);
+    mDaughterOffsets.reserve(nParticles + 1);
+    mMothers.clear();
+    mDaughters.clear();
+    for (const auto& particle : particlesMC) {
+      const auto index = particle.globalIndex();
+      const auto iMcColl = particle.mcCollisionId();
+      if (iMcColl >= 0 && iMcColl < nMcCollisions) {
+        if (mCollisionLast[iMcColl] == mCollisionFirst[iMcColl]) {
+          mCollisionFirst[iMcColl] = index;
+        }
+        mCollisionLast[iMcColl] = index + 1;
+      }
+      if (particle.has_mothers()) {
+        appendRange(particle.mothersIds().front(), particle.mothersIds().back(), nParticles, mMothers);
+      }
+      mMotherOffsets.push_back(mMothers.size());
+      if (particle.has_daughters()) {
+        appendRange(particle.daughtersIds().front(), particle.daughtersIds().back(), nParticles, mDaughters);
+      }
+      mDaughterOffsets.push_back(mDaughters.size());
+    }
+  }
+
+  /// \return number of particles in the index
+  int64_t getNParticles() const { return static_cast<int64_t>(mMotherOffsets.size()) - 1; }
+  /// \return global index of the first particle of an MC collision
+  int64_t getFirstParticle(int64_t iMcColl) const { return mCollisionFirst[iMcColl]; }
+  /// \return global index after the last particle of an MC collision, equal to the first one if the collision has no particle
+  int64_t getLastParticle(int64_t iMcColl) const { return mCollisionLast[iMcColl]; }
+  /// \return global indices of the mothers of the particle with a given global index
+  std::span<const int64_t> getMothers(int64_t index) const { return getRow(index, mMotherOffsets, mMothers); }
+  /// \return global indices of the daughters of the particle with a given global index
+  std::span<const int64_t> getDaughters(int64_t index) const { return getRow(index, mDaughterOffsets, mDaughters); }
+
+  /// Calls function(index) for all the descendants of a particle, depth first.
+  /// \param index  global index of the MC particle
+  /// \param depthMax  maximum number of generations; if -1, all the generations are visited
+  template <typename F>
+  void forEachDescendant(int64_t index, F&& function, int depthMax = -1)
+  {
+    mStack.clear();
+    if (depthMax != 0) {
+      pushDaughters(index, 1);
+    }
+    int64_t nVisited = 0;
+    while (!mStack.empty() && nVisited < getNParticles()) { // the bound protects against loops in the decay tree
+      const auto [iPart, depth] = mStack.back();
+      mStack.pop_back();
+      function(iPart);
+      nVisited++;
+      if (depthMax < 0 || depth < depthMax) {
+        pushDaughters(iPart, depth + 1);
+      }
+    }
+  }
+
+ private:
+  int64_t mOffset{0};                            // global index of the first particle
+  std::vector<int64_t> mCollisionFirst{};        // first particle of each MC collision
+  std::vector<int64_t> mCollisionLast{};         // particle after the last one of each MC collision
+  std::vector<int64_t> mMotherOffsets{};         // position of the mothers of each particle in mMothers, and total size
+  std::vector<int64_t> mMothers{};               // mothers of all the particles
+  std::vector<int64_t> mDaughterOffsets{};       // position of the daughters of each particle in mDaughters, and total size
+  std::vector<int64_t> mDaughters{};             // daughters of all the particles
+  std::vector<std::pair<int64_t, int>> mStack{}; // buffer of the descendant traversal (particle index, generation)
+
+  /// Pushes the daughters of a particle on the traversal stack, in reverse order so that they are visited in the order of the table
+  void pushDaughters(int64_t index, int depth)
+  {
+    const auto daughters = getDaughters(index);
+    for (auto iDaughter = daughters.rbegin(); iDaughter != daughters.rend(); ++iDaughter) {
+      if (*iDaughter != index) {
+        mStack.emplace_back(*iDaughter, depth);
+      }
+    }
+  }
+
+  /// Appends the particles of an index range, skipping the indices outside the table
+  void appendRange(int64_t first, int64_t last, int64_t nParticles, std::vector<int64_t>& row) const
+  {
+    for (auto index = first; index <= last; ++index) {
+      if (index >= mOffset && index - mOffset < nParticles) {
+        row.push_back(index);
+      }
+    }
+  }
+
+  std::span<const int64_t> getRow(int64_t index, const std::vector<int64_t>& offsets, const std::vector<int64_t>& row) const
+  {
+    const auto iPart = index - mOffset;
+    if (iPart < 0 || iPart >= getNParticles()) {
+      return {};
+    }
+    return std::span<const int64_t>(row.data() + offsets[iPart], offsets[iPart + 1] - offsets[iPart]);
+  }
+};
+
+#endif // COMMON_CORE_MCPARTICLEFAMILY_H_
@@ -0,0 +1,155 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   MixingPool.h
+/// \brief  Pool of past events for the event mixing, with a bounded number of events per mixing bin
+///
+/// Each mixing bin (e.g. from MixingBinning in EventMixing.h) keeps the payloads of its last `depth` events,
+/// where the payload is a compact struct defined by the task (e.g. the momentum and sign of the selected
+/// tracks). An event is mixed with the stored events of its bin, from the newest to the oldest, and then
+/// replaces the oldest one, so that the memory is bounded by the number of bins times the depth and the
+/// result does not depend on the size of the dataset. The storage of the evicted events is reused.
+///
+/// Usage:
+///   struct MixingTrack { float pt, eta, phi; int8_t sign; };
+///   eventmixing::MixingPool<MixingTrack> pool;
+///   // in init(): pool.init(binning.getNBins(), cfgMixingDepth);
+///   // in process(), with the selected tracks of the collision in `tracks`:
+///   pool.mixAndInsert(bin, tracks, [&](auto const& current, auto const& stored) { ... });
+///
+
+#ifndef COMMON_CORE_MIXINGPOOL_H_
+#define COMMON_CORE_MIXINGPOOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace eventmixing
+{
+
+template <typename Payload>
+class MixingPool
+{
+ public:
+  /// Sets the number of mixing bins and the number of events kept per bin, and empties the pool
+  void init(int nBins, int depth)
+  {
+    mDepth = depth > 0 ? depth : 1;
+    mBins.assign(nBins > 0 ? nBins : 0, Bin{});
+    for (auto& bin : mBins) {
+      bin.events.resize(mDepth);
+    }
+    mNInserted = 0;
+    mNEvicted = 0;
+  }
+
+  /// Calls function(current, stored) with the payloads of each stored event of the bin, from the newest to the oldest
+  /// \return number of stored events mixed with the current event
+  template <typename F>
+  int mix(int bin, const std::vector<Payload>& current, F&& function) const
+  {
+    if (!isValidBin(bin)) {
+      return 0;
+    }
+    const auto& poolBin = mBins[bin];
+    for (int iEvent = 0; iEvent < poolBin.nEvents; iEvent++) {
+      const int slot = (poolBin.next + mDepth - 1 - iEvent) % mDepth;
+      function(current, poolBin.events[slot]);
+    }
+    return poolBin.nEvents;
+  }
+
+  /// Stores the payloads of an event in its bin, in place of the oldest event if the bin is full
+  /// Events without payloads are not stored, since they would not give any mixed pair
+  void insert(int bin, const std::vector<Payload>& payloads)
+  {
+    if (!isValidBin(bin) || payloads.empty()) {
+      return;
+    }
+    auto& poolBin = mBins[bin];
+    poolBin.events[poolBin.next].assign(payloads.begin(), payloads.end());
+    poolBin.next = (poolBin.next + 1) % mDepth;
+    if (poolBin.nEvents < mDepth) {
+      poolBin.nEvents++;
+    } else {
+      mNEvicted++;
+    }
+    mNInserted++;
+  }
+
+  /// Mixes the event with the stored events of its bin and then stores it
+  template <typename F>
+  int mixAndInsert(int bin, const std::vector<Payload>& payloads, F&& function)
+  {
+    const int nMixed = mix(bin, payloads, function);
+    insert(bin, payloads);
+    return nMixed;
+  }
+
+  /// Empties the pool, keeping the storage of the events
+  void clear()
+  {
+    for (auto& bin : mBins) {
+      bin.nEvents = 0;
+      bin.next = 0;
+    }
+  }
+
+  int getNBins() const { return mBins.size(); }
+  int getDepth() const { return mDepth; }
+  /// Number of events stored in a bin, at most the depth
+  int getNEvents(int bin) const { return isValidBin(bin) ? mBins[bin].nEvents : 0; }
+  /// Number of payloads stored in the pool
+  std::size_t getNPayloads() const
+  {
+    std::size_t nPayloads = 0;
+    for (const auto& bin : mBins) {
+      for (int iEvent = 0; iEvent < bin.nEvents; iEvent++) {
+        nPayloads += bin.events[(bin.next + mDepth - 1 - iEvent) % mDepth].size();
+      }
+    }
+    return nPayloads;
+  }
+  /// Fraction of the events of the pool which are filled
+  float getOccupancy() const
+  {
+    if (mBins.empty()) {
+      return 0.f;
+    }
+    std::size_t nEvents = 0;
+    for (const auto& bin : mBins) {
+      nEvents += bin.nEvents;
+    }
+    return static_cast<float>(nEvents) / (mBins.size() * mDepth);
+  }
+  uint64_t getNInserted() const { return mNInserted; }
+  uint64_t getNEvicted() const { return mNEvicted; }
+
+ private:
+  struct Bin {
+    std::vector<std::vector<Payload>> events; // ring buffer of the payloads of the stored events
+    int next{0};                              // slot of the next inserted event, i.e. of the oldest event when full
+    int nEvents{0};                           // number of stored events
+  };
+
+  bool isValidBin(int bin) const { return bin >= 0 && bin < static_cast<int>(mBins.size()); }
+
+  std::vector<Bin> mBins;
+  int mDepth{1};
+  uint64_t mNInserted{0}; // events inserted since init
+  uint64_t mNEvicted{0};  // events evicted since init
+};
+
+} // namespace eventmixing
+
+#endif // COMMON_CORE_MIXINGPOOL_H_
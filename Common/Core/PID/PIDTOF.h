@@ -228,6 +228,35 @@ class TOFResoParamsV2 : public o2::tof::Parameters<13>
   TGraph* gNegEtaTimeCorr = nullptr;
 };
 
+/// \brief Species-independent inputs of the corrected expected times of a track
+/// They are computed once per track and shared by all the mass hypotheses, so that the momentum shift and the time shift graphs are evaluated only once
+struct ExpTimesTrackInputs {
+  bool hasTOF = false;   /// Whether the track has a TOF measurement
+  float tofExpMom = 0.f; /// TOF expected momentum corrected for the momentum shift
+  float length = 0.f;    /// Track length
+  float timeShift = 0.f; /// Time shift of the expected times
+
+  /// Computes the inputs of the track of interest
+  /// \param parameters Parameters to correct for the momentum and time shifts
+  /// \param track Track of interest
+  template <typename TrackType>
+  void set(const TOFResoParamsV2& parameters, const TrackType& track)
+  {
+    hasTOF = track.hasTOF();
+    if (!hasTOF) {
+      return;
+    }
+    length = track.length();
+    if (track.trackType() == o2::aod::track::Run2Track) {
+      tofExpMom = track.tofExpMom() * kCSPEDDInv / (1.f + track.sign() * parameters.getShift(track.eta()));
+      timeShift = 0.f;
+      return;
+    }
+    tofExpMom = track.tofExpMom() / (1.f + track.sign() * parameters.getShift(track.eta()));
+    timeShift = parameters.getTimeShift(track.eta(), track.sign());
+  }
+};
+
 /// \brief Class to handle the the TOF detector response for the expected time
 template <typename TrackType, o2::track::PID::ID id>
 class ExpTimes
@@ -269,6 +298,16 @@ class ExpTimes
     return ComputeExpectedTime(track.tofExpMom() / (1.f + track.sign() * parameters.getShift(track.eta())), track.length()) + parameters.getTimeShift(track.eta(), track.sign());
   }
 
+  /// Gets the expected signal under the PID assumption corrected for shifts in expected momentum, from the species-independent inputs of the track
+  /// \param inputs Inputs of the track of interest
+  static float GetCorrectedExpectedSignal(const ExpTimesTrackInputs& inputs)
+  {
+    if (!inputs.hasTOF) {
+      return defaultReturnValue;
+    }
+    return ComputeExpectedTime(inputs.tofExpMom, inputs.length) + inputs.timeShift;
+  }
+
   /// Gets the expected resolution of the t-texp-t0
   /// Given a TOF signal and collision time resolutions
   /// \param parameters Detector response parameters
@@ -324,6 +363,17 @@ class ExpTimes
   /// \param parameters Detector response parameters
   /// \param track Track of interest
   static float GetSeparation(const TOFResoParamsV2& parameters, const TrackType& track) { return GetSeparation(parameters, track, track.tofEvTime(), track.tofEvTimeErr()); }
+
+  /// Gets the number of sigmas with respect the expected time, from the species-independent inputs of the track
+  /// \param inputs Inputs of the track of interest
+  /// \param track Track of interest
+  /// \param resolution Resolution of the t-texp-t0
+  static float GetSeparation(const ExpTimesTrackInputs& inputs, const TrackType& track, const float resolution) { return track.hasTOF() ? (track.tofSignal() - track.tofEvTime() - GetCorrectedExpectedSignal(inputs)) / resolution : defaultReturnValue; }
+
+  /// Gets the number of sigmas with respect the expected time, from the species-independent inputs of the track
+  /// \param inputs Inputs of the track of interest
+  /// \param track Track of interest
+  static float GetSeparation(const ExpTimesTrackInputs& inputs, const TrackType& track) { return GetSeparation(inputs, track, track.tofEvTimeErr()); }
 };
 
 /// \brief Class to convert the trackTime to the tofSignal used for PID
@@ -83,6 +83,12 @@ class Response
   /// Gets relative dEdx resolution contribution due to relative pt resolution
   float GetRelativeResolutiondEdx(const float p, const float mass, const float charge, const float resol) const;
 
+  /// Column-wise interface: all arrays have n entries, one per track, and tracks without TPC are to be handled by the caller
+  /// Gets the expected signal and resolution of a block of tracks for the mass hypothesis id
+  void GetExpectedSignalAndSigma(const o2::track::PID::ID id, const std::size_t n, const float* tpcInnerParam, const float* tgl, const float* signed1Pt, const float* tpcNClsFound, const float* multTPC, float* expSignal, float* expSigma) const;
+  /// Gets the number of sigmas of a block of tracks from the expected signal and resolution
+  void GetNumberOfSigma(const std::size_t n, const float* tpcSignal, const float* expSignal, const float* expSigma, float* nSigma) const;
+
   void PrintAll() const;
 
  private:
@@ -179,6 +185,56 @@ inline float Response::GetRelativeResolutiondEdx(const float p, const float mass
   return deltaRel;
 }
 
+/// Gets the expected signal and resolution for a block of tracks
+/// The species constants are computed once per block and the loop body has no allocation, so that it can be vectorised
+inline void Response::GetExpectedSignalAndSigma(const o2::track::PID::ID id, const std::size_t n, const float* tpcInnerParam, const float* tgl, const float* signed1Pt, const float* tpcNClsFound, const float* multTPC, float* expSignal, float* expSigma) const
+{
+  const float mass = o2::track::pid_constants::sMasses[id];
+  const float charge = o2::track::pid_constants::sCharges[id];
+  const float chargeFactor = std::pow(charge, mChargeFactor);
+  const float bb0 = mBetheBlochParams[0], bb1 = mBetheBlochParams[1], bb2 = mBetheBlochParams[2], bb3 = mBetheBlochParams[3], bb4 = mBetheBlochParams[4];
+
+  if (mUseDefaultResolutionParam) {
+    const float reso0 = mResolutionParamsDefault[0];
+    const float reso1 = mResolutionParamsDefault[1];
+    for (std::size_t i = 0; i < n; i++) {
+      const float bethe = mMIP * o2::tpc::BetheBlochAleph(tpcInnerParam[i] / mass, bb0, bb1, bb2, bb3, bb4) * chargeFactor;
+      expSignal[i] = bethe >= 0.f ? bethe : -999.f;
+      const float reso = expSignal[i] * reso0 * (tpcNClsFound[i] > 0 ? std::sqrt(1. + reso1 / tpcNClsFound[i]) : 1.f);
+      expSigma[i] = reso >= 0.f ? reso : -999.f;
+    }
+    return;
+  }
+
+  const double massD = mass;
+  const double par0sq = pow(mResolutionParams[0], 2), par1sq = pow(mResolutionParams[1], 2);
+  for (std::size_t i = 0; i < n; i++) {
+    const float bethe = mMIP * o2::tpc::BetheBlochAleph(tpcInnerParam[i] / mass, bb0, bb1, bb2, bb3, bb4) * chargeFactor;
+    expSignal[i] = bethe >= 0.f ? bethe : -999.f;
+
+    const double ncl = nClNorm / tpcNClsFound[i];
+    const double p = tpcInnerParam[i];
+    const double dEdx = o2::tpc::BetheBlochAleph(static_cast<float>(p / massD), bb0, bb1, bb2, bb3, bb4) * chargeFactor;
+    const double relReso = GetRelativeResolutiondEdx(p, massD, charge, mResolutionParams[3]);
+    const double invdEdx = 1.f / dEdx;
+    const double sqrtNcl = std::sqrt(ncl);
+    const double signed1PtV = signed1Pt[i];
+    const double mult = multTPC[i] / mMultNormalization;
+    const double dEdxTgl = invdEdx / sqrt(1 + pow(tgl[i], 2));
+
+    const float reso = sqrt(par0sq * invdEdx + par1sq * (sqrtNcl * mResolutionParams[5]) * pow(dEdxTgl, mResolutionParams[2]) + sqrtNcl * pow(relReso, 2) + pow(mResolutionParams[4] * signed1PtV, 2) + pow(mult * mResolutionParams[6], 2) + pow(mult * dEdxTgl * mResolutionParams[7], 2)) * dEdx * mMIP;
+    expSigma[i] = reso >= 0.f ? reso : -999.f;
+  }
+}
+
+/// Gets the number of sigmas for a block of tracks
+inline void Response::GetNumberOfSigma(const std::size_t n, const float* tpcSignal, const float* expSignal, const float* expSigma, float* nSigma) const
+{
+  for (std::size_t i = 0; i < n; i++) {
+    nSigma[i] = (expSignal[i] < 0.f || expSigma[i] < 0.f) ? -999.f : (tpcSignal[i] - expSignal[i]) / expSigma[i];
+  }
+}
+
 inline void Response::PrintAll() const
 {
   LOGP(info, "==== TPC PID response parameters: ====");
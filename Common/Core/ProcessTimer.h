@@ -0,0 +1,124 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ProcessTimer.h
+/// \brief  Timing and counting of the sections of a task, e.g. process functions or hot loops
+///
+/// The sections are indexed by an enum of the task. Each section accumulates, in histograms of the
+/// task output binned in sections, its wall-clock time (ms), its number of calls and a counter of
+/// processed items (e.g. candidates), so that the cost per call and per item can be compared between runs.
+/// When the timer is not enabled, a scope costs one branch and nothing is registered in the output.
+///
+/// Usage:
+///   enum TimerSection { kProcess = 0, kFit, kNTimerSections };
+///   ProcessTimer timer;
+///   // in init(): timer.init(registry, {"process", "fit"}, enableTimer);
+///   // in a process function or a loop:
+///   auto scope = timer.scope(kFit); // the time is accumulated when scope goes out of scope
+///   timer.count(kFit, nCandidates);
+///
+
+#ifndef COMMON_CORE_PROCESSTIMER_H_
+#define COMMON_CORE_PROCESSTIMER_H_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <TH1.h>
+
+#include "Framework/HistogramRegistry.h"
+
+namespace o2::analysis
+{
+
+class ProcessTimer
+{
+ public:
+  /// Scope accumulating its lifetime in a section of the timer
+  class Scope
+  {
+   public:
+    Scope(ProcessTimer* timer, int section) : mTimer(timer), mSection(section)
+    {
+      if (mTimer != nullptr) {
+        mStart = std::chrono::steady_clock::now();
+      }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope()
+    {
+      if (mTimer != nullptr) {
+        mTimer->addTime(mSection, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStart).count());
+      }
+    }
+
+   private:
+    ProcessTimer* mTimer;
+    int mSection;
+    std::chrono::steady_clock::time_point mStart;
+  };
+
+  /// Registers the histograms of the sections in the registry of the task
+  /// \param registry histogram registry of the task
+  /// \param sections names of the sections, in the order of their indices
+  /// \param enable if false, nothing is registered and the timer does nothing
+  void init(o2::framework::HistogramRegistry& registry, std::vector<std::string> const& sections, bool enable)
+  {
+    mEnabled = enable;
+    if (!mEnabled) {
+      return;
+    }
+    using o2::framework::AxisSpec;
+    using o2::framework::HistType;
+    const AxisSpec axisSections{static_cast<int>(sections.size()), -0.5, sections.size() - 0.5, "section"};
+    mTime = registry.add<TH1>("ProcessTimer/hTime", "Wall-clock time per section;;time (ms)", HistType::kTH1D, {axisSections});
+    mCalls = registry.add<TH1>("ProcessTimer/hCalls", "Calls per section;;calls", HistType::kTH1D, {axisSections});
+    mItems = registry.add<TH1>("ProcessTimer/hItems", "Items processed per section;;items", HistType::kTH1D, {axisSections});
+    for (size_t iSection = 0; iSection < sections.size(); iSection++) {
+      for (auto& hist : {mTime, mCalls, mItems}) {
+        hist->GetXaxis()->SetBinLabel(iSection + 1, sections[iSection].c_str());
+      }
+    }
+  }
+
+  /// Returns a scope timing the section until it is destroyed
+  Scope scope(int section) { return Scope(mEnabled ? this : nullptr, section); }
+
+  /// Adds processed items to the counter of the section
+  void count(int section, double nItems = 1.)
+  {
+    if (mEnabled) {
+      mItems->Fill(section, nItems);
+    }
+  }
+
+  bool isEnabled() const { return mEnabled; }
+
+ private:
+  void addTime(int section, double time)
+  {
+    mTime->Fill(section, time);
+    mCalls->Fill(section);
+  }
+
+  bool mEnabled{false};
+  std::shared_ptr<TH1> mTime;  // accumulated wall-clock time per section (ms)
+  std::shared_ptr<TH1> mCalls; // number of calls per section
+  std::shared_ptr<TH1> mItems; // number of processed items per section
+};
+
+} // namespace o2::analysis
+
+#endif // COMMON_CORE_PROCESSTIMER_H_
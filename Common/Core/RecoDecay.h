@@ -17,14 +17,177 @@
 #ifndef COMMON_CORE_RECODECAY_H_
 #define COMMON_CORE_RECODECAY_H_
 
-#include <algorithm> // std::find
-#include <array>     // std::array
-#include <cmath>     // std::abs, std::sqrt
-#include <utility>   // std::move
-#include <vector>    // std::vector
+#include <algorithm>     // std::clamp, std::find
+#include <array>         // std::array
+#include <cmath>         // std::abs, std::sqrt
+#include <cstdint>       // int8_t, int64_t, uint64_t
+#include <functional>    // std::hash
+#include <span>          // std::span
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::move, std::pair
+#include <vector>        // std::vector
 
 #include "CommonConstants/MathConstants.h"
 
+/// Cache of the ancestry of the MC particles of a time frame
+///
+/// Filled once from the MC particle table, it stores in flat arrays the PDG code and the mother index range of each particle,
+/// its top ancestor and a hash of the PDG codes along its first-mother chain.
+/// The mother searches done through it (see RecoDecay::getMother and RecoDecay::getMatchedMCRec) do not access the table
+/// and their results are memoised, so that repeated searches for the same particle are O(1) lookups.
+
+class McParticleAncestry
+{
+ public:
+  /// Default constructor
+  McParticleAncestry() = default;
+
+  /// Default destructor
+  ~McParticleAncestry() = default;
+
+  /// Fills the cache from a table of MC particles.
+  /// \param particlesMC  table with MC particles
+  template <typename T>
+  void fill(const T& particlesMC)
+  {
+    const int64_t nParticles = particlesMC.size();
+    mOffset = particlesMC.offset();
+    mPdg.resize(nParticles);
+    mMotherFirst.resize(nParticles);
+    mMotherLast.resize(nParticles);
+    for (const auto& particle : particlesMC) {
+      const auto iPart = particle.globalIndex() - mOffset;
+      mPdg[iPart] = particle.pdgCode();
+      if (particle.has_mothers()) {
+        mMotherFirst[iPart] = particle.mothersIds().front();
+        mMotherLast[iPart] = particle.mothersIds().back();
+      } else {
+        mMotherFirst[iPart] = -1;
+        mMotherLast[iPart] = -1;
+      }
+    }
+    fillFirstMotherChains();
+    mMotherSearches.clear();
+  }
+
+  /// \return whether the particle with a given global index is in the cache
+  bool contains(int64_t index) const { return index >= mOffset && index - mOffset < static_cast<int64_t>(mPdg.size()); }
+  /// \return PDG code of the particle with a given global index
+  int getPdg(int64_t index) const { return mPdg[index - mOffset]; }
+  /// \return global index of the top ancestor (following the first mothers) of the particle with a given global index
+  int64_t getTopAncestor(int64_t index) const { return mTopAncestor[index - mOffset]; }
+  /// \return hash of the PDG codes along the first-mother chain of the particle with a given global index
+  std::size_t getDecayChainHash(int64_t index) const { return mChainHash[index - mOffset]; }
+
+  /// Finds the mother of an MC particle by looking for the expected PDG code in the mother chain.
+  /// \note Same search as RecoDecay::getMother, done on the cached arrays and memoised.
+  /// \param index  global index of the MC particle
+  /// \param PDGMother  expected mother PDG code
+  /// \param acceptAntiParticles  switch to accept the antiparticle of the expected mother
+  /// \param sign  antiparticle indicator of the found mother w.r.t. PDGMother; 1 if particle, -1 if antiparticle, 0 if mother not found
+  /// \param depthMax  maximum decay tree level to check; Mothers up to this level will be considered. If -1, all levels are considered.
+  /// \return index of the mother particle if found, -1 otherwise
+  int getMother(int64_t index, int PDGMother, bool acceptAntiParticles = false, int8_t* sign = nullptr, int8_t depthMax = -1)
+  {
+    const MotherSearchKey key{index, (static_cast<uint64_t>(static_cast<uint32_t>(PDGMother)) << 16) | (static_cast<uint64_t>(acceptAntiParticles) << 8) | static_cast<uint8_t>(depthMax)};
+    auto found = mMotherSearches.find(key);
+    if (found == mMotherSearches.end()) {
+      found = mMotherSearches.emplace(key, searchMother(index, PDGMother, acceptAntiParticles, depthMax)).first;
+    }
+    if (sign) {
+      *sign = found->second.second;
+    }
+    return found->second.first;
+  }
+
+ private:
+  using MotherSearchKey = std::pair<int64_t, uint64_t>; // particle index, packed (PDG code, antiparticles, depth)
+  struct MotherSearchKeyHash {
+    std::size_t operator()(const MotherSearchKey& key) const { return std::hash<int64_t>{}(key.first) ^ (std::hash<uint64_t>{}(key.second) * 0x9e3779b97f4a7c15ULL); }
+  };
+
+  int64_t mOffset{0};                                                                                 // global index of the first particle
+  std::vector<int> mPdg{};                                                                            // PDG codes
+  std::vector<int64_t> mMotherFirst{};                                                                // first mother index (-1 if no mother)
+  std::vector<int64_t> mMotherLast{};                                                                 // last mother index (-1 if no mother)
+  std::vector<int64_t> mTopAncestor{};                                                                // top ancestor index following the first mothers
+  std::vector<std::size_t> mChainHash{};                                                              // hash of the PDG codes along the first-mother chain
+  std::unordered_map<MotherSearchKey, std::pair<int, int8_t>, MotherSearchKeyHash> mMotherSearches{}; // memoised mother searches (mother index, sign)
+
+  /// Resolves the top ancestors and the decay-chain hashes, visiting each particle once.
+  void fillFirstMotherChains()
+  {
+    const int64_t nParticles = mPdg.size();
+    mTopAncestor.assign(nParticles, -1);
+    mChainHash.assign(nParticles, 0);
+    std::vector<int64_t> chain{};
+    for (int64_t iStart = 0; iStart < nParticles; ++iStart) {
+      // walk up the first mothers until a resolved particle, a particle without mother or a loop
+      chain.clear();
+      int64_t iPart = iStart;
+      while (mTopAncestor[iPart] < 0 && static_cast<int64_t>(chain.size()) < nParticles) {
+        chain.push_back(iPart);
+        const int64_t iMother = mMotherFirst[iPart] - mOffset;
+        if (mMotherFirst[iPart] < 0 || iMother < 0 || iMother >= nParticles || iMother == iPart) {
+          break;
+        }
+        iPart = iMother;
+      }
+      // resolve the chain from the top
+      int64_t top = mTopAncestor[iPart] >= 0 ? mTopAncestor[iPart] : iPart + mOffset;
+      std::size_t hash = mTopAncestor[iPart] >= 0 ? mChainHash[iPart] : 0;
+      for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        hash ^= std::hash<int>{}(mPdg[*it]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        mTopAncestor[*it] = top;
+        mChainHash[*it] = hash;
+      }
+    }
+  }
+
+  /// Breadth-first search of the mother, identical to RecoDecay::getMother
+  std::pair<int, int8_t> searchMother(int64_t index, int PDGMother, bool acceptAntiParticles, int8_t depthMax) const
+  {
+    const int64_t nParticles = mPdg.size();
+    int8_t sgn = 0;
+    int indexMother = -1;
+    int depth = 0;
+    bool motherFound = false;
+    std::vector<int64_t> idsStage{index}, idsNextStage{};
+    while (!motherFound && idsStage.size() > 0 && (depthMax < 0 || depth < depthMax)) {
+      idsNextStage.clear();
+      for (const auto iPart : idsStage) { // check all the particles that were the mothers at the previous stage
+        if (iPart - mOffset < 0 || iPart - mOffset >= nParticles || mMotherFirst[iPart - mOffset] < 0) {
+          continue;
+        }
+        for (auto iMother = mMotherFirst[iPart - mOffset]; iMother <= mMotherLast[iPart - mOffset]; ++iMother) { // loop over the mother particles of the analysed particle
+          if (std::find(idsNextStage.begin(), idsNextStage.end(), iMother) != idsNextStage.end()) {             // if a mother is still present in the vector, do not check it again
+            continue;
+          }
+          if (iMother - mOffset < 0 || iMother - mOffset >= nParticles) {
+            continue;
+          }
+          const auto PDGParticleIMother = mPdg[iMother - mOffset];
+          if (PDGParticleIMother == PDGMother) { // exact PDG match
+            sgn = 1;
+            indexMother = iMother;
+            motherFound = true;
+            break;
+          } else if (acceptAntiParticles && PDGParticleIMother == -PDGMother) { // antiparticle PDG match
+            sgn = -1;
+            indexMother = iMother;
+            motherFound = true;
+            break;
+          }
+          idsNextStage.push_back(iMother);
+        }
+      }
+      std::swap(idsStage, idsNextStage);
+      depth++;
+    }
+    return {indexMother, sgn};
+  }
+};
+
 /// Base class for calculating properties of reconstructed decays
 ///
 /// Provides static helper functions for:
@@ -514,6 +677,111 @@ class RecoDecay
     return maxNormDeltaIP;
   }
 
+  // Batch calculations for N candidates in structure-of-arrays layout
+  // Each vector quantity is passed as one span per component, all spans having the size of the output span.
+  // The loops have no branches nor calls to non-inlined functions so that they can be auto-vectorised.
+  // Unlike the scalar functions, the calculations are done in the type T of the arrays (float or double).
+
+  /// Calculates transverse momenta of N candidates.
+  /// \param px,py  {x, y} momentum components of the candidates
+  /// \param pt  output transverse momenta
+  template <typename T>
+  static void ptBatch(std::span<const T> px, std::span<const T> py, std::span<T> pt)
+  {
+    const std::size_t n = pt.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      pt[i] = std::sqrt(px[i] * px[i] + py[i] * py[i]);
+    }
+  }
+
+  /// Calculates invariant masses of N candidates from the momenta and masses of their prongs.
+  /// \param NProngs  number of prongs
+  /// \param arrMom  array of NProngs {x, y, z} momentum components of the prongs
+  /// \param arrMass  array of NProngs masses (in the same order as arrMom)
+  /// \param mass  output invariant masses
+  template <std::size_t NProngs, typename T, typename U>
+  static void mBatch(const std::array<std::array<std::span<const T>, 3>, NProngs>& arrMom, const std::array<U, NProngs>& arrMass, std::span<T> mass)
+  {
+    std::array<T, NProngs> arrMass2;
+    for (std::size_t iProng = 0; iProng < NProngs; ++iProng) {
+      arrMass2[iProng] = static_cast<T>(arrMass[iProng]) * static_cast<T>(arrMass[iProng]);
+    }
+    const std::size_t n = mass.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      T pxTot{0}, pyTot{0}, pzTot{0}, eTot{0};
+      for (std::size_t iProng = 0; iProng < NProngs; ++iProng) {
+        const T px = arrMom[iProng][0][i], py = arrMom[iProng][1][i], pz = arrMom[iProng][2][i];
+        pxTot += px;
+        pyTot += py;
+        pzTot += pz;
+        eTot += std::sqrt(px * px + py * py + pz * pz + arrMass2[iProng]);
+      }
+      mass[i] = std::sqrt(eTot * eTot - (pxTot * pxTot + pyTot * pyTot + pzTot * pzTot));
+    }
+  }
+
+  /// Calculates cosines of pointing angle of N candidates.
+  /// \param posPV  {x, y, z} positions of the primary vertices
+  /// \param posSV  {x, y, z} positions of the secondary vertices
+  /// \param mom  {x, y, z} momentum components of the candidates
+  /// \param cpa  output cosines of pointing angle
+  template <typename T>
+  static void cpaBatch(const std::array<std::span<const T>, 3>& posPV, const std::array<std::span<const T>, 3>& posSV, const std::array<std::span<const T>, 3>& mom, std::span<T> cpa)
+  {
+    const std::size_t n = cpa.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      const T lx = posSV[0][i] - posPV[0][i], ly = posSV[1][i] - posPV[1][i], lz = posSV[2][i] - posPV[2][i];
+      const T px = mom[0][i], py = mom[1][i], pz = mom[2][i];
+      const T cos = (lx * px + ly * py + lz * pz) / std::sqrt((lx * lx + ly * ly + lz * lz) * (px * px + py * py + pz * pz));
+      cpa[i] = std::clamp(cos, T(-1), T(1));
+    }
+  }
+
+  /// Calculates cosines of pointing angle in the {x, y} plane of N candidates.
+  /// \param posPV  {x, y} positions of the primary vertices
+  /// \param posSV  {x, y} positions of the secondary vertices
+  /// \param mom  {x, y} momentum components of the candidates
+  /// \param cpa  output cosines of pointing angle in {x, y}
+  template <typename T>
+  static void cpaXYBatch(const std::array<std::span<const T>, 2>& posPV, const std::array<std::span<const T>, 2>& posSV, const std::array<std::span<const T>, 2>& mom, std::span<T> cpa)
+  {
+    const std::size_t n = cpa.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      const T lx = posSV[0][i] - posPV[0][i], ly = posSV[1][i] - posPV[1][i];
+      const T px = mom[0][i], py = mom[1][i];
+      const T cos = (lx * px + ly * py) / std::sqrt((lx * lx + ly * ly) * (px * px + py * py));
+      cpa[i] = std::clamp(cos, T(-1), T(1));
+    }
+  }
+
+  /// Calculates decay lengths (3D distances between primary and secondary vertices) of N candidates.
+  /// \param posPV  {x, y, z} positions of the primary vertices
+  /// \param posSV  {x, y, z} positions of the secondary vertices
+  /// \param length  output decay lengths
+  template <typename T>
+  static void decayLengthBatch(const std::array<std::span<const T>, 3>& posPV, const std::array<std::span<const T>, 3>& posSV, std::span<T> length)
+  {
+    const std::size_t n = length.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      const T lx = posSV[0][i] - posPV[0][i], ly = posSV[1][i] - posPV[1][i], lz = posSV[2][i] - posPV[2][i];
+      length[i] = std::sqrt(lx * lx + ly * ly + lz * lz);
+    }
+  }
+
+  /// Calculates decay lengths in the {x, y} plane of N candidates.
+  /// \param posPV  {x, y} positions of the primary vertices
+  /// \param posSV  {x, y} positions of the secondary vertices
+  /// \param length  output decay lengths in {x, y}
+  template <typename T>
+  static void decayLengthXYBatch(const std::array<std::span<const T>, 2>& posPV, const std::array<std::span<const T>, 2>& posSV, std::span<T> length)
+  {
+    const std::size_t n = length.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      const T lx = posSV[0][i] - posPV[0][i], ly = posSV[1][i] - posPV[1][i];
+      length[i] = std::sqrt(lx * lx + ly * ly);
+    }
+  }
+
   /// Finds the mother of an MC particle by looking for the expected PDG code in the mother chain.
   /// \param particlesMC  table with MC particles
   /// \param particle  MC particle
@@ -660,6 +928,7 @@ class RecoDecay
   /// \param acceptAntiParticles  switch to accept the antiparticle version of the expected decay
   /// \param sign  antiparticle indicator of the found mother w.r.t. PDGMother; 1 if particle, -1 if antiparticle, 0 if mother not found
   /// \param depthMax  maximum decay tree level to check; Daughters up to this level will be considered. If -1, all levels are considered.
+  /// \param ancestry  optional cache of the MC particle ancestry, filled from particlesMC, used for the mother search
   /// \return index of the mother particle if the mother and daughters are correct, -1 otherwise
   template <std::size_t N, typename T, typename U>
   static int getMatchedMCRec(const T& particlesMC,
@@ -668,7 +937,8 @@ class RecoDecay
                              std::array<int, N> arrPDGDaughters,
                              bool acceptAntiParticles = false,
                              int8_t* sign = nullptr,
-                             int depthMax = 1)
+                             int depthMax = 1,
+                             McParticleAncestry* ancestry = nullptr)
   {
     // Printf("MC Rec: Expected mother PDG: %d", PDGMother);
     int8_t sgn = 0;                        // 1 if the expected mother is particle, -1 if antiparticle (w.r.t. PDGMother)
@@ -689,7 +959,11 @@ class RecoDecay
       if (iProng == 0) {
         // Get the mother index and its sign.
         // PDG code of the first daughter's mother determines whether the expected mother is a particle or antiparticle.
-        indexMother = getMother(particlesMC, particleI, PDGMother, acceptAntiParticles, &sgn, depthMax);
+        if (ancestry) {
+          indexMother = ancestry->getMother(particleI.globalIndex(), PDGMother, acceptAntiParticles, &sgn, depthMax);
+        } else {
+          indexMother = getMother(particlesMC, particleI, PDGMother, acceptAntiParticles, &sgn, depthMax);
+        }
         // Check whether mother was found.
         if (indexMother <= -1) {
           // Printf("MC Rec: Rejected: bad mother index or PDG");
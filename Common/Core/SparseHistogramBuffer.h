@@ -0,0 +1,194 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   SparseHistogramBuffer.h
+/// \brief  Buffer of the fills of a THnSparse, accumulated by bin in a flat hash table
+///
+/// The bin of each fill is found with the binning of the THnSparse axes, and its coordinates, including
+/// underflow and overflow, are packed in a 64-bit key. The weights are summed per key in an open-addressing
+/// hash table, so that a fill costs one lookup and no allocation, and the THnSparse is filled once per bin
+/// at flush(). The table keeps its storage between flushes and is flushed when it becomes full, so that its
+/// memory stays bounded. If the packed coordinates do not fit in 63 bits, the fills go directly to the THnSparse.
+/// The bin contents, errors and number of entries are the same as with THnSparse::Fill; the statistics
+/// sums of THnBase (used e.g. by GetMean) are not filled.
+///
+/// Usage:
+///   o2::analysis::SparseHistogramBuffer buffer;
+///   // in init(), after registry.add(...):
+///   buffer.init(registry.get<THnSparse>(HIST("hSparse")));
+///   // in process():
+///   buffer.fill(mass, pt, multiplicity);
+///   buffer.flush(); // at the latest at the end of the process function
+///
+
+#ifndef COMMON_CORE_SPARSEHISTOGRAMBUFFER_H_
+#define COMMON_CORE_SPARSEHISTOGRAMBUFFER_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <THnSparse.h>
+#include <TAxis.h>
+
+namespace o2::analysis
+{
+
+class SparseHistogramBuffer
+{
+ public:
+  /// \param histogram  histogram to be filled
+  /// \param capacity  number of bins kept in the buffer before it is flushed, rounded up to a power of 2
+  void init(std::shared_ptr<THnSparse> histogram, int capacity = 1 << 16)
+  {
+    mHistogram = histogram;
+    const int nDims = mHistogram->GetNdimensions();
+    mAxes.assign(nDims, Axis{});
+    int nBits = 0;
+    for (int iDim = 0; iDim < nDims; iDim++) {
+      const TAxis* axis = mHistogram->GetAxis(iDim);
+      auto& mAxis = mAxes[iDim];
+      mAxis.nBins = axis->GetNbins();
+      mAxis.min = axis->GetXmin();
+      mAxis.max = axis->GetXmax();
+      if (axis->GetXbins()->GetSize() > 0) {
+        mAxis.edges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->GetSize());
+      }
+      mAxis.shift = nBits;
+      while ((1ll << mAxis.nBits) < mAxis.nBins + 2) { // underflow and overflow bins included
+        mAxis.nBits++;
+      }
+      nBits += mAxis.nBits;
+    }
+    mIsBuffered = nBits <= 63; // all ones is the key of the empty slots
+    int size = 1;
+    while (size < 2 * capacity) {
+      size <<= 1;
+    }
+    mMask = size - 1;
+    mMaxNKeys = size / 2;
+    mKeys.assign(mIsBuffered ? size : 0, EmptyKey);
+    mSumW.assign(mKeys.size(), 0.);
+    mSumW2.assign(mKeys.size(), 0.);
+    mOccupied.clear();
+    mNFills = 0;
+    mCoordinates.resize(nDims);
+  }
+
+  /// Fills the bin of the values with a weight
+  void fillWeighted(const double* values, double weight)
+  {
+    if (!mIsBuffered) {
+      mHistogram->Fill(values, weight);
+      return;
+    }
+    uint64_t key = 0;
+    for (std::size_t iDim = 0; iDim < mAxes.size(); iDim++) {
+      key |= static_cast<uint64_t>(mAxes[iDim].findBin(values[iDim])) << mAxes[iDim].shift;
+    }
+    auto slot = (key * 0x9E3779B97F4A7C15ull >> 16) & mMask;
+    while (mKeys[slot] != key && mKeys[slot] != EmptyKey) {
+      slot = (slot + 1) & mMask;
+    }
+    if (mKeys[slot] == EmptyKey) {
+      mKeys[slot] = key;
+      mOccupied.push_back(slot);
+    }
+    mSumW[slot] += weight;
+    mSumW2[slot] += weight * weight;
+    mNFills++;
+    if (static_cast<int64_t>(mOccupied.size()) >= mMaxNKeys) {
+      flush();
+    }
+  }
+
+  /// Fills the bin of the values, given in the order of the axes, with weight 1
+  template <typename... Ts>
+  void fill(const Ts&... values)
+  {
+    std::array<double, sizeof...(Ts)> array{static_cast<double>(values)...};
+    fillWeighted(array.data(), 1.);
+  }
+
+  /// Adds the buffered bins to the histogram and empties the buffer
+  void flush()
+  {
+    if (mOccupied.empty()) {
+      return;
+    }
+    const bool calculateErrors = mHistogram->GetCalculateErrors();
+    for (const auto slot : mOccupied) {
+      for (std::size_t iDim = 0; iDim < mAxes.size(); iDim++) {
+        mCoordinates[iDim] = (mKeys[slot] >> mAxes[iDim].shift) & ((1ull << mAxes[iDim].nBits) - 1);
+      }
+      const auto bin = mHistogram->GetBin(mCoordinates.data(), true);
+      mHistogram->AddBinContent(bin, mSumW[slot]);
+      if (calculateErrors) {
+        mHistogram->AddBinError2(bin, mSumW2[slot]);
+      }
+      mKeys[slot] = EmptyKey;
+      mSumW[slot] = 0.;
+      mSumW2[slot] = 0.;
+    }
+    mHistogram->SetEntries(mHistogram->GetEntries() + mNFills);
+    mOccupied.clear();
+    mNFills = 0;
+  }
+
+  /// Number of bins in the buffer
+  std::size_t getNBins() const { return mOccupied.size(); }
+
+ private:
+  static constexpr uint64_t EmptyKey = ~0ull;
+
+  struct Axis {
+    int nBins = 1;
+    double min = 0.;
+    double max = 1.;
+    std::vector<double> edges; // bin edges, for variable binning
+    int shift = 0;             // position of the coordinate in the key
+    int nBits = 0;             // number of bits of the coordinate in the key
+
+    /// Same bin as TAxis::FindBin, with 0 for underflow and nBins + 1 for overflow
+    int findBin(double x) const
+    {
+      if (x < min) {
+        return 0;
+      }
+      if (!(x < max)) {
+        return nBins + 1;
+      }
+      if (edges.empty()) {
+        return 1 + static_cast<int>(nBins * (x - min) / (max - min));
+      }
+      return std::upper_bound(edges.begin(), edges.end(), x) - edges.begin();
+    }
+  };
+
+  std::shared_ptr<THnSparse> mHistogram;
+  std::vector<Axis> mAxes;
+  bool mIsBuffered = false;
+  uint64_t mMask = 0;
+  int64_t mMaxNKeys = 0;            // number of bins at which the buffer is flushed, half of the table
+  std::vector<uint64_t> mKeys;      // packed bin coordinates of the slots
+  std::vector<double> mSumW;        // sum of the weights of the slots
+  std::vector<double> mSumW2;       // sum of the squared weights of the slots
+  std::vector<uint64_t> mOccupied;  // occupied slots, in the order of the first fill
+  int64_t mNFills = 0;              // fills since the last flush
+  std::vector<Int_t> mCoordinates;  // buffer of flush()
+};
+
+} // namespace o2::analysis
+
+#endif // COMMON_CORE_SPARSEHISTOGRAMBUFFER_H_
@@ -16,11 +16,22 @@
 #include "Framework/Logger.h"
 #include "Common/Core/TrackSelection.h"
 
+namespace
+{
+uint8_t getITSLayersMask(const std::set<uint8_t>& layers)
+{
+  uint8_t mask = 0;
+  for (auto& layer : layers) {
+    mask |= 1 << layer;
+  }
+  return mask;
+}
+} // namespace
+
 bool TrackSelection::FulfillsITSHitRequirements(uint8_t itsClusterMap) const
 {
-  constexpr uint8_t bit = 1;
-  for (auto& itsRequirement : mRequiredITSHits) {
-    auto hits = std::count_if(itsRequirement.second.begin(), itsRequirement.second.end(), [&](auto&& requiredLayer) { return itsClusterMap & (bit << requiredLayer); });
+  for (auto& itsRequirement : mRequiredITSHitsMasks) {
+    auto hits = __builtin_popcount(itsClusterMap & itsRequirement.second);
     if ((itsRequirement.first == -1) && (hits > 0)) {
       return false; // no hits were required in specified layers
     } else if (hits < itsRequirement.first) {
@@ -115,11 +126,13 @@ void TrackSelection::SetRequireHitsInITSLayers(int8_t minNRequiredHits, std::set
 {
   // layer 0 corresponds to the the innermost ITS layer
   mRequiredITSHits.push_back(std::make_pair(minNRequiredHits, requiredLayers));
+  mRequiredITSHitsMasks.push_back(std::make_pair(minNRequiredHits, getITSLayersMask(requiredLayers)));
   LOG(info) << "Track selection, set require hits in ITS layers: " << static_cast<int>(minNRequiredHits);
 }
 void TrackSelection::SetRequireNoHitsInITSLayers(std::set<uint8_t> excludedLayers)
 {
   mRequiredITSHits.push_back(std::make_pair(-1, excludedLayers));
+  mRequiredITSHitsMasks.push_back(std::make_pair(-1, getITSLayersMask(excludedLayers)));
   LOG(info) << "Track selection, set require no hits in ITS layers";
 }
 
@@ -117,36 +117,45 @@ class TrackSelection
   }
 
   // Temporary function to check if track passes and return a flag. To be replaced by framework filters.
+  // The cuts are evaluated directly rather than through IsSelected(track, cut), to check the track type once
   template <typename T>
   uint16_t IsSelectedMask(T const& track) const
   {
-    uint16_t flag = 0;
+    const bool isRun2 = track.trackType() == o2::aod::track::Run2Track || track.trackType() == o2::aod::track::Run2Tracklet;
+    const float pt = track.pt();
+    const float eta = track.eta();
 
-    auto setFlag = [&](const TrackCuts& cut) {
-      if (IsSelected(track, cut)) {
-        flag |= 1UL << static_cast<int>(cut);
-      }
+    uint16_t flag = 0;
+    auto setFlag = [&](const TrackCuts& cut, bool isSelected) {
+      flag |= static_cast<uint16_t>(isSelected) << static_cast<int>(cut);
     };
 
-    setFlag(TrackCuts::kTrackType);
-    setFlag(TrackCuts::kPtRange);
-    setFlag(TrackCuts::kEtaRange);
-    setFlag(TrackCuts::kTPCNCls);
-    setFlag(TrackCuts::kTPCCrossedRows);
-    setFlag(TrackCuts::kTPCCrossedRowsOverNCls);
-    setFlag(TrackCuts::kTPCChi2NDF);
-    setFlag(TrackCuts::kTPCRefit);
-    setFlag(TrackCuts::kITSNCls);
-    setFlag(TrackCuts::kITSChi2NDF);
-    setFlag(TrackCuts::kITSRefit);
-    setFlag(TrackCuts::kITSHits);
-    setFlag(TrackCuts::kGoldenChi2);
-    setFlag(TrackCuts::kDCAxy);
-    setFlag(TrackCuts::kDCAz);
+    setFlag(TrackCuts::kTrackType, track.trackType() == mTrackType);
+    setFlag(TrackCuts::kPtRange, pt >= mMinPt && pt <= mMaxPt);
+    setFlag(TrackCuts::kEtaRange, eta >= mMinEta && eta <= mMaxEta);
+    setFlag(TrackCuts::kTPCNCls, track.tpcNClsFound() >= mMinNClustersTPC);
+    setFlag(TrackCuts::kTPCCrossedRows, track.tpcNClsCrossedRows() >= mMinNCrossedRowsTPC);
+    setFlag(TrackCuts::kTPCCrossedRowsOverNCls, track.tpcCrossedRowsOverFindableCls() >= mMinNCrossedRowsOverFindableClustersTPC);
+    setFlag(TrackCuts::kTPCChi2NDF, track.tpcChi2NCl() <= mMaxChi2PerClusterTPC);
+    setFlag(TrackCuts::kTPCRefit, mRequireTPCRefit ? (isRun2 ? (track.flags() & o2::aod::track::TPCrefit) != 0 : track.hasTPC()) : true);
+    setFlag(TrackCuts::kITSNCls, track.itsNCls() >= mMinNClustersITS);
+    setFlag(TrackCuts::kITSChi2NDF, track.itsChi2NCl() <= mMaxChi2PerClusterITS);
+    setFlag(TrackCuts::kITSRefit, mRequireITSRefit ? (isRun2 ? (track.flags() & o2::aod::track::ITSrefit) != 0 : track.hasITS()) : true);
+    setFlag(TrackCuts::kITSHits, FulfillsITSHitRequirements(track.itsClusterMap()));
+    setFlag(TrackCuts::kGoldenChi2, (isRun2 && mRequireGoldenChi2) ? (track.flags() & o2::aod::track::GoldenChi2) != 0 : true);
+    setFlag(TrackCuts::kDCAxy, abs(track.dcaXY()) <= ((mMaxDcaXYPtDep) ? mMaxDcaXYPtDep(pt) : mMaxDcaXY));
+    setFlag(TrackCuts::kDCAz, abs(track.dcaZ()) <= mMaxDcaZ);
 
     return flag;
   }
 
+  /// @brief Check if all the cuts are fulfilled in a flag returned by IsSelectedMask, i.e. if IsSelected would be true
+  static bool IsSelectedAllCuts(uint16_t flag)
+  {
+    constexpr uint16_t allCuts = (1 << static_cast<int>(TrackCuts::kNCuts)) - 1;
+    return flag == allCuts;
+  }
+
   // Temporary function to check if track passes a given selection criteria. To be replaced by framework filters.
   template <typename T>
   bool IsSelected(T const& track, const TrackCuts& cut) const
@@ -223,7 +232,11 @@ class TrackSelection
   void SetRequireHitsInITSLayers(int8_t minNRequiredHits, std::set<uint8_t> requiredLayers);
   void SetRequireNoHitsInITSLayers(std::set<uint8_t> excludedLayers);
   /// @brief Reset ITS requirements
-  void ResetITSRequirements() { mRequiredITSHits.clear(); }
+  void ResetITSRequirements()
+  {
+    mRequiredITSHits.clear();
+    mRequiredITSHitsMasks.clear();
+  }
 
   /// @brief Print the track selection
   void print() const;
@@ -255,8 +268,10 @@ class TrackSelection
 
   // vector of ITS requirements (minNRequiredHits in specific requiredLayers)
   std::vector<std::pair<int8_t, std::set<uint8_t>>> mRequiredITSHits{};
+  // same ITS requirements, with the layers as a bit mask of the ITS cluster map
+  std::vector<std::pair<int8_t, uint8_t>> mRequiredITSHitsMasks{};
 
-  ClassDefNV(TrackSelection, 1);
+  ClassDefNV(TrackSelection, 2);
 };
 
 #endif // COMMON_CORE_TRACKSELECTION_H_
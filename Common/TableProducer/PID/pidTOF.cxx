@@ -73,8 +73,9 @@ struct tofPid {
                                                  "Produce PID information for the various mass hypotheses. Values different than -1 override the automatic setup: the corresponding table can be set off (0) or on (1)"};
 
   // Running variables
-  std::vector<int> mEnabledParticles; // Vector of enabled PID hypotheses to loop on when making tables
-  int mLastCollisionId = -1;          // Last collision ID analysed
+  std::vector<int> mEnabledParticles;                // Vector of enabled PID hypotheses to loop on when making tables
+  int mLastCollisionId = -1;                         // Last collision ID analysed
+  o2::pid::tof::ExpTimesTrackInputs mExpTimesInputs; // Species-independent inputs of the expected times of the current track
   void init(o2::framework::InitContext& initContext)
   {
     if (inheritFromBaseTask.value) { // Inheriting from base task
@@ -323,42 +324,43 @@ struct tofPid {
 
       const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
       for (auto const& trkInColl : tracksInCollision) { // Loop on tracks
-        for (auto const& pidId : mEnabledParticles) {   // Loop on enabled particle hypotheses
+        mExpTimesInputs.set(mRespParamsV2, trkInColl);
+        for (auto const& pidId : mEnabledParticles) { // Loop on enabled particle hypotheses
           switch (pidId) {
             case 0:
-              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseEl.GetSeparation(mRespParamsV2, trkInColl),
+              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseEl.GetSeparation(mExpTimesInputs, trkInColl),
                                                                     tablePIDEl);
               break;
             case 1:
-              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseMu.GetSeparation(mRespParamsV2, trkInColl),
+              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseMu.GetSeparation(mExpTimesInputs, trkInColl),
                                                                     tablePIDMu);
               break;
             case 2:
-              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responsePi.GetSeparation(mRespParamsV2, trkInColl),
+              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responsePi.GetSeparation(mExpTimesInputs, trkInColl),
                                                                     tablePIDPi);
               break;
             case 3:
-              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseKa.GetSeparation(mRespParamsV2, trkInColl),
+              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseKa.GetSeparation(mExpTimesInputs, trkInColl),
                                                                     tablePIDKa);
               break;
             case 4:
-              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responsePr.GetSeparation(mRespParamsV2, trkInColl),
+              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responsePr.GetSeparation(mExpTimesInputs, trkInColl),
                                                                     tablePIDPr);
               break;
             case 5:
-              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseDe.GetSeparation(mRespParamsV2, trkInColl),
+              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseDe.GetSeparation(mExpTimesInputs, trkInColl),
                                                                     tablePIDDe);
               break;
             case 6:
-              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseTr.GetSeparation(mRespParamsV2, trkInColl),
+              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseTr.GetSeparation(mExpTimesInputs, trkInColl),
                                                                     tablePIDTr);
               break;
             case 7:
-              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseHe.GetSeparation(mRespParamsV2, trkInColl),
+              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseHe.GetSeparation(mExpTimesInputs, trkInColl),
                                                                     tablePIDHe);
               break;
             case 8:
-              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseAl.GetSeparation(mRespParamsV2, trkInColl),
+              aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseAl.GetSeparation(mExpTimesInputs, trkInColl),
                                                                     tablePIDAl);
               break;
             default:
@@ -411,42 +413,43 @@ struct tofPid {
         }
       }
 
+      mExpTimesInputs.set(mRespParamsV2, track);
       for (auto const& pidId : mEnabledParticles) { // Loop on enabled particle hypotheses
         switch (pidId) {
           case 0:
-            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseEl.GetSeparation(mRespParamsV2, track),
+            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseEl.GetSeparation(mExpTimesInputs, track),
                                                                   tablePIDEl);
             break;
           case 1:
-            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseMu.GetSeparation(mRespParamsV2, track),
+            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseMu.GetSeparation(mExpTimesInputs, track),
                                                                   tablePIDMu);
             break;
           case 2:
-            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responsePi.GetSeparation(mRespParamsV2, track),
+            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responsePi.GetSeparation(mExpTimesInputs, track),
                                                                   tablePIDPi);
             break;
           case 3:
-            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseKa.GetSeparation(mRespParamsV2, track),
+            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseKa.GetSeparation(mExpTimesInputs, track),
                                                                   tablePIDKa);
             break;
           case 4:
-            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responsePr.GetSeparation(mRespParamsV2, track),
+            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responsePr.GetSeparation(mExpTimesInputs, track),
                                                                   tablePIDPr);
             break;
           case 5:
-            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseDe.GetSeparation(mRespParamsV2, track),
+            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseDe.GetSeparation(mExpTimesInputs, track),
                                                                   tablePIDDe);
             break;
           case 6:
-            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseTr.GetSeparation(mRespParamsV2, track),
+            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseTr.GetSeparation(mExpTimesInputs, track),
                                                                   tablePIDTr);
             break;
           case 7:
-            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseHe.GetSeparation(mRespParamsV2, track),
+            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseHe.GetSeparation(mExpTimesInputs, track),
                                                                   tablePIDHe);
             break;
           case 8:
-            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseAl.GetSeparation(mRespParamsV2, track),
+            aod::pidutils::packInTable<aod::pidtof_tiny::binning>(responseAl.GetSeparation(mExpTimesInputs, track),
                                                                   tablePIDAl);
             break;
           default:
@@ -15,6 +15,9 @@
 /// \brief  Base to build tasks for TOF PID tasks.
 ///
 
+#include <algorithm>
+#include <cmath>
+#include <random>
 #include <utility>
 #include <vector>
 #include <string>
@@ -120,6 +123,160 @@ o2::tof::eventTimeContainer evTimeMakerForTracks(const trackTypeContainer& track
   return o2::tof::evTimeMakerFromParam<trackTypeContainer, trackType, trackFilter, response, responseParametersType>(tracks, responseParameters, diamond);
 }
 
+/// Iterative TOF event time maker for high multiplicity events
+/// Instead of the combinatorial search over the mass hypotheses, the event time is obtained by maximising the
+/// likelihood iteratively: each track takes the pion, kaon or proton hypothesis closest to the current event time,
+/// tracks further than maxChi2 are discarded, and the event time is recomputed as the weighted mean of the
+/// remaining tracks and of the diamond, until the assignment is stable. The cost is linear in the number of tracks.
+/// Optionally only an evenly spaced subsample of the tracks is used, and the resolution is estimated with bootstrap.
+class EvTimeMakerIterative
+{
+ public:
+  int maxNtracks = -1;    // maximum number of tracks used, evenly spaced in the track sample (-1: all)
+  int nBootstrap = 0;     // number of bootstrap samples for the resolution, if below 2 the resolution is the one of the weighted mean
+  float maxChi2 = 9.f;    // maximum chi2 of a track with respect to the event time
+  int maxIterations = 10; // maximum number of iterations
+
+  template <typename trackType,
+            bool (*trackFilter)(const trackType&),
+            template <typename T, o2::track::PID::ID> typename response,
+            typename trackTypeContainer,
+            typename responseParametersType>
+  o2::tof::eventTimeContainer compute(const trackTypeContainer& tracks,
+                                      const responseParametersType& responseParameters,
+                                      const float& diamond = 6.0)
+  {
+    const float errDiamond = diamond * 33.356409f;
+    const float weightDiamond = 1.f / (errDiamond * errDiamond);
+
+    // Per-track event time estimates and weights under the three hypotheses, in flat arrays
+    mTimes.clear();
+    mWeightsHyp.clear();
+    for (auto const& trk : tracks) {
+      if (!trackFilter(trk)) {
+        continue;
+      }
+      fillHypothesis<response<trackType, o2::track::PID::Pion>>(trk, responseParameters);
+      fillHypothesis<response<trackType, o2::track::PID::Kaon>>(trk, responseParameters);
+      fillHypothesis<response<trackType, o2::track::PID::Proton>>(trk, responseParameters);
+    }
+    const int nTracks = mTimes.size() / kNHypotheses;
+    const int stride = (maxNtracks > 0 && nTracks > maxNtracks) ? (nTracks + maxNtracks - 1) / maxNtracks : 1;
+
+    // Starting point: all the tracks are pions
+    mHypothesis.assign(nTracks, 0);
+    mUsed.assign(nTracks, 0);
+    for (int iTrack = 0; iTrack < nTracks; iTrack += stride) {
+      mUsed[iTrack] = mWeightsHyp[iTrack * kNHypotheses] > 0.f;
+    }
+    float eventTime = weightedMean(weightDiamond);
+    for (int iteration = 0; iteration < maxIterations; iteration++) {
+      bool changed = false;
+      for (int iTrack = 0; iTrack < nTracks; iTrack += stride) {
+        int best = -1;
+        float bestChi2 = maxChi2;
+        for (int iHyp = 0; iHyp < kNHypotheses; iHyp++) {
+          const int index = iTrack * kNHypotheses + iHyp;
+          const float delta = mTimes[index] - eventTime;
+          const float chi2 = delta * delta * mWeightsHyp[index];
+          if (mWeightsHyp[index] > 0.f && chi2 < bestChi2) {
+            bestChi2 = chi2;
+            best = iHyp;
+          }
+        }
+        const uint8_t used = best >= 0;
+        if (used != mUsed[iTrack] || (used && best != mHypothesis[iTrack])) {
+          changed = true;
+        }
+        mUsed[iTrack] = used;
+        mHypothesis[iTrack] = used ? best : 0;
+      }
+      const float previousTime = eventTime;
+      eventTime = weightedMean(weightDiamond);
+      if (!changed && std::abs(eventTime - previousTime) < 1.f) {
+        break;
+      }
+    }
+
+    // Output container, with the weights and times of the tracks used for the removal of the bias
+    o2::tof::eventTimeContainer evTime(0.f, errDiamond, diamond);
+    float sumOfWeights = weightDiamond;
+    int multiplicity = 0;
+    for (int iTrack = 0; iTrack < nTracks; iTrack++) {
+      const int index = iTrack * kNHypotheses + mHypothesis[iTrack];
+      const float weight = mUsed[iTrack] ? mWeightsHyp[index] : 0.f;
+      evTime.mWeights.push_back(weight);
+      evTime.mTrackTimes.push_back(mUsed[iTrack] ? mTimes[index] : 0.f);
+      sumOfWeights += weight;
+      multiplicity += mUsed[iTrack];
+    }
+    evTime.mEventTime = eventTime;
+    evTime.mEventTimeError = std::sqrt(1.f / sumOfWeights);
+    evTime.mEventTimeMultiplicity = multiplicity;
+    evTime.mSumOfWeights = sumOfWeights;
+    if (nBootstrap > 1 && multiplicity > 1) {
+      evTime.mEventTimeError = bootstrapResolution(weightDiamond);
+    }
+    return evTime;
+  }
+
+ private:
+  static constexpr int kNHypotheses = 3;
+  std::vector<float> mTimes;        // event time estimate of each track and hypothesis (ps)
+  std::vector<float> mWeightsHyp;   // inverse squared resolution of each track and hypothesis, 0 if not valid
+  std::vector<uint8_t> mHypothesis; // hypothesis of each track
+  std::vector<uint8_t> mUsed;       // flag of the tracks used for the event time
+  std::vector<int> mUsedIndices;    // tracks used for the event time, for the bootstrap
+  std::mt19937 mGenerator{1234};    // fixed seed, for reproducible results
+
+  template <typename responseType, typename trackType, typename responseParametersType>
+  void fillHypothesis(const trackType& trk, const responseParametersType& responseParameters)
+  {
+    const float sigma = responseType::GetExpectedSigma(responseParameters, trk, trk.tofSignal(), 0.f);
+    mTimes.push_back(trk.tofSignal() - responseType::GetCorrectedExpectedSignal(responseParameters, trk));
+    mWeightsHyp.push_back(sigma > 0.f ? 1.f / (sigma * sigma) : 0.f);
+  }
+
+  float weightedMean(const float weightDiamond) const
+  {
+    float sumOfWeights = weightDiamond; // the diamond is centered at 0
+    float sum = 0.f;
+    for (std::size_t iTrack = 0; iTrack < mUsed.size(); iTrack++) {
+      const int index = iTrack * kNHypotheses + mHypothesis[iTrack];
+      const float weight = mUsed[iTrack] ? mWeightsHyp[index] : 0.f;
+      sum += weight * mTimes[index];
+      sumOfWeights += weight;
+    }
+    return sum / sumOfWeights;
+  }
+
+  float bootstrapResolution(const float weightDiamond)
+  {
+    mUsedIndices.clear();
+    for (std::size_t iTrack = 0; iTrack < mUsed.size(); iTrack++) {
+      if (mUsed[iTrack]) {
+        mUsedIndices.push_back(iTrack * kNHypotheses + mHypothesis[iTrack]);
+      }
+    }
+    std::uniform_int_distribution<int> pick(0, mUsedIndices.size() - 1);
+    double sum = 0., sum2 = 0.;
+    for (int iSample = 0; iSample < nBootstrap; iSample++) {
+      float sumOfWeights = weightDiamond;
+      float sumSample = 0.f;
+      for (std::size_t iTrack = 0; iTrack < mUsedIndices.size(); iTrack++) {
+        const int index = mUsedIndices[pick(mGenerator)];
+        sumSample += mWeightsHyp[index] * mTimes[index];
+        sumOfWeights += mWeightsHyp[index];
+      }
+      const double eventTime = sumSample / sumOfWeights;
+      sum += eventTime;
+      sum2 += eventTime * eventTime;
+    }
+    const double mean = sum / nBootstrap;
+    return std::sqrt(std::max(0., sum2 / nBootstrap - mean * mean));
+  }
+};
+
 /// Task to produce the TOF event time table
 struct tofEventTime {
   // Tables to produce
@@ -135,6 +292,7 @@ struct tofEventTime {
   bool enableTableTOFOnly = false;
   // Detector response and input parameters
   o2::pid::tof::TOFResoParamsV2 mRespParamsV2;
+  EvTimeMakerIterative evTimeMakerIterative;
   Service<o2::ccdb::BasicCCDBManager> ccdb;
   Configurable<bool> inheritFromBaseTask{"inheritFromBaseTask", true, "Flag to iherit all common configurables from the TOF base task"};
   // CCDB configuration (inherited from TOF signal task)
@@ -146,6 +304,10 @@ struct tofEventTime {
   Configurable<float> maxEvTimeTOF{"maxEvTimeTOF", 100000.0f, "Maximum value of the TOF event time"};
   Configurable<bool> sel8TOFEvTime{"sel8TOFEvTime", false, "Flag to compute the ev. time only for events that pass the sel8 ev. selection"};
   Configurable<int> maxNtracksInSet{"maxNtracksInSet", 10, "Size of the set to consider for the TOF ev. time computation"};
+  Configurable<int> minNtracksIterative{"minNtracksIterative", -1, "Minimum number of tracks in the sample to compute the TOF ev. time with the iterative algorithm instead of the combinatorial one (-1: never)"};
+  Configurable<int> maxNtracksIterative{"maxNtracksIterative", -1, "Maximum number of tracks, evenly spaced in the sample, used by the iterative TOF ev. time algorithm (-1: all)"};
+  Configurable<int> nBootstrapIterative{"nBootstrapIterative", 0, "Number of bootstrap samples for the resolution of the iterative TOF ev. time (0: resolution of the weighted mean)"};
+  Configurable<float> maxChi2Iterative{"maxChi2Iterative", 9.f, "Maximum chi2 of a track with respect to the iterative TOF ev. time"};
   // TOF Calib configuration
   Configurable<std::string> paramFileName{"paramFileName", "", "Path to the parametrization object. If empty the parametrization is not taken from file"};
   Configurable<std::string> parametrizationPath{"parametrizationPath", "TOF/Calib/Params", "Path of the TOF parametrization on the CCDB or in the file, if the paramFileName is not empty"};
@@ -260,6 +422,28 @@ struct tofEventTime {
     mRespParamsV2.print();
     o2::tof::eventTimeContainer::setMaxNtracksInSet(maxNtracksInSet.value);
     o2::tof::eventTimeContainer::printConfig();
+    evTimeMakerIterative.maxNtracks = maxNtracksIterative.value;
+    evTimeMakerIterative.nBootstrap = nBootstrapIterative.value;
+    evTimeMakerIterative.maxChi2 = maxChi2Iterative.value;
+    if (minNtracksIterative.value >= 0) {
+      LOG(info) << "Iterative TOF ev. time for events with at least " << minNtracksIterative.value << " tracks in the sample";
+    }
+  }
+
+  /// Computes the TOF event time with the combinatorial algorithm, or with the iterative one for high multiplicity events
+  template <typename trackType, typename trackTypeContainer>
+  o2::tof::eventTimeContainer computeEvTimeTOF(const trackTypeContainer& tracksInCollision)
+  {
+    if (minNtracksIterative.value >= 0) {
+      int nTracksInSample = 0;
+      for (auto const& trk : tracksInCollision) {
+        nTracksInSample += filterForTOFEventTime(trk);
+      }
+      if (nTracksInSample >= minNtracksIterative.value) {
+        return evTimeMakerIterative.compute<trackType, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV2, diamond);
+      }
+    }
+    return evTimeMakerForTracks<trackType, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV2, diamond);
   }
 
   ///
@@ -326,7 +510,7 @@ struct tofEventTime {
       const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
 
       // First make table for event time
-      const auto evTimeTOF = evTimeMakerForTracks<TrksEvTime::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV2, diamond);
+      const auto evTimeTOF = computeEvTimeTOF<TrksEvTime::iterator>(tracksInCollision);
       int nGoodTracksForTOF = 0;
       float et = evTimeTOF.mEventTime;
       float erret = evTimeTOF.mEventTimeError;
@@ -389,7 +573,7 @@ struct tofEventTime {
       const auto& collision = t.collision_as<EvTimeCollisionsFT0>();
 
       // Compute the TOF event time
-      const auto evTimeTOF = evTimeMakerForTracks<TrksEvTime::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, mRespParamsV2, diamond);
+      const auto evTimeTOF = computeEvTimeTOF<TrksEvTime::iterator>(tracksInCollision);
 
       float t0AC[2] = {.0f, 999.f};                                                                                   // Value and error of T0A or T0C or T0AC
       float t0TOF[2] = {static_cast<float_t>(evTimeTOF.mEventTime), static_cast<float_t>(evTimeTOF.mEventTimeError)}; // Value and error of TOF
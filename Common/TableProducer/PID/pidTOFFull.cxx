@@ -73,8 +73,9 @@ struct tofPidFull {
                                                  "Produce PID information for the various mass hypotheses. Values different than -1 override the automatic setup: the corresponding table can be set off (0) or on (1)"};
 
   // Running variables
-  std::vector<int> mEnabledParticles; // Vector of enabled PID hypotheses to loop on when making tables
-  int mLastCollisionId = -1;          // Last collision ID analysed
+  std::vector<int> mEnabledParticles;                // Vector of enabled PID hypotheses to loop on when making tables
+  int mLastCollisionId = -1;                         // Last collision ID analysed
+  o2::pid::tof::ExpTimesTrackInputs mExpTimesInputs; // Species-independent inputs of the expected times of the current track
   void init(o2::framework::InitContext& initContext)
   {
     if (inheritFromBaseTask.value) { // Inheriting from base task
@@ -315,52 +316,53 @@ struct tofPidFull {
 
       const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
       for (auto const& trkInColl : tracksInCollision) { // Loop on tracks
-        for (auto const& pidId : mEnabledParticles) {   // Loop on enabled particle hypotheses
+        mExpTimesInputs.set(mRespParamsV2, trkInColl);
+        for (auto const& pidId : mEnabledParticles) { // Loop on enabled particle hypotheses
           switch (pidId) {
             case 0:
               resolution = responseEl.GetExpectedSigma(mRespParamsV2, trkInColl);
               tablePIDEl(resolution,
-                         responseEl.GetSeparation(mRespParamsV2, trkInColl, resolution));
+                         responseEl.GetSeparation(mExpTimesInputs, trkInColl, resolution));
               break;
             case 1:
               resolution = responseMu.GetExpectedSigma(mRespParamsV2, trkInColl);
               tablePIDMu(resolution,
-                         responseMu.GetSeparation(mRespParamsV2, trkInColl, resolution));
+                         responseMu.GetSeparation(mExpTimesInputs, trkInColl, resolution));
               break;
             case 2:
               resolution = responsePi.GetExpectedSigma(mRespParamsV2, trkInColl);
               tablePIDPi(resolution,
-                         responsePi.GetSeparation(mRespParamsV2, trkInColl, resolution));
+                         responsePi.GetSeparation(mExpTimesInputs, trkInColl, resolution));
               break;
             case 3:
               resolution = responseKa.GetExpectedSigma(mRespParamsV2, trkInColl);
               tablePIDKa(resolution,
-                         responseKa.GetSeparation(mRespParamsV2, trkInColl, resolution));
+                         responseKa.GetSeparation(mExpTimesInputs, trkInColl, resolution));
               break;
             case 4:
               resolution = responsePr.GetExpectedSigma(mRespParamsV2, trkInColl);
               tablePIDPr(resolution,
-                         responsePr.GetSeparation(mRespParamsV2, trkInColl, resolution));
+                         responsePr.GetSeparation(mExpTimesInputs, trkInColl, resolution));
               break;
             case 5:
               resolution = responseDe.GetExpectedSigma(mRespParamsV2, trkInColl);
               tablePIDDe(resolution,
-                         responseDe.GetSeparation(mRespParamsV2, trkInColl, resolution));
+                         responseDe.GetSeparation(mExpTimesInputs, trkInColl, resolution));
               break;
             case 6:
               resolution = responseTr.GetExpectedSigma(mRespParamsV2, trkInColl);
               tablePIDTr(resolution,
-                         responseTr.GetSeparation(mRespParamsV2, trkInColl, resolution));
+                         responseTr.GetSeparation(mExpTimesInputs, trkInColl, resolution));
               break;
             case 7:
               resolution = responseHe.GetExpectedSigma(mRespParamsV2, trkInColl);
               tablePIDHe(resolution,
-                         responseHe.GetSeparation(mRespParamsV2, trkInColl, resolution));
+                         responseHe.GetSeparation(mExpTimesInputs, trkInColl, resolution));
               break;
             case 8:
               resolution = responseAl.GetExpectedSigma(mRespParamsV2, trkInColl);
               tablePIDAl(resolution,
-                         responseAl.GetSeparation(mRespParamsV2, trkInColl, resolution));
+                         responseAl.GetSeparation(mExpTimesInputs, trkInColl, resolution));
               break;
             default:
               LOG(fatal) << "Wrong particle ID in processWSlice()";
@@ -412,52 +414,53 @@ struct tofPidFull {
         }
       }
 
+      mExpTimesInputs.set(mRespParamsV2, track);
       for (auto const& pidId : mEnabledParticles) { // Loop on enabled particle hypotheses
         switch (pidId) {
           case 0:
             resolution = responseEl.GetExpectedSigma(mRespParamsV2, track);
             tablePIDEl(resolution,
-                       responseEl.GetSeparation(mRespParamsV2, track, resolution));
+                       responseEl.GetSeparation(mExpTimesInputs, track, resolution));
             break;
           case 1:
             resolution = responseMu.GetExpectedSigma(mRespParamsV2, track);
             tablePIDMu(resolution,
-                       responseMu.GetSeparation(mRespParamsV2, track, resolution));
+                       responseMu.GetSeparation(mExpTimesInputs, track, resolution));
             break;
           case 2:
             resolution = responsePi.GetExpectedSigma(mRespParamsV2, track);
             tablePIDPi(resolution,
-                       responsePi.GetSeparation(mRespParamsV2, track));
+                       responsePi.GetSeparation(mExpTimesInputs, track));
             break;
           case 3:
             resolution = responseKa.GetExpectedSigma(mRespParamsV2, track);
             tablePIDKa(resolution,
-                       responseKa.GetSeparation(mRespParamsV2, track, resolution));
+                       responseKa.GetSeparation(mExpTimesInputs, track, resolution));
             break;
           case 4:
             resolution = responsePr.GetExpectedSigma(mRespParamsV2, track);
             tablePIDPr(resolution,
-                       responsePr.GetSeparation(mRespParamsV2, track, resolution));
+                       responsePr.GetSeparation(mExpTimesInputs, track, resolution));
             break;
           case 5:
             resolution = responseDe.GetExpectedSigma(mRespParamsV2, track);
             tablePIDDe(resolution,
-                       responseDe.GetSeparation(mRespParamsV2, track, resolution));
+                       responseDe.GetSeparation(mExpTimesInputs, track, resolution));
             break;
           case 6:
             resolution = responseTr.GetExpectedSigma(mRespParamsV2, track);
             tablePIDTr(resolution,
-                       responseTr.GetSeparation(mRespParamsV2, track, resolution));
+                       responseTr.GetSeparation(mExpTimesInputs, track, resolution));
             break;
           case 7:
             resolution = responseHe.GetExpectedSigma(mRespParamsV2, track);
             tablePIDHe(resolution,
-                       responseHe.GetSeparation(mRespParamsV2, track, resolution));
+                       responseHe.GetSeparation(mExpTimesInputs, track, resolution));
             break;
           case 8:
             resolution = responseAl.GetExpectedSigma(mRespParamsV2, track);
             tablePIDAl(resolution,
-                       responseAl.GetSeparation(mRespParamsV2, track, resolution));
+                       responseAl.GetSeparation(mExpTimesInputs, track, resolution));
             break;
           default:
             LOG(fatal) << "Wrong particle ID in processWoSlice()";
@@ -92,6 +92,7 @@ struct tpcPid {
   Configurable<bool> enableNetworkOptimizations{"enableNetworkOptimizations", 1, "(bool) If the neural network correction is used, this enables GraphOptimizationLevel::ORT_ENABLE_EXTENDED in the ONNX session"};
   Configurable<std::string> networkPathCCDB{"networkPathCCDB", "Analysis/PID/TPC/ML", "Path on CCDB"};
   Configurable<int> networkSetNumThreads{"networkSetNumThreads", 0, "Especially important for running on a SLURM cluster. Sets the number of threads used for execution."};
+  Configurable<int> networkBatchSize{"networkBatchSize", 100000, "Number of tracks evaluated per network inference call (0: all the tracks of the time frame at once)"};
   // Configuration flags to include and exclude particle hypotheses
   Configurable<int> pidEl{"pid-el", -1, {"Produce PID information for the Electron mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
   Configurable<int> pidMu{"pid-mu", -1, {"Produce PID information for the Muon mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
@@ -106,6 +107,12 @@ struct tpcPid {
   // Paramatrization configuration
   bool useCCDBParam = false;
 
+  // Column-wise track properties and response, reused between time frames
+  std::vector<float> trkInnerParam, trkTgl, trkSigned1Pt, trkNClsFound, trkMultTPC, trkSignal;
+  std::array<std::vector<float>, o2::track::PID::NIDs> expSignalPid, expSigmaPid, nSigmaPid;
+  // Network input tensor and predictions, reused between time frames
+  std::vector<float> track_properties, network_prediction, network_output;
+
   void init(o2::framework::InitContext& initContext)
   {
     response = new o2::pid::tpc::Response();
@@ -202,9 +209,6 @@ struct tpcPid {
     }
   }
 
-  Partition<Trks> notTPCStandaloneTracks = ((aod::track::itsClusterSizes > (uint32_t)0) || (aod::track::trdPattern > (uint8_t)0) || (aod::track::tofExpMom > 0.f && aod::track::tofChi2 > 0.f)); // To count number of tracks for use in NN array
-  Partition<Trks> tracksWithTPC = (aod::track::tpcNClsFindable > (uint8_t)0);
-
   void process(Coll const& collisions, Trks const& tracks,
                aod::BCsWithTimestamps const&)
   {
@@ -227,8 +231,7 @@ struct tpcPid {
     reserveTable(pidHe, tablePIDHe);
     reserveTable(pidAl, tablePIDAl);
 
-    std::vector<float> network_prediction;
-    const uint64_t tracksForNet_size = (skipTPCOnly) ? notTPCStandaloneTracks.size() : tracksWithTPC.size();
+    uint64_t tracksForNet_size = 0;
 
     if (useNetworkCorrection) {
       auto start_network_total = std::chrono::high_resolution_clock::now();
@@ -268,64 +271,71 @@ struct tpcPid {
       }
 
       // Defining some network parameters
-      int input_dimensions = network.getNumInputNodes();
-      int output_dimensions = network.getNumOutputNodes();
-      const uint64_t track_prop_size = input_dimensions * tracksForNet_size;
-      const uint64_t prediction_size = output_dimensions * tracksForNet_size;
-
-      network_prediction = std::vector<float>(prediction_size * 9); // For each mass hypotheses
+      const int input_dimensions = network.getNumInputNodes();
+      const int output_dimensions = network.getNumOutputNodes();
       const float nNclNormalization = response->GetNClNormalization();
-      float duration_network = 0;
+      const double start_network_time = network.getInferenceTime();
 
-      std::vector<float> track_properties(track_prop_size);
+      // Filling the preallocated input tensor once for all mass hypotheses: only the mass column changes between them
+      track_properties.resize(input_dimensions * outTable_size);
       uint64_t counter_track_props = 0;
-      int loop_counter = 0;
-
-      // Filling a std::vector<float> to be evaluated by the network
-      // Evaluation on single tracks brings huge overhead: Thus evaluation is done on one large vector
-      for (int i = 0; i < 9; i++) { // Loop over particle number for which network correction is used
-        for (auto const& trk : tracks) {
-          if (!trk.hasTPC()) {
+      for (auto const& trk : tracks) {
+        if (!trk.hasTPC()) {
+          continue;
+        }
+        if (skipTPCOnly) {
+          if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
             continue;
           }
-          if (skipTPCOnly) {
-            if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
-              continue;
-            }
-          }
-          track_properties[counter_track_props] = trk.tpcInnerParam();
-          track_properties[counter_track_props + 1] = trk.tgl();
-          track_properties[counter_track_props + 2] = trk.signed1Pt();
-          track_properties[counter_track_props + 3] = o2::track::pid_constants::sMasses[i];
-          track_properties[counter_track_props + 4] = collisions.iteratorAt(trk.collisionId()).multTPC() / 11000.;
-          track_properties[counter_track_props + 5] = std::sqrt(nNclNormalization / trk.tpcNClsFound());
-          counter_track_props += input_dimensions;
         }
+        track_properties[counter_track_props] = trk.tpcInnerParam();
+        track_properties[counter_track_props + 1] = trk.tgl();
+        track_properties[counter_track_props + 2] = trk.signed1Pt();
+        track_properties[counter_track_props + 4] = collisions.iteratorAt(trk.collisionId()).multTPC() / 11000.;
+        track_properties[counter_track_props + 5] = std::sqrt(nNclNormalization / trk.tpcNClsFound());
+        counter_track_props += input_dimensions;
+        tracksForNet_size++;
+      }
+      const uint64_t prediction_size = output_dimensions * tracksForNet_size;
+      network_prediction.resize(prediction_size * 9); // For each mass hypotheses
 
-        auto start_network_eval = std::chrono::high_resolution_clock::now();
-        float* output_network = network.evalModel(track_properties);
-        auto stop_network_eval = std::chrono::high_resolution_clock::now();
-        duration_network += std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_eval - start_network_eval).count();
-        for (uint64_t i = 0; i < prediction_size; i += output_dimensions) {
-          for (int j = 0; j < output_dimensions; j++) {
-            network_prediction[i + j + prediction_size * loop_counter] = output_network[i + j];
+      // Evaluation on single tracks brings huge overhead: evaluation is done on batches of networkBatchSize tracks, only for the enabled mass hypotheses
+      const uint64_t batch_size = (networkBatchSize.value > 0) ? static_cast<uint64_t>(networkBatchSize.value) : tracksForNet_size;
+      const std::array<const Configurable<int>*, 9> pidFlags{&pidEl, &pidMu, &pidPi, &pidKa, &pidPr, &pidDe, &pidTr, &pidHe, &pidAl};
+      int evaluated_hypotheses = 0;
+      for (int i = 0; i < 9; i++) { // Loop over particle number for which network correction is used
+        if (pidFlags[i]->value != 1) {
+          continue;
+        }
+        for (uint64_t j = 0; j < tracksForNet_size; j++) {
+          track_properties[j * input_dimensions + 3] = o2::track::pid_constants::sMasses[i];
+        }
+        for (uint64_t first = 0; first < tracksForNet_size; first += batch_size) {
+          const uint64_t n_batch = std::min(batch_size, tracksForNet_size - first);
+          if (network.evalModelBatch(track_properties.data() + first * input_dimensions, n_batch, network_output) != output_dimensions) {
+            LOGF(fatal, "Network output-dimensions incompatible!");
           }
+          std::copy(network_output.begin(), network_output.end(), network_prediction.begin() + prediction_size * i + first * output_dimensions);
         }
-
-        counter_track_props = 0;
-        loop_counter += 1;
+        evaluated_hypotheses++;
       }
-      track_properties.clear();
 
+      const float duration_network = (network.getInferenceTime() - start_network_time) * 1e9;
       auto stop_network_total = std::chrono::high_resolution_clock::now();
-      LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval ONNX): " << duration_network / (tracksForNet_size * 9) << "ns ; Total time (eval ONNX): " << duration_network / 1000000000 << " s";
-      LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / (tracksForNet_size * 9) << "ns ; Total time (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / 1000000000 << " s";
+      const uint64_t evaluated_tracks = std::max<uint64_t>(tracksForNet_size * evaluated_hypotheses, 1);
+      LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval ONNX): " << duration_network / evaluated_tracks << "ns ; Total time (eval ONNX): " << duration_network / 1000000000 << " s";
+      LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / evaluated_tracks << "ns ; Total time (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / 1000000000 << " s";
     }
 
-    uint64_t count_tracks = 0;
-
+    // Gather the track properties in contiguous arrays to evaluate the response column-wise
+    trkInnerParam.resize(outTable_size);
+    trkTgl.resize(outTable_size);
+    trkSigned1Pt.resize(outTable_size);
+    trkNClsFound.resize(outTable_size);
+    trkMultTPC.resize(outTable_size);
+    trkSignal.resize(outTable_size);
+    uint64_t iTrk = 0;
     for (auto const& trk : tracks) {
-      // Loop on Tracks
       if (trk.has_collision()) {
         const auto& bc = collisions.iteratorAt(trk.collisionId()).bc_as<aod::BCsWithTimestamps>();
         if (useCCDBParam && ccdbTimestamp.value == 0 && !ccdb->isCachedObjectValid(ccdbPath.value, bc.timestamp())) { // Updating parametrisation only if the initial timestamp is 0
@@ -345,8 +355,43 @@ struct tpcPid {
           response->PrintAll();
         }
       }
+      trkInnerParam[iTrk] = trk.tpcInnerParam();
+      trkTgl[iTrk] = trk.tgl();
+      trkSigned1Pt[iTrk] = trk.signed1Pt();
+      trkNClsFound[iTrk] = trk.tpcNClsFound();
+      trkMultTPC[iTrk] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).multTPC() : 0.f;
+      trkSignal[iTrk] = trk.tpcSignal();
+      iTrk++;
+    }
+
+    // Compute the response of all the tracks for each enabled mass hypothesis
+    auto makeResponse = [&outTable_size, this](const Configurable<int>& flag, const o2::track::PID::ID pid) {
+      if (flag.value != 1) {
+        return;
+      }
+      expSignalPid[pid].resize(outTable_size);
+      expSigmaPid[pid].resize(outTable_size);
+      nSigmaPid[pid].resize(outTable_size);
+      response->GetExpectedSignalAndSigma(pid, outTable_size, trkInnerParam.data(), trkTgl.data(), trkSigned1Pt.data(), trkNClsFound.data(), trkMultTPC.data(), expSignalPid[pid].data(), expSigmaPid[pid].data());
+      response->GetNumberOfSigma(outTable_size, trkSignal.data(), expSignalPid[pid].data(), expSigmaPid[pid].data(), nSigmaPid[pid].data());
+    };
+    makeResponse(pidEl, o2::track::PID::Electron);
+    makeResponse(pidMu, o2::track::PID::Muon);
+    makeResponse(pidPi, o2::track::PID::Pion);
+    makeResponse(pidKa, o2::track::PID::Kaon);
+    makeResponse(pidPr, o2::track::PID::Proton);
+    makeResponse(pidDe, o2::track::PID::Deuteron);
+    makeResponse(pidTr, o2::track::PID::Triton);
+    makeResponse(pidHe, o2::track::PID::Helium3);
+    makeResponse(pidAl, o2::track::PID::Alpha);
+
+    uint64_t count_tracks = 0;
+    iTrk = 0;
+
+    for (auto const& trk : tracks) {
+      // Loop on Tracks
       // Check and fill enabled tables
-      auto makeTable = [&trk, &collisions, &network_prediction, &count_tracks, &tracksForNet_size, this](const Configurable<int>& flag, auto& table, const o2::track::PID::ID pid) {
+      auto makeTable = [&trk, &iTrk, &count_tracks, &tracksForNet_size, this](const Configurable<int>& flag, auto& table, const o2::track::PID::ID pid) {
         if (flag.value != 1) {
           return;
         }
@@ -360,8 +405,8 @@ struct tpcPid {
             return;
           }
         }
-        auto expSignal = response->GetExpectedSignal(trk, pid);
-        auto expSigma = response->GetExpectedSigma(collisions.iteratorAt(trk.collisionId()), trk, pid);
+        const auto expSignal = expSignalPid[pid][iTrk];
+        const auto expSigma = expSigmaPid[pid][iTrk];
         if (expSignal < 0. || expSigma < 0.) { // skip if expected signal invalid
           table(aod::pidtpc_tiny::binning::underflowBin);
           return;
@@ -385,7 +430,7 @@ struct tpcPid {
             LOGF(fatal, "Network output-dimensions incompatible!");
           }
         } else {
-          aod::pidutils::packInTable<aod::pidtpc_tiny::binning>(response->GetNumberOfSigma(collisions.iteratorAt(trk.collisionId()), trk, pid), table);
+          aod::pidutils::packInTable<aod::pidtpc_tiny::binning>(nSigmaPid[pid][iTrk], table);
         }
       };
 
@@ -402,6 +447,7 @@ struct tpcPid {
       if (trk.hasTPC() && (!skipTPCOnly || trk.hasITS() || trk.hasTRD() || trk.hasTOF())) {
         count_tracks++; // Increment network track counter only if (not skipping TPConly) or (is not TPConly)
       }
+      iTrk++;
     }
   }
 };
@@ -29,6 +29,9 @@
 #include "PHOSBase/Geometry.h"
 #include "PHOSReconstruction/Clusterer.h"
 
+#include <unordered_map>
+#include <unordered_set>
+
 using namespace o2::framework;
 using namespace o2;
 
@@ -60,6 +63,9 @@ struct caloClusterProducerTask {
   std::vector<o2::phos::TriggerRecord> outputPHOSClusterTrigRecs;
   std::vector<int> mclabels;
   std::vector<float> mcamplitudes;
+  std::unordered_set<int64_t> phosClusterBCs;              // BCs with PHOS clusters
+  std::unordered_map<int64_t, int> cpvNMatchPointsIndex;   // position of the BCs in cpvNMatchPoints
+  std::unordered_map<int64_t, int> trackNMatchPointsIndex; // position of the BCs in trackNMatchPoints
 
   static constexpr int16_t kCpvX = 7; // grid 13 steps along z and 7 along phi as largest match ellips 20x10 cm
   static constexpr int16_t kCpvZ = 13;
@@ -248,6 +254,7 @@ struct caloClusterProducerTask {
     }
 
     // Fill output
+    indexMatchPoints(cpvNMatchPoints, cpvNMatchPointsIndex);
     for (auto& cluTR : outputPHOSClusterTrigRecs) {
       int firstClusterInEvent = cluTR.getFirstEntry();
       int lastClusterInEvent = firstClusterInEvent + cluTR.getNumberOfObjects();
@@ -265,13 +272,9 @@ struct caloClusterProducerTask {
 
       bool cpvExist = false;
       // find cpvTR for this BC
-      auto cpvPoints = cpvNMatchPoints.begin();
-      while (cpvPoints != cpvNMatchPoints.end()) {
-        if (cpvPoints->mTR == cluTR.getBCData().toLong()) {
-          cpvExist = true;
-          break;
-        }
-        cpvPoints++;
+      auto cpvPoints = findMatchPoints(cpvNMatchPoints, cpvNMatchPointsIndex, cluTR.getBCData().toLong());
+      if (cpvPoints != cpvNMatchPoints.end()) {
+        cpvExist = true;
       }
 
       for (int i = firstClusterInEvent; i < lastClusterInEvent; i++) {
@@ -310,36 +313,38 @@ struct caloClusterProducerTask {
 
         if (mod >= 2 && cpvExist) { // CPV exist in mods 2,3,4
           int phosIndex = CpvMatchIndex(mod, posX, posZ);
-          std::vector<int> regions;
-          regions.push_back(phosIndex);
+          int regions[9]; // at most 9 regions
+          int nRegions = 0;
+          regions[nRegions++] = phosIndex;
           if (posX > -cpvMaxX + cellSizeX) {
             if (posZ > -cpvMaxZ + cellSizeZ) { // bottom left
-              regions.push_back(phosIndex - kCpvZ - 1);
+              regions[nRegions++] = phosIndex - kCpvZ - 1;
             }
-            regions.push_back(phosIndex - kCpvZ);
+            regions[nRegions++] = phosIndex - kCpvZ;
             if (posZ < cpvMaxZ - cellSizeZ) { // top left
-              regions.push_back(phosIndex - kCpvZ + 1);
+              regions[nRegions++] = phosIndex - kCpvZ + 1;
             }
           }
           if (posZ > -cpvMaxZ + cellSizeZ) { // bottom
-            regions.push_back(phosIndex - 1);
+            regions[nRegions++] = phosIndex - 1;
           }
           if (posZ < cpvMaxZ - cellSizeZ) { // top
-            regions.push_back(phosIndex + 1);
+            regions[nRegions++] = phosIndex + 1;
           }
           if (posX < cpvMaxX - cellSizeX) {
             if (posZ > -cpvMaxZ + cellSizeZ) { // bottom right
-              regions.push_back(phosIndex + kCpvZ - 1);
+              regions[nRegions++] = phosIndex + kCpvZ - 1;
             }
-            regions.push_back(phosIndex + kCpvZ);
+            regions[nRegions++] = phosIndex + kCpvZ;
             if (posZ < cpvMaxZ - cellSizeZ) { // top right
-              regions.push_back(phosIndex + kCpvZ + 1);
+              regions[nRegions++] = phosIndex + kCpvZ + 1;
             }
           }
           float sigmaX = 1. / TMath::Min(5.2, 1.111 + 0.56 * TMath::Exp(-0.031 * e * e) + 4.8 / TMath::Power(e + 0.61, 3)); // inverse sigma X
           float sigmaZ = 1. / TMath::Min(3.3, 1.12 + 0.35 * TMath::Exp(-0.032 * e * e) + 0.75 / TMath::Power(e + 0.24, 3)); // inverse sigma Z
 
-          for (int indx : regions) {
+          for (int iRegion = 0; iRegion < nRegions; iRegion++) {
+            int indx = regions[iRegion];
             if (indx >= 0 && indx < kCpvCells) {
               for (int ii = cpvPoints->mStart[indx]; ii < cpvPoints->mEnd[indx]; ii++) {
                 auto p = cpvMatchPoints[indx][ii];
@@ -564,6 +569,7 @@ struct caloClusterProducerTask {
     }
 
     // Fill output
+    indexMatchPoints(cpvNMatchPoints, cpvNMatchPointsIndex);
     for (auto& cluTR : outputPHOSClusterTrigRecs) {
       int firstClusterInEvent = cluTR.getFirstEntry();
       int lastClusterInEvent = firstClusterInEvent + cluTR.getNumberOfObjects();
@@ -581,13 +587,9 @@ struct caloClusterProducerTask {
 
       bool cpvExist = false;
       // find cpvTR for this BC
-      auto cpvPoints = cpvNMatchPoints.begin();
-      while (cpvPoints != cpvNMatchPoints.end()) {
-        if (cpvPoints->mTR == cluTR.getBCData().toLong()) {
-          cpvExist = true;
-          break;
-        }
-        cpvPoints++;
+      auto cpvPoints = findMatchPoints(cpvNMatchPoints, cpvNMatchPointsIndex, cluTR.getBCData().toLong());
+      if (cpvPoints != cpvNMatchPoints.end()) {
+        cpvExist = true;
       }
 
       for (int i = firstClusterInEvent; i < lastClusterInEvent; i++) {
@@ -626,36 +628,38 @@ struct caloClusterProducerTask {
 
         if (mod >= 2 && cpvExist) { // CPV exist in mods 2,3,4
           int phosIndex = CpvMatchIndex(mod, posX, posZ);
-          std::vector<int> regions;
-          regions.push_back(phosIndex);
+          int regions[9]; // at most 9 regions
+          int nRegions = 0;
+          regions[nRegions++] = phosIndex;
           if (posX > -cpvMaxX + cellSizeX) {
             if (posZ > -cpvMaxZ + cellSizeZ) { // bottom left
-              regions.push_back(phosIndex - kCpvZ - 1);
+              regions[nRegions++] = phosIndex - kCpvZ - 1;
             }
-            regions.push_back(phosIndex - kCpvZ);
+            regions[nRegions++] = phosIndex - kCpvZ;
             if (posZ < cpvMaxZ - cellSizeZ) { // top left
-              regions.push_back(phosIndex - kCpvZ + 1);
+              regions[nRegions++] = phosIndex - kCpvZ + 1;
             }
           }
           if (posZ > -cpvMaxZ + cellSizeZ) { // bottom
-            regions.push_back(phosIndex - 1);
+            regions[nRegions++] = phosIndex - 1;
           }
           if (posZ < cpvMaxZ - cellSizeZ) { // top
-            regions.push_back(phosIndex + 1);
+            regions[nRegions++] = phosIndex + 1;
           }
           if (posX < cpvMaxX - cellSizeX) {
             if (posZ > -cpvMaxZ + cellSizeZ) { // bottom right
-              regions.push_back(phosIndex + kCpvZ - 1);
+              regions[nRegions++] = phosIndex + kCpvZ - 1;
             }
-            regions.push_back(phosIndex + kCpvZ);
+            regions[nRegions++] = phosIndex + kCpvZ;
             if (posZ < cpvMaxZ - cellSizeZ) { // top right
-              regions.push_back(phosIndex + kCpvZ + 1);
+              regions[nRegions++] = phosIndex + kCpvZ + 1;
             }
           }
           float sigmaX = 1. / TMath::Min(5.2, 1.111 + 0.56 * TMath::Exp(-0.031 * e * e) + 4.8 / TMath::Power(e + 0.61, 3)); // inverse sigma X
           float sigmaZ = 1. / TMath::Min(3.3, 1.12 + 0.35 * TMath::Exp(-0.032 * e * e) + 0.75 / TMath::Power(e + 0.24, 3)); // inverse sigma Z
 
-          for (int indx : regions) {
+          for (int iRegion = 0; iRegion < nRegions; iRegion++) {
+            int indx = regions[iRegion];
             if (indx >= 0 && indx < kCpvCells) {
               for (int ii = cpvPoints->mStart[indx]; ii < cpvPoints->mEnd[indx]; ii++) {
                 auto p = cpvMatchPoints[indx][ii];
@@ -884,13 +888,12 @@ struct caloClusterProducerTask {
         break;
       }
     }
-    bool keepBC = false;
+    // BCs with PHOS clusters, in which the tracks are kept
+    phosClusterBCs.clear();
     for (auto& cluTR : outputPHOSClusterTrigRecs) {
-      if (cluTR.getBCData().toLong() == curBC) {
-        keepBC = true;
-        break;
-      }
+      phosClusterBCs.insert(cluTR.getBCData().toLong());
     }
+    bool keepBC = phosClusterBCs.find(curBC) != phosClusterBCs.end();
     if (keepBC) {
       trackNMatchPoints.emplace_back();
       trackNMatchPoints.back().mTR = curBC;
@@ -911,13 +914,7 @@ struct caloClusterProducerTask {
           }
           curBC = track.collision().bc_as<aod::BCsWithTimestamps>().globalBC();
         }
-        keepBC = false;
-        for (auto& cluTR : outputPHOSClusterTrigRecs) {
-          if (cluTR.getBCData().toLong() == curBC) {
-            keepBC = true;
-            break;
-          }
-        }
+        keepBC = phosClusterBCs.find(curBC) != phosClusterBCs.end();
         if (!keepBC) {
           continue;
         }
@@ -946,6 +943,8 @@ struct caloClusterProducerTask {
     }
 
     // Fill output tables
+    indexMatchPoints(cpvNMatchPoints, cpvNMatchPointsIndex);
+    indexMatchPoints(trackNMatchPoints, trackNMatchPointsIndex);
     for (auto& cluTR : outputPHOSClusterTrigRecs) {
       int firstClusterInEvent = cluTR.getFirstEntry();
       int lastClusterInEvent = firstClusterInEvent + cluTR.getNumberOfObjects();
@@ -963,23 +962,14 @@ struct caloClusterProducerTask {
 
       bool cpvExist = false;
       // find cpvTR for this BC
-      auto cpvPoints = cpvNMatchPoints.begin();
-      while (cpvPoints != cpvNMatchPoints.end()) {
-        if (cpvPoints->mTR == cluTR.getBCData().toLong()) {
-          cpvExist = true;
-          break;
-        }
-        cpvPoints++;
+      auto cpvPoints = findMatchPoints(cpvNMatchPoints, cpvNMatchPointsIndex, cluTR.getBCData().toLong());
+      if (cpvPoints != cpvNMatchPoints.end()) {
+        cpvExist = true;
       }
 
-      // find cpvTR for this BC
-      auto trackPoints = trackNMatchPoints.begin();
-      while (trackPoints != trackNMatchPoints.end()) {
-        if (trackPoints->mTR == cluTR.getBCData().toLong()) {
-          break;
-        }
-        trackPoints++;
-      }
+      // find trackTR for this BC
+      auto trackPoints = findMatchPoints(trackNMatchPoints, trackNMatchPointsIndex, cluTR.getBCData().toLong());
+      bool trackExist = trackPoints != trackNMatchPoints.end();
 
       for (int i = firstClusterInEvent; i < lastClusterInEvent; i++) {
         o2::phos::Cluster& clu = outputPHOSClusters[i];
@@ -1015,30 +1005,31 @@ struct caloClusterProducerTask {
         const float cellSizeZ = 2 * cpvMaxZ / kCpvZ;
         // look 9 CPV regions around PHOS cluster
         int phosIndex = CpvMatchIndex(mod, posX, posZ);
-        std::vector<int> regions;
-        regions.push_back(phosIndex);
+        int regions[9]; // at most 9 regions
+        int nRegions = 0;
+        regions[nRegions++] = phosIndex;
         if (posX > -cpvMaxX + cellSizeX) {
           if (posZ > -cpvMaxZ + cellSizeZ) { // bottom left
-            regions.push_back(phosIndex - kCpvZ - 1);
+            regions[nRegions++] = phosIndex - kCpvZ - 1;
           }
-          regions.push_back(phosIndex - kCpvZ);
+          regions[nRegions++] = phosIndex - kCpvZ;
           if (posZ < cpvMaxZ - cellSizeZ) { // top left
-            regions.push_back(phosIndex - kCpvZ + 1);
+            regions[nRegions++] = phosIndex - kCpvZ + 1;
           }
         }
         if (posZ > -cpvMaxZ + cellSizeZ) { // bottom
-          regions.push_back(phosIndex - 1);
+          regions[nRegions++] = phosIndex - 1;
         }
         if (posZ < cpvMaxZ - cellSizeZ) { // top
-          regions.push_back(phosIndex + 1);
+          regions[nRegions++] = phosIndex + 1;
         }
         if (posX < cpvMaxX - cellSizeX) {
           if (posZ > -cpvMaxZ + cellSizeZ) { // bottom right
-            regions.push_back(phosIndex + kCpvZ - 1);
+            regions[nRegions++] = phosIndex + kCpvZ - 1;
           }
-          regions.push_back(phosIndex + kCpvZ);
+          regions[nRegions++] = phosIndex + kCpvZ;
           if (posZ < cpvMaxZ - cellSizeZ) { // top right
-            regions.push_back(phosIndex + kCpvZ + 1);
+            regions[nRegions++] = phosIndex + kCpvZ + 1;
           }
         }
         float sigmaX = 1. / TMath::Min(5.2, 1.111 + 0.56 * TMath::Exp(-0.031 * e * e) + 4.8 / TMath::Power(e + 0.61, 3)); // inverse sigma X
@@ -1047,8 +1038,9 @@ struct caloClusterProducerTask {
         // float cpvDx = 0., cpvDz = 0.;
         float trackDx = 9999., trackDz = 9999.;
         int trackindex = -1;
-        for (int indx : regions) {
-          if (indx >= 0 && indx < kCpvCells) {
+        for (int iRegion = 0; iRegion < nRegions; iRegion++) {
+          int indx = regions[iRegion];
+          if (cpvExist && indx >= 0 && indx < kCpvCells) {
             for (int ii = cpvPoints->mStart[indx]; ii < cpvPoints->mEnd[indx]; ii++) {
               auto p = cpvMatchPoints[indx][ii];
               float d = pow((p.first - posX) * sigmaX, 2) + pow((p.second - posZ) * sigmaZ, 2);
@@ -1059,6 +1051,9 @@ struct caloClusterProducerTask {
           }
 
           // same for tracks
+          if (!trackExist) {
+            continue;
+          }
           for (int ii = trackPoints->mStart[indx]; ii < trackPoints->mEnd[indx]; ii++) {
             auto pp = trackMatchPoints[indx][ii];
             float d = pow((pp.pX - posX) * sigmaX, 2) + pow((pp.pZ - posZ) * sigmaZ, 2); // TODO different sigma for tracks
@@ -1301,13 +1296,12 @@ struct caloClusterProducerTask {
         break;
       }
     }
-    bool keepBC = false;
+    // BCs with PHOS clusters, in which the tracks are kept
+    phosClusterBCs.clear();
     for (auto& cluTR : outputPHOSClusterTrigRecs) {
-      if (cluTR.getBCData().toLong() == curBC) {
-        keepBC = true;
-        break;
-      }
+      phosClusterBCs.insert(cluTR.getBCData().toLong());
     }
+    bool keepBC = phosClusterBCs.find(curBC) != phosClusterBCs.end();
     if (keepBC) {
       trackNMatchPoints.emplace_back();
       trackNMatchPoints.back().mTR = curBC;
@@ -1328,13 +1322,7 @@ struct caloClusterProducerTask {
           }
           curBC = track.collision().bc_as<aod::BCsWithTimestamps>().globalBC();
         }
-        keepBC = false;
-        for (auto& cluTR : outputPHOSClusterTrigRecs) {
-          if (cluTR.getBCData().toLong() == curBC) {
-            keepBC = true;
-            break;
-          }
-        }
+        keepBC = phosClusterBCs.find(curBC) != phosClusterBCs.end();
         if (!keepBC) {
           continue;
         }
@@ -1363,6 +1351,8 @@ struct caloClusterProducerTask {
     }
 
     // Fill output tables
+    indexMatchPoints(cpvNMatchPoints, cpvNMatchPointsIndex);
+    indexMatchPoints(trackNMatchPoints, trackNMatchPointsIndex);
     for (auto& cluTR : outputPHOSClusterTrigRecs) {
       int firstClusterInEvent = cluTR.getFirstEntry();
       int lastClusterInEvent = firstClusterInEvent + cluTR.getNumberOfObjects();
@@ -1380,23 +1370,14 @@ struct caloClusterProducerTask {
 
       bool cpvExist = false;
       // find cpvTR for this BC
-      auto cpvPoints = cpvNMatchPoints.begin();
-      while (cpvPoints != cpvNMatchPoints.end()) {
-        if (cpvPoints->mTR == cluTR.getBCData().toLong()) {
-          cpvExist = true;
-          break;
-        }
-        cpvPoints++;
+      auto cpvPoints = findMatchPoints(cpvNMatchPoints, cpvNMatchPointsIndex, cluTR.getBCData().toLong());
+      if (cpvPoints != cpvNMatchPoints.end()) {
+        cpvExist = true;
       }
 
-      // find cpvTR for this BC
-      auto trackPoints = trackNMatchPoints.begin();
-      while (trackPoints != trackNMatchPoints.end()) {
-        if (trackPoints->mTR == cluTR.getBCData().toLong()) {
-          break;
-        }
-        trackPoints++;
-      }
+      // find trackTR for this BC
+      auto trackPoints = findMatchPoints(trackNMatchPoints, trackNMatchPointsIndex, cluTR.getBCData().toLong());
+      bool trackExist = trackPoints != trackNMatchPoints.end();
 
       for (int i = firstClusterInEvent; i < lastClusterInEvent; i++) {
         o2::phos::Cluster& clu = outputPHOSClusters[i];
@@ -1432,30 +1413,31 @@ struct caloClusterProducerTask {
         const float cellSizeZ = 2 * cpvMaxZ / kCpvZ;
         // look 9 CPV regions around PHOS cluster
         int phosIndex = CpvMatchIndex(mod, posX, posZ);
-        std::vector<int> regions;
-        regions.push_back(phosIndex);
+        int regions[9]; // at most 9 regions
+        int nRegions = 0;
+        regions[nRegions++] = phosIndex;
         if (posX > -cpvMaxX + cellSizeX) {
           if (posZ > -cpvMaxZ + cellSizeZ) { // bottom left
-            regions.push_back(phosIndex - kCpvZ - 1);
+            regions[nRegions++] = phosIndex - kCpvZ - 1;
           }
-          regions.push_back(phosIndex - kCpvZ);
+          regions[nRegions++] = phosIndex - kCpvZ;
           if (posZ < cpvMaxZ - cellSizeZ) { // top left
-            regions.push_back(phosIndex - kCpvZ + 1);
+            regions[nRegions++] = phosIndex - kCpvZ + 1;
           }
         }
         if (posZ > -cpvMaxZ + cellSizeZ) { // bottom
-          regions.push_back(phosIndex - 1);
+          regions[nRegions++] = phosIndex - 1;
         }
         if (posZ < cpvMaxZ - cellSizeZ) { // top
-          regions.push_back(phosIndex + 1);
+          regions[nRegions++] = phosIndex + 1;
         }
         if (posX < cpvMaxX - cellSizeX) {
           if (posZ > -cpvMaxZ + cellSizeZ) { // bottom right
-            regions.push_back(phosIndex + kCpvZ - 1);
+            regions[nRegions++] = phosIndex + kCpvZ - 1;
           }
-          regions.push_back(phosIndex + kCpvZ);
+          regions[nRegions++] = phosIndex + kCpvZ;
           if (posZ < cpvMaxZ - cellSizeZ) { // top right
-            regions.push_back(phosIndex + kCpvZ + 1);
+            regions[nRegions++] = phosIndex + kCpvZ + 1;
           }
         }
         float sigmaX = 1. / TMath::Min(5.2, 1.111 + 0.56 * TMath::Exp(-0.031 * e * e) + 4.8 / TMath::Power(e + 0.61, 3)); // inverse sigma X
@@ -1464,8 +1446,9 @@ struct caloClusterProducerTask {
         // float cpvDx = 0., cpvDz = 0.;
         float trackDx = 9999., trackDz = 9999.;
         int trackindex = -1;
-        for (int indx : regions) {
-          if (indx >= 0 && indx < kCpvCells) {
+        for (int iRegion = 0; iRegion < nRegions; iRegion++) {
+          int indx = regions[iRegion];
+          if (cpvExist && indx >= 0 && indx < kCpvCells) {
             for (int ii = cpvPoints->mStart[indx]; ii < cpvPoints->mEnd[indx]; ii++) {
               auto p = cpvMatchPoints[indx][ii];
               float d = pow((p.first - posX) * sigmaX, 2) + pow((p.second - posZ) * sigmaZ, 2);
@@ -1476,6 +1459,9 @@ struct caloClusterProducerTask {
           }
 
           // same for tracks
+          if (!trackExist) {
+            continue;
+          }
           for (int ii = trackPoints->mStart[indx]; ii < trackPoints->mEnd[indx]; ii++) {
             auto pp = trackMatchPoints[indx][ii];
             float d = pow((pp.pX - posX) * sigmaX, 2) + pow((pp.pZ - posZ) * sigmaZ, 2); // TODO different sigma for tracks
@@ -1549,6 +1535,24 @@ struct caloClusterProducerTask {
 
   PROCESS_SWITCH(caloClusterProducerTask, processFullMC, "Process MC with track matching", false);
 
+  void indexMatchPoints(std::vector<trackTrigRec> const& points, std::unordered_map<int64_t, int>& index)
+  {
+    // index the BCs of the match points once instead of scanning them for each trigger record
+    index.clear();
+    for (size_t i = 0; i < points.size(); i++) {
+      index.emplace(points[i].mTR, i); // keep the first range of a BC, as found when scanning
+    }
+  }
+
+  std::vector<trackTrigRec>::const_iterator findMatchPoints(std::vector<trackTrigRec> const& points, std::unordered_map<int64_t, int> const& index, int64_t bc)
+  {
+    auto found = index.find(bc);
+    if (found == index.end()) {
+      return points.end();
+    }
+    return points.begin() + found->second;
+  }
+
   int CpvMatchIndex(int16_t module, float x, float z)
   {
     // calculate cell index in grid over PHOS detector
@@ -119,6 +119,10 @@ struct CentralityTable {
     TH1* mhMultSelCalib = nullptr;
     float mMCScalePars[6] = {0.0};
     TFormula* mMCScale = nullptr;
+    std::vector<float> mPercentiles; // contents of mhMultSelCalib, including underflow and overflow
+    int mNbins = 0;                  // number of bins of mhMultSelCalib if uniform, else 0
+    double mLowEdge = 0.;
+    double mHighEdge = 0.;
     explicit calibrationInfo(std::string name)
       : name(name),
         mCalibrationStored(false),
@@ -127,6 +131,32 @@ struct CentralityTable {
         mMCScale(nullptr)
     {
     }
+    // copies the calibration into a flat array, indexed directly for uniform bins
+    void storeLookupTable()
+    {
+      const TAxis* axis = mhMultSelCalib->GetXaxis();
+      mPercentiles.resize(axis->GetNbins() + 2);
+      for (int ibin = 0; ibin < axis->GetNbins() + 2; ++ibin) {
+        mPercentiles[ibin] = mhMultSelCalib->GetBinContent(ibin);
+      }
+      mNbins = axis->IsVariableBinSize() ? 0 : axis->GetNbins();
+      mLowEdge = axis->GetXmin();
+      mHighEdge = axis->GetXmax();
+    }
+    // same as mhMultSelCalib->GetBinContent(mhMultSelCalib->FindFixBin(multiplicity))
+    float getPercentile(float multiplicity) const
+    {
+      if (mNbins == 0) {
+        return mPercentiles[mhMultSelCalib->GetXaxis()->FindFixBin(multiplicity)];
+      }
+      if (multiplicity < mLowEdge) {
+        return mPercentiles.front();
+      }
+      if (!(multiplicity < mHighEdge)) {
+        return mPercentiles.back();
+      }
+      return mPercentiles[1 + static_cast<int>(mNbins * (multiplicity - mLowEdge) / (mHighEdge - mLowEdge))];
+    }
   };
   calibrationInfo FV0AInfo = calibrationInfo("FV0");
   calibrationInfo FT0MInfo = calibrationInfo("FT0");
@@ -417,6 +447,7 @@ struct CentralityTable {
                   LOGF(warning, "MC Scale information from %s for run %d not available", estimator.name.c_str(), bc.runNumber());
                 }
               }
+              estimator.storeLookupTable();
               estimator.mCalibrationStored = true;
             } else {
               LOGF(error, "Calibration information from %s for run %d not available", estimator.name.c_str(), bc.runNumber());
@@ -471,7 +502,7 @@ struct CentralityTable {
             scaledMultiplicity = scaleMC(multiplicity, estimator.mMCScalePars);
             LOGF(debug, "Unscaled %s multiplicity: %f, scaled %s multiplicity: %f", estimator.name.c_str(), multiplicity, estimator.name.c_str(), scaledMultiplicity);
           }
-          percentile = estimator.mhMultSelCalib->GetBinContent(estimator.mhMultSelCalib->FindFixBin(scaledMultiplicity));
+          percentile = estimator.getPercentile(scaledMultiplicity);
           if (assignOutOfRange)
             percentile = 100.5f;
         }
@@ -26,6 +26,10 @@
 
 #include "TH1D.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::aod::evsel;
@@ -36,6 +40,47 @@ using BCsWithBcSelsRun2 = soa::Join<aod::BCs, aod::Timestamps, aod::BcSels, aod:
 using BCsWithBcSelsRun3 = soa::Join<aod::BCs, aod::Timestamps, aod::BcSels>;
 using FullTracksIU = soa::Join<aod::TracksIU, aod::TracksExtra>;
 
+namespace
+{
+// pairs of global BC and BC index, sorted by global BC and searched with binary searches
+using BCIndexPair = std::pair<int64_t, int32_t>;
+
+// sorts by global BC and keeps only the last row of each BC, as a map filled in the BC order would
+void sortBCIndices(std::vector<BCIndexPair>& bcs)
+{
+  if (!std::is_sorted(bcs.begin(), bcs.end(), [](const auto& left, const auto& right) { return left.first < right.first; })) {
+    std::stable_sort(bcs.begin(), bcs.end(), [](const auto& left, const auto& right) { return left.first < right.first; });
+  }
+  auto itFirstKept = std::unique(bcs.rbegin(), bcs.rend(), [](const auto& left, const auto& right) { return left.first == right.first; });
+  bcs.erase(bcs.begin(), itFirstKept.base());
+}
+
+// index of the BC with the global BC, 0 if there is none
+int32_t findBC(int64_t globalBC, const std::vector<BCIndexPair>& bcs)
+{
+  auto it = std::lower_bound(bcs.begin(), bcs.end(), globalBC, [](const BCIndexPair& p, int64_t bc) { return p.first < bc; });
+  return (it != bcs.end() && it->first == globalBC) ? it->second : 0;
+}
+
+// index of the BC closest to the global BC, bcs must be sorted and not empty
+int32_t findClosest(int64_t globalBC, const std::vector<BCIndexPair>& bcs)
+{
+  auto it = std::lower_bound(bcs.begin(), bcs.end(), globalBC, [](const BCIndexPair& p, int64_t bc) { return p.first < bc; });
+  if (it == bcs.end()) {
+    return bcs.back().second;
+  }
+  int64_t bc1 = it->first;
+  int32_t index1 = it->second;
+  if (it != bcs.begin())
+    --it;
+  int64_t bc2 = it->first;
+  int32_t index2 = it->second;
+  int64_t dbc1 = std::abs(bc1 - globalBC);
+  int64_t dbc2 = std::abs(bc2 - globalBC);
+  return (dbc1 <= dbc2) ? index1 : index2;
+}
+} // namespace
+
 struct BcSelectionTask {
   Produces<aod::BcSels> bcsel;
   Service<o2::ccdb::BasicCCDBManager> ccdb;
@@ -198,11 +243,13 @@ struct BcSelectionTask {
     int64_t ts = bcs.iteratorAt(0).timestamp();
     auto alppar = ccdb->getForTimeStamp<o2::itsmft::DPLAlpideParam<0>>("ITS/Config/AlpideParam", ts);
 
-    // map from GlobalBC to BcId needed to find triggerBc
-    std::map<uint64_t, int32_t> mapGlobalBCtoBcId;
+    // sorted GlobalBC to BcId pairs needed to find triggerBc
+    std::vector<BCIndexPair> globalBCtoBcId;
+    globalBCtoBcId.reserve(bcs.size());
     for (auto& bc : bcs) {
-      mapGlobalBCtoBcId[bc.globalBC()] = bc.globalIndex();
+      globalBCtoBcId.emplace_back(bc.globalBC(), bc.globalIndex());
     }
+    sortBCIndices(globalBCtoBcId);
     int triggerBcShift = confTriggerBcShift;
     if (confTriggerBcShift == 999) {
       int run = bcs.iteratorAt(0).runNumber();
@@ -214,7 +261,7 @@ struct BcSelectionTask {
       TriggerAliases* aliases = ccdb->getForTimeStamp<TriggerAliases>("EventSelection/TriggerAliases", bc.timestamp());
       uint32_t alias{0};
       // workaround for pp2022 (trigger info is shifted by -294 bcs)
-      int32_t triggerBcId = mapGlobalBCtoBcId[bc.globalBC() + triggerBcShift];
+      int32_t triggerBcId = findBC(bc.globalBC() + triggerBcShift, globalBCtoBcId);
       if (triggerBcId) {
         auto triggerBc = bcs.iteratorAt(triggerBcId);
         uint64_t triggerMask = triggerBc.triggerMask();
@@ -356,19 +403,18 @@ struct EventSelectionTask {
   int lastRun = -1;                                          // last run number (needed to access ccdb only if run!=lastRun)
   std::bitset<o2::constants::lhc::LHCMaxBunches> bcPatternB; // bc pattern of colliding bunches
 
-  int32_t findClosest(int64_t globalBC, std::map<int64_t, int32_t>& bcs)
-  {
-    auto it = bcs.lower_bound(globalBC);
-    int64_t bc1 = it->first;
-    int32_t index1 = it->second;
-    if (it != bcs.begin())
-      --it;
-    int64_t bc2 = it->first;
-    int32_t index2 = it->second;
-    int64_t dbc1 = std::abs(bc1 - globalBC);
-    int64_t dbc2 = std::abs(bc2 - globalBC);
-    return (dbc1 <= dbc2) ? index1 : index2;
-  }
+  // per-collision counts of the PV contributors, filled in one pass over the tracks
+  struct ContributorCounts {
+    int nITStracks = 0;
+    int nTPCtracks = 0;
+    int nTOFtracks = 0;
+    int nTRDtracks = 0;
+    double timeFromTOFtracks = 0;
+    double timeFromTRDtracks = 0;
+  };
+  std::vector<ContributorCounts> contributorCounts;
+  std::vector<BCIndexPair> globalBcWithTVX;
+  std::vector<BCIndexPair> globalBcWithTOR;
 
   void init(InitContext&)
   {
@@ -458,7 +504,6 @@ struct EventSelectionTask {
   }
   PROCESS_SWITCH(EventSelectionTask, processRun2, "Process Run2 event selection", true);
 
-  Preslice<FullTracksIU> perCollision = aod::track::collisionId;
   void processRun3(aod::Collisions const& cols, FullTracksIU const& tracks, BCsWithBcSelsRun3 const& bcs)
   {
     int run = bcs.iteratorAt(0).runNumber();
@@ -470,10 +515,10 @@ struct EventSelectionTask {
       bcPatternB = grplhcif->getBunchFilling().getBCPattern();
     }
 
-    // create maps from globalBC to bc index for TVX or FT0-OR fired bcs
+    // create sorted lists of globalBC and bc index for TVX or FT0-OR fired bcs
     // to be used for closest TVX (FT0-OR) searches
-    std::map<int64_t, int32_t> mapGlobalBcWithTVX;
-    std::map<int64_t, int32_t> mapGlobalBcWithTOR;
+    globalBcWithTVX.clear();
+    globalBcWithTOR.clear();
     for (auto& bc : bcs) {
       int64_t globalBC = bc.globalBC();
       // skip non-colliding bcs for data and anchored runs
@@ -481,15 +526,17 @@ struct EventSelectionTask {
         continue;
       }
       if (bc.selection_bit(kIsBBT0A) || bc.selection_bit(kIsBBT0C)) {
-        mapGlobalBcWithTOR[globalBC] = bc.globalIndex();
+        globalBcWithTOR.emplace_back(globalBC, bc.globalIndex());
       }
       if (bc.selection_bit(kIsTriggerTVX)) {
-        mapGlobalBcWithTVX[globalBC] = bc.globalIndex();
+        globalBcWithTVX.emplace_back(globalBC, bc.globalIndex());
       }
     }
+    sortBCIndices(globalBcWithTOR);
+    sortBCIndices(globalBcWithTVX);
 
     // protection against empty FT0 maps
-    if (mapGlobalBcWithTOR.size() == 0 || mapGlobalBcWithTVX.size() == 0) {
+    if (globalBcWithTOR.size() == 0 || globalBcWithTVX.size() == 0) {
       LOGP(error, "FT0 table is empty or corrupted. Filling evsel table with dummy values");
       for (auto& col : cols) {
         auto bc = col.bc_as<BCsWithBcSelsRun3>();
@@ -503,35 +550,32 @@ struct EventSelectionTask {
       return;
     }
 
+    // count tracks of different types
+    contributorCounts.assign(cols.size(), ContributorCounts{});
+    for (auto& track : tracks) {
+      if (!track.isPVContributor() || track.collisionId() < 0) {
+        continue;
+      }
+      auto& counts = contributorCounts[track.collisionId()];
+      counts.nITStracks += track.hasITS();
+      counts.nTPCtracks += track.hasTPC();
+      counts.nTOFtracks += track.hasTOF();
+      counts.nTRDtracks += track.hasTRD() && !track.hasTOF();
+      // calculate average time using TOF and TRD tracks
+      if (track.hasTOF()) {
+        counts.timeFromTOFtracks += track.trackTime();
+      } else if (track.hasTRD()) {
+        counts.timeFromTRDtracks += track.trackTime();
+      }
+    }
+
     for (auto& col : cols) {
       auto bc = col.bc_as<BCsWithBcSelsRun3>();
       int64_t meanBC = bc.globalBC();
       const double bcNS = o2::constants::lhc::LHCBunchSpacingNS;
       int64_t deltaBC = std::ceil(col.collisionTimeRes() / bcNS * 4);
 
-      // count tracks of different types
-      int nITStracks = 0;
-      int nTPCtracks = 0;
-      int nTOFtracks = 0;
-      int nTRDtracks = 0;
-      double timeFromTOFtracks = 0;
-      double timeFromTRDtracks = 0;
-      auto tracksGrouped = tracks.sliceBy(perCollision, col.globalIndex());
-      for (auto& track : tracksGrouped) {
-        if (!track.isPVContributor()) {
-          continue;
-        }
-        nITStracks += track.hasITS();
-        nTPCtracks += track.hasTPC();
-        nTOFtracks += track.hasTOF();
-        nTRDtracks += track.hasTRD() && !track.hasTOF();
-        // calculate average time using TOF and TRD tracks
-        if (track.hasTOF()) {
-          timeFromTOFtracks += track.trackTime();
-        } else if (track.hasTRD()) {
-          timeFromTRDtracks += track.trackTime();
-        }
-      }
+      const auto& [nITStracks, nTPCtracks, nTOFtracks, nTRDtracks, timeFromTOFtracks, timeFromTRDtracks] = contributorCounts[col.globalIndex()];
       LOGP(debug, "nContrib={} nITStracks={} nTPCtracks={} nTOFtracks={} nTRDtracks={}", col.numContrib(), nITStracks, nTPCtracks, nTOFtracks, nTRDtracks);
 
       if (nTRDtracks > 0) {
@@ -547,12 +591,12 @@ struct EventSelectionTask {
       int64_t minBC = meanBC - deltaBC;
       int64_t maxBC = meanBC + deltaBC;
 
-      int32_t indexClosestTVX = findClosest(meanBC, mapGlobalBcWithTVX);
+      int32_t indexClosestTVX = findClosest(meanBC, globalBcWithTVX);
       int64_t tvxBC = bcs.iteratorAt(indexClosestTVX).globalBC();
       if (tvxBC >= minBC && tvxBC <= maxBC) { // closest TVX within search region
         bc.setCursor(indexClosestTVX);
       } else { // no TVX within search region, searching for TOR = T0A | T0C
-        int32_t indexClosestTOR = findClosest(meanBC, mapGlobalBcWithTOR);
+        int32_t indexClosestTOR = findClosest(meanBC, globalBcWithTOR);
         int64_t torBC = bcs.iteratorAt(indexClosestTOR).globalBC();
         if (torBC >= minBC && torBC <= maxBC) {
           bc.setCursor(indexClosestTOR);
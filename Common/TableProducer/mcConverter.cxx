@@ -20,11 +20,14 @@ using namespace o2::framework;
 struct McConverter {
   Produces<aod::StoredMcParticles_001> mcParticles_001;
 
+  std::vector<int> mothers; // reused for all the particles
+
   void process(aod::StoredMcParticles_000 const& mcParticles_000)
   {
+    mcParticles_001.reserve(mcParticles_000.size());
     for (auto& p : mcParticles_000) {
 
-      std::vector<int> mothers;
+      mothers.clear();
       if (p.mother0Id() >= 0) {
         mothers.push_back(p.mother0Id());
       }
@@ -10,9 +10,10 @@
 // or submit itself to any jurisdiction.
 
 #include <math.h>
-#include <onnxruntime/core/session/experimental_onnxruntime_cxx_api.h>
+#include <algorithm>
 #include <string>
 #include <regex>
+#include <vector>
 #include <TLorentzVector.h>
 #include "Common/DataModel/MftmchMatchingML.h"
 #include "Framework/AnalysisDataModel.h"
@@ -71,113 +72,74 @@ struct mftmchMatchingML {
   Configurable<int> cfgColWindow{"collision-window", 1, "Search window (collision ID) for MFT track"};
   Configurable<float> cfgXYWindow{"XY-window", 3, "Search window (delta XY) for MFT track"};
 
-  Ort::Env env{ORT_LOGGING_LEVEL_WARNING, "model-explorer"};
-  Ort::SessionOptions session_options;
-  std::shared_ptr<Ort::Experimental::Session> onnx_session = nullptr;
   OnnxModel model;
 
-  template <typename F, typename M>
-  std::vector<float> getVariables(F const& fwdtrack, M const& mfttrack)
-  {
+  static constexpr int NFeatures = 17; // input features of the model per MFT-MCH pair
+
+  // track parameters at the matching plane
+  struct MatchingPlaneParams {
+    float x;
+    float y;
+    float phi;
+    float tanl;
+  };
 
+  // MFT tracks at the matching plane, grouped by collision
+  std::vector<MatchingPlaneParams> mftParams;
+  std::vector<int> mftIdsByCollision;    // MFT track indices sorted by collision, and by x at the matching plane within a collision
+  std::vector<int> mftOffsetByCollision; // first entry of each collision in mftIdsByCollision
+  // candidate pairs passing the pre-selection and their features, evaluated in one batch
+  std::vector<float> pairFeatures;
+  std::vector<int> pairMFTIds;
+  std::vector<int> pairOffsetByMuon;
+  std::vector<float> pairScores;
+
+  template <typename T>
+  MatchingPlaneParams propagateToMatchingPlane(T const& track)
+  {
     static constexpr Double_t MatchingPlaneZ = -77.5;
 
-    // propagate muontrack to matching position
-    double muonchi2 = fwdtrack.chi2();
-    SMatrix5 muonpars(fwdtrack.x(), fwdtrack.y(), fwdtrack.phi(), fwdtrack.tgl(), fwdtrack.signed1Pt());
-    std::vector<double> muonv1;
-    SMatrix55 muoncovs(muonv1.begin(), muonv1.end());
-    o2::track::TrackParCovFwd muonpars1{fwdtrack.z(), muonpars, muoncovs, muonchi2};
-    muonpars1.propagateToZlinear(MatchingPlaneZ);
-
-    // propagate mfttrack to matching position
-    double mftchi2 = mfttrack.chi2();
-    SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
-    std::vector<double> mftv1;
-    SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
-    o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
-    mftpars1.propagateToZlinear(MatchingPlaneZ);
-
-    Float_t MFT_X = mftpars1.getX();
-    Float_t MFT_Y = mftpars1.getY();
-    Float_t MFT_Phi = mftpars1.getPhi();
-    Float_t MFT_Tanl = mftpars1.getTanl();
-
-    Float_t MCH_X = muonpars1.getX();
-    Float_t MCH_Y = muonpars1.getY();
-    Float_t MCH_Phi = muonpars1.getPhi();
-    Float_t MCH_Tanl = muonpars1.getTanl();
-
-    Float_t Ratio_X = MFT_X / MCH_X;
-    Float_t Ratio_Y = MFT_Y / MCH_Y;
-    Float_t Ratio_Phi = MFT_Phi / MCH_Phi;
-    Float_t Ratio_Tanl = MFT_Tanl / MCH_Tanl;
-
-    Float_t Delta_X = MFT_X - MCH_X;
-    Float_t Delta_Y = MFT_Y - MCH_Y;
-    Float_t Delta_Phi = MFT_Phi - MCH_Phi;
-    Float_t Delta_Tanl = MFT_Tanl - MCH_Tanl;
+    double chi2 = track.chi2();
+    SMatrix5 pars(track.x(), track.y(), track.phi(), track.tgl(), track.signed1Pt());
+    std::vector<double> v1;
+    SMatrix55 covs(v1.begin(), v1.end());
+    o2::track::TrackParCovFwd pars1{track.z(), pars, covs, chi2};
+    pars1.propagateToZlinear(MatchingPlaneZ);
+    return {static_cast<float>(pars1.getX()), static_cast<float>(pars1.getY()), static_cast<float>(pars1.getPhi()), static_cast<float>(pars1.getTanl())};
+  }
 
+  // appends the features of the pair to pairFeatures if it is within the XY window
+  bool addPairFeatures(MatchingPlaneParams const& mch, MatchingPlaneParams const& mft)
+  {
+    Float_t Delta_X = mft.x - mch.x;
+    Float_t Delta_Y = mft.y - mch.y;
     Float_t Delta_XY = sqrt(Delta_X * Delta_X + Delta_Y * Delta_Y);
-
-    std::vector<float> input_tensor_values{
-      MFT_X,
-      MFT_Y,
-      MFT_Phi,
-      MFT_Tanl,
-      MCH_X,
-      MCH_Y,
-      MCH_Phi,
-      MCH_Tanl,
+    if (!(Delta_XY < cfgXYWindow)) {
+      return false;
+    }
+    float features[NFeatures] = {
+      mft.x,
+      mft.y,
+      mft.phi,
+      mft.tanl,
+      mch.x,
+      mch.y,
+      mch.phi,
+      mch.tanl,
       Delta_XY,
       Delta_X,
       Delta_Y,
-      Delta_Phi,
-      Delta_Tanl,
-      Ratio_X,
-      Ratio_Y,
-      Ratio_Phi,
-      Ratio_Tanl,
+      mft.phi - mch.phi,
+      mft.tanl - mch.tanl,
+      mft.x / mch.x,
+      mft.y / mch.y,
+      mft.phi / mch.phi,
+      mft.tanl / mch.tanl,
     };
-    return input_tensor_values;
+    pairFeatures.insert(pairFeatures.end(), features, features + NFeatures);
+    return true;
   }
 
-  template <typename F, typename M>
-  double matchONNX(F const& fwdtrack, M const& mfttrack)
-  {
-    std::vector<std::string> input_names;
-    std::vector<std::vector<int64_t>> input_shapes;
-    std::vector<std::string> output_names;
-    std::vector<std::vector<int64_t>> output_shapes;
-
-    input_names = onnx_session->GetInputNames();
-    input_shapes = onnx_session->GetInputShapes();
-    output_names = onnx_session->GetOutputNames();
-    output_shapes = onnx_session->GetOutputShapes();
-
-    auto input_shape = input_shapes[0];
-    input_shape[0] = 1;
-
-    std::vector<float> input_tensor_values;
-    input_tensor_values = getVariables(fwdtrack, mfttrack);
-
-    if (input_tensor_values[8] < cfgXYWindow) {
-      std::vector<Ort::Value> input_tensors;
-      input_tensors.push_back(Ort::Experimental::Value::CreateTensor<float>(input_tensor_values.data(), input_tensor_values.size(), input_shape));
-
-      std::vector<Ort::Value> output_tensors = onnx_session->Run(input_names, input_tensors, output_names);
-
-      const float* output_value = output_tensors[0].GetTensorData<float>();
-
-      auto score = output_value[0];
-
-      return score;
-    } else {
-      auto score = 0;
-      return score;
-    }
-  };
-
   void init(o2::framework::InitContext&)
   {
     o2::ccdb::CcdbApi ccdbApi;
@@ -195,7 +157,9 @@ struct mftmchMatchingML {
                 << "."
                 << "/" << cfgModelName.value;
       model.initModel(cfgModelName, false, 1, strtoul(headers["Valid-From"].c_str(), NULL, 0), strtoul(headers["Valid-Until"].c_str(), NULL, 0));
-      onnx_session = model.getSession();
+      if (model.getNumInputNodes() != NFeatures) {
+        LOG(fatal) << "Model expects " << model.getNumInputNodes() << " input features instead of " << NFeatures;
+      }
     } else {
       LOG(info) << "Failed to retrieve Network file";
     }
@@ -203,41 +167,92 @@ struct mftmchMatchingML {
 
   void process(aod::Collisions const& collisions, soa::Filtered<aod::FwdTracks> const& fwdtracks, aod::MFTTracks const& mfttracks)
   {
+    // propagate the MFT tracks to the matching plane once and group them by collision
+    mftParams.clear();
+    mftParams.reserve(mfttracks.size());
+    mftOffsetByCollision.assign(collisions.size() + 1, 0);
+    for (auto& mfttrack : mfttracks) {
+      mftParams.push_back(propagateToMatchingPlane(mfttrack));
+      if (mfttrack.has_collision()) {
+        mftOffsetByCollision[mfttrack.collisionId() + 1]++;
+      }
+    }
+    for (size_t i = 1; i < mftOffsetByCollision.size(); i++) {
+      mftOffsetByCollision[i] += mftOffsetByCollision[i - 1];
+    }
+    mftIdsByCollision.resize(mftOffsetByCollision.back());
+    std::vector<int> fillPosition(mftOffsetByCollision.begin(), mftOffsetByCollision.end() - 1);
+    for (auto& mfttrack : mfttracks) {
+      if (mfttrack.has_collision()) {
+        mftIdsByCollision[fillPosition[mfttrack.collisionId()]++] = mfttrack.globalIndex();
+      }
+    }
+    auto xLess = [this](int id1, int id2) { return mftParams[id1].x < mftParams[id2].x; };
+    for (size_t collisionId = 0; collisionId + 1 < mftOffsetByCollision.size(); collisionId++) {
+      std::sort(mftIdsByCollision.begin() + mftOffsetByCollision[collisionId], mftIdsByCollision.begin() + mftOffsetByCollision[collisionId + 1], xLess);
+    }
+
+    // collect the features of the candidate pairs of all muons: the MFT tracks of the collisions
+    // in the search window which are within the XY window at the matching plane, looking only
+    // at the MFT tracks within the X window thanks to their ordering in x
+    pairFeatures.clear();
+    pairMFTIds.clear();
+    pairOffsetByMuon.clear();
     for (auto& fwdtrack : fwdtracks) {
-      if (fwdtrack.trackType() == aod::fwdtrack::ForwardTrackTypeEnum::MuonStandaloneTrack) {
-        double bestscore = 0;
-        int bestmfttrackid = -1;
-        for (auto& mfttrack : mfttracks) {
-          if (fwdtrack.has_collision() && mfttrack.has_collision()) {
-            if (0 <= fwdtrack.collisionId() - mfttrack.collisionId() && fwdtrack.collisionId() - mfttrack.collisionId() < cfgColWindow) {
-              double result = matchONNX(fwdtrack, mfttrack);
-              if (result > cfgThrScore) {
-                bestscore = result;
-                bestmfttrackid = mfttrack.globalIndex();
-              }
-            }
+      pairOffsetByMuon.push_back(pairMFTIds.size());
+      if (fwdtrack.trackType() != aod::fwdtrack::ForwardTrackTypeEnum::MuonStandaloneTrack || !fwdtrack.has_collision()) {
+        continue;
+      }
+      MatchingPlaneParams mchParams = propagateToMatchingPlane(fwdtrack);
+      int firstCollision = std::max(0, fwdtrack.collisionId() - cfgColWindow + 1);
+      for (int collisionId = firstCollision; collisionId <= fwdtrack.collisionId(); collisionId++) {
+        auto first = mftIdsByCollision.begin() + mftOffsetByCollision[collisionId];
+        auto last = mftIdsByCollision.begin() + mftOffsetByCollision[collisionId + 1];
+        first = std::lower_bound(first, last, mchParams.x - cfgXYWindow, [this](int id, float x) { return mftParams[id].x < x; });
+        for (auto it = first; it != last && mftParams[*it].x < mchParams.x + cfgXYWindow; it++) {
+          if (addPairFeatures(mchParams, mftParams[*it])) {
+            pairMFTIds.push_back(*it);
           }
         }
-        if (bestmfttrackid != -1) {
-          for (auto& mfttrack : mfttracks) {
-            if (mfttrack.globalIndex() == bestmfttrackid) {
-              double mftchi2 = mfttrack.chi2();
-              SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
-              std::vector<double> mftv1;
-              SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
-              o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
-              mftpars1.propagateToZlinear(mfttrack.collision().posZ());
-
-              float dcaX = (mftpars1.getX() - mfttrack.collision().posX());
-              float dcaY = (mftpars1.getY() - mfttrack.collision().posY());
-              double px = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * cos(mfttrack.phi());
-              double py = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * sin(mfttrack.phi());
-              double pz = fwdtrack.p() * cos(M_PI / 2 - atan(mfttrack.tgl()));
-              fwdtrackml(fwdtrack.collisionId(), 0, mfttrack.x(), mfttrack.y(), mfttrack.z(), mfttrack.phi(), mfttrack.tgl(), fwdtrack.sign() / std::sqrt(std::pow(px, 2) + std::pow(py, 2)), fwdtrack.nClusters(), fwdtrack.pDca(), fwdtrack.rAtAbsorberEnd(), 0, 0, 0, bestscore, mfttrack.globalIndex(), fwdtrack.globalIndex(), fwdtrack.mchBitMap(), fwdtrack.midBitMap(), fwdtrack.midBoards(), mfttrack.trackTime(), mfttrack.trackTimeRes(), mfttrack.eta(), std::sqrt(std::pow(px, 2) + std::pow(py, 2)), std::sqrt(std::pow(px, 2) + std::pow(py, 2) + std::pow(pz, 2)), dcaX, dcaY);
-            }
-          }
+      }
+    }
+    pairOffsetByMuon.push_back(pairMFTIds.size());
+
+    int64_t nScores = model.evalModelBatch(pairFeatures.data(), pairMFTIds.size(), pairScores);
+    if (nScores == 0 && !pairMFTIds.empty()) {
+      LOG(error) << "Matching scores could not be evaluated";
+      return;
+    }
+
+    int iMuon = 0;
+    for (auto& fwdtrack : fwdtracks) {
+      // the last MFT track, in the table order, with a score above threshold is kept
+      double bestscore = 0;
+      int bestmfttrackid = -1;
+      for (int iPair = pairOffsetByMuon[iMuon]; iPair < pairOffsetByMuon[iMuon + 1]; iPair++) {
+        double result = pairScores[iPair * nScores];
+        if (result > cfgThrScore && pairMFTIds[iPair] > bestmfttrackid) {
+          bestscore = result;
+          bestmfttrackid = pairMFTIds[iPair];
         }
       }
+      iMuon++;
+      if (bestmfttrackid != -1) {
+        auto mfttrack = mfttracks.iteratorAt(bestmfttrackid);
+        double mftchi2 = mfttrack.chi2();
+        SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
+        std::vector<double> mftv1;
+        SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
+        o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
+        mftpars1.propagateToZlinear(mfttrack.collision().posZ());
+
+        float dcaX = (mftpars1.getX() - mfttrack.collision().posX());
+        float dcaY = (mftpars1.getY() - mfttrack.collision().posY());
+        double px = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * cos(mfttrack.phi());
+        double py = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * sin(mfttrack.phi());
+        double pz = fwdtrack.p() * cos(M_PI / 2 - atan(mfttrack.tgl()));
+        fwdtrackml(fwdtrack.collisionId(), 0, mfttrack.x(), mfttrack.y(), mfttrack.z(), mfttrack.phi(), mfttrack.tgl(), fwdtrack.sign() / std::sqrt(std::pow(px, 2) + std::pow(py, 2)), fwdtrack.nClusters(), fwdtrack.pDca(), fwdtrack.rAtAbsorberEnd(), 0, 0, 0, bestscore, mfttrack.globalIndex(), fwdtrack.globalIndex(), fwdtrack.mchBitMap(), fwdtrack.midBitMap(), fwdtrack.midBoards(), mfttrack.trackTime(), mfttrack.trackTimeRes(), mfttrack.eta(), std::sqrt(std::pow(px, 2) + std::pow(py, 2)), std::sqrt(std::pow(px, 2) + std::pow(py, 2) + std::pow(pz, 2)), dcaX, dcaY);
+      }
     }
   }
 };
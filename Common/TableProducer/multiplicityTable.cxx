@@ -21,6 +21,9 @@ using namespace o2::framework;
 #include "Common/DataModel/Multiplicity.h"
 #include "TableHelper.h"
 #include "iostream"
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 static constexpr int kFV0Mults = 0;
 static constexpr int kFT0Mults = 1;
@@ -46,6 +49,7 @@ static const std::vector<std::string> tableNames{"FV0Mults",
                                                  "MultsExtraMC"};
 static const std::vector<std::string> parameterNames{"Enable"};
 static const int defaultParameters[nTables][nParameters]{{-1}, {-1}, {-1}, {-1}, {-1}, {-1}, {-1}, {-1}, {-1}, {-1}};
+static constexpr int kTrackTables[] = {kTPCMults, kPVMults, kMultsExtra}; // tables using the track counts in Run 3
 
 struct MultiplicityTableTaskIndexed {
   SliceCache cache;
@@ -210,13 +214,59 @@ struct MultiplicityTableTaskIndexed {
   PROCESS_SWITCH(MultiplicityTableTaskIndexed, processRun2, "Produce Run 2 multiplicity tables", false);
 
   using Run3Tracks = soa::Join<aod::TracksIU, aod::TracksExtra>;
-  Partition<Run3Tracks> tracksIUWithTPC = (aod::track::tpcNClsFindable > (uint8_t)0);
-  Partition<Run3Tracks> pvAllContribTracksIU = ((aod::track::flags & (uint32_t)o2::aod::track::PVContributor) == (uint32_t)o2::aod::track::PVContributor);
-  Partition<Run3Tracks> pvContribTracksIU = (nabs(aod::track::eta) < 0.8f) && ((aod::track::flags & (uint32_t)o2::aod::track::PVContributor) == (uint32_t)o2::aod::track::PVContributor);
-  Partition<Run3Tracks> pvContribTracksIUEta1 = (nabs(aod::track::eta) < 1.0f) && ((aod::track::flags & (uint32_t)o2::aod::track::PVContributor) == (uint32_t)o2::aod::track::PVContributor);
-  Partition<Run3Tracks> pvContribTracksIUEtaHalf = (nabs(aod::track::eta) < 0.5f) && ((aod::track::flags & (uint32_t)o2::aod::track::PVContributor) == (uint32_t)o2::aod::track::PVContributor);
+
+  // Track counters of a collision, filled for all the collisions in a single pass over the tracks
+  struct TrackCounts {
+    int nTPC = 0;             // tracks with TPC findable clusters
+    int nContribs = 0;        // PV contributors with |eta| < 0.8
+    int nContribsEta1 = 0;    // PV contributors with |eta| < 1
+    int nContribsEtaHalf = 0; // PV contributors with |eta| < 0.5
+    // PV contributors per detector
+    int nHasITS = 0, nHasTPC = 0, nHasTOF = 0, nHasTRD = 0;
+    int nITSonly = 0, nTPConly = 0, nITSTPC = 0;
+  };
+  std::vector<TrackCounts> trackCounts; // per collision, indexed by collision
+
+  void countTracks(Run3Tracks const& tracks, int nCollisions)
+  {
+    trackCounts.assign(nCollisions, TrackCounts{});
+    for (const auto& track : tracks) {
+      const int collisionId = track.collisionId();
+      if (collisionId < 0 || collisionId >= nCollisions) {
+        continue;
+      }
+      auto& counts = trackCounts[collisionId];
+      if (track.tpcNClsFindable() > 0) {
+        counts.nTPC++;
+      }
+      if ((track.flags() & o2::aod::track::PVContributor) != o2::aod::track::PVContributor) {
+        continue;
+      }
+      const float absEta = std::abs(track.eta());
+      counts.nContribs += absEta < 0.8f;
+      counts.nContribsEta1 += absEta < 1.0f;
+      counts.nContribsEtaHalf += absEta < 0.5f;
+      if (track.hasITS()) {
+        counts.nHasITS++;
+        if (track.hasTPC())
+          counts.nITSTPC++;
+        if (!track.hasTPC() && !track.hasTOF() && !track.hasTRD())
+          counts.nITSonly++;
+      }
+      if (track.hasTPC()) {
+        counts.nHasTPC++;
+        if (!track.hasITS() && !track.hasTOF() && !track.hasTRD())
+          counts.nTPConly++;
+      }
+      if (track.hasTOF())
+        counts.nHasTOF++;
+      if (track.hasTRD())
+        counts.nHasTRD++;
+    }
+  }
+
   void processRun3(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
-                   Run3Tracks const&,
+                   Run3Tracks const& tracks,
                    BCsWithRun3Matchings const&,
                    aod::Zdcs const&,
                    aod::FV0As const&,
@@ -261,6 +311,12 @@ struct MultiplicityTableTaskIndexed {
       }
     }
 
+    // count the tracks of all the collisions at once, instead of slicing track partitions for each collision
+    const bool countTracksNeeded = std::find_first_of(mEnabledTables.begin(), mEnabledTables.end(), std::begin(kTrackTables), std::end(kTrackTables)) != mEnabledTables.end();
+    if (countTracksNeeded) {
+      countTracks(tracks, collisions.size());
+    }
+
     // Initializing multiplicity values
     float multFV0A = 0.f;
     float multFV0C = 0.f;
@@ -388,50 +444,26 @@ struct MultiplicityTableTaskIndexed {
           } break;
           case kTPCMults: // TPC
           {
-            const auto& tracksGrouped = tracksIUWithTPC->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
-            const int multTPC = tracksGrouped.size();
+            const int multTPC = trackCounts[collision.globalIndex()].nTPC;
             tableTpc(multTPC);
             LOGF(debug, "multTPC=%i", multTPC);
           } break;
           case kPVMults: // PV multiplicity
           {
-            const auto& pvContribsGrouped = pvContribTracksIU->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
-            const auto& pvContribsEta1Grouped = pvContribTracksIUEta1->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
-            const auto& pvContribsEtaHalfGrouped = pvContribTracksIUEtaHalf->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
-            multNContribs = pvContribsGrouped.size();
-            const int multNContribsEta1 = pvContribsEta1Grouped.size();
-            const int multNContribsEtaHalf = pvContribsEtaHalfGrouped.size();
+            const auto& counts = trackCounts[collision.globalIndex()];
+            multNContribs = counts.nContribs;
+            const int multNContribsEta1 = counts.nContribsEta1;
+            const int multNContribsEtaHalf = counts.nContribsEtaHalf;
             tablePv(multNContribs, multNContribsEta1, multNContribsEtaHalf);
             LOGF(debug, "multNContribs=%i, multNContribsEta1=%i, multNContribsEtaHalf=%i", multNContribs, multNContribsEta1, multNContribsEtaHalf);
           } break;
           case kMultsExtra: // Extra
           {
-            int nHasITS = 0, nHasTPC = 0, nHasTOF = 0, nHasTRD = 0;
-            int nITSonly = 0, nTPConly = 0, nITSTPC = 0;
-            const auto& pvAllContribsGrouped = pvAllContribTracksIU->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
-
-            for (auto track : pvAllContribsGrouped) {
-              if (track.hasITS()) {
-                nHasITS++;
-                if (track.hasTPC())
-                  nITSTPC++;
-                if (!track.hasTPC() && !track.hasTOF() && !track.hasTRD())
-                  nITSonly++;
-              }
-              if (track.hasTPC()) {
-                nHasTPC++;
-                if (!track.hasITS() && !track.hasTOF() && !track.hasTRD())
-                  nTPConly++;
-              }
-              if (track.hasTOF())
-                nHasTOF++;
-              if (track.hasTRD())
-                nHasTRD++;
-            };
+            const auto& counts = trackCounts[collision.globalIndex()];
 
             int bcNumber = bc.globalBC() % 3564;
 
-            tableExtra(static_cast<float>(collision.numContrib()), collision.chi2(), collision.collisionTimeRes(), mRunNumber, collision.posZ(), collision.sel8(), nHasITS, nHasTPC, nHasTOF, nHasTRD, nITSonly, nTPConly, nITSTPC, bcNumber);
+            tableExtra(static_cast<float>(collision.numContrib()), collision.chi2(), collision.collisionTimeRes(), mRunNumber, collision.posZ(), collision.sel8(), counts.nHasITS, counts.nHasTPC, counts.nHasTOF, counts.nHasTRD, counts.nITSonly, counts.nTPConly, counts.nITSTPC, bcNumber);
           } break;
           case kMultZeqs: // Z equalized
           {
@@ -111,6 +111,15 @@ struct qVectorsTable {
   std::vector<float> qvecAmp;
   std::vector<std::vector<float>> cfgCorr;
 
+  // Cosine and sine of nmod*phi of each FIT channel, computed once at init as the
+  // channel positions and offsets do not change during the processing.
+  static constexpr int kNChFT0 = 208; // 96 channels in FT0-A + 112 in FT0-C.
+  static constexpr int kNChFV0 = 49;  // 48 channels in FV0-A + the reference one.
+  std::vector<float> cosPhiFT0;
+  std::vector<float> sinPhiFT0;
+  std::vector<float> cosPhiFV0;
+  std::vector<float> sinPhiFV0;
+
   // Variables for other classes.
   EventPlaneHelper helperEP;
 
@@ -172,6 +181,22 @@ struct qVectorsTable {
     cfgCorr.push_back(cfgBPosCorr);
     cfgCorr.push_back(cfgBNegCorr);
 
+    // Fill the cos/sin tables of the FIT channels, with the offsets set above.
+    cosPhiFT0.resize(kNChFT0);
+    sinPhiFT0.resize(kNChFT0);
+    for (int iCh = 0; iCh < kNChFT0; iCh++) {
+      double phi = helperEP.GetPhiFT0(iCh);
+      cosPhiFT0[iCh] = TMath::Cos(phi * cfgnMod);
+      sinPhiFT0[iCh] = TMath::Sin(phi * cfgnMod);
+    }
+    cosPhiFV0.resize(kNChFV0);
+    sinPhiFV0.resize(kNChFV0);
+    for (int iCh = 0; iCh < kNChFV0; iCh++) {
+      double phi = helperEP.GetPhiFV0(iCh);
+      cosPhiFV0[iCh] = TMath::Cos(phi * cfgnMod);
+      sinPhiFV0[iCh] = TMath::Sin(phi * cfgnMod);
+    }
+
     /*  // Debug printing.
       printf("Offset for FT0A: x = %.3f y = %.3f\n", (*offsetFT0)[0].getX(), (*offsetFT0)[0].getY());
       printf("Offset for FT0C: x = %.3f y = %.3f\n", (*offsetFT0)[1].getX(), (*offsetFT0)[1].getY());
@@ -190,6 +215,19 @@ struct qVectorsTable {
     histosQA.add("ChTracks", "", {HistType::kTHnSparseF, {axisPt, axisEta, axisPhi, axixCent}});
   }
 
+  /// Add the contribution of the channel 'chno' to the Q-vector and to the sum of
+  /// amplitudes, as EventPlaneHelper::SumQvectors does but with the tabulated cos/sin.
+  void SumQvectors(const std::vector<float>& cosPhi, const std::vector<float>& sinPhi,
+                   int det, int chno, float ampl, TComplex& Qvec, float& sum)
+  {
+    if (chno < 0 || chno >= static_cast<int>(cosPhi.size())) { // Not tabulated, use the geometry.
+      helperEP.SumQvectors(det, chno, ampl, cfgnMod, Qvec, sum);
+      return;
+    }
+    Qvec += TComplex(ampl * cosPhi[chno], ampl * sinPhi[chno]);
+    sum += ampl;
+  }
+
   template <typename TrackType>
   bool SelTrack(const TrackType track)
   {
@@ -260,8 +298,8 @@ struct qVectorsTable {
 
         // Update the Q-vector and sum of amplitudes using the helper function.
         // LOKI: Note this assumes nHarmo = 2!! Likely generalise in the future.
-        helperEP.SumQvectors(0, iChA, ampl, cfgnMod, QvecDet, sumAmplFT0A);
-        helperEP.SumQvectors(0, iChA, ampl, cfgnMod, QvecFT0M, sumAmplFT0M);
+        SumQvectors(cosPhiFT0, sinPhiFT0, 0, iChA, ampl, QvecDet, sumAmplFT0A);
+        SumQvectors(cosPhiFT0, sinPhiFT0, 0, iChA, ampl, QvecFT0M, sumAmplFT0M);
       } // Go to the next channel iChA.
 
       // Set the Qvectors for FT0A with the normalised Q-vector values if the sum of
@@ -283,8 +321,8 @@ struct qVectorsTable {
         // iChC ranging from 0 to max 112. We need to add 96 (= max channels in FT0-A)
         // to ensure a proper channel number in FT0 as a whole.
         float ampl = ft0.amplitudeC()[iChC];
-        helperEP.SumQvectors(0, iChC + 96, ampl, cfgnMod, QvecDet, sumAmplFT0C);
-        helperEP.SumQvectors(0, iChC + 96, ampl, cfgnMod, QvecFT0M, sumAmplFT0M);
+        SumQvectors(cosPhiFT0, sinPhiFT0, 0, iChC + 96, ampl, QvecDet, sumAmplFT0C);
+        SumQvectors(cosPhiFT0, sinPhiFT0, 0, iChC + 96, ampl, QvecFT0M, sumAmplFT0M);
       }
 
       if (sumAmplFT0C > 1e-8) {
@@ -323,7 +361,7 @@ struct qVectorsTable {
 
       for (std::size_t iCh = 0; iCh < fv0.channel().size(); iCh++) {
         float ampl = fv0.amplitude()[iCh];
-        helperEP.SumQvectors(1, iCh, ampl, cfgnMod, QvecDet, sumAmplFV0A);
+        SumQvectors(cosPhiFV0, sinPhiFV0, 1, iCh, ampl, QvecDet, sumAmplFV0A);
       }
 
       if (sumAmplFV0A > 1e-8) {
@@ -352,14 +390,16 @@ struct qVectorsTable {
       histosQA.fill(HIST("ChTracks"), trk.pt(), trk.eta(), trk.phi(), cent);
       if (abs(trk.eta()) < 0.1 || abs(trk.eta()) > 0.8)
         continue;
+      float cosPhi = TMath::Cos(trk.phi() * cfgnMod);
+      float sinPhi = TMath::Sin(trk.phi() * cfgnMod);
       if (trk.eta() > 0) {
-        qVectBPos[0] += trk.pt() * TMath::Cos(trk.phi() * cfgnMod);
-        qVectBPos[1] += trk.pt() * TMath::Sin(trk.phi() * cfgnMod);
+        qVectBPos[0] += trk.pt() * cosPhi;
+        qVectBPos[1] += trk.pt() * sinPhi;
         TrkBPosLabel.push_back(trk.globalIndex());
         nTrkBPos++;
       } else if (trk.eta() < 0) {
-        qVectBNeg[0] += trk.pt() * TMath::Cos(trk.phi() * cfgnMod);
-        qVectBNeg[1] += trk.pt() * TMath::Sin(trk.phi() * cfgnMod);
+        qVectBNeg[0] += trk.pt() * cosPhi;
+        qVectBNeg[1] += trk.pt() * sinPhi;
         TrkBNegLabel.push_back(trk.globalIndex());
         nTrkBNeg++;
       }
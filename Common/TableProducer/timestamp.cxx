@@ -53,9 +53,17 @@ struct TimestampTask {
     }
   }
 
-  void process(aod::BC const& bc)
+  void process(aod::BCs const& bcs)
+  {
+    timestampTable.reserve(bcs.size());
+    for (auto& bc : bcs) {
+      setOrbitResetTimestamp(bc.runNumber());
+      timestampTable((orbitResetTimestamp + int64_t(bc.globalBC() * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000); // us -> ms
+    }
+  }
+
+  void setOrbitResetTimestamp(int runNumber)
   {
-    int runNumber = bc.runNumber();
     // We need to set the orbit-reset timestamp for the run number.
     // This is done with caching if the run number was already processed before.
     // If not the orbit-reset timestamp for the run number is queried from CCDB and added to the cache
@@ -104,12 +112,11 @@ struct TimestampTask {
       }
       LOGF(info, "Add new run number %i with orbit-reset timestamp %llu to cache", runNumber, orbitResetTimestamp);
     }
+    lastRunNumber = runNumber;
 
     if (verbose.value) {
       LOGF(info, "Orbit-reset timestamp for run number %i found: %llu us", runNumber, orbitResetTimestamp);
     }
-
-    timestampTable((orbitResetTimestamp + int64_t(bc.globalBC() * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000); // us -> ms
   }
 };
 
@@ -19,6 +19,7 @@
 #include "Framework/RunningWorkflowInfo.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/Core/trackUtilities.h"
+#include "Common/Core/CcdbPrefetcher.h"
 #include "ReconstructionDataFormats/DCA.h"
 #include "DetectorsBase/Propagator.h"
 #include "DetectorsBase/GeometryManager.h"
@@ -31,6 +32,10 @@
 #include "CommonConstants/GeomConstants.h"
 #include "TableHelper.h"
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 // The Run 3 AO2D stores the tracks at the point of innermost update. For a track with ITS this is the innermost (or second innermost)
 // ITS layer. For a track without ITS, this is the TPC inner wall or for loopers in the TPC even a radius beyond that.
 // In order to use the track parameters, the tracks have to be propagated to the collision vertex which is done by this task.
@@ -54,6 +59,7 @@ struct TrackPropagation {
   Produces<aod::TracksDCACov> tracksDCACov;
 
   Service<o2::ccdb::BasicCCDBManager> ccdb;
+  o2::analysis::CcdbPrefetcher ccdbPrefetcher;
 
   bool fillTracksDCA = false;
   bool fillTracksDCACov = false;
@@ -71,6 +77,16 @@ struct TrackPropagation {
   Configurable<std::string> grpmagPath{"grpmagPath", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object"};
   Configurable<std::string> mVtxPath{"mVtxPath", "GLO/Calib/MeanVertex", "Path of the mean vertex file"};
   Configurable<float> minPropagationRadius{"minPropagationDistance", o2::constants::geom::XTPCInnerRef + 0.1, "Only tracks which are at a smaller radius will be propagated, defaults to TPC inner wall"};
+  Configurable<int> nThreads{"nThreads", 1, "Number of threads used to propagate the tracks of a time frame, 1 for serial propagation"};
+  Configurable<bool> prefetchCCDB{"prefetchCCDB", false, "Retrieve the run-dependent CCDB objects of all the runs of a time frame in parallel background threads"};
+  // Adaptive material correction: tracks close to the vertex or with high pT are propagated without material correction
+  Configurable<bool> useAdaptiveMatCorr{"useAdaptiveMatCorr", false, "Propagate tracks close to the vertex or with high pT without material correction"};
+  Configurable<float> adaptiveMaxX{"adaptiveMaxX", 2.5f, "Tracks with innermost update at smaller X (cm) are propagated without material correction"};
+  Configurable<float> adaptiveMinPt{"adaptiveMinPt", 10.f, "Tracks with larger pT (GeV/c) are propagated without material correction"};
+  Configurable<int> adaptiveQADownsampling{"adaptiveQADownsampling", 100, "Propagate also with material correction one every N tracks without it and fill the residual histograms (0: off, only in serial mode)"};
+
+  HistogramRegistry registry{"registry"};
+  uint64_t nTracksAdaptive = 0;
 
   void init(o2::framework::InitContext& initContext)
   {
@@ -101,8 +117,16 @@ struct TrackPropagation {
     ccdb->setURL(ccdburl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
+    ccdbPrefetcher.init(ccdburl);
 
     lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->get<o2::base::MatLayerCylSet>(lutPath));
+
+    if (useAdaptiveMatCorr && adaptiveQADownsampling > 0) {
+      const AxisSpec axisPt{100, 0.f, 20.f, "#it{p}_{T} (GeV/#it{c})"};
+      registry.add("hAdaptiveDcaXYResidual", "DCA_{xy} without - with material correction;#it{p}_{T} (GeV/#it{c});#Delta DCA_{xy} (cm)", kTH2F, {axisPt, {200, -0.01f, 0.01f}});
+      registry.add("hAdaptiveDcaZResidual", "DCA_{z} without - with material correction;#it{p}_{T} (GeV/#it{c});#Delta DCA_{z} (cm)", kTH2F, {axisPt, {200, -0.01f, 0.01f}});
+      registry.add("hAdaptivePtResidual", "#it{p}_{T} without - with material correction;#it{p}_{T} (GeV/#it{c});#Delta #it{p}_{T} / #it{p}_{T}", kTH2F, {axisPt, {200, -0.01f, 0.01f}});
+    }
   }
 
   void initCCDB(aod::BCsWithTimestamps::iterator const& bc)
@@ -110,14 +134,31 @@ struct TrackPropagation {
     if (runNumber == bc.runNumber()) {
       return;
     }
-    grpmag = ccdb->getForTimeStamp<o2::parameters::GRPMagField>(grpmagPath, bc.timestamp());
+    if (prefetchCCDB) {
+      grpmag = ccdbPrefetcher.get<o2::parameters::GRPMagField>(grpmagPath, bc.runNumber(), bc.timestamp());
+    } else {
+      grpmag = ccdb->getForTimeStamp<o2::parameters::GRPMagField>(grpmagPath, bc.timestamp());
+    }
     LOG(info) << "Setting magnetic field to current " << grpmag->getL3Current() << " A for run " << bc.runNumber() << " from its GRPMagField CCDB object";
     o2::base::Propagator::initFieldFromGRP(grpmag);
     o2::base::Propagator::Instance()->setMatLUT(lut);
-    mMeanVtx = ccdb->getForTimeStamp<o2::dataformats::MeanVertexObject>(mVtxPath, bc.timestamp());
+    if (prefetchCCDB) {
+      mMeanVtx = ccdbPrefetcher.get<o2::dataformats::MeanVertexObject>(mVtxPath, bc.runNumber(), bc.timestamp());
+    } else {
+      mMeanVtx = ccdb->getForTimeStamp<o2::dataformats::MeanVertexObject>(mVtxPath, bc.timestamp());
+    }
     runNumber = bc.runNumber();
   }
 
+  /// Starts the retrieval of the CCDB objects of the runs of the time frame not seen before
+  void prefetchRuns(aod::BCsWithTimestamps const& bcs)
+  {
+    for (const auto& [run, timestamp] : ccdbPrefetcher.findNewRuns(bcs)) {
+      ccdbPrefetcher.prefetch<o2::parameters::GRPMagField>(grpmagPath, run, timestamp);
+      ccdbPrefetcher.prefetch<o2::dataformats::MeanVertexObject>(mVtxPath, run, timestamp);
+    }
+  }
+
   // Running variables
   gpu::gpustd::array<float, 2> mDcaInfo;
   o2::dataformats::DCA mDcaInfoCov;
@@ -125,6 +166,116 @@ struct TrackPropagation {
   o2::track::TrackParametrization<float> mTrackPar;
   o2::track::TrackParametrizationWithError<float> mTrackParCov;
 
+  // Propagated track parameters, filled in multi-threaded mode and then written to the tables in the original order
+  std::vector<aod::track::TrackTypeEnum> mTrackTypes;
+  std::vector<o2::track::TrackParametrization<float>> mTrackPars;
+  std::vector<o2::track::TrackParametrizationWithError<float>> mTrackParCovs;
+  std::vector<gpu::gpustd::array<float, 2>> mDcaInfos;
+  std::vector<o2::dataformats::DCA> mDcaInfoCovs;
+
+  /// Propagate one track to its collision vertex (or to the mean vertex)
+  /// \return type of the track after the propagation
+  template <bool fillCovMat, bool useTrkPid, typename TTrack>
+  aod::track::TrackTypeEnum propagateTrack(TTrack const& track, o2::track::TrackParametrization<float>& trackPar, o2::track::TrackParametrizationWithError<float>& trackParCov,
+                                           gpu::gpustd::array<float, 2>& dcaInfo, o2::dataformats::DCA& dcaInfoCov, o2::dataformats::VertexBase& vtx, bool fillQA = false)
+  {
+    if constexpr (fillCovMat) {
+      if (fillTracksDCA || fillTracksDCACov) {
+        dcaInfoCov.set(999, 999, 999, 999, 999);
+      }
+      setTrackParCov(track, trackParCov);
+      if constexpr (useTrkPid) {
+        trackParCov.setPID(track.pidForTracking());
+      }
+    } else {
+      if (fillTracksDCA) {
+        dcaInfo[0] = 999;
+        dcaInfo[1] = 999;
+      }
+      setTrackPar(track, trackPar);
+      if constexpr (useTrkPid) {
+        trackPar.setPID(track.pidForTracking());
+      }
+    }
+    aod::track::TrackTypeEnum trackType = (aod::track::TrackTypeEnum)track.trackType();
+    // Only propagate tracks which have passed the innermost wall of the TPC (e.g. skipping loopers etc). Others fill unpropagated.
+    if (track.trackType() == aod::track::TrackIU && track.x() < minPropagationRadius) {
+      if (track.has_collision()) {
+        auto const& collision = track.collision();
+        vtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
+        vtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+      } else {
+        vtx.setPos({mMeanVtx->getX(), mMeanVtx->getY(), mMeanVtx->getZ()});
+        vtx.setCov(mMeanVtx->getSigmaX() * mMeanVtx->getSigmaX(), 0.0f, mMeanVtx->getSigmaY() * mMeanVtx->getSigmaY(), 0.0f, 0.0f, mMeanVtx->getSigmaZ() * mMeanVtx->getSigmaZ());
+      }
+      auto trackMatCorr = matCorr;
+      if (useAdaptiveMatCorr && (track.x() < adaptiveMaxX || std::abs(track.signed1Pt()) * adaptiveMinPt.value < 1.f)) {
+        trackMatCorr = o2::base::Propagator::MatCorrType::USEMatCorrNONE;
+      }
+      if constexpr (fillCovMat) {
+        if (trackMatCorr != matCorr && fillQA) {
+          fillAdaptiveQA(trackParCov, vtx);
+        }
+        o2::base::Propagator::Instance()->propagateToDCABxByBz(vtx, trackParCov, 2.f, trackMatCorr, &dcaInfoCov);
+      } else {
+        if (trackMatCorr != matCorr && fillQA) {
+          fillAdaptiveQA(trackPar, vtx);
+        }
+        o2::base::Propagator::Instance()->propagateToDCABxByBz(vtx.getXYZ(), trackPar, 2.f, trackMatCorr, &dcaInfo);
+      }
+      trackType = aod::track::Track;
+    }
+    return trackType;
+  }
+
+  /// Compare the propagation without and with material correction for one every adaptiveQADownsampling tracks
+  template <typename TTrackPar>
+  void fillAdaptiveQA(TTrackPar const& trackPar, o2::dataformats::VertexBase const& vtx)
+  {
+    if (adaptiveQADownsampling.value <= 0 || (nTracksAdaptive++ % adaptiveQADownsampling.value) != 0) {
+      return;
+    }
+    o2::track::TrackParametrization<float> trackFast(trackPar), trackFull(trackPar);
+    gpu::gpustd::array<float, 2> dcaFast{999.f, 999.f}, dcaFull{999.f, 999.f};
+    if (!o2::base::Propagator::Instance()->propagateToDCABxByBz(vtx.getXYZ(), trackFast, 2.f, o2::base::Propagator::MatCorrType::USEMatCorrNONE, &dcaFast) ||
+        !o2::base::Propagator::Instance()->propagateToDCABxByBz(vtx.getXYZ(), trackFull, 2.f, matCorr, &dcaFull)) {
+      return;
+    }
+    registry.fill(HIST("hAdaptiveDcaXYResidual"), trackFull.getPt(), dcaFast[0] - dcaFull[0]);
+    registry.fill(HIST("hAdaptiveDcaZResidual"), trackFull.getPt(), dcaFast[1] - dcaFull[1]);
+    registry.fill(HIST("hAdaptivePtResidual"), trackFull.getPt(), (trackFast.getPt() - trackFull.getPt()) / trackFull.getPt());
+  }
+
+  /// Fill the output tables for one propagated track
+  template <bool fillCovMat, typename TTrack>
+  void fillTrack(TTrack const& track, aod::track::TrackTypeEnum trackType, o2::track::TrackParametrization<float> const& trackPar, o2::track::TrackParametrizationWithError<float> const& trackParCov,
+                 gpu::gpustd::array<float, 2> const& dcaInfo, o2::dataformats::DCA const& dcaInfoCov)
+  {
+    if constexpr (fillCovMat) {
+      tracksParPropagated(track.collisionId(), trackType, trackParCov.getX(), trackParCov.getAlpha(), trackParCov.getY(), trackParCov.getZ(), trackParCov.getSnp(), trackParCov.getTgl(), trackParCov.getQ2Pt());
+      tracksParExtensionPropagated(trackParCov.getPt(), trackParCov.getP(), trackParCov.getEta(), trackParCov.getPhi());
+      // TODO do we keep the rho as 0? Also the sigma's are duplicated information
+      tracksParCovPropagated(std::sqrt(trackParCov.getSigmaY2()), std::sqrt(trackParCov.getSigmaZ2()), std::sqrt(trackParCov.getSigmaSnp2()),
+                             std::sqrt(trackParCov.getSigmaTgl2()), std::sqrt(trackParCov.getSigma1Pt2()), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+      tracksParCovExtensionPropagated(trackParCov.getSigmaY2(), trackParCov.getSigmaZY(), trackParCov.getSigmaZ2(), trackParCov.getSigmaSnpY(),
+                                      trackParCov.getSigmaSnpZ(), trackParCov.getSigmaSnp2(), trackParCov.getSigmaTglY(), trackParCov.getSigmaTglZ(), trackParCov.getSigmaTglSnp(),
+                                      trackParCov.getSigmaTgl2(), trackParCov.getSigma1PtY(), trackParCov.getSigma1PtZ(), trackParCov.getSigma1PtSnp(), trackParCov.getSigma1PtTgl(),
+                                      trackParCov.getSigma1Pt2());
+      if (fillTracksDCA) {
+        tracksDCA(dcaInfoCov.getY(), dcaInfoCov.getZ());
+      }
+      if (fillTracksDCACov) {
+        tracksDCACov(dcaInfoCov.getSigmaY2(), dcaInfoCov.getSigmaZ2());
+      }
+    } else {
+      tracksParPropagated(track.collisionId(), trackType, trackPar.getX(), trackPar.getAlpha(), trackPar.getY(), trackPar.getZ(), trackPar.getSnp(), trackPar.getTgl(), trackPar.getQ2Pt());
+      tracksParExtensionPropagated(trackPar.getPt(), trackPar.getP(), trackPar.getEta(), trackPar.getPhi());
+      if (fillTracksDCA) {
+        tracksDCA(dcaInfo[0], dcaInfo[1]);
+      }
+    }
+  }
+
   template <typename TTrack, bool fillCovMat = false, bool useTrkPid = false>
   void fillTrackTables(TTrack const& tracks,
                        aod::Collisions const&,
@@ -133,6 +284,9 @@ struct TrackPropagation {
     if (bcs.size() == 0) {
       return;
     }
+    if (prefetchCCDB) {
+      prefetchRuns(bcs);
+    }
     initCCDB(bcs.begin());
 
     if constexpr (fillCovMat) {
@@ -149,71 +303,59 @@ struct TrackPropagation {
       }
     }
 
-    for (auto& track : tracks) {
-      if constexpr (fillCovMat) {
-        if (fillTracksDCA || fillTracksDCACov) {
-          mDcaInfoCov.set(999, 999, 999, 999, 999);
-        }
-        setTrackParCov(track, mTrackParCov);
-        if constexpr (useTrkPid) {
-          mTrackParCov.setPID(track.pidForTracking());
-        }
-      } else {
-        if (fillTracksDCA) {
-          mDcaInfo[0] = 999;
-          mDcaInfo[1] = 999;
-        }
-        setTrackPar(track, mTrackPar);
-        if constexpr (useTrkPid) {
-          mTrackPar.setPID(track.pidForTracking());
-        }
+    if (nThreads.value <= 1) {
+      for (auto& track : tracks) {
+        auto trackType = propagateTrack<fillCovMat, useTrkPid>(track, mTrackPar, mTrackParCov, mDcaInfo, mDcaInfoCov, mVtx, true);
+        fillTrack<fillCovMat>(track, trackType, mTrackPar, mTrackParCov, mDcaInfo, mDcaInfoCov);
       }
-      aod::track::TrackTypeEnum trackType = (aod::track::TrackTypeEnum)track.trackType();
-      // Only propagate tracks which have passed the innermost wall of the TPC (e.g. skipping loopers etc). Others fill unpropagated.
-      if (track.trackType() == aod::track::TrackIU && track.x() < minPropagationRadius) {
-        if (track.has_collision()) {
-          auto const& collision = track.collision();
-          if constexpr (fillCovMat) {
-            mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
-            mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-            o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
-        } else {
+      return;
+    }
+
+    // Multi-threaded mode: contiguous chunks of tracks are propagated in parallel, the tables are then filled in the original order
+    const int64_t nTracks = tracks.size();
+    mTrackTypes.resize(nTracks);
+    if constexpr (fillCovMat) {
+      mTrackParCovs.resize(nTracks);
+      mDcaInfoCovs.resize(nTracks);
+    } else {
+      mTrackPars.resize(nTracks);
+      mDcaInfos.resize(nTracks);
+    }
+    const int64_t chunkSize = (nTracks + nThreads.value - 1) / nThreads.value;
+    std::vector<std::thread> workers;
+    for (int64_t first = 0; first < nTracks; first += chunkSize) {
+      const int64_t last = std::min(nTracks, first + chunkSize);
+      workers.emplace_back([this, &tracks, first, last]() {
+        o2::track::TrackParametrization<float> trackPar;
+        o2::track::TrackParametrizationWithError<float> trackParCov;
+        gpu::gpustd::array<float, 2> dcaInfo;
+        o2::dataformats::DCA dcaInfoCov;
+        o2::dataformats::VertexBase vtx;
+        auto track = tracks.iteratorAt(first);
+        for (int64_t iTrack = first; iTrack < last; ++iTrack, ++track) {
+          mTrackTypes[iTrack] = propagateTrack<fillCovMat, useTrkPid>(track, trackPar, trackParCov, dcaInfo, dcaInfoCov, vtx);
           if constexpr (fillCovMat) {
-            mVtx.setPos({mMeanVtx->getX(), mMeanVtx->getY(), mMeanVtx->getZ()});
-            mVtx.setCov(mMeanVtx->getSigmaX() * mMeanVtx->getSigmaX(), 0.0f, mMeanVtx->getSigmaY() * mMeanVtx->getSigmaY(), 0.0f, 0.0f, mMeanVtx->getSigmaZ() * mMeanVtx->getSigmaZ());
-            o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
+            mTrackParCovs[iTrack] = trackParCov;
+            mDcaInfoCovs[iTrack] = dcaInfoCov;
           } else {
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({mMeanVtx->getX(), mMeanVtx->getY(), mMeanVtx->getZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
+            mTrackPars[iTrack] = trackPar;
+            mDcaInfos[iTrack] = dcaInfo;
           }
         }
-        trackType = aod::track::Track;
-      }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+
+    int64_t iTrack = 0;
+    for (auto& track : tracks) {
       if constexpr (fillCovMat) {
-        tracksParPropagated(track.collisionId(), trackType, mTrackParCov.getX(), mTrackParCov.getAlpha(), mTrackParCov.getY(), mTrackParCov.getZ(), mTrackParCov.getSnp(), mTrackParCov.getTgl(), mTrackParCov.getQ2Pt());
-        tracksParExtensionPropagated(mTrackParCov.getPt(), mTrackParCov.getP(), mTrackParCov.getEta(), mTrackParCov.getPhi());
-        // TODO do we keep the rho as 0? Also the sigma's are duplicated information
-        tracksParCovPropagated(std::sqrt(mTrackParCov.getSigmaY2()), std::sqrt(mTrackParCov.getSigmaZ2()), std::sqrt(mTrackParCov.getSigmaSnp2()),
-                               std::sqrt(mTrackParCov.getSigmaTgl2()), std::sqrt(mTrackParCov.getSigma1Pt2()), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
-        tracksParCovExtensionPropagated(mTrackParCov.getSigmaY2(), mTrackParCov.getSigmaZY(), mTrackParCov.getSigmaZ2(), mTrackParCov.getSigmaSnpY(),
-                                        mTrackParCov.getSigmaSnpZ(), mTrackParCov.getSigmaSnp2(), mTrackParCov.getSigmaTglY(), mTrackParCov.getSigmaTglZ(), mTrackParCov.getSigmaTglSnp(),
-                                        mTrackParCov.getSigmaTgl2(), mTrackParCov.getSigma1PtY(), mTrackParCov.getSigma1PtZ(), mTrackParCov.getSigma1PtSnp(), mTrackParCov.getSigma1PtTgl(),
-                                        mTrackParCov.getSigma1Pt2());
-        if (fillTracksDCA) {
-          tracksDCA(mDcaInfoCov.getY(), mDcaInfoCov.getZ());
-        }
-        if (fillTracksDCACov) {
-          tracksDCACov(mDcaInfoCov.getSigmaY2(), mDcaInfoCov.getSigmaZ2());
-        }
+        fillTrack<fillCovMat>(track, mTrackTypes[iTrack], mTrackPar, mTrackParCovs[iTrack], mDcaInfo, mDcaInfoCovs[iTrack]);
       } else {
-        tracksParPropagated(track.collisionId(), trackType, mTrackPar.getX(), mTrackPar.getAlpha(), mTrackPar.getY(), mTrackPar.getZ(), mTrackPar.getSnp(), mTrackPar.getTgl(), mTrackPar.getQ2Pt());
-        tracksParExtensionPropagated(mTrackPar.getPt(), mTrackPar.getP(), mTrackPar.getEta(), mTrackPar.getPhi());
-        if (fillTracksDCA) {
-          tracksDCA(mDcaInfo[0], mDcaInfo[1]);
-        }
+        fillTrack<fillCovMat>(track, mTrackTypes[iTrack], mTrackPars[iTrack], mTrackParCov, mDcaInfos[iTrack], mDcaInfoCov);
       }
+      ++iTrack;
     }
   }
 
@@ -24,8 +24,13 @@ using namespace o2::zdc;
 struct zdcConverter {
   Produces<aod::Zdcs_001> Zdcs_001;
 
+  // variables to initialize Zdcs_001 table, reused for all the entries
+  std::vector<float> zdcEnergy, zdcAmplitudes, zdcTime;
+  std::vector<uint8_t> zdcChannelsE, zdcChannelsT;
+
   void process(aod::Zdcs_000 const& zdcLegacy, aod::BCs const&)
   {
+    Zdcs_001.reserve(zdcLegacy.size());
     for (auto& zdcData : zdcLegacy) {
       // Get legacy information, please
       auto bc = zdcData.bc();
@@ -46,9 +51,11 @@ struct zdcConverter {
       auto timeZPA = zdcData.timeZPA();
       auto timeZPC = zdcData.timeZPC();
 
-      // Create variables to initialize Zdcs_001 table
-      std::vector<float> zdcEnergy, zdcAmplitudes, zdcTime;
-      std::vector<uint8_t> zdcChannelsE, zdcChannelsT;
+      zdcEnergy.clear();
+      zdcAmplitudes.clear();
+      zdcTime.clear();
+      zdcChannelsE.clear();
+      zdcChannelsT.clear();
 
       // Tie variables in such that they get read correctly later
       zdcEnergy.emplace_back(energyZEM1);
@@ -44,6 +44,10 @@ multGlauberNBDFitter::multGlauberNBDFitter() : TNamed(),
                                                fhNpNc(0x0),
                                                ffChanged(kTRUE),
                                                fCurrentf(-1),
+                                               fNBDCacheValid(kFALSE),
+                                               fCachedMu(0),
+                                               fCachedk(0),
+                                               fCacheddMu(0),
                                                fAncestorMode(2),
                                                fNpart(0x0),
                                                fNcoll(0x0),
@@ -72,7 +76,7 @@ multGlauberNBDFitter::multGlauberNBDFitter() : TNamed(),
 
   //master function
   fGlauberNBD = new TF1("fGlauberNBD", this, &multGlauberNBDFitter::ProbDistrib,
-                        0, 50000, 4, "multGlauberNBDFitter", "ProbDistrib");
+                        0, 50000, 5, "multGlauberNBDFitter", "ProbDistrib");
   fGlauberNBD->SetParameter(0, fMu);
   fGlauberNBD->SetParameter(1, fk);
   fGlauberNBD->SetParameter(2, ff);
@@ -91,6 +95,10 @@ multGlauberNBDFitter::multGlauberNBDFitter(const char* name, const char* title)
                                                                                   fhNpNc(0x0),
                                                                                   ffChanged(kTRUE),
                                                                                   fCurrentf(-1),
+                                                                                  fNBDCacheValid(kFALSE),
+                                                                                  fCachedMu(0),
+                                                                                  fCachedk(0),
+                                                                                  fCacheddMu(0),
                                                                                   fAncestorMode(2),
                                                                                   fNpart(0x0),
                                                                                   fNcoll(0x0),
@@ -190,28 +198,69 @@ Double_t multGlauberNBDFitter::ProbDistrib(Double_t* x, Double_t* par)
       return 0;
     }
     fhNanc->Scale(1. / fhNanc->Integral());
+    fNBDCacheValid = kFALSE;
   }
+  //______________________________________________________
+  //The ancestor terms only change with mu, k, f and dMu/dNanc: the minimiser
+  //evaluates the function at all the points of the fit range for each set
+  if (!fNBDCacheValid || fCachedMu != par[0] || fCachedk != par[1] || fCacheddMu != par[4])
+    UpdateNBDCache(par);
+
   //______________________________________________________
   //Actually evaluate function
+  if (lMultValue <= 1e-6)
+    return 0.0;
+  if (fAncestorMode == 2) {
+    //ContinuousNBD with the multiplicity-independent terms taken from the cache
+    const Double_t lLnGammaMultPlusOne = TMath::LnGamma(lMultValue + 1.);
+    for (size_t iAnc = 0; iAnc < fAncCount.size(); iAnc++) {
+      Double_t lLnMult = TMath::LnGamma(lMultValue + fAnck[iAnc]) - lLnGammaMultPlusOne - fAncLnGammak[iAnc];
+      lLnMult += lMultValue * fAncLogMuOverk[iAnc] - (lMultValue + fAnck[iAnc]) * fAncLogOnePlusMuk[iAnc];
+      lProbability += fAncCount[iAnc] * TMath::Exp(lLnMult);
+    }
+  } else {
+    for (size_t iAnc = 0; iAnc < fAncCount.size(); iAnc++) {
+      fNBD->SetParameter(1, fAnck[iAnc]);
+      fNBD->SetParameter(0, fAncp[iAnc]);
+      lProbability += fAncCount[iAnc] * fNBD->Eval(lMultValue);
+    }
+  }
+  //______________________________________________________
+  return par[3] * lProbability;
+}
+
+//______________________________________________________
+void multGlauberNBDFitter::UpdateNBDCache(Double_t* par)
+{
+  fAncCount.clear();
+  fAnck.clear();
+  fAncp.clear();
+  fAncLnGammak.clear();
+  fAncLogMuOverk.clear();
+  fAncLogOnePlusMuk.clear();
+
+  //empty ancestor bins do not contribute
   Int_t lStartBin = fhNanc->FindBin(0.0) + 1;
   for (Long_t iNanc = lStartBin; iNanc < fhNanc->GetNbinsX() + 1; iNanc++) {
-    Double_t lNancestors = fhNanc->GetBinCenter(iNanc);
     Double_t lNancestorCount = fhNanc->GetBinContent(iNanc);
-    //if(lNancestorCount<1e-12&&lNancestors>10) break;
+    if (lNancestorCount == 0)
+      continue;
+    Double_t lNancestors = fhNanc->GetBinCenter(iNanc);
 
     // allow for variable mu in case requested
     Double_t lThisMu = (((Double_t)lNancestors)) * (par[0] + par[4] * lNancestors);
     Double_t lThisk = (((Double_t)lNancestors)) * par[1];
-    Double_t lpval = TMath::Power(1.0 + lThisMu / lThisk, -1);
-    fNBD->SetParameter(1, lThisk);
-    fNBD->SetParameter(0, lpval);
-    Double_t lMult = 0.0;
-    if (lMultValue > 1e-6)
-      lMult = fAncestorMode != 2 ? fNBD->Eval(lMultValue) : ContinuousNBD(lMultValue, lThisMu, lThisk);
-    lProbability += lNancestorCount * lMult;
+    fAncCount.push_back(lNancestorCount);
+    fAnck.push_back(lThisk);
+    fAncp.push_back(TMath::Power(1.0 + lThisMu / lThisk, -1));
+    fAncLnGammak.push_back(TMath::LnGamma(lThisk));
+    fAncLogMuOverk.push_back(TMath::Log(lThisMu / lThisk));
+    fAncLogOnePlusMuk.push_back(TMath::Log(1.0 + lThisMu / lThisk));
   }
-  //______________________________________________________
-  return par[3] * lProbability;
+  fCachedMu = par[0];
+  fCachedk = par[1];
+  fCacheddMu = par[4];
+  fNBDCacheValid = kTRUE;
 }
 
 //________________________________________________________________
@@ -13,6 +13,7 @@
 #define MULTGLAUBERNBDFITTER_H
 
 #include <iostream>
+#include <vector>
 #include "TNamed.h"
 #include "TF1.h"
 #include "TH1.h"
@@ -77,6 +78,9 @@ class multGlauberNBDFitter : public TNamed
   //For estimating Npart, Ncoll in multiplicity bins
   void CalculateAvNpNc(TProfile* lNPartProf, TProfile* lNCollProf);
 
+  //Fills the per-ancestor NBD terms which do not depend on the multiplicity
+  void UpdateNBDCache(Double_t* par);
+
   //void    Print(Option_t *option="") const;
 
  private:
@@ -95,6 +99,18 @@ class multGlauberNBDFitter : public TNamed
   Bool_t ffChanged;
   Double_t fCurrentf;
 
+  //NBD terms of the populated ancestor bins, for the current mu, k, f and dMu/dNanc
+  Bool_t fNBDCacheValid;                   //!
+  Double_t fCachedMu;                      //!
+  Double_t fCachedk;                       //!
+  Double_t fCacheddMu;                     //!
+  std::vector<Double_t> fAncCount;         //! ancestor bin content
+  std::vector<Double_t> fAnck;             //! NBD k
+  std::vector<Double_t> fAncp;             //! NBD p, for ancestor modes 0 and 1
+  std::vector<Double_t> fAncLnGammak;      //! ln(Gamma(k))
+  std::vector<Double_t> fAncLogMuOverk;    //! ln(mu/k)
+  std::vector<Double_t> fAncLogOnePlusMuk; //! ln(1 + mu/k)
+
   //0: truncation, 1: rounding, 2: analytical continuation
   Int_t fAncestorMode;
 
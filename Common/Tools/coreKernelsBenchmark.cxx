@@ -0,0 +1,277 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file coreKernelsBenchmark.cxx
+/// \brief Executable benchmarking the hot kernels of Common/Core on synthetic tracks
+///
+/// The same tracks (generated from a fixed seed) are passed through each kernel: the RecoDecay pair kinematics,
+/// TrackSelection::IsSelected and IsSelectedMask with the global track selection, the TPC expected signal and
+/// resolution of the column-wise Response interface and their number of sigmas, the TOF expected times, and
+/// the event mixing bins of eventmixing::getMixingBin and MixingBinning. For each kernel the time per call and the calls per second are printed, together
+/// with a checksum of the results, which must not change when a kernel is optimised.
+///
+/// Usage: o2-analysis-core-kernels-benchmark [-n nTracks] [-r nRepetitions] [-s seed]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CommonConstants/PhysicsConstants.h"
+
+#include "Common/Core/EventMixing.h"
+#include "Common/Core/PID/PIDTOF.h"
+#include "Common/Core/PID/TPCPIDResponse.h"
+#include "Common/Core/RecoDecay.h"
+#include "Common/Core/TrackSelection.h"
+#include "Common/Core/TrackSelectionDefaults.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/// Track with the columns read by the kernels, in place of a table row
+struct Track {
+  float mPt, mEta, mPhi, mSign;
+  float mTgl, mSigned1Pt, mTPCInnerParam, mTPCSignal;
+  float mTOFExpMom, mLength;
+  float mDcaXY, mDcaZ;
+  float mTPCChi2NCl, mITSChi2NCl, mTPCCrossedRowsOverFindableCls;
+  int16_t mTPCNClsFound, mTPCNClsCrossedRows;
+  uint8_t mITSNCls, mITSClusterMap;
+  uint32_t mFlags;
+
+  uint8_t trackType() const { return o2::aod::track::TrackTypeEnum::Track; }
+  float pt() const { return mPt; }
+  float eta() const { return mEta; }
+  int16_t tpcNClsFound() const { return mTPCNClsFound; }
+  int16_t tpcNClsCrossedRows() const { return mTPCNClsCrossedRows; }
+  float tpcCrossedRowsOverFindableCls() const { return mTPCCrossedRowsOverFindableCls; }
+  float tpcChi2NCl() const { return mTPCChi2NCl; }
+  bool hasTPC() const { return mTPCNClsFound > 0; }
+  uint8_t itsNCls() const { return mITSNCls; }
+  float itsChi2NCl() const { return mITSChi2NCl; }
+  uint8_t itsClusterMap() const { return mITSClusterMap; }
+  bool hasITS() const { return mITSNCls > 0; }
+  uint32_t flags() const { return mFlags; }
+  float dcaXY() const { return mDcaXY; }
+  float dcaZ() const { return mDcaZ; }
+};
+
+/// Synthetic tracks with an exponential pT spectrum, flat in eta and phi, and detector variables spread around typical values
+std::vector<Track> generateTracks(std::mt19937& generator, int nTracks)
+{
+  std::uniform_real_distribution<float> distEta(-1.f, 1.f);
+  std::uniform_real_distribution<float> distPhi(0.f, 2.f * M_PI);
+  std::uniform_real_distribution<float> distUniform(0.f, 1.f);
+  std::exponential_distribution<float> distPt(1.f / 0.6f);
+  std::normal_distribution<float> distDca(0.f, 0.05f);
+  std::normal_distribution<float> distSignal(0.f, 4.f);
+  std::uniform_int_distribution<int> distNClsTPC(40, 159);
+  std::uniform_int_distribution<int> distClusterMap(0, 127);
+  std::vector<Track> tracks(nTracks);
+  for (auto& track : tracks) {
+    track.mPt = 0.1f + distPt(generator);
+    track.mEta = distEta(generator);
+    track.mPhi = distPhi(generator);
+    track.mSign = distUniform(generator) < 0.5f ? -1.f : 1.f;
+    track.mTgl = std::sinh(track.mEta);
+    track.mSigned1Pt = track.mSign / track.mPt;
+    track.mTPCInnerParam = track.mPt * std::cosh(track.mEta);
+    track.mTPCSignal = 50.f + distSignal(generator);
+    track.mTOFExpMom = track.mTPCInnerParam;
+    track.mLength = 380.f * std::cosh(track.mEta);
+    track.mDcaXY = distDca(generator);
+    track.mDcaZ = distDca(generator);
+    track.mTPCChi2NCl = 5.f * distUniform(generator);
+    track.mITSChi2NCl = 40.f * distUniform(generator);
+    track.mTPCNClsFound = distNClsTPC(generator);
+    track.mTPCNClsCrossedRows = std::min(159, track.mTPCNClsFound + 5);
+    track.mTPCCrossedRowsOverFindableCls = 0.7f + 0.5f * distUniform(generator);
+    track.mITSClusterMap = distClusterMap(generator);
+    track.mITSNCls = __builtin_popcount(track.mITSClusterMap);
+    track.mFlags = o2::aod::track::TPCrefit | o2::aod::track::ITSrefit;
+  }
+  return tracks;
+}
+
+/// Runs a kernel nRepetitions times and prints its time per call and a checksum of its results
+/// \param nCalls number of calls of the kernel per repetition
+/// \param kernel returns the sum of its results over the calls of a repetition
+void runKernel(const char* name, int nRepetitions, std::size_t nCalls, const std::function<double()>& kernel)
+{
+  double checksum = 0.;
+  auto start = Clock::now();
+  for (int iRepetition = 0; iRepetition < nRepetitions; iRepetition++) {
+    checksum += kernel();
+  }
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  const double totalCalls = static_cast<double>(nCalls) * nRepetitions;
+  std::printf("%-28s %12.2f %14.3e %18.6e\n", name, 1.e9 * seconds / totalCalls, totalCalls / seconds, checksum);
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  int nTracks = 100000;
+  int nRepetitions = 10;
+  unsigned int seed = 12345;
+  for (int iArg = 1; iArg + 1 < argc; iArg += 2) {
+    std::string option(argv[iArg]);
+    if (option == "-n") {
+      nTracks = std::atoi(argv[iArg + 1]);
+    } else if (option == "-r") {
+      nRepetitions = std::atoi(argv[iArg + 1]);
+    } else if (option == "-s") {
+      seed = std::strtoul(argv[iArg + 1], nullptr, 10);
+    } else {
+      std::fprintf(stderr, "Usage: %s [-n nTracks] [-r nRepetitions] [-s seed]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (nTracks < 2) {
+    std::fprintf(stderr, "At least two tracks are needed\n");
+    return 1;
+  }
+
+  std::mt19937 generator(seed);
+  const auto tracks = generateTracks(generator, nTracks);
+  const std::size_t nPairs = tracks.size() - 1;
+
+  // columns of the tracks, as read by the column-wise kernels
+  std::vector<float> tpcInnerParam, tgl, signed1Pt, tpcNClsFound, multTPC, tpcSignal;
+  for (const auto& track : tracks) {
+    tpcInnerParam.push_back(track.mTPCInnerParam);
+    tgl.push_back(track.mTgl);
+    signed1Pt.push_back(track.mSigned1Pt);
+    tpcNClsFound.push_back(track.mTPCNClsFound);
+    multTPC.push_back(3000.f);
+    tpcSignal.push_back(track.mTPCSignal);
+  }
+  std::vector<float> expSignal(tracks.size()), expSigma(tracks.size()), nSigma(tracks.size());
+
+  // collisions for the mixing bins, one per track
+  std::uniform_real_distribution<float> distVtx(-12.f, 12.f);
+  std::exponential_distribution<float> distMult(1.f / 800.f);
+  std::vector<float> vtxs(tracks.size()), mults(tracks.size());
+  for (std::size_t iTrack = 0; iTrack < tracks.size(); iTrack++) {
+    vtxs[iTrack] = distVtx(generator);
+    mults[iTrack] = distMult(generator);
+  }
+  const std::vector<float> vtxBins = {-10.f, -8.f, -6.f, -4.f, -2.f, 0.f, 2.f, 4.f, 6.f, 8.f, 10.f};
+  const std::vector<float> multBins = {0.f, 50.f, 100.f, 200.f, 400.f, 800.f, 1600.f, 3200.f, 1.e5f};
+
+  const auto trackSelection = getGlobalTrackSelection();
+  o2::pid::tpc::Response responseTPC;
+  const std::array<double, 2> massesPiK = {o2::constants::physics::MassPiPlus, o2::constants::physics::MassKPlus};
+
+  std::printf("%d tracks, %d repetitions, seed %u\n", nTracks, nRepetitions, seed);
+  std::printf("%-28s %12s %14s %18s\n", "kernel", "ns/call", "calls/s", "checksum");
+
+  runKernel("RecoDecay::m (pair)", nRepetitions, nPairs, [&]() {
+    double sum = 0.;
+    for (std::size_t iTrack = 0; iTrack < nPairs; iTrack++) {
+      const auto& track0 = tracks[iTrack];
+      const auto& track1 = tracks[iTrack + 1];
+      const std::array<float, 3> pVec0 = {track0.mPt * std::cos(track0.mPhi), track0.mPt * std::sin(track0.mPhi), track0.mPt * track0.mTgl};
+      const std::array<float, 3> pVec1 = {track1.mPt * std::cos(track1.mPhi), track1.mPt * std::sin(track1.mPhi), track1.mPt * track1.mTgl};
+      sum += RecoDecay::m(std::array{pVec0, pVec1}, massesPiK);
+    }
+    return sum;
+  });
+
+  runKernel("RecoDecay::pt/y/cpa (pair)", nRepetitions, nPairs, [&]() {
+    const std::array<float, 3> posPV = {0.f, 0.f, 0.f};
+    double sum = 0.;
+    for (std::size_t iTrack = 0; iTrack < nPairs; iTrack++) {
+      const auto& track0 = tracks[iTrack];
+      const auto& track1 = tracks[iTrack + 1];
+      const std::array<float, 3> pVec0 = {track0.mPt * std::cos(track0.mPhi), track0.mPt * std::sin(track0.mPhi), track0.mPt * track0.mTgl};
+      const std::array<float, 3> pVec1 = {track1.mPt * std::cos(track1.mPhi), track1.mPt * std::sin(track1.mPhi), track1.mPt * track1.mTgl};
+      const auto pVec = RecoDecay::pVec(pVec0, pVec1);
+      const std::array<float, 3> posSV = {track0.mDcaXY, track1.mDcaXY, track0.mDcaZ};
+      sum += RecoDecay::pt(pVec) + RecoDecay::y(pVec, o2::constants::physics::MassD0) + RecoDecay::cpa(posPV, posSV, pVec);
+    }
+    return sum;
+  });
+
+  runKernel("TrackSelection::IsSelected", nRepetitions, tracks.size(), [&]() {
+    double sum = 0.;
+    for (const auto& track : tracks) {
+      sum += trackSelection.IsSelected(track);
+    }
+    return sum;
+  });
+
+  runKernel("TrackSelection::IsSelectedMask", nRepetitions, tracks.size(), [&]() {
+    double sum = 0.;
+    for (const auto& track : tracks) {
+      sum += trackSelection.IsSelectedMask(track);
+    }
+    return sum;
+  });
+
+  runKernel("TPC expected signal+sigma", nRepetitions, tracks.size(), [&]() {
+    responseTPC.GetExpectedSignalAndSigma(o2::track::PID::Pion, tracks.size(), tpcInnerParam.data(), tgl.data(), signed1Pt.data(), tpcNClsFound.data(), multTPC.data(), expSignal.data(), expSigma.data());
+    double sum = 0.;
+    for (std::size_t iTrack = 0; iTrack < tracks.size(); iTrack++) {
+      sum += expSignal[iTrack] + expSigma[iTrack];
+    }
+    return sum;
+  });
+
+  runKernel("TPC number of sigmas", nRepetitions, tracks.size(), [&]() {
+    responseTPC.GetNumberOfSigma(tracks.size(), tpcSignal.data(), expSignal.data(), expSigma.data(), nSigma.data());
+    double sum = 0.;
+    for (const auto& value : nSigma) {
+      sum += value;
+    }
+    return sum;
+  });
+
+  runKernel("TOF ExpTimes (pi, K, p)", nRepetitions, tracks.size(), [&]() {
+    double sum = 0.;
+    for (const auto& track : tracks) {
+      sum += o2::pid::tof::ExpTimes<Track, o2::track::PID::Pion>::ComputeExpectedTime(track.mTOFExpMom, track.mLength);
+      sum += o2::pid::tof::ExpTimes<Track, o2::track::PID::Kaon>::ComputeExpectedTime(track.mTOFExpMom, track.mLength);
+      sum += o2::pid::tof::ExpTimes<Track, o2::track::PID::Proton>::ComputeExpectedTime(track.mTOFExpMom, track.mLength);
+    }
+    return sum;
+  });
+
+  runKernel("eventmixing::getMixingBin", nRepetitions, tracks.size(), [&]() {
+    double sum = 0.;
+    for (std::size_t iTrack = 0; iTrack < tracks.size(); iTrack++) {
+      sum += eventmixing::getMixingBin(vtxBins, multBins, vtxs[iTrack], mults[iTrack]);
+    }
+    return sum;
+  });
+
+  const eventmixing::MixingBinning<2> mixingBinning({vtxBins, multBins});
+  std::vector<int> mixingBins(tracks.size());
+  runKernel("MixingBinning::getBins", nRepetitions, tracks.size(), [&]() {
+    mixingBinning.getBins(tracks.size(), {vtxs.data(), mults.data()}, mixingBins.data());
+    double sum = 0.;
+    for (const auto& bin : mixingBins) {
+      sum += bin;
+    }
+    return sum;
+  });
+
+  return 0;
+}
@@ -788,6 +788,35 @@ struct EventSelectionQaTask {
       vGlobalBCs[indexBc] = globalBC;
     }
 
+    // indices of the closest TVX bcs at or before and at or after each bc (-1 if none),
+    // for the nearest-TVX searches of tracks and collisions
+    std::vector<int> vPrevTVX(nBCs, -1);
+    std::vector<int> vNextTVX(nBCs, -1);
+    for (int i = 0; i < nBCs; i++) {
+      vPrevTVX[i] = vIsTVX[i] ? i : (i > 0 ? vPrevTVX[i - 1] : -1);
+    }
+    for (int i = nBCs - 1; i >= 0; i--) {
+      vNextTVX[i] = vIsTVX[i] ? i : (i < nBCs - 1 ? vNextTVX[i + 1] : -1);
+    }
+    // nearest TVX bc, the bc itself if there is no TVX bc at all
+    auto findNearestTVX = [&](int indexBc, int64_t globalBC) {
+      if (vIsTVX[indexBc]) {
+        return indexBc;
+      }
+      int indexNext = vNextTVX[indexBc];
+      int indexPrev = vPrevTVX[indexBc];
+      if (indexNext >= 0 && indexPrev >= 0) {
+        int64_t diffNext = vGlobalBCs[indexNext] - globalBC;
+        int64_t diffPrev = globalBC - vGlobalBCs[indexPrev];
+        return diffNext <= diffPrev ? indexNext : indexPrev;
+      } else if (indexNext >= 0) {
+        return indexNext;
+      } else if (indexPrev >= 0) {
+        return indexPrev;
+      }
+      return indexBc;
+    };
+
     // build map from track index to ambiguous track index
     std::unordered_map<int32_t, int32_t> mapAmbTrIds;
     for (const auto& ambTrack : ambTracks) {
@@ -802,34 +831,7 @@ struct EventSelectionQaTask {
       auto bc = bcs.iteratorAt(indexBc);
       int64_t globalBC = bc.globalBC() + floor(track.trackTime() / o2::constants::lhc::LHCBunchSpacingNS);
 
-      int indexNearestTVX = indexBc;
-      if (vIsTVX[indexBc]) {
-        indexNearestTVX = indexBc;
-      } else {
-        bool foundNext = 0;
-        int indexNext = indexBc;
-        while (!foundNext && indexNext < nBCs - 1) {
-          if (vIsTVX[++indexNext]) {
-            foundNext = 1;
-          }
-        }
-        bool foundPrev = 0;
-        int indexPrev = indexBc;
-        while (!foundPrev && indexPrev > 0) {
-          if (vIsTVX[--indexPrev]) {
-            foundPrev = 1;
-          }
-        }
-        if (foundNext && foundPrev) {
-          int64_t diffNext = vGlobalBCs[indexNext] - globalBC;
-          int64_t diffPrev = globalBC - vGlobalBCs[indexPrev];
-          indexNearestTVX = diffNext <= diffPrev ? indexNext : indexPrev;
-        } else if (foundNext) {
-          indexNearestTVX = indexNext;
-        } else if (foundPrev) {
-          indexNearestTVX = indexPrev;
-        }
-      }
+      int indexNearestTVX = findNearestTVX(indexBc, globalBC);
       int bcDiff = static_cast<int>(globalBC - vGlobalBCs[indexNearestTVX]);
       if (track.hasTOF() || track.hasTRD() || !track.hasITS() || !track.hasTPC() || track.pt() < 1)
         continue;
@@ -889,34 +891,7 @@ struct EventSelectionQaTask {
 
       // search for nearest ft0a&ft0c entry
       int indexBc = bc.globalIndex();
-      int indexNearestTVX = indexBc;
-      if (vIsTVX[indexBc]) {
-        indexNearestTVX = indexBc;
-      } else {
-        bool foundNext = 0;
-        int indexNext = indexBc;
-        while (!foundNext && indexNext < nBCs - 1) {
-          if (vIsTVX[++indexNext]) {
-            foundNext = 1;
-          }
-        }
-        bool foundPrev = 0;
-        int indexPrev = indexBc;
-        while (!foundPrev && indexPrev > 0) {
-          if (vIsTVX[--indexPrev]) {
-            foundPrev = 1;
-          }
-        }
-        if (foundNext && foundPrev) {
-          int64_t diffNext = vGlobalBCs[indexNext] - globalBC;
-          int64_t diffPrev = globalBC - vGlobalBCs[indexPrev];
-          indexNearestTVX = diffNext <= diffPrev ? indexNext : indexPrev;
-        } else if (foundNext) {
-          indexNearestTVX = indexNext;
-        } else if (foundPrev) {
-          indexNearestTVX = indexPrev;
-        }
-      }
+      int indexNearestTVX = findNearestTVX(indexBc, globalBC);
       const auto& nearestTVX = bcs.iteratorAt(indexNearestTVX);
       int bcDiff = static_cast<int>(globalBC - nearestTVX.globalBC());
       int nContributors = col.numContrib();
@@ -708,6 +708,9 @@ struct QaEfficiency {
 
   void initMC(const AxisSpec& axisSel)
   {
+    if (doprocessMCEfficiency && !doprocessMC) {
+      LOG(fatal) << "processMCEfficiency only fills the efficiencies of processMC, please enable processMC too.";
+    }
     if (!doprocessMC && !doprocessMCWithoutCollisions) {
       return;
     }
@@ -1661,6 +1664,22 @@ struct QaEfficiency {
     return false;
   }
 
+  // copies the numerator and denominator histograms of all species into the TEfficiencies
+  void fillMCEfficiencies()
+  {
+    static_for<0, 1>([&](auto pdgSign) {
+      fillMCEfficiency<pdgSign, o2::track::PID::Electron>(doEl);
+      fillMCEfficiency<pdgSign, o2::track::PID::Muon>(doMu);
+      fillMCEfficiency<pdgSign, o2::track::PID::Pion>(doPi);
+      fillMCEfficiency<pdgSign, o2::track::PID::Kaon>(doKa);
+      fillMCEfficiency<pdgSign, o2::track::PID::Proton>(doPr);
+      fillMCEfficiency<pdgSign, o2::track::PID::Deuteron>(doDe);
+      fillMCEfficiency<pdgSign, o2::track::PID::Triton>(doTr);
+      fillMCEfficiency<pdgSign, o2::track::PID::Helium3>(doHe);
+      fillMCEfficiency<pdgSign, o2::track::PID::Alpha>(doAl);
+    });
+  }
+
   // MC process
   Preslice<o2::aod::Tracks> perCollision = o2::aod::track::collisionId;
   void processMC(o2::aod::McCollision const& mcCollision,
@@ -1746,21 +1765,20 @@ struct QaEfficiency {
     }
     histos.fill(HIST("MC/eventMultiplicity"), dNdEta * 0.5f / 2.f);
 
-    // Fill TEfficiencies
-    static_for<0, 1>([&](auto pdgSign) {
-      fillMCEfficiency<pdgSign, o2::track::PID::Electron>(doEl);
-      fillMCEfficiency<pdgSign, o2::track::PID::Muon>(doMu);
-      fillMCEfficiency<pdgSign, o2::track::PID::Pion>(doPi);
-      fillMCEfficiency<pdgSign, o2::track::PID::Kaon>(doKa);
-      fillMCEfficiency<pdgSign, o2::track::PID::Proton>(doPr);
-      fillMCEfficiency<pdgSign, o2::track::PID::Deuteron>(doDe);
-      fillMCEfficiency<pdgSign, o2::track::PID::Triton>(doTr);
-      fillMCEfficiency<pdgSign, o2::track::PID::Helium3>(doHe);
-      fillMCEfficiency<pdgSign, o2::track::PID::Alpha>(doAl);
-    });
+    // Fill TEfficiencies, unless they are filled once per data frame by processMCEfficiency
+    if (!doprocessMCEfficiency) {
+      fillMCEfficiencies();
+    }
   }
   PROCESS_SWITCH(QaEfficiency, processMC, "process MC", false);
 
+  // Filling of the TEfficiencies of processMC once per data frame, after all its MC collisions
+  void processMCEfficiency(o2::aod::McCollisions const&)
+  {
+    fillMCEfficiencies();
+  }
+  PROCESS_SWITCH(QaEfficiency, processMCEfficiency, "fill the TEfficiencies of processMC once per data frame instead of once per MC collision", false);
+
   // MC process without the collision association
   void processMCWithoutCollisions(o2::soa::Join<TrackCandidates, o2::aod::McTrackLabels> const& tracks,
                                   o2::aod::McParticles const& mcParticles)
@@ -1804,17 +1822,7 @@ struct QaEfficiency {
     }
 
     // Fill TEfficiencies
-    static_for<0, 1>([&](auto pdgSign) {
-      fillMCEfficiency<pdgSign, o2::track::PID::Electron>(doEl);
-      fillMCEfficiency<pdgSign, o2::track::PID::Muon>(doMu);
-      fillMCEfficiency<pdgSign, o2::track::PID::Pion>(doPi);
-      fillMCEfficiency<pdgSign, o2::track::PID::Kaon>(doKa);
-      fillMCEfficiency<pdgSign, o2::track::PID::Proton>(doPr);
-      fillMCEfficiency<pdgSign, o2::track::PID::Deuteron>(doDe);
-      fillMCEfficiency<pdgSign, o2::track::PID::Triton>(doTr);
-      fillMCEfficiency<pdgSign, o2::track::PID::Helium3>(doHe);
-      fillMCEfficiency<pdgSign, o2::track::PID::Alpha>(doAl);
-    });
+    fillMCEfficiencies();
   }
   PROCESS_SWITCH(QaEfficiency, processMCWithoutCollisions, "process MC without the collision association", false);
 
@@ -115,6 +115,8 @@ DECLARE_SOA_COLUMN(TPCFractionSharedCls, tpcFractionSharedCls, float);
 DECLARE_SOA_COLUMN(ITSNCls, itsNCls, uint8_t);                                           //! Clusters found in ITS
 DECLARE_SOA_COLUMN(ITSNClsInnerBarrel, itsNClsInnerBarrel, uint8_t);                     //! Clusters found in the inner barrel of the ITS
 DECLARE_SOA_COLUMN(TOFSignal, tofSignal, float);                                         //! TOF Signal (Ev. Time subtracted)
+DECLARE_SOA_COLUMN(DownsamplingTier, downsamplingTier, uint8_t);                         //! Downsampling tier of the track: 0 stored for all the tracks (rare categories), 1 downsampled (bulk)
+DECLARE_SOA_COLUMN(Weight, weight, float);                                               //! Weight of the track, inverse of the fraction of stored tracks of its tier
 
 } // namespace dpgtrack
 
@@ -130,6 +132,9 @@ DECLARE_SOA_TABLE(DPGTracks, "AOD", "DPGTracks", //! Table of the DPG tracks
                   dpgtrack::TPCCrossedRowsOverFindableCls, dpgtrack::TPCFoundOverFindableCls, dpgtrack::TPCFractionSharedCls,
                   dpgtrack::ITSNCls, dpgtrack::ITSNClsInnerBarrel, track::TPCSignal, dpgtrack::TOFSignal);
 
+DECLARE_SOA_TABLE(DPGTrackWeights, "AOD", "DPGTrackWeights", //! Table of the downsampling weights of the DPG tracks, joinable with DPGTracks
+                  dpgtrack::DownsamplingTier, dpgtrack::Weight);
+
 namespace dpgparticles
 {
 DECLARE_SOA_COLUMN(PtMC, ptMC, float);                   //! Pt MC
@@ -17,6 +17,11 @@
 /// \brief  Task to produce a table with reduced information used for correlation studies for track selection, ideally used with qaEventTrackite
 ///
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
 #include "qaEventTrack.h"
 
 #include "Framework/AnalysisTask.h"
@@ -43,6 +48,7 @@ struct qaEventTrackLiteProducer {
   Produces<o2::aod::DPGCollisions> tableCollisions;
   Produces<o2::aod::DPGCollsBig> tableCollsBig;
   Produces<o2::aod::DPGTracks> tableTracks;
+  Produces<o2::aod::DPGTrackWeights> tableTrackWeights;
   Produces<o2::aod::DPGRecoParticles> tableRecoParticles;
   Produces<o2::aod::DPGNonRecoParticles> tableNonRecoParticles;
 
@@ -71,6 +77,13 @@ struct qaEventTrackLiteProducer {
   Configurable<float> minPhi{"minPhi", -1.f, "Minimum phi of accepted tracks"};
   Configurable<float> maxPhi{"maxPhi", 10.f, "Maximum phi of accepted tracks"};
 
+  // downsampling and quantisation of the track table
+  Configurable<float> downsamplingFractionBulk{"downsamplingFractionBulk", 1.f, "Derived data option: fraction of stored tracks outside the rare categories, chosen with a hash of the track"};
+  Configurable<float> downsamplingPtMinRare{"downsamplingPtMinRare", 5.f, "Derived data option: tracks above this pt are all stored"};
+  Configurable<bool> downsamplingKeepAllTRD{"downsamplingKeepAllTRD", false, "Derived data option: tracks matched to the TRD are all stored"};
+  Configurable<bool> downsamplingKeepAllTOF{"downsamplingKeepAllTOF", false, "Derived data option: tracks matched to the TOF are all stored"};
+  Configurable<int> quantisationMantissaBits{"quantisationMantissaBits", 23, "Derived data option: mantissa bits kept in the float columns of the track table (23 keeps the full precision)"};
+
   // TODO: ask if one can have different filters for both process functions
   Filter trackFilter = (trackSelection.node() == 0) ||
                        ((trackSelection.node() == 1) && requireGlobalTrackInFilter()) ||
@@ -100,6 +113,16 @@ struct qaEventTrackLiteProducer {
   int counterColl;
   int counterDF;
 
+  // downsampling tiers of the tracks
+  enum DownsamplingTier : uint8_t {
+    kTierRare = 0, // stored for all the tracks
+    kTierBulk,     // downsampled
+    kTierDropped   // not stored
+  };
+  std::vector<uint8_t> trackTiers; // tiers of the selected tracks of a collision
+  uint32_t quantisationMask = ~0u;
+  uint32_t quantisationRounding = 0u;
+
   void init(InitContext const&)
   {
     int howManyProcesses = static_cast<int>(doprocessTableData) + static_cast<int>(doprocessTableMC) + static_cast<int>(doprocessTableDataCollsBig) + static_cast<int>(doprocessTableMCCollsBig);
@@ -115,6 +138,51 @@ struct qaEventTrackLiteProducer {
     if (doprocessTableMCCollsBig && storeOnlySinglePvCollsBig && storeOnlyMultiplePvCollsBig) {
       LOGF(fatal, "storeOnlySinglePvCollsBig and storeOnlyMultiplePvCollsBig are both activated. Not possible. Fix the configuration.");
     }
+
+    /// for the quantisation of the track table
+    const int nDroppedBits = 23 - std::clamp(quantisationMantissaBits.value, 0, 23);
+    if (nDroppedBits > 0) {
+      quantisationMask = ~0u << nDroppedBits;
+      quantisationRounding = 1u << (nDroppedBits - 1);
+    }
+  }
+
+  // Function to round a float to the mantissa bits kept in the track table, so that the table compresses better
+  float quantise(float value) const
+  {
+    if (quantisationRounding == 0u) {
+      return value;
+    }
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7f800000u) == 0x7f800000u) { // inf and nan are kept as they are
+      return value;
+    }
+    bits = (bits + quantisationRounding) & quantisationMask;
+    std::memcpy(&value, &bits, sizeof(bits));
+    return value;
+  }
+
+  // Function to assign the downsampling tier of a track
+  // The bulk tracks are chosen with a hash of the bunch crossing and of the track kinematics, so that the same tracks are stored when the data are processed again
+  template <typename T>
+  uint8_t getDownsamplingTier(const T& track, uint64_t globalBC) const
+  {
+    if (track.pt() > downsamplingPtMinRare || (downsamplingKeepAllTRD && track.hasTRD()) || (downsamplingKeepAllTOF && track.hasTOF())) {
+      return kTierRare;
+    }
+    if (downsamplingFractionBulk >= 1.f) {
+      return kTierBulk;
+    }
+    const float kine[3] = {track.pt(), track.eta(), track.phi()};
+    uint32_t kineBits[3];
+    std::memcpy(kineBits, kine, sizeof(kineBits));
+    uint64_t hash = globalBC ^ (static_cast<uint64_t>(kineBits[0]) << 32 | kineBits[1]) ^ (static_cast<uint64_t>(kineBits[2]) << 16);
+    // splitmix64 finaliser
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+    return static_cast<double>(hash >> 11) * 0x1.0p-53 < downsamplingFractionBulk ? kTierBulk : kTierDropped;
   }
 
   // Function to select tracks
@@ -217,40 +285,59 @@ struct qaEventTrackLiteProducer {
                     (isRun3 ? collision.sel8() : collision.sel7()),
                     collision.bc().runNumber(), collision.numContrib());
     int nTracks = 0;
+    int nStoredTracks = 0;
     int particleProduction = 0;
+    const uint64_t globalBC = collision.bc().globalBC();
+    const float weightBulk = downsamplingFractionBulk < 1.f ? 1.f / downsamplingFractionBulk : 1.f;
 
+    trackTiers.clear();
     for (const auto& track : tracks) {
       if (!isSelectedTrack<IS_MC>(track)) {
         continue;
       }
       ++nTracks;
+      trackTiers.push_back(getDownsamplingTier(track, globalBC));
+      if (trackTiers.back() != kTierDropped) {
+        ++nStoredTracks;
+      }
     }
-    tableTracks.reserve(nTracks);
+    tableTracks.reserve(nStoredTracks);
+    tableTrackWeights.reserve(nStoredTracks);
     std::vector<int64_t> recoPartIndices(IS_MC ? nTracks : 0);
 
     if constexpr (IS_MC) { // Running only on MC
-      tableRecoParticles.reserve(nTracks);
+      tableRecoParticles.reserve(nStoredTracks);
     }
     int64_t iTrack = 0;
+    int iSelectedTrack = 0;
     for (const auto& track : tracks) {
       if (!isSelectedTrack<IS_MC>(track)) {
         continue;
       }
+      const auto tier = trackTiers[iSelectedTrack++];
+      if constexpr (IS_MC) { // the particles of the tracks which are not stored are not written as non reconstructed particles either
+        if (track.has_mcParticle()) {
+          recoPartIndices[iTrack++] = track.mcParticleId();
+        }
+      }
+      if (tier == kTierDropped) {
+        continue;
+      }
       tableTracks(tableCollisions.lastIndex(),
-                  track.pt(), track.tpcInnerParam(), track.eta(), track.phi(), track.pt() * std::sqrt(track.c1Pt21Pt2()),
+                  quantise(track.pt()), quantise(track.tpcInnerParam()), quantise(track.eta()), quantise(track.phi()), quantise(track.pt() * std::sqrt(track.c1Pt21Pt2())),
                   track.flags(), track.sign(),
-                  track.dcaXY(), track.dcaZ(), track.length(),
+                  quantise(track.dcaXY()), quantise(track.dcaZ()), quantise(track.length()),
                   track.itsClusterMap(),
-                  track.itsChi2NCl(), track.tpcChi2NCl(), track.trdChi2(), track.tofChi2(),
+                  quantise(track.itsChi2NCl()), quantise(track.tpcChi2NCl()), quantise(track.trdChi2()), quantise(track.tofChi2()),
                   track.hasITS(), track.hasTPC(), track.hasTRD(), track.hasTOF(),
                   track.tpcNClsFound(), track.tpcNClsCrossedRows(),
-                  track.tpcCrossedRowsOverFindableCls(), track.tpcFoundOverFindableCls(), track.tpcFractionSharedCls(),
-                  track.itsNCls(), track.itsNClsInnerBarrel(), track.tpcSignal(), track.tofSignal() - track.tofEvTime());
+                  quantise(track.tpcCrossedRowsOverFindableCls()), quantise(track.tpcFoundOverFindableCls()), quantise(track.tpcFractionSharedCls()),
+                  track.itsNCls(), track.itsNClsInnerBarrel(), quantise(track.tpcSignal()), quantise(track.tofSignal() - track.tofEvTime()));
+      tableTrackWeights(tier, tier == kTierBulk ? weightBulk : 1.f);
 
       if constexpr (IS_MC) { // Running only on MC
         if (track.has_mcParticle()) {
           auto particle = track.mcParticle();
-          recoPartIndices[iTrack++] = particle.globalIndex();
           if (particle.isPhysicalPrimary()) {
             particleProduction = 0;
           } else if (particle.getProcess() == 4) {
@@ -269,6 +356,7 @@ struct qaEventTrackLiteProducer {
 
     // Running only on MC
     if constexpr (IS_MC) {
+      recoPartIndices.resize(iTrack); // tracks without MC particle
       if (!collision.has_mcCollision()) {
         return;
       }
@@ -36,7 +36,10 @@
 #include "CCDB/CcdbApi.h"
 #include "DataFormatsCalibration/MeanVertexObject.h"
 #include "CommonConstants/GeomConstants.h"
+#include "Math/SMatrix.h"
+#include "Math/SVector.h"
 
+#include "cmath"
 #include "iostream"
 #include "vector"
 #include "set"
@@ -52,6 +55,115 @@ using namespace o2::framework::expressions;
 
 #include "Framework/runDataProcessing.h"
 
+/// Linearised fit of the primary vertex from its contributors, to get the vertex without one contributor
+/// by removing its contribution from the normal equations of the fit instead of refitting the vertex.
+/// The contributors are approximated by straight lines at their point of closest approach to the vertex,
+/// with the covariance of their (y, z) parameters, and the robust weights of the PVertexer are not applied:
+/// the vertex without a contributor is the original vertex moved by the shift that the removal of the
+/// contributor gives in the linearised fit, which is an approximation of the full refit to be validated
+/// against it on a subsample.
+struct PVLinearisedFit {
+  using SMatrix33Sym = ROOT::Math::SMatrix<double, 3, 3, ROOT::Math::MatRepSym<double, 3>>;
+  using SMatrix22Sym = ROOT::Math::SMatrix<double, 2, 2, ROOT::Math::MatRepSym<double, 2>>;
+  using SMatrix23 = ROOT::Math::SMatrix<double, 2, 3>;
+  using SVector3 = ROOT::Math::SVector<double, 3>;
+  using SVector2 = ROOT::Math::SVector<double, 2>;
+
+  /// contribution of a track to chi2(v) = v^T A v - 2 b^T v + c, with v the vertex position
+  struct Contribution {
+    SMatrix33Sym a;
+    SVector3 b;
+    double c{0.};
+    bool isValid{false};
+  };
+
+  /// Computes the contributions of the tracks, propagated to the point of closest approach to the vertex
+  void init(std::vector<o2::track::TrackParCov> const& tracks, o2::dataformats::VertexBase const& vertex, o2::base::Propagator::MatCorrType matCorr)
+  {
+    contributions.assign(tracks.size(), Contribution{});
+    total = Contribution{};
+    total.isValid = true;
+    for (size_t iTrack = 0; iTrack < tracks.size(); iTrack++) {
+      auto track = tracks[iTrack];
+      if (!o2::base::Propagator::Instance()->propagateToDCABxByBz(vertex, track, 2.f, matCorr)) {
+        continue;
+      }
+      auto& contribution = contributions[iTrack];
+      const double csp = std::sqrt((1. - track.getSnp()) * (1. + track.getSnp()));
+      const double tgP = track.getSnp() / csp, tgL = track.getTgl() / csp;
+      const double cosAlpha = std::cos(track.getAlpha()), sinAlpha = std::sin(track.getAlpha());
+      // residuals of the track at the vertex in the track frame: r = a + J v, with v in the global frame
+      SMatrix23 jacobian;
+      jacobian(0, 0) = tgP * cosAlpha + sinAlpha;
+      jacobian(0, 1) = tgP * sinAlpha - cosAlpha;
+      jacobian(1, 0) = tgL * cosAlpha;
+      jacobian(1, 1) = tgL * sinAlpha;
+      jacobian(1, 2) = -1.;
+      const SVector2 offset(track.getY() - tgP * track.getX(), track.getZ() - tgL * track.getX());
+      SMatrix22Sym weight;
+      weight(0, 0) = track.getSigmaY2();
+      weight(0, 1) = track.getSigmaZY();
+      weight(1, 1) = track.getSigmaZ2();
+      if (!weight.InvertFast()) {
+        continue;
+      }
+      contribution.a = ROOT::Math::SimilarityT(jacobian, weight);
+      contribution.b = ROOT::Math::Transpose(jacobian) * (weight * offset);
+      contribution.b *= -1.;
+      contribution.c = ROOT::Math::Similarity(offset, weight);
+      contribution.isValid = true;
+      total.a += contribution.a;
+      total.b += contribution.b;
+      total.c += contribution.c;
+    }
+    reference = vertex;
+    SMatrix33Sym cov = total.a;
+    isValid = cov.InvertFast();
+    if (isValid) {
+      positionAll = cov * total.b;
+    }
+  }
+
+  /// Gets the vertex fitted without the track iTrack, or with all the tracks if iTrack < 0
+  /// \return false if the contribution of the track is not known or the remaining tracks do not constrain the vertex
+  bool getVertexWithout(int iTrack, o2::dataformats::PrimaryVertex& vertex) const
+  {
+    if (!isValid) {
+      return false;
+    }
+    SMatrix33Sym a = total.a;
+    SVector3 b = total.b;
+    double c = total.c;
+    int nContributors = contributions.size();
+    if (iTrack >= 0) {
+      const auto& contribution = contributions[iTrack];
+      if (!contribution.isValid) {
+        return false;
+      }
+      a -= contribution.a;
+      b -= contribution.b;
+      c -= contribution.c;
+      nContributors--;
+    }
+    SMatrix33Sym cov = a;
+    if (!cov.InvertFast()) {
+      return false;
+    }
+    const SVector3 position = cov * b;
+    vertex.setXYZ(reference.getX() + position(0) - positionAll(0), reference.getY() + position(1) - positionAll(1), reference.getZ() + position(2) - positionAll(2));
+    vertex.setCov(cov(0, 0), cov(1, 0), cov(1, 1), cov(2, 0), cov(2, 1), cov(2, 2));
+    vertex.setChi2(c - ROOT::Math::Dot(b, position));
+    vertex.setNContributors(nContributors);
+    return true;
+  }
+
+  std::vector<Contribution> contributions;
+  Contribution total;                    // sum of the contributions
+  SVector3 positionAll;                  // position of the linearised fit with all the contributions
+  o2::dataformats::VertexBase reference; // vertex fitted with all the contributors
+  bool isValid{false};                   // whether the linearised fit with all the contributions is defined
+};
+
 /// QA task for impact parameter distribution monitoring
 struct QaImpactPar {
 
@@ -106,6 +218,8 @@ struct QaImpactPar {
   Configurable<uint16_t> maxPVcontrib{"maxPVcontrib", 10000, "Maximum number of PV contributors"};
   Configurable<bool> removeDiamondConstraint{"removeDiamondConstraint", true, "Remove the diamond constraint for the PV refit"};
   Configurable<bool> keepAllTracksPVrefit{"keepAllTracksPVrefit", false, "Keep all tracks for PV refit (for debug)"};
+  Configurable<bool> fastPVrefit{"fastPVrefit", false, "Get the PV without each contributor by removing its contribution from a linearised fit instead of a full refit (requires removeDiamondConstraint)"};
+  Configurable<int> fastPVrefitValidationPeriod{"fastPVrefitValidationPeriod", 0, "With fastPVrefit, compare to the full refit for one contributor every N (0: never)"};
   Configurable<bool> use_customITSHitMap{"use_customITSHitMap", false, "Use custom ITS hitmap selection"};
   Configurable<int> customITShitmap{"customITShitmap", 0, "Custom ITS hitmap (consider the binary representation)"};
   Configurable<int> n_customMinITShits{"n_customMinITShits", 0, "Minimum number of layers crossed by a track among those in \"customITShitmap\""};
@@ -114,6 +228,9 @@ struct QaImpactPar {
   /// Custom cut selection objects
   TrackSelection selector_ITShitmap;
 
+  /// Linearised PV fit for the fast PV refit
+  PVLinearisedFit pvLinearisedFit;
+
   /// Selections with Filter (from o2::framework::expressions)
   // Primary vertex |z_vtx|<XXX cm
   Filter collisionZVtxFilter = (nabs(o2::aod::collision::posZ) < zVtxMax);
@@ -220,6 +337,14 @@ struct QaImpactPar {
       histograms.add("Reco/Z_PVrefitChi2minus1", "PV refit with #chi^{2}==-1", kTH2D, {collisionZAxis, collisionZOrigAxis});
       histograms.add("Reco/nContrib_PVrefitNotDoable", "N. contributors for PV refit not doable", kTH1D, {collisionNumberContributorAxis});
       histograms.add("Reco/nContrib_PVrefitChi2minus1", "N. contributors original PV for PV refit #chi^{2}==-1", kTH1D, {collisionNumberContributorAxis});
+      if (fastPVrefit && fastPVrefitValidationPeriod > 0) {
+        histograms.add("Reco/nContrib_vs_DeltaX_fastVsFullPVrefit", "fast minus full PV refit", kTH2D, {collisionNumberContributorAxis, collisionDeltaX_PVrefit});
+        histograms.add("Reco/nContrib_vs_DeltaY_fastVsFullPVrefit", "fast minus full PV refit", kTH2D, {collisionNumberContributorAxis, collisionDeltaY_PVrefit});
+        histograms.add("Reco/nContrib_vs_DeltaZ_fastVsFullPVrefit", "fast minus full PV refit", kTH2D, {collisionNumberContributorAxis, collisionDeltaZ_PVrefit});
+      }
+    }
+    if (fastPVrefit && !removeDiamondConstraint) {
+      LOG(warning) << "fastPVrefit does not include the diamond constraint: the full PV refit is used";
     }
 
     // Needed for PV refitting
@@ -433,6 +558,11 @@ struct QaImpactPar {
       histograms.fill(HIST("Reco/vertices"), 2);
     }
 
+    const bool useFastPVrefit = doPVrefit && PVrefit_doable && fastPVrefit && removeDiamondConstraint;
+    if (useFastPVrefit) {
+      pvLinearisedFit.init(vec_TrkContributos, Pvtx, matCorr);
+    }
+
     if (fDebug) {
       LOG(info) << "prepareVertexRefit = " << PVrefit_doable << " Ncontrib= " << vec_TrkContributos.size() << " Ntracks= " << collision.numContrib() << " Vtx= " << Pvtx.asString();
     }
@@ -568,7 +698,17 @@ struct QaImpactPar {
           if (!keepAllTracksPVrefit) {
             vec_useTrk_PVrefit[entry] = false; /// remove the track from the PV refitting
           }
-          auto Pvtx_refitted = vertexer.refitVertex(vec_useTrk_PVrefit, Pvtx); // vertex refit
+          o2::dataformats::PrimaryVertex Pvtx_refitted;
+          if (!useFastPVrefit || !pvLinearisedFit.getVertexWithout(keepAllTracksPVrefit ? -1 : entry, Pvtx_refitted)) {
+            Pvtx_refitted = vertexer.refitVertex(vec_useTrk_PVrefit, Pvtx); // vertex refit
+          } else if (fastPVrefitValidationPeriod > 0 && cnt % fastPVrefitValidationPeriod == 0) {
+            auto Pvtx_fullRefit = vertexer.refitVertex(vec_useTrk_PVrefit, Pvtx);
+            if (Pvtx_fullRefit.getChi2() >= 0) {
+              histograms.fill(HIST("Reco/nContrib_vs_DeltaX_fastVsFullPVrefit"), collision.numContrib(), Pvtx_refitted.getX() - Pvtx_fullRefit.getX());
+              histograms.fill(HIST("Reco/nContrib_vs_DeltaY_fastVsFullPVrefit"), collision.numContrib(), Pvtx_refitted.getY() - Pvtx_fullRefit.getY());
+              histograms.fill(HIST("Reco/nContrib_vs_DeltaZ_fastVsFullPVrefit"), collision.numContrib(), Pvtx_refitted.getZ() - Pvtx_fullRefit.getZ());
+            }
+          }
           if (fDebug) {
             LOG(info) << "refit " << cnt << "/" << ntr << " result = " << Pvtx_refitted.asString();
           }
@@ -184,8 +184,22 @@ struct qaMatchEff {
   //
   //  Init function
   //
+  // PID nSigma windows and dcaZ cut, copied at init from the labeled arrays to avoid their lookups by name per track
+  // windows indexed as [TPC, TOF][pion, kaon, proton][min, max]
+  float pidWindows[2][3][2];
+  float dcaZMax = 0.f;
+
   void init(o2::framework::InitContext&)
   {
+    const char* pidDets[2] = {"TPC", "TOF"};
+    const char* pidSpecies[3] = {"Pion", "Kaon", "Proton"};
+    for (int iDet = 0; iDet < 2; iDet++) {
+      for (int iSp = 0; iSp < 3; iSp++) {
+        pidWindows[iDet][iSp][0] = nSigmaPID->get(pidDets[iDet], Form("nSig%sMin", pidSpecies[iSp]));
+        pidWindows[iDet][iSp][1] = nSigmaPID->get(pidDets[iDet], Form("nSig%sMax", pidSpecies[iSp]));
+      }
+    }
+    dcaZMax = dcaMaxCut->get("TrVtx", "dcaZ");
     if (doDebug)
       LOG(info) << "===========================================>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>  is it MC? = " << isitMC;
     //
@@ -1235,7 +1249,7 @@ struct qaMatchEff {
     if (!cutObject.IsSelected(track, TrackSelection::TrackCuts::kDCAxy))
       return false;
     // dcaZ selection to simulate the dca cut in QC ()
-    if (abs(track.dcaZ()) > dcaMaxCut->get("TrVtx", "dcaZ"))
+    if (abs(track.dcaZ()) > dcaZMax)
       return false;
     return true;
   }
@@ -1389,12 +1403,15 @@ struct qaMatchEff {
       const bool trkWTOF = track.hasTOF();
       const bool trkWTPC = track.hasTPC();
       const bool trkWITS = track.hasITS();
-      bool pionPIDwithTPC = (nSigmaPID->get("TPC", "nSigPionMin") < tpcNSigmaPion && tpcNSigmaPion < nSigmaPID->get("TPC", "nSigPionMax"));
-      bool pionPIDwithTOF = (nSigmaPID->get("TOF", "nSigPionMin") < tofNSigmaPion && tofNSigmaPion < nSigmaPID->get("TOF", "nSigPionMax"));
-      bool kaonPIDwithTPC = (nSigmaPID->get("TPC", "nSigKaonMin") < tpcNSigmaKaon && tpcNSigmaKaon < nSigmaPID->get("TPC", "nSigKaonMax"));
-      bool kaonPIDwithTOF = (nSigmaPID->get("TOF", "nSigKaonMin") < tofNSigmaKaon && tofNSigmaKaon < nSigmaPID->get("TOF", "nSigKaonMax"));
-      bool protonPIDwithTPC = (nSigmaPID->get("TPC", "nSigProtonMin") < tpcNSigmaProton && tpcNSigmaProton < nSigmaPID->get("TPC", "nSigProtonMax"));
-      bool protonPIDwithTOF = (nSigmaPID->get("TOF", "nSigProtonMin") < tofNSigmaProton && tofNSigmaProton < nSigmaPID->get("TOF", "nSigProtonMax"));
+      // detector selections, evaluated once per track for all the histograms below
+      const bool trkTPCSelected = trkWTPC && isTrackSelectedTPCCuts(track);
+      const bool trkITSSelected = trkWITS && isTrackSelectedITSCuts(track);
+      bool pionPIDwithTPC = (pidWindows[0][0][0] < tpcNSigmaPion && tpcNSigmaPion < pidWindows[0][0][1]);
+      bool pionPIDwithTOF = (pidWindows[1][0][0] < tofNSigmaPion && tofNSigmaPion < pidWindows[1][0][1]);
+      bool kaonPIDwithTPC = (pidWindows[0][1][0] < tpcNSigmaKaon && tpcNSigmaKaon < pidWindows[0][1][1]);
+      bool kaonPIDwithTOF = (pidWindows[1][1][0] < tofNSigmaKaon && tofNSigmaKaon < pidWindows[1][1][1]);
+      bool protonPIDwithTPC = (pidWindows[0][2][0] < tpcNSigmaProton && tpcNSigmaProton < pidWindows[0][2][1]);
+      bool protonPIDwithTOF = (pidWindows[1][2][0] < tofNSigmaProton && tofNSigmaProton < pidWindows[1][2][1]);
       // isPion
       bool isPion = false;
       if (isPIDPionRequired && pionPIDwithTPC && ((!trkWTOF) || pionPIDwithTOF))
@@ -1552,7 +1569,7 @@ struct qaMatchEff {
       //
       // all tracks w/TPC
       //
-      if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+      if (trkTPCSelected) {
         if constexpr (IS_MC) { ////////////////////////   MC
           //
           // TPC clusters
@@ -1634,7 +1651,7 @@ struct qaMatchEff {
           //     histos.get<TH1>(HIST("MC/TPCclust/tpcsFindableMinusCrossedRows_pr_tpc_1g"))->Fill(crowstpc);
           //   }
           // }
-          // if (trkWITS && isTrackSelectedITSCuts(track)) { ////////////////////////////////////////////   ITS tag inside TPC tagged
+          // if (trkITSSelected) { ////////////////////////////////////////////   ITS tag inside TPC tagged
           //   if (isPion) {
           //     //
           //     // TPC clusters
@@ -1961,7 +1978,7 @@ struct qaMatchEff {
           } // not pions, nor kaons, nor protons
         }   // end if DATA
         //
-        if (trkWITS && isTrackSelectedITSCuts(track)) { ////////////////////////////////////////////   ITS tag inside TPC tagged
+        if (trkITSSelected) { ////////////////////////////////////////////   ITS tag inside TPC tagged
           if constexpr (IS_MC) {                        ////////////////////////   MC
             //
             // TPC clusters
@@ -2294,7 +2311,7 @@ struct qaMatchEff {
       //
       // all tracks with pt>0.5
       if (trackPt > 0.5) {
-        if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+        if (trkTPCSelected) {
           if constexpr (IS_MC) { ////////////////////////   MC
             histos.get<TH1>(HIST("MC/pthist_tpc_05"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/phihist_tpc_05"))->Fill(track.phi());
@@ -2304,7 +2321,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("data/phihist_tpc_05"))->Fill(track.phi());
             histos.get<TH1>(HIST("data/etahist_tpc_05"))->Fill(track.eta());
           }
-          if (trkWITS && isTrackSelectedITSCuts(track)) {
+          if (trkITSSelected) {
             if constexpr (IS_MC) {
               histos.get<TH1>(HIST("MC/pthist_tpcits_05"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/phihist_tpcits_05"))->Fill(track.phi());
@@ -2320,7 +2337,7 @@ struct qaMatchEff {
       //
       // positive only
       if (track.signed1Pt() > 0) {
-        if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+        if (trkTPCSelected) {
           if constexpr (IS_MC) {
             histos.get<TH1>(HIST("MC/pthist_tpc_pos"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/phihist_tpc_pos"))->Fill(track.phi());
@@ -2330,7 +2347,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("data/phihist_tpc_pos"))->Fill(track.phi());
             histos.get<TH1>(HIST("data/etahist_tpc_pos"))->Fill(track.eta());
           }
-          if (trkWITS && isTrackSelectedITSCuts(track)) {
+          if (trkITSSelected) {
             if constexpr (IS_MC) {
               histos.get<TH1>(HIST("MC/pthist_tpcits_pos"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/phihist_tpcits_pos"))->Fill(track.phi());
@@ -2347,7 +2364,7 @@ struct qaMatchEff {
       //
       // negative only
       if (track.signed1Pt() < 0) {
-        if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+        if (trkTPCSelected) {
           if constexpr (IS_MC) {
             histos.get<TH1>(HIST("MC/pthist_tpc_neg"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/phihist_tpc_neg"))->Fill(track.phi());
@@ -2357,7 +2374,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("data/phihist_tpc_neg"))->Fill(track.phi());
             histos.get<TH1>(HIST("data/etahist_tpc_neg"))->Fill(track.eta());
           }
-          if (trkWITS && isTrackSelectedITSCuts(track)) {
+          if (trkITSSelected) {
             if constexpr (IS_MC) {
               histos.get<TH1>(HIST("MC/pthist_tpcits_neg"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/phihist_tpcits_neg"))->Fill(track.phi());
@@ -2377,7 +2394,7 @@ struct qaMatchEff {
         //
         // only primaries
         if (mcpart.isPhysicalPrimary()) {
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkTPCSelected) {
             histos.get<TH1>(HIST("MC/primsec/zDCA_tpc_prim"))->Fill(track.dcaZ());
             histos.get<TH1>(HIST("MC/primsec/xyDCA_tpc_prim"))->Fill(track.dcaXY());
             //
@@ -2385,7 +2402,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("MC/primsec/pthist_tpc_prim"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/primsec/phihist_tpc_prim"))->Fill(track.phi());
             histos.get<TH1>(HIST("MC/primsec/etahist_tpc_prim"))->Fill(track.eta());
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkITSSelected) {
               histos.get<TH1>(HIST("MC/primsec/zDCA_tpcits_prim"))->Fill(track.dcaZ());
               histos.get<TH1>(HIST("MC/primsec/xyDCA_tpcits_prim"))->Fill(track.dcaXY());
               //
@@ -2399,7 +2416,7 @@ struct qaMatchEff {
         } else if (mcpart.getProcess() == 4) {
           //
           // only secondaries from decay
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkTPCSelected) {
             histos.get<TH1>(HIST("MC/primsec/zDCA_tpc_secd"))->Fill(track.dcaZ());
             histos.get<TH1>(HIST("MC/primsec/xyDCA_tpc_secd"))->Fill(track.dcaXY());
             //
@@ -2407,7 +2424,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("MC/primsec/pthist_tpc_secd"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/primsec/phihist_tpc_secd"))->Fill(track.phi());
             histos.get<TH1>(HIST("MC/primsec/etahist_tpc_secd"))->Fill(track.eta());
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkITSSelected) {
               histos.get<TH1>(HIST("MC/primsec/zDCA_tpcits_secd"))->Fill(track.dcaZ());
               histos.get<TH1>(HIST("MC/primsec/xyDCA_tpcits_secd"))->Fill(track.dcaXY());
               //
@@ -2421,7 +2438,7 @@ struct qaMatchEff {
         } else {
           //
           // only secondaries from material
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkTPCSelected) {
             histos.get<TH1>(HIST("MC/primsec/zDCA_tpc_secm"))->Fill(track.dcaZ());
             histos.get<TH1>(HIST("MC/primsec/xyDCA_tpc_secm"))->Fill(track.dcaXY());
             //
@@ -2429,7 +2446,7 @@ struct qaMatchEff {
             histos.get<TH1>(HIST("MC/primsec/pthist_tpc_secm"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/primsec/phihist_tpc_secm"))->Fill(track.phi());
             histos.get<TH1>(HIST("MC/primsec/etahist_tpc_secm"))->Fill(track.eta());
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkITSSelected) {
               histos.get<TH1>(HIST("MC/primsec/zDCA_tpcits_secm"))->Fill(track.dcaZ());
               histos.get<TH1>(HIST("MC/primsec/xyDCA_tpcits_secm"))->Fill(track.dcaXY());
               //
@@ -2443,7 +2460,7 @@ struct qaMatchEff {
         //
         // protons only
         if (tpPDGCode == 2212) {
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkTPCSelected) {
             //
             // TPC clusters
             histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_prMC_tpc"))->Fill(clustpc);
@@ -2474,7 +2491,7 @@ struct qaMatchEff {
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_prminus"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_prminus"))->Fill(track.eta());
             }
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkITSSelected) {
               //
               // TPC clusters
               histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_prMC_tpcits"))->Fill(clustpc);
@@ -2511,7 +2528,7 @@ struct qaMatchEff {
         //
         // pions only
         if (tpPDGCode == 211) {
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkTPCSelected) {
             //
             // TPC clusters
             histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_piMC_tpc"))->Fill(clustpc);
@@ -2542,7 +2559,7 @@ struct qaMatchEff {
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_piminus"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_piminus"))->Fill(track.eta());
             }
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkITSSelected) {
               //
               // TPC clusters
               histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_piMC_tpcits"))->Fill(clustpc);
@@ -2578,11 +2595,11 @@ struct qaMatchEff {
           //
           // only primary pions
           if (mcpart.isPhysicalPrimary()) {
-            if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+            if (trkTPCSelected) {
               histos.get<TH1>(HIST("MC/PID/pthist_tpc_pi_prim"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_pi_prim"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_pi_prim"))->Fill(track.eta());
-              if (trkWITS && isTrackSelectedITSCuts(track)) {
+              if (trkITSSelected) {
                 histos.get<TH1>(HIST("MC/PID/pthist_tpcits_pi_prim"))->Fill(trackPt);
                 histos.get<TH1>(HIST("MC/PID/phihist_tpcits_pi_prim"))->Fill(track.phi());
                 histos.get<TH1>(HIST("MC/PID/etahist_tpcits_pi_prim"))->Fill(track.eta());
@@ -2592,11 +2609,11 @@ struct qaMatchEff {
           } else if (mcpart.getProcess() == 4) {
             //
             // only secondary pions from decay
-            if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+            if (trkTPCSelected) {
               histos.get<TH1>(HIST("MC/PID/pthist_tpc_pi_secd"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_pi_secd"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_pi_secd"))->Fill(track.eta());
-              if (trkWITS && isTrackSelectedITSCuts(track)) {
+              if (trkITSSelected) {
                 histos.get<TH1>(HIST("MC/PID/pthist_tpcits_pi_secd"))->Fill(trackPt);
                 histos.get<TH1>(HIST("MC/PID/phihist_tpcits_pi_secd"))->Fill(track.phi());
                 histos.get<TH1>(HIST("MC/PID/etahist_tpcits_pi_secd"))->Fill(track.eta());
@@ -2606,11 +2623,11 @@ struct qaMatchEff {
           } else {
             //
             // only secondary pions from material
-            if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+            if (trkTPCSelected) {
               histos.get<TH1>(HIST("MC/PID/pthist_tpc_pi_secm"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_pi_secm"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_pi_secm"))->Fill(track.eta());
-              if (trkWITS && isTrackSelectedITSCuts(track)) {
+              if (trkITSSelected) {
                 histos.get<TH1>(HIST("MC/PID/pthist_tpcits_pi_secm"))->Fill(trackPt);
                 histos.get<TH1>(HIST("MC/PID/phihist_tpcits_pi_secm"))->Fill(track.phi());
                 histos.get<TH1>(HIST("MC/PID/etahist_tpcits_pi_secm"))->Fill(track.eta());
@@ -2630,12 +2647,12 @@ struct qaMatchEff {
           else
             pdg_fill = -10.0;
           //
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkTPCSelected) {
             histos.get<TH1>(HIST("MC/PID/pthist_tpc_nopi"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/PID/phihist_tpc_nopi"))->Fill(track.phi());
             histos.get<TH1>(HIST("MC/PID/etahist_tpc_nopi"))->Fill(track.eta());
             histos.get<TH1>(HIST("MC/PID/pdghist_den"))->Fill(pdg_fill);
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkITSSelected) {
               histos.get<TH1>(HIST("MC/PID/pthist_tpcits_nopi"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/PID/phihist_tpcits_nopi"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpcits_nopi"))->Fill(track.eta());
@@ -2646,7 +2663,7 @@ struct qaMatchEff {
         //
         // kaons only
         if (tpPDGCode == 321) {
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkTPCSelected) {
             //
             // TPC clusters
             histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_kaMC_tpc"))->Fill(clustpc);
@@ -2677,7 +2694,7 @@ struct qaMatchEff {
               histos.get<TH1>(HIST("MC/PID/phihist_tpc_kaminus"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpc_kaminus"))->Fill(track.eta());
             }
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkITSSelected) {
               //
               // TPC clusters
               histos.get<TH1>(HIST("MC/TPCclust/tpcNClsFound_kaMC_tpcits"))->Fill(clustpc);
@@ -2714,11 +2731,11 @@ struct qaMatchEff {
         //
         // pions and kaons together
         if (tpPDGCode == 211 || tpPDGCode == 321) {
-          if (trkWTPC && isTrackSelectedTPCCuts(track)) {
+          if (trkTPCSelected) {
             histos.get<TH1>(HIST("MC/PID/pthist_tpc_piK"))->Fill(trackPt);
             histos.get<TH1>(HIST("MC/PID/phihist_tpc_piK"))->Fill(track.phi());
             histos.get<TH1>(HIST("MC/PID/etahist_tpc_piK"))->Fill(track.eta());
-            if (trkWITS && isTrackSelectedITSCuts(track)) {
+            if (trkITSSelected) {
               histos.get<TH1>(HIST("MC/PID/pthist_tpcits_piK"))->Fill(trackPt);
               histos.get<TH1>(HIST("MC/PID/phihist_tpcits_piK"))->Fill(track.phi());
               histos.get<TH1>(HIST("MC/PID/etahist_tpcits_piK"))->Fill(track.eta());
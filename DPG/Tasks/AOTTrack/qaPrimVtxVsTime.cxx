@@ -10,6 +10,9 @@
 // or submit itself to any jurisdiction.
 /// \author Mattia Faggin <mattia.faggin@cern.ch>, Padova University and INFN
 
+#include <algorithm>
+#include <cmath>
+
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
@@ -22,6 +25,7 @@
 #include "DataFormatsParameters/GRPECSObject.h"
 #include "TH1F.h"
 #include "TH2F.h"
+#include "TH2D.h"
 
 using namespace o2::framework;
 using namespace o2;
@@ -33,9 +37,13 @@ struct QaPrimVtxVsTime {
 
   Configurable<std::string> ccdburl{"ccdburl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   ConfigurableAxis binsVertexPosZ{"binsVertexPosZ", {100, -20., 20.}, ""};
+  Configurable<bool> fillPosZvsTime{"fillPosZvsTime", true, "Fill the posZ vs. time histogram, with one bin per second and per posZ bin"};
+  Configurable<double> timeChunkSeconds{"timeChunkSeconds", 1., "Width in seconds of the time chunks of the posZ moments"};
 
   AxisSpec axisVertexPosZ{binsVertexPosZ, "Primary vertex Z (cm)"};
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
+  std::shared_ptr<TH2> hPosZMoments;
+  double nMomentsEntries = 0;
 
   /// @brief init function
   /// @param
@@ -75,7 +83,19 @@ struct QaPrimVtxVsTime {
       double minSec = floor(tsSOR / 1000.); /// round tsSOR to the highest integer lower than tsSOR
       double maxSec = ceil(tsEOR / 1000.);  /// round tsEOR to the lowest integer higher than tsEOR
       const AxisSpec axisSeconds{static_cast<int>(maxSec - minSec), minSec, maxSec, "seconds (from January 1st, 1970 at UTC)"};
-      histos.add("hPosZvsTime", "", kTH2F, {axisSeconds, axisVertexPosZ});
+      if (fillPosZvsTime) {
+        histos.add("hPosZvsTime", "", kTH2F, {axisSeconds, axisVertexPosZ});
+      }
+      /// N, sum of posZ and sum of posZ^2 per time chunk, from which the mean and variance of posZ are obtained
+      /// also in chunks much finer than the posZ vs. time histogram allows, and which add up when merged
+      const int nChunks = std::max(1, static_cast<int>(std::ceil((maxSec - minSec) / timeChunkSeconds)));
+      const AxisSpec axisChunks{nChunks, minSec, minSec + nChunks * timeChunkSeconds, "seconds (from January 1st, 1970 at UTC)"};
+      const AxisSpec axisMoments{3, -0.5, 2.5, "moment (N, #Sigma z, #Sigma z^{2})"};
+      hPosZMoments = histos.add<TH2>("hPosZMomentsVsTime", "", kTH2D, {axisChunks, axisMoments});
+    }
+
+    if (!hPosZMoments) {
+      return;
     }
 
     /// The rest of the code is always run
@@ -87,8 +107,17 @@ struct QaPrimVtxVsTime {
       }
 
       const auto timestamp = collision.bc_as<BCsWithTimeStamp>().timestamp(); /// NB: in ms
-      histos.fill(HIST("hPosZvsTime"), timestamp / 1000., collision.posZ());
+      if (fillPosZvsTime) {
+        histos.fill(HIST("hPosZvsTime"), timestamp / 1000., collision.posZ());
+      }
+      const double posZ = collision.posZ();
+      const int chunk = hPosZMoments->GetXaxis()->FindBin(timestamp / 1000.);
+      hPosZMoments->AddBinContent(hPosZMoments->GetBin(chunk, 1), 1.);
+      hPosZMoments->AddBinContent(hPosZMoments->GetBin(chunk, 2), posZ);
+      hPosZMoments->AddBinContent(hPosZMoments->GetBin(chunk, 3), posZ * posZ);
+      nMomentsEntries++;
     }
+    hPosZMoments->SetEntries(nMomentsEntries);
   }
 };
 //__________________________________________________________
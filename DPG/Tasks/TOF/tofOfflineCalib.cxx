@@ -16,6 +16,8 @@
 /// \brief  Task to produce calibration objects for the TOF. Based on AO2D or TOF skimmed data
 ///
 
+#include <vector>
+
 #include "Framework/AnalysisTask.h"
 #include "Framework/runDataProcessing.h"
 #include "Common/DataModel/PIDResponse.h"
@@ -105,6 +107,17 @@ struct tofOfflineCalib {
                        ((trackSelection.node() == 4) && requireQualityTracksInFilter()) ||
                        ((trackSelection.node() == 5) && requireInAcceptanceTracksInFilter());
 
+  // Quantities of the tracks used in the pair loop, computed once per track instead of once per pair
+  struct TrackCache {
+    float deltaEl = 0.f;
+    float deltaMu = 0.f;
+    float deltaPi = 0.f;
+    float deltaKa = 0.f;
+    float deltaPr = 0.f;
+    int8_t lastTRDLayer = -1;
+  };
+  std::vector<TrackCache> trackCache;
+
   int lastRun = -1;
   void process(soa::Filtered<Coll>::iterator const& collision,
                soa::Filtered<Trks> const& tracks,
@@ -148,30 +161,52 @@ struct tofOfflineCalib {
       deltaVsPHighChi2 = histos.add<TH2>(Form("Run%i/deltaVsPHighChi2", lastRun), "High Chi2", kTH2F, {pTAxis, doubleDeltaAxis});
     }
 
-    int8_t lastTRDLayer = -1;
+    // Expected times and last TRD layer of the TOF tracks
+    trackCache.assign(tracks.size(), TrackCache{});
+    int iTrack = 0;
+    for (auto& track : tracks) {
+      auto& cache = trackCache[iTrack++];
+      if (!track.hasTOF()) {
+        continue;
+      }
+      const float tofSignalNoEvTime = track.tofSignal() - track.tofEvTime();
+      cache.deltaEl = track.tofSignal() - track.tofExpSignalEl(tofSignalNoEvTime);
+      cache.deltaMu = track.tofSignal() - track.tofExpSignalMu(tofSignalNoEvTime);
+      cache.deltaPi = track.tofSignal() - track.tofExpSignalPi(tofSignalNoEvTime);
+      cache.deltaKa = track.tofSignal() - track.tofExpSignalKa(tofSignalNoEvTime);
+      cache.deltaPr = track.tofSignal() - track.tofExpSignalPr(tofSignalNoEvTime);
+      if (track.hasTRD()) {
+        for (int8_t l = 7; l >= 0; l--) {
+          if (track.trdPattern() & (1 << l)) {
+            cache.lastTRDLayer = l;
+            break;
+          }
+        }
+      }
+    }
+
+    int iTrack1 = -1;
     for (auto& track1 : tracks) {
+      iTrack1++;
       if (!track1.hasTOF()) {
         continue;
       }
       // Selecting good reference
-      const float& texp1Pi = track1.tofExpSignalPi(track1.tofSignal() - track1.tofEvTime());
-      const float& delta1Pi = track1.tofSignal() - texp1Pi;
+      const float& delta1Pi = trackCache[iTrack1].deltaPi;
       if (track1.p() < pRefMin || track1.p() > pRefMax || track1.tofChi2() > maxTOFChi2 || fabs(delta1Pi) > deltatTh) {
         continue;
       }
+      int iTrack2 = -1;
       for (auto& track2 : tracks) {
+        iTrack2++;
         if (!track2.hasTOF()) {
           continue;
         }
         if (track1.globalIndex() == track2.globalIndex()) { // Skipping the same track
           continue;
         }
-        const float& texp2El = track2.tofExpSignalEl(track2.tofSignal() - track2.tofEvTime());
-        const float& texp2Mu = track2.tofExpSignalMu(track2.tofSignal() - track2.tofEvTime());
-        const float& texp2Pi = track2.tofExpSignalPi(track2.tofSignal() - track2.tofEvTime());
-        const float& texp2Ka = track2.tofExpSignalKa(track2.tofSignal() - track2.tofEvTime());
-        const float& texp2Pr = track2.tofExpSignalPr(track2.tofSignal() - track2.tofEvTime());
-        const float& delta2Pi = track2.tofSignal() - texp2Pi;
+        const auto& cache2 = trackCache[iTrack2];
+        const float& delta2Pi = cache2.deltaPi;
         if (track2.tofChi2() < maxTOFChi2) {
           deltaVsP->Fill(track2.p(), delta2Pi - delta1Pi);
         } else if (track2.tofChi2() > maxTOFChi2) {
@@ -192,16 +227,6 @@ struct tofOfflineCalib {
             }
           }
         }
-        lastTRDLayer = -1;
-        if (track2.hasTRD()) {
-          for (int8_t l = 7; l >= 0; l--) {
-            if (track2.trdPattern() & (1 << l)) {
-              lastTRDLayer = l;
-              break;
-            }
-          }
-        }
-
         if (!makeTable) {
           continue;
         }
@@ -214,11 +239,11 @@ struct tofOfflineCalib {
                  track1.eta() - track2.eta(),
                  track2.phi(),
                  track1.phi() - track2.phi(),
-                 track2.tofSignal() - texp2El,
-                 track2.tofSignal() - texp2Mu,
+                 cache2.deltaEl,
+                 cache2.deltaMu,
                  delta2Pi,
-                 track2.tofSignal() - texp2Ka,
-                 track2.tofSignal() - texp2Pr,
+                 cache2.deltaKa,
+                 cache2.deltaPr,
                  delta2Pi - delta1Pi,
                  track1.sign(),
                  track2.length(),
@@ -235,7 +260,7 @@ struct tofOfflineCalib {
                  collision.collisionTime(),
                  collision.collisionTimeRes(),
                  track2.tofFlags(),
-                 lastTRDLayer);
+                 cache2.lastTRDLayer);
 
         // float doubleDelta = delta2Pi - delta1Pi;
 
@@ -114,16 +114,17 @@ struct TreeWriterTpcV0 {
     }
   };
 
-  double tsalisCharged(double pt, double mass, double sqrts)
+  /// Ratio of the Tsalis/Hagedorn spectrum at pt to its value at pt = 1 GeV/c, computed with a single pow
+  double tsalisChargedOverNorm(double pt, double mass, double sqrts)
   {
     const double a = 6.81, b = 59.24;
     const double c = 0.082, d = 0.151;
     const double mt = std::sqrt(mass * mass + pt * pt);
+    const double mtNorm = std::sqrt(mass * mass + 1.);
     const double n = a + b / sqrts;
     const double T = c + d / sqrts;
     const double p0 = n * T;
-    const double result = std::pow((1. + mt / p0), -n);
-    return result;
+    return std::pow((p0 + mt) / (p0 + mtNorm), -n);
   };
 
   /// Random downsampling trigger function using Tsalis/Hagedorn spectra fit (sqrt(s) = 62.4 GeV to 13 TeV)
@@ -134,13 +135,12 @@ struct TreeWriterTpcV0 {
     if (factor1Pt < 0.) {
       return true;
     }
-    const double prob = tsalisCharged(pt, mass, sqrts) * pt;
-    const double probNorm = tsalisCharged(1., mass, sqrts);
-    if ((fRndm->Rndm() * ((prob / probNorm) * pt * pt)) > factor1Pt) {
-      return false;
-    } else {
+    const double weight = tsalisChargedOverNorm(pt, mass, sqrts) * pt * pt * pt;
+    // a track with weight below the factor is always kept, no random number is needed
+    if (weight <= factor1Pt) {
       return true;
     }
+    return fRndm->Rndm() * weight <= factor1Pt;
   };
 
   /// Event selection
@@ -279,16 +279,17 @@ struct TreeWriterTPCTOF {
                        ((trackSelection.node() == 4) && requireQualityTracksInFilter()) ||
                        ((trackSelection.node() == 5) && requireTrackCutInFilter(TrackSelectionFlags::kInAcceptanceTracks));
 
-  double tsalisCharged(double pt, double mass, double sqrts)
+  /// Ratio of the Tsalis/Hagedorn spectrum at pt to its value at pt = 1 GeV/c, computed with a single pow
+  double tsalisChargedOverNorm(double pt, double mass, double sqrts)
   {
     const double a = 6.81, b = 59.24;
     const double c = 0.082, d = 0.151;
-    double mt = std::sqrt(mass * mass + pt * pt);
-    double n = a + b / sqrts;
-    double T = c + d / sqrts;
-    double p0 = n * T;
-    double result = pow((1. + mt / p0), -n);
-    return result;
+    const double mt = std::sqrt(mass * mass + pt * pt);
+    const double mtNorm = std::sqrt(mass * mass + 1.);
+    const double n = a + b / sqrts;
+    const double T = c + d / sqrts;
+    const double p0 = n * T;
+    return std::pow((p0 + mt) / (p0 + mtNorm), -n);
   };
 
   /// Random downsampling trigger function using Tsalis/Hagedorn spectra fit (sqrt(s) = 62.4 GeV to 13 TeV)
@@ -299,13 +300,12 @@ struct TreeWriterTPCTOF {
     if (factor1Pt < 0.) {
       return true;
     }
-    const double prob = tsalisCharged(pt, mass, sqrts) * pt;
-    const double probNorm = tsalisCharged(1., mass, sqrts);
-    if ((fRndm->Rndm() * ((prob / probNorm) * pt * pt)) > factor1Pt) {
-      return false;
-    } else {
+    const double weight = tsalisChargedOverNorm(pt, mass, sqrts) * pt * pt * pt;
+    // a track with weight below the factor is always kept, no random number is needed
+    if (weight <= factor1Pt) {
       return true;
     }
+    return fRndm->Rndm() * weight <= factor1Pt;
   };
 
   /// Function to fill trees
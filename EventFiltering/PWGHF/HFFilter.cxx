@@ -170,6 +170,7 @@ struct HfFilter { // Main struct for HF triggers
 
   // helper object
   HfFilterHelper helper;
+  std::vector<HfTrackInfo> trackInfos{}; // per-track quantities of the current collision, shared by the triggers
 
   void init(InitContext&)
   {
@@ -287,6 +288,82 @@ struct HfFilter { // Main struct for HF triggers
   using BigTracksPID = soa::Join<aod::Tracks, aod::TracksExtra, aod::TracksDCA, aod::TrackSelection, aod::pidTPCFullPi, aod::pidTOFFullPi, aod::pidTPCFullKa, aod::pidTOFFullKa, aod::pidTPCFullPr, aod::pidTOFFullPr>;
   using CollsWithEvSel = soa::Join<aod::Collisions, aod::EvSels>;
 
+  // preselected candidates of a collision, whose ML scores are computed for all of them at once before applying the triggers
+  struct Charm2ProngInfo {
+    BigTracksPID::iterator trackPos;
+    BigTracksPID::iterator trackNeg;
+    std::array<float, 3> pVecPos;
+    std::array<float, 3> pVecNeg;
+    int8_t presel;
+    std::array<float, 6> features; // ML input features
+    int tagBDT;
+    std::array<float, 3> scores;
+  };
+  struct Charm3ProngInfo {
+    BigTracksPID::iterator trackFirst;
+    BigTracksPID::iterator trackSecond;
+    BigTracksPID::iterator trackThird;
+    std::array<float, 3> pVecFirst;
+    std::array<float, 3> pVecSecond;
+    std::array<float, 3> pVecThird;
+    std::array<int8_t, kNCharmParticles - 1> is3Prong;
+    std::array<float, 9> features; // ML input features
+    std::array<int, kNCharmParticles - 1> tagBDT;
+    std::array<std::array<float, 3>, kNCharmParticles - 1> scores;
+  };
+  std::vector<Charm2ProngInfo> cand2ProngInfos;
+  std::vector<Charm3ProngInfo> cand3ProngInfos;
+  std::vector<int> candIndicesML;             // candidates evaluated by a model
+  std::vector<float> inputFeaturesML;         // input features of the candidates evaluated by a model
+  std::vector<double> inputFeaturesDoubleML;  // same for the models with double inputs
+  std::vector<std::array<float, 3>> scoresML; // output scores of the candidates evaluated by a model
+  std::vector<std::array<double, 3>> scoresDoubleML;
+
+  /// Computes the ML scores and the BDT tags of the selected candidates with one inference per model
+  /// \param infos candidates of the collision
+  /// \param iModel index of the model
+  /// \param isSelected function telling whether a candidate is evaluated by the model
+  /// \param setResult function storing the BDT tag and the scores of a candidate
+  template <typename TInfo, typename TSel, typename TRes>
+  void applyMLBatch(std::vector<TInfo>& infos, int iModel, TSel isSelected, TRes setResult)
+  {
+    candIndicesML.clear();
+    inputFeaturesML.clear();
+    inputFeaturesDoubleML.clear();
+    for (std::size_t iCand{0}; iCand < infos.size(); ++iCand) {
+      if (!isSelected(infos[iCand])) {
+        continue;
+      }
+      candIndicesML.push_back(iCand);
+      const auto& features = infos[iCand].features;
+      if (dataTypeML[iModel] == 11) {
+        inputFeaturesDoubleML.insert(inputFeaturesDoubleML.end(), features.begin(), features.end());
+      } else {
+        inputFeaturesML.insert(inputFeaturesML.end(), features.begin(), features.end());
+      }
+    }
+    if (candIndicesML.empty()) {
+      return;
+    }
+    if (dataTypeML[iModel] == 1) {
+      helper.predictONNXBatch(inputFeaturesML, candIndicesML.size(), sessionML[iModel], inputShapesML[iModel], scoresML);
+      for (std::size_t iCandML{0}; iCandML < candIndicesML.size(); ++iCandML) {
+        const auto& scores = scoresML[iCandML];
+        setResult(infos[candIndicesML[iCandML]], helper.isBDTSelected(scores, thresholdBDTScores[iModel]), std::array<float, 3>{scores[0], scores[1], scores[2]});
+      }
+    } else if (dataTypeML[iModel] == 11) {
+      helper.predictONNXBatch(inputFeaturesDoubleML, candIndicesML.size(), sessionML[iModel], inputShapesML[iModel], scoresDoubleML);
+      for (std::size_t iCandML{0}; iCandML < candIndicesML.size(); ++iCandML) {
+        const auto& scores = scoresDoubleML[iCandML];
+        setResult(infos[candIndicesML[iCandML]], helper.isBDTSelected(scores, thresholdBDTScores[iModel]), std::array<float, 3>{static_cast<float>(scores[0]), static_cast<float>(scores[1]), static_cast<float>(scores[2])});
+      }
+    } else if (iModel == kD0) {
+      LOG(fatal) << "Error running model inference for D0: Unexpected input data type.";
+    } else {
+      LOG(error) << "Error running model inference for " << charmParticleNames[iModel].data() << ": Unexpected input data type.";
+    }
+  }
+
   Preslice<aod::TrackAssoc> trackIndicesPerCollision = aod::track_association::collisionId;
   Preslice<aod::V0Datas> v0sPerCollision = aod::v0data::collisionId;
   Preslice<aod::Hf2Prongs> hf2ProngPerCollision = aod::track_association::collisionId;
@@ -349,7 +426,16 @@ struct HfFilter { // Main struct for HF triggers
       std::vector<std::vector<int64_t>> indicesDau2Prong{};
 
       auto cand2ProngsThisColl = cand2Prongs.sliceBy(hf2ProngPerCollision, thisCollId);
-      for (const auto& cand2Prong : cand2ProngsThisColl) {                                // start loop over 2 prongs
+      auto cand3ProngsThisColl = cand3Prongs.sliceBy(hf3ProngPerCollision, thisCollId);
+
+      // per-track quantities and selections, computed once and shared by all the triggers with charm candidates
+      auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
+      if (cand2ProngsThisColl.size() > 0 || cand3ProngsThisColl.size() > 0) {
+        helper.fillTrackInfos<BigTracksPID>(trackInfos, trackIdsThisCollision, collision, activateQA, hProtonTPCPID, hProtonTOFPID);
+      }
+      // first pass over the 2 prongs: preselections, kinematics and ML input features
+      cand2ProngInfos.clear();
+      for (const auto& cand2Prong : cand2ProngsThisColl) {
         if (!TESTBIT(cand2Prong.hfflag(), o2::aod::hf_cand_2prong::DecayType::D0ToPiK)) { // check if it's a D0
           continue;
         }
@@ -377,6 +463,27 @@ struct HfFilter { // Main struct for HF triggers
           getPxPyPz(trackParNeg, pVecNeg);
         }
 
+        // TODO: add more feature configurations
+        cand2ProngInfos.push_back({trackPos, trackNeg, pVecPos, pVecNeg, preselD0, {trackParPos.getPt(), dcaPos[0], dcaPos[1], trackParNeg.getPt(), dcaNeg[0], dcaNeg[1]}, 0, {-1., -1., -1.}});
+      }
+
+      // apply ML models, with one inference for all the candidates of the collision
+      if (applyML && onnxFiles[kD0] != "") {
+        applyMLBatch(
+          cand2ProngInfos, kD0, [](const Charm2ProngInfo&) { return true; },
+          [](Charm2ProngInfo& info, int tagBDT, const std::array<float, 3>& scores) {
+            info.tagBDT = tagBDT;
+            info.scores = scores;
+          });
+      }
+
+      for (auto& cand2ProngInfo : cand2ProngInfos) { // start loop over 2 prongs
+        auto& trackPos = cand2ProngInfo.trackPos;
+        auto& trackNeg = cand2ProngInfo.trackNeg;
+        auto& pVecPos = cand2ProngInfo.pVecPos;
+        auto& pVecNeg = cand2ProngInfo.pVecNeg;
+        auto preselD0 = cand2ProngInfo.presel;
+
         bool isSignalTagged{true}, isCharmTagged{true}, isBeautyTagged{true};
 
         // apply ML models
@@ -387,24 +494,9 @@ struct HfFilter { // Main struct for HF triggers
           isCharmTagged = false;
           isBeautyTagged = false;
 
-          // TODO: add more feature configurations
-          std::vector<float> inputFeaturesD0{trackParPos.getPt(), dcaPos[0], dcaPos[1], trackParNeg.getPt(), dcaNeg[0], dcaNeg[1]};
-          std::vector<double> inputFeaturesDoD0{trackParPos.getPt(), dcaPos[0], dcaPos[1], trackParNeg.getPt(), dcaNeg[0], dcaNeg[1]};
-
-          if (dataTypeML[kD0] == 1) {
-            auto scores = helper.predictONNX(inputFeaturesD0, sessionML[kD0], inputShapesML[kD0]);
-            tagBDT = helper.isBDTSelected(scores, thresholdBDTScores[kD0]);
-            for (int iScore{0}; iScore < 3; ++iScore) {
-              scoresToFill[iScore] = scores[iScore];
-            }
-          } else if (dataTypeML[kD0] == 11) {
-            auto scores = helper.predictONNX(inputFeaturesDoD0, sessionML[kD0], inputShapesML[kD0]);
-            tagBDT = helper.isBDTSelected(scores, thresholdBDTScores[kD0]);
-            for (int iScore{0}; iScore < 3; ++iScore) {
-              scoresToFill[iScore] = scores[iScore];
-            }
-          } else {
-            LOG(fatal) << "Error running model inference for D0: Unexpected input data type.";
+          tagBDT = cand2ProngInfo.tagBDT;
+          for (int iScore{0}; iScore < 3; ++iScore) {
+            scoresToFill[iScore] = cand2ProngInfo.scores[iScore];
           }
 
           if (applyML && activateQA > 1) {
@@ -446,24 +538,20 @@ struct HfFilter { // Main struct for HF triggers
         auto massD0Cand = RecoDecay::m(std::array{pVecPos, pVecNeg}, std::array{massPi, massKa});
         auto massD0BarCand = RecoDecay::m(std::array{pVecPos, pVecNeg}, std::array{massKa, massPi});
 
-        auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
+        std::size_t iTrackThird = 0;
         for (const auto& trackId : trackIdsThisCollision) { // start loop over tracks
+          const auto& trackInfoThird = trackInfos[iTrackThird++];
           auto track = trackId.track_as<BigTracksPID>();
 
           if (track.globalIndex() == trackPos.globalIndex() || track.globalIndex() == trackNeg.globalIndex()) {
             continue;
           }
 
-          auto trackParThird = getTrackPar(track);
-          o2::gpu::gpustd::array<float, 2> dcaThird{track.dcaXY(), track.dcaZ()};
-          std::array<float, 3> pVecThird = {track.px(), track.py(), track.pz()};
-          if (track.collisionId() != thisCollId) {
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParThird, 2.f, noMatCorr, &dcaThird);
-            getPxPyPz(trackParThird, pVecThird);
-          }
+          const auto& dcaThird = trackInfoThird.dca;
+          const auto& pVecThird = trackInfoThird.pVec;
 
           if (!keepEvent[kBeauty3P] && isBeautyTagged) {
-            auto isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty(track, trackParThird, dcaThird, kBeauty3P);
+            auto isTrackSelected = trackInfoThird.selBeauty3P;
             if (isTrackSelected && ((TESTBIT(selD0, 0) && track.sign() < 0) || (TESTBIT(selD0, 1) && track.sign() > 0))) {
               auto massCand = RecoDecay::m(std::array{pVec2Prong, pVecThird}, std::array{massD0, massPi});
               auto pVecBeauty3Prong = RecoDecay::pVec(pVec2Prong, pVecThird);
@@ -492,20 +580,17 @@ struct HfFilter { // Main struct for HF triggers
                   if (activateQA) {
                     hMassVsPtC[kNCharmParticles]->Fill(ptCand, massDiffDstar);
                   }
+                  std::size_t iTrackFourth = 0;
                   for (const auto& trackIdB : trackIdsThisCollision) { // start loop over tracks
+                    const auto& trackInfoFourth = trackInfos[iTrackFourth++];
                     auto trackB = trackIdB.track_as<BigTracksPID>();
                     if (track.globalIndex() == trackB.globalIndex()) {
                       continue;
                     }
-                    auto trackParFourth = getTrackPar(trackB);
-                    o2::gpu::gpustd::array<float, 2> dcaFourth{trackB.dcaXY(), trackB.dcaZ()};
-                    std::array<float, 3> pVecFourth = {trackB.px(), trackB.py(), trackB.pz()};
-                    if (trackB.collisionId() != thisCollId) {
-                      o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParFourth, 2.f, noMatCorr, &dcaFourth);
-                      getPxPyPz(trackParFourth, pVecFourth);
-                    }
+                    const auto& dcaFourth = trackInfoFourth.dca;
+                    const auto& pVecFourth = trackInfoFourth.pVec;
 
-                    auto isTrackFourthSelected = helper.isSelectedTrackForSoftPionOrBeauty(trackB, trackParFourth, dcaFourth, kBeauty3P);
+                    auto isTrackFourthSelected = trackInfoFourth.selBeauty3P;
                     if (track.sign() * trackB.sign() < 0 && TESTBIT(isTrackFourthSelected, kForBeauty)) {
                       auto massCandB0 = RecoDecay::m(std::array{pVecBeauty3Prong, pVecFourth}, std::array{massDStar, massPi});
                       if (std::fabs(massCandB0 - massB0) <= deltaMassBeauty->get(0u, 2u)) {
@@ -529,7 +614,7 @@ struct HfFilter { // Main struct for HF triggers
 
           // 2-prong femto
           if (!keepEvent[kFemto2P] && enableFemtoChannels->get(0u, 0u) && isCharmTagged && track.collisionId() == thisCollId && (TESTBIT(selD0, 0) || TESTBIT(selD0, 1) || !requireCharmMassForFemto)) {
-            bool isProton = helper.isSelectedProton4Femto(track, trackParThird, activateQA, hProtonTPCPID, hProtonTOFPID);
+            bool isProton = trackInfoThird.isProtonForFemto;
             if (isProton) {
               float relativeMomentum = helper.computeRelativeMomentum(pVecThird, pVec2Prong, massD0);
               if (applyOptimisation) {
@@ -592,21 +677,17 @@ struct HfFilter { // Main struct for HF triggers
               if (!keepEvent[kV0Charm2P] && TESTBIT(selV0, kK0S)) {
 
                 // we first look for a D*+
+                std::size_t iTrackBachelor = 0;
                 for (const auto& trackBachelorId : trackIdsThisCollision) { // start loop over tracks
+                  const auto& trackInfoBachelor = trackInfos[iTrackBachelor++];
                   auto trackBachelor = trackBachelorId.track_as<BigTracksPID>();
                   if (trackBachelor.globalIndex() == trackPos.globalIndex() || trackBachelor.globalIndex() == trackNeg.globalIndex()) {
                     continue;
                   }
 
-                  auto trackParBachelor = getTrackPar(trackBachelor);
-                  o2::gpu::gpustd::array<float, 2> dcaBachelor{trackBachelor.dcaXY(), trackBachelor.dcaZ()};
-                  std::array<float, 3> pVecBachelor = {trackBachelor.px(), trackBachelor.py(), trackBachelor.pz()};
-                  if (trackBachelor.collisionId() != thisCollId) {
-                    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParBachelor, 2.f, noMatCorr, &dcaBachelor);
-                    getPxPyPz(trackParBachelor, pVecBachelor);
-                  }
+                  const auto& pVecBachelor = trackInfoBachelor.pVec;
 
-                  int isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty(trackBachelor, trackParBachelor, dcaBachelor, -1);
+                  int isTrackSelected = trackInfoBachelor.selBeauty3P; // only the kSoftPion bit is used
                   if (TESTBIT(isTrackSelected, kSoftPion) && ((TESTBIT(selD0, 0) && trackBachelor.sign() < 0) || (TESTBIT(selD0, 1) && trackBachelor.sign() > 0))) {
                     std::array<float, 2> massDausD0{massPi, massKa};
                     auto massD0dau = massD0Cand;
@@ -644,8 +725,9 @@ struct HfFilter { // Main struct for HF triggers
       } // end loop over 2-prong candidates
 
       std::vector<std::vector<int64_t>> indicesDau3Prong{};
-      auto cand3ProngsThisColl = cand3Prongs.sliceBy(hf3ProngPerCollision, thisCollId);
-      for (const auto& cand3Prong : cand3ProngsThisColl) { // start loop over 3 prongs
+      // first pass over the 3 prongs: preselections, kinematics and ML input features
+      cand3ProngInfos.clear();
+      for (const auto& cand3Prong : cand3ProngsThisColl) {
         std::array<int8_t, kNCharmParticles - 1> is3Prong = {
           TESTBIT(cand3Prong.hfflag(), o2::aod::hf_cand_3prong::DecayType::DplusToPiKPi),
           TESTBIT(cand3Prong.hfflag(), o2::aod::hf_cand_3prong::DecayType::DsToKKPi),
@@ -697,6 +779,39 @@ struct HfFilter { // Main struct for HF triggers
           }
         }
 
+        // TODO: add more feature configurations
+        cand3ProngInfos.push_back({trackFirst, trackSecond, trackThird, pVecFirst, pVecSecond, pVecThird, is3Prong,
+                                   {trackParFirst.getPt(), dcaFirst[0], dcaFirst[1], trackParSecond.getPt(), dcaSecond[0], dcaSecond[1], trackParThird.getPt(), dcaThird[0], dcaThird[1]},
+                                   {}, {}});
+        for (auto& scores : cand3ProngInfos.back().scores) {
+          scores = {-1., -1., -1.};
+        }
+      }
+
+      // apply ML models, with one inference per model for all the candidates of the collision
+      if (applyML) {
+        for (auto iCharmPart{0}; iCharmPart < kNCharmParticles - 1; ++iCharmPart) {
+          if (onnxFiles[iCharmPart + 1] == "") {
+            continue;
+          }
+          applyMLBatch(
+            cand3ProngInfos, iCharmPart + 1, [iCharmPart](const Charm3ProngInfo& info) { return info.is3Prong[iCharmPart] != 0; },
+            [iCharmPart](Charm3ProngInfo& info, int tagBDT, const std::array<float, 3>& scores) {
+              info.tagBDT[iCharmPart] = tagBDT;
+              info.scores[iCharmPart] = scores;
+            });
+        }
+      }
+
+      for (auto& cand3ProngInfo : cand3ProngInfos) { // start loop over 3 prongs
+        auto& trackFirst = cand3ProngInfo.trackFirst;
+        auto& trackSecond = cand3ProngInfo.trackSecond;
+        auto& trackThird = cand3ProngInfo.trackThird;
+        auto& pVecFirst = cand3ProngInfo.pVecFirst;
+        auto& pVecSecond = cand3ProngInfo.pVecSecond;
+        auto& pVecThird = cand3ProngInfo.pVecThird;
+        auto& is3Prong = cand3ProngInfo.is3Prong;
+
         std::array<int8_t, kNCharmParticles - 1> isSignalTagged = is3Prong;
         std::array<int8_t, kNCharmParticles - 1> isCharmTagged = is3Prong;
         std::array<int8_t, kNCharmParticles - 1> isBeautyTagged = is3Prong;
@@ -711,29 +826,14 @@ struct HfFilter { // Main struct for HF triggers
           isCharmTagged = std::array<int8_t, kNCharmParticles - 1>{0};
           isBeautyTagged = std::array<int8_t, kNCharmParticles - 1>{0};
 
-          // TODO: add more feature configurations
-          std::vector<float> inputFeatures{trackParFirst.getPt(), dcaFirst[0], dcaFirst[1], trackParSecond.getPt(), dcaSecond[0], dcaSecond[1], trackParThird.getPt(), dcaThird[0], dcaThird[1]};
-          std::vector<double> inputFeaturesD{trackParFirst.getPt(), dcaFirst[0], dcaFirst[1], trackParSecond.getPt(), dcaSecond[0], dcaSecond[1], trackParThird.getPt(), dcaThird[0], dcaThird[1]};
           for (auto iCharmPart{0}; iCharmPart < kNCharmParticles - 1; ++iCharmPart) {
             if (!is3Prong[iCharmPart] || onnxFiles[iCharmPart + 1] == "") {
               continue;
             }
 
-            int tagBDT = 0;
-            if (dataTypeML[iCharmPart + 1] == 1) {
-              auto scores = helper.predictONNX(inputFeatures, sessionML[iCharmPart + 1], inputShapesML[iCharmPart + 1]);
-              tagBDT = helper.isBDTSelected(scores, thresholdBDTScores[iCharmPart + 1]);
-              for (int iScore{0}; iScore < 3; ++iScore) {
-                scoresToFill[iCharmPart][iScore] = scores[iScore];
-              }
-            } else if (dataTypeML[iCharmPart + 1] == 11) {
-              auto scores = helper.predictONNX(inputFeaturesD, sessionML[iCharmPart + 1], inputShapesML[iCharmPart + 1]);
-              tagBDT = helper.isBDTSelected(scores, thresholdBDTScores[iCharmPart + 1]);
-              for (int iScore{0}; iScore < 3; ++iScore) {
-                scoresToFill[iCharmPart][iScore] = scores[iScore];
-              }
-            } else {
-              LOG(error) << "Error running model inference for " << charmParticleNames[iCharmPart + 1].data() << ": Unexpected input data type.";
+            int tagBDT = cand3ProngInfo.tagBDT[iCharmPart];
+            for (int iScore{0}; iScore < 3; ++iScore) {
+              scoresToFill[iCharmPart][iScore] = cand3ProngInfo.scores[iCharmPart][iScore];
             }
 
             isCharmTagged[iCharmPart] = TESTBIT(tagBDT, RecoDecay::OriginType::Prompt);
@@ -761,26 +861,28 @@ struct HfFilter { // Main struct for HF triggers
         float sign3Prong = -1 * trackFirst.sign() * trackSecond.sign() * trackThird.sign();
 
         std::array<int8_t, kNCharmParticles - 1> is3ProngInMass{0};
+        std::array<double, kNInvMasses3Prong> invMasses3Prong{};
+        helper.computeInvMasses3Prong(pVecFirst, pVecThird, pVecSecond, invMasses3Prong); // all the mass hypotheses at once
         if (is3Prong[0]) {
-          is3ProngInMass[0] = helper.isSelectedDplusInMassRange(pVecFirst, pVecThird, pVecSecond, pt3Prong, activateQA, hMassVsPtC[kDplus]);
+          is3ProngInMass[0] = helper.isSelectedDplusInMassRange(invMasses3Prong, pt3Prong, activateQA, hMassVsPtC[kDplus]);
           if (applyOptimisation) {
             optimisationTreeCharm(thisCollId, o2::constants::physics::Pdg::kDPlus, pt3Prong, scoresToFill[0][0], scoresToFill[0][1], scoresToFill[0][2]);
           }
         }
         if (is3Prong[1]) {
-          is3ProngInMass[1] = helper.isSelectedDsInMassRange(pVecFirst, pVecThird, pVecSecond, pt3Prong, is3Prong[1], activateQA, hMassVsPtC[kDs]);
+          is3ProngInMass[1] = helper.isSelectedDsInMassRange(invMasses3Prong, pt3Prong, is3Prong[1], activateQA, hMassVsPtC[kDs]);
           if (applyOptimisation) {
             optimisationTreeCharm(thisCollId, o2::constants::physics::Pdg::kDS, pt3Prong, scoresToFill[1][0], scoresToFill[1][1], scoresToFill[1][2]);
           }
         }
         if (is3Prong[2]) {
-          is3ProngInMass[2] = helper.isSelectedLcInMassRange(pVecFirst, pVecThird, pVecSecond, pt3Prong, is3Prong[2], activateQA, hMassVsPtC[kLc]);
+          is3ProngInMass[2] = helper.isSelectedLcInMassRange(invMasses3Prong, pt3Prong, is3Prong[2], activateQA, hMassVsPtC[kLc]);
           if (applyOptimisation) {
             optimisationTreeCharm(thisCollId, o2::constants::physics::Pdg::kLambdaCPlus, pt3Prong, scoresToFill[2][0], scoresToFill[2][1], scoresToFill[2][2]);
           }
         }
         if (is3Prong[3]) {
-          is3ProngInMass[3] = helper.isSelectedXicInMassRange(pVecFirst, pVecThird, pVecSecond, pt3Prong, is3Prong[3], activateQA, hMassVsPtC[kXic]);
+          is3ProngInMass[3] = helper.isSelectedXicInMassRange(invMasses3Prong, pt3Prong, is3Prong[3], activateQA, hMassVsPtC[kXic]);
           if (applyOptimisation) {
             optimisationTreeCharm(thisCollId, o2::constants::physics::Pdg::kXiCPlus, pt3Prong, scoresToFill[3][0], scoresToFill[3][1], scoresToFill[3][2]);
           }
@@ -797,28 +899,23 @@ struct HfFilter { // Main struct for HF triggers
           }
         } // end high-pT selection
 
-        auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
-
+        std::size_t iTrackFourth = 0;
         for (const auto& trackId : trackIdsThisCollision) { // start loop over track indices as associated to this collision in HF code
+          const auto& trackInfoFourth = trackInfos[iTrackFourth++];
           auto track = trackId.track_as<BigTracksPID>();
           if (track.globalIndex() == trackFirst.globalIndex() || track.globalIndex() == trackSecond.globalIndex() || track.globalIndex() == trackThird.globalIndex()) {
             continue;
           }
 
-          auto trackParFourth = getTrackPar(track);
-          o2::gpu::gpustd::array<float, 2> dcaFourth{track.dcaXY(), track.dcaZ()};
-          std::array<float, 3> pVecFourth = {track.px(), track.py(), track.pz()};
-          if (track.collisionId() != thisCollId) {
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParFourth, 2.f, noMatCorr, &dcaFourth);
-            getPxPyPz(trackParFourth, pVecFourth);
-          }
+          const auto& dcaFourth = trackInfoFourth.dca;
+          const auto& pVecFourth = trackInfoFourth.pVec;
 
           int charmParticleID[kNBeautyParticles - 2] = {o2::constants::physics::Pdg::kDPlus, o2::constants::physics::Pdg::kDS, o2::constants::physics::Pdg::kLambdaCPlus, o2::constants::physics::Pdg::kXiCPlus};
 
           float massCharmHypos[kNBeautyParticles - 2] = {massDPlus, massDs, massLc, massXic};
           float massBeautyHypos[kNBeautyParticles - 2] = {massB0, massBs, massLb, massXib};
           float deltaMassHypos[kNBeautyParticles - 2] = {deltaMassBeauty->get(0u, 1u), deltaMassBeauty->get(0u, 3u), deltaMassBeauty->get(0u, 4u), deltaMassBeauty->get(0u, 5u)};
-          auto isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty(track, trackParFourth, dcaFourth, kBeauty4P);
+          auto isTrackSelected = trackInfoFourth.selBeauty4P;
           if (track.sign() * sign3Prong < 0 && TESTBIT(isTrackSelected, kForBeauty)) {
             for (int iHypo{0}; iHypo < kNBeautyParticles - 2 && !keepEvent[kBeauty4P]; ++iHypo) {
               if (isBeautyTagged[iHypo] && (TESTBIT(is3ProngInMass[iHypo], 0) || TESTBIT(is3ProngInMass[iHypo], 1))) {
@@ -839,7 +936,7 @@ struct HfFilter { // Main struct for HF triggers
           } // end beauty selection
 
           // 3-prong femto
-          bool isProton = helper.isSelectedProton4Femto(track, trackParFourth, activateQA, hProtonTPCPID, hProtonTOFPID);
+          bool isProton = trackInfoFourth.isProtonForFemto;
           if (isProton && track.collisionId() == thisCollId) {
             for (int iHypo{0}; iHypo < kNCharmParticles - 1 && !keepEvent[kFemto3P]; ++iHypo) {
               if (isCharmTagged[iHypo] && enableFemtoChannels->get(0u, iHypo + 1) && (TESTBIT(is3ProngInMass[iHypo], 0) || TESTBIT(is3ProngInMass[iHypo], 1) || !requireCharmMassForFemto)) {
@@ -955,7 +1052,6 @@ struct HfFilter { // Main struct for HF triggers
             hMassXi->Fill(casc.mXi());
           }
 
-          auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
           for (const auto& trackId : trackIdsThisCollision) { // start loop over tracks
             auto track = trackId.track_as<BigTracksPID>();
 
@@ -39,6 +39,7 @@
 #include "CommonConstants/MathConstants.h"
 #include "CommonConstants/PhysicsConstants.h"
 #include "DataFormatsTPC/BetheBlochAleph.h"
+#include "DetectorsBase/Propagator.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/DataTypes.h"
@@ -119,6 +120,15 @@ enum V0Species {
   kNV0
 };
 
+enum invMasses3Prong {
+  kInvMassDplusToPiKPi = 0,
+  kInvMassToKKPi,
+  kInvMassToPiKK,
+  kInvMassToPKPi,
+  kInvMassToPiKP,
+  kNInvMasses3Prong
+};
+
 static const std::array<std::string, kNCharmParticles> charmParticleNames{"D0", "Dplus", "Ds", "Lc", "Xic"};
 static const std::array<std::string, kNBeautyParticles> beautyParticleNames{"Bplus", "B0toDStar", "B0", "Bs", "Lb", "Xib"};
 static const std::array<int, kNCharmParticles> pdgCodesCharm{421, 411, 431, 4122, 4232};
@@ -214,6 +224,16 @@ static const std::vector<std::string> labelsEmpty{};
 static constexpr double cutsTrackDummy[o2::analysis::hf_cuts_single_track::nBinsPtTrack][o2::analysis::hf_cuts_single_track::nCutVarsTrack] = {{0., 10.}, {0., 10.}, {0., 10.}, {0., 10.}, {0., 10.}, {0., 10.}};
 o2::framework::LabeledArray<double> cutsSingleTrackDummy{cutsTrackDummy[0], o2::analysis::hf_cuts_single_track::nBinsPtTrack, o2::analysis::hf_cuts_single_track::nCutVarsTrack, o2::analysis::hf_cuts_single_track::labelsPtTrack, o2::analysis::hf_cuts_single_track::labelsCutVarTrack};
 
+// Per-track quantities shared by the triggers, computed once per collision (see HfFilterHelper::fillTrackInfos)
+struct HfTrackInfo {
+  o2::track::TrackPar trackPar{};         // track parameters, propagated to the collision for tracks associated from another collision
+  o2::gpu::gpustd::array<float, 2> dca{}; // dcaXY and dcaZ with respect to the collision
+  std::array<float, 3> pVec{};            // momentum at the point of closest approach to the collision
+  int8_t selBeauty3P{0};                  // isSelectedTrackForSoftPionOrBeauty for kBeauty3P (the kSoftPion bit does not depend on the trigger)
+  int8_t selBeauty4P{0};                  // isSelectedTrackForSoftPionOrBeauty for kBeauty4P
+  bool isProtonForFemto{false};           // isSelectedProton4Femto
+};
+
 // Main helper class
 
 class HfFilterHelper
@@ -297,6 +317,8 @@ class HfFilterHelper
   void setTpcPidCalibrationOption(int opt) { mTpcPidCalibrationOption = opt; }
 
   // helper functions for selections
+  template <typename TTracks, typename TTrackIds, typename Coll, typename H2>
+  void fillTrackInfos(std::vector<HfTrackInfo>& trackInfos, const TTrackIds& trackIds, const Coll& collision, const int& activateQA, H2 hProtonTPCPID, H2 hProtonTOFPID);
   template <typename T, typename T1, typename T2>
   int8_t isSelectedTrackForSoftPionOrBeauty(const T track, const T1& trackPar, const T2& dca, const int& whichTrigger);
   template <typename T1, typename T2, typename H2>
@@ -311,14 +333,16 @@ class HfFilterHelper
   int8_t isCharmBaryonPreselected(const T& trackSameChargeFirst, const T& trackSameChargeSecond, const T& trackOppositeCharge);
   template <typename T, typename H2>
   int8_t isSelectedD0InMassRange(const T& pTrackPos, const T& pTrackNeg, const float& ptD, int8_t isSelected, const int& activateQA, H2 hMassVsPt);
-  template <typename T, typename H2>
-  int8_t isSelectedDplusInMassRange(const T& pTrackSameChargeFirst, const T& pTrackSameChargeSecond, const T& pTrackOppositeCharge, const float& ptD, const int& activateQA, H2 hMassVsPt);
-  template <typename T, typename H2>
-  int8_t isSelectedDsInMassRange(const T& pTrackSameChargeFirst, const T& pTrackSameChargeSecond, const T& pTrackOppositeCharge, const float& ptD, int8_t isSelected, const int& activateQA, H2 hMassVsPt);
-  template <typename T, typename H2>
-  int8_t isSelectedLcInMassRange(const T& pTrackSameChargeFirst, const T& pTrackSameChargeSecond, const T& pTrackOppositeCharge, const float& ptLc, const int8_t isSelected, const int& activateQA, H2 hMassVsPt);
-  template <typename T, typename H2>
-  int8_t isSelectedXicInMassRange(const T& pTrackSameChargeFirst, const T& pTrackSameChargeSecond, const T& pTrackOppositeCharge, const float& ptXic, const int8_t isSelected, const int& activateQA, H2 hMassVsPt);
+  template <typename T>
+  void computeInvMasses3Prong(const T& pTrackSameChargeFirst, const T& pTrackSameChargeSecond, const T& pTrackOppositeCharge, std::array<double, kNInvMasses3Prong>& invMasses);
+  template <typename H2>
+  int8_t isSelectedDplusInMassRange(const std::array<double, kNInvMasses3Prong>& invMasses, const float& ptD, const int& activateQA, H2 hMassVsPt);
+  template <typename H2>
+  int8_t isSelectedDsInMassRange(const std::array<double, kNInvMasses3Prong>& invMasses, const float& ptD, int8_t isSelected, const int& activateQA, H2 hMassVsPt);
+  template <typename H2>
+  int8_t isSelectedLcInMassRange(const std::array<double, kNInvMasses3Prong>& invMasses, const float& ptLc, const int8_t isSelected, const int& activateQA, H2 hMassVsPt);
+  template <typename H2>
+  int8_t isSelectedXicInMassRange(const std::array<double, kNInvMasses3Prong>& invMasses, const float& ptXic, const int8_t isSelected, const int& activateQA, H2 hMassVsPt);
   template <typename V0, typename Coll, typename T, typename H2>
   int8_t isSelectedV0(const V0& v0, const std::array<T, 2>& dauTracks, const Coll& collision, const int& activateQA, H2 hV0Selected, std::array<H2, 4>& hArmPod);
   template <typename Casc, typename T, typename Coll>
@@ -342,6 +366,8 @@ class HfFilterHelper
   Ort::Experimental::Session* initONNXSession(std::string& onnxFile, std::string partName, Ort::Env& env, Ort::SessionOptions& sessionOpt, std::vector<std::vector<int64_t>>& inputShapes, int& dataType, bool loadModelsFromCCDB, o2::ccdb::CcdbApi& ccdbApi, std::string mlModelPathCCDB, int64_t timestampCCDB);
   template <typename T>
   std::array<T, 3> predictONNX(std::vector<T>& inputFeatures, std::shared_ptr<Ort::Experimental::Session>& session, std::vector<std::vector<int64_t>>& inputShapes);
+  template <typename T>
+  void predictONNXBatch(std::vector<T>& inputFeatures, int64_t nCandidates, std::shared_ptr<Ort::Experimental::Session>& session, std::vector<std::vector<int64_t>>& inputShapes, std::vector<std::array<T, 3>>& scores);
 
  private:
   // selections
@@ -404,6 +430,34 @@ class HfFilterHelper
   std::array<std::vector<double>, 6> mBetheBlochPiKaPr{}; // Bethe-Bloch parametrisations for pions, antipions, kaons, antikaons, protons, antiprotons in TPC
 };
 
+/// Per-track quantities and selections shared by the triggers, computed in one pass over the tracks of a collision
+/// \param trackInfos is the vector to be filled, with one entry per track index in trackIds (same order)
+/// \param trackIds are the track indices associated to the collision
+/// \param collision is the collision
+/// \param activateQA flag to activate the filling of QA histos
+/// \param hProtonTPCPID histo with NsigmaTPC vs. p
+/// \param hProtonTOFPID histo with NsigmaTOF vs. p
+template <typename TTracks, typename TTrackIds, typename Coll, typename H2>
+inline void HfFilterHelper::fillTrackInfos(std::vector<HfTrackInfo>& trackInfos, const TTrackIds& trackIds, const Coll& collision, const int& activateQA, H2 hProtonTPCPID, H2 hProtonTOFPID)
+{
+  trackInfos.clear();
+  trackInfos.reserve(trackIds.size());
+  for (const auto& trackId : trackIds) {
+    auto track = trackId.template track_as<TTracks>();
+    auto& trackInfo = trackInfos.emplace_back();
+    trackInfo.trackPar = getTrackPar(track);
+    trackInfo.dca = {track.dcaXY(), track.dcaZ()};
+    trackInfo.pVec = {track.px(), track.py(), track.pz()};
+    if (track.collisionId() != collision.globalIndex()) {
+      o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackInfo.trackPar, 2.f, o2::base::Propagator::MatCorrType::USEMatCorrNONE, &trackInfo.dca);
+      getPxPyPz(trackInfo.trackPar, trackInfo.pVec);
+    }
+    trackInfo.selBeauty3P = isSelectedTrackForSoftPionOrBeauty(track, trackInfo.trackPar, trackInfo.dca, kBeauty3P);
+    trackInfo.selBeauty4P = isSelectedTrackForSoftPionOrBeauty(track, trackInfo.trackPar, trackInfo.dca, kBeauty4P);
+    trackInfo.isProtonForFemto = isSelectedProton4Femto(track, trackInfo.trackPar, activateQA, hProtonTPCPID, hProtonTOFPID);
+  }
+}
+
 /// Single-track cuts for bachelor track of beauty candidates
 /// \param track is a track parameter
 /// \param trackPar is a track parameter
@@ -672,18 +726,51 @@ inline int8_t HfFilterHelper::isSelectedD0InMassRange(const T& pTrackPos, const
   return retValue;
 }
 
-/// Mass selection of D+ candidates to build B0 candidates
+/// Computation of the invariant masses of all the 3-prong charm-hadron hypotheses at once
+/// The energy of each prong is computed once per mass hypothesis and shared among the charm-hadron hypotheses
+/// (e.g. the pion energy of the first same-charge track enters D+, Ds->piKK and Lc/Xic->piKp)
 /// \param pTrackSameChargeFirst is the first same-charge track momentum
-/// \param pTrackSameChargeFirst is the second same-charge track momentum
-/// \param pTrackSameChargeFirst is the opposite charge track momentum
+/// \param pTrackSameChargeSecond is the second same-charge track momentum
+/// \param pTrackOppositeCharge is the opposite charge track momentum
+/// \param invMasses is the array with the invariant masses, indexed by the invMasses3Prong enum (Lc and Xic share the same hypotheses)
+template <typename T>
+inline void HfFilterHelper::computeInvMasses3Prong(const T& pTrackSameChargeFirst, const T& pTrackSameChargeSecond, const T& pTrackOppositeCharge, std::array<double, kNInvMasses3Prong>& invMasses)
+{
+  // 0: pion, 1: kaon, 2: proton
+  constexpr std::array<float, 3> massesDau{massPi, massKa, massProton};
+  std::array<double, 3> energiesFirst{}, energiesSecond{};
+  for (std::size_t iMass{0u}; iMass < massesDau.size(); ++iMass) {
+    energiesFirst[iMass] = RecoDecay::e(pTrackSameChargeFirst, massesDau[iMass]);
+    energiesSecond[iMass] = RecoDecay::e(pTrackSameChargeSecond, massesDau[iMass]);
+  }
+  double energyOppositeKa = RecoDecay::e(pTrackOppositeCharge, massKa);
+
+  // momenta summed in double and in the same order of the prongs as in RecoDecay::m for each hypothesis, to get the very same values
+  std::array<double, 3> momTotDplus{0., 0., 0.}, momTot{0., 0., 0.};
+  for (std::size_t iMom{0u}; iMom < 3; ++iMom) {
+    momTotDplus[iMom] = static_cast<double>(pTrackSameChargeFirst[iMom]) + pTrackSameChargeSecond[iMom] + pTrackOppositeCharge[iMom];
+    momTot[iMom] = static_cast<double>(pTrackSameChargeFirst[iMom]) + pTrackOppositeCharge[iMom] + pTrackSameChargeSecond[iMom];
+  }
+  double mom2Dplus = RecoDecay::p2(momTotDplus);
+  double mom2 = RecoDecay::p2(momTot);
+  auto invMass = [](double energy, double momTot2) { return std::sqrt(energy * energy - momTot2); };
+  invMasses[kInvMassDplusToPiKPi] = invMass(energiesFirst[0] + energiesSecond[0] + energyOppositeKa, mom2Dplus);
+  invMasses[kInvMassToKKPi] = invMass(energiesFirst[1] + energyOppositeKa + energiesSecond[0], mom2);
+  invMasses[kInvMassToPiKK] = invMass(energiesFirst[0] + energyOppositeKa + energiesSecond[1], mom2);
+  invMasses[kInvMassToPKPi] = invMass(energiesFirst[2] + energyOppositeKa + energiesSecond[0], mom2);
+  invMasses[kInvMassToPiKP] = invMass(energiesFirst[0] + energyOppositeKa + energiesSecond[2], mom2);
+}
+
+/// Mass selection of D+ candidates to build B0 candidates
+/// \param invMasses is the array with the invariant masses of the 3-prong hypotheses (see computeInvMasses3Prong)
 /// \param ptD is the pt of the D+ meson candidate
 /// \param activateQA flag to activate the filling of QA histos
 /// \param hMassVsPt histo with invariant mass vs pt
 /// \return BIT(0) (==1) for D+, 0 otherwise
-template <typename T, typename H2>
-inline int8_t HfFilterHelper::isSelectedDplusInMassRange(const T& pTrackSameChargeFirst, const T& pTrackSameChargeSecond, const T& pTrackOppositeCharge, const float& ptD, const int& activateQA, H2 hMassVsPt)
+template <typename H2>
+inline int8_t HfFilterHelper::isSelectedDplusInMassRange(const std::array<double, kNInvMasses3Prong>& invMasses, const float& ptD, const int& activateQA, H2 hMassVsPt)
 {
-  auto invMassDplus = RecoDecay::m(std::array{pTrackSameChargeFirst, pTrackSameChargeSecond, pTrackOppositeCharge}, std::array{massPi, massPi, massKa});
+  auto invMassDplus = invMasses[kInvMassDplusToPiKPi];
   if (activateQA) {
     hMassVsPt->Fill(ptD, invMassDplus);
   }
@@ -696,20 +783,18 @@ inline int8_t HfFilterHelper::isSelectedDplusInMassRange(const T& pTrackSameChar
 }
 
 /// Mass selection of of Ds candidates to build Bs candidates
-/// \param pTrackSameChargeFirst is the first same-charge track momentum
-/// \param pTrackSameChargeFirst is the second same-charge track momentum
-/// \param pTrackSameChargeFirst is the opposite charge track momentum
+/// \param invMasses is the array with the invariant masses of the 3-prong hypotheses (see computeInvMasses3Prong)
 /// \param ptD is the pt of the Ds meson candidate
 /// \param isSelected is the flag containing the selection tag for the Ds candidate
 /// \param activateQA flag to activate the filling of QA histos
 /// \param hMassVsPt histo with invariant mass vs pt
 /// \return BIT(0) for KKpi, BIT(1) for piKK, BIT(2) for phipi, BIT(3) for piphi
-template <typename T, typename H2>
-inline int8_t HfFilterHelper::isSelectedDsInMassRange(const T& pTrackSameChargeFirst, const T& pTrackSameChargeSecond, const T& pTrackOppositeCharge, const float& ptD, int8_t isSelected, const int& activateQA, H2 hMassVsPt)
+template <typename H2>
+inline int8_t HfFilterHelper::isSelectedDsInMassRange(const std::array<double, kNInvMasses3Prong>& invMasses, const float& ptD, int8_t isSelected, const int& activateQA, H2 hMassVsPt)
 {
   int8_t retValue = 0;
   if (TESTBIT(isSelected, 0)) {
-    auto invMassDsToKKPi = RecoDecay::m(std::array{pTrackSameChargeFirst, pTrackOppositeCharge, pTrackSameChargeSecond}, std::array{massKa, massKa, massPi});
+    auto invMassDsToKKPi = invMasses[kInvMassToKKPi];
     if (activateQA) {
       hMassVsPt->Fill(ptD, invMassDsToKKPi);
     }
@@ -718,7 +803,7 @@ inline int8_t HfFilterHelper::isSelectedDsInMassRange(const T& pTrackSameChargeF
     }
   }
   if (TESTBIT(isSelected, 1)) {
-    auto invMassDsToPiKK = RecoDecay::m(std::array{pTrackSameChargeFirst, pTrackOppositeCharge, pTrackSameChargeSecond}, std::array{massPi, massKa, massKa});
+    auto invMassDsToPiKK = invMasses[kInvMassToPiKK];
     if (activateQA) {
       hMassVsPt->Fill(ptD, invMassDsToPiKK);
     }
@@ -731,20 +816,18 @@ inline int8_t HfFilterHelper::isSelectedDsInMassRange(const T& pTrackSameChargeF
 }
 
 /// Mass selection of Lc candidates to build Lb candidates
-/// \param pTrackSameChargeFirst is the first same-charge track momentum
-/// \param pTrackSameChargeSecond is the second same-charge track momentum
-/// \param pTrackOppositeCharge is the opposite charge track momentum
+/// \param invMasses is the array with the invariant masses of the 3-prong hypotheses (see computeInvMasses3Prong)
 /// \param ptLc is the pt of the D0 meson candidate
 /// \param isSelected is the flag containing the selection tag for the D0 candidate
 /// \param activateQA flag to activate the filling of QA histos
 /// \param hMassVsPt histo with invariant mass vs pt
 /// \return BIT(0) for pKpi with mass cut, BIT(1) for piKp with mass cut
-template <typename T, typename H2>
-inline int8_t HfFilterHelper::isSelectedLcInMassRange(const T& pTrackSameChargeFirst, const T& pTrackSameChargeSecond, const T& pTrackOppositeCharge, const float& ptLc, const int8_t isSelected, const int& activateQA, H2 hMassVsPt)
+template <typename H2>
+inline int8_t HfFilterHelper::isSelectedLcInMassRange(const std::array<double, kNInvMasses3Prong>& invMasses, const float& ptLc, const int8_t isSelected, const int& activateQA, H2 hMassVsPt)
 {
   int8_t retValue = 0;
   if (TESTBIT(isSelected, 0)) {
-    auto invMassLcToPKPi = RecoDecay::m(std::array{pTrackSameChargeFirst, pTrackOppositeCharge, pTrackSameChargeSecond}, std::array{massProton, massKa, massPi});
+    auto invMassLcToPKPi = invMasses[kInvMassToPKPi];
     if (activateQA) {
       hMassVsPt->Fill(ptLc, invMassLcToPKPi);
     }
@@ -753,7 +836,7 @@ inline int8_t HfFilterHelper::isSelectedLcInMassRange(const T& pTrackSameChargeF
     }
   }
   if (TESTBIT(isSelected, 1)) {
-    auto invMassLcToPiKP = RecoDecay::m(std::array{pTrackSameChargeFirst, pTrackOppositeCharge, pTrackSameChargeSecond}, std::array{massPi, massKa, massProton});
+    auto invMassLcToPiKP = invMasses[kInvMassToPiKP];
     if (activateQA) {
       hMassVsPt->Fill(ptLc, invMassLcToPiKP);
     }
@@ -766,20 +849,18 @@ inline int8_t HfFilterHelper::isSelectedLcInMassRange(const T& pTrackSameChargeF
 }
 
 /// Mass selection of Xic candidates to build Lb candidates
-/// \param pTrackSameChargeFirst is the first same-charge track momentum
-/// \param pTrackSameChargeSecond is the second same-charge track momentum
-/// \param pTrackOppositeCharge is the opposite charge track momentum
+/// \param invMasses is the array with the invariant masses of the 3-prong hypotheses (see computeInvMasses3Prong)
 /// \param ptXic is the pt of the Xic baryon candidate
 /// \param isSelected is the flag containing the selection tag for the D0 candidate
 /// \param activateQA flag to activate the filling of QA histos
 /// \param hMassVsPt histo with invariant mass vs pt
 /// \return BIT(0) for pKpi with mass cut, BIT(1) for piKp with mass cut
-template <typename T, typename H2>
-inline int8_t HfFilterHelper::isSelectedXicInMassRange(const T& pTrackSameChargeFirst, const T& pTrackSameChargeSecond, const T& pTrackOppositeCharge, const float& ptXic, const int8_t isSelected, const int& activateQA, H2 hMassVsPt)
+template <typename H2>
+inline int8_t HfFilterHelper::isSelectedXicInMassRange(const std::array<double, kNInvMasses3Prong>& invMasses, const float& ptXic, const int8_t isSelected, const int& activateQA, H2 hMassVsPt)
 {
   int8_t retValue = 0;
   if (TESTBIT(isSelected, 0)) {
-    auto invMassXicToPKPi = RecoDecay::m(std::array{pTrackSameChargeFirst, pTrackOppositeCharge, pTrackSameChargeSecond}, std::array{massProton, massKa, massPi});
+    auto invMassXicToPKPi = invMasses[kInvMassToPKPi];
     if (activateQA) {
       hMassVsPt->Fill(ptXic, invMassXicToPKPi);
     }
@@ -788,7 +869,7 @@ inline int8_t HfFilterHelper::isSelectedXicInMassRange(const T& pTrackSameCharge
     }
   }
   if (TESTBIT(isSelected, 1)) {
-    auto invMassXicToPiKP = RecoDecay::m(std::array{pTrackSameChargeFirst, pTrackOppositeCharge, pTrackSameChargeSecond}, std::array{massPi, massKa, massProton});
+    auto invMassXicToPiKP = invMasses[kInvMassToPiKP];
     if (activateQA) {
       hMassVsPt->Fill(ptXic, invMassXicToPiKP);
     }
@@ -1300,6 +1381,49 @@ inline std::array<T, 3> HfFilterHelper::predictONNX(std::vector<T>& inputFeature
   return scores;
 }
 
+/// Inference of a batch of candidates with a single session call
+/// \param inputFeatures are the input features of the candidates, one candidate after the other
+/// \param nCandidates is the number of candidates
+/// \param session is the ONNX session
+/// \param inputShapes is the input shape for one candidate
+/// \param scores are the output scores, one array per candidate
+/// \note models with a fixed batch size are evaluated candidate by candidate
+template <typename T>
+inline void HfFilterHelper::predictONNXBatch(std::vector<T>& inputFeatures, int64_t nCandidates, std::shared_ptr<Ort::Experimental::Session>& session, std::vector<std::vector<int64_t>>& inputShapes, std::vector<std::array<T, 3>>& scores)
+{
+  scores.assign(nCandidates, std::array<T, 3>{-1., 2., 2.});
+  if (nCandidates == 0) {
+    return;
+  }
+  const int64_t nFeatures = inputFeatures.size() / nCandidates;
+  if (session->GetInputShapes()[0][0] >= 0) { // fixed batch size
+    std::vector<T> inputFeaturesCand(nFeatures);
+    for (int64_t iCand{0}; iCand < nCandidates; ++iCand) {
+      std::copy_n(inputFeatures.begin() + iCand * nFeatures, nFeatures, inputFeaturesCand.begin());
+      scores[iCand] = predictONNX(inputFeaturesCand, session, inputShapes);
+    }
+    return;
+  }
+
+  std::vector<Ort::Value> inputTensor{};
+  inputTensor.push_back(Ort::Experimental::Value::CreateTensor<T>(inputFeatures.data(), inputFeatures.size(), std::vector<int64_t>{nCandidates, nFeatures}));
+  try {
+    auto outputTensor = session->Run(session->GetInputNames(), inputTensor, session->GetOutputNames());
+    assert(outputTensor.size() == session->GetOutputNames().size() && outputTensor[1].IsTensor());
+    auto typeInfo = outputTensor[1].GetTensorTypeAndShapeInfo();
+    if (typeInfo.GetElementCount() != static_cast<std::size_t>(3 * nCandidates)) { // we need multiclass
+      LOG(error) << "Error running batched model inference: " << typeInfo.GetElementCount() << " scores for " << nCandidates << " candidates";
+      return;
+    }
+    const T* outputScores = outputTensor[1].GetTensorMutableData<T>();
+    for (int64_t iCand{0}; iCand < nCandidates; ++iCand) {
+      scores[iCand] = {outputScores[3 * iCand], outputScores[3 * iCand + 1], outputScores[3 * iCand + 2]};
+    }
+  } catch (const Ort::Exception& exception) {
+    LOG(error) << "Error running batched model inference: " << exception.what();
+  }
+}
+
 /// PID postcalibrations
 
 /// load the TPC spline from the CCDB
@@ -12,10 +12,13 @@
 // Full Jet Filter
 // Author: Gijs van Weelden
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <vector>
 #include <TMath.h>
 
 #include <boost/algorithm/string/case_conv.hpp>
@@ -39,6 +42,7 @@
 #include "PWGJE/DataModel/EMCALClusters.h"
 #include "PWGJE/Core/JetFinder.h"
 #include "PWGJE/Core/FastJetUtilities.h"
+#include "PWGJE/Core/EMCALPatchFinder.h"
 
 #include "../filterTables.h"
 
@@ -142,6 +146,10 @@ struct fullJetFilter {
   OutputObj<TH1D> hSelectGammaMaxClusterDCAL{"hSelectGammaMaxClusterDCAL"};
   OutputObj<TH1D> hSelectGammaLowMaxClusterDCAL{"hSelectGammaLowMaxClusterDCAL"};
   OutputObj<TH1D> hSelectGammaVeryLowMaxClusterDCAL{"hSelectGammaVertLowMaxClusterDCAL"};
+  OutputObj<TH1D> hMaxGammaPatchEMCAL{"hMaxGammaPatchEMCAL"};
+  OutputObj<TH1D> hMaxGammaPatchDCAL{"hMaxGammaPatchDCAL"};
+  OutputObj<TH1D> hMaxJetPatchEMCAL{"hMaxJetPatchEMCAL"};
+  OutputObj<TH1D> hMaxJetPatchDCAL{"hMaxJetPatchDCAL"};
 
   // Configurables
   Configurable<float> f_jetPtMin{"f_jetPtMin", 0.0, "minimum jet pT cut"};
@@ -175,10 +183,19 @@ struct fullJetFilter {
   Configurable<bool> b_IgnoreEmcalFlag{"b_IgnoreEmcalFlag", false, "ignore the EMCAL live flag check"};
   Configurable<bool> b_DoFiducialCut{"b_DoFiducialCut", false, "do a fiducial cut on jets to check if they are in the emcal"};
   Configurable<bool> b_RejectExoticClusters{"b_RejectExoticClusters", true, "Reject exotic clusters"};
+  Configurable<bool> b_doPatchQA{"b_doPatchQA", false, "fill the energies of the max. gamma and jet patches built from the selected clusters"};
+  Configurable<int> i_gammaPatchSize{"i_gammaPatchSize", 2, "size of the gamma patches (towers)"};
+  Configurable<int> i_jetPatchSize{"i_jetPatchSize", 16, "size of the jet patches (towers)"};
+  Configurable<int> i_jetPatchStep{"i_jetPatchStep", 4, "distance between two jet patches (towers)"};
 
   int lastRun = -1;
   EMCALHWTriggerConfiguration mHardwareTriggerConfig = EMCALHWTriggerConfiguration::UNKNOWN;
 
+  o2::emcal::Geometry* mGeometry = nullptr;
+  EMCALPatchFinder mPatchFinder;
+  std::vector<std::tuple<int, int>> mCellRowCol; // global row and column of each cell
+  int mNRowsEMCAL = 0;                           // DCAL rows follow the EMCAL rows in the global numbering
+
   Service<o2::ccdb::BasicCCDBManager> ccdb;
 
   void init(o2::framework::InitContext&)
@@ -248,6 +265,14 @@ struct fullJetFilter {
     hSelectGammaLowMaxClusterDCAL.setObject(new TH1D("hSelectGammaLowMaxClusterDCAL", "Max. cluster pt selected Gamms DCAL (low threshold)", nPtBins, kMinPt, kMaxPt));
     hSelectGammaVeryLowMaxClusterDCAL.setObject(new TH1D("hSelectGammaVertLowMaxClusterDCAL", "Max. cluster pt selected Gamms DCAL (very low threshold)", nPtBins, kMinPt, kMaxPt));
 
+    if (b_doPatchQA) {
+      hMaxGammaPatchEMCAL.setObject(new TH1D("hMaxGammaPatchEMCAL", "Max. gamma patch energy EMCAL;E (GeV)", nPtBins, kMinPt, kMaxPt / 2));
+      hMaxGammaPatchDCAL.setObject(new TH1D("hMaxGammaPatchDCAL", "Max. gamma patch energy DCAL;E (GeV)", nPtBins, kMinPt, kMaxPt / 2));
+      hMaxJetPatchEMCAL.setObject(new TH1D("hMaxJetPatchEMCAL", "Max. jet patch energy EMCAL;E (GeV)", nPtBins, kMinPt, kMaxPt));
+      hMaxJetPatchDCAL.setObject(new TH1D("hMaxJetPatchDCAL", "Max. jet patch energy DCAL;E (GeV)", nPtBins, kMinPt, kMaxPt));
+      initPatchFinder();
+    }
+
     LOG(info) << "Jet trigger: " << (b_doJetTrigger ? "on" : "off");
     LOG(info) << "Gamma trigger: " << (b_doJetTrigger ? "on" : "off");
     LOG(info) << "Thresholds gamma trigger (L0-triggered runs): EG1 " << f_gammaPtMinEMCALHigh << " GeV, DG1 " << f_gammaPtMinDCALHigh << " GeV, EG2 " << f_gammaPtMinEMCALLow << " GeV, DG2 " << f_gammaPtMinDCALLow << " GeV";
@@ -460,6 +485,59 @@ struct fullJetFilter {
     return isEMCALMinBias(collision) || isEMCALLevel0(collision) || isEMCALLevel1(collision);
   }
 
+  /// Maps the cells on the global tower grid, once, so that the patch finder only needs the cell index of each cluster
+  void initPatchFinder()
+  {
+    mGeometry = o2::emcal::Geometry::GetInstanceFromRunNumber(300000);
+    const int nCells = mGeometry->GetNCells();
+    mCellRowCol.resize(nCells);
+    int nRows = 0, nCols = 0;
+    mNRowsEMCAL = 0;
+    for (int cellId = 0; cellId < nCells; cellId++) {
+      const auto [row, col] = mGeometry->GlobalRowColFromIndex(cellId);
+      mCellRowCol[cellId] = {row, col};
+      nRows = std::max(nRows, row + 1);
+      nCols = std::max(nCols, col + 1);
+      if (std::get<0>(mGeometry->GetCellIndex(cellId)) < 12) { // EMCAL supermodules
+        mNRowsEMCAL = std::max(mNRowsEMCAL, row + 1);
+      }
+    }
+    mPatchFinder.init(nRows, nCols);
+    LOG(info) << "Patch QA: grid of " << nRows << " x " << nCols << " towers (" << mNRowsEMCAL << " EMCAL rows), gamma patches " << i_gammaPatchSize << "x" << i_gammaPatchSize << ", jet patches " << i_jetPatchSize << "x" << i_jetPatchSize << " (step " << i_jetPatchStep << ")";
+  }
+
+  void runPatchQA(const selectedClusters& clusters)
+  {
+    mPatchFinder.reset();
+    for (const auto& cluster : clusters) {
+      if (b_RejectExoticClusters && cluster.isExotic()) {
+        continue;
+      }
+      if (cluster.time() < f_minClusterTime || cluster.time() > f_maxClusterTime) {
+        continue;
+      }
+      int cellId = -1;
+      try {
+        cellId = mGeometry->GetAbsCellIdFromEtaPhi(cluster.eta(), TVector2::Phi_0_2pi(cluster.phi()));
+      } catch (o2::emcal::InvalidPositionException& e) {
+        // Imprecision of the position at the sector boundaries, mostly due to
+        // vertex imprecision. Skip these clusters for the patches.
+        continue;
+      }
+      if (cellId < 0 || cellId >= static_cast<int>(mCellRowCol.size())) {
+        continue;
+      }
+      const auto [row, col] = mCellRowCol[cellId];
+      mPatchFinder.addEnergy(row, col, cluster.energy());
+    }
+    mPatchFinder.build();
+    const int nRows = mPatchFinder.getNRows();
+    hMaxGammaPatchEMCAL->Fill(mPatchFinder.findMaxPatch(i_gammaPatchSize, 1, 0, mNRowsEMCAL).energy);
+    hMaxGammaPatchDCAL->Fill(mPatchFinder.findMaxPatch(i_gammaPatchSize, 1, mNRowsEMCAL, nRows).energy);
+    hMaxJetPatchEMCAL->Fill(mPatchFinder.findMaxPatch(i_jetPatchSize, i_jetPatchStep, 0, mNRowsEMCAL).energy);
+    hMaxJetPatchDCAL->Fill(mPatchFinder.findMaxPatch(i_jetPatchSize, i_jetPatchStep, mNRowsEMCAL, nRows).energy);
+  }
+
   void runGammaTrigger(const selectedClusters& clusters, std::bitset<EMCALHardwareTrigger::TRG_NTriggers> hardwaretriggers, std::array<bool, kCategories>& keepEvent)
   {
     double maxClusterObservableEMCAL = -1., maxClusterObservableDCAL = -1.;
@@ -682,6 +760,10 @@ struct fullJetFilter {
       runGammaTrigger(clusters, hardwaretriggers, keepEvent);
     }
 
+    if (b_doPatchQA) {
+      runPatchQA(clusters);
+    }
+
     for (int iDecision{0}; iDecision < kCategories; iDecision++) {
       if (keepEvent[iDecision]) {
         hProcessedEvents->Fill(iDecision);
@@ -238,6 +238,9 @@ struct DGBCFilterRun3 {
   // DG selector
   DGSelector dgSelector;
 
+  // FIT activity in the BCs table, used for the ranges of compatible BCs
+  udhelpers::FITActivity fitActivity;
+
   // histograms with cut statistics
   // bin:
   //   1: All collisions
@@ -292,6 +295,9 @@ struct DGBCFilterRun3 {
                aod::FV0As& fv0as,
                aod::FDDs& fdds)
   {
+    // the FIT activity of each BC is evaluated once for all the ranges of compatible BCs it is in
+    fitActivity.fill(bcs, diffCuts.maxFITtime(), diffCuts.FITAmpLimits());
+    dgSelector.SetFITActivity(&fitActivity);
 
     // Advance these pointers step-by-step
     auto tibc = tibcs.iteratorAt(0);
@@ -345,6 +351,7 @@ struct DGBCFilterRun3 {
       // update filterTable
       bcfilterTable(ccs);
     }
+    dgSelector.SetFITActivity(nullptr);
   }
 };
 
@@ -14,6 +14,7 @@
 #include <rapidjson/document.h>
 #include <rapidjson/filereadstream.h>
 
+#include <array>
 #include <iostream>
 #include <cstdio>
 #include <random>
@@ -69,6 +70,19 @@ bool readJsonFile(std::string& config, Document& d)
   return true;
 }
 
+// same as n fills of the bin with unit weight
+void addToBin(TH1* hist, int bin, uint64_t n)
+{
+  if (n == 0) {
+    return;
+  }
+  hist->AddBinContent(bin, n);
+  if (hist->GetSumw2N()) {
+    hist->GetSumw2()->AddAt(hist->GetSumw2()->At(bin) + n, bin);
+  }
+  hist->SetEntries(hist->GetEntries() + n);
+}
+
 std::unordered_map<std::string, std::unordered_map<std::string, float>> mDownscaling;
 static const std::vector<std::string> downscalingName{"Downscaling"};
 static const float defaultDownscaling[128][1]{
@@ -347,6 +361,9 @@ struct centralEventFilterTask {
     int64_t nEvents{-1};
     std::vector<uint64_t> outTrigger, outDecision;
     int64_t nSelected{0};
+    // events firing each trigger bit, one bit per event, to count the pairs of triggers with popcounts
+    std::array<std::vector<uint64_t>, 64> firedEvents;
+    uint64_t usedBits{0};
     for (auto& tableName : mDownscaling) {
       if (!pc.inputs().isValid(tableName.first)) {
         LOG(fatal) << tableName.first << " table is not valid.";
@@ -363,56 +380,72 @@ struct centralEventFilterTask {
         outDecision.resize(nEvents, 0u);
         outTrigger.resize(nEvents, 0u);
       }
+      const size_t nWords = (nEvents + 63) / 64;
 
       auto schema{tablePtr->schema()};
       for (auto& colName : tableName.second) {
         int bin{mScalers->GetXaxis()->FindBin(colName.first.data())};
-        double binCenter{mScalers->GetXaxis()->GetBinCenter(bin)};
-        uint64_t triggerBit{BIT(bin - 2)};
+        int iBit{bin - 2};
+        uint64_t triggerBit{BIT(iBit)};
         auto column{tablePtr->GetColumnByName(colName.first)};
         double downscaling{colName.second};
+        // the uniform numbers are in [0, 1): the draw is only needed for downscalings in (0, 1)
+        bool keepAll{downscaling >= 1.};
+        bool keepNone{downscaling <= 0.};
         if (column) {
+          auto& eventBits = firedEvents[iBit];
+          eventBits.assign(nWords, 0u);
+          usedBits |= triggerBit;
+          uint64_t nFired{0}, nKept{0};
           int entry = 0;
           for (int64_t iC{0}; iC < column->num_chunks(); ++iC) {
             auto chunk{column->chunk(iC)};
             auto boolArray = std::static_pointer_cast<arrow::BooleanArray>(chunk);
             for (int64_t iS{startCollision}; iS < chunk->length(); ++iS) {
               if (boolArray->Value(iS)) {
-                mScalers->Fill(binCenter);
+                nFired++;
                 outTrigger[entry] |= triggerBit;
-                if (mUniformGenerator(mGeneratorEngine) < downscaling) {
-                  mFiltered->Fill(binCenter);
+                eventBits[entry / 64] |= BIT(entry % 64);
+                if (keepAll || (!keepNone && mUniformGenerator(mGeneratorEngine) < downscaling)) {
+                  nKept++;
                   outDecision[entry] |= triggerBit;
-                  nSelected++;
                 }
               }
               entry++;
             }
           }
+          addToBin(mScalers.get(), bin, nFired);
+          addToBin(mFiltered.get(), bin, nKept);
+          nSelected += nKept;
         }
       }
     }
     mScalers->SetBinContent(1, mScalers->GetBinContent(1) + nEvents - startCollision);
     mFiltered->SetBinContent(1, mFiltered->GetBinContent(1) + nEvents - startCollision);
 
-    for (uint64_t iE{0}; iE < outTrigger.size(); ++iE) {
-      for (int iB{0}; iB < 64; ++iB) {
-        if (!(outTrigger[iE] & BIT(iB))) {
+    // number of events firing both triggers of each pair, from the popcounts of the ANDed event bits
+    for (int iB{0}; iB < 64; ++iB) {
+      if (!(usedBits & BIT(iB))) {
+        continue;
+      }
+      for (int iC{iB}; iC < 64; ++iC) {
+        if (!(usedBits & BIT(iC))) {
           continue;
         }
-        for (int iC{iB}; iC < 64; ++iC) {
-          if (outTrigger[iE] & BIT(iC)) {
-            mCovariance->Fill(iB, iC);
-          }
+        uint64_t nBoth{0};
+        for (size_t iW{0}; iW < firedEvents[iB].size(); ++iW) {
+          nBoth += __builtin_popcountll(firedEvents[iB][iW] & firedEvents[iC][iW]);
         }
+        addToBin(mCovariance.get(), mCovariance->FindBin(iB, iC), nBoth);
       }
-      if (outTrigger[iE]) {
-        mScalers->Fill(mScalers->GetNbinsX() - 1);
-      }
-      if (outDecision[iE]) {
-        mFiltered->Fill(mFiltered->GetNbinsX() - 1);
-      }
     }
+    uint64_t nTriggered{0}, nFiltered{0};
+    for (uint64_t iE{0}; iE < outTrigger.size(); ++iE) {
+      nTriggered += outTrigger[iE] != 0;
+      nFiltered += outDecision[iE] != 0;
+    }
+    addToBin(mScalers.get(), mScalers->FindBin(mScalers->GetNbinsX() - 1), nTriggered);
+    addToBin(mFiltered.get(), mFiltered->FindBin(mFiltered->GetNbinsX() - 1), nFiltered);
 
     /// Filling the output table
     if (outDecision.size() != static_cast<uint64_t>(collTabPtr->num_rows())) {
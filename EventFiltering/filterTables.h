@@ -129,6 +129,20 @@ DECLARE_SOA_COLUMN(CefpSelected, cefpSelected, uint64_t);      //! CEFP decision
 
 } // namespace decision
 
+namespace filtertrack
+{
+/// bits of the common track selection, evaluated once per track for all the filters
+enum FilterTrackSelection : uint8_t {
+  kEta = 0, // |eta| below the maximum
+  kITSNCls, // enough ITS clusters
+  kTPCNCls, // enough found TPC clusters
+  kDCA,     // DCAxy and DCAz below the maxima
+  kNFilterTrackSelections
+};
+
+DECLARE_SOA_COLUMN(Selection, selection, uint8_t); //! bits of the common track selection
+} // namespace filtertrack
+
 namespace bcrange
 {
 DECLARE_SOA_COLUMN(BCstart, hasBCstart, uint64_t); //! CEFP triggers before downscalings
@@ -136,6 +150,11 @@ DECLARE_SOA_COLUMN(BCend, hasBCend, uint64_t);     //! CEFP bcrange
 
 } // namespace bcrange
 
+// common track selection of the filters, joinable with Tracks
+DECLARE_SOA_TABLE(FilterTrackSels, "AOD", "FilterTrackSels", //!
+                  filtertrack::Selection);
+using FilterTrackSel = FilterTrackSels::iterator;
+
 // nuclei
 DECLARE_SOA_TABLE(NucleiFilters, "AOD", "NucleiFilters", //!
                   filtering::He, filtering::H3L3Body);
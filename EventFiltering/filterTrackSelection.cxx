@@ -0,0 +1,65 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+// Common track selection of the filters: the quality cuts shared by the filters are
+// evaluated once per track and stored as bits, which the filters read joined with
+// their tracks instead of repeating the cuts in each filter.
+
+#include <cmath>
+
+#include "Common/DataModel/TrackSelectionTables.h"
+#include "Framework/AnalysisDataModel.h"
+#include "Framework/AnalysisTask.h"
+#include "Framework/runDataProcessing.h"
+
+#include "filterTables.h"
+
+using namespace o2;
+using namespace o2::framework;
+
+struct filterTrackSelection {
+
+  Produces<aod::FilterTrackSels> selections;
+
+  Configurable<float> cfgCutEta{"cfgCutEta", 1.f, "Eta range for tracks"};
+  Configurable<float> cfgCutNclusITS{"cfgCutNclusITS", 2, "Minimum number of ITS clusters"};
+  Configurable<float> cfgCutNclusTPC{"cfgCutNclusTPC", 80, "Minimum number of TPC clusters"};
+  Configurable<float> cfgCutDCAxy{"cfgCutDCAxy", 3, "Max DCAxy"};
+  Configurable<float> cfgCutDCAz{"cfgCutDCAz", 10, "Max DCAz"};
+
+  using TrackCandidates = soa::Join<aod::Tracks, aod::TracksExtra, aod::TracksDCA>;
+  void process(TrackCandidates const& tracks)
+  {
+    selections.reserve(tracks.size());
+    for (auto& track : tracks) {
+      uint8_t selection{0};
+      if (std::abs(track.eta()) < cfgCutEta) {
+        selection |= BIT(aod::filtertrack::kEta);
+      }
+      if (track.itsNCls() >= cfgCutNclusITS) {
+        selection |= BIT(aod::filtertrack::kITSNCls);
+      }
+      if (track.tpcNClsFound() >= cfgCutNclusTPC) {
+        selection |= BIT(aod::filtertrack::kTPCNCls);
+      }
+      if (std::abs(track.dcaXY()) <= cfgCutDCAxy && std::abs(track.dcaZ()) <= cfgCutDCAz) {
+        selection |= BIT(aod::filtertrack::kDCA);
+      }
+      selections(selection);
+    }
+  }
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfg)
+{
+  return WorkflowSpec{
+    adaptAnalysisTask<filterTrackSelection>(cfg)};
+}
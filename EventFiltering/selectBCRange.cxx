@@ -111,15 +111,18 @@ struct BCRangeSelector {
       return a.getMin() < b.getMin();
     });
 
-    std::vector<IRFrame> bcRangesMerged(1, bcRanges[0]);
-    for (uint64_t iR{1}; iR < bcRanges.size(); ++iR) {
-      if (bcRangesMerged.back().getMax() >= bcRanges[iR].getMin()) {
-        bcRangesMerged.back().getMax() = std::max(bcRangesMerged.back().getMax(), bcRanges[iR].getMax());
+    /// The ranges are merged in place, also when they are only adjacent as both their limits are included,
+    /// so that the output list is sorted and disjoint and can be searched with a binary search
+    size_t nMerged{1};
+    for (size_t iR{1}; iR < bcRanges.size(); ++iR) {
+      auto& last = bcRanges[nMerged - 1];
+      if (last.getMax().toLong() + 1 >= bcRanges[iR].getMin().toLong()) {
+        last.getMax() = std::max(last.getMax(), bcRanges[iR].getMax());
       } else {
-        bcRangesMerged.push_back(bcRanges[iR]);
+        bcRanges[nMerged++] = bcRanges[iR];
       }
     }
-    bcRanges.swap(bcRangesMerged);
+    bcRanges.resize(nMerged);
 
     for (auto& range : bcRanges) {
       tags(range.getMin().toLong(), range.getMax().toLong());
@@ -0,0 +1,88 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FemtoPairMath.h
+/// \brief Pair kinematics shared by the femtoscopy frameworks (FemtoDream, FemtoUniverse and FemtoWorld)
+///
+/// The pair quantities are computed in closed form from the kinematics of the two particles,
+/// without building and boosting Lorentz vectors for each pair.
+
+#ifndef PWGCF_CORE_FEMTOPAIRMATH_H_
+#define PWGCF_CORE_FEMTOPAIRMATH_H_
+
+#include <cmath>
+
+namespace o2::analysis::femto
+{
+
+/// Radii (cm) in the TPC at which phi* is computed for the close-pair rejection
+static constexpr int kNRadiiTPC = 9;
+static constexpr float radiiTPC[kNRadiiTPC] = {85., 105., 125., 145., 165., 185., 205., 225., 245.};
+
+/// Compute phi*, the azimuthal angle of a track at a given radius
+/// \param phi0 Azimuthal angle of the track at the primary vertex
+/// \param charge Charge of the track
+/// \param pt Transverse momentum of the track (GeV/c)
+/// \param magfield Magnetic field (kG)
+/// \param radius Radius (cm)
+inline float getPhiStar(const float phi0, const float charge, const float pt, const float magfield, const float radius)
+{
+  return phi0 - std::asin(0.3 * charge * 0.1 * magfield * radius * 0.01 / (2. * pt));
+}
+
+/// Compute the k* of a pair of particles, i.e. the momentum of each particle in the pair rest frame
+/// k* = sqrt(lambda(s, m1^2, m2^2)) / (2 sqrt(s)), with s the squared invariant mass of the pair
+/// \param pt1 Transverse momentum of particle 1
+/// \param eta1 Pseudorapidity of particle 1
+/// \param phi1 Azimuthal angle of particle 1
+/// \param mass1 Mass of particle 1
+/// \param pt2 Transverse momentum of particle 2
+/// \param eta2 Pseudorapidity of particle 2
+/// \param phi2 Azimuthal angle of particle 2
+/// \param mass2 Mass of particle 2
+inline float getkstar(const float pt1, const float eta1, const float phi1, const float mass1,
+                      const float pt2, const float eta2, const float phi2, const float mass2)
+{
+  const double pz1 = pt1 * std::sinh(eta1);
+  const double pz2 = pt2 * std::sinh(eta2);
+  const double e1 = std::sqrt(static_cast<double>(pt1) * pt1 + pz1 * pz1 + static_cast<double>(mass1) * mass1);
+  const double e2 = std::sqrt(static_cast<double>(pt2) * pt2 + pz2 * pz2 + static_cast<double>(mass2) * mass2);
+  const double p1p2 = static_cast<double>(pt1) * pt2 * std::cos(phi1 - phi2) + pz1 * pz2;
+  const double s = static_cast<double>(mass1) * mass1 + static_cast<double>(mass2) * mass2 + 2. * (e1 * e2 - p1p2);
+  const double lambda = (s - std::pow(mass1 + mass2, 2.)) * (s - std::pow(mass1 - mass2, 2.));
+  if (lambda <= 0. || s <= 0.) {
+    return 0.f;
+  }
+  return 0.5 * std::sqrt(lambda / s);
+}
+
+/// Compute the transverse momentum of a pair of particles, half of the transverse momentum of the pair
+/// \param pt1 Transverse momentum of particle 1
+/// \param phi1 Azimuthal angle of particle 1
+/// \param pt2 Transverse momentum of particle 2
+/// \param phi2 Azimuthal angle of particle 2
+inline float getkT(const float pt1, const float phi1, const float pt2, const float phi2)
+{
+  return 0.5 * std::sqrt(static_cast<double>(pt1) * pt1 + static_cast<double>(pt2) * pt2 + 2. * pt1 * pt2 * std::cos(phi1 - phi2));
+}
+
+/// Compute the transverse mass of a pair of particles from its transverse momentum
+/// \param kT Transverse momentum of the pair
+/// \param mass1 Mass of particle 1
+/// \param mass2 Mass of particle 2
+inline float getmT(const float kT, const float mass1, const float mass2)
+{
+  return std::sqrt(std::pow(kT, 2.) + std::pow(0.5 * (mass1 + mass2), 2.));
+}
+
+} // namespace o2::analysis::femto
+
+#endif // PWGCF_CORE_FEMTOPAIRMATH_H_
@@ -10,6 +10,7 @@
 // or submit itself to any jurisdiction.
 
 #include <CCDB/BasicCCDBManager.h>
+#include <array>
 #include <cmath>
 #include <vector>
 #include "Framework/AnalysisTask.h"
@@ -133,10 +134,11 @@ struct MeanptFluctuations_QA_QnTable {
       float pT = track.pt();
       // calculating Q1, Q2, Q3, Q4. N_ch
       if (track.pt() > cfgCutPtLower && track.pt() < cfgCutPtUpper && track.sign() != 0) {
-        q1 = q1 + pow(pT, 1.0);
-        q2 = q2 + pow(pT, 2.0);
-        q3 = q3 + pow(pT, 3.0);
-        q4 = q4 + pow(pT, 4.0);
+        const double pT2 = static_cast<double>(pT) * pT;
+        q1 = q1 + pT;
+        q2 = q2 + pT2;
+        q3 = q3 + pT2 * pT;
+        q4 = q4 + pT2 * pT2;
         n_ch = n_ch + 1;
       }
     }
@@ -164,6 +166,7 @@ struct MeanptFluctuations_analysis {
 
   // Define output
   HistogramRegistry registry{"registry", {}, OutputObjHandlingPolicy::AnalysisObject};
+  std::array<std::shared_ptr<TProfile2D>, 4> Prof; // mean, variance, skewness and kurtosis terms
   std::vector<std::vector<std::shared_ptr<TProfile2D>>> Subsample;
   TRandom3* fRndm = new TRandom3(0);
 
@@ -172,10 +175,10 @@ struct MeanptFluctuations_analysis {
     // AxisSpec centAxis = {90, 0, 90, "centrality (%)"};
     // AxisSpec multAxis = {5000, 0.5, 5000.5, "#it{N}_{ch,acc}"};
 
-    registry.add("Prof_mean_t1", "", {HistType::kTProfile2D, {centAxis, multAxis}});
-    registry.add("Prof_var_t1", "", {HistType::kTProfile2D, {centAxis, multAxis}});
-    registry.add("Prof_skew_t1", "", {HistType::kTProfile2D, {centAxis, multAxis}});
-    registry.add("Prof_kurt_t1", "", {HistType::kTProfile2D, {centAxis, multAxis}});
+    Prof[0] = std::get<std::shared_ptr<TProfile2D>>(registry.add("Prof_mean_t1", "", {HistType::kTProfile2D, {centAxis, multAxis}}));
+    Prof[1] = std::get<std::shared_ptr<TProfile2D>>(registry.add("Prof_var_t1", "", {HistType::kTProfile2D, {centAxis, multAxis}}));
+    Prof[2] = std::get<std::shared_ptr<TProfile2D>>(registry.add("Prof_skew_t1", "", {HistType::kTProfile2D, {centAxis, multAxis}}));
+    Prof[3] = std::get<std::shared_ptr<TProfile2D>>(registry.add("Prof_kurt_t1", "", {HistType::kTProfile2D, {centAxis, multAxis}}));
     registry.add("Hist2D_Nch_centrality", "", {HistType::kTH2D, {centAxis, multAxis}});
     registry.add("Hist2D_meanpt_centrality", "", {HistType::kTH2D, {centAxis, meanpTAxis}});
 
@@ -203,26 +206,35 @@ struct MeanptFluctuations_analysis {
     // LOGF(info, "Centrality= %f Nch= %f Q1= %f Q2= %f", event_ptqn.centrality(), event_ptqn.n_ch(), event_ptqn.q1(), event_ptqn.q2());
 
     // calculating observables
-    mean_term1 = event_ptqn.q1() / event_ptqn.n_ch();
-    variance_term1 = (TMath::Power(event_ptqn.q1(), 2.0f) - event_ptqn.q2()) / (event_ptqn.n_ch() * (event_ptqn.n_ch() - 1.0f));
-    skewness_term1 = (TMath::Power(event_ptqn.q1(), 3.0f) - 3.0f * event_ptqn.q2() * event_ptqn.q1() + 2.0f * event_ptqn.q3()) / (event_ptqn.n_ch() * (event_ptqn.n_ch() - 1.0f) * (event_ptqn.n_ch() - 2.0f));
-    kurtosis_term1 = (TMath::Power(event_ptqn.q1(), 4.0f) - (6.0f * event_ptqn.q4()) + (8.0f * event_ptqn.q1() * event_ptqn.q3()) - (6.0f * TMath::Power(event_ptqn.q1(), 2.0f) * event_ptqn.q2()) + (3.0f * TMath::Power(event_ptqn.q2(), 2.0f))) / (event_ptqn.n_ch() * (event_ptqn.n_ch() - 1.0f) * (event_ptqn.n_ch() - 2.0f) * (event_ptqn.n_ch() - 3.0f));
+    const float q1 = event_ptqn.q1();
+    const float q2 = event_ptqn.q2();
+    const float q3 = event_ptqn.q3();
+    const float q4 = event_ptqn.q4();
+    const float nCh = event_ptqn.n_ch();
+    const float centrality = event_ptqn.centrality();
+    const float nPairs = nCh * (nCh - 1.0f);
+    const float nTriplets = nPairs * (nCh - 2.0f);
+    const float nQuadruplets = nTriplets * (nCh - 3.0f);
+    mean_term1 = q1 / nCh;
+    variance_term1 = (q1 * q1 - q2) / nPairs;
+    skewness_term1 = (q1 * q1 * q1 - 3.0f * q2 * q1 + 2.0f * q3) / nTriplets;
+    kurtosis_term1 = (q1 * q1 * q1 * q1 - (6.0f * q4) + (8.0f * q1 * q3) - (6.0f * q1 * q1 * q2) + (3.0f * q2 * q2)) / nQuadruplets;
 
     // filling profiles and histograms for central values
-    registry.get<TProfile2D>(HIST("Prof_mean_t1"))->Fill(event_ptqn.centrality(), event_ptqn.n_ch(), mean_term1);
-    registry.get<TProfile2D>(HIST("Prof_var_t1"))->Fill(event_ptqn.centrality(), event_ptqn.n_ch(), variance_term1);
-    registry.get<TProfile2D>(HIST("Prof_skew_t1"))->Fill(event_ptqn.centrality(), event_ptqn.n_ch(), skewness_term1);
-    registry.get<TProfile2D>(HIST("Prof_kurt_t1"))->Fill(event_ptqn.centrality(), event_ptqn.n_ch(), kurtosis_term1);
-    registry.fill(HIST("Hist2D_Nch_centrality"), event_ptqn.centrality(), event_ptqn.n_ch());
-    registry.fill(HIST("Hist2D_meanpt_centrality"), event_ptqn.centrality(), mean_term1);
+    Prof[0]->Fill(centrality, nCh, mean_term1);
+    Prof[1]->Fill(centrality, nCh, variance_term1);
+    Prof[2]->Fill(centrality, nCh, skewness_term1);
+    Prof[3]->Fill(centrality, nCh, kurtosis_term1);
+    registry.fill(HIST("Hist2D_Nch_centrality"), centrality, nCh);
+    registry.fill(HIST("Hist2D_meanpt_centrality"), centrality, mean_term1);
 
     // selecting subsample and filling profiles
     float l_Random = fRndm->Rndm();
     int SampleIndex = static_cast<int>(cfgNSubsample * l_Random);
-    Subsample[SampleIndex][0]->Fill(event_ptqn.centrality(), event_ptqn.n_ch(), mean_term1);
-    Subsample[SampleIndex][1]->Fill(event_ptqn.centrality(), event_ptqn.n_ch(), variance_term1);
-    Subsample[SampleIndex][2]->Fill(event_ptqn.centrality(), event_ptqn.n_ch(), skewness_term1);
-    Subsample[SampleIndex][3]->Fill(event_ptqn.centrality(), event_ptqn.n_ch(), kurtosis_term1);
+    Subsample[SampleIndex][0]->Fill(centrality, nCh, mean_term1);
+    Subsample[SampleIndex][1]->Fill(centrality, nCh, variance_term1);
+    Subsample[SampleIndex][2]->Fill(centrality, nCh, skewness_term1);
+    Subsample[SampleIndex][3]->Fill(centrality, nCh, kurtosis_term1);
   }
 };
 
@@ -10,6 +10,7 @@
 // or submit itself to any jurisdiction.
 
 #include <CCDB/BasicCCDBManager.h>
+#include <array>
 #include <cmath>
 #include <vector>
 #include "Framework/AnalysisTask.h"
@@ -184,8 +185,12 @@ struct NetProtonCumulants_analysis {
   Configurable<int64_t> nolaterthan{"ccdb-no-later-than", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count(), "latest acceptable timestamp of creation for the object"};
   Configurable<std::string> url{"ccdb-url", "http://ccdb-test.cern.ch:8080", "url of the ccdb repository"};
 
+  static constexpr int kNMoments = 8; // moments of the net-proton number filled in the profiles
+
   // Define output
   HistogramRegistry registry{"registry", {}, OutputObjHandlingPolicy::AnalysisObject};
+  std::array<std::shared_ptr<TProfile2D>, kNMoments> Prof2D;
+  std::array<std::shared_ptr<TProfile>, kNMoments> Prof;
   std::vector<std::vector<std::shared_ptr<TProfile2D>>> Subsample2D;
   std::vector<std::vector<std::shared_ptr<TProfile>>> Subsample;
   TRandom3* fRndm = new TRandom3(0);
@@ -195,49 +200,29 @@ struct NetProtonCumulants_analysis {
     // AxisSpec centAxis = {90, 0, 90, "centrality (%)"};
     // AxisSpec multAxis = {5000, 0.5, 5000.5, "#it{N}_{ch,acc}"};
 
-    registry.add("Prof_mu1_netproton", "", {HistType::kTProfile, {centAxis}});
-    registry.add("Prof_mu2_netproton", "", {HistType::kTProfile, {centAxis}});
-    registry.add("Prof_mu3_netproton", "", {HistType::kTProfile, {centAxis}});
-    registry.add("Prof_mu4_netproton", "", {HistType::kTProfile, {centAxis}});
-    registry.add("Prof_mu5_netproton", "", {HistType::kTProfile, {centAxis}});
-    registry.add("Prof_mu6_netproton", "", {HistType::kTProfile, {centAxis}});
-    registry.add("Prof_mu7_netproton", "", {HistType::kTProfile, {centAxis}});
-    registry.add("Prof_mu8_netproton", "", {HistType::kTProfile, {centAxis}});
-    registry.add("Prof2D_mu1_netproton", "", {HistType::kTProfile2D, {centAxis, multAxis}});
-    registry.add("Prof2D_mu2_netproton", "", {HistType::kTProfile2D, {centAxis, multAxis}});
-    registry.add("Prof2D_mu3_netproton", "", {HistType::kTProfile2D, {centAxis, multAxis}});
-    registry.add("Prof2D_mu4_netproton", "", {HistType::kTProfile2D, {centAxis, multAxis}});
-    registry.add("Prof2D_mu5_netproton", "", {HistType::kTProfile2D, {centAxis, multAxis}});
-    registry.add("Prof2D_mu6_netproton", "", {HistType::kTProfile2D, {centAxis, multAxis}});
-    registry.add("Prof2D_mu7_netproton", "", {HistType::kTProfile2D, {centAxis, multAxis}});
-    registry.add("Prof2D_mu8_netproton", "", {HistType::kTProfile2D, {centAxis, multAxis}});
+    for (int i = 0; i < kNMoments; i++) {
+      Prof[i] = std::get<std::shared_ptr<TProfile>>(registry.add(Form("Prof_mu%d_netproton", i + 1), "", {HistType::kTProfile, {centAxis}}));
+    }
+    for (int i = 0; i < kNMoments; i++) {
+      Prof2D[i] = std::get<std::shared_ptr<TProfile2D>>(registry.add(Form("Prof2D_mu%d_netproton", i + 1), "", {HistType::kTProfile2D, {centAxis, multAxis}}));
+    }
 
     // initial array
     Subsample2D.resize(cfgNSubsample);
     Subsample.resize(cfgNSubsample);
     for (int i = 0; i < cfgNSubsample; i++) {
-      Subsample2D[i].resize(8);
-      Subsample[i].resize(8);
+      Subsample2D[i].resize(kNMoments);
+      Subsample[i].resize(kNMoments);
     }
     for (int i = 0; i < cfgNSubsample; i++) {
       //! 2D profiles of moments
-      Subsample2D[i][0] = std::get<std::shared_ptr<TProfile2D>>(registry.add(Form("Subsample_%d/Prof2D_mu1_netproton", i), "", {HistType::kTProfile2D, {centAxis, multAxis}}));
-      Subsample2D[i][1] = std::get<std::shared_ptr<TProfile2D>>(registry.add(Form("Subsample_%d/Prof2D_mu2_netproton", i), "", {HistType::kTProfile2D, {centAxis, multAxis}}));
-      Subsample2D[i][2] = std::get<std::shared_ptr<TProfile2D>>(registry.add(Form("Subsample_%d/Prof2D_mu3_netproton", i), "", {HistType::kTProfile2D, {centAxis, multAxis}}));
-      Subsample2D[i][3] = std::get<std::shared_ptr<TProfile2D>>(registry.add(Form("Subsample_%d/Prof2D_mu4_netproton", i), "", {HistType::kTProfile2D, {centAxis, multAxis}}));
-      Subsample2D[i][4] = std::get<std::shared_ptr<TProfile2D>>(registry.add(Form("Subsample_%d/Prof2D_mu5_netproton", i), "", {HistType::kTProfile2D, {centAxis, multAxis}}));
-      Subsample2D[i][5] = std::get<std::shared_ptr<TProfile2D>>(registry.add(Form("Subsample_%d/Prof2D_mu6_netproton", i), "", {HistType::kTProfile2D, {centAxis, multAxis}}));
-      Subsample2D[i][6] = std::get<std::shared_ptr<TProfile2D>>(registry.add(Form("Subsample_%d/Prof2D_mu7_netproton", i), "", {HistType::kTProfile2D, {centAxis, multAxis}}));
-      Subsample2D[i][7] = std::get<std::shared_ptr<TProfile2D>>(registry.add(Form("Subsample_%d/Prof2D_mu8_netproton", i), "", {HistType::kTProfile2D, {centAxis, multAxis}}));
+      for (int j = 0; j < kNMoments; j++) {
+        Subsample2D[i][j] = std::get<std::shared_ptr<TProfile2D>>(registry.add(Form("Subsample_%d/Prof2D_mu%d_netproton", i, j + 1), "", {HistType::kTProfile2D, {centAxis, multAxis}}));
+      }
       //! 1D profiles of moments
-      Subsample[i][0] = std::get<std::shared_ptr<TProfile>>(registry.add(Form("Subsample_%d/Prof_mu1_netproton", i), "", {HistType::kTProfile, {centAxis}}));
-      Subsample[i][1] = std::get<std::shared_ptr<TProfile>>(registry.add(Form("Subsample_%d/Prof_mu2_netproton", i), "", {HistType::kTProfile, {centAxis}}));
-      Subsample[i][2] = std::get<std::shared_ptr<TProfile>>(registry.add(Form("Subsample_%d/Prof_mu3_netproton", i), "", {HistType::kTProfile, {centAxis}}));
-      Subsample[i][3] = std::get<std::shared_ptr<TProfile>>(registry.add(Form("Subsample_%d/Prof_mu4_netproton", i), "", {HistType::kTProfile, {centAxis}}));
-      Subsample[i][4] = std::get<std::shared_ptr<TProfile>>(registry.add(Form("Subsample_%d/Prof_mu5_netproton", i), "", {HistType::kTProfile, {centAxis}}));
-      Subsample[i][5] = std::get<std::shared_ptr<TProfile>>(registry.add(Form("Subsample_%d/Prof_mu6_netproton", i), "", {HistType::kTProfile, {centAxis}}));
-      Subsample[i][6] = std::get<std::shared_ptr<TProfile>>(registry.add(Form("Subsample_%d/Prof_mu7_netproton", i), "", {HistType::kTProfile, {centAxis}}));
-      Subsample[i][7] = std::get<std::shared_ptr<TProfile>>(registry.add(Form("Subsample_%d/Prof_mu8_netproton", i), "", {HistType::kTProfile, {centAxis}}));
+      for (int j = 0; j < kNMoments; j++) {
+        Subsample[i][j] = std::get<std::shared_ptr<TProfile>>(registry.add(Form("Subsample_%d/Prof_mu%d_netproton", i, j + 1), "", {HistType::kTProfile, {centAxis}}));
+      }
     }
   }
 
@@ -245,45 +230,33 @@ struct NetProtonCumulants_analysis {
   {
     // LOGF(info, "Centrality= %f Nch= %f net-proton no. = %f", event_netproton.centrality(), event_netproton.n_ch(), event_netproton.net_prot_no());
 
+    // powers of the net-proton number, computed once for all the profiles
+    const float centrality = event_netproton.centrality();
+    const float nCh = event_netproton.n_ch();
+    const double netProton = event_netproton.net_prot_no();
+    std::array<double, kNMoments> powers;
+    powers[0] = netProton;
+    for (int i = 1; i < kNMoments; i++) {
+      powers[i] = powers[i - 1] * netProton;
+    }
+
     // filling profiles for central values
-    registry.get<TProfile2D>(HIST("Prof2D_mu1_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 1.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu2_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 2.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu3_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 3.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu4_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 4.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu5_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 5.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu6_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 6.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu7_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 7.0));
-    registry.get<TProfile2D>(HIST("Prof2D_mu8_netproton"))->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 8.0));
-
-    registry.get<TProfile>(HIST("Prof_mu1_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 1.0));
-    registry.get<TProfile>(HIST("Prof_mu2_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 2.0));
-    registry.get<TProfile>(HIST("Prof_mu3_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 3.0));
-    registry.get<TProfile>(HIST("Prof_mu4_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 4.0));
-    registry.get<TProfile>(HIST("Prof_mu5_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 5.0));
-    registry.get<TProfile>(HIST("Prof_mu6_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 6.0));
-    registry.get<TProfile>(HIST("Prof_mu7_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 7.0));
-    registry.get<TProfile>(HIST("Prof_mu8_netproton"))->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 8.0));
+    for (int i = 0; i < kNMoments; i++) {
+      Prof2D[i]->Fill(centrality, nCh, powers[i]);
+    }
+    for (int i = 0; i < kNMoments; i++) {
+      Prof[i]->Fill(centrality, powers[i]);
+    }
 
     // selecting subsample and filling profiles
     float l_Random = fRndm->Rndm();
     int SampleIndex = static_cast<int>(cfgNSubsample * l_Random);
-    Subsample2D[SampleIndex][0]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 1.0));
-    Subsample2D[SampleIndex][1]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 2.0));
-    Subsample2D[SampleIndex][2]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 3.0));
-    Subsample2D[SampleIndex][3]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 4.0));
-    Subsample2D[SampleIndex][4]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 5.0));
-    Subsample2D[SampleIndex][5]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 6.0));
-    Subsample2D[SampleIndex][6]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 7.0));
-    Subsample2D[SampleIndex][7]->Fill(event_netproton.centrality(), event_netproton.n_ch(), pow(event_netproton.net_prot_no(), 8.0));
-
-    Subsample[SampleIndex][0]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 1.0));
-    Subsample[SampleIndex][1]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 2.0));
-    Subsample[SampleIndex][2]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 3.0));
-    Subsample[SampleIndex][3]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 4.0));
-    Subsample[SampleIndex][4]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 5.0));
-    Subsample[SampleIndex][5]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 6.0));
-    Subsample[SampleIndex][6]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 7.0));
-    Subsample[SampleIndex][7]->Fill(event_netproton.centrality(), pow(event_netproton.net_prot_no(), 8.0));
+    for (int i = 0; i < kNMoments; i++) {
+      Subsample2D[SampleIndex][i]->Fill(centrality, nCh, powers[i]);
+    }
+    for (int i = 0; i < kNMoments; i++) {
+      Subsample[SampleIndex][i]->Fill(centrality, powers[i]);
+    }
   }
 };
 
@@ -13,6 +13,7 @@
 /// \author Sofia Tomassini, Gleb Romanenko, Nicolò Jacazio
 /// \since 31 May 2023
 
+#include <algorithm>
 #include <vector>
 #include <TParameter.h>
 #include <TH1F.h>
@@ -100,9 +101,10 @@ struct FemtoCorrelations {
   typedef std::shared_ptr<soa::Filtered<FilteredTracks>::iterator> trkType;
   typedef std::shared_ptr<soa::Filtered<FilteredCollisions>::iterator> colType;
 
-  std::map<int64_t, std::vector<trkType>> selectedtracks_1;
-  std::map<int64_t, std::vector<trkType>> selectedtracks_2;
-  std::map<std::pair<int, float>, std::vector<colType>> mixbins;
+  std::vector<std::vector<trkType>> selectedtracks_1; // selected particles1 per collision, indexed by the collision index
+  std::vector<std::vector<trkType>> selectedtracks_2; // selected particles2 per collision, indexed by the collision index
+  std::vector<std::vector<colType>> mixbins;          // collisions per vertex&mult bin, indexed by getMixBin
+  int nCentBinsToMix = 0;                             // number of mult bins times the number of mult sub-bins
 
   std::unique_ptr<o2::aod::singletrackselector::FemtoPair<trkType>> Pair = std::make_unique<o2::aod::singletrackselector::FemtoPair<trkType>>();
 
@@ -142,6 +144,9 @@ struct FemtoCorrelations {
 
     IsIdentical = (_sign_1 * _particlePDG_1 == _sign_2 * _particlePDG_2);
 
+    nCentBinsToMix = (_centBins.value.size() - 1) * std::max(1, _multNsubBins.value);
+    mixbins.resize(_vertexNbinsToMix * nCentBinsToMix);
+
     Pair->SetIdentical(IsIdentical);
     Pair->SetPDG1(_particlePDG_1);
     Pair->SetPDG2(_particlePDG_2);
@@ -205,6 +210,23 @@ struct FemtoCorrelations {
     }
   }
 
+  /// dense index of the vertex&mult bin of a collision (vertex bins outer, mult bins and sub-bins inner), -1 if outside the binning
+  template <typename Type>
+  int getMixBin(Type const& collision)
+  {
+    int vertexBinToMix = std::floor((collision.posZ() + _vertexZ) / (2 * _vertexZ / _vertexNbinsToMix));
+    int centBin = o2::aod::singletrackselector::getBinIndex<int>(collision.multPerc(), _centBins);
+    if (vertexBinToMix < 0 || vertexBinToMix >= _vertexNbinsToMix || centBin < 0)
+      return -1;
+
+    int centSubBin = 0;
+    if (_multNsubBins > 1) {
+      float subBinWidth = (_centBins.value[centBin + 1] - _centBins.value[centBin]) / _multNsubBins;
+      centSubBin = std::min(static_cast<int>(std::floor((collision.multPerc() - _centBins.value[centBin]) / subBinWidth)), _multNsubBins - 1);
+    }
+    return vertexBinToMix * nCentBinsToMix + centBin * std::max(1, _multNsubBins.value) + centSubBin;
+  }
+
   template <typename Type>
   void mixTracks(Type const& tracks, int multBin)
   { // template for identical particles from the same collision
@@ -312,6 +334,10 @@ struct FemtoCorrelations {
     if (_particlePDG_1 == 0 || _particlePDG_2 == 0)
       LOGF(fatal, "One of passed PDG is 0!!!");
 
+    selectedtracks_1.resize(collisions.tableSize());
+    if (!IsIdentical)
+      selectedtracks_2.resize(collisions.tableSize());
+
     for (auto track : tracks) {
       if (abs(track.singleCollSel().posZ()) > _vertexZ)
         continue;
@@ -371,39 +397,41 @@ struct FemtoCorrelations {
       if (collision.multPerc() < *_centBins.value.begin() || collision.multPerc() > *(_centBins.value.end() - 1))
         continue;
 
-      if (selectedtracks_1.find(collision.globalIndex()) == selectedtracks_1.end()) {
+      if (selectedtracks_1[collision.globalIndex()].empty()) {
         if (IsIdentical)
           continue;
-        else if (selectedtracks_2.find(collision.globalIndex()) == selectedtracks_2.end())
+        else if (selectedtracks_2[collision.globalIndex()].empty())
           continue;
       }
-      int vertexBinToMix = std::floor((collision.posZ() + _vertexZ) / (2 * _vertexZ / _vertexNbinsToMix));
-      float centBinToMix = o2::aod::singletrackselector::getBinIndex<float>(collision.multPerc(), _centBins, _multNsubBins);
+      int mixBin = getMixBin(collision);
+      if (mixBin < 0)
+        continue;
 
-      mixbins[std::pair<int, float>{vertexBinToMix, centBinToMix}].push_back(std::make_shared<decltype(collision)>(collision));
+      mixbins[mixBin].push_back(std::make_shared<decltype(collision)>(collision));
     }
 
     //====================================== mixing starts here ======================================
 
     if (IsIdentical) { //====================================== mixing identical ======================================
 
-      for (auto i = mixbins.begin(); i != mixbins.end(); i++) { // iterating over all vertex&mult bins
+      for (int mixBin = 0; mixBin < mixbins.size(); mixBin++) { // iterating over all vertex&mult bins
+        auto& bin = mixbins[mixBin];
+        int centBin = (mixBin % nCentBinsToMix) / std::max(1, _multNsubBins.value);
 
-        for (int indx1 = 0; indx1 < (i->second).size(); indx1++) { // loop over all the events in each vertex&mult bin
+        for (int indx1 = 0; indx1 < bin.size(); indx1++) { // loop over all the events in each vertex&mult bin
 
-          auto col1 = (i->second)[indx1];
+          auto col1 = bin[indx1];
 
           Pair->SetMagField1(col1->magField());
           Pair->SetMagField2(col1->magField());
 
-          int centBin = std::floor((i->first).second);
           MultHistos[centBin]->Fill(col1->mult());
 
           mixTracks(selectedtracks_1[col1->index()], centBin); // mixing SE identical
 
-          for (int indx2 = indx1 + 1; indx2 < (i->second).size(); indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
+          for (int indx2 = indx1 + 1; indx2 < bin.size(); indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
 
-            auto col2 = (i->second)[indx2];
+            auto col2 = bin[indx2];
 
             Pair->SetMagField2(col2->magField());
             mixTracks<1>(selectedtracks_1[col1->index()], selectedtracks_1[col2->index()], centBin); // mixing ME identical, in <> brackets: 0 -- SE; 1 -- ME
@@ -413,23 +441,24 @@ struct FemtoCorrelations {
 
     } else { //====================================== mixing non-identical ======================================
 
-      for (auto i = mixbins.begin(); i != mixbins.end(); i++) { // iterating over all vertex&mult bins
+      for (int mixBin = 0; mixBin < mixbins.size(); mixBin++) { // iterating over all vertex&mult bins
+        auto& bin = mixbins[mixBin];
+        int centBin = (mixBin % nCentBinsToMix) / std::max(1, _multNsubBins.value);
 
-        for (int indx1 = 0; indx1 < (i->second).size(); indx1++) { // loop over all the events in each vertex&mult bin
+        for (int indx1 = 0; indx1 < bin.size(); indx1++) { // loop over all the events in each vertex&mult bin
 
-          auto col1 = (i->second)[indx1];
+          auto col1 = bin[indx1];
 
           Pair->SetMagField1(col1->magField());
           Pair->SetMagField2(col1->magField());
 
-          int centBin = std::floor((i->first).second);
           MultHistos[centBin]->Fill(col1->mult());
 
           mixTracks<0>(selectedtracks_1[col1->index()], selectedtracks_2[col1->index()], centBin); // mixing SE non-identical, in <> brackets: 0 -- SE; 1 -- ME
 
-          for (int indx2 = indx1 + 1; indx2 < (i->second).size(); indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
+          for (int indx2 = indx1 + 1; indx2 < bin.size(); indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
 
-            auto col2 = (i->second)[indx2];
+            auto col2 = bin[indx2];
 
             Pair->SetMagField2(col2->magField());
             mixTracks<1>(selectedtracks_1[col1->index()], selectedtracks_2[col2->index()], centBin); // mixing ME non-identical, in <> brackets: 0 -- SE; 1 -- ME
@@ -439,20 +468,17 @@ struct FemtoCorrelations {
 
     } //====================================== end of mixing non-identical ======================================
 
-    // clearing up
-    for (auto i = selectedtracks_1.begin(); i != selectedtracks_1.end(); i++)
-      (i->second).clear();
-    selectedtracks_1.clear();
+    // clearing up, keeping the allocated pools for the next data frame
+    for (auto& tracksOfCol : selectedtracks_1)
+      tracksOfCol.clear();
 
     if (!IsIdentical) {
-      for (auto i = selectedtracks_2.begin(); i != selectedtracks_2.end(); i++)
-        (i->second).clear();
-      selectedtracks_2.clear();
+      for (auto& tracksOfCol : selectedtracks_2)
+        tracksOfCol.clear();
     }
 
-    for (auto i = mixbins.begin(); i != mixbins.end(); i++)
-      (i->second).clear();
-    mixbins.clear();
+    for (auto& bin : mixbins)
+      bin.clear();
   }
 };
 
@@ -16,11 +16,13 @@
 #ifndef PWGCF_FEMTODREAM_CORE_FEMTODREAMDETADPHISTAR_H_
 #define PWGCF_FEMTODREAM_CORE_FEMTODREAMDETADPHISTAR_H_
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
 #include "PWGCF/DataModel/FemtoDerived.h"
 #include "Framework/HistogramRegistry.h"
+#include "PWGCF/Core/FemtoPairMath.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -140,8 +142,6 @@ class FemtoDreamDetaDphiStar
   static constexpr o2::aod::femtodreamparticle::ParticleType mPartOneType = partOne; ///< Type of particle 1
   static constexpr o2::aod::femtodreamparticle::ParticleType mPartTwoType = partTwo; ///< Type of particle 2
 
-  static constexpr float tmpRadiiTPC[9] = {85., 105., 125., 145., 165., 185., 205., 225., 245.};
-
   static constexpr uint32_t kSignMinusMask = 1;
   static constexpr uint32_t kSignPlusMask = 1 << 1;
   static constexpr uint32_t kValue0 = 0;
@@ -154,13 +154,22 @@ class FemtoDreamDetaDphiStar
   std::array<std::array<std::shared_ptr<TH2>, 2>, 2> histdetadpi{};
   std::array<std::array<std::shared_ptr<TH2>, 9>, 2> histdetadpiRadii{};
 
-  ///  Calculate phi at all required radii stored in tmpRadiiTPC
+  /// phi* of a particle at all the radii of femto::radiiTPC, kept so that it is computed once per particle
+  /// instead of once per pair. The entry is recomputed when the particle at this index or the field differ.
+  struct PhiStarAtRadii {
+    float pt = -1.f;
+    float phi = 0.f;
+    float charge = 0.f;
+    float magfield = 0.f;
+    std::array<float, 9> phiStar{};
+  };
+  std::vector<PhiStarAtRadii> mPhiStarCache; ///< phi* per particle, indexed by the global index of the particle
+
+  ///  Calculate phi at all required radii stored in femto::radiiTPC
   /// Magnetic field to be provided in Tesla
   template <typename T>
-  void PhiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
+  std::array<float, 9> PhiAtRadiiTPC(const T& part)
   {
-
-    float phi0 = part.phi();
     // Start: Get the charge from cutcontainer using masks
     float charge = 0.;
     if ((part.cut() & kSignMinusMask) == kValue0 && (part.cut() & kSignPlusMask) == kValue0) {
@@ -173,24 +182,35 @@ class FemtoDreamDetaDphiStar
       LOG(fatal) << "FemtoDreamDetaDphiStar: Charge bits are set wrong!";
     }
     // End: Get the charge from cutcontainer using masks
+    const size_t index = part.globalIndex();
+    if (index >= mPhiStarCache.size()) {
+      mPhiStarCache.resize(index + 1);
+    }
+    auto& entry = mPhiStarCache[index];
+    float phi0 = part.phi();
     float pt = part.pt();
-    for (size_t i = 0; i < 9; i++) {
-      tmpVec.push_back(phi0 - std::asin(0.3 * charge * 0.1 * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt)));
+    if (entry.pt != pt || entry.phi != phi0 || entry.charge != charge || entry.magfield != magfield) {
+      entry.pt = pt;
+      entry.phi = phi0;
+      entry.charge = charge;
+      entry.magfield = magfield;
+      for (size_t i = 0; i < 9; i++) {
+        entry.phiStar[i] = femto::getPhiStar(phi0, charge, pt, magfield, femto::radiiTPC[i]);
+      }
     }
+    return entry.phiStar;
   }
 
   ///  Calculate average phi
   template <typename T1, typename T2>
   float AveragePhiStar(const T1& part1, const T2& part2, int iHist)
   {
-    std::vector<float> tmpVec1;
-    std::vector<float> tmpVec2;
-    PhiAtRadiiTPC(part1, tmpVec1);
-    PhiAtRadiiTPC(part2, tmpVec2);
-    int num = tmpVec1.size();
+    const auto phiStar1 = PhiAtRadiiTPC(part1);
+    const auto phiStar2 = PhiAtRadiiTPC(part2);
+    int num = phiStar1.size();
     float dPhiAvg = 0;
     for (int i = 0; i < num; i++) {
-      float dphi = tmpVec1.at(i) - tmpVec2.at(i);
+      float dphi = phiStar1[i] - phiStar2[i];
       dphi = TVector2::Phi_mpi_pi(dphi);
       dPhiAvg += dphi;
       if (plotForEveryRadii) {
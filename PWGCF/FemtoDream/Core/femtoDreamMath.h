@@ -23,6 +23,8 @@
 #include "TLorentzVector.h"
 #include "TMath.h"
 
+#include "PWGCF/Core/FemtoPairMath.h"
+
 namespace o2::analysis::femtoDream
 {
 
@@ -40,24 +42,7 @@ class FemtoDreamMath
   template <typename T>
   static float getkstar(const T& part1, const float mass1, const T& part2, const float mass2)
   {
-    const ROOT::Math::PtEtaPhiMVector vecpart1(part1.pt(), part1.eta(), part1.phi(), mass1);
-    const ROOT::Math::PtEtaPhiMVector vecpart2(part2.pt(), part2.eta(), part2.phi(), mass2);
-    const ROOT::Math::PtEtaPhiMVector trackSum = vecpart1 + vecpart2;
-
-    const float beta = trackSum.Beta();
-    const float betax = beta * std::cos(trackSum.Phi()) * std::sin(trackSum.Theta());
-    const float betay = beta * std::sin(trackSum.Phi()) * std::sin(trackSum.Theta());
-    const float betaz = beta * std::cos(trackSum.Theta());
-
-    ROOT::Math::PxPyPzMVector PartOneCMS(vecpart1);
-    ROOT::Math::PxPyPzMVector PartTwoCMS(vecpart2);
-
-    const ROOT::Math::Boost boostPRF = ROOT::Math::Boost(-betax, -betay, -betaz);
-    PartOneCMS = boostPRF(PartOneCMS);
-    PartTwoCMS = boostPRF(PartTwoCMS);
-
-    const ROOT::Math::PxPyPzMVector trackRelK = PartOneCMS - PartTwoCMS;
-    return 0.5 * trackRelK.P();
+    return femto::getkstar(part1.pt(), part1.eta(), part1.phi(), mass1, part2.pt(), part2.eta(), part2.phi(), mass2);
   }
   /// Compute the qij of a pair of particles
   /// \tparam T type of tracks
@@ -119,10 +104,7 @@ class FemtoDreamMath
   template <typename T>
   static float getkT(const T& part1, const float mass1, const T& part2, const float mass2)
   {
-    const ROOT::Math::PtEtaPhiMVector vecpart1(part1.pt(), part1.eta(), part1.phi(), mass1);
-    const ROOT::Math::PtEtaPhiMVector vecpart2(part2.pt(), part2.eta(), part2.phi(), mass2);
-    const ROOT::Math::PtEtaPhiMVector trackSum = vecpart1 + vecpart2;
-    return 0.5 * trackSum.Pt();
+    return femto::getkT(part1.pt(), part1.phi(), part2.pt(), part2.phi());
   }
 
   /// Compute the transverse mass of a pair of particles
@@ -134,7 +116,16 @@ class FemtoDreamMath
   template <typename T>
   static float getmT(const T& part1, const float mass1, const T& part2, const float mass2)
   {
-    return std::sqrt(std::pow(getkT(part1, mass1, part2, mass2), 2.) + std::pow(0.5 * (mass1 + mass2), 2.));
+    return getmT(getkT(part1, mass1, part2, mass2), mass1, mass2);
+  }
+
+  /// Compute the transverse mass of a pair of particles from its transverse momentum
+  /// \param kT Transverse momentum of the pair
+  /// \param mass1 Mass of particle 1
+  /// \param mass2 Mass of particle 2
+  static float getmT(const float kT, const float mass1, const float mass2)
+  {
+    return femto::getmT(kT, mass1, mass2);
   }
 };
 
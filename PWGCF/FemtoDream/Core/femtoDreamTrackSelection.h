@@ -17,6 +17,7 @@
 #ifndef PWGCF_FEMTODREAM_CORE_FEMTODREAMTRACKSELECTION_H_
 #define PWGCF_FEMTODREAM_CORE_FEMTODREAMTRACKSELECTION_H_
 
+#include <array>
 #include <string>
 #include <vector>
 #include <cmath>
@@ -246,6 +247,8 @@ class FemtoDreamTrackSelection : public FemtoDreamObjectSelection<float, femtoDr
   float nSigmaPIDOffsetTPC;
   float nSigmaPIDOffsetTOF;
   std::vector<o2::track::PID> mPIDspecies; ///< All the particle species for which the n_sigma values need to be stored
+  std::vector<float> mPIDTPCValues;        ///< TPC n_sigma values of the current track for the PID species, reused across tracks
+  std::vector<float> mPIDCombValues;       ///< Combined TPC and TOF n_sigma values of the current track for the PID species, reused across tracks
   static constexpr int kNtrackSelection = 14;
   static constexpr std::string_view mSelectionNames[kNtrackSelection] = {"Sign",
                                                                          "PtMin",
@@ -421,11 +424,6 @@ bool FemtoDreamTrackSelection::isSelectedMinimal(T const& track)
   const auto dcaZ = track.dcaZ();
   const auto dca = track.dcaXY(); // Accordingly to FemtoDream in AliPhysics  as well as LF analysis,
                                   // only dcaXY should be checked; NOT std::sqrt(pow(dcaXY, 2.) + pow(dcaZ, 2.))
-  std::vector<float> pidTPC, pidTOF;
-  for (auto it : mPIDspecies) {
-    pidTPC.push_back(getNsigmaTPC(track, it));
-    pidTOF.push_back(getNsigmaTOF(track, it));
-  }
 
   if (nPtMinSel > 0 && pT < pTMin) {
     return false;
@@ -468,11 +466,12 @@ bool FemtoDreamTrackSelection::isSelectedMinimal(T const& track)
   }
 
   if (nPIDnSigmaSel > 0) {
+    /// the n_sigma values are only obtained once the other minimal selections are fulfilled
     bool isFulfilled = false;
-    for (size_t i = 0; i < pidTPC.size(); ++i) {
-      auto pidTPCVal = pidTPC.at(i);
-      if (std::abs(pidTPCVal - nSigmaPIDOffsetTPC) < nSigmaPIDMax) {
+    for (auto it : mPIDspecies) {
+      if (std::abs(getNsigmaTPC(track, it) - nSigmaPIDOffsetTPC) < nSigmaPIDMax) {
         isFulfilled = true;
+        break;
       }
     }
     if (!isFulfilled) {
@@ -497,72 +496,44 @@ std::array<cutContainerType, 2> FemtoDreamTrackSelection::getCutContainer(T cons
   const auto tpcNClsS = track.tpcNClsShared();
   const auto itsNCls = track.itsNCls();
   const auto itsNClsIB = track.itsNClsInnerBarrel();
-  const auto dcaXY = track.dcaXY();
-  const auto dcaZ = track.dcaZ();
-  const auto dca = Dca;
 
-  std::vector<float> pidTPC, pidTOF;
+  /// the observables are obtained once per track, indexed by the selection variable
+  std::array<float, kNtrackSelection> observables{};
+  observables[femtoDreamTrackSelection::kSign] = sign;
+  observables[femtoDreamTrackSelection::kpTMin] = pt;
+  observables[femtoDreamTrackSelection::kpTMax] = pt;
+  observables[femtoDreamTrackSelection::kEtaMax] = eta;
+  observables[femtoDreamTrackSelection::kTPCnClsMin] = tpcNClsF;
+  observables[femtoDreamTrackSelection::kTPCfClsMin] = tpcRClsC;
+  observables[femtoDreamTrackSelection::kTPCcRowsMin] = tpcNClsC;
+  observables[femtoDreamTrackSelection::kTPCsClsMax] = tpcNClsS;
+  observables[femtoDreamTrackSelection::kITSnClsMin] = itsNCls;
+  observables[femtoDreamTrackSelection::kITSnClsIbMin] = itsNClsIB;
+  observables[femtoDreamTrackSelection::kDCAxyMax] = track.dcaXY();
+  observables[femtoDreamTrackSelection::kDCAzMax] = track.dcaZ();
+  observables[femtoDreamTrackSelection::kDCAMin] = Dca;
+
+  /// the n_sigma values, with their offsets, are obtained once per track for all the PID selections
+  mPIDTPCValues.clear();
+  mPIDCombValues.clear();
   for (auto it : mPIDspecies) {
-    pidTPC.push_back(getNsigmaTPC(track, it));
-    pidTOF.push_back(getNsigmaTOF(track, it));
+    auto pidTPCVal = getNsigmaTPC(track, it) - nSigmaPIDOffsetTPC;
+    auto pidTOFVal = getNsigmaTOF(track, it) - nSigmaPIDOffsetTOF;
+    mPIDTPCValues.push_back(pidTPCVal);
+    mPIDCombValues.push_back(std::sqrt(pidTPCVal * pidTPCVal + pidTOFVal * pidTOFVal));
   }
 
-  float observable = 0.;
   for (auto& sel : mSelections) {
     const auto selVariable = sel.getSelectionVariable();
     if (selVariable == femtoDreamTrackSelection::kPIDnSigmaMax) {
       /// PID needs to be handled a bit differently since we may need more than one species
       for (size_t i = 0; i < mPIDspecies.size(); ++i) {
-        auto pidTPCVal = pidTPC.at(i) - nSigmaPIDOffsetTPC;
-        auto pidTOFVal = pidTOF.at(i) - nSigmaPIDOffsetTOF;
-        auto pidComb = std::sqrt(pidTPCVal * pidTPCVal + pidTOFVal * pidTOFVal);
-        sel.checkSelectionSetBitPID(pidTPCVal, outputPID);
-        sel.checkSelectionSetBitPID(pidComb, outputPID);
+        sel.checkSelectionSetBitPID(mPIDTPCValues[i], outputPID);
+        sel.checkSelectionSetBitPID(mPIDCombValues[i], outputPID);
       }
     } else {
       /// for the rest it's all the same
-      switch (selVariable) {
-        case (femtoDreamTrackSelection::kSign):
-          observable = sign;
-          break;
-        case (femtoDreamTrackSelection::kpTMin):
-        case (femtoDreamTrackSelection::kpTMax):
-          observable = pt;
-          break;
-        case (femtoDreamTrackSelection::kEtaMax):
-          observable = eta;
-          break;
-        case (femtoDreamTrackSelection::kTPCnClsMin):
-          observable = tpcNClsF;
-          break;
-        case (femtoDreamTrackSelection::kTPCfClsMin):
-          observable = tpcRClsC;
-          break;
-        case (femtoDreamTrackSelection::kTPCcRowsMin):
-          observable = tpcNClsC;
-          break;
-        case (femtoDreamTrackSelection::kTPCsClsMax):
-          observable = tpcNClsS;
-          break;
-        case (femtoDreamTrackSelection::kITSnClsMin):
-          observable = itsNCls;
-          break;
-        case (femtoDreamTrackSelection::kITSnClsIbMin):
-          observable = itsNClsIB;
-          break;
-        case (femtoDreamTrackSelection::kDCAxyMax):
-          observable = dcaXY;
-          break;
-        case (femtoDreamTrackSelection::kDCAzMax):
-          observable = dcaZ;
-          break;
-        case (femtoDreamTrackSelection::kDCAMin):
-          observable = dca;
-          break;
-        case (femtoDreamTrackSelection::kPIDnSigmaMax):
-          break;
-      }
-      sel.checkSelectionSetBit(observable, output, counter, mHistogramRegistry);
+      sel.checkSelectionSetBit(observables[selVariable], output, counter, mHistogramRegistry);
     }
   }
   return {output, outputPID};
@@ -395,7 +395,7 @@ struct femtoDreamProducerTask {
       }
       trackCuts.fillQA<aod::femtodreamparticle::ParticleType::kTrack, aod::femtodreamparticle::TrackType::kNoChild>(track);
       // the bit-wise container of the systematic variations is obtained
-      auto cutContainer = trackCuts.getCutContainer<aod::femtodreamparticle::cutContainerType>(track, track.pt(), track.eta(), sqrtf(powf(track.dcaXY(), 2.f) + powf(track.dcaZ(), 2.f)));
+      auto cutContainer = trackCuts.getCutContainer<aod::femtodreamparticle::cutContainerType>(track, track.pt(), track.eta(), std::sqrt(track.dcaXY() * track.dcaXY() + track.dcaZ() * track.dcaZ()));
 
       // now the table is filled
       outputParts(outputCollision.lastIndex(),
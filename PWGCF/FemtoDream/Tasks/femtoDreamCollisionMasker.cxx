@@ -26,6 +26,7 @@
 #include "Framework/RunningWorkflowInfo.h"
 
 #include "PWGCF/DataModel/FemtoDerived.h"
+#include "PWGCF/FemtoDream/Core/femtoDreamUtils.h"
 
 using namespace o2;
 using namespace o2::aod;
@@ -42,6 +43,7 @@ enum Parts {
 enum Tasks {
   kTrackTrack,
   kTrackV0,
+  kTrackTrackTrack,
   kNTasks,
 };
 } // namespace CollisionMasks
@@ -79,6 +81,14 @@ struct femoDreamCollisionMasker {
   std::array<std::vector<float>, CollisionMasks::kNParts> FilterInvMassAntiMin;
   std::array<std::vector<float>, CollisionMasks::kNParts> FilterInvMassAntiMax;
 
+  // track selection of the triplet task, with the pid selection on the number of sigmas
+  std::array<std::vector<float>, CollisionMasks::kNParts> FilterPMax;
+  std::array<std::vector<int>, CollisionMasks::kNParts> TrackPIDSpecies;
+  std::array<std::vector<int>, CollisionMasks::kNParts> TrackPIDNSpecies;
+  std::array<std::vector<std::vector<float>>, CollisionMasks::kNParts> TrackPIDNSigmaMax;
+  std::array<std::vector<float>, CollisionMasks::kNParts> TrackPIDNSigmaTPC;
+  std::array<std::vector<float>, CollisionMasks::kNParts> TrackPIDNSigmaTPCTOF;
+
   int TaskFinder = -1;
 
   void init(InitContext& context)
@@ -89,7 +99,42 @@ struct femoDreamCollisionMasker {
     LOG(info) << "*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*";
     auto& workflows = context.services().get<RunningWorkflowInfo const>();
     for (DeviceSpec const& device : workflows.devices) {
-      if (device.name.find("femto-dream-pair-task-track-track") != std::string::npos) {
+      if (device.name.find("femto-dream-pair-task-track-track-track") != std::string::npos) {
+        // checked first, since the name of the pair-track-track task is contained in the name of the triplet task
+        LOG(info) << "Matched workflow: " << device.name;
+        TaskFinder = CollisionMasks::kTrackTrackTrack;
+        femtodreamparticle::cutContainerType cutBit = 0;
+        int pidSpecies = 0;
+        int nSpecies = 0;
+        std::vector<float> nSigmaMax;
+        LabeledArray<float> cutTable;
+        for (auto const& option : device.options) {
+          if (option.name.compare(std::string("ConfCutPart")) == 0) {
+            cutBit = option.defaultValue.get<femtodreamparticle::cutContainerType>();
+          } else if (option.name.compare(std::string("ConfPIDPart")) == 0) {
+            pidSpecies = option.defaultValue.get<int>();
+          } else if (option.name.compare(std::string("ConfNspecies")) == 0) {
+            nSpecies = option.defaultValue.get<int>();
+          } else if (option.name.compare(std::string("ConfTrkPIDnSigmaMax")) == 0) {
+            nSigmaMax = option.defaultValue.get<std::vector<float>>();
+          } else if (option.name.compare(std::string("ConfCutTable")) == 0) {
+            cutTable = option.defaultValue.get<LabeledArray<float>>();
+          }
+        }
+        // the three particles share the cut and pid bits, but have their own row in the cut table
+        const std::array<std::string, CollisionMasks::kNParts> partNames{"PartOne", "PartTwo", "PartThree"};
+        for (int P = CollisionMasks::kPartOne; P < CollisionMasks::kNParts; P++) {
+          TrackCutBits.at(P).push_back(cutBit);
+          TrackPIDSpecies.at(P).push_back(pidSpecies);
+          TrackPIDNSpecies.at(P).push_back(nSpecies);
+          TrackPIDNSigmaMax.at(P).push_back(nSigmaMax);
+          FilterPtMax.at(P).push_back(cutTable.get(partNames.at(P).c_str(), "MaxPt"));
+          FilterPMax.at(P).push_back(cutTable.get(partNames.at(P).c_str(), "MaxP"));
+          TrackPIDThreshold.at(P).push_back(cutTable.get(partNames.at(P).c_str(), "PIDthr"));
+          TrackPIDNSigmaTPC.at(P).push_back(cutTable.get(partNames.at(P).c_str(), "nSigmaTPC"));
+          TrackPIDNSigmaTPCTOF.at(P).push_back(cutTable.get(partNames.at(P).c_str(), "nSigmaTPCTOF"));
+        }
+      } else if (device.name.find("femto-dream-pair-task-track-track") != std::string::npos) {
         LOG(info) << "Matched workflow: " << device.name;
         TaskFinder = CollisionMasks::kTrackTrack;
         for (auto const& option : device.options) {
@@ -217,6 +262,35 @@ struct femoDreamCollisionMasker {
     }
   }
 
+  // make bitmask for a track of the triplet task, with the same selection as femtoDreamPairTaskTrackTrackTrack
+  template <typename T, typename R>
+  void MaskForTripletTrack(T& BitSet, CollisionMasks::Parts P, R& track)
+  {
+    if (track.partType() != static_cast<uint8_t>(femtodreamparticle::kTrack)) {
+      return;
+    }
+    for (size_t index = 0; index < TrackCutBits.at(P).size(); index++) {
+      if (BitSet.at(P).test(index)) {
+        // the collision already has a particle passing this selection
+        continue;
+      }
+      if ((track.cut() & TrackCutBits.at(P).at(index)) != TrackCutBits.at(P).at(index) ||
+          track.pt() > FilterPtMax.at(P).at(index) || track.p() > FilterPMax.at(P).at(index)) {
+        continue;
+      }
+      if (o2::analysis::femtoDream::isFullPIDSelected(track.pidcut(),
+                                                      track.p(),
+                                                      TrackPIDThreshold.at(P).at(index),
+                                                      TrackPIDSpecies.at(P).at(index),
+                                                      TrackPIDNSpecies.at(P).at(index),
+                                                      TrackPIDNSigmaMax.at(P).at(index),
+                                                      TrackPIDNSigmaTPC.at(P).at(index),
+                                                      TrackPIDNSigmaTPCTOF.at(P).at(index))) {
+        BitSet.at(P).set(index);
+      }
+    }
+  }
+
   // make bit mask for v0
   template <typename T, typename R, typename S>
   void MaskForV0(T& BitSet, CollisionMasks::Parts P, R& v0, S& parts)
@@ -273,6 +347,15 @@ struct femoDreamCollisionMasker {
           MaskForTrack(Mask, CollisionMasks::kPartOne, part);
           MaskForV0(Mask, CollisionMasks::kPartTwo, part, parts);
         }
+        break;
+      case CollisionMasks::kTrackTrackTrack:
+        // triplet-track-track-track task
+        // create mask for track 1, track 2 and track 3
+        for (auto const& part : parts) {
+          MaskForTripletTrack(Mask, CollisionMasks::kPartOne, part);
+          MaskForTripletTrack(Mask, CollisionMasks::kPartTwo, part);
+          MaskForTripletTrack(Mask, CollisionMasks::kPartThree, part);
+        }
         // TODO: add all supported pair/triplet tasks
         break;
       default:
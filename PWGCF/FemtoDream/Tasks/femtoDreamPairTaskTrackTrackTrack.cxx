@@ -17,6 +17,7 @@
 /// \author Laura Serksnyte, TU München, laura.serksnyte@tum.de
 
 #include <vector>
+#include <bitset>
 #include "Framework/AnalysisTask.h"
 #include "Framework/runDataProcessing.h"
 #include "Framework/HistogramRegistry.h"
@@ -56,6 +57,10 @@ struct femtoDreamPairTaskTrackTrackTrack {
   SliceCache cache;
   Preslice<aod::FDParticles> perCol = aod::femtodreamparticle::fdCollisionId;
 
+  using MaskedCollisions = soa::Join<aod::FDCollisions, aod::FDColMasks>;
+  using MaskedCollision = MaskedCollisions::iterator;
+  aod::femtodreamcollision::BitMaskType MaskBit = -1;
+
   /// Particle selection part
 
   /// Table for both particles
@@ -134,7 +139,7 @@ struct femtoDreamPairTaskTrackTrackTrack {
   HistogramRegistry resultRegistry{"Correlations", {}, OutputObjHandlingPolicy::AnalysisObject};
   HistogramRegistry MixQaRegistry{"MixQaRegistry", {}, OutputObjHandlingPolicy::AnalysisObject};
 
-  void init(InitContext&)
+  void init(InitContext& context)
   {
 
     eventHisto.init(&qaRegistry);
@@ -155,6 +160,54 @@ struct femtoDreamPairTaskTrackTrackTrack {
     // CURRENTLY do only for one species
     vPIDPart = ConfPIDPart.value;
     kNsigma = ConfTrkPIDnSigmaMax.value;
+
+    // get bit for the collision mask
+    std::bitset<8 * sizeof(aod::femtodreamcollision::BitMaskType)> mask;
+    int index = 0;
+    auto& workflows = context.services().get<RunningWorkflowInfo const>();
+    for (DeviceSpec const& device : workflows.devices) {
+      if (device.name.find("femto-dream-pair-task-track-track-track") != std::string::npos) {
+        if (containsNameValuePair(device.options, "ConfCutPart", ConfCutPart.value) &&
+            containsNameValuePair(device.options, "ConfPIDPart", ConfPIDPart.value) &&
+            containsNameValuePair(device.options, "ConfNspecies", ConfNspecies.value) &&
+            isSameCutTable(device.options)) {
+          mask.set(index);
+          MaskBit = static_cast<aod::femtodreamcollision::BitMaskType>(mask.to_ulong());
+          LOG(info) << "Device name matched: " << device.name;
+          LOG(info) << "Bitmask for collisions: " << mask.to_string();
+          break;
+        } else {
+          index++;
+        }
+      }
+    }
+    if ((doprocessSameEvent && doprocessSameEventMasked) ||
+        (doprocessMixedEvent && doprocessMixedEventMasked) ||
+        (doprocessSameEventMC && doprocessSameEventMCMasked) ||
+        (doprocessMixedEventMC && doprocessMixedEventMCMasked)) {
+      LOG(fatal) << "Normal and masked processing cannot be activated simultaneously!";
+    }
+  }
+
+  /// Checks whether the cut table of a device is the one of this task, to find the bit of the collision mask
+  template <typename T>
+  bool isSameCutTable(const std::vector<T>& options)
+  {
+    for (const auto& option : options) {
+      if (option.name != "ConfCutTable") {
+        continue;
+      }
+      const auto cutTable = option.defaultValue.template get<LabeledArray<float>>();
+      for (const auto& partName : partNames) {
+        for (const auto& cutName : cutNames) {
+          if (std::abs(cutTable.get(partName.c_str(), cutName.c_str()) - ConfCutTable->get(partName.c_str(), cutName.c_str())) > 1e-2) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+    return false;
   }
 
   template <typename CollisionType>
@@ -272,6 +325,25 @@ struct femtoDreamPairTaskTrackTrackTrack {
   }
   PROCESS_SWITCH(femtoDreamPairTaskTrackTrackTrack, processSameEvent, "Enable processing same event", true);
 
+  /// process function to call doSameEvent with Data, skipping the collisions without a selected particle for one of the three particles
+  /// \param col subscribe to the collision table joined with the collision masks (Data)
+  /// \param parts subscribe to the femtoDreamParticleTable
+  void processSameEventMasked(MaskedCollision& col,
+                              o2::aod::FDParticles& parts)
+  {
+    if ((col.bitmaskTrackOne() & MaskBit) != MaskBit || (col.bitmaskTrackTwo() & MaskBit) != MaskBit || (col.bitmaskTrackThree() & MaskBit) != MaskBit) {
+      return;
+    }
+    fillCollision(col);
+
+    auto thegroupPartsOne = partsOne->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
+    auto thegroupPartsTwo = partsTwo->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
+    auto thegroupPartsThree = partsThree->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
+
+    doSameEvent<false>(thegroupPartsOne, thegroupPartsTwo, thegroupPartsThree, parts, col.magField(), col.multNtr());
+  }
+  PROCESS_SWITCH(femtoDreamPairTaskTrackTrackTrack, processSameEventMasked, "Enable processing same event with masked collisions", false);
+
   /// process function for to call doSameEvent with Monte Carlo
   /// \param col subscribe to the collision table (Monte Carlo Reconstructed reconstructed)
   /// \param parts subscribe to joined table FemtoDreamParticles and FemtoDreamMCLables to access Monte Carlo truth
@@ -290,6 +362,27 @@ struct femtoDreamPairTaskTrackTrackTrack {
   }
   PROCESS_SWITCH(femtoDreamPairTaskTrackTrackTrack, processSameEventMC, "Enable processing same event for Monte Carlo", false);
 
+  /// process function for to call doSameEvent with Monte Carlo, skipping the collisions without a selected particle for one of the three particles
+  /// \param col subscribe to the collision table joined with the collision masks (Monte Carlo Reconstructed reconstructed)
+  /// \param parts subscribe to joined table FemtoDreamParticles and FemtoDreamMCLables to access Monte Carlo truth
+  /// \param FemtoDreamMCParticles subscribe to the Monte Carlo truth table
+  void processSameEventMCMasked(MaskedCollision& col,
+                                soa::Join<o2::aod::FDParticles, o2::aod::FDMCLabels>& parts,
+                                o2::aod::FDMCParticles&)
+  {
+    if ((col.bitmaskTrackOne() & MaskBit) != MaskBit || (col.bitmaskTrackTwo() & MaskBit) != MaskBit || (col.bitmaskTrackThree() & MaskBit) != MaskBit) {
+      return;
+    }
+    fillCollision(col);
+
+    auto thegroupPartsOne = partsOneMC->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
+    auto thegroupPartsTwo = partsTwoMC->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
+    auto thegroupPartsThree = partsThreeMC->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
+
+    doSameEvent<true>(thegroupPartsOne, thegroupPartsTwo, thegroupPartsThree, parts, col.magField(), col.multNtr());
+  }
+  PROCESS_SWITCH(femtoDreamPairTaskTrackTrackTrack, processSameEventMCMasked, "Enable processing same event for Monte Carlo with masked collisions", false);
+
   /// This function processes the mixed event
   /// \todo the trivial loops over the collisions and tracks should be factored out since they will be common to all combinations of T-T, T-V0, V0-V0, ...
   /// \tparam PartitionType
@@ -380,6 +473,36 @@ struct femtoDreamPairTaskTrackTrackTrack {
   }
   PROCESS_SWITCH(femtoDreamPairTaskTrackTrackTrack, processMixedEvent, "Enable processing mixed events", true);
 
+  /// process function for to call doMixedEvent with Data, mixing only the collisions with a selected particle for each of the three particles
+  /// @param cols subscribe to the collisions table joined with the collision masks (Data)
+  /// @param parts subscribe to the femtoDreamParticleTable
+  void processMixedEventMasked(MaskedCollisions& cols,
+                               o2::aod::FDParticles& parts)
+  {
+    // the three particles are of the same species, so that the collisions are mixed among themselves
+    Partition<MaskedCollisions> PartitionMaskedCol = ((aod::femtodreamcollision::bitmaskTrackOne & MaskBit) == MaskBit) &&
+                                                     ((aod::femtodreamcollision::bitmaskTrackTwo & MaskBit) == MaskBit) &&
+                                                     ((aod::femtodreamcollision::bitmaskTrackThree & MaskBit) == MaskBit);
+    PartitionMaskedCol.bindTable(cols);
+
+    for (auto& [collision1, collision2, collision3] : soa::selfCombinations(colBinning, 5, -1, PartitionMaskedCol, PartitionMaskedCol, PartitionMaskedCol)) {
+      const int multiplicityCol = collision1.multNtr();
+      MixQaRegistry.fill(HIST("MixingQA/hMECollisionBins"), colBinning.getBin({collision1.posZ(), multiplicityCol}));
+
+      const auto& magFieldTesla1 = collision1.magField();
+      if ((magFieldTesla1 != collision2.magField()) || (magFieldTesla1 != collision3.magField())) {
+        continue;
+      }
+
+      auto groupPartsOne = partsOne->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision1.globalIndex(), cache);
+      auto groupPartsTwo = partsTwo->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision2.globalIndex(), cache);
+      auto groupPartsThree = partsThree->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision3.globalIndex(), cache);
+
+      doMixedEvent<false>(groupPartsOne, groupPartsTwo, groupPartsThree, parts, magFieldTesla1, multiplicityCol);
+    }
+  }
+  PROCESS_SWITCH(femtoDreamPairTaskTrackTrackTrack, processMixedEventMasked, "Enable processing mixed events with masked collisions", false);
+
   /// brief process function for to call doMixedEvent with Monte Carlo
   /// @param cols subscribe to the collisions table (Monte Carlo Reconstructed reconstructed)
   /// @param parts subscribe to joined table FemtoDreamParticles and FemtoDreamMCLables to access Monte Carlo truth
@@ -410,6 +533,37 @@ struct femtoDreamPairTaskTrackTrackTrack {
     }
   }
   PROCESS_SWITCH(femtoDreamPairTaskTrackTrackTrack, processMixedEventMC, "Enable processing mixed events MC", false);
+
+  /// brief process function for to call doMixedEvent with Monte Carlo, mixing only the collisions with a selected particle for each of the three particles
+  /// @param cols subscribe to the collisions table joined with the collision masks (Monte Carlo Reconstructed reconstructed)
+  /// @param parts subscribe to joined table FemtoDreamParticles and FemtoDreamMCLables to access Monte Carlo truth
+  /// @param FemtoDreamMCParticles subscribe to the Monte Carlo truth table
+  void processMixedEventMCMasked(MaskedCollisions& cols,
+                                 soa::Join<o2::aod::FDParticles, o2::aod::FDMCLabels>& parts,
+                                 o2::aod::FDMCParticles&)
+  {
+    Partition<MaskedCollisions> PartitionMaskedCol = ((aod::femtodreamcollision::bitmaskTrackOne & MaskBit) == MaskBit) &&
+                                                     ((aod::femtodreamcollision::bitmaskTrackTwo & MaskBit) == MaskBit) &&
+                                                     ((aod::femtodreamcollision::bitmaskTrackThree & MaskBit) == MaskBit);
+    PartitionMaskedCol.bindTable(cols);
+
+    for (auto& [collision1, collision2, collision3] : soa::selfCombinations(colBinning, 5, -1, PartitionMaskedCol, PartitionMaskedCol, PartitionMaskedCol)) {
+      const int multiplicityCol = collision1.multNtr();
+      MixQaRegistry.fill(HIST("MixingQA/hMECollisionBins"), colBinning.getBin({collision1.posZ(), multiplicityCol}));
+
+      const auto& magFieldTesla1 = collision1.magField();
+      if ((magFieldTesla1 != collision2.magField()) || (magFieldTesla1 != collision3.magField())) {
+        continue;
+      }
+
+      auto groupPartsOne = partsOneMC->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision1.globalIndex(), cache);
+      auto groupPartsTwo = partsTwoMC->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision2.globalIndex(), cache);
+      auto groupPartsThree = partsThreeMC->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision3.globalIndex(), cache);
+
+      doMixedEvent<true>(groupPartsOne, groupPartsTwo, groupPartsThree, parts, magFieldTesla1, multiplicityCol);
+    }
+  }
+  PROCESS_SWITCH(femtoDreamPairTaskTrackTrackTrack, processMixedEventMCMasked, "Enable processing mixed events MC with masked collisions", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
@@ -23,6 +23,7 @@
 #include "TMath.h"
 #include "PWGCF/FemtoUniverse/DataModel/FemtoDerived.h"
 #include "Framework/HistogramRegistry.h"
+#include "PWGCF/Core/FemtoPairMath.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -213,8 +214,6 @@ class FemtoUniverseDetaDphiStar
   static constexpr o2::aod::femtouniverseparticle::ParticleType mPartOneType = partOne; ///< Type of particle 1
   static constexpr o2::aod::femtouniverseparticle::ParticleType mPartTwoType = partTwo; ///< Type of particle 2
 
-  static constexpr float tmpRadiiTPC[9] = {85., 105., 125., 145., 165., 185., 205., 225., 245.};
-
   static constexpr uint32_t kSignMinusMask = 1;
   static constexpr uint32_t kSignPlusMask = 1 << 1;
   static constexpr uint32_t kValue0 = 0;
@@ -229,7 +228,7 @@ class FemtoUniverseDetaDphiStar
   std::array<std::array<std::shared_ptr<TH2>, 2>, 2> histdetadpi{};
   std::array<std::array<std::shared_ptr<TH2>, 9>, 2> histdetadpiRadii{};
 
-  ///  Calculate phi at all required radii stored in tmpRadiiTPC
+  ///  Calculate phi at all required radii stored in femto::radiiTPC
   /// Magnetic field to be provided in Tesla
   template <typename T>
   void PhiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
@@ -250,7 +249,7 @@ class FemtoUniverseDetaDphiStar
     // End: Get the charge from cutcontainer using masks
     float pt = part.pt();
     for (size_t i = 0; i < 9; i++) {
-      tmpVec.push_back(phi0 - std::asin(0.3 * charge * 0.1 * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt)));
+      tmpVec.push_back(femto::getPhiStar(phi0, charge, pt, magfield, femto::radiiTPC[i]));
     }
   }
 
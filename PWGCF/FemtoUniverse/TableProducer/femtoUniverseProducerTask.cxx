@@ -203,6 +203,7 @@ struct femtoUniverseProducerTask {
 
   // PHI
   FemtoUniversePhiSelection phiCuts;
+  std::vector<int8_t> kaonSigns; // sign of the tracks of a collision identified as kaons, 0 for the other tracks
   struct : o2::framework::ConfigurableGroup {
     Configurable<std::vector<float>> ConfPhiSign{FemtoUniversePhiSelection::getSelectionName(femtoUniversePhiSelection::kPhiSign, "ConfPhi"), std::vector<float>{-1, 1}, FemtoUniversePhiSelection::getSelectionHelper(femtoUniversePhiSelection::kPhiSign, "Phi selection: ")};
     Configurable<std::vector<float>> ConfPhiPtMin{FemtoUniversePhiSelection::getSelectionName(femtoUniversePhiSelection::kPhipTMin, "ConfPhi"), std::vector<float>{0.3f, 0.4f, 0.5f}, FemtoUniversePhiSelection::getSelectionHelper(femtoUniversePhiSelection::kPhipTMin, "Phi selection: ")};
@@ -853,24 +854,34 @@ struct femtoUniverseProducerTask {
   {
     std::vector<int> childIDs = {0, 0}; // these IDs are necessary to keep track of the children
     std::vector<int> tmpIDtrack;        // this vector keeps track of the matching of the primary track table row <-> aod::track table global index
+    if (tracks.size() < 2) {
+      return;
+    }
+
+    // implementing PID cuts for phi children, once per track instead of once per pair
+    // the tracks of the collision are a contiguous range of the track table, so that they are indexed by their global index
+    const int64_t firstTrackIndex = tracks.begin().globalIndex();
+    kaonSigns.clear();
+    for (auto& track : tracks) {
+      kaonSigns.resize(track.globalIndex() - firstTrackIndex + 1, 0);
+      if (IsKaonNSigma(track.pt(), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon))) {
+        kaonSigns.back() = track.sign();
+      }
+    }
+
+    const float mMassOne = TDatabasePDG::Instance()->GetParticle(ConfPhiChildOne.ConfPDGCodePartOne)->Mass(); // FIXME: Get from the PDG service of the common header
+    const float mMassTwo = TDatabasePDG::Instance()->GetParticle(ConfPhiChildTwo.ConfPDGCodePartTwo)->Mass(); // FIXME: Get from the PDG service of the common header
+
     // lorentz vectors and filling the tables
     for (auto& [p1, p2] : combinations(soa::CombinationsStrictlyUpperIndexPolicy(tracks, tracks))) {
-      // implementing PID cuts for phi children
-      if (!(IsKaonNSigma(p1.pt(), trackCuts.getNsigmaTPC(p1, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(p1, o2::track::PID::Kaon)))) {
-        continue;
-      }
-      if (!(IsKaonNSigma(p2.pt(), trackCuts.getNsigmaTPC(p2, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(p2, o2::track::PID::Kaon)))) {
-        continue;
-      } else if ((!(p1.sign() == 1)) || (!(p2.sign() == -1))) {
+      // positive kaon first and negative kaon second
+      if (kaonSigns[p1.globalIndex() - firstTrackIndex] != 1 || kaonSigns[p2.globalIndex() - firstTrackIndex] != -1) {
         continue;
       }
 
       TLorentzVector part1Vec;
       TLorentzVector part2Vec;
 
-      float mMassOne = TDatabasePDG::Instance()->GetParticle(ConfPhiChildOne.ConfPDGCodePartOne)->Mass(); // FIXME: Get from the PDG service of the common header
-      float mMassTwo = TDatabasePDG::Instance()->GetParticle(ConfPhiChildTwo.ConfPDGCodePartTwo)->Mass(); // FIXME: Get from the PDG service of the common header
-
       part1Vec.SetPtEtaPhiM(p1.pt(), p1.eta(), p1.phi(), mMassOne);
       part2Vec.SetPtEtaPhiM(p2.pt(), p2.eta(), p2.phi(), mMassTwo);
 
@@ -300,6 +300,16 @@ struct femtoUniversePairTaskTrackD0 {
     }
   }
 
+  /// @returns whether the track passes the PID selection, in case the tracks are identified
+  template <typename T>
+  bool isTrackSelected(const T& track)
+  {
+    if (!ConfTrack.ConfIsTrackIdentified) {
+      return true;
+    }
+    return IsParticleNSigma(track.p(), trackCuts.getNsigmaTPC(track, o2::track::PID::Proton), trackCuts.getNsigmaTOF(track, o2::track::PID::Proton), trackCuts.getNsigmaTPC(track, o2::track::PID::Pion), trackCuts.getNsigmaTOF(track, o2::track::PID::Pion), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon));
+  }
+
   void init(InitContext&)
   {
     eventHisto.init(&qaRegistry);
@@ -411,34 +421,33 @@ struct femtoUniversePairTaskTrackD0 {
 
     if (!ConfTrack.ConfIsSame) {
       for (auto& track : groupPartsTrack) {
-        if (ConfTrack.ConfIsTrackIdentified) {
-          if (!IsParticleNSigma(track.p(), trackCuts.getNsigmaTPC(track, o2::track::PID::Proton), trackCuts.getNsigmaTOF(track, o2::track::PID::Proton), trackCuts.getNsigmaTPC(track, o2::track::PID::Pion), trackCuts.getNsigmaTOF(track, o2::track::PID::Pion), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon))) {
-            continue;
-          }
+        if (!isTrackSelected(track)) {
+          continue;
         }
         trackHistoPartTrack.fillQA<isMC, false>(track);
       }
     }
     /// Now build the combinations
-    for (auto& [track, d0candidate] : combinations(CombinationsFullIndexPolicy(groupPartsTrack, groupPartsD0))) {
-      if (ConfTrack.ConfIsTrackIdentified) {
-        if (!IsParticleNSigma(track.p(), trackCuts.getNsigmaTPC(track, o2::track::PID::Proton), trackCuts.getNsigmaTOF(track, o2::track::PID::Proton), trackCuts.getNsigmaTPC(track, o2::track::PID::Pion), trackCuts.getNsigmaTOF(track, o2::track::PID::Pion), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon))) {
-          continue;
-        }
+    for (auto& track : groupPartsTrack) {
+      // the PID of the track is checked once for all its pairs
+      if (!isTrackSelected(track)) {
+        continue;
       }
-      // // Close Pair Rejection
-      if (ConfIsCPR.value) {
-        if (pairCloseRejection.isClosePair(track, d0candidate, parts, magFieldTesla)) {
-          continue;
+      for (auto& d0candidate : groupPartsD0) {
+        // // Close Pair Rejection
+        if (ConfIsCPR.value) {
+          if (pairCloseRejection.isClosePair(track, d0candidate, parts, magFieldTesla)) {
+            continue;
+          }
         }
-      }
 
-      // Track Cleaning
-      if (!pairCleaner.isCleanPair(track, d0candidate, parts)) {
-        continue;
+        // Track Cleaning
+        if (!pairCleaner.isCleanPair(track, d0candidate, parts)) {
+          continue;
+        }
+        sameEventFemtoCont.setPair<isMC>(track, d0candidate, multCol, ConfBothTracks.ConfUse3D);
+        sameEventAngularCont.setPair<isMC>(track, d0candidate, multCol, ConfBothTracks.ConfUse3D);
       }
-      sameEventFemtoCont.setPair<isMC>(track, d0candidate, multCol, ConfBothTracks.ConfUse3D);
-      sameEventAngularCont.setPair<isMC>(track, d0candidate, multCol, ConfBothTracks.ConfUse3D);
     }
   }
 
@@ -488,20 +497,21 @@ struct femtoUniversePairTaskTrackD0 {
   void doMixedEvent(PartitionType groupPartsTrack, PartitionType groupPartsD0, PartType parts, float magFieldTesla, int multCol)
   {
 
-    for (auto& [track, d0candidate] : combinations(CombinationsFullIndexPolicy(groupPartsTrack, groupPartsD0))) {
-      if (ConfTrack.ConfIsTrackIdentified) {
-        if (!IsParticleNSigma(track.p(), trackCuts.getNsigmaTPC(track, o2::track::PID::Proton), trackCuts.getNsigmaTOF(track, o2::track::PID::Proton), trackCuts.getNsigmaTPC(track, o2::track::PID::Pion), trackCuts.getNsigmaTOF(track, o2::track::PID::Pion), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon))) {
-          continue;
-        }
+    for (auto& track : groupPartsTrack) {
+      // the PID of the track is checked once for all its pairs
+      if (!isTrackSelected(track)) {
+        continue;
       }
-      if (ConfIsCPR.value) {
-        if (pairCloseRejection.isClosePair(track, d0candidate, parts, magFieldTesla)) {
-          continue;
+      for (auto& d0candidate : groupPartsD0) {
+        if (ConfIsCPR.value) {
+          if (pairCloseRejection.isClosePair(track, d0candidate, parts, magFieldTesla)) {
+            continue;
+          }
         }
-      }
 
-      mixedEventFemtoCont.setPair<isMC>(track, d0candidate, multCol, ConfBothTracks.ConfUse3D);
-      mixedEventAngularCont.setPair<isMC>(track, d0candidate, multCol, ConfBothTracks.ConfUse3D);
+        mixedEventFemtoCont.setPair<isMC>(track, d0candidate, multCol, ConfBothTracks.ConfUse3D);
+        mixedEventAngularCont.setPair<isMC>(track, d0candidate, multCol, ConfBothTracks.ConfUse3D);
+      }
     }
   }
 
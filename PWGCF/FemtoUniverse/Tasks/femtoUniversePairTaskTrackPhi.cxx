@@ -271,6 +271,16 @@ struct femtoUniversePairTaskTrackPhi {
     }
   }
 
+  /// @returns whether the track passes the PID selection, in case the tracks are identified
+  template <typename T>
+  bool isTrackSelected(const T& track)
+  {
+    if (!ConfTrack.ConfIsTrackIdentified) {
+      return true;
+    }
+    return IsParticleNSigma(track.p(), trackCuts.getNsigmaTPC(track, o2::track::PID::Proton), trackCuts.getNsigmaTOF(track, o2::track::PID::Proton), trackCuts.getNsigmaTPC(track, o2::track::PID::Pion), trackCuts.getNsigmaTOF(track, o2::track::PID::Pion), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon));
+  }
+
   void init(InitContext&)
   {
     eventHisto.init(&qaRegistry);
@@ -383,55 +393,54 @@ struct femtoUniversePairTaskTrackPhi {
         //                        ConfBothTracks.ConfCutTable->get("Track", "nSigmaTPCTOF"))) {
         //   continue;
         // }
-        if (ConfTrack.ConfIsTrackIdentified) {
-          if (!IsParticleNSigma(track.p(), trackCuts.getNsigmaTPC(track, o2::track::PID::Proton), trackCuts.getNsigmaTOF(track, o2::track::PID::Proton), trackCuts.getNsigmaTPC(track, o2::track::PID::Pion), trackCuts.getNsigmaTOF(track, o2::track::PID::Pion), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon))) {
-            continue;
-          }
+        if (!isTrackSelected(track)) {
+          continue;
         }
         trackHistoPartTrack.fillQA<isMC, false>(track);
       }
     }
     /// Now build the combinations
-    for (auto& [track, phicandidate] : combinations(CombinationsFullIndexPolicy(groupPartsTrack, groupPartsPhi))) {
-      // if (track.p() > ConfBothTracks.ConfCutTable->get("PhiCandidate", "MaxP") || track.pt() > ConfBothTracks.ConfCutTable->get("PhiCandidate", "MaxPt") || phicandidate.p() > ConfBothTracks.ConfCutTable->get("Track", "MaxP") || phicandidate.pt() > ConfBothTracks.ConfCutTable->get("Track", "MaxPt")) {
-      //   continue;
-      // }
-      // if (!isFullPIDSelected(track.pidcut(),
-      //                        track.p(),
-      //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "PIDthr"),
-      //                        vPIDPhiCandidate,
-      //                        ConfBothTracks.ConfNspecies,
-      //                        kNsigma,
-      //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "nSigmaTPC"),
-      //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "nSigmaTPCTOF")) ||
-      //     !isFullPIDSelected(phicandidate.pidcut(),
-      //                        phicandidate.p(),
-      //                        ConfBothTracks.ConfCutTable->get("Track", "PIDthr"),
-      //                        vPIDTrack,
-      //                        ConfBothTracks.ConfNspecies,
-      //                        kNsigma,
-      //                        ConfBothTracks.ConfCutTable->get("Track", "nSigmaTPC"),
-      //                        ConfBothTracks.ConfCutTable->get("Track", "nSigmaTPCTOF"))) {
-      //   continue;
-      // }
-      if (ConfTrack.ConfIsTrackIdentified) {
-        if (!IsParticleNSigma(track.p(), trackCuts.getNsigmaTPC(track, o2::track::PID::Proton), trackCuts.getNsigmaTOF(track, o2::track::PID::Proton), trackCuts.getNsigmaTPC(track, o2::track::PID::Pion), trackCuts.getNsigmaTOF(track, o2::track::PID::Pion), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon))) {
-          continue;
-        }
+    for (auto& track : groupPartsTrack) {
+      // the PID of the track is checked once for all its pairs
+      if (!isTrackSelected(track)) {
+        continue;
       }
-      // // Close Pair Rejection
-      if (ConfIsCPR.value) {
-        if (pairCloseRejection.isClosePair(track, phicandidate, parts, magFieldTesla)) {
-          continue;
+      for (auto& phicandidate : groupPartsPhi) {
+        // if (track.p() > ConfBothTracks.ConfCutTable->get("PhiCandidate", "MaxP") || track.pt() > ConfBothTracks.ConfCutTable->get("PhiCandidate", "MaxPt") || phicandidate.p() > ConfBothTracks.ConfCutTable->get("Track", "MaxP") || phicandidate.pt() > ConfBothTracks.ConfCutTable->get("Track", "MaxPt")) {
+        //   continue;
+        // }
+        // if (!isFullPIDSelected(track.pidcut(),
+        //                        track.p(),
+        //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "PIDthr"),
+        //                        vPIDPhiCandidate,
+        //                        ConfBothTracks.ConfNspecies,
+        //                        kNsigma,
+        //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "nSigmaTPC"),
+        //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "nSigmaTPCTOF")) ||
+        //     !isFullPIDSelected(phicandidate.pidcut(),
+        //                        phicandidate.p(),
+        //                        ConfBothTracks.ConfCutTable->get("Track", "PIDthr"),
+        //                        vPIDTrack,
+        //                        ConfBothTracks.ConfNspecies,
+        //                        kNsigma,
+        //                        ConfBothTracks.ConfCutTable->get("Track", "nSigmaTPC"),
+        //                        ConfBothTracks.ConfCutTable->get("Track", "nSigmaTPCTOF"))) {
+        //   continue;
+        // }
+        // // Close Pair Rejection
+        if (ConfIsCPR.value) {
+          if (pairCloseRejection.isClosePair(track, phicandidate, parts, magFieldTesla)) {
+            continue;
+          }
         }
-      }
 
-      // Track Cleaning
-      if (!pairCleaner.isCleanPair(track, phicandidate, parts)) {
-        continue;
+        // Track Cleaning
+        if (!pairCleaner.isCleanPair(track, phicandidate, parts)) {
+          continue;
+        }
+        sameEventFemtoCont.setPair<isMC>(track, phicandidate, multCol, ConfBothTracks.ConfUse3D);
+        sameEventAngularCont.setPair<isMC>(track, phicandidate, multCol, ConfBothTracks.ConfUse3D);
       }
-      sameEventFemtoCont.setPair<isMC>(track, phicandidate, multCol, ConfBothTracks.ConfUse3D);
-      sameEventAngularCont.setPair<isMC>(track, phicandidate, multCol, ConfBothTracks.ConfUse3D);
     }
   }
 
@@ -483,41 +492,42 @@ struct femtoUniversePairTaskTrackPhi {
   void doMixedEvent(PartitionType groupPartsTrack, PartitionType groupPartsPhi, PartType parts, float magFieldTesla, int multCol)
   {
 
-    for (auto& [track, phicandidate] : combinations(CombinationsFullIndexPolicy(groupPartsTrack, groupPartsPhi))) {
-      // if (track.p() > ConfBothTracks.ConfCutTable->get("PhiCandidate", "MaxP") || track.pt() > ConfBothTracks.ConfCutTable->get("PhiCandidate", "MaxPt") || phicandidate.p() > ConfBothTracks.ConfCutTable->get("Track", "MaxP") || phicandidate.pt() > ConfBothTracks.ConfCutTable->get("Track", "MaxPt")) {
-      //   continue;
-      // }
-      // if (!isFullPIDSelected(track.pidcut(),
-      //                        track.p(),
-      //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "PIDthr"),
-      //                        vPIDPhiCandidate,
-      //                        ConfBothTracks.ConfNspecies,
-      //                        kNsigma,
-      //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "nSigmaTPC"),
-      //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "nSigmaTPCTOF")) ||
-      //     !isFullPIDSelected(phicandidate.pidcut(),
-      //                        phicandidate.p(),
-      //                        ConfBothTracks.ConfCutTable->get("Track", "PIDthr"),
-      //                        vPIDTrack,
-      //                        ConfBothTracks.ConfNspecies,
-      //                        kNsigma,
-      //                        ConfBothTracks.ConfCutTable->get("Track", "nSigmaTPC"),
-      //                        ConfBothTracks.ConfCutTable->get("Track", "nSigmaTPCTOF"))) {
-      //   continue;
-      // }
-      if (ConfTrack.ConfIsTrackIdentified) {
-        if (!IsParticleNSigma(track.p(), trackCuts.getNsigmaTPC(track, o2::track::PID::Proton), trackCuts.getNsigmaTOF(track, o2::track::PID::Proton), trackCuts.getNsigmaTPC(track, o2::track::PID::Pion), trackCuts.getNsigmaTOF(track, o2::track::PID::Pion), trackCuts.getNsigmaTPC(track, o2::track::PID::Kaon), trackCuts.getNsigmaTOF(track, o2::track::PID::Kaon))) {
-          continue;
-        }
+    for (auto& track : groupPartsTrack) {
+      // the PID of the track is checked once for all its pairs
+      if (!isTrackSelected(track)) {
+        continue;
       }
-      if (ConfIsCPR.value) {
-        if (pairCloseRejection.isClosePair(track, phicandidate, parts, magFieldTesla)) {
-          continue;
+      for (auto& phicandidate : groupPartsPhi) {
+        // if (track.p() > ConfBothTracks.ConfCutTable->get("PhiCandidate", "MaxP") || track.pt() > ConfBothTracks.ConfCutTable->get("PhiCandidate", "MaxPt") || phicandidate.p() > ConfBothTracks.ConfCutTable->get("Track", "MaxP") || phicandidate.pt() > ConfBothTracks.ConfCutTable->get("Track", "MaxPt")) {
+        //   continue;
+        // }
+        // if (!isFullPIDSelected(track.pidcut(),
+        //                        track.p(),
+        //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "PIDthr"),
+        //                        vPIDPhiCandidate,
+        //                        ConfBothTracks.ConfNspecies,
+        //                        kNsigma,
+        //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "nSigmaTPC"),
+        //                        ConfBothTracks.ConfCutTable->get("PhiCandidate", "nSigmaTPCTOF")) ||
+        //     !isFullPIDSelected(phicandidate.pidcut(),
+        //                        phicandidate.p(),
+        //                        ConfBothTracks.ConfCutTable->get("Track", "PIDthr"),
+        //                        vPIDTrack,
+        //                        ConfBothTracks.ConfNspecies,
+        //                        kNsigma,
+        //                        ConfBothTracks.ConfCutTable->get("Track", "nSigmaTPC"),
+        //                        ConfBothTracks.ConfCutTable->get("Track", "nSigmaTPCTOF"))) {
+        //   continue;
+        // }
+        if (ConfIsCPR.value) {
+          if (pairCloseRejection.isClosePair(track, phicandidate, parts, magFieldTesla)) {
+            continue;
+          }
         }
-      }
 
-      mixedEventFemtoCont.setPair<isMC>(track, phicandidate, multCol, ConfBothTracks.ConfUse3D);
-      mixedEventAngularCont.setPair<isMC>(track, phicandidate, multCol, ConfBothTracks.ConfUse3D);
+        mixedEventFemtoCont.setPair<isMC>(track, phicandidate, multCol, ConfBothTracks.ConfUse3D);
+        mixedEventAngularCont.setPair<isMC>(track, phicandidate, multCol, ConfBothTracks.ConfUse3D);
+      }
     }
   }
 
@@ -23,6 +23,7 @@
 
 #include "PWGCF/FemtoWorld/DataModel/FemtoWorldDerived.h"
 #include "Framework/HistogramRegistry.h"
+#include "PWGCF/Core/FemtoPairMath.h"
 
 namespace o2::analysis
 {
@@ -149,8 +150,6 @@ class FemtoWorldDetaDphiStar
   static constexpr o2::aod::femtoworldparticle::ParticleType mPartOneType = partOne; ///< Type of particle 1
   static constexpr o2::aod::femtoworldparticle::ParticleType mPartTwoType = partTwo; ///< Type of particle 2
 
-  static constexpr float tmpRadiiTPC[9] = {85., 105., 125., 145., 165., 185., 205., 225., 245.};
-
   static constexpr uint32_t kSignMinusMask = 1;
   static constexpr uint32_t kSignPlusMask = 1 << 1;
   static constexpr uint32_t kValue0 = 0;
@@ -163,7 +162,7 @@ class FemtoWorldDetaDphiStar
   std::array<std::array<std::shared_ptr<TH2>, 2>, 2> histdetadpi{};
   std::array<std::array<std::shared_ptr<TH2>, 9>, 2> histdetadpiRadii{};
 
-  ///  Calculate phi at all required radii stored in tmpRadiiTPC
+  ///  Calculate phi at all required radii stored in femto::radiiTPC
   /// Magnetic field to be provided in Tesla
   template <typename T>
   void PhiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
@@ -184,7 +183,7 @@ class FemtoWorldDetaDphiStar
     // End: Get the charge from cutcontainer using masks
     float pt = part.pt();
     for (size_t i = 0; i < 9; i++) {
-      tmpVec.push_back(phi0 - std::asin(0.3 * charge * 0.1 * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt)));
+      tmpVec.push_back(femto::getPhiStar(phi0, charge, pt, magfield, femto::radiiTPC[i]));
     }
   }
 
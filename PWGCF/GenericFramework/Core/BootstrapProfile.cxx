@@ -43,15 +43,57 @@ void BootstrapProfile::InitializeSubsamples(Int_t nSub)
   }
   if (fListOfEntries)
     delete fListOfEntries;
-  fListOfEntries = new TList();
-  fListOfEntries->SetOwner(kTRUE);
-  TProfile* dummyPF = reinterpret_cast<TProfile*>(this);
-  for (Int_t i = 0; i < nSub; i++) {
-    fListOfEntries->Add(reinterpret_cast<TProfile*>(dummyPF->Clone(Form("%s_Subpf%i", dummyPF->GetName(), i))));
-    reinterpret_cast<TProfile*>(fListOfEntries->At(i))->Reset();
-  }
+  fListOfEntries = 0;
+  // the subprofiles are only created from the accumulated sums when they are needed, see FlushSubsamples
+  fSubSums.assign(static_cast<size_t>(nSub) * GetNcells() * 4, 0.);
+  fSubEntries.assign(nSub, 0.);
   fNSubs = nSub;
 }
+void BootstrapProfile::FlushSubsamples()
+{
+  if (fSubSums.empty())
+    return;
+  const Int_t nCells = GetNcells();
+  if (!fListOfEntries) {
+    fListOfEntries = new TList();
+    fListOfEntries->SetOwner(kTRUE);
+    TProfile* dummyPF = reinterpret_cast<TProfile*>(this);
+    for (Int_t i = 0; i < fNSubs; i++) {
+      fListOfEntries->Add(reinterpret_cast<TProfile*>(dummyPF->Clone(Form("%s_Subpf%i", dummyPF->GetName(), i))));
+      reinterpret_cast<TProfile*>(fListOfEntries->At(i))->Reset();
+    }
+  }
+  for (Int_t i = 0; i < fNSubs; i++) {
+    TProfile* subpf = reinterpret_cast<TProfile*>(fListOfEntries->At(i));
+    Double_t* sumwy = subpf->fArray;
+    Double_t* sumwy2 = subpf->GetSumw2()->fArray;
+    Double_t* sumw2 = subpf->GetBinSumw2()->fArray;
+    const Double_t* sums = &fSubSums[static_cast<size_t>(i) * nCells * 4];
+    for (Int_t bin = 0; bin < nCells; bin++) {
+      subpf->SetBinEntries(bin, subpf->GetBinEntries(bin) + sums[4 * bin]);
+      sumwy[bin] += sums[4 * bin + 1];
+      if (sumwy2)
+        sumwy2[bin] += sums[4 * bin + 2];
+      if (sumw2)
+        sumw2[bin] += sums[4 * bin + 3];
+    }
+    Double_t nEntries = subpf->GetEntries() + fSubEntries[i];
+    subpf->ResetStats();
+    subpf->SetEntries(nEntries);
+  }
+  // the sums are released; further fills go directly to the subprofiles
+  std::vector<Double_t>().swap(fSubSums);
+  std::vector<Double_t>().swap(fSubEntries);
+}
+void BootstrapProfile::Streamer(TBuffer& R__b)
+{
+  if (R__b.IsReading()) {
+    R__b.ReadClassBuffer(BootstrapProfile::Class(), this);
+  } else {
+    FlushSubsamples();
+    R__b.WriteClassBuffer(BootstrapProfile::Class(), this);
+  }
+}
 void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w, const Double_t& rn)
 {
   TProfile::Fill(xv, yv, w);
@@ -60,7 +102,18 @@ void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const
   Int_t targetInd = rn * fNSubs;
   if (targetInd >= fNSubs)
     targetInd = 0;
-  reinterpret_cast<TProfile*>(fListOfEntries->At(targetInd))->Fill(xv, yv, w);
+  if (fSubSums.empty()) {
+    reinterpret_cast<TProfile*>(fListOfEntries->At(targetInd))->Fill(xv, yv, w);
+    return;
+  }
+  if (fYmin != fYmax && (yv < fYmin || yv > fYmax))
+    return; // same range check as TProfile::Fill
+  Double_t* sums = &fSubSums[(static_cast<size_t>(targetInd) * GetNcells() + fXaxis.FindFixBin(xv)) * 4];
+  sums[0] += w;
+  sums[1] += w * yv;
+  sums[2] += w * yv * yv;
+  sums[3] += w * w;
+  fSubEntries[targetInd]++;
 }
 void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w)
 {
@@ -68,6 +121,7 @@ void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const
 }
 void BootstrapProfile::RebinMulti(Int_t nbins)
 {
+  FlushSubsamples();
   this->RebinX(nbins);
   if (!fListOfEntries)
     return;
@@ -76,6 +130,7 @@ void BootstrapProfile::RebinMulti(Int_t nbins)
 }
 TH1* BootstrapProfile::getHist(Int_t ind)
 {
+  FlushSubsamples();
   if (fPresetWeights && fMultiRebin > 0)
     return getWeightBasedRebin(ind);
   if (ind < 0) {
@@ -101,6 +156,7 @@ TH1* BootstrapProfile::getHist(Int_t ind)
 }
 TProfile* BootstrapProfile::getProfile(Int_t ind)
 {
+  FlushSubsamples();
   if (ind < 0) {
     if (reinterpret_cast<TProfile*>(this)) {
       return reinterpret_cast<TProfile*>(this);
@@ -127,7 +183,9 @@ Long64_t BootstrapProfile::Merge(TCollection* collist)
   Long64_t nmerged = 0;
   BootstrapProfile* l_PBS = 0;
   TIter all_PBS(collist);
+  FlushSubsamples();
   while ((l_PBS = reinterpret_cast<BootstrapProfile*>(all_PBS()))) {
+    l_PBS->FlushSubsamples();
     reinterpret_cast<TProfile*>(this)->Add(reinterpret_cast<TProfile*>(l_PBS));
     TList* tarL = l_PBS->fListOfEntries;
     if (!tarL)
@@ -207,6 +265,16 @@ TH1* BootstrapProfile::getWeightBasedRebin(Int_t ind)
 void BootstrapProfile::MergeBS(BootstrapProfile* target)
 {
   this->Add(target);
+  if (!fSubSums.empty() && fSubSums.size() == target->fSubSums.size()) {
+    // both subsamples still accumulated in arrays: merge all of them at once
+    for (size_t i = 0; i < fSubSums.size(); i++)
+      fSubSums[i] += target->fSubSums[i];
+    for (size_t i = 0; i < fSubEntries.size(); i++)
+      fSubEntries[i] += target->fSubEntries[i];
+    return;
+  }
+  FlushSubsamples();
+  target->FlushSubsamples();
   TList* tarL = target->fListOfEntries;
   if (!fListOfEntries) {
     if (!target->fListOfEntries)
@@ -220,6 +288,7 @@ void BootstrapProfile::MergeBS(BootstrapProfile* target)
 }
 TProfile* BootstrapProfile::getSummedProfiles()
 {
+  FlushSubsamples();
   if (!fListOfEntries || !fListOfEntries->GetEntries()) {
     printf("No subprofiles initialized for the BootstrapProfile.\n");
     return 0;
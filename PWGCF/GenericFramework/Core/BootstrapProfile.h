@@ -12,7 +12,10 @@
 #ifndef PWGCF_GENERICFRAMEWORK_CORE_BOOTSTRAPPROFILE_H_
 #define PWGCF_GENERICFRAMEWORK_CORE_BOOTSTRAPPROFILE_H_
 
+#include <vector>
+
 #include "TProfile.h"
+#include "TBuffer.h"
 #include "TList.h"
 #include "TString.h"
 #include "TCollection.h"
@@ -37,10 +40,15 @@ class BootstrapProfile : public TProfile
   TProfile* getProfile(Int_t ind = -1);
   TProfile* getSummedProfiles();
   void OverrideMainWithSub();
-  Int_t getNSubs() { return fListOfEntries->GetEntries(); }
+  Int_t getNSubs()
+  {
+    FlushSubsamples();
+    return fListOfEntries->GetEntries();
+  }
   void PresetWeights(BootstrapProfile* targetBS) { fPresetWeights = targetBS; }
   void ResetBin(Int_t nbin)
   {
+    FlushSubsamples();
     ResetBin(reinterpret_cast<TProfile*>(this), nbin);
     for (Int_t i = 0; i < fListOfEntries->GetEntries(); i++)
       ResetBin(reinterpret_cast<TProfile*>(fListOfEntries->At(i)), nbin);
@@ -55,6 +63,10 @@ class BootstrapProfile : public TProfile
   Int_t fMultiRebin;                //! externaly set runtime, no need to store
   Double_t* fMultiRebinEdges;       //! externaly set runtime, no need to store
   BootstrapProfile* fPresetWeights; //! BootstrapProfile whose weights we should copy
+  // The subsamples are accumulated in flat arrays while filling, and moved to the profiles of fListOfEntries only when these are needed
+  std::vector<Double_t> fSubSums;    //! sum of w, w*y, w*y^2 and w^2 per subsample and bin
+  std::vector<Double_t> fSubEntries; //! entries per subsample
+  void FlushSubsamples();
   void ResetBin(TProfile* tpf, Int_t nbin)
   {
     tpf->SetBinEntries(nbin, 0);
@@ -67,13 +67,10 @@ void FlowContainer::Initialize(TObjArray* inputList, const o2::framework::AxisSp
     fProf->GetYaxis()->SetBinLabel(i + 1, inputList->At(i)->GetName());
   fProf->Sumw2();
   if (nRandom) {
+    // the subsample profiles are only created from the accumulated sums when they are needed, see FlushSubSamples
     fNRandom = nRandom;
-    fProfRand = new TObjArray();
-    fProfRand->SetOwner(kTRUE);
-    for (int i = 0; i < nRandom; i++) {
-      fProfRand->Add(dynamic_cast<TProfile2D*>(fProf->Clone(Form("%s_Rand_%i", fProf->GetName(), i))));
-      dynamic_cast<TProfile2D*>(fProfRand->At(i))->Sumw2();
-    }
+    fRandSums.assign(static_cast<size_t>(nRandom) * fProf->GetNcells() * 4, 0.);
+    fRandEntries.assign(nRandom, 0.);
   }
 };
 void FlowContainer::Initialize(TObjArray* inputList, int nMultiBins, double MultiMin, double MultiMax, int nRandom)
@@ -92,13 +89,10 @@ void FlowContainer::Initialize(TObjArray* inputList, int nMultiBins, double Mult
   for (int i = 0; i < inputList->GetEntries(); i++)
     fProf->GetYaxis()->SetBinLabel(i + 1, inputList->At(i)->GetName());
   if (nRandom) {
+    // the subsample profiles are only created from the accumulated sums when they are needed, see FlushSubSamples
     fNRandom = nRandom;
-    fProfRand = new TObjArray();
-    fProfRand->SetOwner(kTRUE);
-    for (int i = 0; i < nRandom; i++) {
-      fProfRand->Add(dynamic_cast<TProfile2D*>(fProf->Clone(Form("%s_Rand_%i", fProf->GetName(), i))));
-      dynamic_cast<TProfile2D*>(fProfRand->At(i))->Sumw2();
-    }
+    fRandSums.assign(static_cast<size_t>(nRandom) * fProf->GetNcells() * 4, 0.);
+    fRandEntries.assign(nRandom, 0.);
   }
 };
 bool FlowContainer::CreateBinsFromAxis(TAxis* inax)
@@ -144,11 +138,64 @@ int FlowContainer::FillProfile(const char* hname, double multi, double corr, dou
   }
   fProf->Fill(multi, yin, corr, w);
   if (fNRandom) {
-    double rnind = rn * fNRandom;
-    dynamic_cast<TProfile2D*>(fProfRand->At(static_cast<int>(rnind)))->Fill(multi, yin, corr, w);
+    int rnind = static_cast<int>(rn * fNRandom);
+    if (!fRandSums.empty()) {
+      double* sums = &fRandSums[(static_cast<size_t>(rnind) * fProf->GetNcells() + fProf->FindFixBin(multi, yin)) * 4];
+      sums[0] += w;
+      sums[1] += w * corr;
+      sums[2] += w * corr * corr;
+      sums[3] += w * w;
+      fRandEntries[rnind]++;
+    } else if (fProfRand) {
+      dynamic_cast<TProfile2D*>(fProfRand->At(rnind))->Fill(multi, yin, corr, w);
+    }
   }
   return 0;
 };
+void FlowContainer::FlushSubSamples()
+{
+  if (fRandSums.empty() || !fProf)
+    return;
+  if (!fProfRand) {
+    fProfRand = new TObjArray();
+    fProfRand->SetOwner(kTRUE);
+  }
+  const int nCells = fProf->GetNcells();
+  for (int i = 0; i < fNRandom; i++) {
+    TProfile2D* subProf = dynamic_cast<TProfile2D*>(fProfRand->At(i));
+    if (!subProf) {
+      subProf = dynamic_cast<TProfile2D*>(fProf->Clone(Form("%s_Rand_%i", fProf->GetName(), i)));
+      subProf->SetDirectory(0);
+      subProf->Reset();
+      fProfRand->AddAtAndExpand(subProf, i);
+    }
+    double* binSumw2 = subProf->GetBinSumw2()->fArray;
+    double* sumw2 = subProf->GetSumw2()->fArray;
+    double* sumwy = subProf->fArray;
+    const double* sums = &fRandSums[static_cast<size_t>(i) * nCells * 4];
+    for (int bin = 0; bin < nCells; bin++) {
+      subProf->SetBinEntries(bin, subProf->GetBinEntries(bin) + sums[4 * bin]);
+      sumwy[bin] += sums[4 * bin + 1];
+      sumw2[bin] += sums[4 * bin + 2];
+      binSumw2[bin] += sums[4 * bin + 3];
+    }
+    double nEntries = subProf->GetEntries() + fRandEntries[i];
+    subProf->ResetStats();
+    subProf->SetEntries(nEntries);
+  }
+  // the sums are released; further fills go directly to the subsample profiles
+  std::vector<double>().swap(fRandSums);
+  std::vector<double>().swap(fRandEntries);
+}
+void FlowContainer::Streamer(TBuffer& R__b)
+{
+  if (R__b.IsReading()) {
+    R__b.ReadClassBuffer(FlowContainer::Class(), this);
+  } else {
+    FlushSubSamples();
+    R__b.WriteClassBuffer(FlowContainer::Class(), this);
+  }
+}
 void FlowContainer::OverrideProfileErrors(TProfile2D* inpf)
 {
   int nBinsX = fProf->GetNbinsX();
@@ -201,24 +248,30 @@ Long64_t FlowContainer::Merge(TCollection* collist)
       tpro->Add(spro);
     }
     nmerged++;
-    TObjArray* tarr = l_FC->GetSubProfiles();
-    if (!tarr)
-      continue;
-    if (!fProfRand) {
-      fProfRand = new TObjArray();
-      fProfRand->SetOwner(kTRUE);
-    }
-    for (int i = 0; i < tarr->GetEntries(); i++) {
-      if (!(fProfRand->FindObject(tarr->At(i)->GetName()))) {
-        fProfRand->Add(dynamic_cast<TProfile2D*>(tarr->At(i)->Clone(tarr->At(i)->GetName())));
-        dynamic_cast<TProfile2D*>(fProfRand->At(fProfRand->GetEntries() - 1))->SetDirectory(0);
-      } else {
-        dynamic_cast<TProfile2D*>(fProfRand->FindObject(tarr->At(i)->GetName()))->Add(dynamic_cast<TProfile2D*>(tarr->At(i)));
-      }
-    }
+    MergeSubProfiles(l_FC->GetSubProfiles());
   }
   return nmerged;
 }
+void FlowContainer::MergeSubProfiles(TObjArray* tarr)
+{
+  if (!tarr)
+    return;
+  FlushSubSamples();
+  if (!fProfRand) {
+    fProfRand = new TObjArray();
+    fProfRand->SetOwner(kTRUE);
+  }
+  for (int i = 0; i < tarr->GetEntries(); i++) {
+    // the subsamples are normally stored in the same order, so only look them up by name if the order differs
+    TObject* target = (i < fProfRand->GetEntriesFast() && fProfRand->At(i) && !strcmp(fProfRand->At(i)->GetName(), tarr->At(i)->GetName())) ? fProfRand->At(i) : fProfRand->FindObject(tarr->At(i)->GetName());
+    if (!target) {
+      fProfRand->Add(dynamic_cast<TProfile2D*>(tarr->At(i)->Clone(tarr->At(i)->GetName())));
+      dynamic_cast<TProfile2D*>(fProfRand->At(fProfRand->GetEntries() - 1))->SetDirectory(0);
+    } else {
+      dynamic_cast<TProfile2D*>(target)->Add(dynamic_cast<TProfile2D*>(tarr->At(i)));
+    }
+  }
+}
 
 void FlowContainer::ReadAndMerge(const char* filelist)
 {
@@ -260,22 +313,7 @@ void FlowContainer::PickAndMerge(TFile* tfi)
   } else {
     tpro->Add(spro);
   }
-  TObjArray* tarr = lfc->GetSubProfiles();
-  if (!tarr) {
-    return;
-  }
-  if (!fProfRand) {
-    fProfRand = new TObjArray();
-    fProfRand->SetOwner(kTRUE);
-  }
-  for (int i = 0; i < tarr->GetEntries(); i++) {
-    if (!(fProfRand->FindObject(tarr->At(i)->GetName()))) {
-      fProfRand->Add(dynamic_cast<TProfile2D*>(tarr->At(i)->Clone(tarr->At(i)->GetName())));
-      dynamic_cast<TProfile2D*>(fProfRand->At(fProfRand->GetEntries() - 1))->SetDirectory(0);
-    } else {
-      dynamic_cast<TProfile2D*>(fProfRand->FindObject(tarr->At(i)->GetName()))->Add(dynamic_cast<TProfile2D*>(tarr->At(i)));
-    }
-  }
+  MergeSubProfiles(lfc->GetSubProfiles());
 }
 bool FlowContainer::OverrideBinsWithZero(int xb1, int yb1, int xb2, int yb2)
 {
@@ -290,6 +328,7 @@ bool FlowContainer::OverrideBinsWithZero(int xb1, int yb1, int xb2, int yb2)
 }
 bool FlowContainer::OverrideMainWithSub(int ind, bool ExcludeChosen)
 {
+  FlushSubSamples();
   if (!fProfRand) {
     printf("Cannot override main profile with a randomized one. Random profile array does not exist.\n");
     return kFALSE;
@@ -322,6 +361,7 @@ bool FlowContainer::OverrideMainWithSub(int ind, bool ExcludeChosen)
 }
 bool FlowContainer::RandomizeProfile(int nSubsets)
 {
+  FlushSubSamples();
   if (!fProfRand) {
     printf("Cannot randomize profile, random array does not exist.\n");
     return kFALSE;
@@ -11,6 +11,7 @@
 
 #ifndef PWGCF_GENERICFRAMEWORK_CORE_FLOWCONTAINER_H_
 #define PWGCF_GENERICFRAMEWORK_CORE_FLOWCONTAINER_H_
+#include <cstring>
 #include <vector>
 #include "TH3F.h"
 #include "TProfile2D.h"
@@ -25,6 +26,7 @@
 #include "TRandom.h"
 #include "TString.h"
 #include "TCollection.h"
+#include "TBuffer.h"
 #include "TAxis.h"
 #include "ProfileSubset.h"
 #include "Framework/HistogramSpec.h"
@@ -45,8 +47,10 @@ class FlowContainer : public TNamed
   void SetXAxis();
   void RebinMulti(int rN)
   {
-    if (fProf)
+    if (fProf) {
+      FlushSubSamples();
       fProf->RebinX(rN);
+    }
   };
   int GetNMultiBins() { return fProf->GetNbinsX(); }
   double GetMultiAtBin(int bin) { return fProf->GetXaxis()->GetBinCenter(bin); }
@@ -59,7 +63,11 @@ class FlowContainer : public TNamed
   bool OverrideMainWithSub(int subind, bool ExcludeChosen);
   bool RandomizeProfile(int nSubsets = 0);
   bool CreateStatisticsProfile(StatisticsType StatType, int arg);
-  TObjArray* GetSubProfiles() { return fProfRand; }
+  TObjArray* GetSubProfiles()
+  {
+    FlushSubSamples();
+    return fProfRand;
+  }
   Long64_t Merge(TCollection* collist);
   void SetIDName(TString newname); //! do not store
   void SetPtRebin(int newval) { fPtRebin = newval; }
@@ -163,6 +171,11 @@ class FlowContainer : public TNamed
   double* fbinsPt;       //! Do not store; stored in fXAxis
   bool fPropagateErrors; //! do not store
   TProfile* GetRefFlowProfile(const char* order, double m1 = -1, double m2 = -1);
+  // The subsamples are accumulated in flat arrays while filling, and moved to the profiles of fProfRand only when these are needed
+  std::vector<double> fRandSums;    //! do not store; sum of w, w*y, w*y^2 and w^2 per subsample and bin of fProf
+  std::vector<double> fRandEntries; //! do not store; entries per subsample
+  void FlushSubSamples();
+  void MergeSubProfiles(TObjArray* tarr);
   ClassDef(FlowContainer, 2);
 };
 
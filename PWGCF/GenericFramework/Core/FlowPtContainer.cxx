@@ -186,8 +186,22 @@ void FlowPtContainer::Initialise(int nbinsx, double xlow, double xhigh, const in
 };
 void FlowPtContainer::Fill(const double& w, const double& pt)
 {
-  for (auto i = 0; i < sumP.size(); ++i) {
-    sumP[i] += pow(w, i % (mpar + 1)) * pow(pt, i / (mpar + 1));
+  // the terms w^i pt^j are built by successive products, in the order of sumP
+  double ptPow = 1.;
+  for (int j = 0; j <= mpar; ++j) {
+    double wptPow = ptPow;
+    for (int i = 0; i <= mpar; ++i) {
+      sumP[GetVectorIndex(i, j)] += wptPow;
+      wptPow *= w;
+    }
+    ptPow *= pt;
+  }
+  return;
+}
+void FlowPtContainer::Fill(const std::size_t n, const double* w, const double* pt)
+{
+  for (std::size_t iTrack = 0; iTrack < n; ++iTrack) {
+    Fill(w[iTrack], pt[iTrack]);
   }
   return;
 }
@@ -13,6 +13,7 @@
 #define PWGCF_GENERICFRAMEWORK_CORE_FLOWPTCONTAINER_H_
 
 #include <algorithm>
+#include <cstddef>
 #include <vector>
 #include "BootstrapProfile.h"
 #include "TNamed.h"
@@ -45,6 +46,8 @@ class FlowPtContainer : public TNamed
   void Initialise(int nbinsx, double* xbins, const int& m, const GFWCorrConfigs& configs, const int& nsub = 10);
   void Initialise(int nbinsx, double xlow, double xhigh, const int& m, const GFWCorrConfigs& configs, const int& nsub = 10);
   void Fill(const double& w, const double& pt);
+  /// Fills the weights and pT of n tracks
+  void Fill(const std::size_t n, const double* w, const double* pt);
   int GetVectorIndex(const int i, const int j) { return j * (mpar + 1) + i; }
   void CalculateCorrelations();
   void CalculateCMTerms();
@@ -82,6 +82,7 @@ int GFW::CreateRegions()
   for (auto pItr = fCumulants.begin(); pItr != fCumulants.end(); ++pItr)
     pItr->DestroyComplexVectorArray();
   fCumulants.clear();
+  fCorrMemoStale = true;
   InitializePowerArrays();
   if (fRegions.size() < 1) {
     printf("No regions set. Skipping...\n");
@@ -96,15 +97,45 @@ int GFW::CreateRegions()
   }
   if (nRegions)
     fInitialized = true;
+  BuildEtaLookup();
   return nRegions;
 };
+void GFW::BuildEtaLookup()
+{
+  fEtaEdges.clear();
+  for (const auto& reg : fRegions) {
+    fEtaEdges.push_back(reg.EtaMin);
+    fEtaEdges.push_back(reg.EtaMax);
+  }
+  std::sort(fEtaEdges.begin(), fEtaEdges.end());
+  fEtaEdges.erase(std::unique(fEtaEdges.begin(), fEtaEdges.end()), fEtaEdges.end());
+  // segment s covers [fEtaEdges[s-1], fEtaEdges[s]); a value at an edge is tested against the regions of the segment above it,
+  // which include all the regions where it can be strictly inside
+  fRegionsInEtaSeg.assign(fEtaEdges.size() + 1, {});
+  for (int s = 1; s < static_cast<int>(fEtaEdges.size()); ++s) {
+    for (int i = 0; i < static_cast<int>(fRegions.size()); ++i) {
+      if (fRegions[i].EtaMin <= fEtaEdges[s - 1] && fRegions[i].EtaMax >= fEtaEdges[s])
+        fRegionsInEtaSeg[s].push_back(i);
+    }
+  }
+};
 void GFW::Fill(double eta, int ptin, double phi, double weight, int mask, double SecondWeight)
 {
   // if(!fInitialized) return;
-  for (int i = 0; i < static_cast<int>(fRegions.size()); ++i) {
-    if (fRegions.at(i).EtaMin < eta && fRegions.at(i).EtaMax > eta && (fRegions.at(i).BitMask & mask))
-      fCumulants.at(i).FillArray(ptin, phi, weight, SecondWeight);
+  if (fRegionsInEtaSeg.empty() || fCumulants.size() != fRegions.size()) {
+    for (int i = 0; i < static_cast<int>(fRegions.size()); ++i) {
+      if (fRegions.at(i).EtaMin < eta && fRegions.at(i).EtaMax > eta && (fRegions.at(i).BitMask & mask))
+        fCumulants.at(i).FillArray(ptin, phi, weight, SecondWeight);
+    }
+    fCorrMemoStale = true;
+    return;
+  }
+  const int seg = std::upper_bound(fEtaEdges.begin(), fEtaEdges.end(), eta) - fEtaEdges.begin();
+  for (const int& i : fRegionsInEtaSeg[seg]) {
+    if (fRegions[i].EtaMin < eta && fRegions[i].EtaMax > eta && (fRegions[i].BitMask & mask))
+      fCumulants[i].FillArray(ptin, phi, weight, SecondWeight);
   }
+  fCorrMemoStale = true;
 };
 complex<double> GFW::TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant* r1, GFWCumulant* r2, GFWCumulant* r3)
 {
@@ -122,6 +153,16 @@ complex<double> GFW::RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumu
   return RecursiveCorr(qpoi, qref, qol, ptbin, hars, pows);
 };
 
+void GFW::BuildCorrKey(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, const vector<int>& hars, const vector<int>& pows)
+{
+  fCorrKey.clear();
+  fCorrKey.push_back(static_cast<int>(qpoi - fCumulants.data()));
+  fCorrKey.push_back(static_cast<int>(qref - fCumulants.data()));
+  fCorrKey.push_back(qol ? static_cast<int>(qol - fCumulants.data()) : -1);
+  fCorrKey.push_back(ptbin);
+  fCorrKey.insert(fCorrKey.end(), hars.begin(), hars.end());
+  fCorrKey.insert(fCorrKey.end(), pows.begin(), pows.end());
+};
 complex<double> GFW::RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, vector<int>& hars, vector<int>& pows)
 {
   if ((pows.at(0) != 1) && qol)
@@ -131,6 +172,15 @@ complex<double> GFW::RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumu
     return qpoi->Vec(hars.at(0), pows.at(0), ptbin);
   if (hars.size() < 3)
     return TwoRec(hars.at(0), hars.at(1), pows.at(0), pows.at(1), ptbin, qpoi, qref, qol);
+  // 3 and more particle terms are shared between the configs and recursion branches, so calculate each of them once per event
+  if (fCorrMemoStale) {
+    fCorrMemo.clear();
+    fCorrMemoStale = false;
+  }
+  BuildCorrKey(qpoi, qref, qol, ptbin, hars, pows);
+  auto memoItr = fCorrMemo.find(fCorrKey);
+  if (memoItr != fCorrMemo.end())
+    return memoItr->second;
   int harlast = hars.at(hars.size() - 1);
   int powlast = pows.at(pows.size() - 1);
   hars.erase(hars.end() - 1);
@@ -160,6 +210,8 @@ complex<double> GFW::RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumu
   }
   hars.push_back(harlast);
   pows.push_back(powlast);
+  BuildCorrKey(qpoi, qref, qol, ptbin, hars, pows);
+  fCorrMemo.emplace(fCorrKey, formula);
   return formula;
 };
 void GFW::Clear()
@@ -168,6 +220,7 @@ void GFW::Clear()
     CreateRegions();
   for (auto ptr = fCumulants.begin(); ptr != fCumulants.end(); ++ptr)
     ptr->ResetQs();
+  fCorrMemoStale = true;
 };
 GFW::CorrConfig GFW::GetCorrelatorConfig(string config, string head, bool ptdif)
 {
@@ -26,6 +26,7 @@ If used, modified, or distributed, please aknowledge the author of this code.
 #include <utility>
 #include <algorithm>
 #include <complex>
+#include <unordered_map>
 
 class GFW
 {
@@ -71,6 +72,25 @@ class GFW
  protected:
   bool fInitialized;
   std::vector<CorrConfig> fListOfCFGs;
+  // Memo of the correlators of the current event, keyed by (regions, pt bin, harmonics, powers). Shared by all the configs and pt bins
+  struct CorrKeyHash {
+    size_t operator()(const std::vector<int>& key) const
+    {
+      size_t hash = key.size();
+      for (const int& val : key)
+        hash ^= static_cast<size_t>(val) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      return hash;
+    }
+  };
+  std::unordered_map<std::vector<int>, std::complex<double>, CorrKeyHash> fCorrMemo; //!
+  std::vector<int> fCorrKey;                                                        //! buffer for the memo key
+  bool fCorrMemoStale = true;                                                       //! Q-vectors changed since the memo was filled
+  // Lookup of the regions by eta, built in CreateRegions: the eta edges of all the regions, sorted, split eta in segments,
+  // and each segment lists the regions which may contain it, so that Fill does not test every region for each track
+  std::vector<double> fEtaEdges;                  //!
+  std::vector<std::vector<int>> fRegionsInEtaSeg; //! regions overlapping each segment, fEtaEdges.size() + 1 segments
+  void BuildEtaLookup();
+  void BuildCorrKey(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, const std::vector<int>& hars, const std::vector<int>& pows);
   std::complex<double> TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant*, GFWCumulant*, GFWCumulant*);
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars, std::vector<int>& pows); // POI, Ref. flow, overlapping region
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars);                         // POI, Ref. flow, overlapping region
@@ -19,16 +19,19 @@ If used, modified, or distributed, please aknowledge the author of this code.
 
 #include "GFWCumulant.h"
 
+#include <algorithm>
+
 using std::complex;
 using std::vector;
 
-GFWCumulant::GFWCumulant() : fQvector(0),
+GFWCumulant::GFWCumulant() : fQvector(),
                              fUsed(kBlank),
                              fNEntries(-1),
                              fN(1),
                              fPow(1),
+                             fNQ(0),
                              fPt(1),
-                             fFilledPts(0),
+                             fFilledPts(),
                              fInitialized(false) {}
 
 GFWCumulant::~GFWCumulant() {}
@@ -40,23 +43,42 @@ void GFWCumulant::FillArray(int ptin, double phi, double weight, double SecondWe
     ptin = 0; // If one bin, then just fill it straight; otherwise, if ptin is out-of-range, do not fill
   else if (ptin < 0 || ptin >= fPt)
     return;
+  FillValidBin(ptin, phi, weight, SecondWeight);
+};
+void GFWCumulant::FillArray(const vector<int>& ptins, const vector<double>& phis, const vector<double>& weights, const vector<double>& SecondWeights)
+{
+  if (!fInitialized)
+    CreateComplexVectorArray(1, 1, 1);
+  bool hasSecondWeights = !SecondWeights.empty();
+  for (size_t i = 0; i < phis.size(); i++) {
+    int ptin = ptins[i];
+    if (fPt == 1)
+      ptin = 0;
+    else if (ptin < 0 || ptin >= fPt)
+      continue;
+    FillValidBin(ptin, phis[i], weights[i], hasSecondWeights ? SecondWeights[i] : -1);
+  }
+};
+void GFWCumulant::FillValidBin(int ptin, double phi, double weight, double SecondWeight)
+{
   fFilledPts[ptin] = true;
+  // Weight prefactors, built by multiplication since it is cheaper than power.
+  // If second weight is specified, then keep the first weight with power no more than 1, and use the other weight otherwise
+  // this is important when POIs are a subset of REFs and have different weights than REFs
+  double lPowWeight = (SecondWeight > 0) ? SecondWeight : weight;
+  fPrefactor[0] = 1;
+  for (size_t lPow = 1; lPow < fPrefactor.size(); lPow++)
+    fPrefactor[lPow] = (lPow == 1) ? weight : fPrefactor[lPow - 1] * lPowWeight;
+  // cos(n*phi) and sin(n*phi) from the powers of exp(i*phi), instead of calling cos and sin for each harmonic
+  const complex<double> lStep(cos(phi), sin(phi));
+  complex<double> lHarm(1, 0);
+  complex<double>* lQ = fQvector.data() + ptin * fNQ;
   for (int lN = 0; lN < fN; lN++) {
-    double lSin = sin(lN * phi); // No need to recalculate for each power
-    double lCos = cos(lN * phi); // No need to recalculate for each power
-    for (int lPow = 0; lPow < PW(lN); lPow++) {
-      double lPrefactor = 0;
-      // Dont calculate it twice; multiplication is cheaper that power
-      // Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
-      // this is important when POIs are a subset of REFs and have different weights than REFs
-      if (SecondWeight > 0 && lPow > 1)
-        lPrefactor = pow(SecondWeight, lPow - 1) * weight;
-      else
-        lPrefactor = pow(weight, lPow);
-      double qsin = lPrefactor * lSin;
-      double qcos = lPrefactor * lCos;
-      fQvector[ptin][lN][lPow] += complex<double>(qcos, qsin);
-    }
+    complex<double>* lQHarm = lQ + fPowOffsets[lN];
+    const int lNPow = fPowVec[lN];
+    for (int lPow = 0; lPow < lNPow; lPow++)
+      lQHarm[lPow] += fPrefactor[lPow] * lHarm;
+    lHarm *= lStep;
   }
   Inc();
 };
@@ -64,30 +86,18 @@ void GFWCumulant::ResetQs()
 {
   if (!fNEntries)
     return; // If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
-  for (int i = 0; i < fPt; i++) {
-    fFilledPts[i] = false;
-    for (int lN = 0; lN < fN; lN++) {
-      for (int lPow = 0; lPow < PW(lN); lPow++) {
-        fQvector[i][lN][lPow] = fNullQ;
-      }
-    }
-  }
+  std::fill(fFilledPts.begin(), fFilledPts.end(), false);
+  std::fill(fQvector.begin(), fQvector.end(), fNullQ);
   fNEntries = 0;
 };
 void GFWCumulant::DestroyComplexVectorArray()
 {
   if (!fInitialized)
     return;
-  for (int l_n = 0; l_n < fN; l_n++) {
-    for (int i = 0; i < fPt; i++) {
-      delete[] fQvector[i][l_n];
-    }
-  }
-  for (int i = 0; i < fPt; i++) {
-    delete[] fQvector[i];
-  }
-  delete[] fQvector;
-  delete[] fFilledPts;
+  fQvector.clear();
+  fPowOffsets.clear();
+  fPrefactor.clear();
+  fFilledPts.clear();
   fInitialized = false;
   fNEntries = -1;
 };
@@ -106,17 +116,18 @@ void GFWCumulant::CreateComplexVectorArrayVarPower(int N, vector<int> PowVec, in
   fN = N;
   fPow = 0;
   fPt = Pt;
-  fFilledPts = new bool[Pt];
+  fFilledPts.assign(Pt, false);
   fPowVec = PowVec;
-  fQvector = new complex<double>**[fPt];
-  for (int i = 0; i < fPt; i++) {
-    fQvector[i] = new complex<double>*[fN];
-  }
+  fPowOffsets.resize(fN);
+  fNQ = 0;
+  int lMaxPow = 1;
   for (int l_n = 0; l_n < fN; l_n++) {
-    for (int i = 0; i < fPt; i++) {
-      fQvector[i][l_n] = new complex<double>[PW(l_n)];
-    }
+    fPowOffsets[l_n] = fNQ;
+    fNQ += PW(l_n);
+    lMaxPow = std::max(lMaxPow, PW(l_n));
   }
+  fPrefactor.resize(lMaxPow);
+  fQvector.resize(fPt * fNQ);
   ResetQs();
   fInitialized = true;
 };
@@ -127,12 +138,12 @@ complex<double> GFWCumulant::Vec(int n, int p, int ptbin)
   if (ptbin >= fPt || ptbin < 0)
     ptbin = 0;
   if (n >= 0)
-    return fQvector[ptbin][n][p];
-  return conj(fQvector[ptbin][-n][p]);
+    return fQvector[ptbin * fNQ + fPowOffsets[n] + p];
+  return conj(fQvector[ptbin * fNQ + fPowOffsets[-n] + p]);
 };
 bool GFWCumulant::IsPtBinFilled(int ptb)
 {
-  if (!fFilledPts)
+  if (fFilledPts.empty())
     return false;
   if (ptb > 0) {
     if (fPt == 1)
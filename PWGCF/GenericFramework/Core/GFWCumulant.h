@@ -30,6 +30,7 @@ class GFWCumulant
   ~GFWCumulant();
   void ResetQs();
   void FillArray(int ptin, double phi, double weight = 1, double SecondWeight = -1);
+  void FillArray(const std::vector<int>& ptins, const std::vector<double>& phis, const std::vector<double>& weights, const std::vector<double>& SecondWeights = {}); // Batch fill, SecondWeights either empty or of the same size
   enum UsedFlags_t { kBlank = 0,
                      kFull = 1,
                      kPt = 2 };
@@ -47,15 +48,18 @@ class GFWCumulant
   void DestroyComplexVectorArray();
   std::complex<double> Vec(int, int, int ptbin = 0); // envelope class to summarize pt-dif. Q-vec getter
  protected:
-  std::complex<double>*** fQvector;
+  void FillValidBin(int ptin, double phi, double weight, double SecondWeight); // Fill without the checks of the pt bin and of the initialization
+  std::vector<std::complex<double>> fQvector; //! Q-vectors, flat in [pt bin][harmonic][power]
   uint fUsed;
   int fNEntries;
-  // Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
-  int fN;                   //! Harmonics
-  int fPow;                 //! Power
-  std::vector<int> fPowVec; //! Powers array
-  int fPt;                  //! fPt bins
-  bool* fFilledPts;
+  int fN;                         //! Harmonics
+  int fPow;                       //! Power
+  std::vector<int> fPowVec;       //! Powers array
+  std::vector<int> fPowOffsets;   //! Offset of each harmonic in a pt bin of fQvector
+  int fNQ;                        //! Number of Q-vectors per pt bin
+  int fPt;                        //! fPt bins
+  std::vector<double> fPrefactor; //! Weight prefactor of each power, recalculated for each particle
+  std::vector<bool> fFilledPts;
   bool fInitialized; // Arrays are initialized
   std::complex<double> fNullQ = 0;
 };
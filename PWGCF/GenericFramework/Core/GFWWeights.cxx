@@ -21,7 +21,8 @@ GFWWeights::GFWWeights() : TNamed("", ""),
                            fIntEff(0),
                            fAccInt(0),
                            fNbinsPt(0),
-                           fbinsPt(0) {}
+                           fbinsPt(0),
+                           fWeightsBaked(kFALSE) {}
 GFWWeights::GFWWeights(const char* name) : TNamed(name, name),
                                            fDataFilled(kFALSE),
                                            fMCFilled(kFALSE),
@@ -32,7 +33,8 @@ GFWWeights::GFWWeights(const char* name) : TNamed(name, name),
                                            fIntEff(0),
                                            fAccInt(0),
                                            fNbinsPt(0),
-                                           fbinsPt(0) {}
+                                           fbinsPt(0),
+                                           fWeightsBaked(kFALSE) {}
 GFWWeights::~GFWWeights()
 {
   delete fW_data;
@@ -143,27 +145,70 @@ double GFWWeights::GetWeight(double phi, double eta, double vz, double pt, doubl
 };
 double GFWWeights::GetNUA(double phi, double eta, double vz)
 {
-  if (!fAccInt)
-    CreateNUA();
-  int xind = fAccInt->GetXaxis()->FindBin(phi);
-  int etaind = fAccInt->GetYaxis()->FindBin(eta);
-  int vzind = fAccInt->GetZaxis()->FindBin(vz);
-  double weight = fAccInt->GetBinContent(xind, etaind, vzind);
-  if (weight != 0)
-    return 1. / weight;
-  return 1;
+  if (!fWeightsBaked)
+    BakeWeights();
+  if (fNUATable.invWeights.empty())
+    return 1;
+  return fNUATable.Get(phi, eta, vz);
 }
 double GFWWeights::GetNUE(double pt, double eta, double vz)
 {
-  if (!fEffInt)
+  if (!fWeightsBaked)
+    BakeWeights();
+  if (fNUETable.invWeights.empty())
+    return 1;
+  return fNUETable.Get(pt, eta, vz);
+}
+void GFWWeights::GetNUA(const std::vector<float>& phi, const std::vector<float>& eta, double vz, std::vector<float>& weights)
+{
+  if (!fWeightsBaked)
+    BakeWeights();
+  weights.assign(phi.size(), 1.f);
+  if (fNUATable.invWeights.empty())
+    return;
+  for (size_t i = 0; i < phi.size(); i++)
+    weights[i] = fNUATable.Get(phi[i], eta[i], vz);
+}
+void GFWWeights::GetNUE(const std::vector<float>& pt, const std::vector<float>& eta, double vz, std::vector<float>& weights)
+{
+  if (!fWeightsBaked)
+    BakeWeights();
+  weights.assign(pt.size(), 1.f);
+  if (fNUETable.invWeights.empty())
+    return;
+  for (size_t i = 0; i < pt.size(); i++)
+    weights[i] = fNUETable.Get(pt[i], eta[i], vz);
+}
+void GFWWeights::BakeWeights()
+{
+  if (!fAccInt && fW_data && fW_data->GetEntries() > 0)
+    CreateNUA();
+  if (!fEffInt && fW_mcrec && fW_mcgen && fW_mcrec->GetEntries() > 0 && fW_mcgen->GetEntries() > 0)
     CreateNUE();
-  int xind = fEffInt->GetXaxis()->FindBin(pt);
-  int etaind = fEffInt->GetYaxis()->FindBin(eta);
-  int vzind = fEffInt->GetZaxis()->FindBin(vz);
-  double weight = fEffInt->GetBinContent(xind, etaind, vzind);
-  if (weight != 0)
-    return 1. / weight;
-  return 1;
+  BakeTable(fAccInt, fNUATable);
+  BakeTable(fEffInt, fNUETable);
+  fWeightsBaked = kTRUE;
+}
+void GFWWeights::BakeTable(TH3D* inh, BakedTable& table)
+{
+  table.invWeights.clear();
+  if (!inh)
+    return;
+  TAxis* axes[3] = {inh->GetXaxis(), inh->GetYaxis(), inh->GetZaxis()};
+  for (int i = 0; i < 3; i++) {
+    BakedAxis& baked = table.axes[i];
+    baked.nBins = axes[i]->GetNbins();
+    baked.min = axes[i]->GetXmin();
+    baked.invWidth = baked.nBins / (axes[i]->GetXmax() - axes[i]->GetXmin());
+    baked.edges.clear();
+    if (axes[i]->GetXbins()->GetSize() > 0)
+      baked.edges.assign(axes[i]->GetXbins()->GetArray(), axes[i]->GetXbins()->GetArray() + baked.nBins + 1);
+  }
+  table.invWeights.resize(inh->GetNcells());
+  for (int bin = 0; bin < inh->GetNcells(); bin++) {
+    double weight = inh->GetBinContent(bin);
+    table.invWeights[bin] = (weight != 0) ? 1. / weight : 1.;
+  }
 }
 double GFWWeights::FindMax(TH3D* inh, int& ix, int& iy, int& iz)
 {
@@ -237,6 +282,7 @@ void GFWWeights::CreateNUA(bool IntegrateOverCentAndPt)
       fAccInt->GetZaxis()->SetRange(1, fAccInt->GetNbinsZ());
     }
     fAccInt->GetYaxis()->SetRange(1, fAccInt->GetNbinsY());
+    fWeightsBaked = kFALSE;
     return;
   }
 };
@@ -278,6 +324,7 @@ void GFWWeights::CreateNUE(bool IntegrateOverCentrality)
     den->RebinZ(5);
     fEffInt = reinterpret_cast<TH3D*>(num->Clone("Efficiency_Integrated"));
     fEffInt->Divide(den);
+    fWeightsBaked = kFALSE;
     return;
   }
 };
@@ -362,6 +409,8 @@ void GFWWeights::OverwriteNUA()
   delete trash;
   fW_data->Add(reinterpret_cast<TH3D*>(fAccInt->Clone(ts.Data())));
   delete fAccInt;
+  fAccInt = 0;
+  fWeightsBaked = kFALSE;
 }
 Long64_t GFWWeights::Merge(TCollection* collist)
 {
@@ -11,6 +11,8 @@
 
 #ifndef PWGCF_GENERICFRAMEWORK_CORE_GFWWEIGHTS_H_
 #define PWGCF_GENERICFRAMEWORK_CORE_GFWWEIGHTS_H_
+#include <algorithm>
+#include <vector>
 #include "TObjArray.h"
 #include "TNamed.h"
 #include "TH3D.h"
@@ -27,10 +29,13 @@ class GFWWeights : public TNamed
   explicit GFWWeights(const char* name);
   ~GFWWeights();
   void Init(bool AddData = kTRUE, bool AddM = kTRUE);
-  void Fill(double phi, double eta, double vz, double pt, double cent, int htype, double weight = 1); // htype: 0 for data, 1 for mc rec, 2 for mc gen
-  double GetWeight(double phi, double eta, double vz, double pt, double cent, int htype);             // htype: 0 for data, 1 for mc rec, 2 for mc gen
-  double GetNUA(double phi, double eta, double vz);                                                   // This just fetches correction from integrated NUA, should speed up
-  double GetNUE(double pt, double eta, double vz);                                                    // fetches weight from fEffInt
+  void Fill(double phi, double eta, double vz, double pt, double cent, int htype, double weight = 1);                // htype: 0 for data, 1 for mc rec, 2 for mc gen
+  double GetWeight(double phi, double eta, double vz, double pt, double cent, int htype);                            // htype: 0 for data, 1 for mc rec, 2 for mc gen
+  double GetNUA(double phi, double eta, double vz);                                                                  // This just fetches correction from integrated NUA, should speed up
+  double GetNUE(double pt, double eta, double vz);                                                                   // fetches weight from fEffInt
+  void GetNUA(const std::vector<float>& phi, const std::vector<float>& eta, double vz, std::vector<float>& weights); // NUA weights for all the tracks of a collision
+  void GetNUE(const std::vector<float>& pt, const std::vector<float>& eta, double vz, std::vector<float>& weights);  // NUE weights for all the tracks of a collision
+  void BakeWeights();                                                                                                // Converts the NUA and NUE histograms into lookup tables of inverse weights, done on the first Get call otherwise
   bool IsDataFilled() { return fDataFilled; }
   bool IsMCFilled() { return fMCFilled; }
   double FindMax(TH3D* inh, int& ix, int& iy, int& iz);
@@ -64,6 +69,33 @@ class GFWWeights : public TNamed
   TH3D* fAccInt;   //!
   int fNbinsPt;    //! do not store
   double* fbinsPt; //! do not store
+  // Lookup tables of the inverse weights, with the bins of the TH3D (including under- and overflow) found without TAxis::FindBin
+  struct BakedAxis {
+    int nBins = 0;
+    double min = 0;
+    double invWidth = 0;
+    std::vector<double> edges{}; // only for variable binning
+    int FindBin(double val) const
+    {
+      if (!edges.empty())
+        return std::upper_bound(edges.begin(), edges.end(), val) - edges.begin();
+      if (!(val >= min))
+        return 0;
+      return std::min(static_cast<int>((val - min) * invWidth) + 1, nBins + 1);
+    }
+  };
+  struct BakedTable {
+    BakedAxis axes[3];
+    std::vector<float> invWeights{};
+    float Get(double x, double y, double z) const
+    {
+      return invWeights[(axes[2].FindBin(z) * (axes[1].nBins + 2) + axes[1].FindBin(y)) * (axes[0].nBins + 2) + axes[0].FindBin(x)];
+    }
+  };
+  BakedTable fNUATable; //!
+  BakedTable fNUETable; //!
+  bool fWeightsBaked;   //!
+  void BakeTable(TH3D* inh, BakedTable& table);
   void AddArray(TObjArray* targ, TObjArray* sour);
   const char* GetBinName(double ptv, double v0mv, const char* pf = "")
   {
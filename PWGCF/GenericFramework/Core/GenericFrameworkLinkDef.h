@@ -20,9 +20,9 @@
 #pragma link C++ class GFWCumulant + ;
 #pragma link C++ class GFW + ;
 #pragma link C++ class ProfileSubset + ;
-#pragma link C++ class FlowContainer + ;
+#pragma link C++ class FlowContainer - ;
 #pragma link C++ class GFWWeights + ;
-#pragma link C++ class BootstrapProfile + ;
+#pragma link C++ class BootstrapProfile - ;
 #pragma link C++ class FlowPtContainer + ;
 #pragma link C++ class o2::analysis::genericframework::GFWBinningCuts + ;
 #pragma link C++ class o2::analysis::genericframework::GFWRegions + ;
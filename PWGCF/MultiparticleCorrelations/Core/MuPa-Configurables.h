@@ -46,6 +46,8 @@ Configurable<int> cfFixedNumberOfRandomlySelectedTracks{
 // Correlations:
 Configurable<bool> cfCalculateCorrelations{"cfCalculateCorrelations", false,
                                            "calculate or not correlations"};
+Configurable<string> cfCorrelationsHarmonics{"cfCorrelationsHarmonics", "1 2 3 4 5 6",
+                                             "harmonics for which correlations are calculated (space-separated, from 1 to gMaxHarmonic)"};
 
 // Test0:
 Configurable<bool> cfCalculateTest0{"cfCalculateTest0", false,
@@ -116,6 +116,7 @@ struct Qvector_Arrays {
   TComplex fQvector[gMaxHarmonic * gMaxCorrelator + 1][gMaxCorrelator + 1] = {
     {TComplex(0., 0.)}}; //! "integrated" Q-vector
 } qv_a;
+std::map<std::vector<Int_t>, TComplex> fRecursionCache; //! terms of Recursion already calculated from the generic Q-vector [n,mult,skip,harmonics...]
 
 // *) Multiparticle correlations (standard, isotropic, same harmonic):
 TList* fCorrelationsList = NULL; // list to hold all correlations objects
@@ -123,6 +124,7 @@ TProfile* fCorrelationsFlagsPro =
   NULL; // profile to hold all flags for correlations
 Bool_t fCalculateCorrelations =
   kTRUE; // calculate and store integrated correlations
+Bool_t fCalculateCorrelationsHarmonic[gMaxHarmonic] = {kTRUE, kTRUE, kTRUE, kTRUE, kTRUE, kTRUE}; // calculate or not correlations in harmonic n=1,...,6
 struct Correlations_Arrays {
   TProfile* fCorrelationsPro[4][gMaxHarmonic][eAsFunctionOf_N] = {
     {{NULL}}}; //! multiparticle correlations
@@ -173,6 +175,7 @@ struct Test0_Arrays {
   TString* fTest0Labels[gMaxCorrelator][gMaxIndex] = {
     {NULL}}; // all labels: k-p'th order is stored in k-1'th index. So yes, I
              // also store 1-p
+  std::vector<Int_t> fTest0Harmonics[gMaxCorrelator][gMaxIndex]; //! harmonics extracted once from fTest0Labels
 } t0_a;
 TString fFileWithLabels =
   ""; // path to external ROOT file which specifies all labels of interest
@@ -162,6 +162,20 @@ void DefaultConfiguration()
   // Configurable<bool> cfCalculateCorrelations{ ... };
   fCalculateCorrelations = cfCalculateCorrelations;
 
+  // Configurable<string> cfCorrelationsHarmonics{ ... };
+  for (Int_t h = 0; h < gMaxHarmonic; h++) {
+    fCalculateCorrelationsHarmonic[h] = kFALSE;
+  }
+  TObjArray* oaHarmonics = TString(cfCorrelationsHarmonics).Tokenize(" ");
+  for (Int_t i = 0; i < oaHarmonics->GetEntries(); i++) {
+    Int_t h = TString(oaHarmonics->At(i)->GetName()).Atoi();
+    if (h < 1 || h > gMaxHarmonic) {
+      LOGF(fatal, "in function \033[1;31m%s at line %d, harmonic %d in cfCorrelationsHarmonics is not in [1,%d]\033[0m", __PRETTY_FUNCTION__, __LINE__, h, gMaxHarmonic);
+    }
+    fCalculateCorrelationsHarmonic[h - 1] = kTRUE;
+  }
+  delete oaHarmonics;
+
   // ...
 
   // Configurable<bool> cfCalculateTest0{ ... };
@@ -1536,6 +1550,9 @@ void CalculateCorrelations()
     if (tc.fVerbose) {
       LOGF(info, "\033[1;32m%s => calculating 2-particle correlations....\033[0m", __PRETTY_FUNCTION__);
     }
+    if (!fCalculateCorrelationsHarmonic[h - 1]) {
+      continue;
+    }
     TComplex two = Two(h, -h);
     Double_t twoC = two.Re(); // cos
     // Double_t twoS = two.Im(); // sin
@@ -1793,16 +1810,21 @@ void CalculateTest0()
       } // if(!t0_afTest0Labels[mo][mi])
 
       if (t0_a.fTest0Labels[mo][mi]) {
-        // Extract harmonics from TString, FS is " ":
-        for (Int_t h = 0; h <= mo; h++) {
+        // Extract harmonics from TString, FS is " ". This is done only once per label, and then reused in all events:
+        if (t0_a.fTest0Harmonics[mo][mi].empty()) {
           TObjArray* oa = t0_a.fTest0Labels[mo][mi]->Tokenize(" ");
           if (!oa) {
             LOGF(fatal, "in function \033[1;31m%s at line %d\033[0m",
                  __PRETTY_FUNCTION__, __LINE__);
           }
-          n[h] = TString(oa->At(h)->GetName()).Atoi();
+          for (Int_t h = 0; h <= mo; h++) {
+            t0_a.fTest0Harmonics[mo][mi].push_back(TString(oa->At(h)->GetName()).Atoi());
+          }
           delete oa; // yes, otherwise it's a memory leak
         }
+        for (Int_t h = 0; h <= mo; h++) {
+          n[h] = t0_a.fTest0Harmonics[mo][mi][h];
+        }
 
         switch (mo + 1) // which order? yes, mo+1
         {
@@ -2452,14 +2474,34 @@ TComplex Recursion(Int_t n, Int_t* harmonic, Int_t mult = 1, Int_t skip = 0)
 {
   // Calculate multi-particle correlators by using recursion (an improved faster version) originally developed by
   // Kristjan Gulbrandsen (gulbrand@nbi.dk).
+  // The same terms are met many times in the recursion for higher orders, so from 3 harmonics onwards
+  // each term is calculated only once from the current generic Q-vector, and then taken from fRecursionCache.
 
   Int_t nm1 = n - 1;
   TComplex c(Q(harmonic[nm1], mult));
   if (nm1 == 0)
     return c;
+
+  std::vector<Int_t> key;
+  if (n >= 3) {
+    key.reserve(n + 3);
+    key.push_back(n);
+    key.push_back(mult);
+    key.push_back(skip);
+    key.insert(key.end(), harmonic, harmonic + n);
+    auto cached = fRecursionCache.find(key);
+    if (cached != fRecursionCache.end()) {
+      return cached->second;
+    }
+  }
+
   c *= Recursion(nm1, harmonic);
-  if (nm1 == skip)
+  if (nm1 == skip) {
+    if (n >= 3) {
+      fRecursionCache.emplace(std::move(key), c);
+    }
     return c;
+  }
 
   Int_t multp1 = mult + 1;
   Int_t nm2 = n - 2;
@@ -2482,9 +2524,11 @@ TComplex Recursion(Int_t n, Int_t* harmonic, Int_t mult = 1, Int_t skip = 0)
   harmonic[nm2] = harmonic[counter1];
   harmonic[counter1] = hhold;
 
-  if (mult == 1)
-    return c - c2;
-  return c - Double_t(mult) * c2;
+  TComplex result = (mult == 1) ? c - c2 : c - Double_t(mult) * c2;
+  if (n >= 3) {
+    fRecursionCache.emplace(std::move(key), result);
+  }
+  return result;
 
 } // TComplex Recursion(Int_t n, Int_t* harmonic, Int_t mult = 1, Int_t skip = 0)
 
@@ -2505,6 +2549,7 @@ void ResetQ()
       qv_a.fQ[h][wp] = TComplex(0., 0.);
     }
   }
+  fRecursionCache.clear();
 
 } // void ResetQ()
 
@@ -40,6 +40,8 @@ using TrackSim = aod::McParticles::iterator;
 #include "Riostream.h"
 #include "TRandom3.h"
 #include <TComplex.h>
+#include <map>
+#include <vector>
 using namespace std;
 
 // *) Enums:
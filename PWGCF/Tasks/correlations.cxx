@@ -28,7 +28,9 @@
 #include "DataFormatsParameters/GRPMagField.h"
 
 #include <TH1F.h>
+#include <algorithm>
 #include <cmath>
+#include <vector>
 #include <TDirectory.h>
 #include <THn.h>
 
@@ -133,6 +135,16 @@ struct CorrelationTask {
     registry.add("eventcount_same", "bin", {HistType::kTH1F, {{maxMixBin + 2, -2.5, -0.5 + maxMixBin, "bin"}}});
     registry.add("eventcount_mixed", "bin", {HistType::kTH1F, {{maxMixBin + 2, -2.5, -0.5 + maxMixBin, "bin"}}});
 
+    if (doprocessMixedDerivedPool) {
+      if (cfgNoMixedEvents < 1) {
+        LOGF(fatal, "The event mixing with pools needs at least one mixed event per event");
+      }
+      mixingPools.resize(maxMixBin);
+      for (auto& pool : mixingPools) {
+        pool.events.resize(cfgNoMixedEvents);
+      }
+    }
+
     mPairCuts.SetHistogramRegistry(&registry);
 
     if (cfgPairCut->get("Photon") > 0 || cfgPairCut->get("K0") > 0 || cfgPairCut->get("Lambda") > 0 || cfgPairCut->get("Phi") > 0 || cfgPairCut->get("Rho") > 0) {
@@ -229,63 +241,81 @@ struct CorrelationTask {
     return true;
   }
 
-  template <CorrelationContainer::CFStep step, typename TTarget, typename TTracks>
-  void fillCorrelations(TTarget target, TTracks& tracks1, TTracks& tracks2, float multiplicity, float posZ, int magField, float eventWeight)
+  // Particle which passed the single-particle selections, with the quantities used in the pair loop
+  // The accessors have the names of the table columns, so that PairCuts can be used on it
+  struct ReducedTrack {
+    float mEta;
+    float mPhi;
+    float mPt;
+    float mEfficiency;
+    int mSign;
+    int64_t mGlobalIndex;
+    float eta() const { return mEta; }
+    float phi() const { return mPhi; }
+    float pt() const { return mPt; }
+    int sign() const { return mSign; }
+  };
+  std::vector<ReducedTrack> triggerTracks;
+  std::vector<ReducedTrack> associatedTracks;
+
+  template <CorrelationContainer::CFStep step, typename TTracks>
+  void gatherTracks(TTracks& tracks, int chargeSelection, THn* efficiency, float multiplicity, float posZ, std::vector<ReducedTrack>& reducedTracks)
   {
-    // Cache efficiency for particles (too many FindBin lookups)
-    float* efficiencyAssociated = nullptr;
-    if constexpr (step == CorrelationContainer::kCFStepCorrected) {
-      if (cfg.mEfficiencyAssociated) {
-        efficiencyAssociated = new float[tracks2.size()];
-        int i = 0;
-        for (auto& track : tracks2) {
-          efficiencyAssociated[i++] = getEfficiencyCorrection(cfg.mEfficiencyAssociated, track.eta(), track.pt(), multiplicity, posZ);
-        }
-      }
-    }
-
-    for (auto& track1 : tracks1) {
-      // LOGF(info, "Track %f | %f | %f  %d %d", track1.eta(), track1.phi(), track1.pt(), track1.isGlobalTrack(), track1.isGlobalTrackSDD());
-
+    reducedTracks.clear();
+    for (auto& track : tracks) {
       if constexpr (step <= CorrelationContainer::kCFStepTracked) {
-        if (!checkObject<step>(track1)) {
+        if (!checkObject<step>(track)) {
           continue;
         }
       }
-
-      if (cfgTriggerCharge != 0 && cfgTriggerCharge * track1.sign() < 0) {
+      if (chargeSelection != 0 && chargeSelection * track.sign() < 0) {
         continue;
       }
-
-      float triggerWeight = eventWeight;
+      // Cache efficiency for particles (too many FindBin lookups)
+      float efficiencyCorrection = 1.0f;
       if constexpr (step == CorrelationContainer::kCFStepCorrected) {
-        if (cfg.mEfficiencyTrigger) {
-          triggerWeight *= getEfficiencyCorrection(cfg.mEfficiencyTrigger, track1.eta(), track1.pt(), multiplicity, posZ);
+        if (efficiency) {
+          efficiencyCorrection = getEfficiencyCorrection(efficiency, track.eta(), track.pt(), multiplicity, posZ);
         }
       }
+      reducedTracks.push_back({track.eta(), track.phi(), track.pt(), efficiencyCorrection, track.sign(), track.globalIndex()});
+    }
+    // sorted in pT so that the pair loop can stop at the trigger pT when the pT ordering is required
+    if (cfgPtOrder != 0) {
+      std::sort(reducedTracks.begin(), reducedTracks.end(), [](const ReducedTrack& a, const ReducedTrack& b) { return a.mPt < b.mPt; });
+    }
+  }
 
-      target->getTriggerHist()->Fill(step, track1.pt(), multiplicity, posZ, triggerWeight);
+  template <CorrelationContainer::CFStep step, typename TTarget, typename TTracks>
+  void fillCorrelations(TTarget target, TTracks& tracks1, TTracks& tracks2, float multiplicity, float posZ, int magField, float eventWeight)
+  {
+    gatherTracks<step>(tracks1, cfgTriggerCharge, cfg.mEfficiencyTrigger, multiplicity, posZ, triggerTracks);
+    gatherTracks<step>(tracks2, cfgAssociatedCharge, cfg.mEfficiencyAssociated, multiplicity, posZ, associatedTracks);
+    fillPairs<step>(target, triggerTracks, associatedTracks, multiplicity, posZ, magField, eventWeight);
+  }
 
-      for (auto& track2 : tracks2) {
-        if (track1.globalIndex() == track2.globalIndex()) {
-          // LOGF(info, "Track identical: %f | %f | %f || %f | %f | %f", track1.eta(), track1.phi(), track1.pt(),  track2.eta(), track2.phi(), track2.pt());
-          continue;
-        }
+  template <CorrelationContainer::CFStep step, typename TTarget>
+  void fillPairs(TTarget target, const std::vector<ReducedTrack>& triggers, const std::vector<ReducedTrack>& associated, float multiplicity, float posZ, int magField, float eventWeight)
+  {
+    for (const auto& track1 : triggers) {
+      float triggerWeight = eventWeight;
+      if constexpr (step == CorrelationContainer::kCFStepCorrected) {
+        triggerWeight *= track1.mEfficiency;
+      }
 
-        if constexpr (step <= CorrelationContainer::kCFStepTracked) {
-          if (!checkObject<step>(track2)) {
-            continue;
-          }
-        }
+      target->getTriggerHist()->Fill(step, track1.mPt, multiplicity, posZ, triggerWeight);
 
-        if (cfgPtOrder != 0 && track2.pt() >= track1.pt()) {
-          continue;
+      for (const auto& track2 : associated) {
+        if (cfgPtOrder != 0 && track2.mPt >= track1.mPt) {
+          break; // sorted in pT
         }
 
-        if (cfgAssociatedCharge != 0 && cfgAssociatedCharge * track2.sign() < 0) {
+        if (track1.mGlobalIndex == track2.mGlobalIndex) {
+          // LOGF(info, "Track identical: %f | %f | %f || %f | %f | %f", track1.eta(), track1.phi(), track1.pt(),  track2.eta(), track2.phi(), track2.pt());
           continue;
         }
-        if (cfgPairCharge != 0 && cfgPairCharge * track1.sign() * track2.sign() < 0) {
+
+        if (cfgPairCharge != 0 && cfgPairCharge * track1.mSign * track2.mSign < 0) {
           continue;
         }
 
@@ -301,12 +331,10 @@ struct CorrelationTask {
 
         float associatedWeight = triggerWeight;
         if constexpr (step == CorrelationContainer::kCFStepCorrected) {
-          if (cfg.mEfficiencyAssociated) {
-            associatedWeight *= efficiencyAssociated[track2.filteredIndex()];
-          }
+          associatedWeight *= track2.mEfficiency;
         }
 
-        float deltaPhi = track1.phi() - track2.phi();
+        float deltaPhi = track1.mPhi - track2.mPhi;
         if (deltaPhi > 1.5f * PI) {
           deltaPhi -= TwoPI;
         }
@@ -315,11 +343,9 @@ struct CorrelationTask {
         }
 
         target->getPairHist()->Fill(step,
-                                    track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, associatedWeight);
+                                    track1.mEta - track2.mEta, track2.mPt, track1.mPt, multiplicity, deltaPhi, posZ, associatedWeight);
       }
     }
-
-    delete[] efficiencyAssociated;
   }
 
   void loadEfficiency(uint64_t timestamp)
@@ -490,6 +516,57 @@ struct CorrelationTask {
   }
   PROCESS_SWITCH(CorrelationTask, processMixedDerived, "Process mixed events on derived data", false);
 
+  // Event mixing with pools: for each (vertex, multiplicity) bin, the associated particles of the last cfgNoMixedEvents events
+  // are kept in a ring buffer, and each new event is mixed with the events of its pool
+  struct MixingPool {
+    std::vector<std::vector<ReducedTrack>> events;
+    int next = 0; // position in the ring buffer of the next event
+    int nEvents = 0;
+  };
+  std::vector<MixingPool> mixingPools;
+
+  void processMixedDerivedPool(derivedCollisions::iterator const& collision, derivedTracks const& tracks)
+  {
+    int bin = configurableBinningDerived.getBin({collision.posZ(), collision.multiplicity()});
+    if (bin < 0) {
+      return;
+    }
+    loadEfficiency(collision.timestamp());
+
+    const auto multiplicity = collision.multiplicity();
+    int field = 0;
+    if (cfgTwoTrackCut > 0) {
+      field = getMagneticField(collision.timestamp());
+    }
+    const bool useEfficiency = cfg.mEfficiencyAssociated || cfg.mEfficiencyTrigger;
+
+    auto& pool = mixingPools[bin];
+    if (cfgVerbosity > 0) {
+      LOGF(info, "processMixedDerivedPool: collision %d (%.3f, %.3f) in bin %d mixed with %d events", collision.globalIndex(), collision.posZ(), multiplicity, bin, pool.nEvents);
+    }
+    if (pool.nEvents > 0) {
+      float eventWeight = 1.0f / pool.nEvents;
+      gatherTracks<CorrelationContainer::kCFStepCorrected>(tracks, cfgTriggerCharge, cfg.mEfficiencyTrigger, multiplicity, collision.posZ(), triggerTracks);
+      mixed->fillEvent(multiplicity, CorrelationContainer::kCFStepReconstructed);
+      if (useEfficiency) {
+        mixed->fillEvent(multiplicity, CorrelationContainer::kCFStepCorrected);
+      }
+      for (int i = 0; i < pool.nEvents; i++) {
+        registry.fill(HIST("eventcount_mixed"), bin);
+        fillPairs<CorrelationContainer::kCFStepReconstructed>(mixed, triggerTracks, pool.events[i], multiplicity, collision.posZ(), field, eventWeight);
+        if (useEfficiency) {
+          fillPairs<CorrelationContainer::kCFStepCorrected>(mixed, triggerTracks, pool.events[i], multiplicity, collision.posZ(), field, eventWeight);
+        }
+      }
+    }
+
+    // the current event replaces the oldest one of the pool
+    gatherTracks<CorrelationContainer::kCFStepCorrected>(tracks, cfgAssociatedCharge, cfg.mEfficiencyAssociated, multiplicity, collision.posZ(), pool.events[pool.next]);
+    pool.next = (pool.next + 1) % pool.events.size();
+    pool.nEvents = std::min<int>(pool.nEvents + 1, pool.events.size());
+  }
+  PROCESS_SWITCH(CorrelationTask, processMixedDerivedPool, "Process mixed events on derived data with event pools kept in memory (instead of processMixedDerived)", false);
+
   // Version with combinations
   /*void processWithCombinations(soa::Join<aod::Collisions, aod::CentRun2V0Ms>::iterator const& collision, aod::BCsWithTimestamps const&, soa::Filtered<aod::Tracks> const& tracks)
   {
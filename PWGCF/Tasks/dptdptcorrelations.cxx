@@ -247,12 +247,46 @@ struct DptDptCorrelationsTask {
       for (auto& t : tracks) {
         if (fhPtAvg_vsEtaPhi[t.trackacceptedid()] != nullptr) {
           (*ptavg)[index] = fhPtAvg_vsEtaPhi[t.trackacceptedid()]->GetBinContent(fhPtAvg_vsEtaPhi[t.trackacceptedid()]->FindFixBin(t.eta(), t.phi()));
-          index++;
         }
+        index++;
       }
       return ptavg;
     }
 
+    /// \brief the track magnitudes used in the pair loop
+    struct PairTrack {
+      int id;       ///< the track accepted id
+      int etaix;    ///< the zero based eta bin index
+      int phiix;    ///< the zero based phi bin index, with the potential phi origin shift
+      float pt;     ///< the track \f$p_T\f$
+      float eta;    ///< the track \f$\eta\f$
+      float phi;    ///< the track \f$\phi\f$
+      double corr;  ///< the track correction
+      double ptavg; ///< the track average \f$p_T\f$
+    };
+    std::vector<PairTrack> pairtracks1; //!<! the magnitudes of the first tracks of the pairs for the current collision
+    std::vector<PairTrack> pairtracks2; //!<! the magnitudes of the second tracks of the pairs for the current collision
+
+    /// \brief extracts the track magnitudes used in the pair loop
+    /// So that they are obtained once per track and not for each pair the track enters
+    template <typename TrackListObject>
+    void fillPairTracks(TrackListObject const& tracks, std::vector<float>* corrs, std::vector<float>* ptavgs, std::vector<PairTrack>& pairtracks)
+    {
+      using namespace correlationstask;
+      using namespace o2::analysis::dptdptfilter;
+
+      pairtracks.clear();
+      pairtracks.reserve(tracks.size());
+      int index = 0;
+      for (auto& t : tracks) {
+        int etaix = static_cast<int>((t.eta() - etalow) / etabinwidth);
+        /* consider a potential phi origin shift */
+        int phiix = static_cast<int>((GetShiftedPhi(t.phi()) - philow) / phibinwidth);
+        pairtracks.push_back({static_cast<int>(t.trackacceptedid()), etaix, phiix, t.pt(), t.eta(), t.phi(), (*corrs)[index], (*ptavgs)[index]});
+        index++;
+      }
+    }
+
     /// \brief fills the singles histograms in singles execution mode
     /// \param passedtracks filtered table with the tracks associated to the passed index
     /// \param tix index, in the singles histogram bank, for the passed filetered track table
@@ -317,6 +351,7 @@ struct DptDptCorrelationsTask {
     void processTrackPairs(TrackOneListObject const& trks1, TrackTwoListObject const& trks2, std::vector<float>* corrs1, std::vector<float>* corrs2, std::vector<float>* ptavgs1, std::vector<float>* ptavgs2, float cmul, int bfield)
     {
       using namespace correlationstask;
+      using namespace o2::analysis::dptdptfilter;
 
       /* process pair magnitudes */
       std::vector<std::vector<double>> n2(nch, std::vector<double>(nch, 0.0));           ///< weighted number of track 1 track 2 pairs for current collision
@@ -326,13 +361,24 @@ struct DptDptCorrelationsTask {
       std::vector<std::vector<double>> n2nw(nch, std::vector<double>(nch, 0.0));         ///< not weighted number of track1 track 2 pairs for current collision
       std::vector<std::vector<double>> sum2PtPtnw(nch, std::vector<double>(nch, 0.0));   ///< accumulated sum of not weighted track 1 track 2 \f${p_T}_1 {p_T}_2\f$ for current collision
       std::vector<std::vector<double>> sum2DptDptnw(nch, std::vector<double>(nch, 0.0)); ///< accumulated sum of not weighted number of track 1 tracks times not weighted track 2 \f$p_T\f$ for current collision
-      int index1 = 0;
 
+      /* the track magnitudes are extracted once per track */
+      fillPairTracks(trks1, corrs1, ptavgs1, pairtracks1);
+      if (corrs2 != corrs1) {
+        fillPairTracks(trks2, corrs2, ptavgs2, pairtracks2);
+      }
+      const std::vector<PairTrack>& ptrks1 = pairtracks1;
+      const std::vector<PairTrack>& ptrks2 = (corrs2 != corrs1) ? pairtracks2 : pairtracks1;
+      /* the differential histograms, without Sumw2 structure, are accumulated directly in their bin contents */
+      /* rule: ix are always zero based while bins are always one based */
+      const int deltaetanbins = fhN2_vsDEtaDPhi[0][0]->GetNbinsX() + 2;
+
+      int index1 = 0;
       for (auto& track1 : trks1) {
-        double ptavg_1 = (*ptavgs1)[index1];
-        double corr1 = (*corrs1)[index1];
+        const PairTrack& ptrk1 = ptrks1[index1++];
         int index2 = 0;
         for (auto& track2 : trks2) {
+          const PairTrack& ptrk2 = ptrks2[index2++];
           /* checking the same track id condition */
           if (track1 == track2) {
             /* exclude autocorrelations */
@@ -340,21 +386,27 @@ struct DptDptCorrelationsTask {
           }
 
           if constexpr (doptorder) {
-            if (track2.pt() >= track1.pt()) {
+            if (ptrk2.pt >= ptrk1.pt) {
               continue;
             }
           }
           /* process pair magnitudes */
-          double ptavg_2 = (*ptavgs2)[index2];
-          double corr2 = (*corrs2)[index2];
-          double corr = corr1 * corr2;
-          double dptdptnw = (track1.pt() - ptavg_1) * (track2.pt() - ptavg_2);
-          double dptdptw = (corr1 * track1.pt() - ptavg_1) * (corr2 * track2.pt() - ptavg_2);
+          const int pid1 = ptrk1.id;
+          const int pid2 = ptrk2.id;
+          double corr = ptrk1.corr * ptrk2.corr;
+          double ptpt = ptrk1.pt * ptrk2.pt;
+          double dptdptnw = (ptrk1.pt - ptrk1.ptavg) * (ptrk2.pt - ptrk2.ptavg);
+          double dptdptw = (ptrk1.corr * ptrk1.pt - ptrk1.ptavg) * (ptrk2.corr * ptrk2.pt - ptrk2.ptavg);
 
           /* get the global bin for filling the differential histograms */
-          int globalbin = GetDEtaDPhiGlobalIndex(track1, track2);
-          float deltaeta = track1.eta() - track2.eta();
-          float deltaphi = track1.phi() - track2.phi();
+          int deltaeta_ix = ptrk1.etaix - ptrk2.etaix + etabins - 1;
+          int deltaphi_ix = ptrk1.phiix - ptrk2.phiix;
+          if (deltaphi_ix < 0) {
+            deltaphi_ix += phibins;
+          }
+          int globalbin = (deltaphi_ix + 1) * deltaetanbins + deltaeta_ix + 1;
+          float deltaeta = ptrk1.eta - ptrk2.eta;
+          float deltaphi = ptrk1.phi - ptrk2.phi;
           while (deltaphi >= deltaphiup) {
             deltaphi -= constants::math::TwoPI;
           }
@@ -363,27 +415,25 @@ struct DptDptCorrelationsTask {
           }
           if ((fUseConversionCuts && fPairCuts.conversionCuts(track1, track2)) || (fUseTwoTrackCut && fPairCuts.twoTrackCut(track1, track2, bfield))) {
             /* suppress the pair */
-            fhSupN1N1_vsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->AddBinContent(globalbin, corr);
-            fhSupPt1Pt1_vsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->AddBinContent(globalbin, track1.pt() * track2.pt() * corr);
-            n2sup[track1.trackacceptedid()][track2.trackacceptedid()] += corr;
+            fhSupN1N1_vsDEtaDPhi[pid1][pid2]->GetArray()[globalbin] += corr;
+            fhSupPt1Pt1_vsDEtaDPhi[pid1][pid2]->GetArray()[globalbin] += ptpt * corr;
+            n2sup[pid1][pid2] += corr;
           } else {
             /* count the pair */
-            n2[track1.trackacceptedid()][track2.trackacceptedid()] += corr;
-            sum2PtPt[track1.trackacceptedid()][track2.trackacceptedid()] += track1.pt() * track2.pt() * corr;
-            sum2DptDpt[track1.trackacceptedid()][track2.trackacceptedid()] += dptdptw;
-            n2nw[track1.trackacceptedid()][track2.trackacceptedid()] += 1;
-            sum2PtPtnw[track1.trackacceptedid()][track2.trackacceptedid()] += track1.pt() * track2.pt();
-            sum2DptDptnw[track1.trackacceptedid()][track2.trackacceptedid()] += dptdptnw;
-
-            fhN2_vsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->AddBinContent(globalbin, corr);
-            fhN2cont_vsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->Fill(deltaeta, deltaphi, corr);
-            fhSum2DptDpt_vsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->AddBinContent(globalbin, dptdptw);
-            fhSum2PtPt_vsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->AddBinContent(globalbin, track1.pt() * track2.pt() * corr);
+            n2[pid1][pid2] += corr;
+            sum2PtPt[pid1][pid2] += ptpt * corr;
+            sum2DptDpt[pid1][pid2] += dptdptw;
+            n2nw[pid1][pid2] += 1;
+            sum2PtPtnw[pid1][pid2] += ptpt;
+            sum2DptDptnw[pid1][pid2] += dptdptnw;
+
+            fhN2_vsDEtaDPhi[pid1][pid2]->GetArray()[globalbin] += corr;
+            fhN2cont_vsDEtaDPhi[pid1][pid2]->Fill(deltaeta, deltaphi, corr);
+            fhSum2DptDpt_vsDEtaDPhi[pid1][pid2]->GetArray()[globalbin] += dptdptw;
+            fhSum2PtPt_vsDEtaDPhi[pid1][pid2]->GetArray()[globalbin] += ptpt * corr;
           }
-          fhN2_vsPtPt[track1.trackacceptedid()][track2.trackacceptedid()]->Fill(track1.pt(), track2.pt(), corr);
-          index2++;
+          fhN2_vsPtPt[pid1][pid2]->Fill(ptrk1.pt, ptrk2.pt, corr);
         }
-        index1++;
       }
       for (uint pid1 = 0; pid1 < nch; ++pid1) {
         for (uint pid2 = 0; pid2 < nch; ++pid2) {
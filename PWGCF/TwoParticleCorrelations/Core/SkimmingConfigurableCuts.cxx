@@ -769,6 +769,29 @@ std::vector<bool> CutBrickSelectorMultipleRanges<TValueToFilter>::Filter(const T
   return std::vector<bool>(mActive);
 }
 
+/// \brief Filter the passed value storing the status of the ranges in the mask
+/// \param value The value to filter
+/// \param mask The mask where to store the status of the ranges
+/// \param bit The first bit of the brick in the mask, advanced by the number of ranges
+/// \return true if the value is within any of the ranges false otherwise
+template <typename TValueToFilter>
+bool CutBrickSelectorMultipleRanges<TValueToFilter>::FilterInMask(const TValueToFilter& value, uint64_t& mask, int& bit)
+{
+  bool found = false;
+  bool inrange = (mEdges.front() <= value) and (value < mEdges.back());
+  for (unsigned int i = 0; i < mActive.size(); ++i) {
+    bool active = inrange and not found and (value < mEdges[i + 1]);
+    mActive[i] = active;
+    if (active) {
+      found = true;
+      SETBIT(mask, bit);
+    }
+    bit++;
+  }
+  this->mState = inrange ? this->kACTIVE : this->kPASSIVE;
+  return found;
+}
+
 templateClassImp(CutBrickSelectorMultipleRanges);
 template class o2::analysis::PWGCF::CutBrickSelectorMultipleRanges<int>;
 template class o2::analysis::PWGCF::CutBrickSelectorMultipleRanges<float>;
@@ -987,6 +1010,26 @@ std::vector<bool> CutWithVariations<TValueToFilter>::Filter(const TValueToFilter
   return res;
 }
 
+/// Filters the passed value storing the status of the bricks in the mask
+/// The bricks on the default values list and in the variation
+/// values list will change to active or passive accordingly to the passed value
+/// \param value The value to filter
+/// \param mask The mask where to store the status of the bricks
+/// \param bit The first bit of the cut in the mask, advanced by the cut length
+/// \returns true if the value activated any of the bricks
+template <typename TValueToFilter>
+bool CutWithVariations<TValueToFilter>::FilterInMask(const TValueToFilter& value, uint64_t& mask, int& bit)
+{
+  bool atleastone = false;
+  for (int i = 0; i < mDefaultBricks.GetEntries(); ++i) {
+    atleastone = ((CutBrick<TValueToFilter>*)mDefaultBricks.At(i))->FilterInMask(value, mask, bit) or atleastone;
+  }
+  for (int i = 0; i < mVariationBricks.GetEntries(); ++i) {
+    atleastone = ((CutBrick<TValueToFilter>*)mVariationBricks.At(i))->FilterInMask(value, mask, bit) or atleastone;
+  }
+  return atleastone;
+}
+
 /// Return the length needed to code the cut
 /// The length is in brick units. The actual length is implementation dependent
 /// \returns Cut length in units of bricks
@@ -18,6 +18,7 @@
 #include <TMath.h>
 #include <TList.h>
 #include <TF1.h>
+#include <cstdint>
 #include <set>
 #include <vector>
 #include <regex>
@@ -57,6 +58,11 @@ class CutBrick : public TNamed
   /// fits within the brick or brick components scope
   /// \returns a vector of booleans with true on the component for which the value activated the component brick
   virtual std::vector<bool> Filter(const TValueToFilter&) = 0;
+  /// Virtual function. Filters the passed value as Filter() does but stores the status
+  /// of the brick components directly in the passed mask, starting at the passed bit,
+  /// which is advanced by the brick length
+  /// \returns true if the value activated any of the brick components
+  virtual bool FilterInMask(const TValueToFilter&, uint64_t& mask, int& bit);
   /// Pure virtual function. Return the length needed to code the brick status
   /// The length is in brick units. The actual length is implementation dependent
   /// \returns Brick length in units of bricks
@@ -91,12 +97,43 @@ class CutBrick : public TNamed
     kSELECTED    ///< if the status of the brick is significative
   };
 
+  /// Stores the status of a single component brick and its bit in the mask
+  bool storeState(bool active, uint64_t& mask, int& bit)
+  {
+    mState = active ? kACTIVE : kPASSIVE;
+    if (active) {
+      SETBIT(mask, bit);
+    }
+    bit++;
+    return active;
+  }
+
   BrickStatus mState = kPASSIVE;
   BrickMode mMode = kUNSELECTED;
 
   ClassDef(CutBrick, 1);
 };
 
+/// \brief Filter the passed value storing the status of the brick components in the mask
+/// The default implementation relies on Filter()
+/// \param value The value to filter
+/// \param mask The mask where to store the status of the brick components
+/// \param bit The first bit of the brick in the mask, advanced by the brick length
+/// \return true if the value activated any of the brick components
+template <typename TValueToFilter>
+inline bool CutBrick<TValueToFilter>::FilterInMask(const TValueToFilter& value, uint64_t& mask, int& bit)
+{
+  bool atleastone = false;
+  for (bool b : Filter(value)) {
+    if (b) {
+      atleastone = true;
+      SETBIT(mask, bit);
+    }
+    bit++;
+  }
+  return atleastone;
+}
+
 /// \class CutBrickLimit
 /// \brief Class which implements a limiting cut brick.
 /// The brick will be active if the filtered value is below the limit
@@ -113,6 +150,10 @@ class CutBrickLimit : public CutBrick<TValueToFilter>
 
   virtual std::vector<bool> IsArmed() override;
   virtual std::vector<bool> Filter(const TValueToFilter&) override;
+  virtual bool FilterInMask(const TValueToFilter& value, uint64_t& mask, int& bit) override
+  {
+    return this->storeState(value < mLimit, mask, bit);
+  }
   virtual int Length() override { return 1; }
 
  private:
@@ -184,6 +225,10 @@ class CutBrickThreshold : public CutBrick<TValueToFilter>
 
   virtual std::vector<bool> IsArmed() override;
   virtual std::vector<bool> Filter(const TValueToFilter&) override;
+  virtual bool FilterInMask(const TValueToFilter& value, uint64_t& mask, int& bit) override
+  {
+    return this->storeState(mThreshold < value, mask, bit);
+  }
   virtual int Length() override { return 1; }
 
  private:
@@ -255,6 +300,10 @@ class CutBrickRange : public CutBrick<TValueToFilter>
 
   virtual std::vector<bool> IsArmed() override;
   virtual std::vector<bool> Filter(const TValueToFilter&) override;
+  virtual bool FilterInMask(const TValueToFilter& value, uint64_t& mask, int& bit) override
+  {
+    return this->storeState((mLow < value) and (value < mUp), mask, bit);
+  }
   virtual int Length() override { return 1; }
 
  private:
@@ -329,6 +378,10 @@ class CutBrickExtToRange : public CutBrick<TValueToFilter>
 
   virtual std::vector<bool> IsArmed() override;
   virtual std::vector<bool> Filter(const TValueToFilter&) override;
+  virtual bool FilterInMask(const TValueToFilter& value, uint64_t& mask, int& bit) override
+  {
+    return this->storeState((value < mLow) or (mUp < value), mask, bit);
+  }
   virtual int Length() override { return 1; }
 
  private:
@@ -405,6 +458,7 @@ class CutBrickSelectorMultipleRanges : public CutBrick<TValueToFilter>
 
   virtual std::vector<bool> IsArmed() override;
   virtual std::vector<bool> Filter(const TValueToFilter&) override;
+  virtual bool FilterInMask(const TValueToFilter&, uint64_t& mask, int& bit) override;
   /// Return the length needed to code the brick status
   /// The length is in brick units. The actual length is implementation dependent
   /// \returns Brick length in units of bricks
@@ -439,6 +493,7 @@ class CutWithVariations : public CutBrick<TValueToFilter>
   TList& getVariantBricks() { return mVariationBricks; }
   virtual std::vector<bool> IsArmed() override;
   virtual std::vector<bool> Filter(const TValueToFilter&) override;
+  virtual bool FilterInMask(const TValueToFilter&, uint64_t& mask, int& bit) override;
   virtual int Length() override;
   virtual int getArmedIndex() override;
 
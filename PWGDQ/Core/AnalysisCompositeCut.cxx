@@ -11,6 +11,9 @@
 
 #include "PWGDQ/Core/AnalysisCompositeCut.h"
 
+#include <algorithm>
+#include <vector>
+
 ClassImp(AnalysisCompositeCut)
 
   //____________________________________________________________________________
@@ -68,3 +71,40 @@ bool AnalysisCompositeCut::IsSelected(float* values)
     return false;
   }
 }
+
+void AnalysisCompositeCut::IsSelected(const float* columns, int nObjects, uint8_t* selected)
+{
+  //
+  // apply cuts on a batch of objects
+  //
+  if (fOptionUseAND) {
+    // each cut narrows down the selection
+    for (auto& cut : fCutList) {
+      cut.IsSelected(columns, nObjects, selected);
+    }
+    for (auto& cut : fCompositeCutList) {
+      cut.IsSelected(columns, nObjects, selected);
+    }
+    return;
+  }
+
+  // OR: each cut is checked only on the objects not yet accepted by the previous cuts
+  std::vector<uint8_t> accepted(nObjects, 0);
+  std::vector<uint8_t> candidates(nObjects);
+  auto applyOR = [&](AnalysisCut& cut) {
+    for (int i = 0; i < nObjects; ++i) {
+      candidates[i] = selected[i] && !accepted[i];
+    }
+    cut.IsSelected(columns, nObjects, candidates.data());
+    for (int i = 0; i < nObjects; ++i) {
+      accepted[i] |= candidates[i];
+    }
+  };
+  for (auto& cut : fCutList) {
+    applyOR(cut);
+  }
+  for (auto& cut : fCompositeCutList) {
+    applyOR(cut);
+  }
+  std::copy(accepted.begin(), accepted.end(), selected);
+}
@@ -41,8 +41,11 @@ class AnalysisCompositeCut : public AnalysisCut
 
   bool GetUseAND() const { return fOptionUseAND; }
   int GetNCuts() const { return fCutList.size() + fCompositeCutList.size(); }
+  const std::vector<AnalysisCut>& GetCutList() const { return fCutList; }
+  const std::vector<AnalysisCompositeCut>& GetCompositeCutList() const { return fCompositeCutList; }
 
   bool IsSelected(float* values) override;
+  void IsSelected(const float* columns, int nObjects, uint8_t* selected) override;
 
  protected:
   bool fOptionUseAND;                                  // true (default): apply AND on all cuts; false: use OR
@@ -19,6 +19,7 @@
 
 #include <TF1.h>
 #include <vector>
+#include <cstdint>
 
 //_________________________________________________________________________
 class AnalysisCut : public TNamed
@@ -39,6 +40,9 @@ class AnalysisCut : public TNamed
               int dependentVar2 = -1, float depCut2Low = 0., float depCut2High = 0., bool depCut2Exclude = false);
 
   virtual bool IsSelected(float* values);
+  // Apply the cuts on a batch of objects stored column-major, columns[var * nObjects + iObject]
+  // On input, selected[iObject] flags the objects to be checked; on output, it is reset for the rejected ones
+  virtual void IsSelected(const float* columns, int nObjects, uint8_t* selected);
 
   static std::vector<int> fgUsedVars; //! vector of used variables
 
@@ -62,6 +66,8 @@ class AnalysisCut : public TNamed
     TF1* fFuncHigh; // function for the upper limit cut
   };
 
+  const std::vector<CutContainer>& GetCuts() const { return fCuts; }
+
  protected:
   std::vector<CutContainer> fCuts;
 
@@ -174,4 +180,43 @@ inline bool AnalysisCut::IsSelected(float* values)
   return true;
 }
 
+//____________________________________________________________________________
+inline void AnalysisCut::IsSelected(const float* columns, int nObjects, uint8_t* selected)
+{
+  //
+  // apply the configured cuts on a batch of objects
+  //
+  auto column = [&](int var) { return columns + static_cast<std::size_t>(var) * nObjects; };
+  for (auto const& cut : fCuts) {
+    const float* values = column(cut.fVar);
+    const float* depValues = (cut.fDepVar != -1 ? column(cut.fDepVar) : nullptr);
+    const float* dep2Values = (cut.fDepVar2 != -1 ? column(cut.fDepVar2) : nullptr);
+    for (int i = 0; i < nObjects; ++i) {
+      if (!selected[i]) {
+        continue;
+      }
+      // check whether the dependent variables were enabled and if they are in the requested range
+      if (depValues) {
+        bool inRange = (depValues[i] > cut.fDepLow && depValues[i] <= cut.fDepHigh);
+        if (inRange == cut.fDepExclude) {
+          continue;
+        }
+      }
+      if (dep2Values) {
+        bool inRange = (dep2Values[i] > cut.fDep2Low && dep2Values[i] <= cut.fDep2High);
+        if (inRange == cut.fDep2Exclude) {
+          continue;
+        }
+      }
+      // obtain the low and high cut values (either directly as a value or from a function)
+      float cutLow = (cut.fFuncLow ? cut.fFuncLow->Eval(depValues[i]) : cut.fLow);
+      float cutHigh = (cut.fFuncHigh ? cut.fFuncHigh->Eval(depValues[i]) : cut.fHigh);
+      bool inRange = (values[i] >= cutLow && values[i] <= cutHigh);
+      if (inRange == cut.fExclude) {
+        selected[i] = 0;
+      }
+    }
+  }
+}
+
 #endif
@@ -0,0 +1,138 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "PWGDQ/Core/AnalysisCutEvaluator.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "Framework/Logger.h"
+
+//____________________________________________________________________________
+void AnalysisCutEvaluator::AddCut(const AnalysisCut& cut)
+{
+  //
+  // add a simple cut: an AND of its cut containers
+  //
+  if (fRoots.size() >= 64) {
+    LOG(fatal) << "AnalysisCutEvaluator::AddCut(): Maximum 64 cuts are supported, cannot add " << cut.GetName();
+  }
+  std::vector<int> items;
+  AddConditions(cut, items);
+  int node = AddNode(true);
+  FinishNode(node, items);
+  fRoots.push_back(node);
+}
+
+//____________________________________________________________________________
+void AnalysisCutEvaluator::AddCut(const AnalysisCompositeCut& cut)
+{
+  //
+  // add a composite cut
+  //
+  if (fRoots.size() >= 64) {
+    LOG(fatal) << "AnalysisCutEvaluator::AddCut(): Maximum 64 cuts are supported, cannot add " << cut.GetName();
+  }
+  std::vector<int> items;
+  // use the opposite logic for the (virtual) parent, such that a separate node is created
+  AddComposite(cut, items, !cut.GetUseAND());
+  fRoots.push_back(-items[0] - 1);
+}
+
+//____________________________________________________________________________
+int AnalysisCutEvaluator::AddNode(bool useAND)
+{
+  fNodes.push_back({useAND, 0, 0});
+  return fNodes.size() - 1;
+}
+
+//____________________________________________________________________________
+void AnalysisCutEvaluator::FinishNode(int node, const std::vector<int>& items)
+{
+  //
+  // store the items of a node contiguously
+  //
+  fNodes[node].fBegin = fItems.size();
+  fItems.insert(fItems.end(), items.begin(), items.end());
+  fNodes[node].fEnd = fItems.size();
+  fItemNEval.resize(fItems.size(), 0);
+  fItemNDecisive.resize(fItems.size(), 0);
+}
+
+//____________________________________________________________________________
+void AnalysisCutEvaluator::AddConditions(const AnalysisCut& cut, std::vector<int>& items)
+{
+  for (auto const& container : cut.GetCuts()) {
+    fConditions.push_back(container);
+    items.push_back(fConditions.size() - 1);
+  }
+}
+
+//____________________________________________________________________________
+void AnalysisCutEvaluator::AddComposite(const AnalysisCompositeCut& cut, std::vector<int>& items, bool parentUseAND)
+{
+  //
+  // flatten a composite cut into the items of its parent
+  // NOTE: nested cuts using the same logic as their parent are merged into the parent node
+  //
+  bool useAND = cut.GetUseAND();
+  bool merge = (useAND == parentUseAND);
+  std::vector<int> nodeItems;
+  std::vector<int>& target = (merge ? items : nodeItems);
+
+  for (auto const& simpleCut : cut.GetCutList()) {
+    if (useAND) {
+      AddConditions(simpleCut, target);
+    } else {
+      std::vector<int> leafItems;
+      AddConditions(simpleCut, leafItems);
+      int leaf = AddNode(true);
+      FinishNode(leaf, leafItems);
+      target.push_back(-leaf - 1);
+    }
+  }
+  for (auto const& compositeCut : cut.GetCompositeCutList()) {
+    AddComposite(compositeCut, target, useAND);
+  }
+
+  if (!merge) {
+    int node = AddNode(useAND);
+    FinishNode(node, nodeItems);
+    items.push_back(-node - 1);
+  }
+}
+
+//____________________________________________________________________________
+void AnalysisCutEvaluator::Reorder()
+{
+  //
+  // sort the items of each node by the fraction of evaluations in which they decided the node
+  //
+  for (auto const& node : fNodes) {
+    int nItems = node.fEnd - node.fBegin;
+    if (nItems < 2) {
+      continue;
+    }
+    std::vector<int> order(nItems);
+    std::iota(order.begin(), order.end(), node.fBegin);
+    auto fraction = [&](int k) {
+      return (fItemNEval[k] > 0 ? static_cast<double>(fItemNDecisive[k]) / fItemNEval[k] : 0.0);
+    };
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return fraction(a) > fraction(b); });
+    std::vector<int> sortedItems(nItems);
+    for (int k = 0; k < nItems; ++k) {
+      sortedItems[k] = fItems[order[k]];
+    }
+    std::copy(sortedItems.begin(), sortedItems.end(), fItems.begin() + node.fBegin);
+  }
+  std::fill(fItemNEval.begin(), fItemNEval.end(), 0);
+  std::fill(fItemNDecisive.begin(), fItemNDecisive.end(), 0);
+}
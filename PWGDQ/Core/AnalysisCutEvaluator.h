@@ -0,0 +1,171 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+// Class which flattens a list of AnalysisCut / AnalysisCompositeCut trees into a compact
+//   program, evaluated without virtual dispatch and producing directly the filter bit maps
+// The decision of the i-th added cut is stored in the i-th bit of the filter map. The sub-cuts
+//   of each node are reordered after a training phase, such that the most decisive ones
+//   (most rejecting for AND, most accepting for OR) are evaluated first. Since all the
+//   sub-cuts are pure selections, the reordering does not change the decisions.
+//
+
+#ifndef AnalysisCutEvaluator_H
+#define AnalysisCutEvaluator_H
+
+#include "PWGDQ/Core/AnalysisCut.h"
+#include "PWGDQ/Core/AnalysisCompositeCut.h"
+
+#include <cstdint>
+#include <vector>
+
+//_________________________________________________________________________
+class AnalysisCutEvaluator
+{
+ public:
+  AnalysisCutEvaluator() = default;
+  ~AnalysisCutEvaluator() = default;
+
+  // add a cut; the decision is stored in the bit with the index of the AddCut() call (maximum 64 cuts)
+  void AddCut(const AnalysisCut& cut);
+  void AddCut(const AnalysisCompositeCut& cut);
+  int GetNCuts() const { return fRoots.size(); }
+
+  // number of objects used to measure the selectivity of each sub-cut, before reordering them
+  // NOTE: 0 disables the reordering, and the sub-cuts are evaluated in the configured order
+  void SetNTrainingObjects(int n) { fNTrainingObjects = n; }
+
+  // evaluate all the cuts on one object with the values indexed by variable (e.g. VarManager::fgValues)
+  uint64_t Evaluate(const float* values);
+  // evaluate all the cuts on a batch of objects stored column-major, columns[var * nObjects + iObject]
+  void Evaluate(const float* columns, int nObjects, uint64_t* filterMaps);
+
+ private:
+  struct Node {
+    bool fUseAND; // AND or OR of the items
+    int fBegin;   // first item in fItems
+    int fEnd;     // end of the item range in fItems
+  };
+
+  std::vector<AnalysisCut::CutContainer> fConditions; // single variable selections
+  std::vector<Node> fNodes;                           // AND / OR nodes
+  std::vector<int> fItems;                            // node items: >= 0 for conditions, -(node + 1) for nodes
+  std::vector<int> fRoots;                            // root node for each filter bit
+  // training counters, per item
+  std::vector<uint32_t> fItemNEval;     // number of evaluations
+  std::vector<uint32_t> fItemNDecisive; // number of evaluations which decided the node
+  int fNTrainingObjects = 1000;         // number of objects used for the training
+  int fNEvaluatedObjects = 0;           // number of objects evaluated so far
+
+  int AddNode(bool useAND);
+  void AddConditions(const AnalysisCut& cut, std::vector<int>& items);
+  void AddComposite(const AnalysisCompositeCut& cut, std::vector<int>& items, bool parentUseAND);
+  void FinishNode(int node, const std::vector<int>& items);
+  void Reorder();
+
+  template <bool training, typename F>
+  bool EvaluateNode(int node, F const& value);
+  template <typename F>
+  static bool EvaluateCondition(const AnalysisCut::CutContainer& cut, F const& value);
+  template <typename F>
+  uint64_t EvaluateAll(F const& value);
+};
+
+//____________________________________________________________________________
+template <typename F>
+inline bool AnalysisCutEvaluator::EvaluateCondition(const AnalysisCut::CutContainer& cut, F const& value)
+{
+  //
+  // same logic as in AnalysisCut::IsSelected(), for a single cut container
+  //
+  if (cut.fDepVar != -1) {
+    float dep = value(cut.fDepVar);
+    bool inRange = (dep > cut.fDepLow && dep <= cut.fDepHigh);
+    if (inRange == cut.fDepExclude) {
+      return true; // the cut does not apply
+    }
+  }
+  if (cut.fDepVar2 != -1) {
+    float dep2 = value(cut.fDepVar2);
+    bool inRange = (dep2 > cut.fDep2Low && dep2 <= cut.fDep2High);
+    if (inRange == cut.fDep2Exclude) {
+      return true; // the cut does not apply
+    }
+  }
+  float cutLow = (cut.fFuncLow ? cut.fFuncLow->Eval(value(cut.fDepVar)) : cut.fLow);
+  float cutHigh = (cut.fFuncHigh ? cut.fFuncHigh->Eval(value(cut.fDepVar)) : cut.fHigh);
+  float x = value(cut.fVar);
+  bool inRange = (x >= cutLow && x <= cutHigh);
+  return inRange != cut.fExclude;
+}
+
+//____________________________________________________________________________
+template <bool training, typename F>
+inline bool AnalysisCutEvaluator::EvaluateNode(int node, F const& value)
+{
+  //
+  // evaluate a node, stopping at the first decisive item
+  //
+  const Node& n = fNodes[node];
+  for (int k = n.fBegin; k < n.fEnd; ++k) {
+    int item = fItems[k];
+    bool pass = (item >= 0 ? EvaluateCondition(fConditions[item], value) : EvaluateNode<training>(-item - 1, value));
+    if constexpr (training) {
+      fItemNEval[k]++;
+    }
+    if (pass != n.fUseAND) { // false for AND, true for OR
+      if constexpr (training) {
+        fItemNDecisive[k]++;
+      }
+      return pass;
+    }
+  }
+  return n.fUseAND;
+}
+
+//____________________________________________________________________________
+template <typename F>
+inline uint64_t AnalysisCutEvaluator::EvaluateAll(F const& value)
+{
+  uint64_t filterMap = 0;
+  if (fNEvaluatedObjects < fNTrainingObjects) {
+    for (std::size_t i = 0; i < fRoots.size(); ++i) {
+      if (EvaluateNode<true>(fRoots[i], value)) {
+        filterMap |= (uint64_t(1) << i);
+      }
+    }
+    if (++fNEvaluatedObjects == fNTrainingObjects) {
+      Reorder();
+    }
+    return filterMap;
+  }
+  for (std::size_t i = 0; i < fRoots.size(); ++i) {
+    if (EvaluateNode<false>(fRoots[i], value)) {
+      filterMap |= (uint64_t(1) << i);
+    }
+  }
+  return filterMap;
+}
+
+//____________________________________________________________________________
+inline uint64_t AnalysisCutEvaluator::Evaluate(const float* values)
+{
+  return EvaluateAll([values](int var) { return values[var]; });
+}
+
+//____________________________________________________________________________
+inline void AnalysisCutEvaluator::Evaluate(const float* columns, int nObjects, uint64_t* filterMaps)
+{
+  for (int i = 0; i < nObjects; ++i) {
+    filterMaps[i] = EvaluateAll([columns, nObjects, i](int var) { return columns[static_cast<std::size_t>(var) * nObjects + i]; });
+  }
+}
+
+#endif
@@ -13,7 +13,48 @@
 //
 #include "PWGDQ/Core/CutsLibrary.h"
 
+#include <memory>
+#include <unordered_map>
+
+// The cuts are defined in BuildCompositeCut and BuildAnalysisCut by a chain of name comparisons.
+// Each cut is built once per process: GetCompositeCut and GetAnalysisCut keep the built cuts by name
+// and return copies of them, so that the same names requested by several cuts or tasks do not go
+// through the chain again.
+namespace o2::aod::dqcuts
+{
+AnalysisCompositeCut* BuildCompositeCut(const char* cutName);
+AnalysisCut* BuildAnalysisCut(const char* cutName);
+} // namespace o2::aod::dqcuts
+
 AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
+{
+  static std::unordered_map<std::string, std::unique_ptr<AnalysisCompositeCut>> builtCuts;
+  auto found = builtCuts.find(cutName);
+  if (found == builtCuts.end()) {
+    AnalysisCompositeCut* cut = BuildCompositeCut(cutName);
+    if (cut == nullptr) {
+      return nullptr;
+    }
+    found = builtCuts.emplace(cutName, cut).first;
+  }
+  return new AnalysisCompositeCut(*found->second);
+}
+
+AnalysisCut* o2::aod::dqcuts::GetAnalysisCut(const char* cutName)
+{
+  static std::unordered_map<std::string, std::unique_ptr<AnalysisCut>> builtCuts;
+  auto found = builtCuts.find(cutName);
+  if (found == builtCuts.end()) {
+    AnalysisCut* cut = BuildAnalysisCut(cutName);
+    if (cut == nullptr) {
+      return nullptr;
+    }
+    found = builtCuts.emplace(cutName, cut).first;
+  }
+  return new AnalysisCut(*found->second);
+}
+
+AnalysisCompositeCut* o2::aod::dqcuts::BuildCompositeCut(const char* cutName)
 {
   //
   // define composie cuts, typically combinations of all the ingredients needed for a full cut
@@ -2376,7 +2417,7 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
   return nullptr;
 }
 
-AnalysisCut* o2::aod::dqcuts::GetAnalysisCut(const char* cutName)
+AnalysisCut* o2::aod::dqcuts::BuildAnalysisCut(const char* cutName)
 {
   //
   // define here cuts which are likely to be used often
@@ -39,6 +39,7 @@ HistogramManager::HistogramManager() : TNamed("", ""),
                                        fNVars(0),
                                        fUsedVars(nullptr),
                                        fVariablesMap(),
+                                       fPlansCompiled(false),
                                        fUseDefaultVariableNames(false),
                                        fBinsAllocated(0),
                                        fVariableNames(nullptr),
@@ -55,6 +56,7 @@ HistogramManager::HistogramManager(const char* name, const char* title, const in
                                                                                               fNVars(maxNVars),
                                                                                               fUsedVars(),
                                                                                               fVariablesMap(),
+                                                                                              fPlansCompiled(false),
                                                                                               fUseDefaultVariableNames(kFALSE),
                                                                                               fBinsAllocated(0),
                                                                                               fVariableNames(),
@@ -110,6 +112,9 @@ void HistogramManager::AddHistClass(const char* histClass)
   fMainList->Add(hList);
   std::list<std::vector<int>> varList;
   fVariablesMap[histClass] = varList;
+  fHistClassHandles[histClass] = fHistClassNames.size();
+  fHistClassNames.push_back(histClass);
+  fPlansCompiled = false;
   cout << "Adding histogram class " << histClass << endl;
   cout << "Variable map size :: " << fVariablesMap.size() << endl;
 }
@@ -181,6 +186,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   varVector.push_back(varT); // variable used for profiling in case of TProfile3D
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
+  fPlansCompiled = false;
   cout << "Adding histogram " << hname << endl;
   cout << "size of array :: " << varList.size() << endl;
   fVariablesMap[histClass] = varList;
@@ -380,6 +386,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   varVector.push_back(varT); // variable used for profiling in case of TProfile3D
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
+  fPlansCompiled = false;
   cout << "Adding histogram " << hname << endl;
   cout << "size of array :: " << varList.size() << endl;
   fVariablesMap[histClass] = varList;
@@ -548,6 +555,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   }
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
+  fPlansCompiled = false;
   cout << "Adding histogram " << hname << endl;
   cout << "size of array :: " << varList.size() << endl;
   fVariablesMap[histClass] = varList;
@@ -627,6 +635,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   }
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
+  fPlansCompiled = false;
   cout << "Adding histogram " << hname << endl;
   cout << "size of array :: " << varList.size() << endl;
   fVariablesMap[histClass] = varList;
@@ -679,131 +688,255 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   fBinsAllocated += bins;
 }
 
+//__________________________________________________________________
+int HistogramManager::GetHistClassHandle(const char* className) const
+{
+  //
+  // get the handle of a histogram class, to be used with FillHistClass(int, float*)
+  //
+  auto it = fHistClassHandles.find(className);
+  if (it == fHistClassHandles.end()) {
+    return kNothing;
+  }
+  return it->second;
+}
+
+//__________________________________________________________________
+void HistogramManager::CompileFillPlans()
+{
+  //
+  // flatten the histogram lists and the variable maps into the fill plans
+  // NOTE: this decodes once the information which would otherwise be decoded in every FillHistClass() call
+  //
+  fPlanRanges.assign(fHistClassNames.size(), {0, 0});
+  fPlanHists.clear();
+  fPlanKinds.clear();
+  fPlanVarW.clear();
+  fPlanVarsBegin.clear();
+  fPlanNVars.clear();
+  fPlanVars.clear();
+
+  for (std::size_t handle = 0; handle < fHistClassNames.size(); ++handle) {
+    const std::string& className = fHistClassNames[handle];
+    fPlanRanges[handle].first = fPlanHists.size();
+    fPlanRanges[handle].second = fPlanHists.size();
+    auto* hList = reinterpret_cast<TList*>(fMainList->FindObject(className.c_str()));
+    if (!hList) {
+      continue;
+    }
+    auto& varList = fVariablesMap[className];
+    // NOTE: the histogram list and the variable list contain the same number of elements and are synchronized
+    TIter next(hList);
+    for (auto varIter = varList.begin(); varIter != varList.end(); varIter++) {
+      TObject* h = next();
+      if (!h) {
+        break;
+      }
+      bool isProfile = (varIter->at(0) == 1);
+      int nTHnDimensions = varIter->at(1);
+      fPlanHists.push_back(h);
+      fPlanVarW.push_back(varIter->at(2));
+      fPlanVarsBegin.push_back(fPlanVars.size());
+      if (nTHnDimensions > 0) {
+        fPlanKinds.push_back(kFillTHn);
+        fPlanNVars.push_back(nTHnDimensions);
+        for (int i = 0; i < nTHnDimensions; i++) {
+          fPlanVars.push_back(varIter->at(3 + i));
+        }
+        continue;
+      }
+      switch ((reinterpret_cast<TH1*>(h))->GetDimension()) {
+        case 1:
+          fPlanKinds.push_back(isProfile ? kFillProfile : kFillTH1);
+          break;
+        case 2:
+          fPlanKinds.push_back(isProfile ? kFillProfile2D : kFillTH2);
+          break;
+        case 3:
+          fPlanKinds.push_back(isProfile ? kFillProfile3D : kFillTH3);
+          break;
+        default:
+          LOG(fatal) << "HistogramManager::CompileFillPlans(): Unsupported dimension for histogram " << h->GetName();
+          break;
+      }
+      // for the TH1 based histograms, the X, Y, Z and T variables are always stored
+      fPlanNVars.push_back(4);
+      for (int i = 0; i < 4; i++) {
+        fPlanVars.push_back(varIter->at(3 + i));
+      }
+    }
+    fPlanRanges[handle].second = fPlanHists.size();
+  }
+  fPlansCompiled = true;
+}
+
 //__________________________________________________________________
 void HistogramManager::FillHistClass(const char* className, Float_t* values)
 {
   //
   //  fill a class of histograms
   //
-
-  // get the needed histogram list
-  auto* hList = reinterpret_cast<TList*>(fMainList->FindObject(className));
-  if (!hList) {
+  int handle = GetHistClassHandle(className);
+  if (handle == kNothing) {
     // TODO: add some meaningfull error message
     /*LOG(warn) << "HistogramManager::FillHistClass(): Histogram list " << className << " not found!";
     LOG(warn) << "         Histogram list not filled" << endl; */
     return;
   }
+  FillHistClass(handle, values);
+}
 
-  // get the corresponding std::list containng identifiers to the needed variables to be filled
-  list varList = fVariablesMap[className];
-
-  TIter next(hList);
+//__________________________________________________________________
+void HistogramManager::FillHistClass(int handle, Float_t* values)
+{
+  //
+  //  fill a class of histograms using the precompiled fill plan
+  //
+  if (handle < 0 || handle >= static_cast<int>(fHistClassNames.size())) {
+    return;
+  }
+  if (!fPlansCompiled) {
+    CompileFillPlans();
+  }
 
-  TObject* h = nullptr;
-  bool isProfile;
-  bool isTHn;
-  int dimension = 0;
-  bool isSparse = kFALSE;
   // TODO: At the moment, maximum 20 dimensions are foreseen for the THn histograms. We should make this more dynamic
   //       But maybe its better to have it like to avoid dynamically allocating this array in the histogram loop
   double fillValues[20] = {0.0};
-  int varX = -1, varY = -1, varZ = -1, varT = -1, varW = -1;
-
-  // loop over the histogram and std::list
-  // NOTE: these two should contain the same number of elements and be synchronized, otherwise its a mess
-  for (auto varIter = varList.begin(); varIter != varList.end(); varIter++) {
-    h = next(); // get the histogram
-    // decode information from the vector of indices
-    isProfile = (varIter->at(0) == 1 ? true : false);
-    isTHn = (varIter->at(1) > 0 ? true : false);
-    if (isTHn) {
-      dimension = varIter->at(1);
-    } else {
-      dimension = (reinterpret_cast<TH1*>(h))->GetDimension();
-    }
 
-    // get the various variable indices
-    varW = varIter->at(2);
-    if (isTHn) {
-      for (int i = 0; i < dimension; i++) {
-        fillValues[i] = values[varIter->at(3 + i)];
-      }
-    } else {
-      varX = varIter->at(3);
-      varY = varIter->at(4);
-      varZ = varIter->at(5);
-      varT = varIter->at(6);
-    }
+  const auto [begin, end] = fPlanRanges[handle];
+  for (int ih = begin; ih < end; ++ih) {
+    TObject* h = fPlanHists[ih];
+    const int varW = fPlanVarW[ih];
+    const int* vars = fPlanVars.data() + fPlanVarsBegin[ih];
 
-    if (!isTHn) {
-      switch (dimension) {
-        case 1:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY]);
-            }
-          } else {
-            if (varW > kNothing) {
-              (reinterpret_cast<TH1F*>(h))->Fill(values[varX], values[varW]);
-            } else {
-              (reinterpret_cast<TH1F*>(h))->Fill(values[varX]);
-            }
-          }
+    switch (fPlanKinds[ih]) {
+      case kFillTH1:
+        if (varW > kNothing) {
+          (reinterpret_cast<TH1F*>(h))->Fill(values[vars[0]], values[varW]);
+        } else {
+          (reinterpret_cast<TH1F*>(h))->Fill(values[vars[0]]);
+        }
+        break;
+      case kFillTH2:
+        if (varW > kNothing) {
+          (reinterpret_cast<TH2F*>(h))->Fill(values[vars[0]], values[vars[1]], values[varW]);
+        } else {
+          (reinterpret_cast<TH2F*>(h))->Fill(values[vars[0]], values[vars[1]]);
+        }
+        break;
+      case kFillTH3:
+        if (varW > kNothing) {
+          (reinterpret_cast<TH3F*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[varW]);
+        } else {
+          (reinterpret_cast<TH3F*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]]);
+        }
+        break;
+      case kFillProfile:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile*>(h))->Fill(values[vars[0]], values[vars[1]], values[varW]);
+        } else {
+          (reinterpret_cast<TProfile*>(h))->Fill(values[vars[0]], values[vars[1]]);
+        }
+        break;
+      case kFillProfile2D:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile2D*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[varW]);
+        } else {
+          (reinterpret_cast<TProfile2D*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]]);
+        }
+        break;
+      case kFillProfile3D:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile3D*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[vars[3]], values[varW]);
+        } else {
+          (reinterpret_cast<TProfile3D*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[vars[3]]);
+        }
+        break;
+      case kFillTHn: {
+        const int nDimensions = fPlanNVars[ih];
+        for (int i = 0; i < nDimensions; i++) {
+          fillValues[i] = values[vars[i]];
+        }
+        // THnF and THnSparseF are both filled through the THnBase interface
+        if (varW > kNothing) {
+          (reinterpret_cast<THnBase*>(h))->Fill(fillValues, values[varW]);
+        } else {
+          (reinterpret_cast<THnBase*>(h))->Fill(fillValues);
+        }
+        break;
+      }
+      default:
+        break;
+    } // end switch
+  }   // end loop over histograms
+}
+
+//__________________________________________________________________
+void HistogramManager::FillHistClass(int handle, const float* columns, int nObjects, const uint8_t* selected)
+{
+  //
+  //  fill a class of histograms for a batch of objects
+  //  NOTE: the loop over objects is the inner one, such that each histogram reads its variable columns contiguously
+  //
+  if (handle < 0 || handle >= static_cast<int>(fHistClassNames.size())) {
+    return;
+  }
+  if (!fPlansCompiled) {
+    CompileFillPlans();
+  }
+
+  double fillValues[20] = {0.0};
+  auto column = [&](int var) { return columns + static_cast<std::size_t>(var) * nObjects; };
+
+  const auto [begin, end] = fPlanRanges[handle];
+  for (int ih = begin; ih < end; ++ih) {
+    TObject* h = fPlanHists[ih];
+    const int kind = fPlanKinds[ih];
+    const int varW = fPlanVarW[ih];
+    const int* vars = fPlanVars.data() + fPlanVarsBegin[ih];
+    const int nVars = (kind == kFillTHn ? fPlanNVars[ih] : 0);
+    // for the TH1 based histograms, the number of used columns depends on the fill kind
+    const float* x = (kind != kFillTHn ? column(vars[0]) : nullptr);
+    const float* y = (kind == kFillTH2 || kind == kFillTH3 || kind == kFillProfile || kind == kFillProfile2D || kind == kFillProfile3D ? column(vars[1]) : nullptr);
+    const float* z = (kind == kFillTH3 || kind == kFillProfile2D || kind == kFillProfile3D ? column(vars[2]) : nullptr);
+    const float* t = (kind == kFillProfile3D ? column(vars[3]) : nullptr);
+    const float* w = (varW > kNothing ? column(varW) : nullptr);
+
+    for (int i = 0; i < nObjects; ++i) {
+      if (selected && !selected[i]) {
+        continue;
+      }
+      const double weight = (w ? w[i] : 1.0);
+      switch (kind) {
+        case kFillTH1:
+          (reinterpret_cast<TH1F*>(h))->Fill(x[i], weight);
           break;
-        case 2:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
-          } else {
-            if (varW > kNothing) {
-              (reinterpret_cast<TH2F*>(h))->Fill(values[varX], values[varY], values[varW]);
-            } else {
-              (reinterpret_cast<TH2F*>(h))->Fill(values[varX], values[varY]);
-            }
-          }
+        case kFillTH2:
+          (reinterpret_cast<TH2F*>(h))->Fill(x[i], y[i], weight);
           break;
-        case 3:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT]);
-            }
-          } else {
-            if (varW > kNothing) {
-              (reinterpret_cast<TH3F*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TH3F*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
+        case kFillTH3:
+          (reinterpret_cast<TH3F*>(h))->Fill(x[i], y[i], z[i], weight);
+          break;
+        case kFillProfile:
+          (reinterpret_cast<TProfile*>(h))->Fill(x[i], y[i], weight);
+          break;
+        case kFillProfile2D:
+          (reinterpret_cast<TProfile2D*>(h))->Fill(x[i], y[i], z[i], weight);
+          break;
+        case kFillProfile3D:
+          (reinterpret_cast<TProfile3D*>(h))->Fill(x[i], y[i], z[i], t[i], weight);
+          break;
+        case kFillTHn:
+          for (int iv = 0; iv < nVars; iv++) {
+            fillValues[iv] = column(vars[iv])[i];
           }
+          (reinterpret_cast<THnBase*>(h))->Fill(fillValues, weight);
           break;
-
         default:
           break;
       } // end switch
-      // end if(!isTHn)
-    } else {
-      if (varW > kNothing) {
-        if (isSparse) {
-          (reinterpret_cast<THnSparseF*>(h))->Fill(fillValues, values[varW]);
-        } else {
-          (reinterpret_cast<THnF*>(h))->Fill(fillValues, values[varW]);
-        }
-      } else {
-        if (isSparse) {
-          (reinterpret_cast<THnSparseF*>(h))->Fill(fillValues);
-        } else {
-          (reinterpret_cast<THnF*>(h))->Fill(fillValues);
-        }
-      }
-    } // end else
-  }   // end loop over histograms
+    }   // end loop over objects
+  }     // end loop over histograms
 }
 
 //____________________________________________________________________________________
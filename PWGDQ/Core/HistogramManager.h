@@ -28,6 +28,8 @@
 #include <map>
 #include <vector>
 #include <list>
+#include <unordered_map>
+#include <cstdint>
 
 class HistogramManager : public TNamed
 {
@@ -41,6 +43,17 @@ class HistogramManager : public TNamed
     kNothing = -1
   };
 
+  // Fill kinds used in the precompiled fill plans
+  enum FillKind {
+    kFillTH1 = 0,
+    kFillTH2,
+    kFillTH3,
+    kFillProfile,
+    kFillProfile2D,
+    kFillProfile3D,
+    kFillTHn
+  };
+
   void SetMainHistogramList(THashList* list)
   {
     if (fMainList) {
@@ -85,6 +98,15 @@ class HistogramManager : public TNamed
                     TString* axLabels = nullptr, int varW = -1, bool useSparse = kFALSE);
 
   void FillHistClass(const char* className, float* values);
+  // Fill a class of histograms using a handle obtained via GetHistClassHandle()
+  // This avoids any string lookup and is meant for the per-track / per-pair fills
+  void FillHistClass(int handle, float* values);
+  // Return the handle of a histogram class, or kNothing if the class does not exist
+  // Handles are stable for the lifetime of the manager, also if histograms are added afterwards
+  int GetHistClassHandle(const char* className) const;
+  // Fill a class of histograms for a batch of objects stored column-major, columns[var * nObjects + iObject]
+  //   (see VarManager::FillTrackBatch()). If specified, only the objects with selected[iObject] != 0 are filled
+  void FillHistClass(int handle, const float* columns, int nObjects, const uint8_t* selected = nullptr);
 
   void SetUseDefaultVariableNames(bool flag) { fUseDefaultVariableNames = flag; };
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -102,6 +124,19 @@ class HistogramManager : public TNamed
   bool* fUsedVars;                                                  //! flags of used variables
   std::map<std::string, std::list<std::vector<int>>> fVariablesMap; //!  map holding identifiers for all variables needed by histograms
 
+  // precompiled fill plans, one entry for each histogram class (indexed by the class handle)
+  // fPlanRanges[handle] gives the [begin, end) range in the per-histogram arrays
+  std::unordered_map<std::string, int> fHistClassHandles; //! map from histogram class name to handle
+  std::vector<std::string> fHistClassNames;                //! histogram class names, indexed by handle
+  std::vector<std::pair<int, int>> fPlanRanges;            //! range of histograms for each class
+  std::vector<TObject*> fPlanHists;                        //! histogram pointers
+  std::vector<int> fPlanKinds;                             //! fill kind (see FillKind)
+  std::vector<int> fPlanVarW;                              //! weight variable
+  std::vector<int> fPlanVarsBegin;                         //! start index of the axis variables in fPlanVars
+  std::vector<int> fPlanNVars;                             //! number of axis variables
+  std::vector<int> fPlanVars;                              //! axis variables, flattened
+  bool fPlansCompiled;                                     //! plans are up to date with the defined histograms
+
   // various
   bool fUseDefaultVariableNames;    //! toggle the usage of default variable names and units
   unsigned long int fBinsAllocated; //! number of allocated bins
@@ -109,6 +144,7 @@ class HistogramManager : public TNamed
   TString* fVariableUnits;          //! variable units
 
   void MakeAxisLabels(TAxis* ax, const char* labels);
+  void CompileFillPlans();
 
   HistogramManager& operator=(const HistogramManager& c);
   HistogramManager(const HistogramManager& c);
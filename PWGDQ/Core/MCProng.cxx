@@ -162,6 +162,86 @@ bool MCProng::TestPDG(int i, int pdgCode) const
   return true;
 }
 
+//________________________________________________________________________________________________________________
+bool MCProng::TestSources(int generation, uint64_t particleSources) const
+{
+  //
+  // check the sources required for a generation
+  //
+  if (!fSourceBits[generation]) {
+    return true;
+  }
+  bool isPhysicalPrimary = particleSources & (uint64_t(1) << kPhysicalPrimary);
+  bool producedByGenerator = particleSources & (uint64_t(1) << kProducedByGenerator);
+  bool fromBackgroundEvent = particleSources & (uint64_t(1) << kFromBackgroundEvent);
+
+  // check each source
+  uint64_t sourcesDecision = 0;
+  // Check kPhysicalPrimary
+  if (fSourceBits[generation] & (uint64_t(1) << kPhysicalPrimary)) {
+    if ((fExcludeSource[generation] & (uint64_t(1) << kPhysicalPrimary)) != isPhysicalPrimary) {
+      sourcesDecision |= (uint64_t(1) << kPhysicalPrimary);
+    }
+  }
+  // Check kProducedInTransport
+  if (fSourceBits[generation] & (uint64_t(1) << kProducedInTransport)) {
+    if ((fExcludeSource[generation] & (uint64_t(1) << kProducedInTransport)) != (!producedByGenerator)) {
+      sourcesDecision |= (uint64_t(1) << kProducedInTransport);
+    }
+  }
+  // Check kProducedByGenerator
+  if (fSourceBits[generation] & (uint64_t(1) << kProducedByGenerator)) {
+    if ((fExcludeSource[generation] & (uint64_t(1) << kProducedByGenerator)) != producedByGenerator) {
+      sourcesDecision |= (uint64_t(1) << kProducedByGenerator);
+    }
+  }
+  // Check kFromBackgroundEvent
+  if (fSourceBits[generation] & (uint64_t(1) << kFromBackgroundEvent)) {
+    if ((fExcludeSource[generation] & (uint64_t(1) << kFromBackgroundEvent)) != fromBackgroundEvent) {
+      sourcesDecision |= (uint64_t(1) << kFromBackgroundEvent);
+    }
+  }
+  // no source bit is fulfilled
+  if (!sourcesDecision) {
+    return false;
+  }
+  // if fUseANDonSourceBitMap is on, request all bits
+  if (fUseANDonSourceBitMap[generation] && (sourcesDecision != fSourceBits[generation])) {
+    return false;
+  }
+  return true;
+}
+
+//________________________________________________________________________________________________________________
+bool MCProng::TestPDGInHistory(const int* motherPDGs, int nMothers) const
+{
+  //
+  // check whether the required PDG codes are included (or excluded) in the decay history of the particle
+  // NOTE: at most kNMaxGenerationsInHistory mothers are inspected
+  //
+  if (nMothers > kNMaxGenerationsInHistory) {
+    nMothers = kNMaxGenerationsInHistory;
+  }
+  unsigned int nIncludedPDG = 0;
+  unsigned int nFoundPDG = 0;
+  for (unsigned int k = 0; k < fPDGInHistory.size(); k++) {
+    if (!fExcludePDGInHistory[k]) {
+      nIncludedPDG++;
+    }
+    for (int ith = 0; ith < nMothers; ith++) {
+      bool compare = ComparePDG(motherPDGs[ith], fPDGInHistory[k], true, fExcludePDGInHistory[k]);
+      if (!fExcludePDGInHistory[k] && compare) {
+        nFoundPDG++;
+        break;
+      }
+      if (fExcludePDGInHistory[k] && !compare) {
+        return false;
+      }
+    }
+  }
+  return (nFoundPDG == nIncludedPDG); // as many found PDG codes as included ones defined for the prong
+}
+
 //________________________________________________________________________________________________________________
 bool MCProng::ComparePDG(int pdg, int prongPDG, bool checkBothCharges, bool exclude) const
 {
@@ -73,7 +73,8 @@ class MCProng
   };
 
   enum Constants {
-    kPDGCodeNotAssigned = 0
+    kPDGCodeNotAssigned = 0,
+    kNMaxGenerationsInHistory = 11 // maximum number of mothers inspected when checking the PDG codes in history
   };
 
   MCProng();
@@ -93,6 +94,10 @@ class MCProng
   void Print() const;
   bool TestPDG(int i, int pdgCode) const;
   bool ComparePDG(int pdg, int prongPDG, bool checkBothCharges = false, bool exclude = false) const;
+  // check the source requirements of a generation, for a particle with the given source bit map (bits as in MCProng::Source)
+  bool TestSources(int generation, uint64_t particleSources) const;
+  // check the PDG codes in history, given the PDG codes of the mother, grand-mother, ... of the particle
+  bool TestPDGInHistory(const int* motherPDGs, int nMothers) const;
 
   int fNGenerations;
   std::vector<int> fPDGcodes;
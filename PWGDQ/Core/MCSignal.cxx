@@ -75,3 +75,82 @@ void MCSignal::PrintConfig()
     pr.Print();
   }
 }
+
+//________________________________________________________________________________________________
+int MCSignal::GetNAncestryGenerations() const
+{
+  int nGenerations = 0;
+  for (auto& pr : fProngs) {
+    int n = (pr.fPDGInHistory.size() > 0 ? MCAncestry::kMaxGenerations : pr.fNGenerations);
+    if (n > nGenerations) {
+      nGenerations = n;
+    }
+  }
+  return nGenerations;
+}
+
+//________________________________________________________________________________________________
+bool MCSignal::IsAncestryCompatible(int nGenerations) const
+{
+  //
+  // the MCAncestry objects store only the history back in time
+  //
+  for (auto& pr : fProngs) {
+    if (pr.fCheckGenerationsInTime) {
+      return false;
+    }
+  }
+  return (GetNAncestryGenerations() <= nGenerations);
+}
+
+//________________________________________________________________________________________________
+bool MCSignal::CheckProng(int i, bool checkSources, const MCAncestry& ancestry)
+{
+  //
+  // same logic as the templated CheckProng() for prongs checked back in time, using the precomputed ancestry
+  //
+  const MCProng& prong = fProngs[i];
+  // all the generations specified for this prong must exist in the stack
+  if (prong.fNGenerations > ancestry.fNGenerations) {
+    return false;
+  }
+
+  for (int j = 0; j < prong.fNGenerations; j++) {
+    // check the PDG code
+    if (!prong.TestPDG(j, ancestry.fPdgCode[j])) {
+      return false;
+    }
+    // check the common ancestor (if specified)
+    if (fNProngs > 1 && fCommonAncestorIdxs[i] == j) {
+      if (i == 0) {
+        fTempAncestorLabel = ancestry.fGlobalIndex[j];
+      } else {
+        if (ancestry.fGlobalIndex[j] != fTempAncestorLabel) {
+          return false;
+        }
+      }
+    }
+  }
+
+  // check the various specified sources
+  // NOTE: the history is moved one generation further only for the generations which require sources, as in the templated CheckProng()
+  if (checkSources) {
+    int generation = 0;
+    for (int j = 0; j < prong.fNGenerations; j++) {
+      if (!prong.fSourceBits[j]) {
+        continue;
+      }
+      if (!prong.TestSources(j, ancestry.fSources[generation])) {
+        return false;
+      }
+      if (j < prong.fNGenerations - 1) {
+        generation++;
+      }
+    }
+  }
+
+  if (prong.fPDGInHistory.size() == 0) {
+    return true;
+  }
+  return prong.TestPDGInHistory(ancestry.fPdgCode + 1, ancestry.fNGenerations - 1);
+}
@@ -59,9 +59,26 @@ process(aod::McParticles const& mcTracks) {
 #include "MCProng.h"
 #include "TNamed.h"
 
+#include <cstdint>
 #include <vector>
 #include <iostream>
 
+// Ancestry of a MC particle, back in time: the particle itself (generation 0), its mother, grand-mother, ...
+// It stores per generation the information needed by MCSignal, such that the mother chain is walked only once
+//   and then shared by all the signals checked for the particle (see MCSignalMatcher)
+struct MCAncestry {
+  static constexpr int kMaxGenerations = MCProng::kNMaxGenerationsInHistory + 1;
+
+  int fNGenerations = 0;                       // number of stored generations
+  bool fTruncated = false;                     // true if the history continues beyond the stored generations
+  int fPdgCode[kMaxGenerations] = {0};         // PDG codes
+  int64_t fGlobalIndex[kMaxGenerations] = {0}; // global indices of the particles
+  uint64_t fSources[kMaxGenerations] = {0};    // source bit maps, with bits as in MCProng::Source
+
+  template <typename T>
+  void Fill(const T& particle, int nGenerations = kMaxGenerations);
+};
+
 class MCSignal : public TNamed
 {
  public:
@@ -82,6 +99,17 @@ class MCSignal : public TNamed
   {
     return fProngs[0].fNGenerations;
   }
+  const std::vector<MCProng>& GetProngs() const
+  {
+    return fProngs;
+  }
+  // true if the signal can be checked on MCAncestry objects storing nGenerations generations
+  bool IsAncestryCompatible(int nGenerations) const;
+  // number of generations to be stored in MCAncestry objects to check this signal
+  int GetNAncestryGenerations() const;
+  // source bit map of a MC particle, with bits as in MCProng::Source
+  template <typename T>
+  static uint64_t SourceBits(const T& particle);
 
   template <typename... T>
   bool CheckSignal(bool checkSources, const T&... args)
@@ -104,6 +132,7 @@ class MCSignal : public TNamed
 
   template <typename T>
   bool CheckProng(int i, bool checkSources, const T& track);
+  bool CheckProng(int i, bool checkSources, const MCAncestry& ancestry);
 
   bool CheckMC(int, bool)
   {
@@ -180,38 +209,7 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
       if (!fProngs[i].fSourceBits[j]) {
         continue;
       }
-      // check each source
-      uint64_t sourcesDecision = 0;
-      // Check kPhysicalPrimary
-      if (fProngs[i].fSourceBits[j] & (uint64_t(1) << MCProng::kPhysicalPrimary)) {
-        if ((fProngs[i].fExcludeSource[j] & (uint64_t(1) << MCProng::kPhysicalPrimary)) != currentMCParticle.isPhysicalPrimary()) {
-          sourcesDecision |= (uint64_t(1) << MCProng::kPhysicalPrimary);
-        }
-      }
-      // Check kProducedInTransport
-      if (fProngs[i].fSourceBits[j] & (uint64_t(1) << MCProng::kProducedInTransport)) {
-        if ((fProngs[i].fExcludeSource[j] & (uint64_t(1) << MCProng::kProducedInTransport)) != (!currentMCParticle.producedByGenerator())) {
-          sourcesDecision |= (uint64_t(1) << MCProng::kProducedInTransport);
-        }
-      }
-      // Check kProducedByGenerator
-      if (fProngs[i].fSourceBits[j] & (uint64_t(1) << MCProng::kProducedByGenerator)) {
-        if ((fProngs[i].fExcludeSource[j] & (uint64_t(1) << MCProng::kProducedByGenerator)) != currentMCParticle.producedByGenerator()) {
-          sourcesDecision |= (uint64_t(1) << MCProng::kProducedByGenerator);
-        }
-      }
-      // Check kFromBackgroundEvent
-      if (fProngs[i].fSourceBits[j] & (uint64_t(1) << MCProng::kFromBackgroundEvent)) {
-        if ((fProngs[i].fExcludeSource[j] & (uint64_t(1) << MCProng::kFromBackgroundEvent)) != currentMCParticle.fromBackgroundEvent()) {
-          sourcesDecision |= (uint64_t(1) << MCProng::kFromBackgroundEvent);
-        }
-      }
-      // no source bit is fulfilled
-      if (!sourcesDecision) {
-        return false;
-      }
-      // if fUseANDonSourceBitMap is on, request all bits
-      if (fProngs[i].fUseANDonSourceBitMap[j] && (sourcesDecision != fProngs[i].fSourceBits[j])) {
+      if (!fProngs[i].TestSources(j, SourceBits(currentMCParticle))) {
         return false;
       }
 
@@ -244,61 +242,63 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
     }
   }
 
-  if (fProngs[i].fPDGInHistory.size() == 0)
+  if (fProngs[i].fPDGInHistory.size() == 0) {
     return true;
-  else { // check if mother pdg is in history
-    std::vector<int> pdgInHistory;
-
-    // while find mothers, check if the provided PDG codes are included or excluded in the particle decay history
-    unsigned int nIncludedPDG = 0;
-    for (unsigned int k = 0; k < fProngs[i].fPDGInHistory.size(); k++) {
-      currentMCParticle = track;
-      if (!fProngs[i].fExcludePDGInHistory[k])
-        nIncludedPDG++;
-      int ith = 0;
+  }
+  // check if mother pdg is in history
+  // Note: Currently no need to check generation InTime, so always check BackInTime (direction of mothers)
+  int motherPDGs[MCProng::kNMaxGenerationsInHistory];
+  int nMothers = 0;
+  currentMCParticle = track;
+  while (currentMCParticle.has_mothers() && nMothers < MCProng::kNMaxGenerationsInHistory) {
+    currentMCParticle = currentMCParticle.template mothers_first_as<P>();
+    motherPDGs[nMothers++] = currentMCParticle.pdgCode();
+  }
+  return fProngs[i].TestPDGInHistory(motherPDGs, nMothers);
+}
 
-      // Note: Currently no need to check generation InTime, so disable if case and always check BackInTime (direction of mothers)
-      //       The option to check for daughter in decay chain is still implemented but commented out.
+template <typename T>
+uint64_t MCSignal::SourceBits(const T& particle)
+{
+  uint64_t sources = 0;
+  if (particle.isPhysicalPrimary()) {
+    sources |= (uint64_t(1) << MCProng::kPhysicalPrimary);
+  }
+  if (particle.producedByGenerator()) {
+    sources |= (uint64_t(1) << MCProng::kProducedByGenerator);
+  } else {
+    sources |= (uint64_t(1) << MCProng::kProducedInTransport);
+  }
+  if (particle.fromBackgroundEvent()) {
+    sources |= (uint64_t(1) << MCProng::kFromBackgroundEvent);
+  }
+  return sources;
+}
 
-      // if (!fProngs[i].fCheckGenerationsInTime) { // check generation back in time
-      while (currentMCParticle.has_mothers()) {
-        auto mother = currentMCParticle.template mothers_first_as<P>();
-        if (!fProngs[i].fExcludePDGInHistory[k] && fProngs[i].ComparePDG(mother.pdgCode(), fProngs[i].fPDGInHistory[k], true, fProngs[i].fExcludePDGInHistory[k])) {
-          pdgInHistory.emplace_back(mother.pdgCode());
-          break;
-        }
-        if (fProngs[i].fExcludePDGInHistory[k] && !fProngs[i].ComparePDG(mother.pdgCode(), fProngs[i].fPDGInHistory[k], true, fProngs[i].fExcludePDGInHistory[k])) {
-          return false;
-        }
-        ith++;
-        currentMCParticle = mother;
-        if (ith > 10) { // need error message. Given pdg code was not found within 10 generations of the particles decay chain.
-          break;
-        }
-      }
-      // } else { // check generation in time
-      //   if (!currentMCParticle.has_daughters())
-      //     return false;
-      //   const auto& daughtersSlice = currentMCParticle.template daughters_as<P>();
-      //   for (auto& d : daughtersSlice) {
-      //     if (!fProngs[i].fExcludePDGInHistory[k] && fProngs[i].ComparePDG(d.pdgCode(), fProngs[i].fPDGInHistory[k], true, fProngs[i].fExcludePDGInHistory[k])) {
-      //       pdgInHistory.emplace_back(d.pdgCode());
-      //       break;
-      //     }
-      //     if (fProngs[i].fExcludePDGInHistory[k] && !fProngs[i].ComparePDG(d.pdgCode(), fProngs[i].fPDGInHistory[k], true, fProngs[i].fExcludePDGInHistory[k])) {
-      //       return false;
-      //     }
-      //     ith++;
-      //     if (ith > 10) { // need error message. Given pdg code was not found within 10 generations of the particles decay chain.
-      //       break;
-      //     }
-      //   }
-      // }
+template <typename T>
+void MCAncestry::Fill(const T& particle, int nGenerations)
+{
+  using P = typename T::parent_t;
+  if (nGenerations > kMaxGenerations) {
+    nGenerations = kMaxGenerations;
+  }
+  auto currentMCParticle = particle;
+  fNGenerations = 0;
+  fTruncated = false;
+  while (true) {
+    fPdgCode[fNGenerations] = currentMCParticle.pdgCode();
+    fGlobalIndex[fNGenerations] = currentMCParticle.globalIndex();
+    fSources[fNGenerations] = MCSignal::SourceBits(currentMCParticle);
+    fNGenerations++;
+    if (!currentMCParticle.has_mothers()) {
+      break;
     }
-    if (pdgInHistory.size() != nIncludedPDG) // vector has as many entries as mothers (daughters) defined for prong
-      return false;
+    if (fNGenerations == nGenerations) {
+      fTruncated = true;
+      break;
+    }
+    currentMCParticle = currentMCParticle.template mothers_first_as<P>();
   }
-  return true;
 }
 
 #endif // PWGDQ_CORE_MCSIGNAL_H_
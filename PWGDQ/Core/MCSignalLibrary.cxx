@@ -13,7 +13,31 @@
 //
 #include "PWGDQ/Core/MCSignalLibrary.h"
 
+#include <memory>
+#include <unordered_map>
+
+namespace o2::aod::dqmcsignals
+{
+MCSignal* BuildMCSignal(const char* name);
+} // namespace o2::aod::dqmcsignals
+
+// Each signal is built once per process and the next requests of the same name get copies of it,
+// without going through the chain of name comparisons of BuildMCSignal again
 MCSignal* o2::aod::dqmcsignals::GetMCSignal(const char* name)
+{
+  static std::unordered_map<std::string, std::unique_ptr<MCSignal>> builtSignals;
+  auto found = builtSignals.find(name);
+  if (found == builtSignals.end()) {
+    MCSignal* signal = BuildMCSignal(name);
+    if (signal == nullptr) {
+      return nullptr;
+    }
+    found = builtSignals.emplace(name, signal).first;
+  }
+  return new MCSignal(*found->second);
+}
+
+MCSignal* o2::aod::dqmcsignals::BuildMCSignal(const char* name)
 {
   std::string nameStr = name;
   MCSignal* signal;
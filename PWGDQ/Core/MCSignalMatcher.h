@@ -0,0 +1,94 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+// Class to check a list of MC signals in one pass over the history of the MC particles
+// The MCAncestry of each particle is built once (as deep as required by the signals) and all the signals
+//   are checked against it, producing a bit map with the i-th bit set if the i-th added signal is matched.
+// Signals which cannot be checked on the ancestry (e.g. prongs checked in time) are checked directly on the particles.
+//
+
+#ifndef PWGDQ_CORE_MCSIGNALMATCHER_H_
+#define PWGDQ_CORE_MCSIGNALMATCHER_H_
+
+#include "PWGDQ/Core/MCSignal.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class MCSignalMatcher
+{
+ public:
+  MCSignalMatcher() = default;
+  ~MCSignalMatcher() = default;
+
+  // add a signal; the decision is stored in the bit with the index of the AddSignal() call (maximum 64 signals)
+  // NOTE: the signal is not copied, so it must outlive the matcher
+  void AddSignal(MCSignal* signal)
+  {
+    fSignals.push_back(signal);
+    int nGenerations = signal->GetNAncestryGenerations();
+    bool useAncestry = signal->IsAncestryCompatible(MCAncestry::kMaxGenerations);
+    fUseAncestry.push_back(useAncestry);
+    if (useAncestry && nGenerations > fNGenerations) {
+      fNGenerations = nGenerations;
+    }
+  }
+  int GetNSignals() const { return fSignals.size(); }
+
+  // check all the signals with as many prongs as the particles provided (at most 64 signals are checked)
+  template <typename... T>
+  uint64_t Match(bool checkSources, const T&... particles);
+
+ private:
+  std::vector<MCSignal*> fSignals; // list of signals
+  std::vector<bool> fUseAncestry;  // whether each signal is checked on the ancestry of the particles
+  int fNGenerations = 0;           // number of generations stored in the ancestries
+
+  template <std::size_t... Is>
+  static bool CheckAncestries(MCSignal* signal, bool checkSources, const MCAncestry* ancestries, std::index_sequence<Is...>)
+  {
+    return signal->CheckSignal(checkSources, ancestries[Is]...);
+  }
+};
+
+//________________________________________________________________________________________________
+template <typename... T>
+inline uint64_t MCSignalMatcher::Match(bool checkSources, const T&... particles)
+{
+  constexpr unsigned int nProngs = sizeof...(particles);
+  MCAncestry ancestries[nProngs];
+  bool ancestriesFilled = false;
+
+  uint64_t decisions = 0;
+  for (std::size_t isig = 0; isig < fSignals.size() && isig < 64; isig++) {
+    if (static_cast<unsigned int>(fSignals[isig]->GetNProngs()) != nProngs) {
+      continue;
+    }
+    bool matched = false;
+    if (fUseAncestry[isig]) {
+      if (!ancestriesFilled) {
+        int ip = 0;
+        (ancestries[ip++].Fill(particles, fNGenerations), ...);
+        ancestriesFilled = true;
+      }
+      matched = CheckAncestries(fSignals[isig], checkSources, ancestries, std::make_index_sequence<nProngs>{});
+    } else {
+      matched = fSignals[isig]->CheckSignal(checkSources, particles...);
+    }
+    if (matched) {
+      decisions |= (uint64_t(1) << isig);
+    }
+  }
+  return decisions;
+}
+
+#endif // PWGDQ_CORE_MCSIGNALMATCHER_H_
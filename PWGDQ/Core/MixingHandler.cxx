@@ -63,6 +63,7 @@ void MixingHandler::AddMixingVariable(int var, int nBins, float* binLims)
   varBins.Set(nBins, binLims);
   fVariableLimits.push_back(varBins);
   VarManager::SetUseVariable(var);
+  fIsInitialized = kFALSE; // the bin lookup needs to be recomputed
 }
 
 //_________________________________________________________________________
@@ -111,11 +112,29 @@ void MixingHandler::Init()
   // Initialization of pools
   //       The correct event category will be retrieved using the function FindEventCategory()
   //
-  int size = 1;
-  for (auto v : fVariableLimits) {
-    size *= (v.GetSize() - 1);
+  int nVars = fVariables.size();
+  fStrides.assign(nVars, 1);
+  fIsUniform.assign(nVars, false);
+  fInvBinWidths.assign(nVars, 0.0);
+  for (int i = nVars - 2; i >= 0; --i) {
+    fStrides[i] = fStrides[i + 1] * (fVariableLimits[i + 1].GetSize() - 1);
+  }
+  // check which variables use equidistant bins, for which the bin can be computed directly
+  for (int i = 0; i < nVars; ++i) {
+    const TArrayF& lims = fVariableLimits[i];
+    int nBins = lims.GetSize() - 1;
+    if (nBins < 1) {
+      continue;
+    }
+    float width = (lims.At(nBins) - lims.At(0)) / nBins;
+    // NOTE: the edges are checked against the computed bin in FindEventCategory(), so a small tolerance is fine here
+    bool uniform = (width > 0);
+    for (int iBin = 0; iBin < nBins && uniform; ++iBin) {
+      uniform = (TMath::Abs((lims.At(iBin + 1) - lims.At(iBin)) - width) < 1.0e-3 * width);
+    }
+    fIsUniform[i] = uniform;
+    fInvBinWidths[i] = (uniform ? 1.0 / width : 0.0);
   }
-  (void)size;
   fIsInitialized = kTRUE;
 }
 
@@ -132,35 +151,50 @@ int MixingHandler::FindEventCategory(float* values)
     Init();
   }
 
-  std::vector<int> bin;
-  int iVar = 0;
-  for (auto v = fVariableLimits.begin(); v != fVariableLimits.end(); v++, iVar++) {
-    int binValue = TMath::BinarySearch((*v).GetSize(), (*v).GetArray(), values[fVariables[iVar]]);
-    bin.push_back(binValue);
-    if (bin[iVar] == -1 || bin[iVar] == (*v).GetSize() - 1) {
+  int category = 0;
+  int nVars = fVariables.size();
+  for (int iVar = 0; iVar < nVars; ++iVar) {
+    const TArrayF& lims = fVariableLimits[iVar];
+    const int nBins = lims.GetSize() - 1;
+    const float value = values[fVariables[iVar]];
+    if (!(value >= lims.At(0) && value < lims.At(nBins))) {
       return -1; // all variables must be inside limits
     }
-  }
-
-  int category = 0;
-  int tempCategory = 1;
-  int iv1 = 0;
-  int iv2 = 0;
-  for (auto v1 = fVariables.begin(); v1 != fVariables.end(); v1++, iv1++) {
-    tempCategory = 1;
-    iv2 = iv1;
-    for (auto v2 = v1; v2 != fVariables.end(); v2++, iv2++) {
-      if (iv2 == iv1) {
-        tempCategory *= bin[iv2];
-      } else {
-        tempCategory *= (fVariableLimits[iv2].GetSize() - 1);
+    int bin = 0;
+    if (fIsUniform[iVar]) {
+      // compute the bin directly, then correct for rounding at the bin edges
+      bin = static_cast<int>((value - lims.At(0)) * fInvBinWidths[iVar]);
+      bin = TMath::Min(TMath::Max(bin, 0), nBins - 1);
+      while (value < lims.At(bin)) {
+        bin--;
       }
+      while (value >= lims.At(bin + 1)) {
+        bin++;
+      }
+    } else {
+      bin = TMath::BinarySearch(lims.GetSize(), lims.GetArray(), value);
     }
-    category += tempCategory;
+    category += bin * fStrides[iVar];
   }
   return category;
 }
 
+//_________________________________________________________________________
+int MixingHandler::GetNCategories() const
+{
+  //
+  // total number of event categories
+  //
+  if (fVariables.size() == 0) {
+    return 0;
+  }
+  int size = 1;
+  for (auto const& v : fVariableLimits) {
+    size *= (v.GetSize() - 1);
+  }
+  return size;
+}
+
 //_________________________________________________________________________
 int MixingHandler::GetBinFromCategory(VarManager::Variables var, int category) const
 {
@@ -47,6 +47,7 @@ class MixingHandler : public TNamed
   void Init();
   int FindEventCategory(float* values);
   int GetBinFromCategory(VarManager::Variables var, int category) const;
+  int GetNCategories() const;
 
  private:
   MixingHandler(const MixingHandler& handler);
@@ -58,6 +59,11 @@ class MixingHandler : public TNamed
   std::vector<TArrayF> fVariableLimits;
   std::vector<int> fVariables;
 
+  // precomputed at Init(), used for the bin lookup in FindEventCategory()
+  std::vector<int> fStrides;        //! category stride for each variable
+  std::vector<bool> fIsUniform;     //! whether the binning of each variable is equidistant
+  std::vector<float> fInvBinWidths; //! inverse bin width, for the equidistant binnings
+
   ClassDef(MixingHandler, 1);
 };
 
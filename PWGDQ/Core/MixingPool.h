@@ -0,0 +1,129 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+// Ring-buffer event pools for event mixing, one pool per mixing category (see MixingHandler)
+// Each pool keeps the legs of the last N added events in a compact structure-of-arrays store
+//   (pt, eta, phi, sign and filter bits), which is enough for VarManager::FillPairME().
+// The memory is bounded by the number of categories times the pool depth and the slots are reused,
+//   so the mixing cost per event does not depend on the number of events in the category.
+//
+
+#ifndef MixingPool_H
+#define MixingPool_H
+
+#include <cstdint>
+#include <vector>
+
+class MixingPool
+{
+ public:
+  // Lightweight view of a stored leg, providing the accessors used by VarManager::FillPairME()
+  struct Leg {
+    float fPt;
+    float fEta;
+    float fPhi;
+    int fSign;
+    float pt() const { return fPt; }
+    float eta() const { return fEta; }
+    float phi() const { return fPhi; }
+    int sign() const { return fSign; }
+  };
+
+  // Legs of one stored event
+  struct Event {
+    std::vector<float> fPt;
+    std::vector<float> fEta;
+    std::vector<float> fPhi;
+    std::vector<int8_t> fSign;
+    std::vector<uint32_t> fFilter;
+
+    std::size_t size() const { return fPt.size(); }
+    Leg leg(std::size_t i) const { return {fPt[i], fEta[i], fPhi[i], fSign[i]}; }
+    uint32_t filter(std::size_t i) const { return fFilter[i]; }
+    void clear()
+    {
+      fPt.clear();
+      fEta.clear();
+      fPhi.clear();
+      fSign.clear();
+      fFilter.clear();
+    }
+  };
+
+  MixingPool() = default;
+  MixingPool(int depth, int nCategories = 0) { Init(depth, nCategories); }
+
+  // NOTE: the pools of categories beyond nCategories are allocated when the first event of that category is added
+  void Init(int depth, int nCategories = 0)
+  {
+    fDepth = (depth > 0 ? depth : 1);
+    fEvents.clear();
+    fNEvents.clear();
+    fNext.clear();
+    Resize(nCategories);
+  }
+  int GetNCategories() const { return fNEvents.size(); }
+  int GetDepth() const { return fDepth; }
+
+  // number of events currently stored for a category (at most the pool depth)
+  int GetNEvents(int category) const { return (category >= 0 && category < GetNCategories() ? fNEvents[category] : 0); }
+  // i-th stored event of a category, from the oldest (0) to the most recent one
+  const Event& GetEvent(int category, int i) const
+  {
+    int slot = (fNEvents[category] < fDepth ? i : (fNext[category] + i) % fDepth);
+    return fEvents[static_cast<std::size_t>(category) * fDepth + slot];
+  }
+
+  // add the legs of an event to the pool of its category, replacing the oldest event if the pool is full
+  // Only the legs with a non-zero filter (as returned by filterFunc) are stored
+  template <typename TLegs, typename F>
+  void AddEvent(int category, TLegs const& legs, F const& filterFunc)
+  {
+    if (category < 0) {
+      return;
+    }
+    if (category >= GetNCategories()) {
+      Resize(category + 1);
+    }
+    Event& event = fEvents[static_cast<std::size_t>(category) * fDepth + fNext[category]];
+    event.clear();
+    for (auto const& leg : legs) {
+      uint32_t filter = filterFunc(leg);
+      if (!filter) {
+        continue;
+      }
+      event.fPt.push_back(leg.pt());
+      event.fEta.push_back(leg.eta());
+      event.fPhi.push_back(leg.phi());
+      event.fSign.push_back(leg.sign());
+      event.fFilter.push_back(filter);
+    }
+    fNext[category] = (fNext[category] + 1) % fDepth;
+    if (fNEvents[category] < fDepth) {
+      fNEvents[category]++;
+    }
+  }
+
+ private:
+  int fDepth = 1;
+  std::vector<Event> fEvents; // fDepth slots for each category
+  std::vector<int> fNEvents;  // number of stored events for each category
+  std::vector<int> fNext;     // slot to be used by the next added event, for each category
+
+  void Resize(int nCategories)
+  {
+    fEvents.resize(static_cast<std::size_t>(nCategories) * fDepth);
+    fNEvents.resize(nCategories, 0);
+    fNext.resize(nCategories, 0);
+  }
+};
+
+#endif
@@ -21,9 +21,11 @@ ClassImp(VarManager);
 TString VarManager::fgVariableNames[VarManager::kNVars] = {""};
 TString VarManager::fgVariableUnits[VarManager::kNVars] = {""};
 bool VarManager::fgUsedVars[VarManager::kNVars] = {false};
+std::vector<int> VarManager::fgUsedVarsList;
 bool VarManager::fgUsedKF = false;
 float VarManager::fgMagField = 0.5;
-float VarManager::fgValues[VarManager::kNVars] = {0.0f};
+float VarManager::fgMagFieldMFT = 0.;
+thread_local float VarManager::fgValues[VarManager::kNVars] = {0.0f};
 std::map<int, int> VarManager::fgRunMap;
 TString VarManager::fgRunStr = "";
 std::vector<int> VarManager::fgRunList = {0};
@@ -33,6 +35,8 @@ o2::vertexing::DCAFitterN<2> VarManager::fgFitterTwoProngBarrel;
 o2::vertexing::DCAFitterN<3> VarManager::fgFitterThreeProngBarrel;
 o2::vertexing::FwdDCAFitterN<2> VarManager::fgFitterTwoProngFwd;
 o2::vertexing::FwdDCAFitterN<3> VarManager::fgFitterThreeProngFwd;
+int VarManager::fgFitterConfigVersion = 0;
+bool VarManager::fgUseTrackParCache = false;
 o2::globaltracking::MatchGlobalFwd VarManager::mMatching;
 std::map<VarManager::CalibObjects, TObject*> VarManager::fgCalibs;
 bool VarManager::fgRunTPCPostCalibration[4] = {false, false, false, false};
@@ -82,6 +86,31 @@ void VarManager::SetVariableDependencies()
   }
 }
 
+//__________________________________________________________________
+void VarManager::UpdateUsedVarsList()
+{
+  //
+  // rebuild the list of used variables, needed by the batch filling
+  //
+  fgUsedVarsList.clear();
+  for (int i = 0; i < kNVars; ++i) {
+    if (fgUsedVars[i]) {
+      fgUsedVarsList.push_back(i);
+    }
+  }
+}
+
+//__________________________________________________________________
+void VarManager::ScatterToColumns(const float* values, std::vector<float>& columns, int nObjects, int iObject)
+{
+  //
+  // copy the used variables of one object into the column-major batch buffer
+  //
+  for (int var : fgUsedVarsList) {
+    columns[static_cast<std::size_t>(var) * nObjects + iObject] = values[var];
+  }
+}
+
 //__________________________________________________________________
 void VarManager::ResetValues(int startValue, int endValue, float* values)
 {
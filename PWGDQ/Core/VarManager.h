@@ -24,9 +24,11 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <cmath>
 #include <iostream>
 #include <utility>
+#include <algorithm>
 
 #include <TObject.h>
 #include <TString.h>
@@ -490,6 +492,7 @@ class VarManager : public TObject
       fgUsedVars[var] = kTRUE;
     }
     SetVariableDependencies();
+    UpdateUsedVarsList();
   }
   static void SetUseVars(const bool* usedVars)
   {
@@ -499,12 +502,14 @@ class VarManager : public TObject
       }
     }
     SetVariableDependencies();
+    UpdateUsedVarsList();
   }
   static void SetUseVars(const std::vector<int> usedVars)
   {
     for (auto& var : usedVars) {
       fgUsedVars[var] = true;
     }
+    UpdateUsedVarsList();
   }
   static bool GetUsedVar(int var)
   {
@@ -513,6 +518,8 @@ class VarManager : public TObject
     }
     return false;
   }
+  // list of the variables flagged in fgUsedVars, used to restrict the batch filling
+  static const std::vector<int>& GetUsedVarsList() { return fgUsedVarsList; }
 
   static void SetRunNumbers(int n, int* runs);
   static void SetRunNumbers(std::vector<int> runs);
@@ -552,10 +559,13 @@ class VarManager : public TObject
     KFParticle::SetField(magField);
     fgUsedKF = true;
   }
-  // Setup magnetic field for muon propagation
+  // Setup magnetic field for muon propagation, to be called once the field of the run is initialized
   static void SetupMuonMagField()
   {
     o2::mch::TrackExtrap::setField();
+    double centerMFT[3] = {0, 0, -61.4};
+    o2::field::MagneticField* field = static_cast<o2::field::MagneticField*>(TGeoGlobalMagField::Instance()->GetField());
+    fgMagFieldMFT = field->getBz(centerMFT); // field at the centre of the MFT, used for the global muons
   }
 
   // Setup the 2 prong DCAFitterN
@@ -569,6 +579,7 @@ class VarManager : public TObject
     fgFitterTwoProngBarrel.setMinRelChi2Change(minRelChi2Change);
     fgFitterTwoProngBarrel.setUseAbsDCA(useAbsDCA);
     fgUsedKF = false;
+    fgFitterConfigVersion++;
   }
 
   // Setup the 2 prong FwdDCAFitterN
@@ -581,22 +592,26 @@ class VarManager : public TObject
     fgFitterTwoProngFwd.setMinRelChi2Change(minRelChi2Change);
     fgFitterTwoProngFwd.setUseAbsDCA(useAbsDCA);
     fgUsedKF = false;
+    fgFitterConfigVersion++;
   }
   // Use MatLayerCylSet to correct MCS in fwdtrack propagation
   static void SetupMatLUTFwdDCAFitter(o2::base::MatLayerCylSet* m)
   {
     fgFitterTwoProngFwd.setTGeoMat(false);
     fgFitterTwoProngFwd.setMatLUT(m);
+    fgFitterConfigVersion++;
   }
   // Use GeometryManager to correct MCS in fwdtrack propagation
   static void SetupTGeoFwdDCAFitter()
   {
     fgFitterTwoProngFwd.setTGeoMat(true);
+    fgFitterConfigVersion++;
   }
   // No material budget in fwdtrack propagation
   static void SetupFwdDCAFitterNoCorr()
   {
     fgFitterTwoProngFwd.setTGeoMat(false);
+    fgFitterConfigVersion++;
   }
   // Setup the 3 prong KFParticle
   static void SetupThreeProngKFParticle(float magField)
@@ -611,6 +626,23 @@ class VarManager : public TObject
     fgUsedKF = false;
   }
 
+  // Cache the track parametrizations (TrackParCov / TrackParCovFwd / KFPTrack) built for the vertexing, keyed by the track global index,
+  //   such that they are built only once per track even if the track enters many pairs or triplets
+  // NOTE: The cache has to be reset with ResetTrackParCache() whenever the track tables change (e.g. at each event)
+  static void SetUseTrackParCache(bool useCache)
+  {
+    fgUseTrackParCache = useCache;
+    ResetTrackParCache();
+  }
+  static void ResetTrackParCache()
+  {
+    auto& state = GetThreadState();
+    state.fTrackParCovCache.clear();
+    state.fFwdTrackParCovCache.clear();
+    state.fKFPTrackCache.clear();
+    state.fKFPFwdTrackCache.clear();
+  }
+
   static auto getEventPlane(int harm, float qnxa, float qnya)
   {
     // Compute event plane angle from qn vector components for the sub-event A
@@ -648,6 +680,15 @@ class VarManager : public TObject
   template <int pairType, typename T1, typename T2>
   static void FillPairVn(T1 const& t1, T2 const& t2, float* values = nullptr);
 
+  // Batch filling: the variables of N objects are written in a column-major buffer, columns[var * N + iObject]
+  // Only the columns of the variables flagged in fgUsedVars are written. The values in "values" (fgValues by default),
+  //   e.g. the event variables from a previous FillEvent() call, are used as starting point for each object
+  template <uint32_t fillMap, typename T>
+  static void FillTrackBatch(T const& tracks, std::vector<float>& columns, float* values = nullptr);
+  // The pairs container holds std::pair-like objects with the two legs
+  template <int pairType, uint32_t fillMap, typename P>
+  static void FillPairBatch(P const& pairs, std::vector<float>& columns, float* values = nullptr);
+
   static void SetCalibrationObject(CalibObjects calib, TObject* obj)
   {
     fgCalibs[calib] = obj;
@@ -679,15 +720,21 @@ class VarManager : public TObject
   VarManager();
   ~VarManager() override;
 
-  static float fgValues[kNVars]; // array holding all variables computed during analysis
+  // NOTE: The variable values are thread-local: each thread fills its own array, while the configuration
+  //       (used variables, calibrations, fitter setup, run list) is shared and must be set before threads are started
+  static thread_local float fgValues[kNVars]; // array holding all variables computed during analysis
   static void ResetValues(int startValue = 0, int endValue = kNVars, float* values = nullptr);
 
  private:
-  static bool fgUsedVars[kNVars]; // holds flags for when the corresponding variable is needed (e.g., in the histogram manager, in cuts, mixing handler, etc.)
+  static bool fgUsedVars[kNVars];         // holds flags for when the corresponding variable is needed (e.g., in the histogram manager, in cuts, mixing handler, etc.)
+  static std::vector<int> fgUsedVarsList; // indices of the used variables
   static bool fgUsedKF;
   static void SetVariableDependencies(); // toggle those variables on which other used variables might depend
+  static void UpdateUsedVarsList();      // rebuild fgUsedVarsList from fgUsedVars
+  static void ScatterToColumns(const float* values, std::vector<float>& columns, int nObjects, int iObject);
 
   static float fgMagField;
+  static float fgMagFieldMFT;             // Bz at the centre of the MFT, set per run by SetupMuonMagField()
   static std::map<int, int> fgRunMap;     // map of runs to be used in histogram axes
   static TString fgRunStr;                // semi-colon separated list of runs, to be used for histogram axis labels
   static std::vector<int> fgRunList;      // vector of runs, to be used for histogram axis
@@ -699,17 +746,61 @@ class VarManager : public TObject
   template <typename T, typename U, typename V>
   static auto getRotatedCovMatrixXX(const T& matrix, U phi, V theta);
   template <typename T>
+  static o2::track::TrackParCov createTrackParCovFromTrack(const T& track);
+  template <typename T>
+  static o2::track::TrackParCovFwd createFwdTrackParCovFromFwdTrack(const T& muon);
+  template <typename T>
   static KFPTrack createKFPTrackFromTrack(const T& track);
   template <typename T>
   static KFPTrack createKFPFwdTrackFromFwdTrack(const T& muon);
   template <typename T>
+  static o2::track::TrackParCov getCachedTrackParCov(const T& track);
+  template <typename T>
+  static o2::track::TrackParCovFwd getCachedFwdTrackParCov(const T& muon);
+  template <typename T>
+  static KFPTrack getCachedKFPTrack(const T& track);
+  template <typename T>
+  static KFPTrack getCachedKFPFwdTrack(const T& muon);
+  template <typename TCache, typename T, typename F>
+  static typename TCache::mapped_type getCached(TCache& cache, const T& track, F const& create);
+  template <typename T>
   static KFPVertex createKFPVertexFromCollision(const T& collision);
   static float calculateCosPA(KFParticle kfp, KFParticle PV);
 
+  // NOTE: the fitters below hold the configuration set via the Setup*() functions. The fill functions use
+  //       per-thread copies (see GetThreadState()), so that several threads can fill variables concurrently
   static o2::vertexing::DCAFitterN<2> fgFitterTwoProngBarrel;
   static o2::vertexing::DCAFitterN<3> fgFitterThreeProngBarrel;
   static o2::vertexing::FwdDCAFitterN<2> fgFitterTwoProngFwd;
   static o2::vertexing::FwdDCAFitterN<3> fgFitterThreeProngFwd;
+  static int fgFitterConfigVersion; // incremented at each change of the fitter configuration
+  static bool fgUseTrackParCache;   // if true, the track parametrizations used in the vertexing are cached (see SetUseTrackParCache())
+
+  // working state owned by each thread
+  struct ThreadState {
+    int fFitterConfigVersion = -1;
+    o2::vertexing::DCAFitterN<2> fFitterTwoProngBarrel;
+    o2::vertexing::DCAFitterN<3> fFitterThreeProngBarrel;
+    o2::vertexing::FwdDCAFitterN<2> fFitterTwoProngFwd;
+    o2::vertexing::FwdDCAFitterN<3> fFitterThreeProngFwd;
+    // track parametrization caches, keyed by the track global index
+    std::unordered_map<int64_t, o2::track::TrackParCov> fTrackParCovCache;
+    std::unordered_map<int64_t, o2::track::TrackParCovFwd> fFwdTrackParCovCache;
+    std::unordered_map<int64_t, KFPTrack> fKFPTrackCache;
+    std::unordered_map<int64_t, KFPTrack> fKFPFwdTrackCache;
+  };
+  static ThreadState& GetThreadState()
+  {
+    static thread_local ThreadState state;
+    if (state.fFitterConfigVersion != fgFitterConfigVersion) {
+      state.fFitterTwoProngBarrel = fgFitterTwoProngBarrel;
+      state.fFitterThreeProngBarrel = fgFitterThreeProngBarrel;
+      state.fFitterTwoProngFwd = fgFitterTwoProngFwd;
+      state.fFitterThreeProngFwd = fgFitterThreeProngFwd;
+      state.fFitterConfigVersion = fgFitterConfigVersion;
+    }
+    return state;
+  }
   static o2::globaltracking::MatchGlobalFwd mMatching;
 
   static std::map<CalibObjects, TObject*> fgCalibs; // map of calibration histograms
@@ -737,13 +828,68 @@ auto VarManager::getRotatedCovMatrixXX(const T& matrix, U phi, V theta)
 }
 
 template <typename T>
-KFPTrack VarManager::createKFPTrackFromTrack(const T& track)
+o2::track::TrackParCov VarManager::createTrackParCovFromTrack(const T& track)
 {
   std::array<float, 5> trackpars = {track.y(), track.z(), track.snp(), track.tgl(), track.signed1Pt()};
   std::array<float, 15> trackcovs = {track.cYY(), track.cZY(), track.cZZ(), track.cSnpY(), track.cSnpZ(),
                                      track.cSnpSnp(), track.cTglY(), track.cTglZ(), track.cTglSnp(), track.cTglTgl(),
                                      track.c1PtY(), track.c1PtZ(), track.c1PtSnp(), track.c1PtTgl(), track.c1Pt21Pt2()};
-  o2::track::TrackParametrizationWithError trackparCov{track.x(), track.alpha(), std::move(trackpars), std::move(trackcovs)};
+  return o2::track::TrackParCov{track.x(), track.alpha(), trackpars, trackcovs};
+}
+
+template <typename T>
+o2::track::TrackParCovFwd VarManager::createFwdTrackParCovFromFwdTrack(const T& muon)
+{
+  double chi2 = muon.chi2();
+  SMatrix5 tpars(muon.x(), muon.y(), muon.phi(), muon.tgl(), muon.signed1Pt());
+  std::vector<double> v1{muon.cXX(), muon.cXY(), muon.cYY(), muon.cPhiX(), muon.cPhiY(),
+                         muon.cPhiPhi(), muon.cTglX(), muon.cTglY(), muon.cTglPhi(), muon.cTglTgl(),
+                         muon.c1PtX(), muon.c1PtY(), muon.c1PtPhi(), muon.c1PtTgl(), muon.c1Pt21Pt2()};
+  SMatrix55 tcovs(v1.begin(), v1.end());
+  return o2::track::TrackParCovFwd{muon.z(), tpars, tcovs, chi2};
+}
+
+template <typename TCache, typename T, typename F>
+typename TCache::mapped_type VarManager::getCached(TCache& cache, const T& track, F const& create)
+{
+  if (!fgUseTrackParCache) {
+    return create(track);
+  }
+  auto it = cache.find(track.globalIndex());
+  if (it == cache.end()) {
+    it = cache.emplace(track.globalIndex(), create(track)).first;
+  }
+  return it->second;
+}
+
+template <typename T>
+o2::track::TrackParCov VarManager::getCachedTrackParCov(const T& track)
+{
+  return getCached(GetThreadState().fTrackParCovCache, track, [](const T& t) { return createTrackParCovFromTrack(t); });
+}
+
+template <typename T>
+o2::track::TrackParCovFwd VarManager::getCachedFwdTrackParCov(const T& muon)
+{
+  return getCached(GetThreadState().fFwdTrackParCovCache, muon, [](const T& t) { return createFwdTrackParCovFromFwdTrack(t); });
+}
+
+template <typename T>
+KFPTrack VarManager::getCachedKFPTrack(const T& track)
+{
+  return getCached(GetThreadState().fKFPTrackCache, track, [](const T& t) { return createKFPTrackFromTrack(t); });
+}
+
+template <typename T>
+KFPTrack VarManager::getCachedKFPFwdTrack(const T& muon)
+{
+  return getCached(GetThreadState().fKFPFwdTrackCache, muon, [](const T& t) { return createKFPFwdTrackFromFwdTrack(t); });
+}
+
+template <typename T>
+KFPTrack VarManager::createKFPTrackFromTrack(const T& track)
+{
+  o2::track::TrackParCov trackparCov = createTrackParCovFromTrack(track);
   std::array<float, 3> trkpos_par;
   std::array<float, 3> trkmom_par;
   std::array<float, 21> trk_cov;
@@ -769,12 +915,7 @@ template <typename T>
 KFPTrack VarManager::createKFPFwdTrackFromFwdTrack(const T& muon)
 {
   double chi2 = muon.chi2();
-  SMatrix5 tpars(muon.x(), muon.y(), muon.phi(), muon.tgl(), muon.signed1Pt());
-  std::vector<double> v1{muon.cXX(), muon.cXY(), muon.cYY(), muon.cPhiX(), muon.cPhiY(),
-                         muon.cPhiPhi(), muon.cTglX(), muon.cTglY(), muon.cTglPhi(), muon.cTglTgl(),
-                         muon.c1PtX(), muon.c1PtY(), muon.c1PtPhi(), muon.c1PtTgl(), muon.c1Pt21Pt2()};
-  SMatrix55 tcovs(v1.begin(), v1.end());
-  o2::track::TrackParCovFwd trackparCov{muon.z(), tpars, tcovs, chi2};
+  o2::track::TrackParCovFwd trackparCov = createFwdTrackParCovFromFwdTrack(muon);
 
   std::array<float, 21> trk_cov;
   trackparCov.getCovXYZPxPyPzGlo(trk_cov);
@@ -833,12 +974,9 @@ void VarManager::FillPropagateMuon(const T& muon, const C& collision, float* val
       propmuon.setCovariances(proptrack.getCovariances());
 
     } else if (static_cast<int>(muon.trackType()) < 2) {
-      double centerMFT[3] = {0, 0, -61.4};
-      o2::field::MagneticField* field = static_cast<o2::field::MagneticField*>(TGeoGlobalMagField::Instance()->GetField());
-      auto Bz = field->getBz(centerMFT); // Get field at centre of MFT
       auto geoMan = o2::base::GeometryManager::meanMaterialBudget(muon.x(), muon.y(), muon.z(), collision.posX(), collision.posY(), collision.posZ());
       auto x2x0 = static_cast<float>(geoMan.meanX2X0);
-      fwdtrack.propagateToVtxhelixWithMCS(collision.posZ(), {collision.posX(), collision.posY()}, {collision.covXX(), collision.covYY()}, Bz, x2x0);
+      fwdtrack.propagateToVtxhelixWithMCS(collision.posZ(), {collision.posX(), collision.posY()}, {collision.covXX(), collision.covYY()}, fgMagFieldMFT, x2x0);
       propmuon.setParameters(fwdtrack.getParameters());
       propmuon.setZ(fwdtrack.getZ());
       propmuon.setCovariances(fwdtrack.getCovariances());
@@ -1491,6 +1629,40 @@ void VarManager::FillTrackMC(const U& mcStack, T const& track, float* values)
   FillTrackDerived(values);
 }
 
+template <uint32_t fillMap, typename T>
+void VarManager::FillTrackBatch(T const& tracks, std::vector<float>& columns, float* values)
+{
+  if (!values) {
+    values = fgValues;
+  }
+  const int nObjects = tracks.size();
+  columns.resize(static_cast<std::size_t>(kNVars) * nObjects);
+  float trackValues[kNVars];
+  int iObject = 0;
+  for (auto const& track : tracks) {
+    std::copy(values, values + kNVars, trackValues);
+    FillTrack<fillMap>(track, trackValues);
+    ScatterToColumns(trackValues, columns, nObjects, iObject++);
+  }
+}
+
+template <int pairType, uint32_t fillMap, typename P>
+void VarManager::FillPairBatch(P const& pairs, std::vector<float>& columns, float* values)
+{
+  if (!values) {
+    values = fgValues;
+  }
+  const int nObjects = pairs.size();
+  columns.resize(static_cast<std::size_t>(kNVars) * nObjects);
+  float pairValues[kNVars];
+  int iObject = 0;
+  for (auto const& [t1, t2] : pairs) {
+    std::copy(values, values + kNVars, pairValues);
+    FillPair<pairType, fillMap>(t1, t2, pairValues);
+    ScatterToColumns(pairValues, columns, nObjects, iObject++);
+  }
+}
+
 template <int pairType, uint32_t fillMap, typename T1, typename T2>
 void VarManager::FillPair(T1 const& t1, T2 const& t2, float* values)
 {
@@ -1625,7 +1797,7 @@ void VarManager::FillPair(T1 const& t1, T2 const& t2, float* values)
     // u = v12 / |v12|            , the unit vector of v12
     // v = v1 x v2 / |v1 x v2|    , unit vector perpendicular to v1 and v2
 
-    float bz = fgFitterTwoProngBarrel.getBz();
+    float bz = GetThreadState().fFitterTwoProngBarrel.getBz();
 
     bool swapTracks = false;
     if (v1.Pt() < v2.Pt()) { // ordering of track, pt1 > pt2
@@ -1809,34 +1981,14 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
     // auto pars2 = getTrackParCov(t2);
     // We need to hide the cov data members from the cases when no cov table is provided
     if constexpr ((pairType == kDecayToEE) && trackHasCov) {
-      std::array<float, 5> t1pars = {t1.y(), t1.z(), t1.snp(), t1.tgl(), t1.signed1Pt()};
-      std::array<float, 15> t1covs = {t1.cYY(), t1.cZY(), t1.cZZ(), t1.cSnpY(), t1.cSnpZ(),
-                                      t1.cSnpSnp(), t1.cTglY(), t1.cTglZ(), t1.cTglSnp(), t1.cTglTgl(),
-                                      t1.c1PtY(), t1.c1PtZ(), t1.c1PtSnp(), t1.c1PtTgl(), t1.c1Pt21Pt2()};
-      o2::track::TrackParCov pars1{t1.x(), t1.alpha(), t1pars, t1covs};
-      std::array<float, 5> t2pars = {t2.y(), t2.z(), t2.snp(), t2.tgl(), t2.signed1Pt()};
-      std::array<float, 15> t2covs = {t2.cYY(), t2.cZY(), t2.cZZ(), t2.cSnpY(), t2.cSnpZ(),
-                                      t2.cSnpSnp(), t2.cTglY(), t2.cTglZ(), t2.cTglSnp(), t2.cTglTgl(),
-                                      t2.c1PtY(), t2.c1PtZ(), t2.c1PtSnp(), t2.c1PtTgl(), t2.c1Pt21Pt2()};
-      o2::track::TrackParCov pars2{t2.x(), t2.alpha(), t2pars, t2covs};
-      procCode = fgFitterTwoProngBarrel.process(pars1, pars2);
+      o2::track::TrackParCov pars1 = getCachedTrackParCov(t1);
+      o2::track::TrackParCov pars2 = getCachedTrackParCov(t2);
+      procCode = GetThreadState().fFitterTwoProngBarrel.process(pars1, pars2);
     } else if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
       // Initialize track parameters for forward
-      double chi21 = t1.chi2();
-      double chi22 = t2.chi2();
-      SMatrix5 t1pars(t1.x(), t1.y(), t1.phi(), t1.tgl(), t1.signed1Pt());
-      std::vector<double> v1{t1.cXX(), t1.cXY(), t1.cYY(), t1.cPhiX(), t1.cPhiY(),
-                             t1.cPhiPhi(), t1.cTglX(), t1.cTglY(), t1.cTglPhi(), t1.cTglTgl(),
-                             t1.c1PtX(), t1.c1PtY(), t1.c1PtPhi(), t1.c1PtTgl(), t1.c1Pt21Pt2()};
-      SMatrix55 t1covs(v1.begin(), v1.end());
-      o2::track::TrackParCovFwd pars1{t1.z(), t1pars, t1covs, chi21};
-      SMatrix5 t2pars(t2.x(), t2.y(), t2.phi(), t2.tgl(), t2.signed1Pt());
-      std::vector<double> v2{t2.cXX(), t2.cXY(), t2.cYY(), t2.cPhiX(), t2.cPhiY(),
-                             t2.cPhiPhi(), t2.cTglX(), t2.cTglY(), t2.cTglPhi(), t2.cTglTgl(),
-                             t2.c1PtX(), t2.c1PtY(), t2.c1PtPhi(), t2.c1PtTgl(), t2.c1Pt21Pt2()};
-      SMatrix55 t2covs(v2.begin(), v2.end());
-      o2::track::TrackParCovFwd pars2{t2.z(), t2pars, t2covs, chi22};
-      procCode = fgFitterTwoProngFwd.process(pars1, pars2);
+      o2::track::TrackParCovFwd pars1 = getCachedFwdTrackParCov(t1);
+      o2::track::TrackParCovFwd pars2 = getCachedFwdTrackParCov(t2);
+      procCode = GetThreadState().fFitterTwoProngFwd.process(pars1, pars2);
     } else {
       return;
     }
@@ -1873,11 +2025,11 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
       auto covMatrixPV = primaryVertex.getCov();
 
       if constexpr (pairType == kDecayToEE && trackHasCov) {
-        secondaryVertex = fgFitterTwoProngBarrel.getPCACandidate();
-        covMatrixPCA = fgFitterTwoProngBarrel.calcPCACovMatrixFlat();
-        auto chi2PCA = fgFitterTwoProngBarrel.getChi2AtPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngBarrel.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngBarrel.getTrack(1);
+        secondaryVertex = GetThreadState().fFitterTwoProngBarrel.getPCACandidate();
+        covMatrixPCA = GetThreadState().fFitterTwoProngBarrel.calcPCACovMatrixFlat();
+        auto chi2PCA = GetThreadState().fFitterTwoProngBarrel.getChi2AtPCACandidate();
+        auto trackParVar0 = GetThreadState().fFitterTwoProngBarrel.getTrack(0);
+        auto trackParVar1 = GetThreadState().fFitterTwoProngBarrel.getTrack(1);
         values[kVertexingChi2PCA] = chi2PCA;
         v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
         v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
@@ -1885,11 +2037,11 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
 
       } else if constexpr (pairType == kDecayToMuMu && muonHasCov) {
         // Get pca candidate from forward DCA fitter
-        secondaryVertex = fgFitterTwoProngFwd.getPCACandidate();
-        covMatrixPCA = fgFitterTwoProngFwd.calcPCACovMatrixFlat();
-        auto chi2PCA = fgFitterTwoProngFwd.getChi2AtPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngFwd.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngFwd.getTrack(1);
+        secondaryVertex = GetThreadState().fFitterTwoProngFwd.getPCACandidate();
+        covMatrixPCA = GetThreadState().fFitterTwoProngFwd.calcPCACovMatrixFlat();
+        auto chi2PCA = GetThreadState().fFitterTwoProngFwd.getChi2AtPCACandidate();
+        auto trackParVar0 = GetThreadState().fFitterTwoProngFwd.getTrack(0);
+        auto trackParVar1 = GetThreadState().fFitterTwoProngFwd.getTrack(1);
         values[kVertexingChi2PCA] = chi2PCA;
         v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
         v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
@@ -1945,9 +2097,9 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
     KFParticle trk1KF;
     KFParticle KFGeoTwoProng;
     if constexpr ((pairType == kDecayToEE) && trackHasCov) {
-      KFPTrack kfpTrack0 = createKFPTrackFromTrack(t1);
+      KFPTrack kfpTrack0 = getCachedKFPTrack(t1);
       trk0KF = KFParticle(kfpTrack0, -11 * t1.sign());
-      KFPTrack kfpTrack1 = createKFPTrackFromTrack(t2);
+      KFPTrack kfpTrack1 = getCachedKFPTrack(t2);
       trk1KF = KFParticle(kfpTrack1, -11 * t2.sign());
 
       KFGeoTwoProng.SetConstructMethod(2);
@@ -1955,9 +2107,9 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
       KFGeoTwoProng.AddDaughter(trk1KF);
 
     } else if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
-      KFPTrack kfpTrack0 = createKFPFwdTrackFromFwdTrack(t1);
+      KFPTrack kfpTrack0 = getCachedKFPFwdTrack(t1);
       trk0KF = KFParticle(kfpTrack0, -13 * t1.sign());
-      KFPTrack kfpTrack1 = createKFPFwdTrackFromFwdTrack(t2);
+      KFPTrack kfpTrack1 = getCachedKFPFwdTrack(t2);
       trk1KF = KFParticle(kfpTrack1, -13 * t2.sign());
 
       KFGeoTwoProng.SetConstructMethod(2);
@@ -2132,51 +2284,19 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
       mlepton = o2::constants::physics::MassMuon;
       mtrack = o2::constants::physics::MassMuon;
 
-      double chi21 = lepton1.chi2();
-      double chi22 = lepton2.chi2();
-      double chi23 = track.chi2();
-      SMatrix5 t1pars(lepton1.x(), lepton1.y(), lepton1.phi(), lepton1.tgl(), lepton1.signed1Pt());
-      std::vector<double> v1{lepton1.cXX(), lepton1.cXY(), lepton1.cYY(), lepton1.cPhiX(), lepton1.cPhiY(),
-                             lepton1.cPhiPhi(), lepton1.cTglX(), lepton1.cTglY(), lepton1.cTglPhi(), lepton1.cTglTgl(),
-                             lepton1.c1PtX(), lepton1.c1PtY(), lepton1.c1PtPhi(), lepton1.c1PtTgl(), lepton1.c1Pt21Pt2()};
-      SMatrix55 t1covs(v1.begin(), v1.end());
-      o2::track::TrackParCovFwd pars1{lepton1.z(), t1pars, t1covs, chi21};
-
-      SMatrix5 t2pars(lepton2.x(), lepton2.y(), lepton2.phi(), lepton2.tgl(), lepton2.signed1Pt());
-      std::vector<double> v2{lepton2.cXX(), lepton2.cXY(), lepton2.cYY(), lepton2.cPhiX(), lepton2.cPhiY(),
-                             lepton2.cPhiPhi(), lepton2.cTglX(), lepton2.cTglY(), lepton2.cTglPhi(), lepton2.cTglTgl(),
-                             lepton2.c1PtX(), lepton2.c1PtY(), lepton2.c1PtPhi(), lepton2.c1PtTgl(), lepton2.c1Pt21Pt2()};
-      SMatrix55 t2covs(v2.begin(), v2.end());
-      o2::track::TrackParCovFwd pars2{lepton2.z(), t2pars, t2covs, chi22};
-
-      SMatrix5 t3pars(track.x(), track.y(), track.phi(), track.tgl(), track.signed1Pt());
-      std::vector<double> v3{track.cXX(), track.cXY(), track.cYY(), track.cPhiX(), track.cPhiY(),
-                             track.cPhiPhi(), track.cTglX(), track.cTglY(), track.cTglPhi(), track.cTglTgl(),
-                             track.c1PtX(), track.c1PtY(), track.c1PtPhi(), track.c1PtTgl(), track.c1Pt21Pt2()};
-      SMatrix55 t3covs(v3.begin(), v3.end());
-      o2::track::TrackParCovFwd pars3{track.z(), t3pars, t3covs, chi23};
-      procCode = VarManager::fgFitterThreeProngFwd.process(pars1, pars2, pars3);
-      procCodeJpsi = VarManager::fgFitterTwoProngFwd.process(pars1, pars2);
+      o2::track::TrackParCovFwd pars1 = getCachedFwdTrackParCov(lepton1);
+      o2::track::TrackParCovFwd pars2 = getCachedFwdTrackParCov(lepton2);
+      o2::track::TrackParCovFwd pars3 = getCachedFwdTrackParCov(track);
+      procCode = GetThreadState().fFitterThreeProngFwd.process(pars1, pars2, pars3);
+      procCodeJpsi = GetThreadState().fFitterTwoProngFwd.process(pars1, pars2);
     } else if constexpr ((candidateType == kBtoJpsiEEK) && trackHasCov) {
       mlepton = o2::constants::physics::MassElectron;
       mtrack = o2::constants::physics::MassKaonCharged;
-      std::array<float, 5> lepton1pars = {lepton1.y(), lepton1.z(), lepton1.snp(), lepton1.tgl(), lepton1.signed1Pt()};
-      std::array<float, 15> lepton1covs = {lepton1.cYY(), lepton1.cZY(), lepton1.cZZ(), lepton1.cSnpY(), lepton1.cSnpZ(),
-                                           lepton1.cSnpSnp(), lepton1.cTglY(), lepton1.cTglZ(), lepton1.cTglSnp(), lepton1.cTglTgl(),
-                                           lepton1.c1PtY(), lepton1.c1PtZ(), lepton1.c1PtSnp(), lepton1.c1PtTgl(), lepton1.c1Pt21Pt2()};
-      o2::track::TrackParCov pars1{lepton1.x(), lepton1.alpha(), lepton1pars, lepton1covs};
-      std::array<float, 5> lepton2pars = {lepton2.y(), lepton2.z(), lepton2.snp(), lepton2.tgl(), lepton2.signed1Pt()};
-      std::array<float, 15> lepton2covs = {lepton2.cYY(), lepton2.cZY(), lepton2.cZZ(), lepton2.cSnpY(), lepton2.cSnpZ(),
-                                           lepton2.cSnpSnp(), lepton2.cTglY(), lepton2.cTglZ(), lepton2.cTglSnp(), lepton2.cTglTgl(),
-                                           lepton2.c1PtY(), lepton2.c1PtZ(), lepton2.c1PtSnp(), lepton2.c1PtTgl(), lepton2.c1Pt21Pt2()};
-      o2::track::TrackParCov pars2{lepton2.x(), lepton2.alpha(), lepton2pars, lepton2covs};
-      std::array<float, 5> lepton3pars = {track.y(), track.z(), track.snp(), track.tgl(), track.signed1Pt()};
-      std::array<float, 15> lepton3covs = {track.cYY(), track.cZY(), track.cZZ(), track.cSnpY(), track.cSnpZ(),
-                                           track.cSnpSnp(), track.cTglY(), track.cTglZ(), track.cTglSnp(), track.cTglTgl(),
-                                           track.c1PtY(), track.c1PtZ(), track.c1PtSnp(), track.c1PtTgl(), track.c1Pt21Pt2()};
-      o2::track::TrackParCov pars3{track.x(), track.alpha(), lepton3pars, lepton3covs};
-      procCode = VarManager::fgFitterThreeProngBarrel.process(pars1, pars2, pars3);
-      procCodeJpsi = VarManager::fgFitterTwoProngBarrel.process(pars1, pars2);
+      o2::track::TrackParCov pars1 = getCachedTrackParCov(lepton1);
+      o2::track::TrackParCov pars2 = getCachedTrackParCov(lepton2);
+      o2::track::TrackParCov pars3 = getCachedTrackParCov(track);
+      procCode = GetThreadState().fFitterThreeProngBarrel.process(pars1, pars2, pars3);
+      procCodeJpsi = GetThreadState().fFitterTwoProngBarrel.process(pars1, pars2);
     } else {
       return;
     }
@@ -2227,14 +2347,14 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
       auto covMatrixPV = primaryVertex.getCov();
 
       if constexpr (candidateType == kBtoJpsiEEK && trackHasCov) {
-        secondaryVertex = fgFitterThreeProngBarrel.getPCACandidate();
-        covMatrixPCA = fgFitterThreeProngBarrel.calcPCACovMatrixFlat();
+        secondaryVertex = GetThreadState().fFitterThreeProngBarrel.getPCACandidate();
+        covMatrixPCA = GetThreadState().fFitterThreeProngBarrel.calcPCACovMatrixFlat();
       } else if constexpr (candidateType == kBcToThreeMuons && muonHasCov) {
-        secondaryVertex = fgFitterThreeProngFwd.getPCACandidate();
-        covMatrixPCA = fgFitterThreeProngFwd.calcPCACovMatrixFlat();
+        secondaryVertex = GetThreadState().fFitterThreeProngFwd.getPCACandidate();
+        covMatrixPCA = GetThreadState().fFitterThreeProngFwd.calcPCACovMatrixFlat();
       }
 
-      auto chi2PCA = fgFitterThreeProngBarrel.getChi2AtPCACandidate();
+      auto chi2PCA = GetThreadState().fFitterThreeProngBarrel.getChi2AtPCACandidate();
       if (fgUsedVars[kVertexingChi2PCA])
         values[VarManager::kVertexingChi2PCA] = chi2PCA;
 
@@ -2290,11 +2410,11 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
     KFParticle KFGeoThreeProngBarrel;
 
     if constexpr ((candidateType == kBtoJpsiEEK) && trackHasCov) {
-      KFPTrack kfpTrack0 = createKFPTrackFromTrack(lepton1);
+      KFPTrack kfpTrack0 = getCachedKFPTrack(lepton1);
       lepton1KF = KFParticle(kfpTrack0, 11 * lepton1.sign());
-      KFPTrack kfpTrack1 = createKFPTrackFromTrack(lepton2);
+      KFPTrack kfpTrack1 = getCachedKFPTrack(lepton2);
       lepton2KF = KFParticle(kfpTrack1, 11 * lepton2.sign());
-      KFPTrack kfpTrack2 = createKFPTrackFromTrack(track);
+      KFPTrack kfpTrack2 = getCachedKFPTrack(track);
       hadronKF = KFParticle(kfpTrack2, 321 * track.sign()); // kaon mass
 
       KFGeoThreeProngBarrel.SetConstructMethod(2);
@@ -18,6 +18,7 @@
 // The event filtering (filterPP), centrality, and V0Bits (from v0-selector) can be switched on/off by selecting one
 //  of the process functions
 #include <iostream>
+#include <algorithm>
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/ASoAHelpers.h"
@@ -47,6 +48,7 @@
 #include "CommonDataFormat/InteractionRecord.h"
 #include "DetectorsVertexing/PVertexerParams.h"
 #include "MathUtils/Primitive2D.h"
+#include "MathUtils/detail/TypeTruncation.h"
 #include "DataFormatsGlobalTracking/RecoContainer.h"
 #include "Common/DataModel/CollisionAssociationTables.h"
 #include "DataFormatsParameters/GRPMagField.h"
@@ -172,6 +174,8 @@ struct TableMaker {
   Configurable<bool> fConfigDummyRunlist{"cfgDummyRunlist", false, "If true, use dummy runlist"};
   Configurable<int> fConfigInitRunNumber{"cfgInitRunNumber", 543215, "Initial run number used in run by run checks"};
   Configurable<bool> fPropMuon{"cfgPropMuon", false, "Propgate muon tracks through absorber"};
+  Configurable<int> fConfigKineMantissaBits{"cfgKineMantissaBits", 23, "Number of float mantissa bits (0-23) kept for the skimmed track and muon kinematics (pt, eta, phi, TPC inner param); 23 keeps full precision"};
+  Configurable<int> fConfigPIDMantissaBits{"cfgPIDMantissaBits", 23, "Number of float mantissa bits (0-23) kept for the skimmed barrel PID columns; 23 keeps full precision"};
   Configurable<std::string> geoPath{"geoPath", "GLO/Config/GeometryAligned", "Path of the geometry file"};
   Configurable<std::string> grpmagPath{"grpmagPath", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object"};
   Configurable<std::string> grpmagPathRun2{"grpmagPathRun2", "GLO/GRP/GRP", "CCDB path of the GRPObject (Usage for Run 2)"};
@@ -198,8 +202,23 @@ struct TableMaker {
 
   Filter muonFilter = o2::aod::fwdtrack::pt >= fConfigMuonPtLow;
 
+  // masks used to truncate the float mantissa of the skimmed columns; the zeroed bits compress away in the output
+  uint32_t fKineMask = 0xFFFFFFFF;
+  uint32_t fPIDMask = 0xFFFFFFFF;
+
+  static uint32_t getMantissaMask(int nBits)
+  {
+    nBits = std::clamp(nBits, 0, 23);
+    return ~((uint32_t(1) << (23 - nBits)) - 1);
+  }
+  float truncKine(float x) const { return o2::math_utils::detail::truncateFloatFraction(x, fKineMask); }
+  float truncPID(float x) const { return o2::math_utils::detail::truncateFloatFraction(x, fPIDMask); }
+
   void init(o2::framework::InitContext& context)
   {
+    fKineMask = getMantissaMask(fConfigKineMantissaBits.value);
+    fPIDMask = getMantissaMask(fConfigPIDMantissaBits.value);
+
     DefineCuts();
     fCCDB->setURL(fConfigCcdbUrl);
     fCCDB->setCaching(true);
@@ -364,13 +383,13 @@ struct TableMaker {
           o2::base::Propagator::initFieldFromGRP(grpmagrun2);
         }
       } else {
-        if (fPropMuon) {
-          VarManager::SetupMuonMagField();
-        }
         grpmag = fCCDB->getForTimeStamp<o2::parameters::GRPMagField>(grpmagPath, bc.timestamp());
         if (grpmag != nullptr) {
           o2::base::Propagator::initFieldFromGRP(grpmag);
         }
+        if (fPropMuon) {
+          VarManager::SetupMuonMagField();
+        }
       }
 
       fCurrentRun = bc.runNumber();
@@ -538,8 +557,8 @@ struct TableMaker {
         }
 
         // create the track tables
-        trackBasic(event.lastIndex(), trackFilteringTag, track.pt(), track.eta(), track.phi(), track.sign(), isAmbiguous);
-        trackBarrel(track.tpcInnerParam(), track.flags(), track.itsClusterMap(), track.itsChi2NCl(),
+        trackBasic(event.lastIndex(), trackFilteringTag, truncKine(track.pt()), truncKine(track.eta()), truncKine(track.phi()), track.sign(), isAmbiguous);
+        trackBarrel(truncKine(track.tpcInnerParam()), track.flags(), track.itsClusterMap(), track.itsChi2NCl(),
                     track.tpcNClsFindable(), track.tpcNClsFindableMinusFound(), track.tpcNClsFindableMinusCrossedRows(),
                     track.tpcNClsShared(), track.tpcChi2NCl(),
                     track.trdChi2(), track.trdPattern(), track.tofChi2(),
@@ -559,11 +578,11 @@ struct TableMaker {
           float nSigmaPi = (fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaPi_Corr] : track.tpcNSigmaPi());
           float nSigmaKa = ((fConfigComputeTPCpostCalib & fConfigComputeTPCpostCalibKaon) ? VarManager::fgValues[VarManager::kTPCnSigmaKa_Corr] : track.tpcNSigmaKa());
           float nSigmaPr = (fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaPr_Corr] : track.tpcNSigmaPr());
-          trackBarrelPID(track.tpcSignal(),
-                         nSigmaEl, track.tpcNSigmaMu(), nSigmaPi, nSigmaKa, nSigmaPr,
-                         track.beta(),
-                         track.tofNSigmaEl(), track.tofNSigmaMu(), track.tofNSigmaPi(), track.tofNSigmaKa(), track.tofNSigmaPr(),
-                         track.trdSignal());
+          trackBarrelPID(truncPID(track.tpcSignal()),
+                         truncPID(nSigmaEl), truncPID(track.tpcNSigmaMu()), truncPID(nSigmaPi), truncPID(nSigmaKa), truncPID(nSigmaPr),
+                         truncPID(track.beta()),
+                         truncPID(track.tofNSigmaEl()), truncPID(track.tofNSigmaMu()), truncPID(track.tofNSigmaPi()), truncPID(track.tofNSigmaKa()), truncPID(track.tofNSigmaPr()),
+                         truncPID(track.trdSignal()));
         }
       }
     } // end if constexpr (TTrackFillMap)
@@ -716,7 +735,7 @@ struct TableMaker {
           }
         }
 
-        muonBasic(event.lastIndex(), trackFilteringTag, VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], muon.sign(), isAmbiguous);
+        muonBasic(event.lastIndex(), trackFilteringTag, truncKine(VarManager::fgValues[VarManager::kPt]), truncKine(VarManager::fgValues[VarManager::kEta]), truncKine(VarManager::fgValues[VarManager::kPhi]), muon.sign(), isAmbiguous);
         muonExtra(muon.nClusters(), muon.pDca(), muon.rAtAbsorberEnd(),
                   muon.chi2(), muon.chi2MatchMCHMID(), muon.chi2MatchMCHMFT(),
                   muon.matchScoreMCHMFT(), newMatchIndex.find(muon.index())->second, newMFTMatchIndex.find(muon.index())->second, muon.mchBitMap(), muon.midBitMap(),
@@ -738,14 +757,23 @@ struct TableMaker {
   void fullSkimmingIndices(TEvent const& collision, aod::BCsWithTimestamps const&, TTracks const& tracksBarrel, TMuons const& tracksMuon, AssocTracks const& trackIndices, AssocMuons const& fwdtrackIndices)
   {
     auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
-    if (fConfigComputeTPCpostCalib && fCurrentRun != bc.runNumber()) {
-      auto calibList = fCCDB->getForTimeStamp<TList>(fConfigCcdbPathTPC.value, bc.timestamp());
-      VarManager::SetCalibrationObject(VarManager::kTPCElectronMean, calibList->FindObject("mean_map_electron"));
-      VarManager::SetCalibrationObject(VarManager::kTPCElectronSigma, calibList->FindObject("sigma_map_electron"));
-      VarManager::SetCalibrationObject(VarManager::kTPCPionMean, calibList->FindObject("mean_map_pion"));
-      VarManager::SetCalibrationObject(VarManager::kTPCPionSigma, calibList->FindObject("sigma_map_pion"));
-      VarManager::SetCalibrationObject(VarManager::kTPCProtonMean, calibList->FindObject("mean_map_proton"));
-      VarManager::SetCalibrationObject(VarManager::kTPCProtonSigma, calibList->FindObject("sigma_map_proton"));
+    if ((fConfigComputeTPCpostCalib || fPropMuon) && fCurrentRun != bc.runNumber()) {
+      if (fConfigComputeTPCpostCalib) {
+        auto calibList = fCCDB->getForTimeStamp<TList>(fConfigCcdbPathTPC.value, bc.timestamp());
+        VarManager::SetCalibrationObject(VarManager::kTPCElectronMean, calibList->FindObject("mean_map_electron"));
+        VarManager::SetCalibrationObject(VarManager::kTPCElectronSigma, calibList->FindObject("sigma_map_electron"));
+        VarManager::SetCalibrationObject(VarManager::kTPCPionMean, calibList->FindObject("mean_map_pion"));
+        VarManager::SetCalibrationObject(VarManager::kTPCPionSigma, calibList->FindObject("sigma_map_pion"));
+        VarManager::SetCalibrationObject(VarManager::kTPCProtonMean, calibList->FindObject("mean_map_proton"));
+        VarManager::SetCalibrationObject(VarManager::kTPCProtonSigma, calibList->FindObject("sigma_map_proton"));
+      }
+      if (fPropMuon) {
+        grpmag = fCCDB->getForTimeStamp<o2::parameters::GRPMagField>(grpmagPath, bc.timestamp());
+        if (grpmag != nullptr) {
+          o2::base::Propagator::initFieldFromGRP(grpmag);
+        }
+        VarManager::SetupMuonMagField();
+      }
       fCurrentRun = bc.runNumber();
     }
 
@@ -896,8 +924,8 @@ struct TableMaker {
         trackFilteringTag |= (uint64_t(trackTempFilterMap) << 15); // BIT15-...:  user track filters
 
         // create the track tables
-        trackBasic(event.lastIndex(), trackFilteringTag, track.pt(), track.eta(), track.phi(), track.sign(), isAmbiguous);
-        trackBarrel(track.tpcInnerParam(), track.flags(), track.itsClusterMap(), track.itsChi2NCl(),
+        trackBasic(event.lastIndex(), trackFilteringTag, truncKine(track.pt()), truncKine(track.eta()), truncKine(track.phi()), track.sign(), isAmbiguous);
+        trackBarrel(truncKine(track.tpcInnerParam()), track.flags(), track.itsClusterMap(), track.itsChi2NCl(),
                     track.tpcNClsFindable(), track.tpcNClsFindableMinusFound(), track.tpcNClsFindableMinusCrossedRows(),
                     track.tpcNClsShared(), track.tpcChi2NCl(),
                     track.trdChi2(), track.trdPattern(), track.tofChi2(),
@@ -916,11 +944,11 @@ struct TableMaker {
           float nSigmaEl = (fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaEl_Corr] : track.tpcNSigmaEl());
           float nSigmaPi = (fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaPi_Corr] : track.tpcNSigmaPi());
           float nSigmaPr = (fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaPr_Corr] : track.tpcNSigmaPr());
-          trackBarrelPID(track.tpcSignal(),
-                         nSigmaEl, track.tpcNSigmaMu(), nSigmaPi, track.tpcNSigmaKa(), nSigmaPr,
-                         track.beta(),
-                         track.tofNSigmaEl(), track.tofNSigmaMu(), track.tofNSigmaPi(), track.tofNSigmaKa(), track.tofNSigmaPr(),
-                         track.trdSignal());
+          trackBarrelPID(truncPID(track.tpcSignal()),
+                         truncPID(nSigmaEl), truncPID(track.tpcNSigmaMu()), truncPID(nSigmaPi), truncPID(track.tpcNSigmaKa()), truncPID(nSigmaPr),
+                         truncPID(track.beta()),
+                         truncPID(track.tofNSigmaEl()), truncPID(track.tofNSigmaMu()), truncPID(track.tofNSigmaPi()), truncPID(track.tofNSigmaKa()), truncPID(track.tofNSigmaPr()),
+                         truncPID(track.trdSignal()));
         }
       }
     } // end if constexpr (TTrackFillMap)
@@ -1026,7 +1054,7 @@ struct TableMaker {
           }
         }
 
-        muonBasic(event.lastIndex(), trackFilteringTag, VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], muon.sign(), isAmbiguous);
+        muonBasic(event.lastIndex(), trackFilteringTag, truncKine(VarManager::fgValues[VarManager::kPt]), truncKine(VarManager::fgValues[VarManager::kEta]), truncKine(VarManager::fgValues[VarManager::kPhi]), muon.sign(), isAmbiguous);
         muonExtra(muon.nClusters(), muon.pDca(), muon.rAtAbsorberEnd(),
                   muon.chi2(), muon.chi2MatchMCHMID(), muon.chi2MatchMCHMFT(),
                   muon.matchScoreMCHMFT(), newMatchIndex.find(muon.index())->second, -1, muon.mchBitMap(), muon.midBitMap(),
@@ -30,6 +30,7 @@
 #include "PWGDQ/Core/HistogramsLibrary.h"
 #include "PWGDQ/Core/CutsLibrary.h"
 #include "PWGDQ/Core/MCSignal.h"
+#include "PWGDQ/Core/MCSignalMatcher.h"
 #include "PWGDQ/Core/MCSignalLibrary.h"
 #include "CCDB/BasicCCDBManager.h"
 #include "DataFormatsParameters/GRPMagField.h"
@@ -164,6 +165,7 @@ struct AnalysisTrackSelection {
   HistogramManager* fHistMan;
   std::vector<AnalysisCompositeCut> fTrackCuts;
   std::vector<MCSignal> fMCSignals; // list of signals to be checked
+  MCSignalMatcher fMCSignalMatcher; // checks all the signals in one pass over the particle history
   std::vector<TString> fHistNamesReco;
   std::vector<std::vector<TString>> fHistNamesMCMatched;
 
@@ -192,6 +194,9 @@ struct AnalysisTrackSelection {
         fMCSignals.push_back(*sig);
       }
     }
+    for (auto& sig : fMCSignals) {
+      fMCSignalMatcher.AddSignal(&sig);
+    }
 
     // Configure histogram classes for each track cut;
     // Add histogram classes for each track cut and for each requested MC signal (reconstructed tracks with MC truth)
@@ -273,18 +278,11 @@ struct AnalysisTrackSelection {
 
       // compute MC matching decisions
       uint32_t mcDecision = 0;
-      int isig = 0;
-      for (auto sig = fMCSignals.begin(); sig != fMCSignals.end(); sig++, isig++) {
-        if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedTrack) > 0) {
-          if ((*sig).CheckSignal(false, track.reducedMCTrack())) {
-            mcDecision |= (uint32_t(1) << isig);
-          }
-        }
-        if constexpr ((TTrackFillMap & VarManager::ObjTypes::Track) > 0) {
-          if ((*sig).CheckSignal(false, track.template mcParticle_as<aod::McParticles_001>())) {
-            mcDecision |= (uint32_t(1) << isig);
-          }
-        }
+      if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedTrack) > 0) {
+        mcDecision = fMCSignalMatcher.Match(false, track.reducedMCTrack());
+      }
+      if constexpr ((TTrackFillMap & VarManager::ObjTypes::Track) > 0) {
+        mcDecision = fMCSignalMatcher.Match(false, track.template mcParticle_as<aod::McParticles_001>());
       }
 
       // fill histograms
@@ -324,6 +322,7 @@ struct AnalysisMuonSelection {
   HistogramManager* fHistMan;
   std::vector<AnalysisCompositeCut> fTrackCuts;
   std::vector<MCSignal> fMCSignals; // list of signals to be checked
+  MCSignalMatcher fMCSignalMatcher; // checks all the signals in one pass over the particle history
   std::vector<TString> fHistNamesReco;
   std::vector<std::vector<TString>> fHistNamesMCMatched;
 
@@ -352,6 +351,9 @@ struct AnalysisMuonSelection {
         fMCSignals.push_back(*sig);
       }
     }
+    for (auto& sig : fMCSignals) {
+      fMCSignalMatcher.AddSignal(&sig);
+    }
 
     // Configure histogram classes for each track cut;
     // Add histogram classes for each track cut and for each requested MC signal (reconstructed tracks with MC truth)
@@ -437,18 +439,11 @@ struct AnalysisMuonSelection {
 
       // compute MC matching decisions
       uint32_t mcDecision = 0;
-      int isig = 0;
-      for (auto sig = fMCSignals.begin(); sig != fMCSignals.end(); sig++, isig++) {
-        if constexpr ((TMuonFillMap & VarManager::ObjTypes::ReducedMuon) > 0) {
-          if ((*sig).CheckSignal(false, muon.reducedMCTrack())) {
-            mcDecision |= (uint32_t(1) << isig);
-          }
-        }
-        if constexpr ((TMuonFillMap & VarManager::ObjTypes::Muon) > 0) {
-          if ((*sig).CheckSignal(false, muon.template mcParticle_as<aod::McParticles_001>())) {
-            mcDecision |= (uint32_t(1) << isig);
-          }
-        }
+      if constexpr ((TMuonFillMap & VarManager::ObjTypes::ReducedMuon) > 0) {
+        mcDecision = fMCSignalMatcher.Match(false, muon.reducedMCTrack());
+      }
+      if constexpr ((TMuonFillMap & VarManager::ObjTypes::Muon) > 0) {
+        mcDecision = fMCSignalMatcher.Match(false, muon.template mcParticle_as<aod::McParticles_001>());
       }
 
       // fill histograms
@@ -504,6 +499,7 @@ struct AnalysisSameEventPairing {
   Configurable<std::string> grpmagPath{"grpmagPath", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object"};
   Configurable<bool> fUseAbsDCA{"cfgUseAbsDCA", false, "Use absolute DCA minimization instead of chi^2 minimization in secondary vertexing"};
   Configurable<bool> fPropToPCA{"cfgPropToPCA", false, "Propagate tracks to secondary vertex"};
+  Configurable<bool> fConfigUseTrackParCache{"cfgUseTrackParCache", true, "Build the track parametrizations used in the vertexing once per track and event"};
   Configurable<bool> fCorrFullGeo{"cfgCorrFullGeo", false, "Use full geometry to correct for MCS effects in track propagation"};
   Configurable<bool> fNoCorr{"cfgNoCorrFwdProp", false, "Do not correct for MCS effects in track propagation"};
   Configurable<std::string> lutPath{"lutPath", "GLO/Param/MatLUT", "Path of the Lut parametrization"};
@@ -523,10 +519,12 @@ struct AnalysisSameEventPairing {
   std::vector<std::vector<TString>> fBarrelMuonHistNamesMCmatched;
   std::vector<MCSignal> fRecMCSignals;
   std::vector<MCSignal> fGenMCSignals;
+  MCSignalMatcher fRecMCSignalMatcher; // checks all the reconstructed signals in one pass over the particle history
 
   void init(o2::framework::InitContext& context)
   {
     fCurrentRun = 0;
+    VarManager::SetUseTrackParCache(fConfigUseTrackParCache.value);
 
     ccdb->setURL(ccdburl.value);
     ccdb->setCaching(true);
@@ -676,6 +674,9 @@ struct AnalysisSameEventPairing {
         }
       }
     }
+    for (auto& sig : fRecMCSignals) {
+      fRecMCSignalMatcher.AddSignal(&sig);
+    }
 
     DefineHistograms(fHistMan, histNames.Data());    // define all histograms
     VarManager::SetUseVars(fHistMan->GetUsedVars()); // provide the list of required variables so that VarManager knows what to fill
@@ -709,6 +710,7 @@ struct AnalysisSameEventPairing {
       }
       fCurrentRun = event.runNumber();
     }
+    VarManager::ResetTrackParCache(); // the cached track parametrizations are valid only within the event
 
     // establish the right histogram classes to be filled depending on TPairType (ee,mumu,emu)
     unsigned int ncuts = fBarrelHistNames.size();
@@ -756,19 +758,12 @@ struct AnalysisSameEventPairing {
 
       // run MC matching for this pair
       uint32_t mcDecision = 0;
-      int isig = 0;
-      for (auto sig = fRecMCSignals.begin(); sig != fRecMCSignals.end(); sig++, isig++) {
-        if constexpr (TTrackFillMap & VarManager::ObjTypes::ReducedTrack || TTrackFillMap & VarManager::ObjTypes::ReducedMuon) { // for skimmed DQ model
-          if ((*sig).CheckSignal(false, t1.reducedMCTrack(), t2.reducedMCTrack())) {
-            mcDecision |= (uint32_t(1) << isig);
-          }
-        }
-        if constexpr (TTrackFillMap & VarManager::ObjTypes::Track || TTrackFillMap & VarManager::ObjTypes::Muon) { // for Framework data model
-          if ((*sig).CheckSignal(false, t1.template mcParticle_as<aod::McParticles_001>(), t2.template mcParticle_as<aod::McParticles_001>())) {
-            mcDecision |= (uint32_t(1) << isig);
-          }
-        }
-      } // end loop over MC signals
+      if constexpr (TTrackFillMap & VarManager::ObjTypes::ReducedTrack || TTrackFillMap & VarManager::ObjTypes::ReducedMuon) { // for skimmed DQ model
+        mcDecision = fRecMCSignalMatcher.Match(false, t1.reducedMCTrack(), t2.reducedMCTrack());
+      }
+      if constexpr (TTrackFillMap & VarManager::ObjTypes::Track || TTrackFillMap & VarManager::ObjTypes::Muon) { // for Framework data model
+        mcDecision = fRecMCSignalMatcher.Match(false, t1.template mcParticle_as<aod::McParticles_001>(), t2.template mcParticle_as<aod::McParticles_001>());
+      }
 
       dileptonFilterMap = twoTrackFilter;
       dileptonMcDecision = mcDecision;
@@ -973,6 +968,7 @@ struct AnalysisDileptonTrack {
 
   Configurable<std::string> fConfigMCRecSignals{"cfgBarrelMCRecSignals", "", "Comma separated list of MC signals (reconstructed)"};
   Configurable<std::string> fConfigMCGenSignals{"cfgBarrelMCGenSignals", "", "Comma separated list of MC signals (generated)"};
+  Configurable<bool> fConfigUseTrackParCache{"cfgUseTrackParCache", true, "Build the track parametrizations used in the vertexing once per track and event"};
 
   constexpr static uint32_t fgDileptonFillMap = VarManager::ObjTypes::ReducedTrack | VarManager::ObjTypes::Pair; // fill map
 
@@ -995,6 +991,7 @@ struct AnalysisDileptonTrack {
 
   void init(o2::framework::InitContext& context)
   {
+    VarManager::SetUseTrackParCache(fConfigUseTrackParCache.value);
     TString sigNamesStr = fConfigMCRecSignals.value;
     std::unique_ptr<TObjArray> objRecSigArray(sigNamesStr.Tokenize(","));
     TString histNames;
@@ -1073,6 +1070,7 @@ struct AnalysisDileptonTrack {
   template <int TCandidateType, uint32_t TEventFillMap, uint32_t TEventMCFillMap, uint32_t TTrackFillMap, typename TEvent, typename TTracks, typename TEventsMC, typename TTracksMC>
   void runDileptonTrack(TEvent const& event, TTracks const& tracks, soa::Join<aod::Dileptons, aod::DileptonsExtra> const& dileptons, TEventsMC const& eventsMC, TTracksMC const& tracksMC)
   {
+    VarManager::ResetTrackParCache(); // the cached track parametrizations are valid only within the event
     VarManager::ResetValues(0, VarManager::kNVars, fValuesTrack);
     VarManager::ResetValues(0, VarManager::kNVars, fValuesDilepton);
     VarManager::FillEvent<TEventFillMap>(event, fValuesTrack);
@@ -15,7 +15,10 @@
 #include <vector>
 #include <memory>
 #include <cstring>
+#include <chrono>
+#include <bit>
 #include <TH1F.h>
+#include <TH1D.h>
 #include <TH2I.h>
 #include <THashList.h>
 #include <TString.h>
@@ -377,11 +380,14 @@ struct DQFilterPPTask {
   Produces<aod::DqFilters> dqtable;
   OutputObj<THashList> fOutputList{"output"};
   OutputObj<TH1I> fStats{"Statistics"};
+  OutputObj<TH1D> fTriggerTiming{"TriggerTiming"};         // CPU time spent in pairing, per trigger
+  OutputObj<TH1I> fTriggerCandidates{"TriggerCandidates"}; // events in which each trigger was not ruled out before pairing
   HistogramManager* fHistMan;
 
   Configurable<std::string> fConfigBarrelSelections{"cfgBarrelSels", "jpsiPID1:pairMassLow:1", "<track-cut>:[<pair-cut>]:<n>,[<track-cut>:[<pair-cut>]:<n>],..."};
   Configurable<std::string> fConfigMuonSelections{"cfgMuonSels", "muonQualityCuts:pairNoCut:1", "<muon-cut>:[<pair-cut>]:<n>"};
   Configurable<bool> fConfigQA{"cfgWithQA", false, "If true, fill QA histograms"};
+  Configurable<bool> fConfigEarlyExit{"cfgEarlyExit", false, "If true, skip the event quantities and pairing which cannot change the trigger decisions (ignored if cfgWithQA is true)"};
 
   Filter filterBarrelTrackSelected = aod::dqppfilter::isDQBarrelSelected > uint32_t(0);
   Filter filterMuonTrackSelected = aod::dqppfilter::isDQMuonSelected > uint32_t(0);
@@ -459,6 +465,18 @@ struct DQFilterPPTask {
         fStats->GetXaxis()->SetBinLabel(ib, objArray2->At(ib - 3 - fNBarrelCuts)->GetName());
       }
     }
+
+    // setup the per-trigger CPU time and candidate counters
+    fTriggerTiming.setObject(new TH1D("TriggerTiming", "CPU time spent in pairing per DQ trigger (#mus)", fNBarrelCuts + fNMuonCuts, -0.5, -0.5 + fNBarrelCuts + fNMuonCuts));
+    fTriggerCandidates.setObject(new TH1I("TriggerCandidates", "Events in which the DQ triggers were not ruled out before pairing", fNBarrelCuts + fNMuonCuts, -0.5, -0.5 + fNBarrelCuts + fNMuonCuts));
+    for (int ib = 1; ib <= fNBarrelCuts; ib++) {
+      fTriggerTiming->GetXaxis()->SetBinLabel(ib, objArray->At(ib - 1)->GetName());
+      fTriggerCandidates->GetXaxis()->SetBinLabel(ib, objArray->At(ib - 1)->GetName());
+    }
+    for (int ib = 1 + fNBarrelCuts; ib <= fNBarrelCuts + fNMuonCuts; ib++) {
+      fTriggerTiming->GetXaxis()->SetBinLabel(ib, objArray2->At(ib - 1 - fNBarrelCuts)->GetName());
+      fTriggerCandidates->GetXaxis()->SetBinLabel(ib, objArray2->At(ib - 1 - fNBarrelCuts)->GetName());
+    }
   }
 
   void init(o2::framework::InitContext&)
@@ -486,6 +504,18 @@ struct DQFilterPPTask {
     }
   }
 
+  // distribute the CPU time spent in a pairing loop among the selections which required it
+  void fillTriggerTiming(uint32_t pairingMask, int offset, std::chrono::steady_clock::time_point start)
+  {
+    double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    int nActive = std::popcount(pairingMask);
+    for (int i = 0; i < 32; i++) {
+      if (pairingMask & (uint32_t(1) << i)) {
+        fTriggerTiming->Fill(static_cast<float>(i + offset), elapsed / nActive);
+      }
+    }
+  }
+
   template <uint32_t TEventFillMap, uint32_t TTrackFillMap, uint32_t TMuonFillMap, typename TEvent, typename TTracks, typename TMuons>
   void runFilterPP(TEvent const& collision, aod::BCs const& bcs, TTracks const& tracksBarrel, TMuons const& muons)
   {
@@ -504,34 +534,89 @@ struct DQFilterPPTask {
       return;
     }
 
-    // Reset the values array and compute event quantities
-    VarManager::ResetValues(0, VarManager::kNVars);
-    VarManager::FillEvent<TEventFillMap>(collision);
+    // NOTE: In the early-exit mode, the event quantities and the pairing are computed only if some trigger can still fire
+    //       This does not change the decisions, but the QA histograms would be incomplete, so it is disabled with QA
+    const bool earlyExit = fConfigEarlyExit && !fConfigQA;
+    if (!earlyExit) {
+      // Reset the values array and compute event quantities
+      VarManager::ResetValues(0, VarManager::kNVars);
+      VarManager::FillEvent<TEventFillMap>(collision);
+    }
 
     std::vector<int> objCountersBarrel(fNBarrelCuts, 0); // init all counters to zero
+    std::vector<int> posCountersBarrel(fNBarrelCuts, 0); // number of positive tracks, used to bound the number of opposite-sign pairs
     // count the number of barrel tracks fulfilling each cut
     for (auto track : tracksBarrel) {
       for (int i = 0; i < fNBarrelCuts; ++i) {
         if (track.isDQBarrelSelected() & (uint32_t(1) << i)) {
           objCountersBarrel[i] += 1;
+          if (track.sign() > 0) {
+            posCountersBarrel[i] += 1;
+          }
         }
       }
     }
 
     // check which selections require pairing
-    uint32_t pairingMask = 0; // in order to know which of the selections actually require pairing
+    uint32_t pairingMaskBarrel = 0; // in order to know which of the selections actually require pairing
     for (int i = 0; i < fNBarrelCuts; i++) {
       if (fBarrelRunPairing[i]) {
         if (objCountersBarrel[i] > 1) { // pairing has to be enabled and at least two tracks are needed
-          pairingMask |= (uint32_t(1) << i);
+          // in the early-exit mode, skip also the selections which cannot reach the required number of opposite-sign pairs
+          int64_t maxPairs = int64_t(posCountersBarrel[i]) * (objCountersBarrel[i] - posCountersBarrel[i]);
+          if (!earlyExit || maxPairs >= fBarrelNreqObjs[i]) {
+            pairingMaskBarrel |= (uint32_t(1) << i);
+            fTriggerCandidates->Fill(static_cast<float>(i));
+          }
         }
         objCountersBarrel[i] = 0; // reset counters for selections where pairing is needed (count pairs instead)
+      } else if (objCountersBarrel[i] >= fBarrelNreqObjs[i]) {
+        fTriggerCandidates->Fill(static_cast<float>(i));
+      }
+    }
+
+    std::vector<int> objCountersMuon(fNMuonCuts, 0); // init all counters to zero
+    std::vector<int> posCountersMuon(fNMuonCuts, 0); // number of positive muons, used to bound the number of opposite-sign pairs
+    // count the number of muon tracks fulfilling each selection
+    for (auto muon : muons) {
+      for (int i = 0; i < fNMuonCuts; ++i) {
+        if (muon.isDQMuonSelected() & (uint32_t(1) << i)) {
+          objCountersMuon[i] += 1;
+          if (muon.sign() > 0) {
+            posCountersMuon[i] += 1;
+          }
+        }
       }
     }
 
+    // check which muon selections require pairing
+    uint32_t pairingMaskMuon = 0;
+    for (int i = 0; i < fNMuonCuts; i++) {
+      if (fMuonRunPairing[i]) { // pairing has to be enabled and at least two tracks are needed
+        if (objCountersMuon[i] > 1) {
+          int64_t maxPairs = int64_t(posCountersMuon[i]) * (objCountersMuon[i] - posCountersMuon[i]);
+          if (!earlyExit || maxPairs >= fMuonNreqObjs[i]) {
+            pairingMaskMuon |= (uint32_t(1) << i);
+            fTriggerCandidates->Fill(static_cast<float>(i + fNBarrelCuts));
+          }
+        }
+        objCountersMuon[i] = 0; // reset counters for selections where pairing is needed (count pairs instead)
+      } else if (objCountersMuon[i] >= fMuonNreqObjs[i]) {
+        fTriggerCandidates->Fill(static_cast<float>(i + fNBarrelCuts));
+      }
+    }
+
+    if (earlyExit && (pairingMaskBarrel > 0 || pairingMaskMuon > 0)) {
+      // Reset the values array and compute event quantities, needed by the pair cuts
+      VarManager::ResetValues(0, VarManager::kNVars);
+      VarManager::FillEvent<TEventFillMap>(collision);
+    }
+
     // run pairing if there is at least one selection that requires it
+    uint32_t pairingMask = pairingMaskBarrel;
     uint32_t pairFilter = 0;
     if (pairingMask > 0) {
+      auto start = std::chrono::steady_clock::now();
       for (auto& [t1, t2] : combinations(tracksBarrel, tracksBarrel)) {
         // keep just opposite-sign pairs
         if (t1.sign() * t2.sign() > 0) {
@@ -555,34 +640,22 @@ struct DQFilterPPTask {
           if (fConfigQA) {              // fill histograms if QA is enabled
             fHistMan->FillHistClass(fBarrelPairHistNames[icut].Data(), VarManager::fgValues);
           }
+          if (earlyExit && objCountersBarrel[icut] >= fBarrelNreqObjs[icut]) {
+            pairingMask &= ~(uint32_t(1) << icut); // the decision for this selection is taken
+          }
         }
-      }
-    }
-
-    std::vector<int> objCountersMuon(fNMuonCuts, 0); // init all counters to zero
-    // count the number of muon tracks fulfilling each selection
-    for (auto muon : muons) {
-      for (int i = 0; i < fNMuonCuts; ++i) {
-        if (muon.isDQMuonSelected() & (uint32_t(1) << i)) {
-          objCountersMuon[i] += 1;
-        }
-      }
-    }
-
-    // check which muon selections require pairing
-    pairingMask = 0; // reset the mask for the muons
-    for (int i = 0; i < fNMuonCuts; i++) {
-      if (fMuonRunPairing[i]) { // pairing has to be enabled and at least two tracks are needed
-        if (objCountersMuon[i] > 1) {
-          pairingMask |= (uint32_t(1) << i);
+        if (pairingMask == 0) {
+          break;
         }
-        objCountersMuon[i] = 0; // reset counters for selections where pairing is needed (count pairs instead)
       }
+      fillTriggerTiming(pairingMaskBarrel, 0, start);
     }
 
     // run pairing if there is at least one selection that requires it
+    pairingMask = pairingMaskMuon;
     pairFilter = 0;
     if (pairingMask > 0) {
+      auto start = std::chrono::steady_clock::now();
       for (auto& [t1, t2] : combinations(muons, muons)) {
         // keep just opposite-sign pairs
         if (t1.sign() * t2.sign() > 0) {
@@ -606,8 +679,15 @@ struct DQFilterPPTask {
           if (fConfigQA) {
             fHistMan->FillHistClass(fMuonPairHistNames[icut].Data(), VarManager::fgValues);
           }
+          if (earlyExit && objCountersMuon[icut] >= fMuonNreqObjs[icut]) {
+            pairingMask &= ~(uint32_t(1) << icut); // the decision for this selection is taken
+          }
+        }
+        if (pairingMask == 0) {
+          break;
         }
       }
+      fillTriggerTiming(pairingMaskMuon, fNBarrelCuts, start);
     }
 
     // compute the decisions and publish
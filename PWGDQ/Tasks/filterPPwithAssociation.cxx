@@ -15,7 +15,10 @@
 #include <vector>
 #include <memory>
 #include <cstring>
+#include <chrono>
+#include <bit>
 #include <TH1F.h>
+#include <TH1D.h>
 #include <TH2I.h>
 #include <THashList.h>
 #include <TString.h>
@@ -984,11 +987,14 @@ struct DQFilterPPTask {
   Produces<aod::DqFilters> dqtable;
   OutputObj<THashList> fOutputList{"output"};
   OutputObj<TH1I> fStats{"Statistics"};
+  OutputObj<TH1D> fTriggerTiming{"TriggerTiming"};         // CPU time spent in pairing, per trigger
+  OutputObj<TH1I> fTriggerCandidates{"TriggerCandidates"}; // events in which each trigger was not ruled out before pairing
   HistogramManager* fHistMan;
 
   Configurable<std::string> fConfigBarrelSelections{"cfgBarrelSels", "jpsiPID1:pairMassLow:1", "<track-cut>:[<pair-cut>]:<n>,[<track-cut>:[<pair-cut>]:<n>],..."};
   Configurable<std::string> fConfigMuonSelections{"cfgMuonSels", "muonQualityCuts:pairNoCut:1", "<muon-cut>:[<pair-cut>]:<n>"};
   Configurable<bool> fConfigQA{"cfgWithQA", false, "If true, fill QA histograms"};
+  Configurable<bool> fConfigEarlyExit{"cfgEarlyExit", false, "If true, skip the event quantities and pairing which cannot change the trigger decisions (ignored if cfgWithQA is true)"};
   Configurable<bool> fConfigFilterLsBarrelTracksPairs{"cfgWithBarrelLS", false, "If true, also select like sign (--/++) barrel track pairs"};
   Configurable<bool> fConfigFilterLsMuonsPairs{"cfgWithMuonLS", false, "If true, also select like sign (--/++) muon pairs"};
 
@@ -1068,6 +1074,18 @@ struct DQFilterPPTask {
         fStats->GetXaxis()->SetBinLabel(ib, objArray2->At(ib - 3 - fNBarrelCuts)->GetName());
       }
     }
+
+    // setup the per-trigger CPU time and candidate counters
+    fTriggerTiming.setObject(new TH1D("TriggerTiming", "CPU time spent in pairing per DQ trigger (#mus)", fNBarrelCuts + fNMuonCuts, -0.5, -0.5 + fNBarrelCuts + fNMuonCuts));
+    fTriggerCandidates.setObject(new TH1I("TriggerCandidates", "Events in which the DQ triggers were not ruled out before pairing", fNBarrelCuts + fNMuonCuts, -0.5, -0.5 + fNBarrelCuts + fNMuonCuts));
+    for (int ib = 1; ib <= fNBarrelCuts; ib++) {
+      fTriggerTiming->GetXaxis()->SetBinLabel(ib, objArray->At(ib - 1)->GetName());
+      fTriggerCandidates->GetXaxis()->SetBinLabel(ib, objArray->At(ib - 1)->GetName());
+    }
+    for (int ib = 1 + fNBarrelCuts; ib <= fNBarrelCuts + fNMuonCuts; ib++) {
+      fTriggerTiming->GetXaxis()->SetBinLabel(ib, objArray2->At(ib - 1 - fNBarrelCuts)->GetName());
+      fTriggerCandidates->GetXaxis()->SetBinLabel(ib, objArray2->At(ib - 1 - fNBarrelCuts)->GetName());
+    }
   }
 
   void init(o2::framework::InitContext&)
@@ -1095,6 +1113,18 @@ struct DQFilterPPTask {
     }
   }
 
+  // distribute the CPU time spent in a pairing loop among the selections which required it
+  void fillTriggerTiming(uint32_t pairingMask, int offset, std::chrono::steady_clock::time_point start)
+  {
+    double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    int nActive = std::popcount(pairingMask);
+    for (int i = 0; i < 32; i++) {
+      if (pairingMask & (uint32_t(1) << i)) {
+        fTriggerTiming->Fill(static_cast<float>(i + offset), elapsed / nActive);
+      }
+    }
+  }
+
   template <uint32_t TEventFillMap, uint32_t TTrackFillMap, uint32_t TMuonFillMap, typename TEvent, typename TTracks, typename TMuons>
   uint64_t runFilterPP(TEvent const& collision,
                        aod::BCs const& bcs,
@@ -1102,9 +1132,16 @@ struct DQFilterPPTask {
                        TMuons const& muons,
                        DQTrackAssoc const& barrelAssocs, DQMuonAssoc const& muonAssocs)
   {
-    // Reset the values array and compute event quantities
-    VarManager::ResetValues(0, VarManager::kNVars);
-    VarManager::FillEvent<TEventFillMap>(collision); // event properties could be needed for cuts or histogramming
+    // NOTE: In the early-exit mode, the event quantities and the pairing are computed only if some trigger can still fire
+    //       This does not change the decisions, but the QA histograms would be incomplete, so it is disabled with QA
+    const bool earlyExit = fConfigEarlyExit && !fConfigQA;
+    bool eventFilled = false;
+    if (!earlyExit) {
+      // Reset the values array and compute event quantities
+      VarManager::ResetValues(0, VarManager::kNVars);
+      VarManager::FillEvent<TEventFillMap>(collision); // event properties could be needed for cuts or histogramming
+      eventFilled = true;
+    }
 
     std::vector<int> objCountersBarrel(fNBarrelCuts, 0); // init all counters to zero
     // count the number of barrel tracks fulfilling each cut
@@ -1121,15 +1158,30 @@ struct DQFilterPPTask {
     for (int i = 0; i < fNBarrelCuts; i++) {
       if (fBarrelRunPairing[i]) {
         if (objCountersBarrel[i] > 1) { // pairing has to be enabled and at least two tracks are needed
-          pairingMask |= (uint32_t(1) << i);
+          // in the early-exit mode, skip also the selections which cannot reach the required number of pairs
+          int64_t maxPairs = int64_t(objCountersBarrel[i]) * (objCountersBarrel[i] - 1) / 2;
+          if (!earlyExit || maxPairs >= fBarrelNreqObjs[i]) {
+            pairingMask |= (uint32_t(1) << i);
+            fTriggerCandidates->Fill(static_cast<float>(i));
+          }
         }
         objCountersBarrel[i] = 0; // reset counters for selections where pairing is needed (count pairs instead)
+      } else if (objCountersBarrel[i] >= fBarrelNreqObjs[i]) {
+        fTriggerCandidates->Fill(static_cast<float>(i));
       }
     }
 
     // run pairing if there is at least one selection that requires it
     uint32_t pairFilter = 0;
     if (pairingMask > 0) {
+      if (!eventFilled) {
+        // Reset the values array and compute event quantities, needed by the pair cuts
+        VarManager::ResetValues(0, VarManager::kNVars);
+        VarManager::FillEvent<TEventFillMap>(collision);
+        eventFilled = true;
+      }
+      const uint32_t pairingMaskBarrel = pairingMask;
+      auto start = std::chrono::steady_clock::now();
       // run pairing on the collision grouped associations
       for (auto& [a1, a2] : combinations(barrelAssocs, barrelAssocs)) {
         // check the pairing mask and that the tracks share a cut bit
@@ -1161,8 +1213,15 @@ struct DQFilterPPTask {
           if (fConfigQA) {              // fill histograms if QA is enabled
             fHistMan->FillHistClass(fBarrelPairHistNames[icut].Data(), VarManager::fgValues);
           }
+          if (earlyExit && objCountersBarrel[icut] >= fBarrelNreqObjs[icut]) {
+            pairingMask &= ~(uint32_t(1) << icut); // the decision for this selection is taken
+          }
+        }
+        if (pairingMask == 0) {
+          break;
         }
       }
+      fillTriggerTiming(pairingMaskBarrel, 0, start);
     }
 
     std::vector<int> objCountersMuon(fNMuonCuts, 0); // init all counters to zero
@@ -1180,15 +1239,29 @@ struct DQFilterPPTask {
     for (int i = 0; i < fNMuonCuts; i++) {
       if (fMuonRunPairing[i]) { // pairing has to be enabled and at least two tracks are needed
         if (objCountersMuon[i] > 1) {
-          pairingMask |= (uint32_t(1) << i);
+          int64_t maxPairs = int64_t(objCountersMuon[i]) * (objCountersMuon[i] - 1) / 2;
+          if (!earlyExit || maxPairs >= fMuonNreqObjs[i]) {
+            pairingMask |= (uint32_t(1) << i);
+            fTriggerCandidates->Fill(static_cast<float>(i + fNBarrelCuts));
+          }
         }
         objCountersMuon[i] = 0; // reset counters for selections where pairing is needed (count pairs instead)
+      } else if (objCountersMuon[i] >= fMuonNreqObjs[i]) {
+        fTriggerCandidates->Fill(static_cast<float>(i + fNBarrelCuts));
       }
     }
 
     // run pairing if there is at least one selection that requires it
     pairFilter = 0;
     if (pairingMask > 0) {
+      if (!eventFilled) {
+        // Reset the values array and compute event quantities, needed by the pair cuts
+        VarManager::ResetValues(0, VarManager::kNVars);
+        VarManager::FillEvent<TEventFillMap>(collision);
+        eventFilled = true;
+      }
+      const uint32_t pairingMaskMuon = pairingMask;
+      auto start = std::chrono::steady_clock::now();
       // pairing is done using the collision grouped muon associations
       for (auto& [a1, a2] : combinations(muonAssocs, muonAssocs)) {
 
@@ -1221,8 +1294,15 @@ struct DQFilterPPTask {
           if (fConfigQA) {
             fHistMan->FillHistClass(fMuonPairHistNames[icut].Data(), VarManager::fgValues);
           }
+          if (earlyExit && objCountersMuon[icut] >= fMuonNreqObjs[icut]) {
+            pairingMask &= ~(uint32_t(1) << icut); // the decision for this selection is taken
+          }
+        }
+        if (pairingMask == 0) {
+          break;
         }
       }
+      fillTriggerTiming(pairingMaskMuon, fNBarrelCuts, start);
     }
 
     // compute the decisions and publish
@@ -12,6 +12,7 @@
 // Contact: iarsene@cern.ch, i.c.arsene@fys.uio.no
 //
 #include <iostream>
+#include <map>
 #include <vector>
 #include <algorithm>
 #include <TH1F.h>
@@ -29,11 +30,14 @@
 #include "PWGDQ/Core/VarManager.h"
 #include "PWGDQ/Core/HistogramManager.h"
 #include "PWGDQ/Core/MixingHandler.h"
+#include "PWGDQ/Core/MixingPool.h"
 #include "PWGDQ/Core/AnalysisCut.h"
 #include "PWGDQ/Core/AnalysisCompositeCut.h"
+#include "PWGDQ/Core/AnalysisCutEvaluator.h"
 #include "PWGDQ/Core/HistogramsLibrary.h"
 #include "PWGDQ/Core/CutsLibrary.h"
 #include "PWGDQ/Core/MixingLibrary.h"
+#include "Common/Core/ProcessTimer.h"
 #include "DataFormatsParameters/GRPMagField.h"
 #include "Field/MagneticField.h"
 #include "TGeoGlobalMagField.h"
@@ -232,6 +236,8 @@ struct AnalysisTrackSelection {
 
   HistogramManager* fHistMan;
   std::vector<AnalysisCompositeCut> fTrackCuts;
+  AnalysisCutEvaluator fTrackCutsEvaluator; // flattened fTrackCuts, returning the map of passed cuts
+  std::vector<int> fHistClassHandles;       // QA histogram class handles: before cuts, then one for each cut
 
   int fCurrentRun; // needed to detect if the run changed and trigger update of calibrations etc.
 
@@ -244,6 +250,7 @@ struct AnalysisTrackSelection {
       std::unique_ptr<TObjArray> objArray(cutNamesStr.Tokenize(","));
       for (int icut = 0; icut < objArray->GetEntries(); ++icut) {
         fTrackCuts.push_back(*dqcuts::GetCompositeCut(objArray->At(icut)->GetName()));
+        fTrackCutsEvaluator.AddCut(fTrackCuts.back());
       }
     }
 
@@ -265,6 +272,12 @@ struct AnalysisTrackSelection {
       DefineHistograms(fHistMan, histDirNames.Data(), fConfigAddTrackHistogram); // define all histograms
       VarManager::SetUseVars(fHistMan->GetUsedVars());                           // provide the list of required variables so that VarManager knows what to fill
       fOutputList.setObject(fHistMan->GetMainHistogramList());
+
+      // resolve the histogram classes once, to avoid string lookups in the track loop
+      fHistClassHandles.push_back(fHistMan->GetHistClassHandle("TrackBarrel_BeforeCuts"));
+      for (auto& cut : fTrackCuts) {
+        fHistClassHandles.push_back(fHistMan->GetHistClassHandle(Form("TrackBarrel_%s", cut.GetName())));
+      }
     }
     if (fConfigDummyRunlist) {
       VarManager::SetDummyRunlist(fConfigInitRunNumber);
@@ -313,11 +326,12 @@ struct AnalysisTrackSelection {
       prefilterSelected = false;
       VarManager::FillTrack<TTrackFillMap>(track);
       if (fConfigQA) { // TODO: make this compile time
-        fHistMan->FillHistClass("TrackBarrel_BeforeCuts", VarManager::fgValues);
+        fHistMan->FillHistClass(fHistClassHandles[0], VarManager::fgValues);
       }
+      uint64_t cutMap = fTrackCutsEvaluator.Evaluate(VarManager::fgValues);
       iCut = 0;
       for (auto cut = fTrackCuts.begin(); cut != fTrackCuts.end(); cut++, iCut++) {
-        if ((*cut).IsSelected(VarManager::fgValues)) {
+        if (cutMap & (uint64_t(1) << iCut)) {
           if (iCut != fConfigPrefilterCutId) {
             filterMap |= (uint32_t(1) << iCut);
           }
@@ -325,7 +339,7 @@ struct AnalysisTrackSelection {
             prefilterSelected = true;
           }
           if (fConfigQA) { // TODO: make this compile time
-            fHistMan->FillHistClass(Form("TrackBarrel_%s", (*cut).GetName()), VarManager::fgValues);
+            fHistMan->FillHistClass(fHistClassHandles[iCut + 1], VarManager::fgValues);
           }
         }
       }
@@ -361,6 +375,7 @@ struct AnalysisMuonSelection {
 
   HistogramManager* fHistMan;
   std::vector<AnalysisCompositeCut> fMuonCuts;
+  std::vector<int> fHistClassHandles; // QA histogram class handles: before cuts, then one for each cut
 
   void init(o2::framework::InitContext&)
   {
@@ -388,6 +403,12 @@ struct AnalysisMuonSelection {
       DefineHistograms(fHistMan, histDirNames.Data(), fConfigAddMuonHistogram); // define all histograms
       VarManager::SetUseVars(fHistMan->GetUsedVars());                          // provide the list of required variables so that VarManager knows what to fill
       fOutputList.setObject(fHistMan->GetMainHistogramList());
+
+      // resolve the histogram classes once, to avoid string lookups in the muon loop
+      fHistClassHandles.push_back(fHistMan->GetHistClassHandle("TrackMuon_BeforeCuts"));
+      for (auto& cut : fMuonCuts) {
+        fHistClassHandles.push_back(fHistMan->GetHistClassHandle(Form("TrackMuon_%s", cut.GetName())));
+      }
     }
   }
 
@@ -405,7 +426,7 @@ struct AnalysisMuonSelection {
       filterMap = 0;
       VarManager::FillTrack<TMuonFillMap>(muon);
       if (fConfigQA) { // TODO: make this compile time
-        fHistMan->FillHistClass("TrackMuon_BeforeCuts", VarManager::fgValues);
+        fHistMan->FillHistClass(fHistClassHandles[0], VarManager::fgValues);
       }
 
       iCut = 0;
@@ -413,7 +434,7 @@ struct AnalysisMuonSelection {
         if ((*cut).IsSelected(VarManager::fgValues)) {
           filterMap |= (uint32_t(1) << iCut);
           if (fConfigQA) { // TODO: make this compile time
-            fHistMan->FillHistClass(Form("TrackMuon_%s", (*cut).GetName()), VarManager::fgValues);
+            fHistMan->FillHistClass(fHistClassHandles[iCut + 1], VarManager::fgValues);
           }
         }
       }
@@ -519,6 +540,7 @@ struct AnalysisEventMixing {
   Configurable<string> fConfigMuonCuts{"cfgMuonCuts", "", "Comma separated list of muon cuts"};
   Configurable<int> fConfigMixingDepth{"cfgMixingDepth", 100, "Number of Events stored for event mixing"};
   Configurable<std::string> fConfigAddEventMixingHistogram{"cfgAddEventMixingHistogram", "", "Comma separated list of histograms"};
+  Configurable<bool> fConfigUseMixingPool{"cfgUseMixingPool", false, "If true, barrel-barrel and muon-muon mixing pair each event with the last cfgMixingDepth events of its category, kept in ring-buffer pools"};
 
   Filter filterEventSelected = aod::dqanalysisflags::isEventSelected == 1;
   Filter filterTrackSelected = aod::dqanalysisflags::isBarrelSelected > 0;
@@ -534,8 +556,15 @@ struct AnalysisEventMixing {
 
   NoBinningPolicy<aod::dqanalysisflags::MixingHash> hashBin;
 
+  // ring-buffer pools used with cfgUseMixingPool, filled across the processed time frames
+  MixingPool fBarrelPool;
+  MixingPool fMuonPool;
+
   void init(o2::framework::InitContext& context)
   {
+    fBarrelPool.Init(fConfigMixingDepth.value);
+    fMuonPool.Init(fConfigMixingDepth.value);
+
     VarManager::SetDefaultVarNames();
     fHistMan = new HistogramManager("analysisHistos", "aa", VarManager::kNVars);
     fHistMan->SetUseDefaultVariableNames(kTRUE);
@@ -603,16 +632,8 @@ struct AnalysisEventMixing {
   void runMixedPairing(TTracks1 const& tracks1, TTracks2 const& tracks2)
   {
 
-    unsigned int ncuts = fTrackHistNames.size();
-    std::vector<std::vector<TString>> histNames = fTrackHistNames;
-    if constexpr (TPairType == pairTypeMuMu) {
-      ncuts = fMuonHistNames.size();
-      histNames = fMuonHistNames;
-    }
-    if constexpr (TPairType == pairTypeEMu) {
-      ncuts = fTrackMuonHistNames.size();
-      histNames = fTrackMuonHistNames;
-    }
+    auto const& histNames = (TPairType == pairTypeMuMu ? fMuonHistNames : (TPairType == pairTypeEMu ? fTrackMuonHistNames : fTrackHistNames));
+    unsigned int ncuts = histNames.size();
 
     uint32_t twoTrackFilter = 0;
     for (auto& track1 : tracks1) {
@@ -654,10 +675,85 @@ struct AnalysisEventMixing {
     }       // end for (track1)
   }
 
+  // pairing of the selected legs of the current event with the legs of an event stored in the mixing pool
+  template <int TPairType, typename TTracks, typename F>
+  void runMixedPairingWithPool(MixingPool::Event const& poolEvent, TTracks const& tracks2, F const& legFilter)
+  {
+    auto const& histNames = (TPairType == pairTypeMuMu ? fMuonHistNames : fTrackHistNames);
+    unsigned int ncuts = histNames.size();
+
+    uint32_t twoTrackFilter = 0;
+    for (std::size_t i = 0; i < poolEvent.size(); ++i) {
+      auto track1 = poolEvent.leg(i);
+      for (auto& track2 : tracks2) {
+        twoTrackFilter = poolEvent.filter(i) & legFilter(track2);
+        if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
+          continue;
+        }
+        VarManager::FillPairME<TPairType>(track1, track2);
+
+        constexpr bool eventHasQvector = (VarManager::ObjTypes::ReducedEventQvector > 0);
+        if constexpr (eventHasQvector) {
+          VarManager::FillPairVn<TPairType>(track1, track2);
+        }
+
+        for (unsigned int icut = 0; icut < ncuts; icut++) {
+          if (twoTrackFilter & (uint32_t(1) << icut)) {
+            if (track1.sign() * track2.sign() < 0) {
+              fHistMan->FillHistClass(histNames[icut][0].Data(), VarManager::fgValues);
+            } else {
+              if (track1.sign() > 0) {
+                fHistMan->FillHistClass(histNames[icut][1].Data(), VarManager::fgValues);
+              } else {
+                fHistMan->FillHistClass(histNames[icut][2].Data(), VarManager::fgValues);
+              }
+            }
+          } // end if (filter bits)
+        }   // end for (cuts)
+      }     // end for (track2)
+    }       // end for (track1)
+  }
+
+  // barrel-barrel and muon-muon event mixing using the ring-buffer pools
+  // NOTE: each event is mixed with the last cfgMixingDepth events of the same category, also from previous time frames.
+  //       The event variables are taken from the current event.
+  template <int TPairType, uint32_t TEventFillMap, typename TEvents, typename TTracks>
+  void runSameSideWithPool(TEvents& events, TTracks const& tracks, Preslice<TTracks>& preSlice)
+  {
+    MixingPool& pool = (TPairType == pairTypeMuMu ? fMuonPool : fBarrelPool);
+    auto legFilter = [this](auto const& track) -> uint32_t {
+      if constexpr (TPairType == pairTypeMuMu) {
+        return uint32_t(track.isMuonSelected()) & fTwoMuonFilterMask;
+      } else {
+        return uint32_t(track.isBarrelSelected()) & fTwoTrackFilterMask;
+      }
+    };
+
+    for (auto& event : events) {
+      int category = event.mixingHash();
+      if (category < 0) {
+        continue;
+      }
+      auto tracks2 = tracks.sliceBy(preSlice, event.globalIndex());
+      if (pool.GetNEvents(category) > 0) {
+        VarManager::ResetValues(0, VarManager::kNVars);
+        VarManager::FillEvent<TEventFillMap>(event, VarManager::fgValues);
+        for (int iEvent = 0; iEvent < pool.GetNEvents(category); ++iEvent) {
+          runMixedPairingWithPool<TPairType>(pool.GetEvent(category, iEvent), tracks2, legFilter);
+        }
+      }
+      pool.AddEvent(category, tracks2, legFilter);
+    } // end event loop
+  }
+
   // barrel-barrel and muon-muon event mixing
   template <int TPairType, uint32_t TEventFillMap, typename TEvents, typename TTracks>
   void runSameSide(TEvents& events, TTracks const& tracks, Preslice<TTracks>& preSlice)
   {
+    if (fConfigUseMixingPool) {
+      runSameSideWithPool<TPairType, TEventFillMap>(events, tracks, preSlice);
+      return;
+    }
     events.bindExternalIndices(&tracks);
     int mixingDepth = fConfigMixingDepth.value;
     for (auto& [event1, event2] : selfCombinations(hashBin, mixingDepth, -1, events, events)) {
@@ -753,6 +849,7 @@ struct AnalysisSameEventPairing {
   Configurable<int64_t> nolaterthan{"ccdb-no-later-than", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count(), "latest acceptable timestamp of creation for the object"};
   Configurable<std::string> fConfigAddSEPHistogram{"cfgAddSEPHistogram", "", "Comma separated list of histograms"};
   Configurable<bool> fConfigFlatTables{"cfgFlatTables", false, "Produce a single flat tables with all relevant information of the pairs and single tracks"};
+  Configurable<bool> fConfigTimer{"cfgTimer", false, "Time the same event pairing (histograms in timer/ProcessTimer/)"};
   Configurable<bool> fConfigUseKFVertexing{"cfgUseKFVertexing", false, "Use KF Particle for secondary vertex reconstruction (DCAFitter is used by default)"};
   Configurable<bool> fUseRemoteField{"cfgUseRemoteField", false, "Chose whether to fetch the magnetic field from ccdb or set it manually"};
   Configurable<float> fConfigMagField{"cfgMagField", 5.0f, "Manually set magnetic field"};
@@ -760,6 +857,7 @@ struct AnalysisSameEventPairing {
   Configurable<std::string> grpmagPath{"grpmagPath", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object"};
   Configurable<bool> fUseAbsDCA{"cfgUseAbsDCA", false, "Use absolute DCA minimization instead of chi^2 minimization in secondary vertexing"};
   Configurable<bool> fPropToPCA{"cfgPropToPCA", false, "Propagate tracks to secondary vertex"};
+  Configurable<bool> fConfigUseTrackParCache{"cfgUseTrackParCache", true, "Build the track parametrizations used in the vertexing once per track and event"};
   Configurable<bool> fCorrFullGeo{"cfgCorrFullGeo", false, "Use full geometry to correct for MCS effects in track propagation"};
   Configurable<bool> fNoCorr{"cfgNoCorrFwdProp", false, "Do not correct for MCS effects in track propagation"};
   Configurable<std::string> lutPath{"lutPath", "GLO/Param/MatLUT", "Path of the Lut parametrization"};
@@ -785,10 +883,23 @@ struct AnalysisSameEventPairing {
   std::vector<std::vector<TString>> fMuonHistNames;
   std::vector<std::vector<TString>> fTrackMuonHistNames;
   std::vector<AnalysisCompositeCut> fPairCuts;
+  std::vector<uint32_t> fLegFilters; // filter maps of the legs used in the blocked pairing (see runBlockedPairing())
+  // per pair type, the number of leg cuts and the handles of the pair histogram classes, resolved at the first event
+  std::map<int, int> fNLegCuts;
+  std::map<int, std::vector<std::vector<int>>> fPairHistHandles;
+
+  // timing of the same event pairing, counting the legs
+  enum TimerSection {
+    kTimerPairing = 0
+  };
+  HistogramRegistry fTimerRegistry{"timer"};
+  o2::analysis::ProcessTimer fTimer;
 
   void init(o2::framework::InitContext& context)
   {
     fCurrentRun = 0;
+    fTimer.init(fTimerRegistry, {"same event pairing"}, fConfigTimer.value);
+    VarManager::SetUseTrackParCache(fConfigUseTrackParCache.value);
 
     ccdb->setURL(ccdburl.value);
     ccdb->setCaching(true);
@@ -933,6 +1044,8 @@ struct AnalysisSameEventPairing {
   template <bool TTwoProngFitter, int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, typename TEvent, typename TTracks1, typename TTracks2>
   void runSameEventPairing(TEvent const& event, TTracks1 const& tracks1, TTracks2 const& tracks2)
   {
+    auto timerPairing = fTimer.scope(kTimerPairing);
+    fTimer.count(kTimerPairing, tracks1.size());
     if (fCurrentRun != event.runNumber()) {
       if (fUseRemoteField.value) {
         grpmag = ccdb->getForTimeStamp<o2::parameters::GRPMagField>(grpmagPath, event.timestamp());
@@ -965,21 +1078,32 @@ struct AnalysisSameEventPairing {
       }
       fCurrentRun = event.runNumber();
     }
+    VarManager::ResetTrackParCache(); // the cached track parametrizations are valid only within the event
 
-    TString cutNames = fConfigTrackCuts.value;
-    std::vector<std::vector<TString>> histNames = fTrackHistNames;
-    if constexpr (TPairType == pairTypeMuMu) {
-      cutNames = fConfigMuonCuts.value;
-      histNames = fMuonHistNames;
-    }
-    if constexpr (TPairType == pairTypeEMu) {
-      cutNames = fConfigMuonCuts.value;
-      histNames = fTrackMuonHistNames;
+    auto& histHandles = fPairHistHandles[TPairType];
+    if (fNLegCuts.find(TPairType) == fNLegCuts.end()) {
+      TString cutNames = fConfigTrackCuts.value;
+      const std::vector<std::vector<TString>>* histNames = &fTrackHistNames;
+      if constexpr (TPairType == pairTypeMuMu) {
+        cutNames = fConfigMuonCuts.value;
+        histNames = &fMuonHistNames;
+      }
+      if constexpr (TPairType == pairTypeEMu) {
+        cutNames = fConfigMuonCuts.value;
+        histNames = &fTrackMuonHistNames;
+      }
+      std::unique_ptr<TObjArray> objArray(cutNames.Tokenize(","));
+      fNLegCuts[TPairType] = objArray->GetEntries();
+      // resolve the histogram classes once, instead of looking them up by name for every pair
+      histHandles.resize(histNames->size());
+      for (unsigned int i = 0; i < histNames->size(); i++) {
+        for (auto& name : (*histNames)[i]) {
+          histHandles[i].push_back(fHistMan->GetHistClassHandle(name.Data()));
+        }
+      }
     }
-    std::unique_ptr<TObjArray> objArray(cutNames.Tokenize(","));
-    int ncuts = objArray->GetEntries();
+    int ncuts = fNLegCuts[TPairType];
 
-    uint32_t twoTrackFilter = 0;
     uint32_t dileptonFilterMap = 0;
     uint32_t dileptonMcDecision = 0; // placeholder, copy of the dqEfficiency.cxx one
     dileptonList.reserve(1);
@@ -988,19 +1112,8 @@ struct AnalysisSameEventPairing {
     if (fConfigFlatTables.value) {
       dimuonAllList.reserve(1);
     }
-    for (auto& [t1, t2] : combinations(tracks1, tracks2)) {
-      if constexpr (TPairType == VarManager::kDecayToEE || TPairType == VarManager::kDecayToPiPi) {
-        twoTrackFilter = uint32_t(t1.isBarrelSelected()) & uint32_t(t2.isBarrelSelected()) & fTwoTrackFilterMask;
-      }
-      if constexpr (TPairType == VarManager::kDecayToMuMu) {
-        twoTrackFilter = uint32_t(t1.isMuonSelected()) & uint32_t(t2.isMuonSelected()) & fTwoMuonFilterMask;
-      }
-      if constexpr (TPairType == VarManager::kElectronMuon) {
-        twoTrackFilter = uint32_t(t1.isBarrelSelected()) & uint32_t(t2.isMuonSelected()) & fTwoTrackFilterMask;
-      }
-      if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
-        continue;
-      }
+
+    auto processPair = [&](auto const& t1, auto const& t2, uint32_t twoTrackFilter) {
       constexpr bool eventHasQvector = ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0);
 
       // TODO: FillPair functions need to provide a template argument to discriminate between cases when cov matrix is available or not
@@ -1063,26 +1176,26 @@ struct AnalysisSameEventPairing {
       for (int icut = 0; icut < ncuts; icut++) {
         if (twoTrackFilter & (uint32_t(1) << icut)) {
           if (t1.sign() * t2.sign() < 0) {
-            fHistMan->FillHistClass(histNames[iCut][0].Data(), VarManager::fgValues);
+            fHistMan->FillHistClass(histHandles[iCut][0], VarManager::fgValues);
           } else {
             if (t1.sign() > 0) {
-              fHistMan->FillHistClass(histNames[iCut][1].Data(), VarManager::fgValues);
+              fHistMan->FillHistClass(histHandles[iCut][1], VarManager::fgValues);
             } else {
-              fHistMan->FillHistClass(histNames[iCut][2].Data(), VarManager::fgValues);
+              fHistMan->FillHistClass(histHandles[iCut][2], VarManager::fgValues);
             }
           }
           iCut++;
           for (unsigned int iPairCut = 0; iPairCut < fPairCuts.size(); iPairCut++, iCut++) {
-            AnalysisCompositeCut cut = fPairCuts.at(iPairCut);
+            AnalysisCompositeCut& cut = fPairCuts.at(iPairCut);
             if (!(cut.IsSelected(VarManager::fgValues))) // apply pair cuts
               continue;
             if (t1.sign() * t2.sign() < 0) {
-              fHistMan->FillHistClass(histNames[iCut][0].Data(), VarManager::fgValues);
+              fHistMan->FillHistClass(histHandles[iCut][0], VarManager::fgValues);
             } else {
               if (t1.sign() > 0) {
-                fHistMan->FillHistClass(histNames[iCut][1].Data(), VarManager::fgValues);
+                fHistMan->FillHistClass(histHandles[iCut][1], VarManager::fgValues);
               } else {
-                fHistMan->FillHistClass(histNames[iCut][2].Data(), VarManager::fgValues);
+                fHistMan->FillHistClass(histHandles[iCut][2], VarManager::fgValues);
               }
             }
           }      // end loop (pair cuts)
@@ -1090,7 +1203,66 @@ struct AnalysisSameEventPairing {
           iCut++;
         }
       } // end loop (cuts)
-    }   // end loop over pairs
+    };
+
+    if constexpr (TPairType == VarManager::kElectronMuon) {
+      for (auto& [t1, t2] : combinations(tracks1, tracks2)) {
+        uint32_t twoTrackFilter = uint32_t(t1.isBarrelSelected()) & uint32_t(t2.isMuonSelected()) & fTwoTrackFilterMask;
+        if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
+          continue;
+        }
+        processPair(t1, t2, twoTrackFilter);
+      } // end loop over pairs
+    } else {
+      // NOTE: the same-type pairing runs over a single table, with the same pairs and order as combinations(tracks1, tracks2)
+      auto legFilter = [&](auto const& t) -> uint32_t {
+        if constexpr (TPairType == VarManager::kDecayToMuMu) {
+          return uint32_t(t.isMuonSelected()) & fTwoMuonFilterMask;
+        } else {
+          return uint32_t(t.isBarrelSelected()) & fTwoTrackFilterMask;
+        }
+      };
+      runBlockedPairing(tracks1, legFilter, processPair);
+    }
+  }
+
+  // Pairing kernel for pairs of legs from the same table
+  // The legs with at least one filter bit are first copied to a compact buffer, and for each first leg the filter bits shared
+  //   with a block of second legs are computed in one go (a simple loop over contiguous filter maps), before visiting only the pairs sharing a bit.
+  // NOTE: The pairs are visited in the same order as with combinations(CombinationsStrictlyUpperIndexPolicy(tracks, tracks)),
+  //       such that the produced tables do not change
+  template <typename TTracks, typename TFilter, typename TPairFunc>
+  void runBlockedPairing(TTracks const& tracks, TFilter const& legFilter, TPairFunc const& pairFunc)
+  {
+    constexpr int kBlockSize = 256;
+    std::vector<typename TTracks::iterator> legs;
+    legs.reserve(tracks.size());
+    fLegFilters.clear();
+    for (auto& track : tracks) {
+      uint32_t filter = legFilter(track);
+      if (filter) {
+        legs.push_back(track);
+        fLegFilters.push_back(filter);
+      }
+    }
+
+    uint32_t pairFilters[kBlockSize];
+    const int nLegs = legs.size();
+    for (int i = 0; i < nLegs - 1; i++) {
+      const uint32_t filter1 = fLegFilters[i];
+      for (int jBegin = i + 1; jBegin < nLegs; jBegin += kBlockSize) {
+        const int nBlock = std::min(kBlockSize, nLegs - jBegin);
+        const uint32_t* filters2 = fLegFilters.data() + jBegin;
+        for (int j = 0; j < nBlock; j++) {
+          pairFilters[j] = filter1 & filters2[j];
+        }
+        for (int j = 0; j < nBlock; j++) {
+          if (pairFilters[j]) { // the legs must have at least one filter bit in common
+            pairFunc(legs[i], legs[jBegin + j], pairFilters[j]);
+          }
+        }
+      }
+    } // end loop over pairs
   }
 
   void processDecayToEESkimmed(soa::Filtered<MyEventsSelected>::iterator const& event, soa::Filtered<MyBarrelTracksSelected> const& tracks)
@@ -1268,6 +1440,7 @@ struct AnalysisDileptonHadron {
   Configurable<bool> fUseRemoteField{"cfgUseRemoteField", false, "Chose whether to fetch the magnetic field from ccdb or set it manually"};
   Configurable<std::string> grpmagPath{"grpmagPath", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object"};
   Configurable<float> fConfigMagField{"cfgMagField", 5.0f, "Manually set magnetic field"};
+  Configurable<bool> fConfigUseTrackParCache{"cfgUseTrackParCache", true, "Build the track parametrizations used in the vertexing once per track and event"};
 
   Service<o2::ccdb::BasicCCDBManager> ccdb;
   Produces<aod::BmesonCandidates> BmesonsTable;
@@ -1293,6 +1466,7 @@ struct AnalysisDileptonHadron {
   void init(o2::framework::InitContext& context)
   {
     fCurrentRun = 0;
+    VarManager::SetUseTrackParCache(fConfigUseTrackParCache.value);
     fValuesDilepton = new float[VarManager::kNVars];
     fValuesHadron = new float[VarManager::kNVars];
     VarManager::SetDefaultVarNames();
@@ -1349,6 +1523,7 @@ struct AnalysisDileptonHadron {
       }
       fCurrentRun = event.runNumber();
     } // end: runNumber
+    VarManager::ResetTrackParCache(); // the cached track parametrizations are valid only within the event
 
     VarManager::ResetValues(0, VarManager::kNVars, fValuesHadron);
     VarManager::ResetValues(0, VarManager::kNVars, fValuesDilepton);
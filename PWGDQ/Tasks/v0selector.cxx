@@ -18,7 +18,7 @@
 //    Please write to: daiki.sekihata@cern.ch
 //
 #include <array>
-#include <map>
+#include <vector>
 #include "Math/Vector4D.h"
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
@@ -137,6 +137,7 @@ struct v0selector {
   Configurable<bool> fillhisto{"fillhisto", false, "flag to fill histograms"};
 
   HistogramRegistry registry{"registry"};
+  std::vector<uint8_t> pidmap; // buffer of the V0 tags of the tracks, reused between time frames
   void init(o2::framework::InitContext& context)
   {
     if (fillhisto) {
@@ -162,7 +163,8 @@ struct v0selector {
 
   void process(aod::V0Datas const& V0s, FullTracksExt const& tracks, aod::Collisions const&)
   {
-    std::map<int, uint8_t> pidmap;
+    // V0 tags of each track, indexed by track
+    pidmap.assign(tracks.size(), 0);
 
     for (auto& V0 : V0s) {
       // if (!(V0.posTrack_as<FullTracksExt>().trackType() & o2::aod::track::TPCrefit)) {
@@ -176,42 +178,44 @@ struct v0selector {
       if (fillhisto) {
         registry.fill(HIST("hV0Candidate"), 1);
       }
-      if (fabs(V0.posTrack_as<FullTracksExt>().eta()) > 0.9) {
+      const auto& posTrack = V0.posTrack_as<FullTracksExt>();
+      const auto& negTrack = V0.negTrack_as<FullTracksExt>();
+      if (fabs(posTrack.eta()) > 0.9) {
         continue;
       }
-      if (fabs(V0.negTrack_as<FullTracksExt>().eta()) > 0.9) {
+      if (fabs(negTrack.eta()) > 0.9) {
         continue;
       }
 
-      if (V0.posTrack_as<FullTracksExt>().tpcNClsCrossedRows() < mincrossedrows) {
+      if (posTrack.tpcNClsCrossedRows() < mincrossedrows) {
         continue;
       }
-      if (V0.negTrack_as<FullTracksExt>().tpcNClsCrossedRows() < mincrossedrows) {
+      if (negTrack.tpcNClsCrossedRows() < mincrossedrows) {
         continue;
       }
 
-      if (V0.posTrack_as<FullTracksExt>().tpcChi2NCl() > maxchi2tpc) {
+      if (posTrack.tpcChi2NCl() > maxchi2tpc) {
         continue;
       }
-      if (V0.negTrack_as<FullTracksExt>().tpcChi2NCl() > maxchi2tpc) {
+      if (negTrack.tpcChi2NCl() > maxchi2tpc) {
         continue;
       }
 
-      if (fabs(V0.posTrack_as<FullTracksExt>().dcaXY()) < dcamin) {
+      if (fabs(posTrack.dcaXY()) < dcamin) {
         continue;
       }
-      if (fabs(V0.negTrack_as<FullTracksExt>().dcaXY()) < dcamin) {
+      if (fabs(negTrack.dcaXY()) < dcamin) {
         continue;
       }
 
-      if (fabs(V0.posTrack_as<FullTracksExt>().dcaXY()) > dcamax) {
+      if (fabs(posTrack.dcaXY()) > dcamax) {
         continue;
       }
-      if (fabs(V0.negTrack_as<FullTracksExt>().dcaXY()) > dcamax) {
+      if (fabs(negTrack.dcaXY()) > dcamax) {
         continue;
       }
 
-      if (V0.posTrack_as<FullTracksExt>().sign() * V0.negTrack_as<FullTracksExt>().sign() > 0) { // reject same sign pair
+      if (posTrack.sign() * negTrack.sign() > 0) { // reject same sign pair
         continue;
       }
 
@@ -256,10 +260,10 @@ struct v0selector {
       if (fillhisto) {
         registry.fill(HIST("hV0Pt"), V0.pt());
         registry.fill(HIST("hV0EtaPhi"), V0.phi(), V0.eta());
-        registry.fill(HIST("hDCAxyPosToPV"), V0.posTrack_as<FullTracksExt>().dcaXY());
-        registry.fill(HIST("hDCAxyNegToPV"), V0.negTrack_as<FullTracksExt>().dcaXY());
-        registry.fill(HIST("hDCAzPosToPV"), V0.posTrack_as<FullTracksExt>().dcaZ());
-        registry.fill(HIST("hDCAzNegToPV"), V0.negTrack_as<FullTracksExt>().dcaZ());
+        registry.fill(HIST("hDCAxyPosToPV"), posTrack.dcaXY());
+        registry.fill(HIST("hDCAxyNegToPV"), negTrack.dcaXY());
+        registry.fill(HIST("hDCAzPosToPV"), posTrack.dcaZ());
+        registry.fill(HIST("hDCAzNegToPV"), negTrack.dcaZ());
         registry.fill(HIST("hV0APplot"), V0.alpha(), V0.qtarm());
         registry.fill(HIST("hV0Radius"), V0radius);
         registry.fill(HIST("hV0CosPA"), V0CosinePA);
@@ -277,7 +281,7 @@ struct v0selector {
           registry.fill(HIST("hMassGamma"), V0radius, mGamma);
           registry.fill(HIST("hV0Psi"), psipair, mGamma);
         }
-        if (mGamma < v0max_mee && TMath::Abs(V0.posTrack_as<FullTracksExt>().tpcNSigmaEl()) < 5 && TMath::Abs(V0.negTrack_as<FullTracksExt>().tpcNSigmaEl()) < 5 && psipair < maxpsipair) {
+        if (mGamma < v0max_mee && TMath::Abs(posTrack.tpcNSigmaEl()) < 5 && TMath::Abs(negTrack.tpcNSigmaEl()) < 5 && psipair < maxpsipair) {
           pidmap[V0.posTrackId()] |= (uint8_t(1) << kGamma);
           pidmap[V0.negTrackId()] |= (uint8_t(1) << kGamma);
           if (fillhisto) {
@@ -288,7 +292,7 @@ struct v0selector {
         if (fillhisto) {
           registry.fill(HIST("hMassK0S"), V0radius, mK0S);
         }
-        if ((0.48 < mK0S && mK0S < 0.51) && TMath::Abs(V0.posTrack_as<FullTracksExt>().tpcNSigmaPi()) < 5 && TMath::Abs(V0.negTrack_as<FullTracksExt>().tpcNSigmaPi()) < 5) {
+        if ((0.48 < mK0S && mK0S < 0.51) && TMath::Abs(posTrack.tpcNSigmaPi()) < 5 && TMath::Abs(negTrack.tpcNSigmaPi()) < 5) {
           pidmap[V0.posTrackId()] |= (uint8_t(1) << kK0S);
           pidmap[V0.negTrackId()] |= (uint8_t(1) << kK0S);
         }
@@ -296,7 +300,7 @@ struct v0selector {
         if (fillhisto) {
           registry.fill(HIST("hMassLambda"), V0radius, mLambda);
         }
-        if (v0id == kLambda && (1.110 < mLambda && mLambda < 1.120) && TMath::Abs(V0.posTrack_as<FullTracksExt>().tpcNSigmaPr()) < 5 && TMath::Abs(V0.negTrack_as<FullTracksExt>().tpcNSigmaPi()) < 5) {
+        if (v0id == kLambda && (1.110 < mLambda && mLambda < 1.120) && TMath::Abs(posTrack.tpcNSigmaPr()) < 5 && TMath::Abs(negTrack.tpcNSigmaPi()) < 5) {
           pidmap[V0.posTrackId()] |= (uint8_t(1) << kLambda);
           pidmap[V0.negTrackId()] |= (uint8_t(1) << kLambda);
         }
@@ -304,7 +308,7 @@ struct v0selector {
         if (fillhisto) {
           registry.fill(HIST("hMassAntiLambda"), V0radius, mAntiLambda);
         }
-        if ((1.110 < mAntiLambda && mAntiLambda < 1.120) && TMath::Abs(V0.posTrack_as<FullTracksExt>().tpcNSigmaPi()) < 5 && TMath::Abs(V0.negTrack_as<FullTracksExt>().tpcNSigmaPr()) < 5) {
+        if ((1.110 < mAntiLambda && mAntiLambda < 1.120) && TMath::Abs(posTrack.tpcNSigmaPi()) < 5 && TMath::Abs(negTrack.tpcNSigmaPr()) < 5) {
           pidmap[V0.posTrackId()] |= (uint8_t(1) << kAntiLambda);
           pidmap[V0.negTrackId()] |= (uint8_t(1) << kAntiLambda);
         }
@@ -315,6 +319,7 @@ struct v0selector {
 
     } // end of V0 loop
 
+    v0bits.reserve(tracks.size());
     for (auto& track : tracks) {
       // printf("setting pidmap[%lld] = %d\n",track.globalIndex(),pidmap[track.globalIndex()]);
       v0bits(pidmap[track.globalIndex()]);
@@ -12,6 +12,7 @@
 //
 // Analysis task for lmee light flavour cocktail
 
+#include <algorithm>
 #include <vector>
 #include "Framework/Task.h"
 #include "Framework/runDataProcessing.h"
@@ -113,6 +114,14 @@ struct lmeelfcocktail {
   MomentumSmearer smearer;
 
   Double_t eMass;
+  Double_t cosMinOpAng; // cosine of the minimum opening angle of the legs
+
+  // electrons of the event for the LS and ULS pairing, kept between events to reuse the memory
+  std::vector<PxPyPzEVector> eBuff;
+  std::vector<XYZVector> edirBuff; // unit momentum vectors
+  std::vector<Char_t> echBuff;
+  std::vector<Double_t> eweightBuff;
+  std::vector<bool> eaccBuff; // whether the electron passes the single-leg pT and eta cuts
 
   Configurable<int> fCollisionSystem{"cfgCollisionSystem", 200, "set the collision system"};
   Configurable<bool> fConfigWriteTTree{"cfgWriteTTree", false, "write tree output"};
@@ -182,6 +191,7 @@ struct lmeelfcocktail {
     }
 
     eMass = (TDatabasePDG::Instance()->GetParticle(11))->Mass();
+    cosMinOpAng = TMath::Cos(fConfigMinOpAng);
 
     fillKrollWada();
   }
@@ -196,10 +206,6 @@ struct lmeelfcocktail {
       // get the tracks
       auto mctracks = pc.inputs().get<std::vector<o2::MCTrack>>("mctracks", i);
 
-      std::vector<PxPyPzEVector> eBuff;
-      std::vector<Char_t> echBuff;
-      std::vector<Double_t> eweightBuff;
-
       bool skipNext = false;
 
       int trackID = -1;
@@ -224,11 +230,15 @@ struct lmeelfcocktail {
               ech = -1.;
             }
             eweight = mctrack.getWeight();
+            bool eacc = e.Pt() > fConfigMinPt && e.Pt() < fConfigMaxPt && TMath::Abs(e.Eta()) < fConfigMaxEta;
+            XYZVector edir = e.Vect().Unit();
             // put in the buffer
             //-----------------
             eBuff.push_back(e);
+            edirBuff.push_back(edir);
             echBuff.push_back(ech);
             eweightBuff.push_back(eweight);
+            eaccBuff.push_back(eacc);
             // loop the buffer and pair
             //------------------------
             for (Int_t jj = eBuff.size() - 2; jj >= 0; jj--) {
@@ -242,7 +252,7 @@ struct lmeelfcocktail {
                 registry.fill(HIST("LSpp_orig"), dielectron.M(), dielectron.Pt(), dielectron_weight);
               if (dielectron_ch < 0)
                 registry.fill(HIST("LSmm_orig"), dielectron.M(), dielectron.Pt(), dielectron_weight);
-              if (e.Pt() > fConfigMinPt && eBuff.at(jj).Pt() > fConfigMinPt && e.Pt() < fConfigMaxPt && eBuff.at(jj).Pt() < fConfigMaxPt && TMath::Abs(e.Eta()) < fConfigMaxEta && TMath::Abs(eBuff.at(jj).Eta()) < fConfigMaxEta && e.Vect().Unit().Dot(eBuff.at(jj).Vect().Unit()) < TMath::Cos(fConfigMinOpAng)) {
+              if (eacc && eaccBuff[jj] && edir.Dot(edirBuff[jj]) < cosMinOpAng) {
                 if (dielectron_ch == 0)
                   registry.fill(HIST("ULS"), dielectron.M(), dielectron.Pt(), dielectron_weight);
                 if (dielectron_ch > 0)
@@ -444,19 +454,19 @@ struct lmeelfcocktail {
             treeWords.fpass = false; // leg pT cut
           if (treeWords.fd1pt > fConfigMaxPt || treeWords.fd2pt > fConfigMaxPt)
             treeWords.fpass = false; // leg pT cut
-          if (dau1.Vect().Unit().Dot(dau2.Vect().Unit()) > TMath::Cos(fConfigMinOpAng))
+          if (dau1.Vect().Unit().Dot(dau2.Vect().Unit()) > cosMinOpAng)
             treeWords.fpass = false; // opening angle cut
           if (TMath::Abs(treeWords.fd1eta) > fConfigMaxEta || TMath::Abs(treeWords.fd2eta) > fConfigMaxEta)
             treeWords.fpass = false;
 
           // get the pair DCA (based in smeared pT)
-          for (int jj = 0; jj < nbDCAtemplate; jj++) { // loop over DCA templates
-            if (dau1.Pt() >= DCATemplateEdges[jj] && dau1.Pt() < DCATemplateEdges[jj + 1]) {
-              treeWords.fd1DCA = fh_DCAtemplates[jj]->GetRandom();
-            }
-            if (dau2.Pt() >= DCATemplateEdges[jj] && dau2.Pt() < DCATemplateEdges[jj + 1]) {
-              treeWords.fd2DCA = fh_DCAtemplates[jj]->GetRandom();
-            }
+          int itemplate = GetDCATemplateIndex(dau1.Pt());
+          if (itemplate >= 0) {
+            treeWords.fd1DCA = fh_DCAtemplates[itemplate]->GetRandom();
+          }
+          itemplate = GetDCATemplateIndex(dau2.Pt());
+          if (itemplate >= 0) {
+            treeWords.fd2DCA = fh_DCAtemplates[itemplate]->GetRandom();
           }
           treeWords.fpairDCA = sqrt((pow(treeWords.fd1DCA, 2) + pow(treeWords.fd2DCA, 2)) / 2);
 
@@ -564,7 +574,7 @@ struct lmeelfcocktail {
               Double_t VPHphi = 2.0 * TMath::ACos(-1.) * gRandom->Rndm();
               TLorentzVector beam;
               beam.SetPtEtaPhiM(VPHpT, VPHeta, VPHphi, VPHmass);
-              Double_t decaymasses[2] = {(TDatabasePDG::Instance()->GetParticle(11))->Mass(), (TDatabasePDG::Instance()->GetParticle(11))->Mass()};
+              Double_t decaymasses[2] = {eMass, eMass};
               TGenPhaseSpace VPHgen;
               Bool_t SetDecay;
               SetDecay = VPHgen.SetDecay(beam, 2, decaymasses);
@@ -618,7 +628,7 @@ struct lmeelfcocktail {
                 treeWords.fpass = false; // leg pT cut
               if (dau1.Pt() > fConfigMaxPt || dau2.Pt() > fConfigMaxPt)
                 treeWords.fpass = false; // leg pT cut
-              if (dau1.Vect().Unit().Dot(dau2.Vect().Unit()) > TMath::Cos(fConfigMinOpAng))
+              if (dau1.Vect().Unit().Dot(dau2.Vect().Unit()) > cosMinOpAng)
                 treeWords.fpass = false; // opening angle cut
               if (TMath::Abs(dau1.Eta()) > fConfigMaxEta || TMath::Abs(dau2.Eta()) > fConfigMaxEta)
                 treeWords.fpass = false;
@@ -685,11 +695,20 @@ struct lmeelfcocktail {
 
       // Clear buffers
       eBuff.clear();
+      edirBuff.clear();
       echBuff.clear();
       eweightBuff.clear();
+      eaccBuff.clear();
     }
   }
 
+  // index of the DCA template of the pT bin, -1 outside of the template edges
+  int GetDCATemplateIndex(double pt)
+  {
+    int index = std::upper_bound(DCATemplateEdges.begin(), DCATemplateEdges.end(), pt) - DCATemplateEdges.begin() - 1;
+    return (index >= 0 && index < nbDCAtemplate) ? index : -1;
+  }
+
   Double_t PhiV(PxPyPzEVector e1, PxPyPzEVector e2)
   {
     Double_t outPhiV;
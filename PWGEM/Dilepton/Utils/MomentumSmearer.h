@@ -11,11 +11,18 @@
 //
 //
 // Class to produce smeared pt,eta,phi
+//
+// The resolution maps are converted at init into inverse cumulative distributions of each pt slice,
+// tabulated at uniform quantiles, so that a smearing is drawn with one lookup and a linear interpolation.
 
 #ifndef PWGEM_DILEPTON_UTILS_MOMENTUMSMEARER_H_
 #define PWGEM_DILEPTON_UTILS_MOMENTUMSMEARER_H_
 
+#include <algorithm>
+#include <vector>
 #include <TH1D.h>
+#include <TH2D.h>
+#include <TRandom.h>
 #include <TString.h>
 #include <TGrid.h>
 #include <TObjArray.h>
@@ -93,59 +100,33 @@ class MomentumSmearer
     fArrResoPhi_Neg = ArrResoPhi_Neg;
     fFile->Close();
 
+    buildSmearingMap(fArrResoPt, fMapPt);
+    buildSmearingMap(fArrResoEta, fMapEta);
+    buildSmearingMap(fArrResoPhi_Pos, fMapPhiPos);
+    buildSmearingMap(fArrResoPhi_Neg, fMapPhiNeg);
+
     fInitialized = true;
   }
 
   void applySmearing(const int ch, const float ptgen, const float etagen, const float phigen, float& ptsmeared, float& etasmeared, float& phismeared)
   {
     // smear pt
-    int ptbin = reinterpret_cast<TH2D*>(fArrResoPt->At(0))->GetXaxis()->FindBin(ptgen);
-    if (ptbin < 1) {
-      ptbin = 1;
-    }
-    if (ptbin > fArrResoPt->GetLast()) {
-      ptbin = fArrResoPt->GetLast();
-    }
-    float smearing = 0.;
-    TH1D* thisHist = reinterpret_cast<TH1D*>(fArrResoPt->At(ptbin));
-    if (thisHist->GetEntries() > 0) {
-      smearing = thisHist->GetRandom() * ptgen;
-    }
-    ptsmeared = ptgen - smearing;
+    ptsmeared = ptgen - getSmearing(fMapPt, getPtBin(fMapPt, ptgen)) * ptgen;
 
     // smear eta
-    ptbin = reinterpret_cast<TH2D*>(fArrResoEta->At(0))->GetXaxis()->FindBin(ptgen);
-    if (ptbin < 1) {
-      ptbin = 1;
-    }
-    if (ptbin > fArrResoEta->GetLast()) {
-      ptbin = fArrResoEta->GetLast();
-    }
-    smearing = 0.;
-    thisHist = reinterpret_cast<TH1D*>(fArrResoEta->At(ptbin));
-    if (thisHist->GetEntries() > 0) {
-      smearing = thisHist->GetRandom();
-    }
-    etasmeared = etagen - smearing;
+    etasmeared = etagen - getSmearing(fMapEta, getPtBin(fMapEta, ptgen));
 
-    // smear phi
-    ptbin = reinterpret_cast<TH2D*>(fArrResoPhi_Pos->At(0))->GetXaxis()->FindBin(ptgen);
-    if (ptbin < 1) {
-      ptbin = 1;
-    }
-    if (ptbin > fArrResoPhi_Pos->GetLast()) {
-      ptbin = fArrResoPhi_Pos->GetLast();
-    }
-    smearing = 0.;
-    if (ch < 0) {
-      thisHist = reinterpret_cast<TH1D*>(fArrResoPhi_Neg->At(ptbin));
-    } else {
-      thisHist = reinterpret_cast<TH1D*>(fArrResoPhi_Pos->At(ptbin));
-    }
-    if (thisHist->GetEntries() > 0) {
-      smearing = thisHist->GetRandom();
+    // smear phi, in the pt bins of the positive map for both charges
+    int ptbin = getPtBin(fMapPhiPos, ptgen);
+    phismeared = phigen - getSmearing(ch < 0 ? fMapPhiNeg : fMapPhiPos, ptbin);
+  }
+
+  /// Smears n particles at once
+  void applySmearing(const int n, const int* ch, const float* ptgen, const float* etagen, const float* phigen, float* ptsmeared, float* etasmeared, float* phismeared)
+  {
+    for (int i = 0; i < n; i++) {
+      applySmearing(ch[i], ptgen[i], etagen[i], phigen[i], ptsmeared[i], etasmeared[i], phismeared[i]);
     }
-    phismeared = phigen - smearing;
   }
 
   // setters
@@ -154,6 +135,7 @@ class MomentumSmearer
   void setResEtaHistName(TString resEtaHistName) { fResEtaHistName = resEtaHistName; }
   void setResPhiPosHistName(TString resPhiPosHistName) { fResPhiPosHistName = resPhiPosHistName; }
   void setResPhiNegHistName(TString resPhiNegHistName) { fResPhiNegHistName = resPhiNegHistName; }
+  void setNQuantiles(int nQuantiles) { fNQuantiles = nQuantiles; } // to be set before init
 
   // getters
   TString getResFileName() { return fResFileName; }
@@ -165,9 +147,76 @@ class MomentumSmearer
   TObjArray* getArrResoEta() { return fArrResoEta; }
   TObjArray* getArrResoPhiPos() { return fArrResoPhi_Pos; }
   TObjArray* getArrResoPhiNeg() { return fArrResoPhi_Neg; }
+  int getNQuantiles() { return fNQuantiles; }
 
  private:
+  /// Resolution map: pt axis of the slices and their inverse cumulative distributions
+  struct SmearingMap {
+    std::vector<double> ptEdges;  // bin edges of the pt axis of the map
+    int lastSlice = 0;            // index of the last pt slice in the array
+    std::vector<char> hasEntries; // per slice, whether it is used to smear
+    std::vector<float> quantiles; // per slice, values at the fNQuantiles + 1 uniform quantiles
+  };
+
+  void buildSmearingMap(TObjArray* arr, SmearingMap& map)
+  {
+    map = SmearingMap();
+    if (!arr || arr->GetLast() < 1) {
+      return;
+    }
+    const TAxis* axis = reinterpret_cast<TH2D*>(arr->At(0))->GetXaxis();
+    for (int i = 1; i <= axis->GetNbins() + 1; i++) {
+      map.ptEdges.push_back(axis->GetBinLowEdge(i));
+    }
+    map.lastSlice = arr->GetLast();
+    map.hasEntries.assign(map.lastSlice + 1, 0);
+    map.quantiles.assign((map.lastSlice + 1) * (fNQuantiles + 1), 0.f);
+    for (int islice = 1; islice <= map.lastSlice; islice++) {
+      TH1D* hist = reinterpret_cast<TH1D*>(arr->At(islice));
+      if (hist->GetEntries() <= 0) {
+        continue;
+      }
+      map.hasEntries[islice] = 1;
+      if (hist->ComputeIntegral() <= 0.) {
+        continue; // GetRandom returns 0 for an empty integral
+      }
+      // same inverse as TH1::GetRandom: linear within the bin of the quantile
+      const double* integral = hist->GetIntegral();
+      const int nbins = hist->GetNbinsX();
+      float* quantiles = &map.quantiles[islice * (fNQuantiles + 1)];
+      for (int k = 0; k <= fNQuantiles; k++) {
+        double u = static_cast<double>(k) / fNQuantiles;
+        int ibin = std::clamp(static_cast<int>(std::upper_bound(integral, integral + nbins, u) - integral) - 1, 0, nbins - 1);
+        double x = hist->GetBinLowEdge(ibin + 1);
+        if (u > integral[ibin]) {
+          x += hist->GetBinWidth(ibin + 1) * (u - integral[ibin]) / (integral[ibin + 1] - integral[ibin]);
+        }
+        quantiles[k] = x;
+      }
+    }
+  }
+
+  /// \return the index of the slice of the map, as given by TAxis::FindBin and clamped to the slices of the array
+  int getPtBin(const SmearingMap& map, const float pt) const
+  {
+    int ptbin = std::upper_bound(map.ptEdges.begin(), map.ptEdges.end(), pt) - map.ptEdges.begin();
+    return std::clamp(ptbin, 1, std::max(map.lastSlice, 1));
+  }
+
+  /// \return a smearing drawn from the slice of the map, 0 if the slice is empty
+  float getSmearing(const SmearingMap& map, const int ptbin) const
+  {
+    if (ptbin > map.lastSlice || !map.hasEntries[ptbin]) {
+      return 0.f;
+    }
+    const float* quantiles = &map.quantiles[ptbin * (fNQuantiles + 1)];
+    double pos = gRandom->Rndm() * fNQuantiles;
+    int k = std::min(static_cast<int>(pos), fNQuantiles - 1);
+    return quantiles[k] + (pos - k) * (quantiles[k + 1] - quantiles[k]);
+  }
+
   bool fInitialized = false;
+  int fNQuantiles = 1000; // number of uniform quantiles of the inverse cumulative distributions
   TString fResFileName;
   TString fResPtHistName;
   TString fResEtaHistName;
@@ -177,6 +226,10 @@ class MomentumSmearer
   TObjArray* fArrResoEta;
   TObjArray* fArrResoPhi_Pos;
   TObjArray* fArrResoPhi_Neg;
+  SmearingMap fMapPt;
+  SmearingMap fMapEta;
+  SmearingMap fMapPhiPos;
+  SmearingMap fMapPhiNeg;
 };
 
 #endif // PWGEM_DILEPTON_UTILS_MOMENTUMSMEARER_H_
@@ -24,16 +24,27 @@ void PairCut::SetAsymRange(float min, float max)
 {
   mMinAsym = min;
   mMaxAsym = max;
+  if (mMinAsym >= 0.f || mMaxAsym <= 1.f) { // the asymmetry is in [0, 1]
+    AddActiveCut(PairCuts::kAsym);
+  }
   LOG(info) << "Pair Cut, set energy asymmetry range: " << mMinAsym << " - " << mMaxAsym;
 }
 
+void PairCut::AddActiveCut(const PairCuts& cut)
+{
+  if (std::find(mActiveCuts.begin(), mActiveCuts.end(), cut) == mActiveCuts.end()) {
+    mActiveCuts.push_back(cut);
+    std::sort(mActiveCuts.begin(), mActiveCuts.end());
+  }
+}
+
 void PairCut::print() const
 {
   LOG(info) << "Pair Cut:";
   for (int i = 0; i < static_cast<int>(PairCuts::kNCuts); i++) {
     switch (static_cast<PairCuts>(i)) {
       case PairCuts::kAsym:
-        LOG(info) << mCutNames[i] << " in [" << mMinAsym << ", " << mMaxAsym << "]";
+        LOG(info) << mCutNames[i] << " in [" << mMinAsym << ", " << mMaxAsym << "], rejected " << mNRejected[i] << " of " << mNTested << " pairs";
         break;
       default:
         LOG(fatal) << "Cut unknown!";
@@ -16,6 +16,8 @@
 #ifndef PWGEM_PHOTONMESON_CORE_PAIRCUT_H_
 #define PWGEM_PHOTONMESON_CORE_PAIRCUT_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <set>
 #include <vector>
 #include <utility>
@@ -40,11 +42,16 @@ class PairCut : public TNamed
 
   static const char* mCutNames[static_cast<int>(PairCuts::kNCuts)];
 
+  // only the configured cuts are evaluated, in the order of the enum, i.e. the cheapest first
   template <typename G1, typename G2>
   bool IsSelected(G1 const& g1, G2 const& g2) const
   {
-    if (!IsSelectedPair(g1, g2, PairCuts::kAsym)) {
-      return false;
+    mNTested++;
+    for (auto& cut : mActiveCuts) {
+      if (!IsSelectedPair(g1, g2, cut)) {
+        mNRejected[static_cast<int>(cut)]++;
+        return false;
+      }
     }
 
     return true;
@@ -68,13 +75,23 @@ class PairCut : public TNamed
   // Setters
   void SetAsymRange(float min = -1e+10f, float max = 1e10f);
 
+  // Selectivity counters
+  uint64_t GetNTested() const { return mNTested; }
+  uint64_t GetNRejected(const PairCuts& cut) const { return mNRejected[static_cast<int>(cut)]; }
+
   /// @brief Print the pair selection
   void print() const;
 
  private:
+  void AddActiveCut(const PairCuts& cut);
+
   float mMinAsym{-1e+10}, mMaxAsym{1e+10};
 
-  ClassDef(PairCut, 1);
+  std::vector<PairCuts> mActiveCuts;                                  // cuts which can reject a pair, sorted as in the enum
+  mutable uint64_t mNTested{0};                                       //! number of pairs tested
+  mutable uint64_t mNRejected[static_cast<int>(PairCuts::kNCuts)]{0}; //! number of pairs rejected first by each cut
+
+  ClassDef(PairCut, 2);
 };
 
 #endif // PWGEM_PHOTONMESON_CORE_PAIRCUT_H_
@@ -15,6 +15,8 @@
 //    Please write to: daiki.sekihata@cern.ch
 
 #include <array>
+#include <cmath>
+#include <tuple>
 #include <vector>
 #include <algorithm>
 #include "Framework/runDataProcessing.h"
@@ -95,6 +97,7 @@ struct createPCM {
   Configurable<float> max_qt_arm{"max_qt_arm", 0.03, "max qt for AP cut in GeV/c"};
   Configurable<float> max_r_req_its{"max_r_req_its", 16.0, "min Rxy for V0 with ITS hits"};
   Configurable<float> min_r_tpconly{"min_r_tpconly", 32.0, "min Rxy for V0 with TPConly tracks"};
+  Configurable<float> maxDipAngleFactor{"maxDipAngleFactor", 1.5, "margin on the max. difference of the dip angles of the legs allowed by max_qt_arm, negative to fit all pairs"};
 
   int mRunNumber;
   float d_bz;
@@ -388,8 +391,54 @@ struct createPCM {
   // Partition<MyFilteredTracks> orphan_negTracks = o2::aod::track::signed1Pt < 0.f && o2::aod::track::collisionId < int32_t(0);
   Partition<MyFilteredTracks> posTracks = o2::aod::track::signed1Pt > 0.f;
   Partition<MyFilteredTracks> negTracks = o2::aod::track::signed1Pt < 0.f;
-  std::vector<decltype(negTracks->sliceByCached(o2::aod::track::collisionId, 0, cache))> negTracks_sw;
-  std::vector<decltype(posTracks->sliceByCached(o2::aod::track::collisionId, 0, cache))> posTracks_sw;
+
+  // Selected tracks of a searching window (or collision), to be paired
+  struct Leg {
+    float lambda;   // dip angle, constant along the helix
+    float maxAngle; // max. angle to the photon direction allowed by max_qt_arm
+    int64_t index;  // global index of the track
+    int64_t order;  // position of the track in the input, to keep the order of the pairs
+  };
+  std::vector<Leg> negLegs;
+  std::vector<Leg> posLegs;
+
+  template <typename TTrack>
+  Leg makeLeg(TTrack const& track, int64_t order)
+  {
+    return {std::atan(track.tgl()), std::asin(std::min(1.f, max_qt_arm / track.p())), track.globalIndex(), order};
+  }
+
+  /// Calls function(negLeg, posLeg) for the pairs of legs which can pass the AP cut.
+  /// Since qt is the momentum of each leg transverse to the photon, the opening angle, and thus the difference
+  /// of the dip angles, is at most asin(qt/p1) + asin(qt/p2). The positive legs are sorted by dip angle,
+  /// so that only the ones in the window of each negative leg are checked.
+  template <typename F>
+  void forEachLegPair(F&& function)
+  {
+    if (maxDipAngleFactor < 0.f) {
+      for (const auto& negLeg : negLegs) {
+        for (const auto& posLeg : posLegs) {
+          function(negLeg, posLeg);
+        }
+      }
+      return;
+    }
+    std::sort(posLegs.begin(), posLegs.end(), [](const Leg& a, const Leg& b) { return a.lambda < b.lambda; });
+    float maxAnglePos = 0.f;
+    for (const auto& posLeg : posLegs) {
+      maxAnglePos = std::max(maxAnglePos, posLeg.maxAngle);
+    }
+    for (const auto& negLeg : negLegs) {
+      const float window = maxDipAngleFactor * (negLeg.maxAngle + maxAnglePos);
+      auto posLeg = std::lower_bound(posLegs.begin(), posLegs.end(), negLeg.lambda - window, [](const Leg& leg, float lambda) { return leg.lambda < lambda; });
+      for (; posLeg != posLegs.end() && posLeg->lambda <= negLeg.lambda + window; ++posLeg) {
+        if (std::fabs(negLeg.lambda - posLeg->lambda) > maxDipAngleFactor * (negLeg.maxAngle + posLeg->maxAngle)) {
+          continue;
+        }
+        function(negLeg, *posLeg);
+      }
+    }
+  }
 
   void processSA(MyFilteredTracks const& tracks, aod::Collisions const& collisions, aod::BCsWithTimestamps const&)
   {
@@ -406,46 +455,47 @@ struct createPCM {
       int32_t max_sw = std::min(int64_t(min_sw + nsw), int64_t(collisions.size()));
 
       // LOGF(info, "orphan_posTracks.size() = %d, orphan_negTracks.size() = %d", orphan_posTracks.size(), orphan_negTracks.size());
-      negTracks_sw.reserve(max_sw - min_sw);
-      posTracks_sw.reserve(max_sw - min_sw);
-
-      // int npos = 0, nneg = 0;
+      // the tracks of the searching window are selected once, and not for each pair
+      negLegs.clear();
+      posLegs.clear();
       for (int32_t isw = min_sw; isw < max_sw; isw++) {
-        negTracks_sw.emplace_back(negTracks->sliceByCached(o2::aod::track::collisionId, isw, cache));
-        posTracks_sw.emplace_back(posTracks->sliceByCached(o2::aod::track::collisionId, isw, cache));
-        // npos += posTracks_sw.back().size();
-        // nneg += negTracks_sw.back().size();
-        // LOGF(info, "collision.globalIndex() = %d , posTracks_sw.back().size() = %d , negTracks_sw.back().size() = %d", collision.globalIndex(), posTracks_sw.back().size(), negTracks_sw.back().size());
+        auto negTracks_coll = negTracks->sliceByCached(o2::aod::track::collisionId, isw, cache);
+        auto posTracks_coll = posTracks->sliceByCached(o2::aod::track::collisionId, isw, cache);
+        for (const auto& track : negTracks_coll) {
+          if (isSelected(track)) {
+            negLegs.emplace_back(makeLeg(track, negLegs.size()));
+          }
+        }
+        for (const auto& track : posTracks_coll) {
+          if (isSelected(track)) {
+            posLegs.emplace_back(makeLeg(track, posLegs.size()));
+          }
+        }
       }
-      // LOGF(info, "min_sw = %d , max_sw = %d , collision.globalIndex() = %d , n posTracks_sw = %d , n negTracks_sw = %d", min_sw, max_sw, collision.globalIndex(), npos, nneg);
-
-      for (auto& negTracks_coll : negTracks_sw) {
-        for (auto& posTracks_coll : posTracks_sw) {
-          for (auto& [ele, pos] : combinations(CombinationsFullIndexPolicy(negTracks_coll, posTracks_coll))) {
-            if (!isSelected(ele) || !isSelected(pos)) {
-              continue;
-            }
-            if (!reconstructV0(ele, pos)) { // this is needed for speed-up.
-              continue;
-            }
-
-            for (int32_t isw = min_sw; isw < max_sw; isw++) {
-              auto collision_in_sw = collisions.rawIteratorAt(isw);
-
-              if (ele.isPVContributor() && isw != ele.collisionId()) {
-                continue;
-              }
-              if (pos.isPVContributor() && isw != pos.collisionId()) {
-                continue;
-              }
-
-              // LOGF(info, "pairing: collision_in_sw.globalIndex() = %d , ele.collisionId() = %d , pos.collisionId() = %d ele.globalIndex() = %d , pos.globalIndex() = %d",
-              //     collision_in_sw.globalIndex(), ele.collisionId(), pos.collisionId(), ele.globalIndex(), pos.globalIndex());
-              fillV0Table(collision_in_sw, ele, pos, false);
-            } // end of searching window loop
-          }   // end of pairing loop
-        }     // end of pos track loop in sw
-      }       // end of pos track loop in sw
+      // LOGF(info, "min_sw = %d , max_sw = %d , collision.globalIndex() = %d , n posLegs = %d , n negLegs = %d", min_sw, max_sw, collision.globalIndex(), posLegs.size(), negLegs.size());
+
+      forEachLegPair([&](const Leg& negLeg, const Leg& posLeg) {
+        auto ele = tracks.rawIteratorAt(negLeg.index);
+        auto pos = tracks.rawIteratorAt(posLeg.index);
+        if (!reconstructV0(ele, pos)) { // this is needed for speed-up.
+          return;
+        }
+
+        for (int32_t isw = min_sw; isw < max_sw; isw++) {
+          auto collision_in_sw = collisions.rawIteratorAt(isw);
+
+          if (ele.isPVContributor() && isw != ele.collisionId()) {
+            continue;
+          }
+          if (pos.isPVContributor() && isw != pos.collisionId()) {
+            continue;
+          }
+
+          // LOGF(info, "pairing: collision_in_sw.globalIndex() = %d , ele.collisionId() = %d , pos.collisionId() = %d ele.globalIndex() = %d , pos.globalIndex() = %d",
+          //     collision_in_sw.globalIndex(), ele.collisionId(), pos.collisionId(), ele.globalIndex(), pos.globalIndex());
+          fillV0Table(collision_in_sw, ele, pos, false);
+        } // end of searching window loop
+      }); // end of pairing loop
 
       // LOGF(info, "possible number of V0 = %d", cospa_map.size());
       std::map<std::pair<uint32_t, uint32_t>, bool> used_pair_map;
@@ -509,17 +559,13 @@ struct createPCM {
 
       pca_map.clear();
       cospa_map.clear();
-
-      negTracks_sw.clear();
-      posTracks_sw.clear();
-      negTracks_sw.shrink_to_fit();
-      posTracks_sw.shrink_to_fit();
     } // end of collision loop
 
   } // end of process
   PROCESS_SWITCH(createPCM, processSA, "create V0s with stand-alone way", true);
 
   Preslice<aod::TrackAssoc> trackIndicesPerCollision = aod::track_association::collisionId;
+  std::vector<std::tuple<int64_t, int64_t, int64_t, int64_t>> pairs; // positions of the legs in the associations, indices of the negative and positive tracks
   void processTrkCollAsso(aod::TrackAssoc const& trackIndices, FullTracksExtIU const& tracks, aod::Collisions const& collisions, aod::BCsWithTimestamps const&)
   {
     for (auto& collision : collisions) {
@@ -530,24 +576,25 @@ struct createPCM {
       auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, collision.globalIndex());
 
       // LOGF(info,"%d tracks in collision %d", trackIdsThisCollision.size(), collision.globalIndex());
-      for (auto& [eleId, posId] : combinations(CombinationsStrictlyUpperIndexPolicy(trackIdsThisCollision, trackIdsThisCollision))) {
-        auto ele = eleId.track_as<FullTracksExtIU>();
-        auto pos = posId.track_as<FullTracksExtIU>();
-        // LOGF(info,"eleId = %d , posId = %d", ele.globalIndex(), pos.globalIndex());
-
-        if (ele.sign() * pos.sign() > 0) { // reject same sign combination
-          continue;
-        }
-
-        if (!isSelected(ele) || !isSelected(pos)) {
-          continue;
+      negLegs.clear();
+      posLegs.clear();
+      int64_t order = 0;
+      for (auto& trackId : trackIdsThisCollision) {
+        auto track = trackId.track_as<FullTracksExtIU>();
+        if (isSelected(track)) {
+          (track.sign() < 0 ? negLegs : posLegs).emplace_back(makeLeg(track, order));
         }
+        order++;
+      }
 
-        if (ele.sign() < 0) {
-          fillV0Table(collision, ele, pos, true);
-        } else {
-          fillV0Table(collision, pos, ele, true);
-        }
+      // the pairs are fitted in the order of the track associations, as with the combinations of all the tracks
+      pairs.clear();
+      forEachLegPair([&](const Leg& negLeg, const Leg& posLeg) {
+        pairs.emplace_back(std::min(negLeg.order, posLeg.order), std::max(negLeg.order, posLeg.order), negLeg.index, posLeg.index);
+      });
+      std::sort(pairs.begin(), pairs.end());
+      for (const auto& [first, second, eleIndex, posIndex] : pairs) {
+        fillV0Table(collision, tracks.rawIteratorAt(eleIndex), tracks.rawIteratorAt(posIndex), true);
       }
     } // end of collision loop
   }   // end of process
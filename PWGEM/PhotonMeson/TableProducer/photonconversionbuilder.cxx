@@ -17,10 +17,13 @@
 
 #include <cmath>
 #include <array>
+#include <algorithm>
 #include <cstdlib>
-#include <map>
 #include <iterator>
+#include <set>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Math/Vector4D.h"
 
@@ -292,8 +295,24 @@ struct PhotonConversionBuilder {
            trackiu_x, trackiu_y, trackiu_z, track.tgl(), track.signed1Pt());
   }
 
+  // photon candidate passing the v0 cuts, kept until the closest and most aligned v0s are selected
+  struct V0Candidate {
+    int64_t v0Id;
+    int64_t collisionId;
+    int64_t posId;
+    int64_t eleId;
+    std::array<float, 3> pv;  // primary vertex of the collision
+    std::array<float, 3> xyz; // recalculated conversion point
+    float posdcaXY, posdcaZ, eledcaXY, eledcaZ;
+    float cospa, pca, rxy, v0pt, v0eta, v0phi, alpha, qt;
+    KFParticle gammaKF_DecayVtx;
+    KFParticle kfp_pos_DecayVtx;
+    KFParticle kfp_ele_DecayVtx;
+  };
+  std::vector<V0Candidate> v0candidates;
+
   template <bool isMC, class TCollision, class TTrack, typename TV0>
-  void fillV0Table(TV0 const& v0, const bool filltable)
+  void buildV0Candidate(TV0 const& v0)
   {
     // Get tracks
     auto pos = v0.template posTrack_as<TTrack>();
@@ -458,74 +477,109 @@ struct PhotonConversionBuilder {
     if (!checkAP(alpha, qt, max_alpha_ap, max_qt_ap)) { // store only photon conversions
       return;
     }
-    pca_map[std::make_tuple(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())] = pca_kf;
-    cospa_map[std::make_tuple(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())] = cospa_kf;
-
-    if (filltable) {
-      registry.fill(HIST("V0/hAP"), alpha, qt);
-      registry.fill(HIST("V0/hConversionPointXY"), gammaKF_DecayVtx.GetX(), gammaKF_DecayVtx.GetY());
-      registry.fill(HIST("V0/hConversionPointRZ"), gammaKF_DecayVtx.GetZ(), rxy);
-      registry.fill(HIST("V0/hPt"), v0pt);
-      registry.fill(HIST("V0/hEtaPhi"), v0phi, v0eta);
-      registry.fill(HIST("V0/hCosPA"), cospa_kf);
-      registry.fill(HIST("V0/hPCA"), pca_kf);
-
-      // calculate DCAxy,z to PV
-      float v0mom = RecoDecay::sqrtSumOfSquares(gammaKF_DecayVtx.GetPx(), gammaKF_DecayVtx.GetPy(), gammaKF_DecayVtx.GetPz());
-      float length = RecoDecay::sqrtSumOfSquares(gammaKF_DecayVtx.GetX() - collision.posX(), gammaKF_DecayVtx.GetY() - collision.posY(), gammaKF_DecayVtx.GetZ() - collision.posZ());
-      float dca_x_v0_to_pv = (gammaKF_DecayVtx.GetX() - gammaKF_DecayVtx.GetPx() * cospa_kf * length / v0mom) - collision.posX();
-      float dca_y_v0_to_pv = (gammaKF_DecayVtx.GetY() - gammaKF_DecayVtx.GetPy() * cospa_kf * length / v0mom) - collision.posY();
-      float dca_z_v0_to_pv = (gammaKF_DecayVtx.GetZ() - gammaKF_DecayVtx.GetPz() * cospa_kf * length / v0mom) - collision.posZ();
-      float sign_tmp = dca_x_v0_to_pv * dca_y_v0_to_pv > 0 ? +1.f : -1.f;
-      float dca_xy_v0_to_pv = RecoDecay::sqrtSumOfSquares(dca_x_v0_to_pv, dca_y_v0_to_pv) * sign_tmp;
-      registry.fill(HIST("V0/hDCAxyz"), dca_xy_v0_to_pv, dca_z_v0_to_pv);
-
-      float chi2kf = gammaKF_DecayVtx.GetChi2() / gammaKF_DecayVtx.GetNDF();
-
-      for (auto& leg : {kfp_pos_DecayVtx, kfp_ele_DecayVtx}) {
-        float legpt = RecoDecay::sqrtSumOfSquares(leg.GetPx(), leg.GetPy());
-        float legeta = RecoDecay::eta(std::array{leg.GetPx(), leg.GetPy(), leg.GetPz()});
-        float legphi = RecoDecay::phi(leg.GetPx(), leg.GetPy()) > 0.f ? RecoDecay::phi(leg.GetPx(), leg.GetPy()) : RecoDecay::phi(leg.GetPx(), leg.GetPy()) + TMath::TwoPi();
-        registry.fill(HIST("V0Leg/hPt"), legpt);
-        registry.fill(HIST("V0Leg/hEtaPhi"), legphi, legeta);
-      } // end of leg loop
-      for (auto& leg : {pos, ele}) {
-        registry.fill(HIST("V0Leg/hdEdx_Pin"), leg.tpcInnerParam(), leg.tpcSignal());
-        registry.fill(HIST("V0Leg/hTPCNsigmaEl"), leg.tpcInnerParam(), leg.tpcNSigmaEl());
-      } // end of leg loop
-      registry.fill(HIST("V0Leg/hDCAxyz"), posdcaXY, posdcaZ);
-      registry.fill(HIST("V0Leg/hDCAxyz"), eledcaXY, eledcaZ);
-
-      // ROOT::Math::PxPyPzMVector vpos_pv(kfp_pos_PV.GetPx(), kfp_pos_PV.GetPy(), kfp_pos_PV.GetPz(), o2::constants::physics::MassElectron);
-      // ROOT::Math::PxPyPzMVector vele_pv(kfp_ele_PV.GetPx(), kfp_ele_PV.GetPy(), kfp_ele_PV.GetPz(), o2::constants::physics::MassElectron);
-      // ROOT::Math::PxPyPzMVector v0_pv = vpos_pv + vele_pv;
-
-      ROOT::Math::PxPyPzMVector vpos_sv(kfp_pos_DecayVtx.GetPx(), kfp_pos_DecayVtx.GetPy(), kfp_pos_DecayVtx.GetPz(), o2::constants::physics::MassElectron);
-      ROOT::Math::PxPyPzMVector vele_sv(kfp_ele_DecayVtx.GetPx(), kfp_ele_DecayVtx.GetPy(), kfp_ele_DecayVtx.GetPz(), o2::constants::physics::MassElectron);
-      ROOT::Math::PxPyPzMVector v0_sv = vpos_sv + vele_sv;
-      // registry.fill(HIST("V0/hMee_SVPV"), v0_pv.M(), v0_sv.M());
-      registry.fill(HIST("V0/hMeeSV_Rxy"), rxy, v0_sv.M());
-      // registry.fill(HIST("V0/hMeePV_Rxy"), rxy, v0_pv.M());
-
-      v0photonskf(collision.globalIndex(), v0legs.lastIndex() + 1, v0legs.lastIndex() + 2,
-                  gammaKF_DecayVtx.GetX(), gammaKF_DecayVtx.GetY(), gammaKF_DecayVtx.GetZ(),
-                  gammaKF_DecayVtx.GetPx(), gammaKF_DecayVtx.GetPy(), gammaKF_DecayVtx.GetPz(),
-                  v0_sv.M(), dca_xy_v0_to_pv, dca_z_v0_to_pv,
-                  cospa_kf, pca_kf, alpha, qt, chi2kf);
-
-      fFuncTableV0Recalculated(xyz[0], xyz[1], xyz[2]);
-      fillTrackTable(pos, kfp_pos_DecayVtx, posdcaXY, posdcaZ); // positive leg first
-      fillTrackTable(ele, kfp_ele_DecayVtx, eledcaXY, eledcaZ); // negative leg second
-    }                                                           // end of fill table
+    v0candidates.push_back({v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex(),
+                            {collision.posX(), collision.posY(), collision.posZ()}, {xyz[0], xyz[1], xyz[2]},
+                            posdcaXY, posdcaZ, eledcaXY, eledcaZ,
+                            cospa_kf, pca_kf, rxy, v0pt, v0eta, v0phi, alpha, qt,
+                            gammaKF_DecayVtx, kfp_pos_DecayVtx, kfp_ele_DecayVtx});
+  }
+
+  template <class TTrack, typename TV0>
+  void fillV0Table(TV0 const& v0, V0Candidate const& candidate)
+  {
+    auto pos = v0.template posTrack_as<TTrack>();
+    auto ele = v0.template negTrack_as<TTrack>();
+    auto const& gammaKF_DecayVtx = candidate.gammaKF_DecayVtx;
+    auto const& kfp_pos_DecayVtx = candidate.kfp_pos_DecayVtx;
+    auto const& kfp_ele_DecayVtx = candidate.kfp_ele_DecayVtx;
+    auto const& pv = candidate.pv;
+    float cospa_kf = candidate.cospa;
+    float pca_kf = candidate.pca;
+    float rxy = candidate.rxy;
+    float alpha = candidate.alpha;
+    float qt = candidate.qt;
+
+    registry.fill(HIST("V0/hAP"), alpha, qt);
+    registry.fill(HIST("V0/hConversionPointXY"), gammaKF_DecayVtx.GetX(), gammaKF_DecayVtx.GetY());
+    registry.fill(HIST("V0/hConversionPointRZ"), gammaKF_DecayVtx.GetZ(), rxy);
+    registry.fill(HIST("V0/hPt"), candidate.v0pt);
+    registry.fill(HIST("V0/hEtaPhi"), candidate.v0phi, candidate.v0eta);
+    registry.fill(HIST("V0/hCosPA"), cospa_kf);
+    registry.fill(HIST("V0/hPCA"), pca_kf);
+
+    // calculate DCAxy,z to PV
+    float v0mom = RecoDecay::sqrtSumOfSquares(gammaKF_DecayVtx.GetPx(), gammaKF_DecayVtx.GetPy(), gammaKF_DecayVtx.GetPz());
+    float length = RecoDecay::sqrtSumOfSquares(gammaKF_DecayVtx.GetX() - pv[0], gammaKF_DecayVtx.GetY() - pv[1], gammaKF_DecayVtx.GetZ() - pv[2]);
+    float dca_x_v0_to_pv = (gammaKF_DecayVtx.GetX() - gammaKF_DecayVtx.GetPx() * cospa_kf * length / v0mom) - pv[0];
+    float dca_y_v0_to_pv = (gammaKF_DecayVtx.GetY() - gammaKF_DecayVtx.GetPy() * cospa_kf * length / v0mom) - pv[1];
+    float dca_z_v0_to_pv = (gammaKF_DecayVtx.GetZ() - gammaKF_DecayVtx.GetPz() * cospa_kf * length / v0mom) - pv[2];
+    float sign_tmp = dca_x_v0_to_pv * dca_y_v0_to_pv > 0 ? +1.f : -1.f;
+    float dca_xy_v0_to_pv = RecoDecay::sqrtSumOfSquares(dca_x_v0_to_pv, dca_y_v0_to_pv) * sign_tmp;
+    registry.fill(HIST("V0/hDCAxyz"), dca_xy_v0_to_pv, dca_z_v0_to_pv);
+
+    float chi2kf = gammaKF_DecayVtx.GetChi2() / gammaKF_DecayVtx.GetNDF();
+
+    for (auto& leg : {kfp_pos_DecayVtx, kfp_ele_DecayVtx}) {
+      float legpt = RecoDecay::sqrtSumOfSquares(leg.GetPx(), leg.GetPy());
+      float legeta = RecoDecay::eta(std::array{leg.GetPx(), leg.GetPy(), leg.GetPz()});
+      float legphi = RecoDecay::phi(leg.GetPx(), leg.GetPy()) > 0.f ? RecoDecay::phi(leg.GetPx(), leg.GetPy()) : RecoDecay::phi(leg.GetPx(), leg.GetPy()) + TMath::TwoPi();
+      registry.fill(HIST("V0Leg/hPt"), legpt);
+      registry.fill(HIST("V0Leg/hEtaPhi"), legphi, legeta);
+    } // end of leg loop
+    for (auto& leg : {pos, ele}) {
+      registry.fill(HIST("V0Leg/hdEdx_Pin"), leg.tpcInnerParam(), leg.tpcSignal());
+      registry.fill(HIST("V0Leg/hTPCNsigmaEl"), leg.tpcInnerParam(), leg.tpcNSigmaEl());
+    } // end of leg loop
+    registry.fill(HIST("V0Leg/hDCAxyz"), candidate.posdcaXY, candidate.posdcaZ);
+    registry.fill(HIST("V0Leg/hDCAxyz"), candidate.eledcaXY, candidate.eledcaZ);
+
+    // ROOT::Math::PxPyPzMVector vpos_pv(kfp_pos_PV.GetPx(), kfp_pos_PV.GetPy(), kfp_pos_PV.GetPz(), o2::constants::physics::MassElectron);
+    // ROOT::Math::PxPyPzMVector vele_pv(kfp_ele_PV.GetPx(), kfp_ele_PV.GetPy(), kfp_ele_PV.GetPz(), o2::constants::physics::MassElectron);
+    // ROOT::Math::PxPyPzMVector v0_pv = vpos_pv + vele_pv;
+
+    ROOT::Math::PxPyPzMVector vpos_sv(kfp_pos_DecayVtx.GetPx(), kfp_pos_DecayVtx.GetPy(), kfp_pos_DecayVtx.GetPz(), o2::constants::physics::MassElectron);
+    ROOT::Math::PxPyPzMVector vele_sv(kfp_ele_DecayVtx.GetPx(), kfp_ele_DecayVtx.GetPy(), kfp_ele_DecayVtx.GetPz(), o2::constants::physics::MassElectron);
+    ROOT::Math::PxPyPzMVector v0_sv = vpos_sv + vele_sv;
+    // registry.fill(HIST("V0/hMee_SVPV"), v0_pv.M(), v0_sv.M());
+    registry.fill(HIST("V0/hMeeSV_Rxy"), rxy, v0_sv.M());
+    // registry.fill(HIST("V0/hMeePV_Rxy"), rxy, v0_pv.M());
+
+    v0photonskf(candidate.collisionId, v0legs.lastIndex() + 1, v0legs.lastIndex() + 2,
+                gammaKF_DecayVtx.GetX(), gammaKF_DecayVtx.GetY(), gammaKF_DecayVtx.GetZ(),
+                gammaKF_DecayVtx.GetPx(), gammaKF_DecayVtx.GetPy(), gammaKF_DecayVtx.GetPz(),
+                v0_sv.M(), dca_xy_v0_to_pv, dca_z_v0_to_pv,
+                cospa_kf, pca_kf, alpha, qt, chi2kf);
+
+    fFuncTableV0Recalculated(candidate.xyz[0], candidate.xyz[1], candidate.xyz[2]);
+    fillTrackTable(pos, kfp_pos_DecayVtx, candidate.posdcaXY, candidate.posdcaZ); // positive leg first
+    fillTrackTable(ele, kfp_ele_DecayVtx, candidate.eledcaXY, candidate.eledcaZ); // negative leg second
   }
 
   Preslice<aod::V0s> perCollision = o2::aod::v0::collisionId;
-  std::map<std::tuple<int64_t, int64_t, int64_t, int64_t>, float> pca_map;   //(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex()) -> pca
-  std::map<std::tuple<int64_t, int64_t, int64_t, int64_t>, float> cospa_map; //(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex()) -> cospa
-  std::vector<std::pair<int64_t, int64_t>> stored_v0Ids;                     //(pos.globalIndex(), ele.globalIndex())
+  std::unordered_map<int64_t, std::vector<size_t>> v0candidates_per_pos; // pos.globalIndex() -> indices in v0candidates
+  std::unordered_map<int64_t, std::vector<size_t>> v0candidates_per_ele; // ele.globalIndex() -> indices in v0candidates
+  std::set<std::pair<int64_t, int64_t>> stored_v0Ids;                    //(pos.globalIndex(), ele.globalIndex())
+
+  // a candidate is rejected by another one sharing a leg with a smaller pca, or sharing both legs in another collision with a larger cospa
+  bool isBestV0Candidate(V0Candidate const& candidate, std::vector<size_t> const& others)
+  {
+    for (const auto& index : others) {
+      const auto& other = v0candidates[index];
+      if (candidate.v0Id == other.v0Id) { // skip exactly the same v0
+        continue;
+      }
+      if (candidate.collisionId != other.collisionId && candidate.eleId == other.eleId && candidate.posId == other.posId && candidate.cospa < other.cospa) { // same ele and pos, but attached to different collision
+        return false;
+      }
+      if (candidate.pca > other.pca) {
+        return false;
+      }
+    }
+    return true;
+  }
 
   template <bool isMC, typename TCollisions, typename TV0s, typename TTracks, typename TBCs>
-  void build(TCollisions const& collisions, TV0s const& v0s, TTracks const& tracks, TBCs const&)
+  void build(TCollisions const& collisions, TV0s const& v0s, TTracks const&, TBCs const&)
   {
     for (auto& collision : collisions) {
       if constexpr (isMC) {
@@ -542,64 +596,32 @@ struct PhotonConversionBuilder {
       // LOGF(info, "n v0 = %d", v0s_per_coll.size());
       for (auto& v0 : v0s_per_coll) {
         // LOGF(info, "collision.globalIndex() = %d, v0.globalIndex() = %d, v0.posTrackId() = %d, v0.negTrackId() = %d", collision.globalIndex(), v0.globalIndex(), v0.posTrackId() , v0.negTrackId());
-        fillV0Table<isMC, TCollisions, TTracks>(v0, false);
+        buildV0Candidate<isMC, TCollisions, TTracks>(v0);
       } // end of v0 loop
     }   // end of collision loop
 
-    stored_v0Ids.reserve(pca_map.size()); // number of photon candidates per DF
-
-    // find minimal pca
-    for (const auto& [key, value] : pca_map) {
-      auto v0Id = std::get<0>(key);
-      auto collisionId = std::get<1>(key);
-      auto posId = std::get<2>(key);
-      auto eleId = std::get<3>(key);
-      float v0pca = value;
-      float cospa = cospa_map[key];
-      bool is_closest_v0 = true;
-      bool is_most_aligned_v0 = true;
-
-      for (const auto& [key_tmp, value_tmp] : pca_map) {
-        auto v0Id_tmp = std::get<0>(key_tmp);
-        auto collisionId_tmp = std::get<1>(key_tmp);
-        auto posId_tmp = std::get<2>(key_tmp);
-        auto eleId_tmp = std::get<3>(key_tmp);
-        float v0pca_tmp = value_tmp;
-        float cospa_tmp = cospa_map[key_tmp];
-
-        if (v0Id == v0Id_tmp) { // skip exactly the same v0
-          continue;
-        }
-
-        if (collisionId != collisionId_tmp && eleId == eleId_tmp && posId == posId_tmp && cospa < cospa_tmp) { // same ele and pos, but attached to different collision
-          // LOGF(info, "!reject! | collision id = %d | posid1 = %d , eleid1 = %d , posid2 = %d , eleid2 = %d , cospa1 = %f , cospa2 = %f", collisionId, posId, eleId, posId_tmp, eleId_tmp, cospa, cospa_tmp);
-          is_most_aligned_v0 = false;
-          break;
-        }
+    // the table is filled in the order of v0 ids
+    std::sort(v0candidates.begin(), v0candidates.end(), [](const V0Candidate& a, const V0Candidate& b) { return a.v0Id < b.v0Id; });
+    for (size_t i = 0; i < v0candidates.size(); i++) {
+      v0candidates_per_pos[v0candidates[i].posId].emplace_back(i);
+      v0candidates_per_ele[v0candidates[i].eleId].emplace_back(i);
+    }
 
-        if ((eleId == eleId_tmp || posId == posId_tmp) && v0pca > v0pca_tmp) {
-          // LOGF(info, "!reject! | collision id = %d | posid1 = %d , eleid1 = %d , posid2 = %d , eleid2 = %d , pca1 = %f , pca2 = %f", collisionId, posId, eleId, posId_tmp, eleId_tmp, v0pca, v0pca_tmp);
-          is_closest_v0 = false;
-          break;
-        }
-      } // end of pca_map tmp loop
-
-      bool is_stored = std::find(stored_v0Ids.begin(), stored_v0Ids.end(), std::make_pair(posId, eleId)) != stored_v0Ids.end();
-      if (is_closest_v0 && is_most_aligned_v0 && !is_stored) {
-        auto v0 = v0s.rawIteratorAt(v0Id);
-        // auto collision = collisions.rawIteratorAt(collisionId);
-        // auto pos = tracks.rawIteratorAt(posId);
-        // auto ele = tracks.rawIteratorAt(eleId);
-        // LOGF(info, "!accept! | collision id = %d | v0id1 = %d , posid1 = %d , eleid1 = %d , pca1 = %f , cospa = %f", collisionId, v0Id, posId, eleId, v0pca, cospa);
-        fillV0Table<isMC, TCollisions, TTracks>(v0, true);
-        stored_v0Ids.emplace_back(std::make_pair(posId, eleId));
+    // find minimal pca among the candidates sharing a leg
+    for (const auto& candidate : v0candidates) {
+      if (!isBestV0Candidate(candidate, v0candidates_per_pos[candidate.posId]) || !isBestV0Candidate(candidate, v0candidates_per_ele[candidate.eleId])) {
+        continue;
+      }
+      if (stored_v0Ids.insert(std::make_pair(candidate.posId, candidate.eleId)).second) {
+        // LOGF(info, "!accept! | collision id = %d | v0id1 = %d , posid1 = %d , eleid1 = %d , pca1 = %f , cospa = %f", candidate.collisionId, candidate.v0Id, candidate.posId, candidate.eleId, candidate.pca, candidate.cospa);
+        fillV0Table<TTracks>(v0s.rawIteratorAt(candidate.v0Id), candidate);
       }
-    } // end of pca_map loop
-    // LOGF(info, "pca_map.size() = %d", pca_map.size());
-    pca_map.clear();
-    cospa_map.clear();
+    } // end of candidate loop
+    // LOGF(info, "v0candidates.size() = %d", v0candidates.size());
+    v0candidates.clear();
+    v0candidates_per_pos.clear();
+    v0candidates_per_ele.clear();
     stored_v0Ids.clear();
-    stored_v0Ids.shrink_to_fit();
   } // end of build
 
   void processRec(MyCollisions const& collisions, aod::V0s const& v0s, MyTracksIU const& tracks, aod::BCsWithTimestamps const& bcs)
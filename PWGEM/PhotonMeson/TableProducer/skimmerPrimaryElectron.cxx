@@ -12,7 +12,8 @@
 /// \brief write relevant information for dalitz ee analysis to an AO2D.root file. This file is then the only necessary input to perform pcm analysis.
 /// \author daiki.sekihata@cern.ch
 
-#include <map>
+#include <unordered_set>
+#include <vector>
 #include "Math/Vector4D.h"
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
@@ -253,6 +254,9 @@ struct skimmerPrimaryElectron {
       if (!checkTrack<isMC>(track)) {
         continue;
       }
+      if (isElectron(track)) {
+        selected_trackIds.insert(track.globalIndex());
+      }
       fRegistry.fill(HIST("Track/hTPCdEdx_Pin_before"), track.tpcInnerParam(), track.tpcSignal());
       fRegistry.fill(HIST("Track/hTOFbeta_Pin_before"), track.tpcInnerParam(), track.beta());
       fRegistry.fill(HIST("Track/hTPCNsigmaEl_before"), track.tpcInnerParam(), track.tpcNSigmaEl());
@@ -267,8 +271,7 @@ struct skimmerPrimaryElectron {
   template <typename TTrack>
   void fillTrackTable(TTrack const& track)
   {
-    // bool is_stored = std::find(stored_trackIds.begin(), stored_trackIds.end(), track.globalIndex()) != stored_trackIds.end();
-    if (std::find(stored_trackIds.begin(), stored_trackIds.end(), track.globalIndex()) == stored_trackIds.end()) {
+    if (stored_trackIds.insert(track.globalIndex()).second) {
       emprimaryelectrons(track.collisionId(), track.globalIndex(), track.sign(),
                          track.pt(), track.eta(), track.phi(), track.dcaXY(), track.dcaZ(),
                          track.tpcNClsFindable(), track.tpcNClsFindableMinusFound(), track.tpcNClsFindableMinusCrossedRows(),
@@ -284,19 +287,16 @@ struct skimmerPrimaryElectron {
       fRegistry.fill(HIST("Track/hTOFNsigmaMu_after"), track.tpcInnerParam(), track.tofNSigmaMu());
       fRegistry.fill(HIST("Track/hTPCNsigmaPi_after"), track.tpcInnerParam(), track.tpcNSigmaPi());
       fRegistry.fill(HIST("Track/hTOFNsigmaPi_after"), track.tpcInnerParam(), track.tofNSigmaPi());
-      stored_trackIds.emplace_back(track.globalIndex());
     }
   }
 
+  // pairs are built from the tracks selected in fillTrackHistogram, where the track and PID cuts are evaluated once per track
   template <bool isMC, EM_EEPairType pairtype, typename TCollision, typename TTracks1, typename TTracks2>
   void fillPairInfo(TCollision const& collision, TTracks1 const& tracks1, TTracks2 const& tracks2)
   {
     if constexpr (pairtype == EM_EEPairType::kULS) { // ULS
       for (auto& [t1, t2] : combinations(CombinationsFullIndexPolicy(tracks1, tracks2))) {
-        if (!checkTrack<isMC>(t1) || !checkTrack<isMC>(t2)) {
-          continue;
-        }
-        if (!isElectron(t1) || !isElectron(t2)) {
+        if (!selected_trackIds.count(t1.globalIndex()) || !selected_trackIds.count(t2.globalIndex())) {
           continue;
         }
 
@@ -314,10 +314,7 @@ struct skimmerPrimaryElectron {
       }      // end of pairing loop
     } else { // LS
       for (auto& [t1, t2] : combinations(CombinationsStrictlyUpperIndexPolicy(tracks1, tracks2))) {
-        if (!checkTrack<isMC>(t1) || !checkTrack<isMC>(t2)) {
-          continue;
-        }
-        if (!isElectron(t1) || !isElectron(t2)) {
+        if (!selected_trackIds.count(t1.globalIndex()) || !selected_trackIds.count(t2.globalIndex())) {
           continue;
         }
 
@@ -335,7 +332,8 @@ struct skimmerPrimaryElectron {
   }
 
   // ============================ FUNCTION DEFINITIONS ====================================================
-  std::vector<uint64_t> stored_trackIds;
+  std::unordered_set<int64_t> selected_trackIds; // tracks passing the track and PID cuts
+  std::unordered_set<int64_t> stored_trackIds;
 
   Filter trackFilter = o2::aod::track::pt > minpt&& nabs(o2::aod::track::eta) < maxeta&& nabs(o2::aod::track::dcaXY) < dca_xy_max&& nabs(o2::aod::track::dcaZ) < dca_z_max&& o2::aod::track::tpcChi2NCl < maxchi2tpc&& o2::aod::track::itsChi2NCl < maxchi2its;
   Filter pidFilter = minTPCNsigmaEl < o2::aod::pidtpc::tpcNSigmaEl && o2::aod::pidtpc::tpcNSigmaEl < maxTPCNsigmaEl && ((0.95f < o2::aod::pidtofbeta::beta && o2::aod::pidtofbeta::beta < 1.05f) || o2::aod::pidtofbeta::beta < 0.f);
@@ -363,8 +361,8 @@ struct skimmerPrimaryElectron {
       }
     } // end of collision loop
 
+    selected_trackIds.clear();
     stored_trackIds.clear();
-    stored_trackIds.shrink_to_fit();
   }
   PROCESS_SWITCH(skimmerPrimaryElectron, processRec, "process reconstructed info only", true);
 
@@ -395,8 +393,8 @@ struct skimmerPrimaryElectron {
       }
     } // end of collision loop
 
+    selected_trackIds.clear();
     stored_trackIds.clear();
-    stored_trackIds.shrink_to_fit();
   }
   PROCESS_SWITCH(skimmerPrimaryElectron, processMC, "process reconstructed and MC info ", false);
 };
@@ -551,7 +549,7 @@ struct prefilterPrimaryElectron {
   Partition<MyFilteredTracks> posTracks = o2::aod::track::signed1Pt > 0.f && ncheckbit(aod::track::detectorMap, (uint8_t)o2::aod::track::ITS) == true;
   Partition<MyFilteredTracks> negTracks = o2::aod::track::signed1Pt < 0.f && ncheckbit(aod::track::detectorMap, (uint8_t)o2::aod::track::ITS) == true;
 
-  std::map<int, uint8_t> pfb_map; // map track.globalIndex -> prefilter bit
+  std::vector<uint8_t> pfb_map; // prefilter bit per EMPrimaryElectron, indexed by its globalIndex
 
   Partition<aod::EMPrimaryElectrons> positrons = o2::aod::emprimaryelectron::sign > 0;
   Partition<aod::EMPrimaryElectrons> electrons = o2::aod::emprimaryelectron::sign < 0;
@@ -559,6 +557,7 @@ struct prefilterPrimaryElectron {
   template <typename TCollisions, typename TTracks, typename TEMPrimaryElectrons>
   void runPrefilterPC(TCollisions const& collisions, aod::BCsWithTimestamps const&, TTracks const& tracks, TEMPrimaryElectrons const& primaryelectrons)
   {
+    pfb_map.assign(primaryelectrons.size(), 0);
     for (auto& collision : collisions) {
       auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
       initCCDB(bc);
@@ -569,41 +568,42 @@ struct prefilterPrimaryElectron {
       auto positrons_per_coll = positrons->sliceByCached(o2::aod::emprimaryelectron::collisionId, collision.globalIndex(), cache);
       auto electrons_per_coll = electrons->sliceByCached(o2::aod::emprimaryelectron::collisionId, collision.globalIndex(), cache);
 
-      for (auto& [ele, empos] : combinations(CombinationsFullIndexPolicy(negTracks_per_coll, positrons_per_coll))) {
-        auto pos = tracks.rawIteratorAt(empos.trackId()); // use rawIterator, if the table is filtered.
-        if (!checkTrack(ele)) {                           // track cut is applied to loose sample
+      for (auto& ele : negTracks_per_coll) {
+        if (!checkTrack(ele)) { // track cut is applied to loose sample, once per track
           continue;
         }
-        if (empos.trackId() == ele.globalIndex()) {
-          continue;
-        }
-
-        bool isPC = reconstructPC(collision, ele, pos);
-        if (isPC) {
-          pfb_map[empos.globalIndex()] |= (uint8_t(1) << static_cast<int>(EM_Electron_PF::kElFromPC));
+        for (auto& empos : positrons_per_coll) {
+          if (empos.trackId() == ele.globalIndex()) {
+            continue;
+          }
+          auto pos = tracks.rawIteratorAt(empos.trackId()); // use rawIterator, if the table is filtered.
+          bool isPC = reconstructPC(collision, ele, pos);
+          if (isPC) {
+            pfb_map[empos.globalIndex()] |= (uint8_t(1) << static_cast<int>(EM_Electron_PF::kElFromPC));
+          }
         }
       }
 
-      for (auto& [pos, emele] : combinations(CombinationsFullIndexPolicy(posTracks_per_coll, electrons_per_coll))) {
-        auto ele = tracks.rawIteratorAt(emele.trackId()); // use rawIterator, if the table is filtered.
-        if (!checkTrack(pos)) {                           // track cut is applied to loose sample
+      for (auto& pos : posTracks_per_coll) {
+        if (!checkTrack(pos)) { // track cut is applied to loose sample, once per track
           continue;
         }
-        if (emele.trackId() == pos.globalIndex()) {
-          continue;
-        }
-        bool isPC = reconstructPC(collision, ele, pos);
-        if (isPC) {
-          pfb_map[emele.globalIndex()] |= (uint8_t(1) << static_cast<int>(EM_Electron_PF::kElFromPC));
+        for (auto& emele : electrons_per_coll) {
+          if (emele.trackId() == pos.globalIndex()) {
+            continue;
+          }
+          auto ele = tracks.rawIteratorAt(emele.trackId()); // use rawIterator, if the table is filtered.
+          bool isPC = reconstructPC(collision, ele, pos);
+          if (isPC) {
+            pfb_map[emele.globalIndex()] |= (uint8_t(1) << static_cast<int>(EM_Electron_PF::kElFromPC));
+          }
         }
       }
     } // end of collision loop
 
-    for (auto& ele : primaryelectrons) {
-      ele_pfb(pfb_map[ele.globalIndex()]);
+    for (auto& pfb : pfb_map) {
+      ele_pfb(pfb);
     }
-
-    pfb_map.clear();
   }
 
   void processPrefilter(aod::Collisions const& collisions, aod::BCsWithTimestamps const& bcs, MyFilteredTracks const& tracks, aod::EMPrimaryElectrons const& primaryelectrons)
@@ -14,8 +14,10 @@
 // This code loops over v0 photons for studying material budget.
 //    Please write to: daiki.sekihata@cern.ch
 
+#include <algorithm>
 #include <cstring>
 #include <iterator>
+#include <vector>
 
 #include "TString.h"
 #include "Math/Vector4D.h"
@@ -31,6 +33,7 @@
 #include "Common/Core/RecoDecay.h"
 #include "PWGEM/PhotonMeson/DataModel/gammaTables.h"
 #include "PWGEM/PhotonMeson/Utils/PairUtilities.h"
+#include "PWGEM/PhotonMeson/Utils/SparseHistAccumulator.h"
 #include "PWGEM/PhotonMeson/Core/V0PhotonCut.h"
 #include "PWGEM/PhotonMeson/Core/PairCut.h"
 #include "PWGEM/PhotonMeson/Core/CutsLibrary.h"
@@ -42,6 +45,7 @@ using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::soa;
 using namespace o2::aod::photonpair;
+using o2::aod::emphotonhistograms::SparseHistAccumulator;
 
 using MyCollisions = soa::Join<aod::EMReducedEvents, aod::EMReducedEventsMult, aod::EMReducedEventsCent, aod::EMReducedEventsNgPCM>;
 using MyCollision = MyCollisions::iterator;
@@ -69,6 +73,11 @@ struct MaterialBudget {
   std::vector<V0PhotonCut> fProbeCuts;
   std::vector<PairCut> fPairCuts;
 
+  // fills of the conversion point histograms, added to them once per data frame
+  std::vector<SparseHistAccumulator> fConvPoint;     // per probe cut
+  std::vector<SparseHistAccumulator> fConvPointSame; // per tag cut, probe cut and pair cut
+  std::vector<SparseHistAccumulator> fConvPointMix;  // per tag cut, probe cut and pair cut
+
   std::vector<std::string> fPairNames;
   void init(InitContext& context)
   {
@@ -80,6 +89,7 @@ struct MaterialBudget {
     DefineProbeCuts();
     DefinePairCuts();
     addhistograms();
+    DefineAccumulators();
 
     fOutputEvent.setObject(reinterpret_cast<THashList*>(fMainList->FindObject("Event")));
     fOutputV0.setObject(reinterpret_cast<THashList*>(fMainList->FindObject("V0")));
@@ -148,6 +158,36 @@ struct MaterialBudget {
     } // end of pair name loop
   }
 
+  void DefineAccumulators()
+  {
+    THashList* list_v0 = reinterpret_cast<THashList*>(fMainList->FindObject("V0"));
+    for (const auto& cut : fProbeCuts) {
+      fConvPoint.emplace_back(reinterpret_cast<THnSparse*>(list_v0->FindObject(cut.GetName())->FindObject("hs_conv_point")));
+    }
+    if (std::find(fPairNames.begin(), fPairNames.end(), "PCMPCM") == fPairNames.end()) {
+      return;
+    }
+    THashList* list_pair_ss = reinterpret_cast<THashList*>(fMainList->FindObject("Pair")->FindObject("PCMPCM"));
+    for (const auto& tagcut : fTagCuts) {
+      for (const auto& probecut : fProbeCuts) {
+        for (const auto& paircut : fPairCuts) {
+          auto list_pair_cut = list_pair_ss->FindObject(Form("%s_%s", tagcut.GetName(), probecut.GetName()))->FindObject(paircut.GetName());
+          fConvPointSame.emplace_back(reinterpret_cast<THnSparse*>(list_pair_cut->FindObject("hs_conv_point_same")));
+          fConvPointMix.emplace_back(reinterpret_cast<THnSparse*>(list_pair_cut->FindObject("hs_conv_point_mix")));
+        }
+      }
+    }
+  }
+
+  void FlushAccumulators()
+  {
+    for (auto& accumulators : {&fConvPoint, &fConvPointSame, &fConvPointMix}) {
+      for (auto& accumulator : *accumulators) {
+        accumulator.Flush();
+      }
+    }
+  }
+
   void DefineTagCuts()
   {
     TString cutNamesStr = fConfigTagCuts.value;
@@ -202,7 +242,6 @@ struct MaterialBudget {
   void fillsinglephoton(TEvents const& collisions, TPhotons const& photons, TPreslice const& perCollision, TCuts const& cuts, TLegs const& legs)
   {
     THashList* list_ev_pair = static_cast<THashList*>(fMainList->FindObject("Event")->FindObject(pairnames[pairtype].data()));
-    THashList* list_v0 = static_cast<THashList*>(fMainList->FindObject("V0"));
     double value[4] = {0.f};
     for (auto& collision : collisions) {
       reinterpret_cast<TH1F*>(fMainList->FindObject("Event")->FindObject(pairnames[pairtype].data())->FindObject("hZvtx_before"))->Fill(collision.posZ());
@@ -223,7 +262,8 @@ struct MaterialBudget {
       o2::aod::emphotonhistograms::FillHistClass<EMHistType::kEvent>(list_ev_pair, "", collision);
 
       auto photons_coll = photons.sliceBy(perCollision, collision.globalIndex());
-      for (auto& cut : cuts) {
+      for (size_t icut = 0; icut < cuts.size(); icut++) {
+        auto& cut = cuts[icut];
         for (auto& photon : photons_coll) {
           if (!cut.template IsSelected<TLegs>(photon)) {
             continue;
@@ -235,7 +275,7 @@ struct MaterialBudget {
           value[1] = photon.v0radius();
           value[2] = phi_cp > 0 ? phi_cp : phi_cp + TMath::TwoPi();
           value[3] = eta_cp;
-          reinterpret_cast<THnSparseF*>(list_v0->FindObject(cut.GetName())->FindObject("hs_conv_point"))->Fill(value);
+          fConvPoint[icut].Fill(value);
 
         } // end of photon loop
       }   // end of cut loop
@@ -246,16 +286,16 @@ struct MaterialBudget {
   template <PairType pairtype, typename TEvents, typename TPhotons1, typename TPhotons2, typename TPreslice1, typename TPreslice2, typename TCuts1, typename TCuts2, typename TPairCuts, typename TLegs>
   void SameEventPairing(TEvents const& collisions, TPhotons1 const& photons1, TPhotons2 const& photons2, TPreslice1 const& perCollision1, TPreslice2 const& perCollision2, TCuts1 const& tagcuts, TCuts2 const& probecuts, TPairCuts const& paircuts, TLegs const& legs)
   {
-    THashList* list_pair_ss = static_cast<THashList*>(fMainList->FindObject("Pair")->FindObject(pairnames[pairtype].data()));
-
     for (auto& collision : collisions) {
       auto photons1_coll = photons1.sliceBy(perCollision1, collision.globalIndex());
       auto photons2_coll = photons2.sliceBy(perCollision2, collision.globalIndex());
 
       double value[6] = {0.f};
       float phi_cp2 = 0.f, eta_cp2 = 0.f;
-      for (auto& tagcut : tagcuts) {
-        for (auto& probecut : probecuts) {
+      for (size_t itagcut = 0; itagcut < tagcuts.size(); itagcut++) {
+        auto& tagcut = tagcuts[itagcut];
+        for (size_t iprobecut = 0; iprobecut < probecuts.size(); iprobecut++) {
+          auto& probecut = probecuts[iprobecut];
           for (auto& g1 : photons1_coll) {
             for (auto& g2 : photons2_coll) {
               if (g1.globalIndex() == g2.globalIndex()) {
@@ -264,8 +304,8 @@ struct MaterialBudget {
               if (!IsSelectedPair<pairtype>(g1, g2, tagcut, probecut)) {
                 continue;
               }
-              for (auto& paircut : paircuts) {
-                if (!paircut.IsSelected(g1, g2)) {
+              for (size_t ipaircut = 0; ipaircut < paircuts.size(); ipaircut++) {
+                if (!paircuts[ipaircut].IsSelected(g1, g2)) {
                   continue;
                 }
 
@@ -280,7 +320,7 @@ struct MaterialBudget {
                 value[3] = g2.v0radius();
                 value[4] = phi_cp2 > 0.f ? phi_cp2 : phi_cp2 + TMath::TwoPi();
                 value[5] = eta_cp2;
-                reinterpret_cast<THnSparseF*>(list_pair_ss->FindObject(Form("%s_%s", tagcut.GetName(), probecut.GetName()))->FindObject(paircut.GetName())->FindObject("hs_conv_point_same"))->Fill(value);
+                fConvPointSame[(itagcut * probecuts.size() + iprobecut) * paircuts.size() + ipaircut].Fill(value);
               } // end of pair cut loop
             }   // end of g2 loop
           }     // end of g1 loop
@@ -298,7 +338,6 @@ struct MaterialBudget {
   template <PairType pairtype, typename TEvents, typename TPhotons1, typename TPhotons2, typename TPreslice1, typename TPreslice2, typename TCuts1, typename TCuts2, typename TPairCuts, typename TLegs>
   void MixedEventPairing(TEvents const& collisions, TPhotons1 const& photons1, TPhotons2 const& photons2, TPreslice1 const& perCollision1, TPreslice2 const& perCollision2, TCuts1 const& tagcuts, TCuts2 const& probecuts, TPairCuts const& paircuts, TLegs const& legs)
   {
-    THashList* list_pair_ss = static_cast<THashList*>(fMainList->FindObject("Pair")->FindObject(pairnames[pairtype].data()));
     // LOGF(info, "Number of collisions after filtering: %d", collisions.size());
     for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, ndepth, -1, collisions, collisions)) { // internally, CombinationsStrictlyUpperIndexPolicy(collisions, collisions) is called.
 
@@ -312,8 +351,10 @@ struct MaterialBudget {
 
       double value[6] = {0.f};
       float phi_cp2 = 0.f, eta_cp2 = 0.f;
-      for (auto& tagcut : tagcuts) {
-        for (auto& probecut : probecuts) {
+      for (size_t itagcut = 0; itagcut < tagcuts.size(); itagcut++) {
+        auto& tagcut = tagcuts[itagcut];
+        for (size_t iprobecut = 0; iprobecut < probecuts.size(); iprobecut++) {
+          auto& probecut = probecuts[iprobecut];
           for (auto& g1 : photons_coll1) {
             for (auto& g2 : photons_coll2) {
               if (!IsSelectedPair<pairtype>(g1, g2, tagcut, probecut)) {
@@ -321,8 +362,8 @@ struct MaterialBudget {
               }
               // LOGF(info, "Mixed event photon pair: (%d, %d) from events (%d, %d), photon event: (%d, %d)", g1.index(), g2.index(), collision1.index(), collision2.index(), g1.globalIndex(), g2.globalIndex());
 
-              for (auto& paircut : paircuts) {
-                if (!paircut.IsSelected(g1, g2)) {
+              for (size_t ipaircut = 0; ipaircut < paircuts.size(); ipaircut++) {
+                if (!paircuts[ipaircut].IsSelected(g1, g2)) {
                   continue;
                 }
 
@@ -337,7 +378,7 @@ struct MaterialBudget {
                 value[3] = g2.v0radius();
                 value[4] = phi_cp2 > 0.f ? phi_cp2 : phi_cp2 + TMath::TwoPi();
                 value[5] = eta_cp2;
-                reinterpret_cast<THnSparseF*>(list_pair_ss->FindObject(Form("%s_%s", tagcut.GetName(), probecut.GetName()))->FindObject(paircut.GetName())->FindObject("hs_conv_point_mix"))->Fill(value);
+                fConvPointMix[(itagcut * probecuts.size() + iprobecut) * paircuts.size() + ipaircut].Fill(value);
 
               } // end of pair cut loop
             }   // end of g2 loop
@@ -359,6 +400,7 @@ struct MaterialBudget {
     if (fDoMixing) {
       MixedEventPairing<PairType::kPCMPCM>(filtered_collisions, v0photons, v0photons, perCollision_pcm, perCollision_pcm, fTagCuts, fProbeCuts, fPairCuts, legs);
     }
+    FlushAccumulators();
   }
 
   void processDummy(MyCollisions::iterator const& collision) {}
@@ -14,8 +14,10 @@
 // This code loops over v0 photons for studying material budget.
 //    Please write to: daiki.sekihata@cern.ch
 
+#include <algorithm>
 #include <cstring>
 #include <iterator>
+#include <vector>
 
 #include "TString.h"
 #include "Math/Vector4D.h"
@@ -31,6 +33,7 @@
 #include "Common/Core/RecoDecay.h"
 #include "PWGEM/PhotonMeson/DataModel/gammaTables.h"
 #include "PWGEM/PhotonMeson/Utils/PairUtilities.h"
+#include "PWGEM/PhotonMeson/Utils/SparseHistAccumulator.h"
 #include "PWGEM/PhotonMeson/Utils/MCUtilities.h"
 #include "PWGEM/PhotonMeson/Core/V0PhotonCut.h"
 #include "PWGEM/PhotonMeson/Core/PairCut.h"
@@ -43,6 +46,7 @@ using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::soa;
 using namespace o2::aod::photonpair;
+using o2::aod::emphotonhistograms::SparseHistAccumulator;
 
 using MyCollisions = soa::Join<aod::EMReducedEvents, aod::EMReducedEventsMult, aod::EMReducedEventsCent, aod::EMReducedEventsNgPCM>;
 using MyCollision = MyCollisions::iterator;
@@ -74,6 +78,10 @@ struct MaterialBudgetMC {
   std::vector<V0PhotonCut> fProbeCuts;
   std::vector<PairCut> fPairCuts;
 
+  // fills of the conversion point histograms, added to them once per data frame
+  std::vector<SparseHistAccumulator> fConvPoint;     // per probe cut
+  std::vector<SparseHistAccumulator> fConvPointSame; // per tag cut, probe cut and pair cut
+
   std::vector<std::string> fPairNames;
   void init(InitContext& context)
   {
@@ -85,6 +93,7 @@ struct MaterialBudgetMC {
     DefineProbeCuts();
     DefinePairCuts();
     addhistograms();
+    DefineAccumulators();
 
     fOutputEvent.setObject(reinterpret_cast<THashList*>(fMainList->FindObject("Event")));
     fOutputV0.setObject(reinterpret_cast<THashList*>(fMainList->FindObject("V0")));
@@ -163,6 +172,35 @@ struct MaterialBudgetMC {
     o2::aod::emphotonhistograms::DefineHistograms(list_gen, "Generated", "ConversionStudy");
   }
 
+  void DefineAccumulators()
+  {
+    THashList* list_v0 = reinterpret_cast<THashList*>(fMainList->FindObject("V0"));
+    for (const auto& cut : fProbeCuts) {
+      fConvPoint.emplace_back(reinterpret_cast<THnSparse*>(list_v0->FindObject(cut.GetName())->FindObject("hs_conv_point")));
+    }
+    if (std::find(fPairNames.begin(), fPairNames.end(), "PCMPCM") == fPairNames.end()) {
+      return;
+    }
+    THashList* list_pair_ss = reinterpret_cast<THashList*>(fMainList->FindObject("Pair")->FindObject("PCMPCM"));
+    for (const auto& tagcut : fTagCuts) {
+      for (const auto& probecut : fProbeCuts) {
+        for (const auto& paircut : fPairCuts) {
+          auto list_pair_cut = list_pair_ss->FindObject(Form("%s_%s", tagcut.GetName(), probecut.GetName()))->FindObject(paircut.GetName());
+          fConvPointSame.emplace_back(reinterpret_cast<THnSparse*>(list_pair_cut->FindObject("hs_conv_point_same")));
+        }
+      }
+    }
+  }
+
+  void FlushAccumulators()
+  {
+    for (auto& accumulators : {&fConvPoint, &fConvPointSame}) {
+      for (auto& accumulator : *accumulators) {
+        accumulator.Flush();
+      }
+    }
+  }
+
   void DefineTagCuts()
   {
     TString cutNamesStr = fConfigTagCuts.value;
@@ -217,7 +255,6 @@ struct MaterialBudgetMC {
   void fillsinglephoton(TEvents const& collisions, TPhotons const& photons, TPreslice const& perCollision, TCuts const& cuts, TLegs const& legs, TMCParticles const& mcparticles, TMCEvents const&)
   {
     THashList* list_ev_pair = static_cast<THashList*>(fMainList->FindObject("Event")->FindObject(pairnames[pairtype].data()));
-    THashList* list_v0 = static_cast<THashList*>(fMainList->FindObject("V0"));
     double value[4] = {0.f};
     for (auto& collision : collisions) {
       reinterpret_cast<TH1F*>(fMainList->FindObject("Event")->FindObject(pairnames[pairtype].data())->FindObject("hZvtx_before"))->Fill(collision.posZ());
@@ -241,7 +278,8 @@ struct MaterialBudgetMC {
       o2::aod::emphotonhistograms::FillHistClass<EMHistType::kEvent>(list_ev_pair, "", collision);
 
       auto photons_coll = photons.sliceBy(perCollision, collision.globalIndex());
-      for (auto& cut : cuts) {
+      for (size_t icut = 0; icut < cuts.size(); icut++) {
+        auto& cut = cuts[icut];
         for (auto& photon : photons_coll) {
 
           if (!cut.template IsSelected<TLegs>(photon)) {
@@ -269,7 +307,7 @@ struct MaterialBudgetMC {
           value[1] = photon.v0radius();
           value[2] = phi_cp > 0 ? phi_cp : phi_cp + TMath::TwoPi();
           value[3] = eta_cp;
-          reinterpret_cast<THnSparseF*>(list_v0->FindObject(cut.GetName())->FindObject("hs_conv_point"))->Fill(value);
+          fConvPoint[icut].Fill(value);
 
         } // end of photon loop
       }   // end of cut loop
@@ -280,16 +318,16 @@ struct MaterialBudgetMC {
   template <PairType pairtype, typename TEvents, typename TPhotons1, typename TPhotons2, typename TPreslice1, typename TPreslice2, typename TCuts1, typename TCuts2, typename TPairCuts, typename TLegs, typename TMCParticles, typename TMCEvents>
   void TruePairing(TEvents const& collisions, TPhotons1 const& photons1, TPhotons2 const& photons2, TPreslice1 const& perCollision1, TPreslice2 const& perCollision2, TCuts1 const& tagcuts, TCuts2 const& probecuts, TPairCuts const& paircuts, TLegs const& legs, TMCParticles const& mcparticles, TMCEvents const&)
   {
-    THashList* list_pair_ss = static_cast<THashList*>(fMainList->FindObject("Pair")->FindObject(pairnames[pairtype].data()));
-
     for (auto& collision : collisions) {
       auto photons1_coll = photons1.sliceBy(perCollision1, collision.globalIndex());
       auto photons2_coll = photons2.sliceBy(perCollision2, collision.globalIndex());
 
       double value[6] = {0.f};
       float phi_cp2 = 0.f, eta_cp2 = 0.f;
-      for (auto& tagcut : tagcuts) {
-        for (auto& probecut : probecuts) {
+      for (size_t itagcut = 0; itagcut < tagcuts.size(); itagcut++) {
+        auto& tagcut = tagcuts[itagcut];
+        for (size_t iprobecut = 0; iprobecut < probecuts.size(); iprobecut++) {
+          auto& probecut = probecuts[iprobecut];
           for (auto& g1 : photons1_coll) {
             for (auto& g2 : photons2_coll) {
               if (g1.globalIndex() == g2.globalIndex()) {
@@ -299,8 +337,8 @@ struct MaterialBudgetMC {
                 continue;
               }
 
-              for (auto& paircut : paircuts) {
-                if (!paircut.IsSelected(g1, g2)) {
+              for (size_t ipaircut = 0; ipaircut < paircuts.size(); ipaircut++) {
+                if (!paircuts[ipaircut].IsSelected(g1, g2)) {
                   continue;
                 }
 
@@ -347,7 +385,7 @@ struct MaterialBudgetMC {
                 value[3] = g2.v0radius();
                 value[4] = phi_cp2 > 0.f ? phi_cp2 : phi_cp2 + TMath::TwoPi();
                 value[5] = eta_cp2;
-                reinterpret_cast<THnSparseF*>(list_pair_ss->FindObject(Form("%s_%s", tagcut.GetName(), probecut.GetName()))->FindObject(paircut.GetName())->FindObject("hs_conv_point_same"))->Fill(value);
+                fConvPointSame[(itagcut * probecuts.size() + iprobecut) * paircuts.size() + ipaircut].Fill(value);
               } // end of pair cut loop
             }   // end of g2 loop
           }     // end of g1 loop
@@ -365,6 +403,7 @@ struct MaterialBudgetMC {
   {
     fillsinglephoton<PairType::kPCMPCM>(grouped_collisions, v0photons, perCollision_pcm, fProbeCuts, legs, mcparticles, mccollisions);
     TruePairing<PairType::kPCMPCM>(filtered_collisions, v0photons, v0photons, perCollision_pcm, perCollision_pcm, fTagCuts, fProbeCuts, fPairCuts, legs, mcparticles, mccollisions);
+    FlushAccumulators();
   }
 
   PresliceUnsorted<aod::EMMCParticles> perMcCollision = aod::emmcparticle::emreducedmceventId;
@@ -36,6 +36,7 @@
 #include "Common/DataModel/PIDResponse.h"
 #include "Common/Core/RecoDecay.h"
 #include "PWGEM/PhotonMeson/Utils/PairUtilities.h"
+#include "PWGEM/PhotonMeson/Utils/EventMixingPool.h"
 #include "PWGEM/PhotonMeson/DataModel/gammaTables.h"
 #include "PWGEM/PhotonMeson/Core/V0PhotonCut.h"
 #include "PWGEM/PhotonMeson/Core/DalitzEECut.h"
@@ -69,6 +70,7 @@ struct PhotonHBT {
   Configurable<std::string> fConfigDalitzEECuts{"cfgDalitzEECuts", "mee_all_tpchadrejortofreq_prompt", "Comma separated list of DalitzEE cuts"};
   Configurable<std::string> fConfigPHOSCuts{"cfgPHOSCuts", "test02,test03", "Comma separated list of PHOS photon cuts"};
   Configurable<std::string> fConfigPairCuts{"cfgPairCuts", "nocut", "Comma separated list of pair cuts"};
+  Configurable<float> maxQinv{"maxQinv", 0.4, "pairs with a larger qinv, i.e. in the overflow of the q histograms, are not filled. no limit if negative"};
 
   OutputObj<THashList> fOutputEvent{"Event"};
   OutputObj<THashList> fOutputPair{"Pair"}; // 2-photon pair
@@ -99,6 +101,11 @@ struct PhotonHBT {
     DefineDalitzEECuts();
     DefinePHOSCuts();
     DefinePairCuts();
+    for (auto ncuts : {fPCMCuts.size(), fDalitzEECuts.size(), fPHOSCuts.size(), fPairCuts.size()}) {
+      if (ncuts > kMaxNCuts) {
+        LOGF(fatal, "At most %d cuts per category are supported, %d given", kMaxNCuts, ncuts);
+      }
+    }
     addhistograms();
 
     fOutputEvent.setObject(reinterpret_cast<THashList*>(fMainList->FindObject("Event")));
@@ -243,6 +250,18 @@ struct PhotonHBT {
     return is_selected_pair;
   }
 
+  // values[2-8] of the hs_q_same and hs_q_mix histograms
+  void SetHBTValues(double* values, HBTPairVariables const& vars)
+  {
+    values[2] = vars.kt;
+    values[3] = vars.qinv;
+    values[4] = vars.qlong_cms;
+    values[5] = vars.qout_cms;
+    values[6] = vars.qside_cms;
+    values[7] = vars.qt_cms;
+    values[8] = vars.qlong_lcms;
+  }
+
   template <PairType pairtype, typename TEvents, typename TPhotons1, typename TPhotons2, typename TPreslice1, typename TPreslice2, typename TCuts1, typename TCuts2, typename TPairCuts, typename TLegs, typename TEMPrimaryElectrons>
   void SameEventPairing(TEvents const& collisions, TPhotons1 const& photons1, TPhotons2 const& photons2, TPreslice1 const& perCollision1, TPreslice2 const& perCollision2, TCuts1 const& cuts1, TCuts2 const& cuts2, TPairCuts const& paircuts, TLegs const& legs, TEMPrimaryElectrons const& emprimaryelectrons)
   {
@@ -288,51 +307,16 @@ struct PhotonHBT {
 
               values[0] = 0.0;
               values[1] = 0.0;
-              // center-of-mass system (CMS)
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
+              float m2 = 0.f;
               if constexpr (pairtype == PairType::kPCMDalitzEE) {
-                v2.SetM(g2.mass());
+                m2 = g2.mass();
                 values[1] = g2.mass();
               }
-              ROOT::Math::PtEtaPhiMVector q12 = v1 - v2;
-              ROOT::Math::PtEtaPhiMVector k12 = 0.5 * (v1 + v2);
-              float qinv = -q12.M();
-              float kt = k12.Pt();
-              float qt = q12.Pt();
-              float qlong_cms = q12.Pz();
-
-              ROOT::Math::XYZVector q_3d = q12.Vect();                                   // 3D q vector
-              ROOT::Math::XYZVector uv_out(k12.Px() / k12.Pt(), k12.Py() / k12.Pt(), 0); // unit vector for out. i.e. parallel to kt
-              ROOT::Math::XYZVector uv_long(0, 0, 1);                                    // unit vector for long, beam axis
-              ROOT::Math::XYZVector uv_side = uv_out.Cross(uv_long);                     // unit vector for side
-              float qout_cms = q_3d.Dot(uv_out);
-              float qside_cms = q_3d.Dot(uv_side);
-
-              // longitudinally co-moving system (LCMS)
-              ROOT::Math::PxPyPzEVector v1_cartesian(v1.Px(), v1.Py(), v1.Pz(), v1.E());
-              ROOT::Math::PxPyPzEVector v2_cartesian(v2.Px(), v2.Py(), v2.Pz(), v2.E());
-              ROOT::Math::PxPyPzEVector q12_cartesian = v1_cartesian - v2_cartesian;
-              float beta_z = (v1 + v2).Pz() / (v1 + v2).E();
-              ROOT::Math::Boost bst_z(0, 0, -beta_z); // Boost supports only PxPyPzEVector
-              ROOT::Math::PxPyPzEVector q12_lcms = bst_z(q12_cartesian);
-              float qlong_lcms = q12_lcms.Pz();
-
-              // ROOT::Math::PxPyPzEVector v1_lcms_cartesian = bst_z(v1_cartesian);
-              // ROOT::Math::PxPyPzEVector v2_lcms_cartesian = bst_z(v2_cartesian);
-              // ROOT::Math::PxPyPzEVector q12_lcms_cartesian = bst_z(q12_cartesian);
-              // LOGF(info, "q12.Pz() = %f, q12_cartesian.Pz() = %f",q12.Pz(), q12_cartesian.Pz());
-              // LOGF(info, "v1.Pz() = %f, v2.Pz() = %f",v1.Pz(), v2.Pz());
-              // LOGF(info, "v1_lcms_cartesian.Pz() = %f, v2_lcms_cartesian.Pz() = %f",v1_lcms_cartesian.Pz(), v2_lcms_cartesian.Pz());
-              // LOGF(info, "q12_lcms_cartesian.Pz() = %f", q12_lcms_cartesian.Pz());
-
-              values[2] = kt;
-              values[3] = qinv;
-              values[4] = qlong_cms;
-              values[5] = qout_cms;
-              values[6] = qside_cms;
-              values[7] = qt;
-              values[8] = qlong_lcms;
+              HBTPairVariables vars;
+              if (!GetHBTPairVariables(g1.pt(), g1.eta(), g1.phi(), 0.f, g2.pt(), g2.eta(), g2.phi(), m2, maxQinv, vars)) {
+                continue;
+              }
+              SetHBTValues(values, vars);
               reinterpret_cast<THnSparseF*>(list_pair_ss->FindObject(Form("%s_%s", cut.GetName(), cut.GetName()))->FindObject(paircut.GetName())->FindObject("hs_q_same"))->Fill(values);
             }  // end of combination
           }    // end of pair cut loop
@@ -358,43 +342,16 @@ struct PhotonHBT {
 
                 values[0] = 0.0;
                 values[1] = 0.0;
-                // center-of-mass system (CMS)
-                ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-                ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
+                float m2 = 0.f;
                 if constexpr (pairtype == PairType::kPCMDalitzEE) {
-                  v2.SetM(g2.mass());
+                  m2 = g2.mass();
                   values[1] = g2.mass();
                 }
-                ROOT::Math::PtEtaPhiMVector q12 = v1 - v2;
-                ROOT::Math::PtEtaPhiMVector k12 = 0.5 * (v1 + v2);
-                float qinv = -q12.M();
-                float kt = k12.Pt();
-                float qt = q12.Pt();
-                float qlong_cms = q12.Pz();
-
-                ROOT::Math::XYZVector q_3d = q12.Vect();                                   // 3D q vector
-                ROOT::Math::XYZVector uv_out(k12.Px() / k12.Pt(), k12.Py() / k12.Pt(), 0); // unit vector for out. i.e. parallel to kt
-                ROOT::Math::XYZVector uv_long(0, 0, 1);                                    // unit vector for long, beam axis
-                ROOT::Math::XYZVector uv_side = uv_out.Cross(uv_long);                     // unit vector for side
-                float qout_cms = q_3d.Dot(uv_out);
-                float qside_cms = q_3d.Dot(uv_side);
-
-                // longitudinally co-moving system (LCMS)
-                ROOT::Math::PxPyPzEVector v1_cartesian(v1.Px(), v1.Py(), v1.Pz(), v1.E());
-                ROOT::Math::PxPyPzEVector v2_cartesian(v2.Px(), v2.Py(), v2.Pz(), v2.E());
-                ROOT::Math::PxPyPzEVector q12_cartesian = v1_cartesian - v2_cartesian;
-                float beta_z = (v1 + v2).Pz() / (v1 + v2).E();
-                ROOT::Math::Boost bst_z(0, 0, -beta_z); // Boost supports only PxPyPzEVector
-                ROOT::Math::PxPyPzEVector q12_lcms = bst_z(q12_cartesian);
-                float qlong_lcms = q12_lcms.Pz();
-
-                values[2] = kt;
-                values[3] = qinv;
-                values[4] = qlong_cms;
-                values[5] = qout_cms;
-                values[6] = qside_cms;
-                values[7] = qt;
-                values[8] = qlong_lcms;
+                HBTPairVariables vars;
+                if (!GetHBTPairVariables(g1.pt(), g1.eta(), g1.phi(), 0.f, g2.pt(), g2.eta(), g2.phi(), m2, maxQinv, vars)) {
+                  continue;
+                }
+                SetHBTValues(values, vars);
                 reinterpret_cast<THnSparseF*>(list_pair_ss->FindObject(Form("%s_%s", cut1.GetName(), cut2.GetName()))->FindObject(paircut.GetName())->FindObject("hs_q_same"))->Fill(values);
               } // end of combination
             }   // end of pair cut loop
@@ -409,83 +366,113 @@ struct PhotonHBT {
   ConfigurableAxis ConfMultBins{"ConfMultBins", {VARIABLE_WIDTH, 0.0f, 10.f, 20.0f, 40.0f, 60.0f, 80.0f, 100.0f, 200.0f, 1e+10f}, "Mixing bins - multiplicity"};
   using BinningType = ColumnBinningPolicy<aod::collision::PosZ, aod::mult::MultNTracksPV>;
   BinningType colBinning{{ConfVtxBins, ConfMultBins}, true};
+  MixingPool fMixingPool;
 
   template <PairType pairtype, typename TEvents, typename TPhotons1, typename TPhotons2, typename TPreslice1, typename TPreslice2, typename TCuts1, typename TCuts2, typename TPairCuts, typename TLegs, typename TEMPrimaryElectrons>
   void MixedEventPairing(TEvents const& collisions, TPhotons1 const& photons1, TPhotons2 const& photons2, TPreslice1 const& perCollision1, TPreslice2 const& perCollision2, TCuts1 const& cuts1, TCuts2 const& cuts2, TPairCuts const& paircuts, TLegs const& legs, TEMPrimaryElectrons const& emprimaryelectrons)
   {
     THashList* list_pair_ss = static_cast<THashList*>(fMainList->FindObject("Pair")->FindObject(pairnames[pairtype].data()));
-    // LOGF(info, "Number of collisions after filtering: %d", collisions.size());
-    for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, ndepth, -1, collisions, collisions)) { // internally, CombinationsStrictlyUpperIndexPolicy(collisions, collisions) is called.
-      // LOGF(info, "Mixed event globalIndex: (%d, %d) , counter = %d, ngpcm: (%d, %d), ngphos: (%d, %d), ngemc: (%d, %d)",
-      //     collision1.globalIndex(), collision2.globalIndex(), nev, collision1.ngpcm(), collision2.ngpcm(), collision1.ngphos(), collision2.ngphos(), collision1.ngemc(), collision2.ngemc());
+    // histograms of the (cut1, cut2, paircut) combinations, at (icut1 * ncuts2 + icut2) * npaircuts + ipaircut
+    const size_t ncuts2 = cuts2.size();
+    const size_t npaircuts = paircuts.size();
+    std::vector<THnSparseF*> hs_q_mix(cuts1.size() * ncuts2 * npaircuts, nullptr);
+    for (size_t icut1 = 0; icut1 < cuts1.size(); icut1++) {
+      for (size_t icut2 = 0; icut2 < ncuts2; icut2++) {
+        if ((pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC) && (TString(cuts1[icut1].GetName()) != TString(cuts2[icut2].GetName()))) {
+          continue;
+        }
+        for (size_t ipaircut = 0; ipaircut < npaircuts; ipaircut++) {
+          hs_q_mix[(icut1 * ncuts2 + icut2) * npaircuts + ipaircut] = reinterpret_cast<THnSparseF*>(list_pair_ss->FindObject(Form("%s_%s", cuts1[icut1].GetName(), cuts2[icut2].GetName()))->FindObject(paircuts[ipaircut].GetName())->FindObject("hs_q_mix"));
+        }
+      }
+    }
 
-      auto photons_coll1 = photons1.sliceBy(perCollision1, collision1.globalIndex());
-      auto photons_coll2 = photons2.sliceBy(perCollision2, collision2.globalIndex());
-      // LOGF(info, "collision1: posZ = %f, numContrib = %d , sel8 = %d | collision2: posZ = %f, numContrib = %d , sel8 = %d",
-      //     collision1.posZ(), collision1.numContrib(), collision1.sel8(), collision2.posZ(), collision2.numContrib(), collision2.sel8());
+    fMixingPool.Reset(ndepth);
+    // each collision is paired with the previous ndepth collisions of its bin, as with soa::selfCombinations(colBinning, ndepth, -1, collisions, collisions)
+    for (auto& collision : collisions) {
+      const int bin = colBinning.getBin({collision.posZ(), collision.multNTracksPV()});
+      if (bin < 0) { // underflow and overflow
+        continue;
+      }
 
-      double values[9] = {0.f};
-      for (auto& cut1 : cuts1) {
-        for (auto& cut2 : cuts2) {
-          for (auto& paircut : paircuts) {
-            for (auto& [g1, g2] : combinations(soa::CombinationsFullIndexPolicy(photons_coll1, photons_coll2))) {
-              // LOGF(info, "Mixed event photon pair: (%d, %d) from events (%d, %d), photon event: (%d, %d)", g1.index(), g2.index(), collision1.index(), collision2.index(), g1.globalIndex(), g2.globalIndex());
+      MixingEvent event;
+      auto photons_coll1 = photons1.sliceBy(perCollision1, collision.globalIndex());
+      auto photons_coll2 = photons2.sliceBy(perCollision2, collision.globalIndex());
+      for (auto& g1 : photons_coll1) {
+        uint64_t mask = 0;
+        if constexpr (pairtype == PairType::kPHOSPHOS) {
+          mask = GetCutMask<int>(g1, cuts1); // dummy, because track matching is not ready.
+        } else {
+          mask = GetCutMask<aod::V0Legs>(g1, cuts1);
+        }
+        if (mask != 0) {
+          event.mPhotons1.push_back(MakeMixingPhoton(g1, mask));
+        }
+      }
+      for (auto& g2 : photons_coll2) {
+        if constexpr (pairtype == PairType::kPCMPCM) {
+          uint64_t mask = GetCutMask<aod::V0Legs>(g2, cuts2);
+          if (mask != 0) {
+            event.mPhotons2.push_back(MakeMixingPhoton(g2, mask));
+          }
+        } else if constexpr (pairtype == PairType::kPCMDalitzEE) {
+          uint64_t mask = GetCutMask<MyPrimaryElectrons>(g2, cuts2);
+          if (mask != 0) {
+            event.mPhotons2.push_back(MakeMixingPhoton(g2, mask, g2.mass()));
+          }
+        } else {
+          uint64_t mask = GetCutMask<int>(g2, cuts2);
+          if (mask != 0) {
+            event.mPhotons2.push_back(MakeMixingPhoton(g2, mask));
+          }
+        }
+      }
 
-              if ((pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC) && (TString(cut1.GetName()) != TString(cut2.GetName()))) {
-                continue;
-              }
-              if (!IsSelectedPair<pairtype>(g1, g2, cut1, cut2)) {
-                continue;
-              }
-              if (!paircut.IsSelected(g1, g2)) {
-                continue;
+      double values[9] = {0.f};
+      fMixingPool.ForEachPooledEvent(bin, [&](MixingEvent const& pooled_event) {
+        for (auto& g1 : pooled_event.mPhotons1) {
+          for (auto& g2 : event.mPhotons2) {
+            HBTPairVariables vars;
+            if (!GetHBTPairVariables(g1.pt(), g1.eta(), g1.phi(), 0.f, g2.pt(), g2.eta(), g2.phi(), g2.mass(), maxQinv, vars)) {
+              continue;
+            }
+
+            uint64_t mask_paircut = 0;
+            for (size_t ipaircut = 0; ipaircut < npaircuts; ipaircut++) {
+              if (paircuts[ipaircut].IsSelected(g1, g2)) {
+                mask_paircut |= uint64_t(1) << ipaircut;
               }
+            }
+            if (mask_paircut == 0) {
+              continue;
+            }
 
-              // center-of-mass system (CMS)
-              values[0] = 0.0;
-              values[1] = 0.0;
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              if constexpr (pairtype == PairType::kPCMDalitzEE) {
-                v2.SetM(g2.mass());
-                values[1] = g2.mass();
+            values[0] = 0.0;
+            values[1] = g2.mass();
+            SetHBTValues(values, vars);
+
+            for (size_t icut1 = 0; icut1 < cuts1.size(); icut1++) {
+              if (!(g1.mCutMask & (uint64_t(1) << icut1))) {
+                continue;
               }
-              ROOT::Math::PtEtaPhiMVector q12 = v1 - v2;
-              ROOT::Math::PtEtaPhiMVector k12 = 0.5 * (v1 + v2);
-              float qinv = -q12.M();
-              float kt = k12.Pt();
-              float qt = q12.Pt();
-              float qlong_cms = q12.Pz();
-
-              ROOT::Math::XYZVector q_3d = q12.Vect();                                   // 3D q vector
-              ROOT::Math::XYZVector uv_out(k12.Px() / k12.Pt(), k12.Py() / k12.Pt(), 0); // unit vector for out. i.e. parallel to kt
-              ROOT::Math::XYZVector uv_long(0, 0, 1);                                    // unit vector for long, beam axis
-              ROOT::Math::XYZVector uv_side = uv_out.Cross(uv_long);                     // unit vector for side
-              float qout_cms = q_3d.Dot(uv_out);
-              float qside_cms = q_3d.Dot(uv_side);
-
-              // longitudinally co-moving system (LCMS)
-              ROOT::Math::PxPyPzEVector v1_cartesian(v1.Px(), v1.Py(), v1.Pz(), v1.E());
-              ROOT::Math::PxPyPzEVector v2_cartesian(v2.Px(), v2.Py(), v2.Pz(), v2.E());
-              ROOT::Math::PxPyPzEVector q12_cartesian = v1_cartesian - v2_cartesian;
-              float beta_z = (v1 + v2).Pz() / (v1 + v2).E();
-              ROOT::Math::Boost bst_z(0, 0, -beta_z); // Boost supports only PxPyPzEVector
-              ROOT::Math::PxPyPzEVector q12_lcms = bst_z(q12_cartesian);
-              float qlong_lcms = q12_lcms.Pz();
-
-              values[2] = kt;
-              values[3] = qinv;
-              values[4] = qlong_cms;
-              values[5] = qout_cms;
-              values[6] = qside_cms;
-              values[7] = qt;
-              values[8] = qlong_lcms;
-              reinterpret_cast<THnSparseF*>(list_pair_ss->FindObject(Form("%s_%s", cut1.GetName(), cut2.GetName()))->FindObject(paircut.GetName())->FindObject("hs_q_mix"))->Fill(values);
-            } // end of different photon combinations
-          }   // end of pair cut loop
-        }     // end of cut2 loop
-      }       // end of cut1 loop
-    }         // end of different collision combinations
+              for (size_t icut2 = 0; icut2 < ncuts2; icut2++) {
+                if (!(g2.mCutMask & (uint64_t(1) << icut2))) {
+                  continue;
+                }
+                for (size_t ipaircut = 0; ipaircut < npaircuts; ipaircut++) {
+                  auto hs = hs_q_mix[(icut1 * ncuts2 + icut2) * npaircuts + ipaircut];
+                  if ((mask_paircut & (uint64_t(1) << ipaircut)) && hs != nullptr) {
+                    hs->Fill(values);
+                  }
+                } // end of pair cut loop
+              }   // end of cut2 loop
+            }     // end of cut1 loop
+          }       // end of photon2 loop
+        }         // end of photon1 loop
+      });
+
+      fMixingPool.Add(bin, std::move(event));
+    } // end of collision loop
   }
 
   Preslice<MyV0Photons> perCollision_pcm = aod::v0photonkf::emreducedeventId;
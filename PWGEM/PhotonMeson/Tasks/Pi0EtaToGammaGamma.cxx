@@ -14,8 +14,11 @@
 // This code loops over photons and makes pairs for neutral mesons analyses.
 //    Please write to: daiki.sekihata@cern.ch
 
+#include <cstdint>
 #include <cstring>
 #include <iterator>
+#include <utility>
+#include <vector>
 
 #include "TString.h"
 #include "Math/Vector4D.h"
@@ -31,6 +34,7 @@
 #include "Common/Core/RecoDecay.h"
 #include "PWGEM/PhotonMeson/DataModel/gammaTables.h"
 #include "PWGEM/PhotonMeson/Utils/PairUtilities.h"
+#include "PWGEM/PhotonMeson/Utils/EventMixingPool.h"
 #include "PWGEM/PhotonMeson/Core/V0PhotonCut.h"
 #include "PWGEM/PhotonMeson/Core/DalitzEECut.h"
 #include "PWGEM/PhotonMeson/Core/PHOSPhotonCut.h"
@@ -137,6 +141,11 @@ struct Pi0EtaToGammaGamma {
     DefinePHOSCuts();
     DefineEMCCuts();
     DefinePairCuts();
+    for (auto ncuts : {fPCMCuts.size(), fDalitzEECuts.size(), fDalitzMuMuCuts.size(), fPHOSCuts.size(), fEMCCuts.size(), fPairCuts.size()}) {
+      if (ncuts > kMaxNCuts) {
+        LOGF(fatal, "At most %d cuts per category are supported, %d given", kMaxNCuts, ncuts);
+      }
+    }
     addhistograms();
 
     fOutputEvent.setObject(reinterpret_cast<THashList*>(fMainList->FindObject("Event")));
@@ -336,30 +345,107 @@ struct Pi0EtaToGammaGamma {
   Preslice<aod::PHOSClusters> perCollision_phos = aod::skimmedcluster::collisionId;
   Preslice<aod::SkimEMCClusters> perCollision_emc = aod::skimmedcluster::collisionId;
 
-  template <PairType pairtype, typename TG1, typename TG2, typename TCut1, typename TCut2>
-  bool IsSelectedPair(TG1 const& g1, TG2 const& g2, TCut1 const& cut1, TCut2 const& cut2)
+  // selection bits of the photons in each single-photon cut, indexed by globalIndex, evaluated once per data frame
+  std::vector<uint64_t> fCutMasks1;
+  std::vector<uint64_t> fCutMasks2;
+
+  template <typename TLeg, typename TPhotons, typename TCuts>
+  void FillCutMasks(TPhotons const& photons, TCuts const& cuts, std::vector<uint64_t>& masks)
+  {
+    masks.clear();
+    for (auto& photon : photons) {
+      uint64_t mask = 0;
+      for (size_t icut = 0; icut < cuts.size(); icut++) {
+        if (cuts[icut].template IsSelected<TLeg>(photon)) {
+          mask |= uint64_t(1) << icut;
+        }
+      }
+      if (static_cast<size_t>(photon.globalIndex()) >= masks.size()) {
+        masks.resize(photon.globalIndex() + 1, 0);
+      }
+      masks[photon.globalIndex()] = mask;
+    }
+  }
+
+  // track ids of the positive and negative legs of the photons, indexed by globalIndex, filled once per data frame
+  std::vector<std::pair<int, int>> fLegTrackIds1;
+  std::vector<std::pair<int, int>> fLegTrackIds2;
+
+  template <typename TLeg, typename TPhotons>
+  void FillLegTrackIds(TPhotons const& photons, std::vector<std::pair<int, int>>& ids)
+  {
+    ids.clear();
+    for (auto& photon : photons) {
+      if (static_cast<size_t>(photon.globalIndex()) >= ids.size()) {
+        ids.resize(photon.globalIndex() + 1, {-1, -1});
+      }
+      ids[photon.globalIndex()] = {photon.template posTrack_as<TLeg>().trackId(), photon.template negTrack_as<TLeg>().trackId()};
+    }
+  }
+
+  template <PairType pairtype, typename TPhotons1, typename TPhotons2, typename TCuts1, typename TCuts2>
+  void FillCutMasks(TPhotons1 const& photons1, TPhotons2 const& photons2, TCuts1 const& cuts1, TCuts2 const& cuts2)
   {
-    bool is_selected_pair = false;
     if constexpr (pairtype == PairType::kPCMPCM) {
-      is_selected_pair = o2::aod::photonpair::IsSelectedPair<aod::V0Legs, aod::V0Legs>(g1, g2, cut1, cut2);
+      FillCutMasks<aod::V0Legs>(photons1, cuts1, fCutMasks1);
+      fCutMasks2 = fCutMasks1;
     } else if constexpr (pairtype == PairType::kPHOSPHOS) {
-      is_selected_pair = o2::aod::photonpair::IsSelectedPair<int, int>(g1, g2, cut1, cut2); // dummy, because track matching is not ready.
+      FillCutMasks<int>(photons1, cuts1, fCutMasks1); // dummy, because track matching is not ready.
+      fCutMasks2 = fCutMasks1;
     } else if constexpr (pairtype == PairType::kEMCEMC) {
-      is_selected_pair = o2::aod::photonpair::IsSelectedPair<aod::SkimEMCMTs, aod::SkimEMCMTs>(g1, g2, cut1, cut2);
+      FillCutMasks<aod::SkimEMCMTs>(photons1, cuts1, fCutMasks1);
+      fCutMasks2 = fCutMasks1;
     } else if constexpr (pairtype == PairType::kPCMPHOS) {
-      is_selected_pair = o2::aod::photonpair::IsSelectedPair<aod::V0Legs, int>(g1, g2, cut1, cut2);
+      FillCutMasks<aod::V0Legs>(photons1, cuts1, fCutMasks1);
+      FillCutMasks<int>(photons2, cuts2, fCutMasks2);
     } else if constexpr (pairtype == PairType::kPCMEMC) {
-      is_selected_pair = o2::aod::photonpair::IsSelectedPair<aod::V0Legs, aod::SkimEMCMTs>(g1, g2, cut1, cut2);
+      FillCutMasks<aod::V0Legs>(photons1, cuts1, fCutMasks1);
+      FillCutMasks<aod::SkimEMCMTs>(photons2, cuts2, fCutMasks2);
     } else if constexpr (pairtype == PairType::kPCMDalitzEE) {
-      is_selected_pair = o2::aod::photonpair::IsSelectedPair<aod::V0Legs, MyPrimaryElectrons>(g1, g2, cut1, cut2);
+      FillCutMasks<aod::V0Legs>(photons1, cuts1, fCutMasks1);
+      FillCutMasks<MyPrimaryElectrons>(photons2, cuts2, fCutMasks2);
+      FillLegTrackIds<aod::V0Legs>(photons1, fLegTrackIds1);
+      FillLegTrackIds<MyPrimaryElectrons>(photons2, fLegTrackIds2);
     } else if constexpr (pairtype == PairType::kPCMDalitzMuMu) {
-      is_selected_pair = o2::aod::photonpair::IsSelectedPair<aod::V0Legs, MyPrimaryMuons>(g1, g2, cut1, cut2);
+      FillCutMasks<aod::V0Legs>(photons1, cuts1, fCutMasks1);
+      FillCutMasks<MyPrimaryMuons>(photons2, cuts2, fCutMasks2);
+      FillLegTrackIds<aod::V0Legs>(photons1, fLegTrackIds1);
+      FillLegTrackIds<MyPrimaryMuons>(photons2, fLegTrackIds2);
     } else if constexpr (pairtype == PairType::kPHOSEMC) {
-      is_selected_pair = o2::aod::photonpair::IsSelectedPair<int, aod::SkimEMCMTs>(g1, g2, cut1, cut2);
-    } else {
-      is_selected_pair = true;
+      FillCutMasks<int>(photons1, cuts1, fCutMasks1);
+      FillCutMasks<aod::SkimEMCMTs>(photons2, cuts2, fCutMasks2);
+    }
+  }
+
+  // histogram lists of the (cut1, cut2, paircut) combinations, at (icut1 * ncuts2 + icut2) * npaircuts + ipaircut
+  template <PairType pairtype, typename TCuts1, typename TCuts2, typename TPairCuts>
+  std::vector<THashList*> GetPairLists(THashList* list_pair, TCuts1 const& cuts1, TCuts2 const& cuts2, TPairCuts const& paircuts)
+  {
+    std::vector<THashList*> lists(cuts1.size() * cuts2.size() * paircuts.size(), nullptr);
+    for (size_t icut1 = 0; icut1 < cuts1.size(); icut1++) {
+      for (size_t icut2 = 0; icut2 < cuts2.size(); icut2++) {
+        if ((pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC) && icut1 != icut2) {
+          continue;
+        }
+        auto list_photoncut = list_pair->FindObject(Form("%s_%s", cuts1[icut1].GetName(), cuts2[icut2].GetName()));
+        for (size_t ipaircut = 0; ipaircut < paircuts.size(); ipaircut++) {
+          lists[(icut1 * cuts2.size() + icut2) * paircuts.size() + ipaircut] = static_cast<THashList*>(list_photoncut->FindObject(paircuts[ipaircut].GetName()));
+        }
+      }
+    }
+    return lists;
+  }
+
+  template <typename TG1, typename TG2, typename TPairCuts>
+  uint64_t GetPairCutMask(TG1 const& g1, TG2 const& g2, TPairCuts const& paircuts)
+  {
+    uint64_t mask = 0;
+    for (size_t ipaircut = 0; ipaircut < paircuts.size(); ipaircut++) {
+      if (paircuts[ipaircut].IsSelected(g1, g2)) {
+        mask |= uint64_t(1) << ipaircut;
+      }
     }
-    return is_selected_pair;
+    return mask;
   }
 
   template <PairType pairtype, typename TEvents, typename TPhotons1, typename TPhotons2, typename TPreslice1, typename TPreslice2, typename TCuts1, typename TCuts2, typename TPairCuts, typename TLegs, typename TEMPrimaryElectrons, typename TEMPrimaryMuons, typename TEMCMTs>
@@ -367,6 +453,10 @@ struct Pi0EtaToGammaGamma {
   {
     THashList* list_ev_pair = static_cast<THashList*>(fMainList->FindObject("Event")->FindObject(pairnames[pairtype].data()));
     THashList* list_pair_ss = static_cast<THashList*>(fMainList->FindObject("Pair")->FindObject(pairnames[pairtype].data()));
+    const auto lists_pair = GetPairLists<pairtype>(list_pair_ss, cuts1, cuts2, paircuts);
+    const size_t ncuts2 = cuts2.size();
+    const size_t npaircuts = paircuts.size();
+    std::vector<THashList*> lists_selected;
 
     for (auto& collision : collisions) {
       if ((pairtype == PairType::kPHOSPHOS || pairtype == PairType::kPCMPHOS) && !collision.isPHOSCPVreadout()) {
@@ -400,102 +490,121 @@ struct Pi0EtaToGammaGamma {
       auto photons2_coll = photons2.sliceBy(perCollision2, collision.globalIndex());
 
       if constexpr (pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC) {
-        for (auto& cut : cuts1) {
-          for (auto& paircut : paircuts) {
-
-            for (auto& [g1, g2] : combinations(CombinationsStrictlyUpperIndexPolicy(photons1_coll, photons2_coll))) {
-              if (!IsSelectedPair<pairtype>(g1, g2, cut, cut)) {
+        for (auto& [g1, g2] : combinations(CombinationsStrictlyUpperIndexPolicy(photons1_coll, photons2_coll))) {
+          const uint64_t mask_cut = fCutMasks1[g1.globalIndex()] & fCutMasks2[g2.globalIndex()];
+          if (mask_cut == 0) {
+            continue;
+          }
+          const uint64_t mask_paircut = GetPairCutMask(g1, g2, paircuts);
+          if (mask_paircut == 0) {
+            continue;
+          }
+
+          ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
+          ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
+          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+          if (abs(v12.Rapidity()) > maxY) {
+            continue;
+          }
+
+          for (size_t icut = 0; icut < cuts1.size(); icut++) {
+            if (!(mask_cut & (uint64_t(1) << icut))) {
+              continue;
+            }
+            for (size_t ipaircut = 0; ipaircut < npaircuts; ipaircut++) {
+              if (!(mask_paircut & (uint64_t(1) << ipaircut))) {
                 continue;
               }
-              if (!paircut.IsSelected(g1, g2)) {
-                continue;
-              }
-
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (abs(v12.Rapidity()) > maxY) {
-                continue;
-              }
-              reinterpret_cast<TH2F*>(list_pair_ss->FindObject(Form("%s_%s", cut.GetName(), cut.GetName()))->FindObject(paircut.GetName())->FindObject("hMggPt_Same"))->Fill(v12.M(), v12.Pt());
+              THashList* list_pair_cut = lists_pair[(icut * ncuts2 + icut) * npaircuts + ipaircut];
+              reinterpret_cast<TH2F*>(list_pair_cut->FindObject("hMggPt_Same"))->Fill(v12.M(), v12.Pt());
 
               if constexpr (pairtype == PairType::kEMCEMC) {
-                RotationBackground<aod::SkimEMCClusters>(v12, v1, v2, photons2_coll, g1.globalIndex(), g2.globalIndex(), cut, paircut, emcmatchedtracks);
+                RotationBackground<aod::SkimEMCClusters>(v12, v1, v2, photons2_coll, g1.globalIndex(), g2.globalIndex(), uint64_t(1) << icut, list_pair_cut);
               }
-            } // end of combination
-          }   // end of pair cut loop
-        }     // end of cut loop
+            } // end of pair cut loop
+          }   // end of cut loop
+        }     // end of combination
 
       } else { // different subsystem pairs
-        for (auto& cut1 : cuts1) {
-          for (auto& cut2 : cuts2) {
-            for (auto& paircut : paircuts) {
-              for (auto& [g1, g2] : combinations(CombinationsFullIndexPolicy(photons1_coll, photons2_coll))) {
-                if (!IsSelectedPair<pairtype>(g1, g2, cut1, cut2)) {
-                  continue;
-                }
-                if (!paircut.IsSelected(g1, g2)) {
-                  continue;
-                }
-
-                if constexpr (pairtype == PairType::kPCMPHOS || pairtype == PairType::kPCMEMC) {
-                  auto pos = g1.template posTrack_as<aod::V0Legs>();
-                  auto ele = g1.template negTrack_as<aod::V0Legs>();
-
-                  for (auto& v0leg : {pos, ele}) {
-                    float deta = v0leg.eta() - g2.eta();
-                    float dphi = TVector2::Phi_mpi_pi(TVector2::Phi_0_2pi(v0leg.phi()) - TVector2::Phi_0_2pi(g2.phi()));
-                    float Ep = g2.e() / v0leg.p();
-                    reinterpret_cast<TH2F*>(list_pair_ss->FindObject(Form("%s_%s", cut1.GetName(), cut2.GetName()))->FindObject(paircut.GetName())->FindObject("hdEtadPhi"))->Fill(dphi, deta);
-                    reinterpret_cast<TH2F*>(list_pair_ss->FindObject(Form("%s_%s", cut1.GetName(), cut2.GetName()))->FindObject(paircut.GetName())->FindObject("hdEtaPt"))->Fill(v0leg.pt(), deta);
-                    reinterpret_cast<TH2F*>(list_pair_ss->FindObject(Form("%s_%s", cut1.GetName(), cut2.GetName()))->FindObject(paircut.GetName())->FindObject("hdPhiPt"))->Fill(v0leg.pt(), dphi);
-                    if (pow(deta / 0.02, 2) + pow(dphi / 0.4, 2) < 1) {
-                      reinterpret_cast<TH2F*>(list_pair_ss->FindObject(Form("%s_%s", cut1.GetName(), cut2.GetName()))->FindObject(paircut.GetName())->FindObject("hEp_E"))->Fill(g2.e(), Ep);
-                    }
-                  }
-
-                  if constexpr (pairtype == PairType::kPCMPHOS) {
-                    if (o2::aod::photonpair::DoesV0LegMatchWithCluster(pos, g2, 0.02, 0.4, 0.2) || o2::aod::photonpair::DoesV0LegMatchWithCluster(ele, g2, 0.02, 0.4, 0.2)) {
-                      continue;
-                    }
-                  } else if constexpr (pairtype == PairType::kPCMEMC) {
-                    if (o2::aod::photonpair::DoesV0LegMatchWithCluster(pos, g2, 0.02, 0.4, 0.5) || o2::aod::photonpair::DoesV0LegMatchWithCluster(ele, g2, 0.02, 0.4, 0.5)) {
-                      continue;
-                    }
-                  }
+        for (auto& [g1, g2] : combinations(CombinationsFullIndexPolicy(photons1_coll, photons2_coll))) {
+          const uint64_t mask_cut1 = fCutMasks1[g1.globalIndex()];
+          const uint64_t mask_cut2 = fCutMasks2[g2.globalIndex()];
+          if (mask_cut1 == 0 || mask_cut2 == 0) {
+            continue;
+          }
+          if constexpr (pairtype == PairType::kPCMDalitzEE || pairtype == PairType::kPCMDalitzMuMu) { // the V0 photon and the dilepton must not share a leg
+            const auto& legs1 = fLegTrackIds1[g1.globalIndex()];
+            const auto& legs2 = fLegTrackIds2[g2.globalIndex()];
+            if (legs1.first == legs2.first || legs1.second == legs2.second) {
+              continue;
+            }
+          }
+          const uint64_t mask_paircut = GetPairCutMask(g1, g2, paircuts);
+          if (mask_paircut == 0) {
+            continue;
+          }
+
+          // histogram lists of the cut combinations selecting this pair
+          lists_selected.clear();
+          for (size_t icut1 = 0; icut1 < cuts1.size(); icut1++) {
+            if (!(mask_cut1 & (uint64_t(1) << icut1))) {
+              continue;
+            }
+            for (size_t icut2 = 0; icut2 < ncuts2; icut2++) {
+              if (!(mask_cut2 & (uint64_t(1) << icut2))) {
+                continue;
+              }
+              for (size_t ipaircut = 0; ipaircut < npaircuts; ipaircut++) {
+                if (mask_paircut & (uint64_t(1) << ipaircut)) {
+                  lists_selected.push_back(lists_pair[(icut1 * ncuts2 + icut2) * npaircuts + ipaircut]);
                 }
-
-                ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-                ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-                if constexpr (pairtype == PairType::kPCMDalitzEE) {
-                  v2.SetM(g2.mass());
-                  auto pos_sv = g1.template posTrack_as<aod::V0Legs>();
-                  auto ele_sv = g1.template negTrack_as<aod::V0Legs>();
-                  auto pos_pv = g2.template posTrack_as<MyPrimaryElectrons>();
-                  auto ele_pv = g2.template negTrack_as<MyPrimaryElectrons>();
-                  if (pos_sv.trackId() == pos_pv.trackId() || ele_sv.trackId() == ele_pv.trackId()) {
-                    continue;
-                  }
-                } else if constexpr (pairtype == PairType::kPCMDalitzMuMu) {
-                  v2.SetM(g2.mass());
-                  auto pos_sv = g1.template posTrack_as<aod::V0Legs>();
-                  auto ele_sv = g1.template negTrack_as<aod::V0Legs>();
-                  auto pos_pv = g2.template posTrack_as<MyPrimaryMuons>();
-                  auto ele_pv = g2.template negTrack_as<MyPrimaryMuons>();
-                  if (pos_sv.trackId() == pos_pv.trackId() || ele_sv.trackId() == ele_pv.trackId()) {
-                    continue;
-                  }
+              }
+            }
+          }
+
+          if constexpr (pairtype == PairType::kPCMPHOS || pairtype == PairType::kPCMEMC) {
+            auto pos = g1.template posTrack_as<aod::V0Legs>();
+            auto ele = g1.template negTrack_as<aod::V0Legs>();
+
+            for (auto& v0leg : {pos, ele}) {
+              float deta = v0leg.eta() - g2.eta();
+              float dphi = TVector2::Phi_mpi_pi(TVector2::Phi_0_2pi(v0leg.phi()) - TVector2::Phi_0_2pi(g2.phi()));
+              float Ep = g2.e() / v0leg.p();
+              for (auto& list_pair_cut : lists_selected) {
+                reinterpret_cast<TH2F*>(list_pair_cut->FindObject("hdEtadPhi"))->Fill(dphi, deta);
+                reinterpret_cast<TH2F*>(list_pair_cut->FindObject("hdEtaPt"))->Fill(v0leg.pt(), deta);
+                reinterpret_cast<TH2F*>(list_pair_cut->FindObject("hdPhiPt"))->Fill(v0leg.pt(), dphi);
+                if (pow(deta / 0.02, 2) + pow(dphi / 0.4, 2) < 1) {
+                  reinterpret_cast<TH2F*>(list_pair_cut->FindObject("hEp_E"))->Fill(g2.e(), Ep);
                 }
+              }
+            }
 
-                ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-                if (abs(v12.Rapidity()) > maxY) {
-                  continue;
-                }
-                reinterpret_cast<TH2F*>(list_pair_ss->FindObject(Form("%s_%s", cut1.GetName(), cut2.GetName()))->FindObject(paircut.GetName())->FindObject("hMggPt_Same"))->Fill(v12.M(), v12.Pt());
-              } // end of combination
-            }   // end of pair cut loop
-          }     // end of cut2 loop
-        }       // end of cut1 loop
+            if constexpr (pairtype == PairType::kPCMPHOS) {
+              if (o2::aod::photonpair::DoesV0LegMatchWithCluster(pos, g2, 0.02, 0.4, 0.2) || o2::aod::photonpair::DoesV0LegMatchWithCluster(ele, g2, 0.02, 0.4, 0.2)) {
+                continue;
+              }
+            } else if constexpr (pairtype == PairType::kPCMEMC) {
+              if (o2::aod::photonpair::DoesV0LegMatchWithCluster(pos, g2, 0.02, 0.4, 0.5) || o2::aod::photonpair::DoesV0LegMatchWithCluster(ele, g2, 0.02, 0.4, 0.5)) {
+                continue;
+              }
+            }
+          }
+
+          ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
+          ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
+          if constexpr (pairtype == PairType::kPCMDalitzEE || pairtype == PairType::kPCMDalitzMuMu) {
+            v2.SetM(g2.mass());
+          }
+
+          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+          if (abs(v12.Rapidity()) > maxY) {
+            continue;
+          }
+          for (auto& list_pair_cut : lists_selected) {
+            reinterpret_cast<TH2F*>(list_pair_cut->FindObject("hMggPt_Same"))->Fill(v12.M(), v12.Pt());
+          }
+        } // end of combination
       }
     } // end of collision loop
   }
@@ -505,59 +614,85 @@ struct Pi0EtaToGammaGamma {
   ConfigurableAxis ConfMultBins{"ConfMultBins", {VARIABLE_WIDTH, 0.0f, 5.0f, 10.f, 20.0f, 40.0f, 60.0f, 80.0f, 100.0f, 200.0f, 1e+10f}, "Mixing bins - multiplicity"};
   using BinningType = ColumnBinningPolicy<aod::collision::PosZ, aod::mult::MultNTracksPV>;
   BinningType colBinning{{ConfVtxBins, ConfMultBins}, true};
+  MixingPool fMixingPool;
 
   template <PairType pairtype, typename TEvents, typename TPhotons1, typename TPhotons2, typename TPreslice1, typename TPreslice2, typename TCuts1, typename TCuts2, typename TPairCuts, typename TLegs, typename TEMPrimaryElectrons, typename TEMPrimaryMuons, typename TEMCMTs>
   void MixedEventPairing(TEvents const& collisions, TPhotons1 const& photons1, TPhotons2 const& photons2, TPreslice1 const& perCollision1, TPreslice2 const& perCollision2, TCuts1 const& cuts1, TCuts2 const& cuts2, TPairCuts const& paircuts, TLegs const& legs, TEMPrimaryElectrons const& emprimaryelectrons, TEMPrimaryMuons const& emprimarymuons, TEMCMTs const& emcmatchedtracks)
   {
     THashList* list_pair_ss = static_cast<THashList*>(fMainList->FindObject("Pair")->FindObject(pairnames[pairtype].data()));
-    // LOGF(info, "Number of collisions after filtering: %d", collisions.size());
-    for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, ndepth, -1, collisions, collisions)) { // internally, CombinationsStrictlyUpperIndexPolicy(collisions, collisions) is called.
-
-      // LOGF(info, "Mixed event globalIndex: (%d, %d) , ngpcm: (%d, %d), ngphos: (%d, %d), ngemc: (%d, %d)",
-      //     collision1.globalIndex(), collision2.globalIndex(), collision1.ngpcm(), collision2.ngpcm(), collision1.ngphos(), collision2.ngphos(), collision1.ngemc(), collision2.ngemc());
-
-      auto photons_coll1 = photons1.sliceBy(perCollision1, collision1.globalIndex());
-      auto photons_coll2 = photons2.sliceBy(perCollision2, collision2.globalIndex());
-      // LOGF(info, "collision1: posZ = %f, numContrib = %d , sel8 = %d | collision2: posZ = %f, numContrib = %d , sel8 = %d",
-      //     collision1.posZ(), collision1.numContrib(), collision1.sel8(), collision2.posZ(), collision2.numContrib(), collision2.sel8());
-
-      for (auto& cut1 : cuts1) {
-        for (auto& cut2 : cuts2) {
-          for (auto& paircut : paircuts) {
-            for (auto& [g1, g2] : combinations(soa::CombinationsFullIndexPolicy(photons_coll1, photons_coll2))) {
-              // LOGF(info, "Mixed event photon pair: (%d, %d) from events (%d, %d), photon event: (%d, %d)", g1.index(), g2.index(), collision1.index(), collision2.index(), g1.globalIndex(), g2.globalIndex());
+    const auto lists_pair = GetPairLists<pairtype>(list_pair_ss, cuts1, cuts2, paircuts);
+    const size_t ncuts2 = cuts2.size();
+    const size_t npaircuts = paircuts.size();
+    fMixingPool.Reset(ndepth);
+    // each collision is paired with the previous ndepth collisions of its bin, as with soa::selfCombinations(colBinning, ndepth, -1, collisions, collisions)
+    for (auto& collision : collisions) {
+      const int bin = colBinning.getBin({collision.posZ(), collision.multNTracksPV()});
+      if (bin < 0) { // underflow and overflow
+        continue;
+      }
 
-              if ((pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC) && (TString(cut1.GetName()) != TString(cut2.GetName()))) {
-                continue;
-              }
-              if (!IsSelectedPair<pairtype>(g1, g2, cut1, cut2)) {
-                continue;
-              }
-              if (!paircut.IsSelected(g1, g2)) {
-                continue;
-              }
+      MixingEvent event;
+      auto photons_coll1 = photons1.sliceBy(perCollision1, collision.globalIndex());
+      auto photons_coll2 = photons2.sliceBy(perCollision2, collision.globalIndex());
+      for (auto& g1 : photons_coll1) {
+        if (fCutMasks1[g1.globalIndex()] != 0) {
+          event.mPhotons1.push_back(MakeMixingPhoton(g1, fCutMasks1[g1.globalIndex()]));
+        }
+      }
+      for (auto& g2 : photons_coll2) {
+        if (fCutMasks2[g2.globalIndex()] != 0) {
+          if constexpr (pairtype == PairType::kPCMDalitzEE || pairtype == PairType::kPCMDalitzMuMu) {
+            event.mPhotons2.push_back(MakeMixingPhoton(g2, fCutMasks2[g2.globalIndex()], g2.mass()));
+          } else {
+            event.mPhotons2.push_back(MakeMixingPhoton(g2, fCutMasks2[g2.globalIndex()]));
+          }
+        }
+      }
 
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              if constexpr (pairtype == PairType::kPCMDalitzEE || pairtype == PairType::kPCMDalitzMuMu) {
-                v2.SetM(g2.mass());
-              }
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (abs(v12.Rapidity()) > maxY) {
+      fMixingPool.ForEachPooledEvent(bin, [&](MixingEvent const& pooled_event) {
+        for (auto& g1 : pooled_event.mPhotons1) {
+          for (auto& g2 : event.mPhotons2) {
+            const uint64_t mask_paircut = GetPairCutMask(g1, g2, paircuts);
+            if (mask_paircut == 0) {
+              continue;
+            }
+
+            ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
+            ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), g2.mass());
+            ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+            if (abs(v12.Rapidity()) > maxY) {
+              continue;
+            }
+
+            for (size_t icut1 = 0; icut1 < cuts1.size(); icut1++) {
+              if (!(g1.mCutMask & (uint64_t(1) << icut1))) {
                 continue;
               }
-              reinterpret_cast<TH2F*>(list_pair_ss->FindObject(Form("%s_%s", cut1.GetName(), cut2.GetName()))->FindObject(paircut.GetName())->FindObject("hMggPt_Mixed"))->Fill(v12.M(), v12.Pt());
-
-            } // end of different photon combinations
-          }   // end of pair cut loop
-        }     // end of cut2 loop
-      }       // end of cut1 loop
-    }         // end of different collision combinations
+              for (size_t icut2 = 0; icut2 < ncuts2; icut2++) {
+                if (!(g2.mCutMask & (uint64_t(1) << icut2))) {
+                  continue;
+                }
+                if ((pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC) && icut1 != icut2) {
+                  continue;
+                }
+                for (size_t ipaircut = 0; ipaircut < npaircuts; ipaircut++) {
+                  if (mask_paircut & (uint64_t(1) << ipaircut)) {
+                    reinterpret_cast<TH2F*>(lists_pair[(icut1 * ncuts2 + icut2) * npaircuts + ipaircut]->FindObject("hMggPt_Mixed"))->Fill(v12.M(), v12.Pt());
+                  }
+                } // end of pair cut loop
+              }   // end of cut2 loop
+            }     // end of cut1 loop
+          }       // end of photon2 loop
+        }         // end of photon1 loop
+      });
+
+      fMixingPool.Add(bin, std::move(event));
+    } // end of collision loop
   }
 
   /// \brief Calculate background (using rotation background method only for EMCal!)
   template <typename TPhotons>
-  void RotationBackground(const ROOT::Math::PtEtaPhiMVector& meson, ROOT::Math::PtEtaPhiMVector photon1, ROOT::Math::PtEtaPhiMVector photon2, TPhotons const& photons_coll, unsigned int ig1, unsigned int ig2, EMCPhotonCut const& cut, PairCut const& paircut, SkimEMCMTs const& emcmatchedtracks)
+  void RotationBackground(const ROOT::Math::PtEtaPhiMVector& meson, ROOT::Math::PtEtaPhiMVector photon1, ROOT::Math::PtEtaPhiMVector photon2, TPhotons const& photons_coll, unsigned int ig1, unsigned int ig2, uint64_t mask_cut, THashList* list_pair_cut)
   {
     // if less than 3 clusters are present skip event since we need at least 3 clusters
     if (photons_coll.size() < 3) {
@@ -585,7 +720,7 @@ struct Pi0EtaToGammaGamma {
         // only combine rotated photons with other photons
         continue;
       }
-      if (!cut.template IsSelected<aod::SkimEMCMTs>(photon)) {
+      if (!(fCutMasks2[photon.globalIndex()] & mask_cut)) {
         continue;
       }
 
@@ -609,10 +744,10 @@ struct Pi0EtaToGammaGamma {
 
       // Fill histograms
       if (openingAngle1 > minOpenAngle) {
-        reinterpret_cast<TH2F*>(fMainList->FindObject("Pair")->FindObject("EMCEMC")->FindObject(Form("%s_%s", cut.GetName(), cut.GetName()))->FindObject(paircut.GetName())->FindObject("hMggPt_Same_RotatedBkg"))->Fill(mother1.M(), mother1.Pt());
+        reinterpret_cast<TH2F*>(list_pair_cut->FindObject("hMggPt_Same_RotatedBkg"))->Fill(mother1.M(), mother1.Pt());
       }
       if (openingAngle2 > minOpenAngle) {
-        reinterpret_cast<TH2F*>(fMainList->FindObject("Pair")->FindObject("EMCEMC")->FindObject(Form("%s_%s", cut.GetName(), cut.GetName()))->FindObject(paircut.GetName())->FindObject("hMggPt_Same_RotatedBkg"))->Fill(mother2.M(), mother2.Pt());
+        reinterpret_cast<TH2F*>(list_pair_cut->FindObject("hMggPt_Same_RotatedBkg"))->Fill(mother2.M(), mother2.Pt());
       }
     }
   }
@@ -630,47 +765,55 @@ struct Pi0EtaToGammaGamma {
 
   void processPCMPCM(MyCollisions const& collisions, MyFilteredCollisions const& filtered_collisions, MyV0Photons const& v0photons, aod::V0Legs const& legs)
   {
+    FillCutMasks<PairType::kPCMPCM>(v0photons, v0photons, fPCMCuts, fPCMCuts);
     SameEventPairing<PairType::kPCMPCM>(grouped_collisions, v0photons, v0photons, perCollision, perCollision, fPCMCuts, fPCMCuts, fPairCuts, legs, nullptr, nullptr, nullptr);
     MixedEventPairing<PairType::kPCMPCM>(filtered_collisions, v0photons, v0photons, perCollision, perCollision, fPCMCuts, fPCMCuts, fPairCuts, legs, nullptr, nullptr, nullptr);
   }
 
   void processPHOSPHOS(MyCollisions const& collisions, MyFilteredCollisions const& filtered_collisions, aod::PHOSClusters const& phosclusters)
   {
+    FillCutMasks<PairType::kPHOSPHOS>(phosclusters, phosclusters, fPHOSCuts, fPHOSCuts);
     SameEventPairing<PairType::kPHOSPHOS>(grouped_collisions, phosclusters, phosclusters, perCollision_phos, perCollision_phos, fPHOSCuts, fPHOSCuts, fPairCuts, nullptr, nullptr, nullptr, nullptr);
     MixedEventPairing<PairType::kPHOSPHOS>(filtered_collisions, phosclusters, phosclusters, perCollision_phos, perCollision_phos, fPHOSCuts, fPHOSCuts, fPairCuts, nullptr, nullptr, nullptr, nullptr);
   }
 
   void processEMCEMC(MyCollisions const& collisions, MyFilteredCollisions const& filtered_collisions, aod::SkimEMCClusters const& emcclusters, aod::SkimEMCMTs const& emcmatchedtracks)
   {
+    FillCutMasks<PairType::kEMCEMC>(emcclusters, emcclusters, fEMCCuts, fEMCCuts);
     SameEventPairing<PairType::kEMCEMC>(grouped_collisions, emcclusters, emcclusters, perCollision_emc, perCollision_emc, fEMCCuts, fEMCCuts, fPairCuts, nullptr, nullptr, nullptr, emcmatchedtracks);
     MixedEventPairing<PairType::kEMCEMC>(filtered_collisions, emcclusters, emcclusters, perCollision_emc, perCollision_emc, fEMCCuts, fEMCCuts, fPairCuts, nullptr, nullptr, nullptr, emcmatchedtracks);
   }
 
   void processPCMDalitzEE(MyCollisions const& collisions, MyFilteredCollisions const& filtered_collisions, MyV0Photons const& v0photons, aod::V0Legs const& legs, MyFilteredDalitzEEs const& dileptons, MyPrimaryElectrons const& emprimaryelectrons)
   {
+    FillCutMasks<PairType::kPCMDalitzEE>(v0photons, dileptons, fPCMCuts, fDalitzEECuts);
     SameEventPairing<PairType::kPCMDalitzEE>(grouped_collisions, v0photons, dileptons, perCollision, perCollision_dalitzee, fPCMCuts, fDalitzEECuts, fPairCuts, legs, emprimaryelectrons, nullptr, nullptr);
     MixedEventPairing<PairType::kPCMDalitzEE>(filtered_collisions, v0photons, dileptons, perCollision, perCollision_dalitzee, fPCMCuts, fDalitzEECuts, fPairCuts, legs, emprimaryelectrons, nullptr, nullptr);
   }
   void processPCMDalitzMuMu(MyCollisions const& collisions, MyFilteredCollisions const& filtered_collisions, MyV0Photons const& v0photons, aod::V0Legs const& legs, MyFilteredDalitzMuMus const& dileptons, MyPrimaryMuons const& emprimarymuons)
   {
+    FillCutMasks<PairType::kPCMDalitzMuMu>(v0photons, dileptons, fPCMCuts, fDalitzMuMuCuts);
     SameEventPairing<PairType::kPCMDalitzMuMu>(grouped_collisions, v0photons, dileptons, perCollision, perCollision_dalitzmumu, fPCMCuts, fDalitzMuMuCuts, fPairCuts, legs, nullptr, emprimarymuons, nullptr);
     MixedEventPairing<PairType::kPCMDalitzMuMu>(filtered_collisions, v0photons, dileptons, perCollision, perCollision_dalitzmumu, fPCMCuts, fDalitzMuMuCuts, fPairCuts, legs, nullptr, emprimarymuons, nullptr);
   }
 
   void processPCMPHOS(MyCollisions const& collisions, MyFilteredCollisions const& filtered_collisions, MyV0Photons const& v0photons, aod::PHOSClusters const& phosclusters, aod::V0Legs const& legs)
   {
+    FillCutMasks<PairType::kPCMPHOS>(v0photons, phosclusters, fPCMCuts, fPHOSCuts);
     SameEventPairing<PairType::kPCMPHOS>(grouped_collisions, v0photons, phosclusters, perCollision, perCollision_phos, fPCMCuts, fPHOSCuts, fPairCuts, legs, nullptr, nullptr, nullptr);
     MixedEventPairing<PairType::kPCMPHOS>(filtered_collisions, v0photons, phosclusters, perCollision, perCollision_phos, fPCMCuts, fPHOSCuts, fPairCuts, legs, nullptr, nullptr, nullptr);
   }
 
   void processPCMEMC(MyCollisions const& collisions, MyFilteredCollisions const& filtered_collisions, MyV0Photons const& v0photons, aod::SkimEMCClusters const& emcclusters, aod::V0Legs const& legs, aod::SkimEMCMTs const& emcmatchedtracks)
   {
+    FillCutMasks<PairType::kPCMEMC>(v0photons, emcclusters, fPCMCuts, fEMCCuts);
     SameEventPairing<PairType::kPCMEMC>(grouped_collisions, v0photons, emcclusters, perCollision, perCollision_emc, fPCMCuts, fEMCCuts, fPairCuts, legs, nullptr, nullptr, emcmatchedtracks);
     MixedEventPairing<PairType::kPCMEMC>(filtered_collisions, v0photons, emcclusters, perCollision, perCollision_emc, fPCMCuts, fEMCCuts, fPairCuts, legs, nullptr, nullptr, emcmatchedtracks);
   }
 
   void processPHOSEMC(MyCollisions const& collisions, MyFilteredCollisions const& filtered_collisions, aod::PHOSClusters const& phosclusters, aod::SkimEMCClusters const& emcclusters, aod::SkimEMCMTs const& emcmatchedtracks)
   {
+    FillCutMasks<PairType::kPHOSEMC>(phosclusters, emcclusters, fPHOSCuts, fEMCCuts);
     SameEventPairing<PairType::kPHOSEMC>(grouped_collisions, phosclusters, emcclusters, perCollision_phos, perCollision_emc, fPHOSCuts, fEMCCuts, fPairCuts, nullptr, nullptr, nullptr, emcmatchedtracks);
     MixedEventPairing<PairType::kPHOSEMC>(filtered_collisions, phosclusters, emcclusters, perCollision_phos, perCollision_emc, fPHOSCuts, fEMCCuts, fPairCuts, nullptr, nullptr, nullptr, emcmatchedtracks);
   }
@@ -25,6 +25,7 @@
 #include "Framework/ASoAHelpers.h"
 #include "Common/Core/RecoDecay.h"
 #include "PWGEM/PhotonMeson/Utils/PairUtilities.h"
+#include "PWGEM/PhotonMeson/Utils/EventMixingPool.h"
 #include "PWGEM/PhotonMeson/DataModel/gammaTables.h"
 #include "PWGEM/PhotonMeson/Core/V0PhotonCut.h"
 #include "PWGEM/PhotonMeson/Core/DalitzEECut.h"
@@ -108,6 +109,11 @@ struct TaggingPi0 {
     DefinePHOSCuts();
     DefineEMCCuts();
     DefinePairCuts();
+    for (auto ncuts : {fPCMCuts.size(), fDalitzEECuts.size(), fPCMibwCuts.size(), fPHOSCuts.size(), fEMCCuts.size(), fPairCuts.size()}) {
+      if (ncuts > kMaxNCuts) {
+        LOGF(fatal, "At most %d cuts per category are supported, %d given", kMaxNCuts, ncuts);
+      }
+    }
     addhistograms();
 
     fOutputEvent.setObject(reinterpret_cast<THashList*>(fMainList->FindObject("Event")));
@@ -392,62 +398,103 @@ struct TaggingPi0 {
   ConfigurableAxis ConfMultBins{"ConfMultBins", {VARIABLE_WIDTH, 0.0f, 10.f, 20.0f, 40.0f, 60.0f, 80.0f, 100.0f, 200.0f, 1e+10f}, "Mixing bins - multiplicity"};
   using BinningType = ColumnBinningPolicy<aod::collision::PosZ, aod::mult::MultNTracksPV>;
   BinningType colBinning{{ConfVtxBins, ConfMultBins}, true};
+  MixingPool fMixingPool;
 
   template <PairType pairtype, typename TEvents, typename TPhotons1, typename TPhotons2, typename TPreslice1, typename TPreslice2, typename TCuts1, typename TCuts2, typename TPairCuts, typename TLegs, typename TEMPrimaryElectrons>
   void MixedEventPairing(TEvents const& collisions, TPhotons1 const& photons1, TPhotons2 const& photons2, TPreslice1 const& perCollision1, TPreslice2 const& perCollision2, TCuts1 const& cuts1, TCuts2 const& cuts2, TPairCuts const& paircuts, TLegs const& legs, TEMPrimaryElectrons const& emprimaryelectrons)
   {
     THashList* list_pair_ss = static_cast<THashList*>(fMainList->FindObject("Pair")->FindObject(pairnames[pairtype].data()));
+    // histograms of the (cut1, cut2, paircut) combinations, at (icut1 * ncuts2 + icut2) * npaircuts + ipaircut
+    const size_t ncuts2 = cuts2.size();
+    const size_t npaircuts = paircuts.size();
+    std::vector<TH2F*> hMggPt_Mixed(cuts1.size() * ncuts2 * npaircuts, nullptr);
+    for (size_t icut1 = 0; icut1 < cuts1.size(); icut1++) {
+      for (size_t icut2 = 0; icut2 < ncuts2; icut2++) {
+        for (size_t ipaircut = 0; ipaircut < npaircuts; ipaircut++) {
+          hMggPt_Mixed[(icut1 * ncuts2 + icut2) * npaircuts + ipaircut] = reinterpret_cast<TH2F*>(list_pair_ss->FindObject(Form("%s_%s", cuts1[icut1].GetName(), cuts2[icut2].GetName()))->FindObject(paircuts[ipaircut].GetName())->FindObject("hMggPt_Mixed"));
+        }
+      }
+    }
 
-    // LOGF(info, "Number of collisions after filtering: %d", collisions.size());
-    for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, ndepth, -1, collisions, collisions)) { // internally, CombinationsStrictlyUpperIndexPolicy(collisions, collisions) is called.
-
-      // LOGF(info, "Mixed event globalIndex: (%d, %d) , counter = %d, ngpcm: (%d, %d), ngphos: (%d, %d), ngemc: (%d, %d)",
-      //     collision1.globalIndex(), collision2.globalIndex(), nev, collision1.ngpcm(), collision2.ngpcm(), collision1.ngphos(), collision2.ngphos(), collision1.ngemc(), collision2.ngemc());
-
-      auto photons_coll1 = photons1.sliceBy(perCollision1, collision1.globalIndex());
-      auto photons_coll2 = photons2.sliceBy(perCollision2, collision2.globalIndex());
-      // LOGF(info, "collision1: posZ = %f, numContrib = %d , sel8 = %d | collision2: posZ = %f, numContrib = %d , sel8 = %d",
-      //     collision1.posZ(), collision1.numContrib(), collision1.sel8(), collision2.posZ(), collision2.numContrib(), collision2.sel8());
+    fMixingPool.Reset(ndepth);
+    // each collision is paired with the previous ndepth collisions of its bin, as with soa::selfCombinations(colBinning, ndepth, -1, collisions, collisions)
+    for (auto& collision : collisions) {
+      const int bin = colBinning.getBin({collision.posZ(), collision.multNTracksPV()});
+      if (bin < 0) { // underflow and overflow
+        continue;
+      }
 
-      for (auto& cut1 : cuts1) {
-        for (auto& cut2 : cuts2) {
-          for (auto& paircut : paircuts) {
-            for (auto& [g1, g2] : combinations(soa::CombinationsFullIndexPolicy(photons_coll1, photons_coll2))) {
-              // LOGF(info, "Mixed event photon pair: (%d, %d) from events (%d, %d), photon event: (%d, %d)", g1.index(), g2.index(), collision1.index(), collision2.index(), g1.globalIndex(), g2.globalIndex());
+      MixingEvent event;
+      auto photons_coll1 = photons1.sliceBy(perCollision1, collision.globalIndex());
+      auto photons_coll2 = photons2.sliceBy(perCollision2, collision.globalIndex());
+      for (auto& g1 : photons_coll1) { // pcm
+        uint64_t mask = GetCutMask<aod::V0Legs>(g1, cuts1);
+        if (mask == 0) {
+          continue;
+        }
+        if constexpr (pairtype == PairType::kPCMDalitzEE) {
+          event.mPhotons1.push_back(MakeMixingPhoton(g1, mask, 0.f, g1.template posTrack_as<aod::V0Legs>().trackId(), g1.template negTrack_as<aod::V0Legs>().trackId()));
+        } else {
+          event.mPhotons1.push_back(MakeMixingPhoton(g1, mask));
+        }
+      }
+      for (auto& g2 : photons_coll2) { // pcm or phos or emc or dalitzee
+        if constexpr (pairtype == PairType::kPCMPCMibw) {
+          uint64_t mask = GetCutMask<aod::V0Legs>(g2, cuts2);
+          if (mask != 0) {
+            event.mPhotons2.push_back(MakeMixingPhoton(g2, mask));
+          }
+        } else if constexpr (pairtype == PairType::kPCMPHOS) {
+          uint64_t mask = GetCutMask<int>(g2, cuts2);
+          if (mask != 0) {
+            event.mPhotons2.push_back(MakeMixingPhoton(g2, mask));
+          }
+        } else if constexpr (pairtype == PairType::kPCMEMC) {
+          uint64_t mask = GetCutMask<aod::SkimEMCMTs>(g2, cuts2);
+          if (mask != 0) {
+            event.mPhotons2.push_back(MakeMixingPhoton(g2, mask));
+          }
+        } else if constexpr (pairtype == PairType::kPCMDalitzEE) {
+          uint64_t mask = GetCutMask<MyPrimaryElectrons>(g2, cuts2);
+          if (mask != 0) {
+            event.mPhotons2.push_back(MakeMixingPhoton(g2, mask, g2.mass(), g2.template posTrack_as<MyPrimaryElectrons>().trackId(), g2.template negTrack_as<MyPrimaryElectrons>().trackId()));
+          }
+        }
+      }
 
-              if ((pairtype == PairType::kPCMPCM || pairtype == PairType::kPHOSPHOS || pairtype == PairType::kEMCEMC) && (TString(cut1.GetName()) != TString(cut2.GetName()))) {
+      fMixingPool.ForEachPooledEvent(bin, [&](MixingEvent const& pooled_event) {
+        for (auto& g1 : pooled_event.mPhotons1) {
+          for (auto& g2 : event.mPhotons2) {
+            if constexpr (pairtype == PairType::kPCMDalitzEE) {
+              if (g1.mPosTrackId == g2.mPosTrackId || g1.mNegTrackId == g2.mNegTrackId) {
                 continue;
               }
-              if (!IsSelectedPair<pairtype>(g1, g2, cut1, cut2)) {
-                continue;
-              }
-              if (!paircut.IsSelected(g1, g2)) {
+            }
+            ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);         // pcm
+            ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), g2.mass()); // phos or emc or dalitzee
+            ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+
+            for (size_t ipaircut = 0; ipaircut < npaircuts; ipaircut++) {
+              if (!paircuts[ipaircut].IsSelected(g1, g2)) {
                 continue;
               }
-
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.); // pcm
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.); // phos or emc or dalitzee
-              if constexpr (pairtype == PairType::kPCMDalitzEE) {
-                v2.SetM(g2.mass());
-                auto pos_sv = g1.template posTrack_as<aod::V0Legs>();
-                auto ele_sv = g1.template negTrack_as<aod::V0Legs>();
-                auto pos_pv = g2.template posTrack_as<MyPrimaryElectrons>();
-                auto ele_pv = g2.template negTrack_as<MyPrimaryElectrons>();
-                if (pos_sv.trackId() == pos_pv.trackId() || ele_sv.trackId() == ele_pv.trackId()) {
+              for (size_t icut1 = 0; icut1 < cuts1.size(); icut1++) {
+                if (!(g1.mCutMask & (uint64_t(1) << icut1))) {
                   continue;
                 }
-              }
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              // if (abs(v12.Rapidity()) > maxY) {
-              //   continue;
-              // }
-              reinterpret_cast<TH2F*>(list_pair_ss->FindObject(Form("%s_%s", cut1.GetName(), cut2.GetName()))->FindObject(paircut.GetName())->FindObject("hMggPt_Mixed"))->Fill(v12.M(), v1.Pt());
-
-            } // end of different photon combinations
-          }   // end of pair cut loop
-        }     // end of cut2 loop
-      }       // end of cut1 loop
-    }         // end of different collision combinations
+                for (size_t icut2 = 0; icut2 < ncuts2; icut2++) {
+                  if (g2.mCutMask & (uint64_t(1) << icut2)) {
+                    hMggPt_Mixed[(icut1 * ncuts2 + icut2) * npaircuts + ipaircut]->Fill(v12.M(), v1.Pt());
+                  }
+                } // end of cut2 loop
+              }   // end of cut1 loop
+            }     // end of pair cut loop
+          }       // end of photon2 loop
+        }         // end of photon1 loop
+      });
+
+      fMixingPool.Add(bin, std::move(event));
+    } // end of collision loop
   }
 
   Filter collisionFilter_common = nabs(o2::aod::collision::posZ) < 10.f && o2::aod::collision::numContrib > (uint16_t)0 && o2::aod::evsel::sel8 == true;
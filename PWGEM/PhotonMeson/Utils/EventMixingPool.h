@@ -0,0 +1,112 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \commonly used for event mixing in pair analyses.
+/// The photons of each event are reduced once to their kinematics and cut bits and kept in a pool per mixing bin,
+/// holding the last ndepth events of the bin, so that a new event is paired with the pooled ones without slicing again.
+
+#ifndef PWGEM_PHOTONMESON_UTILS_EVENTMIXINGPOOL_H_
+#define PWGEM_PHOTONMESON_UTILS_EVENTMIXINGPOOL_H_
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace o2::aod::photonpair
+{
+constexpr size_t kMaxNCuts = 64; // cuts per category, as one bit per cut is used in the cut masks
+
+// photon reduced to what the mixed-event pairing uses
+struct MixingPhoton {
+  float mPt;
+  float mEta;
+  float mPhi;
+  float mE;
+  float mMass;
+  uint64_t mCutMask; // selection bits in the single-photon cuts
+  int mPosTrackId;   // track id of the positive leg, -1 if not used
+  int mNegTrackId;   // track id of the negative leg, -1 if not used
+
+  float pt() const { return mPt; }
+  float eta() const { return mEta; }
+  float phi() const { return mPhi; }
+  float e() const { return mE; }
+  float mass() const { return mMass; }
+};
+
+template <typename TPhoton>
+MixingPhoton MakeMixingPhoton(TPhoton const& photon, uint64_t cutMask, float mass = 0.f, int posTrackId = -1, int negTrackId = -1)
+{
+  return MixingPhoton{photon.pt(), photon.eta(), photon.phi(), photon.e(), mass, cutMask, posTrackId, negTrackId};
+}
+
+// selection bits of a photon in the single-photon cuts
+template <typename TLeg, typename TPhoton, typename TCuts>
+uint64_t GetCutMask(TPhoton const& photon, TCuts const& cuts)
+{
+  uint64_t mask = 0;
+  for (size_t icut = 0; icut < cuts.size(); icut++) {
+    if (cuts[icut].template IsSelected<TLeg>(photon)) {
+      mask |= uint64_t(1) << icut;
+    }
+  }
+  return mask;
+}
+
+struct MixingEvent {
+  std::vector<MixingPhoton> mPhotons1; // photons of the first kind of the pair
+  std::vector<MixingPhoton> mPhotons2; // photons of the second kind of the pair
+};
+
+class MixingPool
+{
+ public:
+  // empties the pools, e.g. at the beginning of a data frame
+  void Reset(int ndepth)
+  {
+    mDepth = ndepth;
+    for (auto& [bin, pool] : mPools) {
+      pool.clear();
+    }
+  }
+
+  // loops over the pooled events of the bin, from the oldest to the newest
+  template <typename TFunction>
+  void ForEachPooledEvent(int bin, TFunction&& function) const
+  {
+    auto pool = mPools.find(bin);
+    if (pool == mPools.end()) {
+      return;
+    }
+    for (auto& event : pool->second) {
+      function(event);
+    }
+  }
+
+  // adds the event to the pool of its bin, dropping the oldest one beyond ndepth events
+  void Add(int bin, MixingEvent&& event)
+  {
+    auto& pool = mPools[bin];
+    pool.push_back(std::move(event));
+    if (static_cast<int>(pool.size()) > mDepth) {
+      pool.pop_front();
+    }
+  }
+
+ private:
+  int mDepth{0};
+  std::unordered_map<int, std::deque<MixingEvent>> mPools; // last ndepth events per mixing bin
+};
+} // namespace o2::aod::photonpair
+
+#endif // PWGEM_PHOTONMESON_UTILS_EVENTMIXINGPOOL_H_
@@ -51,6 +51,48 @@ bool DoesV0LegMatchWithCluster(TV0Leg const& v0leg, TCluster const& cluster, con
   float Ep = cluster.e() / v0leg.p();
   return (pow(deta / max_deta, 2) + pow(dphi / max_dphi, 2) < 1) && (abs(Ep - 1) < max_Ep_width);
 }
+
+// relative momenta of a photon pair for HBT analyses, with q = v1 - v2 and k = (v1 + v2) / 2
+struct HBTPairVariables {
+  float kt;
+  float qinv; // -m(q), i.e. positive for space-like q
+  float qlong_cms;
+  float qout_cms;  // along kt
+  float qside_cms; // along kt x beam axis
+  float qt_cms;
+  float qlong_lcms; // in the frame where the pair has no longitudinal momentum
+};
+
+// Computes qinv first and the other variables only if qinv does not exceed max_qinv (no limit if max_qinv < 0), so that
+// the pairs out of the q range are rejected before the projections. Returns whether the pair is within the q range.
+inline bool GetHBTPairVariables(float pt1, float eta1, float phi1, float m1, float pt2, float eta2, float phi2, float m2, float max_qinv, HBTPairVariables& vars)
+{
+  const double px1 = pt1 * std::cos(phi1), py1 = pt1 * std::sin(phi1), pz1 = pt1 * std::sinh(eta1);
+  const double px2 = pt2 * std::cos(phi2), py2 = pt2 * std::sin(phi2), pz2 = pt2 * std::sinh(eta2);
+  const double e1 = std::sqrt(px1 * px1 + py1 * py1 + pz1 * pz1 + static_cast<double>(m1) * m1);
+  const double e2 = std::sqrt(px2 * px2 + py2 * py2 + pz2 * pz2 + static_cast<double>(m2) * m2);
+
+  const double qx = px1 - px2, qy = py1 - py2, qz = pz1 - pz2, qe = e1 - e2;
+  const double q2 = qe * qe - qx * qx - qy * qy - qz * qz;
+  vars.qinv = q2 >= 0 ? -std::sqrt(q2) : std::sqrt(-q2);
+  if (max_qinv >= 0.f && vars.qinv > max_qinv) {
+    return false;
+  }
+
+  const double kx = 0.5 * (px1 + px2), ky = 0.5 * (py1 + py2);
+  const double kt = std::sqrt(kx * kx + ky * ky);
+  const double out_x = kx / kt, out_y = ky / kt; // unit vector for out, side is out x (0, 0, 1)
+  vars.kt = kt;
+  vars.qt_cms = std::sqrt(qx * qx + qy * qy);
+  vars.qlong_cms = qz;
+  vars.qout_cms = qx * out_x + qy * out_y;
+  vars.qside_cms = qx * out_y - qy * out_x;
+
+  const float beta_z = (pz1 + pz2) / (e1 + e2);
+  const double gamma_z = 1. / std::sqrt(1. - static_cast<double>(beta_z) * beta_z);
+  vars.qlong_lcms = gamma_z * (qz - beta_z * qe);
+  return true;
+}
 } // namespace o2::aod::photonpair
 
 #endif // PWGEM_PHOTONMESON_UTILS_PAIRUTILITIES_H_
@@ -0,0 +1,102 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \accumulator of the fills of a THnSparse.
+/// The fills are summed per bin in a hash map keyed by the bin coordinates packed into one integer,
+/// and are added to the THnSparse only when flushed, e.g. once per data frame, so that a bin filled
+/// several times is looked up and allocated in the THnSparse only once.
+
+#ifndef PWGEM_PHOTONMESON_UTILS_SPARSEHISTACCUMULATOR_H_
+#define PWGEM_PHOTONMESON_UTILS_SPARSEHISTACCUMULATOR_H_
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "TAxis.h"
+#include "THnSparse.h"
+#include "Framework/Logger.h"
+
+namespace o2::aod::emphotonhistograms
+{
+class SparseHistAccumulator
+{
+ public:
+  explicit SparseHistAccumulator(THnSparse* hist) : mHist(hist)
+  {
+    const int ndim = hist->GetNdimensions();
+    mStrides.resize(ndim);
+    mCoord.resize(ndim);
+    double nkeys = 1.;
+    uint64_t stride = 1;
+    for (int idim = 0; idim < ndim; idim++) {
+      const uint64_t nbins = hist->GetAxis(idim)->GetNbins() + 2; // including underflow and overflow
+      nkeys *= nbins;
+      mStrides[idim] = stride;
+      stride *= nbins;
+    }
+    if (nkeys >= std::pow(2., 64)) {
+      LOGF(fatal, "%s has too many bins to pack the bin coordinates into 64 bits", hist->GetName());
+    }
+  }
+
+  // same as THnSparse::Fill
+  void Fill(const double* x, double w = 1.)
+  {
+    uint64_t key = 0;
+    for (size_t idim = 0; idim < mStrides.size(); idim++) {
+      key += static_cast<uint64_t>(mHist->GetAxis(idim)->FindBin(x[idim])) * mStrides[idim];
+    }
+    auto& sums = mBins[key];
+    sums.mSumW += w;
+    sums.mSumW2 += w * w;
+    mNEntries++;
+  }
+
+  // adds the accumulated fills to the THnSparse and empties the accumulator
+  void Flush()
+  {
+    if (mNEntries == 0) {
+      return;
+    }
+    const bool calculateErrors = mHist->GetCalculateErrors();
+    for (auto& [key, sums] : mBins) {
+      for (size_t idim = 0; idim < mStrides.size(); idim++) {
+        const uint64_t nbins = mHist->GetAxis(idim)->GetNbins() + 2;
+        mCoord[idim] = static_cast<int>((key / mStrides[idim]) % nbins);
+      }
+      const Long64_t bin = mHist->GetBin(mCoord.data(), true);
+      mHist->AddBinContent(bin, sums.mSumW);
+      if (calculateErrors) {
+        mHist->AddBinError2(bin, sums.mSumW2);
+      }
+    }
+    mHist->SetEntries(mHist->GetEntries() + mNEntries);
+    mBins.clear();
+    mNEntries = 0;
+  }
+
+ private:
+  struct BinSums {
+    double mSumW{0.};
+    double mSumW2{0.};
+  };
+
+  THnSparse* mHist;
+  std::vector<uint64_t> mStrides;              // strides of the axes in the packed bin coordinates
+  std::vector<int> mCoord;                     // bin coordinates, used when flushing
+  std::unordered_map<uint64_t, BinSums> mBins; // sums of the weights per packed bin coordinates
+  uint64_t mNEntries{0};
+};
+} // namespace o2::aod::emphotonhistograms
+
+#endif // PWGEM_PHOTONMESON_UTILS_SPARSEHISTACCUMULATOR_H_
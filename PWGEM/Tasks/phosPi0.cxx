@@ -67,6 +67,13 @@ struct phosPi0 {
   std::bitset<nBCsPerOrbit> mbcPatternA;
   std::bitset<nBCsPerOrbit> mbcPatternC;
 
+  enum CluFlag : uint8_t {
+    kCluGood = 0x1, // passes the energy, ncell and time cuts
+    kCluCPV = 0x2,  // no track close to the cluster
+    kCluDisp = 0x4  // passes the dispersion cut
+  };
+  std::vector<uint8_t> mCluFlags; // selections of the clusters, indexed by their row
+
   /// \brief Create output histograms
   void init(InitContext const&)
   {
@@ -252,7 +259,9 @@ struct phosPi0 {
     }
 
     uint64_t bcevent = 0;
+    fillClusterFlags(clusters);
     for (const auto& clu : clusters) {
+      const uint8_t flags1 = mCluFlags[clu.globalIndex()];
       if (clu.collision_as<SelCollisions>().bc_as<BCsWithBcSels>().globalBC() != bcevent) { // New BC
         bcevent = clu.collision_as<SelCollisions>().bc_as<BCsWithBcSels>().globalBC();
         ir.setFromLong(bcevent);
@@ -278,21 +287,20 @@ struct phosPi0 {
 
       mHistManager.fill(HIST("cluETime"), clu.e(), clu.time(), clu.mod());
 
-      if (clu.e() < mMinCluE || clu.ncell() < mMinCluNcell ||
-          clu.time() > mMaxCluTime || clu.time() < mMinCluTime) {
+      if (!(flags1 & kCluGood)) {
         continue;
       }
 
       mHistManager.fill(HIST("cluSp"), clu.e(), clu.mod());
       if (clu.e() > mOccE) {
         mHistManager.fill(HIST("cluOcc"), clu.x(), clu.z(), clu.mod());
-        if (clu.trackdist() > 2.) {
+        if (flags1 & kCluCPV) {
           mHistManager.fill(HIST("cluCPVOcc"), clu.x(), clu.z(), clu.mod());
-          if (TestLambda(clu.e(), clu.m02(), clu.m20())) {
+          if (flags1 & kCluDisp) {
             mHistManager.fill(HIST("cluBothOcc"), clu.x(), clu.z(), clu.mod());
           }
         }
-        if (TestLambda(clu.e(), clu.m02(), clu.m20())) {
+        if (flags1 & kCluDisp) {
           mHistManager.fill(HIST("cluDispOcc"), clu.x(), clu.z(), clu.mod());
         }
         mHistManager.fill(HIST("cluE"), clu.x(), clu.z(), clu.mod(), clu.e());
@@ -305,8 +313,8 @@ struct phosPi0 {
       bool skipMix = false;
       uint64_t bcurrentMix = 0;
       for (; clu2 != clusters.end() && nMix > 0; clu2++) {
-        if (clu2.e() < mMinCluE || clu2.ncell() < mMinCluNcell ||
-            clu2.time() > mMaxCluTime || clu2.time() < mMinCluTime) {
+        const uint8_t flags2 = mCluFlags[clu2.globalIndex()];
+        if (!(flags2 & kCluGood)) {
           continue;
         }
         double m = pow(clu.e() + clu2.e(), 2) - pow(clu.px() + clu2.px(), 2) -
@@ -319,12 +327,12 @@ struct phosPi0 {
         int modComb = ModuleCombination(clu.mod(), clu2.mod());
         if (clu.collision() == clu2.collision()) { // Real
           mHistManager.fill(HIST("mggRe"), m, pt, modComb);
-          if (clu.trackdist() > 2. && clu2.trackdist() > 2.) {
+          if ((flags1 & kCluCPV) && (flags2 & kCluCPV)) {
             mHistManager.fill(HIST("mggReCPV"), m, pt, modComb);
           }
-          if (TestLambda(clu.e(), clu.m02(), clu.m20()) && TestLambda(clu2.e(), clu2.m02(), clu2.m20())) {
+          if ((flags1 & kCluDisp) && (flags2 & kCluDisp)) {
             mHistManager.fill(HIST("mggReDisp"), m, pt, modComb);
-            if (clu.trackdist() > 2. && clu2.trackdist() > 2.) {
+            if ((flags1 & kCluCPV) && (flags2 & kCluCPV)) {
               mHistManager.fill(HIST("mggReBoth"), m, pt, modComb);
             }
           }
@@ -344,12 +352,12 @@ struct phosPi0 {
             continue;
           }
           mHistManager.fill(HIST("mggMi"), m, pt, modComb);
-          if (clu.trackdist() > 2. && clu2.trackdist() > 2.) {
+          if ((flags1 & kCluCPV) && (flags2 & kCluCPV)) {
             mHistManager.fill(HIST("mggMiCPV"), m, pt, modComb);
           }
-          if (TestLambda(clu.e(), clu.m02(), clu.m20()) && TestLambda(clu2.e(), clu2.m02(), clu2.m20())) {
+          if ((flags1 & kCluDisp) && (flags2 & kCluDisp)) {
             mHistManager.fill(HIST("mggMiDisp"), m, pt, modComb);
-            if (clu.trackdist() > 2. && clu2.trackdist() > 2.) {
+            if ((flags1 & kCluCPV) && (flags2 & kCluCPV)) {
               mHistManager.fill(HIST("mggMiBoth"), m, pt, modComb);
             }
           }
@@ -360,7 +368,9 @@ struct phosPi0 {
 
     // same for amb clusters
     bcevent = 0;
+    fillClusterFlags(ambclusters);
     for (const auto& clu : ambclusters) {
+      const uint8_t flags1 = mCluFlags[clu.globalIndex()];
       if (clu.bc_as<BCsWithBcSels>().globalBC() != bcevent) {
         bcevent = clu.bc_as<BCsWithBcSels>().globalBC();
         ir.setFromLong(bcevent);
@@ -382,21 +392,20 @@ struct phosPi0 {
       }
 
       mHistManager.fill(HIST("ambcluETime"), clu.e(), clu.time(), clu.mod());
-      if (clu.e() < mMinCluE || clu.ncell() < mMinCluNcell ||
-          clu.time() > mMaxCluTime || clu.time() < mMinCluTime) {
+      if (!(flags1 & kCluGood)) {
         continue;
       }
 
       mHistManager.fill(HIST("ambcluSp"), clu.e(), clu.mod());
       if (clu.e() > mOccE) {
         mHistManager.fill(HIST("ambcluOcc"), clu.x(), clu.z(), clu.mod());
-        if (clu.trackdist() > 2.) {
+        if (flags1 & kCluCPV) {
           mHistManager.fill(HIST("ambcluCPVOcc"), clu.x(), clu.z(), clu.mod());
-          if (TestLambda(clu.e(), clu.m02(), clu.m20())) {
+          if (flags1 & kCluDisp) {
             mHistManager.fill(HIST("ambcluBothOcc"), clu.x(), clu.z(), clu.mod());
           }
         }
-        if (TestLambda(clu.e(), clu.m02(), clu.m20())) {
+        if (flags1 & kCluDisp) {
           mHistManager.fill(HIST("ambcluDispOcc"), clu.x(), clu.z(), clu.mod());
         }
         mHistManager.fill(HIST("ambcluE"), clu.x(), clu.z(), clu.mod(), clu.e());
@@ -409,8 +418,8 @@ struct phosPi0 {
       uint64_t bcurrentMix = 0;
       bool skipMix = false;
       for (; clu2 != ambclusters.end() && nMix > 0; clu2++) {
-        if (clu2.e() < mMinCluE || clu2.ncell() < mMinCluNcell ||
-            clu2.time() > mMaxCluTime || clu2.time() < mMinCluTime) {
+        const uint8_t flags2 = mCluFlags[clu2.globalIndex()];
+        if (!(flags2 & kCluGood)) {
           continue;
         }
         double m = pow(clu.e() + clu2.e(), 2) - pow(clu.px() + clu2.px(), 2) -
@@ -423,12 +432,12 @@ struct phosPi0 {
         int modComb = ModuleCombination(clu.mod(), clu2.mod());
         if (clu.bc_as<BCsWithBcSels>() == clu2.bc_as<BCsWithBcSels>()) { // Real
           mHistManager.fill(HIST("mggReAmb"), m, pt, modComb);
-          if (clu.trackdist() > 2. && clu2.trackdist() > 2.) {
+          if ((flags1 & kCluCPV) && (flags2 & kCluCPV)) {
             mHistManager.fill(HIST("mggReAmbCPV"), m, pt, modComb);
           }
-          if (TestLambda(clu.e(), clu.m02(), clu.m20()) && TestLambda(clu2.e(), clu2.m02(), clu2.m20())) {
+          if ((flags1 & kCluDisp) && (flags2 & kCluDisp)) {
             mHistManager.fill(HIST("mggReAmbDisp"), m, pt, modComb);
-            if (clu.trackdist() > 2. && clu2.trackdist() > 2.) {
+            if ((flags1 & kCluCPV) && (flags2 & kCluCPV)) {
               mHistManager.fill(HIST("mggReAmbBoth"), m, pt, modComb);
             }
           }
@@ -448,12 +457,12 @@ struct phosPi0 {
             continue;
           }
           mHistManager.fill(HIST("mggMiAmb"), m, pt, modComb);
-          if (clu.trackdist() > 2. && clu2.trackdist() > 2.) {
+          if ((flags1 & kCluCPV) && (flags2 & kCluCPV)) {
             mHistManager.fill(HIST("mggMiAmbCPV"), m, pt, modComb);
           }
-          if (TestLambda(clu.e(), clu.m02(), clu.m20()) && TestLambda(clu2.e(), clu2.m02(), clu2.m20())) {
+          if ((flags1 & kCluDisp) && (flags2 & kCluDisp)) {
             mHistManager.fill(HIST("mggMiAmbDisp"), m, pt, modComb);
-            if (clu.trackdist() > 2. && clu2.trackdist() > 2.) {
+            if ((flags1 & kCluCPV) && (flags2 & kCluCPV)) {
               mHistManager.fill(HIST("mggMiAmbBoth"), m, pt, modComb);
             }
           }
@@ -462,6 +471,28 @@ struct phosPi0 {
     }
   }
 
+  //_____________________________________________________________________________
+  /// \brief Evaluates the cluster selections once per cluster, as they are used again in every pair of the cluster
+  template <typename TClusters>
+  void fillClusterFlags(TClusters const& clusters)
+  {
+    mCluFlags.resize(clusters.size());
+    for (const auto& clu : clusters) {
+      uint8_t flags = 0;
+      if (!(clu.e() < mMinCluE || clu.ncell() < mMinCluNcell ||
+            clu.time() > mMaxCluTime || clu.time() < mMinCluTime)) {
+        flags |= kCluGood;
+      }
+      if (clu.trackdist() > 2.) {
+        flags |= kCluCPV;
+      }
+      if (TestLambda(clu.e(), clu.m02(), clu.m20())) {
+        flags |= kCluDisp;
+      }
+      mCluFlags[clu.globalIndex()] = flags;
+    }
+  }
+
   //_____________________________________________________________________________
   int ModuleCombination(int m1, int m2)
   {
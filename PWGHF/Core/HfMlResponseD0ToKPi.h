@@ -117,17 +117,16 @@ class HfMlResponseD0ToKPi : public HfMlResponse<TypeOutputScore>
 
   HfHelper hfHelper;
 
-  /// Method to get the input features vector needed for ML inference
+  /// Method to fill the input features vector needed for ML inference, reusing its memory
+  /// \param inputFeatures is the vector to be filled, cleared first
   /// \param candidate is the D0 candidate
   /// \param prong0 is the candidate's prong0
   /// \param prong1 is the candidate's prong1
-  /// \return inputFeatures vector
   template <typename T1, typename T2>
-  std::vector<float> getInputFeatures(T1 const& candidate,
-                                      T2 const& prong0, T2 const& prong1, int const& pdgCode)
+  void fillInputFeatures(std::vector<float>& inputFeatures, T1 const& candidate,
+                         T2 const& prong0, T2 const& prong1, int const& pdgCode)
   {
-    std::vector<float> inputFeatures;
-
+    inputFeatures.clear();
     for (const auto& idx : MlResponse<TypeOutputScore>::mCachedIndices) {
       switch (idx) {
         CHECK_AND_FILL_VEC_D0(chi2PCA);
@@ -163,7 +162,64 @@ class HfMlResponseD0ToKPi : public HfMlResponse<TypeOutputScore>
         CHECK_AND_FILL_VEC_D0_HFHELPER(candidate, ct, ctD0);
       }
     }
+  }
 
+  /// Method to fill the input features vector from a candidate of the derived tables, reusing its memory
+  /// \param inputFeatures is the vector to be filled, cleared first
+  /// \param candidate is the derived D0 candidate (join of the HfD0Pars and HfD0ParEs tables), for the selected mass hypothesis
+  /// \note The derived columns are named after the input features and cosThetaStar is already computed for the mass hypothesis of the row.
+  template <typename T1>
+  void fillInputFeaturesDerived(std::vector<float>& inputFeatures, T1 const& candidate)
+  {
+    inputFeatures.clear();
+    for (const auto& idx : MlResponse<TypeOutputScore>::mCachedIndices) {
+      switch (idx) {
+        CHECK_AND_FILL_VEC_D0(chi2PCA);
+        CHECK_AND_FILL_VEC_D0(decayLength);
+        CHECK_AND_FILL_VEC_D0(decayLengthXY);
+        CHECK_AND_FILL_VEC_D0(decayLengthNormalised);
+        CHECK_AND_FILL_VEC_D0(decayLengthXYNormalised);
+        CHECK_AND_FILL_VEC_D0(ptProng0);
+        CHECK_AND_FILL_VEC_D0(ptProng1);
+        CHECK_AND_FILL_VEC_D0(impactParameter0);
+        CHECK_AND_FILL_VEC_D0(impactParameter1);
+        // TPC PID variables
+        CHECK_AND_FILL_VEC_D0(nSigTpcPi0);
+        CHECK_AND_FILL_VEC_D0(nSigTpcKa0);
+        CHECK_AND_FILL_VEC_D0(nSigTpcPi1);
+        CHECK_AND_FILL_VEC_D0(nSigTpcKa1);
+        // TOF PID variables
+        CHECK_AND_FILL_VEC_D0(nSigTofPi0);
+        CHECK_AND_FILL_VEC_D0(nSigTofKa0);
+        CHECK_AND_FILL_VEC_D0(nSigTofPi1);
+        CHECK_AND_FILL_VEC_D0(nSigTofKa1);
+        // Combined PID variables
+        CHECK_AND_FILL_VEC_D0(nSigTpcTofPi0);
+        CHECK_AND_FILL_VEC_D0(nSigTpcTofKa0);
+        CHECK_AND_FILL_VEC_D0(nSigTpcTofPi1);
+        CHECK_AND_FILL_VEC_D0(nSigTpcTofKa1);
+        CHECK_AND_FILL_VEC_D0(maxNormalisedDeltaIP);
+        CHECK_AND_FILL_VEC_D0(impactParameterProduct);
+        CHECK_AND_FILL_VEC_D0(cosThetaStar);
+        CHECK_AND_FILL_VEC_D0(cpa);
+        CHECK_AND_FILL_VEC_D0(cpaXY);
+        CHECK_AND_FILL_VEC_D0(ct);
+      }
+    }
+  }
+
+  /// Method to get the input features vector needed for ML inference
+  /// \param candidate is the D0 candidate
+  /// \param prong0 is the candidate's prong0
+  /// \param prong1 is the candidate's prong1
+  /// \return inputFeatures vector
+  template <typename T1, typename T2>
+  std::vector<float> getInputFeatures(T1 const& candidate,
+                                      T2 const& prong0, T2 const& prong1, int const& pdgCode)
+  {
+    std::vector<float> inputFeatures;
+    inputFeatures.reserve(MlResponse<TypeOutputScore>::mCachedIndices.size());
+    fillInputFeatures(inputFeatures, candidate, prong0, prong1, pdgCode);
     return inputFeatures;
   }
 
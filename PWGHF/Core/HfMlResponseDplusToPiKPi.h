@@ -92,18 +92,17 @@ class HfMlResponseDplusToPiKPi : public HfMlResponse<TypeOutputScore>
   /// Default destructor
   virtual ~HfMlResponseDplusToPiKPi() = default;
 
-  /// Method to get the input features vector needed for ML inference
+  /// Method to fill the input features vector needed for ML inference, reusing its memory
+  /// \param inputFeatures is the vector to be filled, cleared first
   /// \param candidate is the Dplus candidate
   /// \param prong0 is the candidate's prong0
   /// \param prong1 is the candidate's prong1
   /// \param prong2 is the candidate's prong2
-  /// \return inputFeatures vector
   template <typename T1, typename T2>
-  std::vector<float> getInputFeatures(T1 const& candidate,
-                                      T2 const& prong0, T2 const& prong1, T2 const& prong2)
+  void fillInputFeatures(std::vector<float>& inputFeatures, T1 const& candidate,
+                         T2 const& prong0, T2 const& prong1, T2 const& prong2)
   {
-    std::vector<float> inputFeatures;
-
+    inputFeatures.clear();
     for (const auto& idx : MlResponse<TypeOutputScore>::mCachedIndices) {
       switch (idx) {
         CHECK_AND_FILL_VEC_DPLUS(ptProng0);
@@ -140,7 +139,21 @@ class HfMlResponseDplusToPiKPi : public HfMlResponse<TypeOutputScore>
         CHECK_AND_FILL_VEC_DPLUS_FULL(prong2, tpcTofNSigmaKa2, tpcTofNSigmaKa);
       }
     }
+  }
 
+  /// Method to get the input features vector needed for ML inference
+  /// \param candidate is the Dplus candidate
+  /// \param prong0 is the candidate's prong0
+  /// \param prong1 is the candidate's prong1
+  /// \param prong2 is the candidate's prong2
+  /// \return inputFeatures vector
+  template <typename T1, typename T2>
+  std::vector<float> getInputFeatures(T1 const& candidate,
+                                      T2 const& prong0, T2 const& prong1, T2 const& prong2)
+  {
+    std::vector<float> inputFeatures;
+    inputFeatures.reserve(MlResponse<TypeOutputScore>::mCachedIndices.size());
+    fillInputFeatures(inputFeatures, candidate, prong0, prong1, prong2);
     return inputFeatures;
   }
 
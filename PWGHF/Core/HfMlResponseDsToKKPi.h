@@ -106,19 +106,18 @@ class HfMlResponseDsToKKPi : public HfMlResponse<TypeOutputScore>
 
   HfHelper hfHelper;
 
-  /// Method to get the input features vector needed for ML inference
+  /// Method to fill the input features vector needed for ML inference, reusing its memory
+  /// \param inputFeatures is the vector to be filled, cleared first
   /// \param candidate is the Ds candidate
   /// \param prong0 is the candidate's prong0
   /// \param prong1 is the candidate's prong1
   /// \param prong2 is the candidate's prong2
   /// \param caseDsToKKPi used to divide the case DsToKKPi from DsToPiKK
-  /// \return inputFeatures vector
   template <typename T1, typename T2>
-  std::vector<float> getInputFeatures(T1 const& candidate,
-                                      T2 const& prong0, T2 const& prong1, T2 const& prong2, bool const& caseDsToKKPi)
+  void fillInputFeatures(std::vector<float>& inputFeatures, T1 const& candidate,
+                         T2 const& prong0, T2 const& prong1, T2 const& prong2, bool const& caseDsToKKPi)
   {
-    std::vector<float> inputFeatures;
-
+    inputFeatures.clear();
     for (const auto& idx : MlResponse<TypeOutputScore>::mCachedIndices) {
       switch (idx) {
         CHECK_AND_FILL_VEC_DS(chi2PCA);
@@ -148,7 +147,22 @@ class HfMlResponseDsToKKPi : public HfMlResponse<TypeOutputScore>
         CHECK_AND_FILL_VEC_DS_HFHELPER_SIGNED(candidate, deltaMassPhi, deltaMassPhiDsToKKPi, deltaMassPhiDsToPiKK);
       }
     }
+  }
 
+  /// Method to get the input features vector needed for ML inference
+  /// \param candidate is the Ds candidate
+  /// \param prong0 is the candidate's prong0
+  /// \param prong1 is the candidate's prong1
+  /// \param prong2 is the candidate's prong2
+  /// \param caseDsToKKPi used to divide the case DsToKKPi from DsToPiKK
+  /// \return inputFeatures vector
+  template <typename T1, typename T2>
+  std::vector<float> getInputFeatures(T1 const& candidate,
+                                      T2 const& prong0, T2 const& prong1, T2 const& prong2, bool const& caseDsToKKPi)
+  {
+    std::vector<float> inputFeatures;
+    inputFeatures.reserve(MlResponse<TypeOutputScore>::mCachedIndices.size());
+    fillInputFeatures(inputFeatures, candidate, prong0, prong1, prong2, caseDsToKKPi);
     return inputFeatures;
   }
 
@@ -105,16 +105,15 @@ class HfMlResponseLcToK0sP : public HfMlResponse<TypeOutputScore>
 
   HfHelper hfHelper;
 
-  /// Method to get the input features vector needed for ML inference
+  /// Method to fill the input features vector needed for ML inference, reusing its memory
+  /// \param inputFeatures is the vector to be filled, cleared first
   /// \param candidate is the Lc candidate
   /// \param bach is the bachelor candidate (proton)
-  /// \return inputFeatures vector
   template <typename T1, typename T2>
-  std::vector<float> getInputFeatures(T1 const& candidate,
-                                      T2 const& bach)
+  void fillInputFeatures(std::vector<float>& inputFeatures, T1 const& candidate,
+                         T2 const& bach)
   {
-    std::vector<float> inputFeatures;
-
+    inputFeatures.clear();
     for (const auto& idx : MlResponse<TypeOutputScore>::mCachedIndices) {
       switch (idx) {
         CHECK_AND_FILL_VEC_LC(chi2PCA);
@@ -153,7 +152,19 @@ class HfMlResponseLcToK0sP : public HfMlResponse<TypeOutputScore>
         CHECK_AND_FILL_VEC_LC_FULL(bach, nSigmaTpcTofPr0, tpcTofNSigmaPr);
       }
     }
+  }
 
+  /// Method to get the input features vector needed for ML inference
+  /// \param candidate is the Lc candidate
+  /// \param bach is the bachelor candidate (proton)
+  /// \return inputFeatures vector
+  template <typename T1, typename T2>
+  std::vector<float> getInputFeatures(T1 const& candidate,
+                                      T2 const& bach)
+  {
+    std::vector<float> inputFeatures;
+    inputFeatures.reserve(MlResponse<TypeOutputScore>::mCachedIndices.size());
+    fillInputFeatures(inputFeatures, candidate, bach);
     return inputFeatures;
   }
 
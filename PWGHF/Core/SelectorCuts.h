@@ -352,6 +352,25 @@ static const std::vector<std::string> labelsPt = {
 
 // column labels
 static const std::vector<std::string> labelsCutVar = {"m", "DCA", "cos theta*", "pT K", "pT Pi", "d0K", "d0pi", "d0d0", "cos pointing angle", "cos pointing angle xy", "min norm decay length XY", "max decay length", "max decay length XY", "min decay length", "norm dauImpPar XY"};
+
+// column indices of the cut variables, in the order of labelsCutVar
+enum CutVar : int {
+  Mass = 0,
+  Dca,
+  CosThetaStar,
+  PtK,
+  PtPi,
+  D0K,
+  D0Pi,
+  D0D0,
+  CosPointingAngle,
+  CosPointingAngleXY,
+  MinNormDecayLengthXY,
+  MaxDecayLength,
+  MaxDecayLengthXY,
+  MinDecayLength,
+  NormDauImpParXY
+};
 } // namespace hf_cuts_d0_to_pi_k
 
 namespace hf_cuts_dstar_to_d0_pi
@@ -125,7 +125,6 @@ struct HfCandidateCreatorB0Reduced {
           continue;
         }
 
-        auto trackParCovPi = getTrackParCov(trackPion);
         std::array<float, 3> pVecPion = {trackPion.px(), trackPion.py(), trackPion.pz()};
 
         // compute invariant mass square and apply selection
@@ -133,6 +132,8 @@ struct HfCandidateCreatorB0Reduced {
         if ((invMass2DPi < invMass2DPiMin) || (invMass2DPi > invMass2DPiMax)) {
           continue;
         }
+        // the track parametrisation is only needed for the pairs in the invariant-mass window
+        auto trackParCovPi = getTrackParCov(trackPion);
         // ---------------------------------
         // reconstruct the 2-prong B0 vertex
         if (df2.process(trackParCovD, trackParCovPi) == 0) {
@@ -123,13 +123,12 @@ struct HfCandidateCreatorBplusReduced {
       df2.setBz(bz);
 
       auto candsDThisColl = candsD.sliceBy(candsDPerCollision, thisCollId);
+      auto tracksPionThisCollision = tracksPion.sliceBy(tracksPionPerCollision, thisCollId);
       for (const auto& candD0 : candsDThisColl) {
         auto trackParCovD = getTrackParCov(candD0);
         std::array<float, 3> pVecD0 = {candD0.px(), candD0.py(), candD0.pz()};
 
-        auto tracksPionThisCollision = tracksPion.sliceBy(tracksPionPerCollision, thisCollId);
         for (const auto& trackPion : tracksPionThisCollision) {
-          auto trackParCovPi = getTrackParCov(trackPion);
           std::array<float, 3> pVecPion = {trackPion.px(), trackPion.py(), trackPion.pz()};
 
           // compute invariant mass square and apply selection
@@ -137,6 +136,8 @@ struct HfCandidateCreatorBplusReduced {
           if ((invMass2D0Pi < invMass2D0PiMin) || (invMass2D0Pi > invMass2D0PiMax)) {
             continue;
           }
+          // the track parametrisation is only needed for the pairs in the invariant-mass window
+          auto trackParCovPi = getTrackParCov(trackPion);
           // ---------------------------------
           // reconstruct the 2-prong B+ vertex
           if (df2.process(trackParCovD, trackParCovPi) == 0) {
@@ -199,6 +199,8 @@ struct HfTaskD0 {
         massD0bar = hfHelper.invMassD0barToKPi(candidate);
       }
       auto ptCandidate = candidate.pt();
+      auto ctsCandidate = hfHelper.cosThetaStarD0(candidate);
+      auto ctCandidate = hfHelper.ctD0(candidate);
 
       if (candidate.isSelD0() >= selectionFlagD0) {
         registry.fill(HIST("hMass"), massD0, ptCandidate);
@@ -224,8 +226,8 @@ struct HfTaskD0 {
       registry.fill(HIST("hd0ErrProng0"), candidate.errorImpactParameter0(), ptCandidate);
       registry.fill(HIST("hd0ErrProng1"), candidate.errorImpactParameter1(), ptCandidate);
       registry.fill(HIST("hd0d0"), candidate.impactParameterProduct(), ptCandidate);
-      registry.fill(HIST("hCTS"), hfHelper.cosThetaStarD0(candidate), ptCandidate);
-      registry.fill(HIST("hCt"), hfHelper.ctD0(candidate), ptCandidate);
+      registry.fill(HIST("hCTS"), ctsCandidate, ptCandidate);
+      registry.fill(HIST("hCt"), ctCandidate, ptCandidate);
       registry.fill(HIST("hCPA"), candidate.cpa(), ptCandidate);
       registry.fill(HIST("hEta"), candidate.eta(), ptCandidate);
       registry.fill(HIST("hSelectionStatus"), candidate.isSelD0() + (candidate.isSelD0bar() * 2), ptCandidate);
@@ -234,8 +236,8 @@ struct HfTaskD0 {
       registry.fill(HIST("hd0Prong0FinerBinning"), candidate.impactParameter0(), ptCandidate);
       registry.fill(HIST("hd0Prong1FinerBinning"), candidate.impactParameter1(), ptCandidate);
       registry.fill(HIST("hd0d0FinerBinning"), candidate.impactParameterProduct(), ptCandidate);
-      registry.fill(HIST("hCTSFinerBinning"), hfHelper.cosThetaStarD0(candidate), ptCandidate);
-      registry.fill(HIST("hCtFinerBinning"), hfHelper.ctD0(candidate), ptCandidate);
+      registry.fill(HIST("hCTSFinerBinning"), ctsCandidate, ptCandidate);
+      registry.fill(HIST("hCtFinerBinning"), ctCandidate, ptCandidate);
       registry.fill(HIST("hCPAFinerBinning"), candidate.cpa(), ptCandidate);
       registry.fill(HIST("hCPAXYFinerBinning"), candidate.cpaXY(), ptCandidate);
     }
@@ -253,6 +253,7 @@ struct HfTaskFlowCharmHadrons {
       case qvecEstimator::FT0C:
         xQVec = collision.qvecFT0CRe();
         yQVec = collision.qvecFT0CIm();
+        break;
       case qvecEstimator::TPCPos:
         xQVec = collision.qvecBPosRe();
         yQVec = collision.qvecBPosIm();
@@ -284,11 +285,18 @@ struct HfTaskFlowCharmHadrons {
     float yQVec = qVecs[1];
     float amplQVec = qVecs[2];
     float evtPl = epHelper.GetEventPlane(xQVec, yQVec, harmonic);
+    // the event plane is the same for all the candidates of the collision
+    float cosNEvtPl = std::cos(harmonic * evtPl);
+    float sinNEvtPl = std::sin(harmonic * evtPl);
     float cent = getCentrality(collision);
 
+    std::vector<float> outputMl(2);
+    std::vector<float> tracksQx;
+    std::vector<float> tracksQy;
     for (const auto& candidate : candidates) {
       float massCand = 0.;
-      std::vector<float> outputMl = {-999., -999.};
+      outputMl[0] = -999.;
+      outputMl[1] = -999.;
 
       if constexpr (std::is_same<T1, CandDsData>::value || std::is_same<T1, CandDsDatawMl>::value) {
         switch (DecayChannel) {
@@ -320,21 +328,24 @@ struct HfTaskFlowCharmHadrons {
       float phiCand = candidate.phi();
 
       // If TPC is used for the SP estimation, the tracks of the hadron candidate must be removed from the TPC Q vector to avoid double counting
+      float xQVecCand = xQVec;
+      float yQVecCand = yQVec;
       if (qvecDetector == qvecEstimator::TPCNeg || qvecDetector == qvecEstimator::TPCPos) {
         float ampl = amplQVec - 3.;
-        std::vector<float> tracksQx = {};
-        std::vector<float> tracksQy = {};
+        tracksQx.clear();
+        tracksQy.clear();
         getQvecDtracks(candidate, tracksQx, tracksQy, ampl);
         for (unsigned int itrack = 0; itrack < 3; itrack++) {
-          xQVec -= tracksQx[itrack];
-          yQVec -= tracksQy[itrack];
+          xQVecCand -= tracksQx[itrack];
+          yQVecCand -= tracksQy[itrack];
         }
       }
 
       float cosNPhi = std::cos(harmonic * phiCand);
       float sinNPhi = std::sin(harmonic * phiCand);
-      float scalprodCand = cosNPhi * xQVec + sinNPhi * yQVec;
-      float cosDeltaPhi = std::cos(harmonic * (phiCand - evtPl));
+      float scalprodCand = cosNPhi * xQVecCand + sinNPhi * yQVecCand;
+      // cos(n(phi - psi)) from the cosine and sine of n*phi and n*psi
+      float cosDeltaPhi = cosNPhi * cosNEvtPl + sinNPhi * sinNEvtPl;
 
       fillThn(massCand, ptCand, cent, cosNPhi, cosDeltaPhi, scalprodCand, outputMl);
     }
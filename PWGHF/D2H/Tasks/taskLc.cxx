@@ -263,15 +263,18 @@ struct HfTaskLc {
         continue;
       }
       auto pt = candidate.pt();
+      auto ctCandidate = hfHelper.ctLc(candidate);
       if (candidate.isSelLcToPKPi() >= selectionFlagLc) {
-        registry.fill(HIST("Data/hMass"), hfHelper.invMassLcToPKPi(candidate));
-        registry.fill(HIST("Data/hMassVsPtVsMult"), hfHelper.invMassLcToPKPi(candidate), pt, nTracks);
-        registry.fill(HIST("Data/hMassVsPt"), hfHelper.invMassLcToPKPi(candidate), pt);
+        auto massLc = hfHelper.invMassLcToPKPi(candidate);
+        registry.fill(HIST("Data/hMass"), massLc);
+        registry.fill(HIST("Data/hMassVsPtVsMult"), massLc, pt, nTracks);
+        registry.fill(HIST("Data/hMassVsPt"), massLc, pt);
       }
       if (candidate.isSelLcToPiKP() >= selectionFlagLc) {
-        registry.fill(HIST("Data/hMass"), hfHelper.invMassLcToPiKP(candidate));
-        registry.fill(HIST("Data/hMassVsPtVsMult"), hfHelper.invMassLcToPiKP(candidate), pt, nTracks);
-        registry.fill(HIST("Data/hMassVsPt"), hfHelper.invMassLcToPiKP(candidate), pt);
+        auto massLc = hfHelper.invMassLcToPiKP(candidate);
+        registry.fill(HIST("Data/hMass"), massLc);
+        registry.fill(HIST("Data/hMassVsPtVsMult"), massLc, pt, nTracks);
+        registry.fill(HIST("Data/hMassVsPt"), massLc, pt);
       }
       registry.fill(HIST("Data/hPt"), pt);
       registry.fill(HIST("Data/hPtProng0"), candidate.ptProng0());
@@ -287,8 +290,8 @@ struct HfTaskLc {
       registry.fill(HIST("Data/hDecLengthVsPt"), candidate.decayLength(), pt);
       registry.fill(HIST("Data/hDecLengthxy"), candidate.decayLengthXY());
       registry.fill(HIST("Data/hDecLengthxyVsPt"), candidate.decayLengthXY(), pt);
-      registry.fill(HIST("Data/hCt"), hfHelper.ctLc(candidate));
-      registry.fill(HIST("Data/hCtVsPt"), hfHelper.ctLc(candidate), pt);
+      registry.fill(HIST("Data/hCt"), ctCandidate);
+      registry.fill(HIST("Data/hCtVsPt"), ctCandidate, pt);
       registry.fill(HIST("Data/hCPA"), candidate.cpa());
       registry.fill(HIST("Data/hCPAVsPt"), candidate.cpa(), pt);
       registry.fill(HIST("Data/hCPAxy"), candidate.cpaXY());
@@ -331,14 +334,17 @@ struct HfTaskLc {
         auto particleMother = mcParticles.rawIteratorAt(indexMother);
         registry.fill(HIST("MC/generated/signal/hPtGenSig"), particleMother.pt()); // gen. level pT
         auto pt = candidate.pt();
+        auto ctCandidate = hfHelper.ctLc(candidate);
+        auto massLcToPKPi = hfHelper.invMassLcToPKPi(candidate);
+        auto massLcToPiKP = hfHelper.invMassLcToPiKP(candidate);
         /// MC reconstructed signal
         if ((candidate.isSelLcToPKPi() >= selectionFlagLc) && pdgCodeProng0 == kProton) {
-          registry.fill(HIST("MC/reconstructed/signal/hMassRecSig"), hfHelper.invMassLcToPKPi(candidate));
-          registry.fill(HIST("MC/reconstructed/signal/hMassVsPtRecSig"), hfHelper.invMassLcToPKPi(candidate), pt);
+          registry.fill(HIST("MC/reconstructed/signal/hMassRecSig"), massLcToPKPi);
+          registry.fill(HIST("MC/reconstructed/signal/hMassVsPtRecSig"), massLcToPKPi, pt);
         }
         if ((candidate.isSelLcToPiKP() >= selectionFlagLc) && pdgCodeProng0 == kPiPlus) {
-          registry.fill(HIST("MC/reconstructed/signal/hMassRecSig"), hfHelper.invMassLcToPiKP(candidate));
-          registry.fill(HIST("MC/reconstructed/signal/hMassVsPtRecSig"), hfHelper.invMassLcToPiKP(candidate), pt);
+          registry.fill(HIST("MC/reconstructed/signal/hMassRecSig"), massLcToPiKP);
+          registry.fill(HIST("MC/reconstructed/signal/hMassVsPtRecSig"), massLcToPiKP, pt);
         }
         registry.fill(HIST("MC/reconstructed/signal/hPtRecSig"), pt);
         registry.fill(HIST("MC/reconstructed/signal/hPtRecProng0Sig"), candidate.ptProng0());
@@ -355,8 +361,8 @@ struct HfTaskLc {
         registry.fill(HIST("MC/reconstructed/signal/hDecLengthVsPtRecSig"), candidate.decayLength(), pt);
         registry.fill(HIST("MC/reconstructed/signal/hDecLengthxyRecSig"), candidate.decayLengthXY());
         registry.fill(HIST("MC/reconstructed/signal/hDecLengthxyVsPtRecSig"), candidate.decayLengthXY(), pt);
-        registry.fill(HIST("MC/reconstructed/signal/hCtRecSig"), hfHelper.ctLc(candidate));
-        registry.fill(HIST("MC/reconstructed/signal/hCtVsPtRecSig"), hfHelper.ctLc(candidate), pt);
+        registry.fill(HIST("MC/reconstructed/signal/hCtRecSig"), ctCandidate);
+        registry.fill(HIST("MC/reconstructed/signal/hCtVsPtRecSig"), ctCandidate, pt);
         registry.fill(HIST("MC/reconstructed/signal/hCPARecSig"), candidate.cpa());
         registry.fill(HIST("MC/reconstructed/signal/hCPAVsPtRecSig"), candidate.cpa(), pt);
         registry.fill(HIST("MC/reconstructed/signal/hCPAxyRecSig"), candidate.cpaXY());
@@ -375,12 +381,12 @@ struct HfTaskLc {
         /// reconstructed signal prompt
         if (candidate.originMcRec() == RecoDecay::OriginType::Prompt) {
           if ((candidate.isSelLcToPKPi() >= selectionFlagLc) && pdgCodeProng0 == kProton) {
-            registry.fill(HIST("MC/reconstructed/prompt/hMassRecSigPrompt"), hfHelper.invMassLcToPKPi(candidate));
-            registry.fill(HIST("MC/reconstructed/prompt/hMassVsPtRecSigPrompt"), hfHelper.invMassLcToPKPi(candidate), pt);
+            registry.fill(HIST("MC/reconstructed/prompt/hMassRecSigPrompt"), massLcToPKPi);
+            registry.fill(HIST("MC/reconstructed/prompt/hMassVsPtRecSigPrompt"), massLcToPKPi, pt);
           }
           if ((candidate.isSelLcToPiKP() >= selectionFlagLc) && pdgCodeProng0 == kPiPlus) {
-            registry.fill(HIST("MC/reconstructed/prompt/hMassRecSigPrompt"), hfHelper.invMassLcToPiKP(candidate));
-            registry.fill(HIST("MC/reconstructed/prompt/hMassVsPtRecSigPrompt"), hfHelper.invMassLcToPiKP(candidate), pt);
+            registry.fill(HIST("MC/reconstructed/prompt/hMassRecSigPrompt"), massLcToPiKP);
+            registry.fill(HIST("MC/reconstructed/prompt/hMassVsPtRecSigPrompt"), massLcToPiKP, pt);
           }
           registry.fill(HIST("MC/reconstructed/prompt/hPtRecSigPrompt"), pt);
           registry.fill(HIST("MC/reconstructed/prompt/hPtRecProng0SigPrompt"), candidate.ptProng0());
@@ -396,8 +402,8 @@ struct HfTaskLc {
           registry.fill(HIST("MC/reconstructed/prompt/hDecLengthVsPtRecSigPrompt"), candidate.decayLength(), pt);
           registry.fill(HIST("MC/reconstructed/prompt/hDecLengthxyRecSigPrompt"), candidate.decayLengthXY());
           registry.fill(HIST("MC/reconstructed/prompt/hDecLengthxyVsPtRecSigPrompt"), candidate.decayLengthXY(), pt);
-          registry.fill(HIST("MC/reconstructed/prompt/hCtRecSigPrompt"), hfHelper.ctLc(candidate));
-          registry.fill(HIST("MC/reconstructed/prompt/hCtVsPtRecSigPrompt"), hfHelper.ctLc(candidate), pt);
+          registry.fill(HIST("MC/reconstructed/prompt/hCtRecSigPrompt"), ctCandidate);
+          registry.fill(HIST("MC/reconstructed/prompt/hCtVsPtRecSigPrompt"), ctCandidate, pt);
           registry.fill(HIST("MC/reconstructed/prompt/hCPARecSigPrompt"), candidate.cpa());
           registry.fill(HIST("MC/reconstructed/prompt/hCPAVsPtRecSigPrompt"), candidate.cpa(), pt);
           registry.fill(HIST("MC/reconstructed/prompt/hCPAxyRecSigPrompt"), candidate.cpaXY());
@@ -414,12 +420,12 @@ struct HfTaskLc {
           registry.fill(HIST("MC/reconstructed/prompt/hDecLenErrSigPrompt"), candidate.errorDecayLength(), pt);
         } else {
           if ((candidate.isSelLcToPKPi() >= selectionFlagLc) && pdgCodeProng0 == kProton) {
-            registry.fill(HIST("MC/reconstructed/nonprompt/hMassRecSigNonPrompt"), hfHelper.invMassLcToPKPi(candidate));
-            registry.fill(HIST("MC/reconstructed/nonprompt/hMassVsPtRecSigNonPrompt"), hfHelper.invMassLcToPKPi(candidate), pt);
+            registry.fill(HIST("MC/reconstructed/nonprompt/hMassRecSigNonPrompt"), massLcToPKPi);
+            registry.fill(HIST("MC/reconstructed/nonprompt/hMassVsPtRecSigNonPrompt"), massLcToPKPi, pt);
           }
           if ((candidate.isSelLcToPiKP() >= selectionFlagLc) && pdgCodeProng0 == kPiPlus) {
-            registry.fill(HIST("MC/reconstructed/nonprompt/hMassRecSigNonPrompt"), hfHelper.invMassLcToPiKP(candidate));
-            registry.fill(HIST("MC/reconstructed/nonprompt/hMassVsPtRecSigNonPrompt"), hfHelper.invMassLcToPiKP(candidate), pt);
+            registry.fill(HIST("MC/reconstructed/nonprompt/hMassRecSigNonPrompt"), massLcToPiKP);
+            registry.fill(HIST("MC/reconstructed/nonprompt/hMassVsPtRecSigNonPrompt"), massLcToPiKP, pt);
           }
           registry.fill(HIST("MC/reconstructed/nonprompt/hPtRecSigNonPrompt"), pt);
           registry.fill(HIST("MC/reconstructed/nonprompt/hPtRecProng0SigNonPrompt"), candidate.ptProng0());
@@ -435,8 +441,8 @@ struct HfTaskLc {
           registry.fill(HIST("MC/reconstructed/nonprompt/hDecLengthVsPtRecSigNonPrompt"), candidate.decayLength(), pt);
           registry.fill(HIST("MC/reconstructed/nonprompt/hDecLengthxyRecSigNonPrompt"), candidate.decayLengthXY());
           registry.fill(HIST("MC/reconstructed/nonprompt/hDecLengthxyVsPtRecSigNonPrompt"), candidate.decayLengthXY(), pt);
-          registry.fill(HIST("MC/reconstructed/nonprompt/hCtRecSigNonPrompt"), hfHelper.ctLc(candidate));
-          registry.fill(HIST("MC/reconstructed/nonprompt/hCtVsPtRecSigNonPrompt"), hfHelper.ctLc(candidate), pt);
+          registry.fill(HIST("MC/reconstructed/nonprompt/hCtRecSigNonPrompt"), ctCandidate);
+          registry.fill(HIST("MC/reconstructed/nonprompt/hCtVsPtRecSigNonPrompt"), ctCandidate, pt);
           registry.fill(HIST("MC/reconstructed/nonprompt/hCPARecSigNonPrompt"), candidate.cpa());
           registry.fill(HIST("MC/reconstructed/nonprompt/hCPAVsPtRecSigNonPrompt"), candidate.cpa(), pt);
           registry.fill(HIST("MC/reconstructed/nonprompt/hCPAxyRecSigNonPrompt"), candidate.cpaXY());
@@ -156,6 +156,7 @@ DECLARE_SOA_COLUMN(FlagMcDecayChanGen, flagMcDecayChanGen, int8_t); //! resonant
 DECLARE_SOA_COLUMN(MlScoreBkg, mlScoreBkg, float);                  //! ML score for background class
 DECLARE_SOA_COLUMN(MlScorePrompt, mlScorePrompt, float);            //! ML score for prompt class
 DECLARE_SOA_COLUMN(MlScoreNonPrompt, mlScoreNonPrompt, float);      //! ML score for non-prompt class
+DECLARE_SOA_COLUMN(MlScores, mlScores, std::vector<float>);         //! vector of ML scores, one per model class
 } // namespace hf_cand_mc
 
 DECLARE_SOA_TABLE(HfD0Bases, "AOD1", "HFD0BASE", //! Table with basic candidate properties used in the analyses
@@ -316,6 +317,15 @@ DECLARE_SOA_TABLE(StoredHfD0Mcs, "AOD", "HFD0MC", //! Table with MC candidate in
                   hf_cand_mc::OriginMcRec,
                   soa::Marker<1>);
 
+// ML scores are a separate column group, row-aligned with the other candidate tables,
+// such that they can be (re)computed from an existing derived dataset (see derivedDataMlD0ToKPi.cxx)
+DECLARE_SOA_TABLE(HfD0Mls, "AOD1", "HFD0ML", //! Table with candidate ML scores
+                  hf_cand_mc::MlScores);
+
+DECLARE_SOA_TABLE(StoredHfD0Mls, "AOD", "HFD0ML", //! Table with candidate ML scores (stored version)
+                  hf_cand_mc::MlScores,
+                  soa::Marker<1>);
+
 DECLARE_SOA_TABLE(HfD0PBases, "AOD1", "HFD0PBASE", //! Table with MC particle info
                   o2::soa::Index<>,
                   hf_cand_base::Pt,
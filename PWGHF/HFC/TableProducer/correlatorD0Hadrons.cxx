@@ -15,6 +15,8 @@
 /// \author Samrangy Sadhu <samrangy.sadhu@cern.ch>, INFN Bari
 /// \author Swapnesh Santosh Khade <swapnesh.santosh.khade@cern.ch>, IIT Indore
 
+#include <vector>
+
 #include "CommonConstants/PhysicsConstants.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/HistogramRegistry.h"
@@ -29,9 +31,11 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/HFC/DataModel/CorrelationTables.h"
+#include "PWGHF/HFC/Utils/utilsCorrelations.h"
 
 using namespace o2;
 using namespace o2::analysis;
+using namespace o2::analysis::hf_correlations;
 using namespace o2::constants::physics;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
@@ -205,6 +209,8 @@ struct HfCorrelatorD0Hadrons {
   Filter collisionFilterGen = aod::hf_selection_dmeson_collision::dmesonSel == true;
   Filter particlesFilter = nabs(aod::mcparticle::pdgCode) == static_cast<int>(Pdg::kD0) || ((aod::mcparticle::flags & (uint8_t)o2::aod::mcparticle::enums::PhysicalPrimary) == (uint8_t)o2::aod::mcparticle::enums::PhysicalPrimary);
 
+  std::vector<AssociatedHadron> associatedHadrons; // associated hadrons of the current collision, selected once for all its candidates
+
   HistogramRegistry registry{
     "registry",
     // NOTE: use hMassD0 for trigger normalisation (S*0.955), and hMass2DCorrelationPairs (in final task) for 2D-sideband-subtraction purposes
@@ -296,6 +302,13 @@ struct HfCorrelatorD0Hadrons {
 
     auto selectedD0CandidatesGrouped = selectedD0Candidates->sliceByCached(aod::hf_cand::collisionId, collision.globalIndex(), cache);
 
+    // select the associated hadrons once for all the candidates of the collision
+    selectAssociatedHadrons(
+      tracks, [](const auto& track) {
+        return std::abs(track.dcaXY()) < 1. && std::abs(track.dcaZ()) < 1.; // Remove secondary tracks
+      },
+      associatedHadrons);
+
     for (const auto& candidate1 : selectedD0CandidatesGrouped) {
       if (yCandMax >= 0. && std::abs(hfHelper.yD0(candidate1)) > yCandMax) {
         continue;
@@ -341,22 +354,20 @@ struct HfCorrelatorD0Hadrons {
       // ============ D-h correlation dedicated section ==================================
 
       // ========================== track loop starts here ================================
-      for (const auto& track : tracks) {
-        registry.fill(HIST("hTrackCounter"), 1); // fill total no. of tracks
+      registry.fill(HIST("hTrackCounter"), 1, tracks.size()); // fill total no. of tracks
+      for (const auto& hadron : associatedHadrons) {
         // Remove D0 daughters by checking track indices
-        if ((candidate1.prong0Id() == track.globalIndex()) || (candidate1.prong1Id() == track.globalIndex())) {
+        if (isCandidateDaughter(hadron, candidate1.prong0Id(), candidate1.prong1Id())) {
           continue;
         }
-        if (std::abs(track.dcaXY()) >= 1. || std::abs(track.dcaZ()) >= 1.)
-          continue; // Remove secondary tracks
 
         registry.fill(HIST("hTrackCounter"), 2); // fill no. of tracks before soft pion removal
 
         // ========== soft pion removal ===================================================
         double invMassDstar1 = 0., invMassDstar2 = 0.;
         bool isSoftPiD0 = false, isSoftPiD0bar = false;
-        auto pSum2 = RecoDecay::p2(candidate1.px() + track.px(), candidate1.py() + track.py(), candidate1.pz() + track.pz());
-        auto ePion = track.energy(massPi);
+        auto pSum2 = RecoDecay::p2(candidate1.px() + hadron.px, candidate1.py() + hadron.py, candidate1.pz() + hadron.pz);
+        auto ePion = RecoDecay::e(hadron.px, hadron.py, hadron.pz, massPi);
         invMassDstar1 = std::sqrt((ePiK + ePion) * (ePiK + ePion) - pSum2);
         invMassDstar2 = std::sqrt((eKPi + ePion) * (eKPi + ePion) - pSum2);
 
@@ -383,10 +394,10 @@ struct HfCorrelatorD0Hadrons {
           signalStatus += aod::hf_correlation_d0_hadron::ParticleTypeData::D0barOnly;
         }
 
-        entryD0HadronPair(getDeltaPhi(track.phi(), candidate1.phi()),
-                          track.eta() - candidate1.eta(),
+        entryD0HadronPair(getDeltaPhi(hadron.phi, candidate1.phi()),
+                          hadron.eta - candidate1.eta(),
                           candidate1.pt(),
-                          track.pt(),
+                          hadron.pt,
                           poolBin);
         entryD0HadronRecoInfo(hfHelper.invMassD0ToPiK(candidate1), hfHelper.invMassD0barToKPi(candidate1), signalStatus);
 
@@ -430,6 +441,14 @@ struct HfCorrelatorD0Hadrons {
     bool flagD0 = false;
     bool flagD0bar = false;
 
+    // select the associated hadrons once for all the candidates of the collision
+    selectAssociatedHadrons(
+      tracks, [this](const auto& track) {
+        return std::abs(track.eta()) <= etaTrackMax && track.pt() >= ptTrackMin &&
+               std::abs(track.dcaXY()) < 1. && std::abs(track.dcaZ()) < 1.; // Remove secondary tracks
+      },
+      associatedHadrons);
+
     for (const auto& candidate1 : selectedD0CandidatesGroupedMc) {
       // check decay channel flag for candidate1
       if (!TESTBIT(candidate1.hfflag(), aod::hf_cand_2prong::DecayType::D0ToPiK)) {
@@ -488,28 +507,19 @@ struct HfCorrelatorD0Hadrons {
 
       // ========== track loop starts here ========================
 
-      for (const auto& track : tracks) {
-        registry.fill(HIST("hTrackCounterRec"), 1); // fill total no. of tracks
-        if (std::abs(track.eta()) > etaTrackMax) {
-          continue;
-        }
-        if (track.pt() < ptTrackMin) {
-          continue;
-        }
+      registry.fill(HIST("hTrackCounterRec"), 1, tracks.size()); // fill total no. of tracks
+      for (const auto& hadron : associatedHadrons) {
         // Removing D0 daughters by checking track indices
-        if ((candidate1.prong0Id() == track.globalIndex()) || (candidate1.prong1Id() == track.globalIndex())) {
+        if (isCandidateDaughter(hadron, candidate1.prong0Id(), candidate1.prong1Id())) {
           continue;
         }
-        if (std::abs(track.dcaXY()) >= 1. || std::abs(track.dcaZ()) >= 1.) {
-          continue; // Remove secondary tracks
-        }
         registry.fill(HIST("hTrackCounterRec"), 2); // fill no. of tracks before soft pion removal
 
         // ===== soft pion removal ===================================================
         double invMassDstar1 = 0, invMassDstar2 = 0;
         bool isSoftPiD0 = false, isSoftPiD0bar = false;
-        auto pSum2 = RecoDecay::p2(candidate1.px() + track.px(), candidate1.py() + track.py(), candidate1.pz() + track.pz());
-        auto ePion = track.energy(massPi);
+        auto pSum2 = RecoDecay::p2(candidate1.px() + hadron.px, candidate1.py() + hadron.py, candidate1.pz() + hadron.pz);
+        auto ePion = RecoDecay::e(hadron.px, hadron.py, hadron.pz, massPi);
         invMassDstar1 = std::sqrt((ePiK + ePion) * (ePiK + ePion) - pSum2);
         invMassDstar2 = std::sqrt((eKPi + ePion) * (eKPi + ePion) - pSum2);
 
@@ -550,10 +560,10 @@ struct HfCorrelatorD0Hadrons {
           SETBIT(signalStatus, aod::hf_correlation_d0_hadron::ParticleTypeMcRec::D0barBg);
         } // background case D0bar
 
-        entryD0HadronPair(getDeltaPhi(track.phi(), candidate1.phi()),
-                          track.eta() - candidate1.eta(),
+        entryD0HadronPair(getDeltaPhi(hadron.phi, candidate1.phi()),
+                          hadron.eta - candidate1.eta(),
                           candidate1.pt(),
-                          track.pt(),
+                          hadron.pt,
                           poolBin);
         entryD0HadronRecoInfo(hfHelper.invMassD0ToPiK(candidate1), hfHelper.invMassD0barToKPi(candidate1), signalStatus);
       } // end inner loop (Tracks)
@@ -12,6 +12,8 @@
 /// \file correlatorDplusHadrons.cxx
 /// \author Shyam Kumar <shyam.kumar@cern.ch>
 
+#include <vector>
+
 #include "CommonConstants/PhysicsConstants.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/HistogramRegistry.h"
@@ -27,9 +29,11 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/HFC/DataModel/CorrelationTables.h"
+#include "PWGHF/HFC/Utils/utilsCorrelations.h"
 
 using namespace o2;
 using namespace o2::analysis;
+using namespace o2::analysis::hf_correlations;
 using namespace o2::constants::physics;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
@@ -195,6 +199,8 @@ struct HfCorrelatorDplusHadrons {
   Partition<soa::Join<aod::HfCand3Prong, aod::HfSelDplusToPiKPi>> selectedDplusCandidates = aod::hf_sel_candidate_dplus::isSelDplusToPiKPi >= selectionFlagDplus;
   Partition<soa::Join<aod::HfCand3Prong, aod::HfSelDplusToPiKPi, aod::HfCand3ProngMcRec>> selectedDplusCandidatesMc = aod::hf_sel_candidate_dplus::isSelDplusToPiKPi >= selectionFlagDplus;
 
+  std::vector<AssociatedHadron> associatedHadrons; // associated hadrons of the current collision, selected once for all its candidates
+
   HistogramRegistry registry{
     "registry",
     {{"hPtCand", "Dplus,Hadron candidates;candidate #it{p}_{T} (GeV/#it{c});entries", {HistType::kTH1F, {{ptDAxisBins, ptDAxisMin, ptDAxisMax}}}},
@@ -268,6 +274,13 @@ struct HfCorrelatorDplusHadrons {
       registry.fill(HIST("hMultiplicity"), nTracks);
 
       auto selectedDplusCandidatesGrouped = selectedDplusCandidates->sliceByCached(aod::hf_cand::collisionId, collision.globalIndex(), cache);
+      // select the associated hadrons once for all the candidates of the collision
+      selectAssociatedHadrons(
+        tracks, [this](const auto& track) {
+          return std::abs(track.eta()) <= etaTrackMax && track.pt() >= ptTrackMin &&
+                 std::abs(track.dcaXY()) < dcaXYTrackMax && std::abs(track.dcaZ()) < dcaZTrackMax; // Remove secondary tracks
+        },
+        associatedHadrons);
       int cntDplus = 0;
       for (const auto& candidate1 : selectedDplusCandidatesGrouped) {
         if (yCandMax >= 0. && std::abs(hfHelper.yDplus(candidate1)) > yCandMax) {
@@ -302,27 +315,18 @@ struct HfCorrelatorDplusHadrons {
         entryDplus(candidate1.phi(), candidate1.eta(), candidate1.pt(), hfHelper.invMassDplusToPiKPi(candidate1), poolBin, gCollisionId, timeStamp);
         // Dplus-Hadron correlation dedicated section
         // if the candidate is a Dplus, search for Hadrons and evaluate correlations
-        for (const auto& track : tracks) {
-          if (std::abs(track.eta()) > etaTrackMax) {
-            continue;
-          }
-          if (track.pt() < ptTrackMin) {
-            continue;
-          }
-          if (std::abs(track.dcaXY()) >= dcaXYTrackMax || std::abs(track.dcaZ()) >= dcaZTrackMax) {
-            continue; // Remove secondary tracks
-          }
+        for (const auto& hadron : associatedHadrons) {
           // Removing Dplus daughters by checking track indices
-          if ((candidate1.prong0Id() == track.globalIndex()) || (candidate1.prong1Id() == track.globalIndex()) || (candidate1.prong2Id() == track.globalIndex())) {
+          if (isCandidateDaughter(hadron, candidate1.prong0Id(), candidate1.prong1Id(), candidate1.prong2Id())) {
             continue;
           }
-          entryDplusHadronPair(getDeltaPhi(track.phi(), candidate1.phi()),
-                               track.eta() - candidate1.eta(),
+          entryDplusHadronPair(getDeltaPhi(hadron.phi, candidate1.phi()),
+                               hadron.eta - candidate1.eta(),
                                candidate1.pt(),
-                               track.pt(), poolBin);
+                               hadron.pt, poolBin);
           entryDplusHadronRecoInfo(hfHelper.invMassDplusToPiKPi(candidate1), 0);
           if (cntDplus == 0)
-            entryHadron(track.phi(), track.eta(), track.pt(), poolBin, gCollisionId, timeStamp);
+            entryHadron(hadron.phi, hadron.eta, hadron.pt, poolBin, gCollisionId, timeStamp);
         } // Hadron Tracks loop
         cntDplus++;
       } // end outer Dplus loop
@@ -359,6 +363,13 @@ struct HfCorrelatorDplusHadrons {
       registry.fill(HIST("hMultiplicity"), nTracks);
 
       auto selectedDplusCandidatesMcGrouped = selectedDplusCandidatesMc->sliceByCached(aod::hf_cand::collisionId, collision.globalIndex(), cache);
+      // select the associated hadrons once for all the candidates of the collision
+      selectAssociatedHadrons(
+        tracks, [this](const auto& track) {
+          return std::abs(track.eta()) <= etaTrackMax && track.pt() >= ptTrackMin &&
+                 std::abs(track.dcaXY()) < dcaXYTrackMax && std::abs(track.dcaZ()) < dcaZTrackMax; // Remove secondary tracks
+        },
+        associatedHadrons);
       // MC reco level
       bool flagDplusSignal = false;
       for (const auto& candidate1 : selectedDplusCandidatesMcGrouped) {
@@ -402,24 +413,15 @@ struct HfCorrelatorDplusHadrons {
         // Dplus-Hadron correlation dedicated section
         // if the candidate is selected as Dplus, search for Hadron and evaluate correlations
         flagDplusSignal = candidate1.flagMcMatchRec() == 1 << aod::hf_cand_3prong::DecayType::DplusToPiKPi;
-        for (const auto& track : tracks) {
-          if (std::abs(track.eta()) > etaTrackMax) {
-            continue;
-          }
-          if (track.pt() < ptTrackMin) {
-            continue;
-          }
+        for (const auto& hadron : associatedHadrons) {
           // Removing Dplus daughters by checking track indices
-          if ((candidate1.prong0Id() == track.globalIndex()) || (candidate1.prong1Id() == track.globalIndex()) || (candidate1.prong2Id() == track.globalIndex())) {
+          if (isCandidateDaughter(hadron, candidate1.prong0Id(), candidate1.prong1Id(), candidate1.prong2Id())) {
             continue;
           }
-          if (std::abs(track.dcaXY()) >= dcaXYTrackMax || std::abs(track.dcaZ()) >= dcaZTrackMax) {
-            continue; // Remove secondary tracks
-          }
-          entryDplusHadronPair(getDeltaPhi(track.phi(), candidate1.phi()),
-                               track.eta() - candidate1.eta(),
+          entryDplusHadronPair(getDeltaPhi(hadron.phi, candidate1.phi()),
+                               hadron.eta - candidate1.eta(),
                                candidate1.pt(),
-                               track.pt(), poolBin);
+                               hadron.pt, poolBin);
           entryDplusHadronRecoInfo(hfHelper.invMassDplusToPiKPi(candidate1), flagDplusSignal);
         } // end inner loop (Tracks)
 
@@ -14,6 +14,8 @@
 /// \author Grazia Luparello <grazia.luparello@cern.ch>
 /// \author Samuele Cattaruzzi <samuele.cattaruzzi@cern.ch>
 
+#include <vector>
+
 #include "CommonConstants/PhysicsConstants.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/HistogramRegistry.h"
@@ -29,9 +31,11 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/HFC/DataModel/CorrelationTables.h"
+#include "PWGHF/HFC/Utils/utilsCorrelations.h"
 
 using namespace o2;
 using namespace o2::analysis;
+using namespace o2::analysis::hf_correlations;
 using namespace o2::constants::physics;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
@@ -195,6 +199,8 @@ struct HfCorrelatorDsHadrons {
 
   Preslice<aod::HfCand3Prong> perCol = aod::hf_cand::collisionId;
 
+  std::vector<AssociatedHadron> associatedHadrons; // associated hadrons of the current collision, selected once for all its candidates
+
   HistogramRegistry registry{
     "registry",
     {{"hPtCand", "Ds,Hadron candidates", {HistType::kTH1F, {axisPtD}}},
@@ -383,6 +389,10 @@ struct HfCorrelatorDsHadrons {
       }
       registry.fill(HIST("hMultiplicity"), nTracks);
 
+      // read the associated hadrons, already selected by the track filter, once for all the candidates of the collision
+      selectAssociatedHadrons(
+        tracks, [](const auto&) { return true; }, associatedHadrons);
+
       // Ds fill histograms and Ds-Hadron correlation for DsToKKPi
       for (const auto& candidate : candidates) {
         if (yCandMax >= 0. && std::abs(hfHelper.yDs(candidate)) > yCandMax) {
@@ -406,26 +416,26 @@ struct HfCorrelatorDsHadrons {
         }
 
         // Ds-Hadron correlation dedicated section
-        for (const auto& track : tracks) {
+        for (const auto& hadron : associatedHadrons) {
           // Removing Ds daughters by checking track indices
-          if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex()) || (candidate.prong2Id() == track.globalIndex())) {
+          if (isCandidateDaughter(hadron, candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id())) {
             continue;
           }
-          registry.fill(HIST("hEtaVsPtPartAssoc"), track.eta(), candidate.pt());
-          registry.fill(HIST("hPhiVsPtPartAssoc"), RecoDecay::constrainAngle(track.phi(), -o2::constants::math::PIHalf), candidate.pt());
+          registry.fill(HIST("hEtaVsPtPartAssoc"), hadron.eta, candidate.pt());
+          registry.fill(HIST("hPhiVsPtPartAssoc"), RecoDecay::constrainAngle(hadron.phi, -o2::constants::math::PIHalf), candidate.pt());
           if (candidate.isSelDsToKKPi() >= selectionFlagDs) {
-            entryDsHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                              track.eta() - candidate.eta(),
+            entryDsHadronPair(getDeltaPhi(hadron.phi, candidate.phi()),
+                              hadron.eta - candidate.eta(),
                               candidate.pt(),
-                              track.pt(),
+                              hadron.pt,
                               poolBin);
             entryDsHadronRecoInfo(hfHelper.invMassDsToKKPi(candidate), false);
             entryDsHadronGenInfo(false);
           } else if (candidate.isSelDsToPiKK() >= selectionFlagDs) {
-            entryDsHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                              track.eta() - candidate.eta(),
+            entryDsHadronPair(getDeltaPhi(hadron.phi, candidate.phi()),
+                              hadron.eta - candidate.eta(),
                               candidate.pt(),
-                              track.pt(),
+                              hadron.pt,
                               poolBin);
             entryDsHadronRecoInfo(hfHelper.invMassDsToPiKK(candidate), false);
             entryDsHadronGenInfo(false);
@@ -464,6 +474,10 @@ struct HfCorrelatorDsHadrons {
 
       // auto selectedDsMcRecoCandGrouped = selectedDsMcRecoCand->sliceByCached(aod::hf_cand::collisionId, collision.globalIndex(), cache);
 
+      // read the associated hadrons, already selected by the track filter, once for all the candidates of the collision
+      selectAssociatedHadrons(
+        tracks, [](const auto&) { return true; }, associatedHadrons);
+
       // MC reco level
       bool isDsPrompt = false;
       bool isDsSignal = false;
@@ -519,26 +533,26 @@ struct HfCorrelatorDsHadrons {
 
         // Ds-Hadron correlation dedicated section
         // if the candidate is selected as Ds, search for Hadron and evaluate correlations
-        for (const auto& track : tracks) {
+        for (const auto& hadron : associatedHadrons) {
           // Removing Ds daughters by checking track indices
-          if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex()) || (candidate.prong2Id() == track.globalIndex())) {
+          if (isCandidateDaughter(hadron, candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id())) {
             continue;
           }
-          registry.fill(HIST("hPtParticleAssocMcRec"), track.pt()); // va tolto
+          registry.fill(HIST("hPtParticleAssocMcRec"), hadron.pt); // va tolto
           // DsToKKPi and DsToPiKK division
           if (candidate.isSelDsToKKPi() >= selectionFlagDs) {
-            entryDsHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                              track.eta() - candidate.eta(),
+            entryDsHadronPair(getDeltaPhi(hadron.phi, candidate.phi()),
+                              hadron.eta - candidate.eta(),
                               candidate.pt(),
-                              track.pt(),
+                              hadron.pt,
                               poolBin);
             entryDsHadronRecoInfo(hfHelper.invMassDsToKKPi(candidate), isDsSignal);
             entryDsHadronGenInfo(isDsPrompt);
           } else if (candidate.isSelDsToPiKK() >= selectionFlagDs) {
-            entryDsHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                              track.eta() - candidate.eta(),
+            entryDsHadronPair(getDeltaPhi(hadron.phi, candidate.phi()),
+                              hadron.eta - candidate.eta(),
                               candidate.pt(),
-                              track.pt(),
+                              hadron.pt,
                               poolBin);
             entryDsHadronRecoInfo(hfHelper.invMassDsToPiKK(candidate), isDsSignal);
             entryDsHadronGenInfo(isDsPrompt);
@@ -15,6 +15,8 @@
 /// \author Marianna Mazzilli <marianna.mazzilli@cern.ch>
 /// \author Zhen Zhang <zhenz@cern.ch>
 
+#include <vector>
+
 #include "CommonConstants/PhysicsConstants.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/HistogramRegistry.h"
@@ -30,9 +32,11 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/HFC/DataModel/CorrelationTables.h"
+#include "PWGHF/HFC/Utils/utilsCorrelations.h"
 
 using namespace o2;
 using namespace o2::analysis;
+using namespace o2::analysis::hf_correlations;
 using namespace o2::constants::physics;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
@@ -203,6 +207,8 @@ struct HfCorrelatorLcHadrons {
   Partition<soa::Join<aod::HfCand3Prong, aod::HfSelLc>> selectedLcCandidates = aod::hf_sel_candidate_lc::isSelLcToPKPi >= selectionFlagLc || aod::hf_sel_candidate_lc::isSelLcToPiKP >= selectionFlagLc;
   Partition<soa::Join<aod::HfCand3Prong, aod::HfSelLc, aod::HfCand3ProngMcRec>> selectedLcCandidatesMc = aod::hf_sel_candidate_lc::isSelLcToPKPi >= selectionFlagLc || aod::hf_sel_candidate_lc::isSelLcToPiKP >= selectionFlagLc;
 
+  std::vector<AssociatedHadron> associatedHadrons; // associated hadrons of the current collision, selected once for all its candidates
+
   HistogramRegistry registry{
     "registry",
     {{"hPtCand", "Lc,Hadron candidates;candidate #it{p}_{T} (GeV/#it{c});entries", {HistType::kTH1F, {{ptLcAxisBins, ptLcAxisMin, ptLcAxisMax}}}},
@@ -280,6 +286,13 @@ struct HfCorrelatorLcHadrons {
     registry.fill(HIST("hMultiplicity"), nTracks);
 
     auto selectedLcCandidatesGrouped = selectedLcCandidates->sliceByCached(aod::hf_cand::collisionId, collision.globalIndex(), cache);
+    // select the associated hadrons once for all the candidates of the collision
+    selectAssociatedHadrons(
+      tracks, [this](const auto& track) {
+        return std::abs(track.eta()) <= etaTrackMax && track.pt() >= ptTrackMin &&
+               std::abs(track.dcaXY()) < dcaXYTrackMax && std::abs(track.dcaZ()) < dcaZTrackMax; // Remove secondary tracks
+      },
+      associatedHadrons);
 
     for (const auto& candidate : selectedLcCandidatesGrouped) {
       if (yCandMax >= 0. && std::abs(hfHelper.yLc(candidate)) > yCandMax) {
@@ -321,33 +334,24 @@ struct HfCorrelatorLcHadrons {
       // Lc-Hadron correlation dedicated section
       // if the candidate is a Lc, search for Hadrons and evaluate correlations
 
-      for (const auto& track : tracks) {
-        if (std::abs(track.eta()) > etaTrackMax) {
-          continue;
-        }
-        if (track.pt() < ptTrackMin) {
-          continue;
-        }
-        if (std::abs(track.dcaXY()) >= dcaXYTrackMax || std::abs(track.dcaZ()) >= dcaZTrackMax) {
-          continue; // Remove secondary tracks
-        }
+      for (const auto& hadron : associatedHadrons) {
         // Remove Lc daughters by checking track indices
-        if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex()) || (candidate.prong2Id() == track.globalIndex())) {
+        if (isCandidateDaughter(hadron, candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id())) {
           continue;
         }
         if (candidate.isSelLcToPKPi() >= selectionFlagLc) {
-          entryLcHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                            track.eta() - candidate.eta(),
+          entryLcHadronPair(getDeltaPhi(hadron.phi, candidate.phi()),
+                            hadron.eta - candidate.eta(),
                             candidate.pt(),
-                            track.pt(),
+                            hadron.pt,
                             poolBin);
           entryLcHadronRecoInfo(hfHelper.invMassLcToPKPi(candidate), false);
         }
         if (candidate.isSelLcToPiKP() >= selectionFlagLc) {
-          entryLcHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                            track.eta() - candidate.eta(),
+          entryLcHadronPair(getDeltaPhi(hadron.phi, candidate.phi()),
+                            hadron.eta - candidate.eta(),
                             candidate.pt(),
-                            track.pt(),
+                            hadron.pt,
                             poolBin);
           entryLcHadronRecoInfo(hfHelper.invMassLcToPiKP(candidate), false);
         }
@@ -387,6 +391,13 @@ struct HfCorrelatorLcHadrons {
     registry.fill(HIST("hMultiplicity"), nTracks);
 
     auto selectedLcCandidatesGroupedMc = selectedLcCandidatesMc->sliceByCached(aod::hf_cand::collisionId, collision.globalIndex(), cache);
+    // select the associated hadrons once for all the candidates of the collision
+    selectAssociatedHadrons(
+      tracks, [this](const auto& track) {
+        return std::abs(track.eta()) <= etaTrackMax && track.pt() >= ptTrackMin &&
+               std::abs(track.dcaXY()) < dcaXYTrackMax && std::abs(track.dcaZ()) < dcaZTrackMax; // Remove secondary tracks
+      },
+      associatedHadrons);
 
     // Mc reco level
     bool isLcSignal = false;
@@ -456,35 +467,26 @@ struct HfCorrelatorLcHadrons {
 
       // Lc-Hadron correlation dedicated section
       // if the candidate is selected as Lc, search for Hadron ad evaluate correlations
-      for (const auto& track : tracks) {
-        if (std::abs(track.eta()) > etaTrackMax) {
-          continue;
-        }
-        if (track.pt() < ptTrackMin) {
-          continue;
-        }
-        if (std::abs(track.dcaXY()) >= dcaXYTrackMax || std::abs(track.dcaZ()) >= dcaZTrackMax) {
-          continue; // Remove secondary tracks
-        }
+      for (const auto& hadron : associatedHadrons) {
         // Removing Lc daughters by checking track indices
-        if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex()) || (candidate.prong2Id() == track.globalIndex())) {
+        if (isCandidateDaughter(hadron, candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id())) {
           continue;
         }
-        registry.fill(HIST("hPtParticleAssocMcRec"), track.pt());
+        registry.fill(HIST("hPtParticleAssocMcRec"), hadron.pt);
 
         if (candidate.isSelLcToPKPi() >= selectionFlagLc) {
-          entryLcHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                            track.eta() - candidate.eta(),
+          entryLcHadronPair(getDeltaPhi(hadron.phi, candidate.phi()),
+                            hadron.eta - candidate.eta(),
                             candidate.pt(),
-                            track.pt(),
+                            hadron.pt,
                             poolBin);
           entryLcHadronRecoInfo(hfHelper.invMassLcToPKPi(candidate), isLcSignal);
         }
         if (candidate.isSelLcToPiKP() >= selectionFlagLc) {
-          entryLcHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                            track.eta() - candidate.eta(),
+          entryLcHadronPair(getDeltaPhi(hadron.phi, candidate.phi()),
+                            hadron.eta - candidate.eta(),
                             candidate.pt(),
-                            track.pt(),
+                            hadron.pt,
                             poolBin);
           entryLcHadronRecoInfo(hfHelper.invMassLcToPiKP(candidate), isLcSignal);
         }
@@ -0,0 +1,64 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsCorrelations.h
+/// \brief Utilities for the HF-hadron correlation analyses
+///
+/// The associated hadrons of a collision are selected once and reduced to their kinematics,
+/// so that each charm candidate of the collision is paired with them without repeating the track selection.
+
+#ifndef PWGHF_HFC_UTILS_UTILSCORRELATIONS_H_
+#define PWGHF_HFC_UTILS_UTILSCORRELATIONS_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace o2::analysis::hf_correlations
+{
+/// Associated hadron reduced to what the pairing with the charm candidates uses
+struct AssociatedHadron {
+  int64_t globalIndex; // global index of the track, to exclude the candidate daughters
+  float pt;
+  float eta;
+  float phi;
+  float px;
+  float py;
+  float pz;
+};
+
+/// Selects the associated hadrons of a collision
+/// \param tracks  tracks of the collision
+/// \param isSelected  track selection, called once per track
+/// \param hadrons  selected hadrons, emptied first
+template <typename TTracks, typename TSelection>
+void selectAssociatedHadrons(TTracks const& tracks, TSelection const& isSelected, std::vector<AssociatedHadron>& hadrons)
+{
+  hadrons.clear();
+  hadrons.reserve(tracks.size());
+  for (const auto& track : tracks) {
+    if (!isSelected(track)) {
+      continue;
+    }
+    hadrons.push_back({track.globalIndex(), track.pt(), track.eta(), track.phi(), track.px(), track.py(), track.pz()});
+  }
+}
+
+/// Checks whether the hadron is one of the daughters of the candidate
+/// \param hadron  associated hadron
+/// \param prongIds  track indices of the candidate daughters
+template <typename... TIds>
+bool isCandidateDaughter(AssociatedHadron const& hadron, TIds... prongIds)
+{
+  return ((hadron.globalIndex == prongIds) || ...);
+}
+} // namespace o2::analysis::hf_correlations
+
+#endif // PWGHF_HFC_UTILS_UTILSCORRELATIONS_H_
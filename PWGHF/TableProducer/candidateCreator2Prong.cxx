@@ -26,6 +26,9 @@
 #include <KFPVertex.h>
 #include <KFVertex.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <TPDGCode.h>
 
 #include "CommonConstants/PhysicsConstants.h"
@@ -39,6 +42,7 @@
 
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
+#include "PWGHF/Utils/utilsDcaFitterBatch.h"
 
 using namespace o2;
 using namespace o2::analysis;
@@ -60,6 +64,7 @@ struct HfCandidateCreator2Prong {
   Configurable<double> maxDZIni{"maxDZIni", 4., "reject (if>0) PCA candidate if tracks DZ exceeds threshold"};
   Configurable<double> minParamChange{"minParamChange", 1.e-3, "stop iterations if largest change of any X is smaller than this"};
   Configurable<double> minRelChi2Change{"minRelChi2Change", 0.9, "stop iterations is chi2/chi2old > this"};
+  Configurable<int> nThreadsFit{"nThreadsFit", 1, "number of threads for the DCAFitterN secondary-vertex fits"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "do validation plots"};
   // magnetic field setting from CCDB
   Configurable<bool> isRun2{"isRun2", false, "enable Run 2 or Run 3 GRP objects for magnetic field"};
@@ -79,6 +84,10 @@ struct HfCandidateCreator2Prong {
   double massPiK{0.};
   double massKPi{0.};
   double bz{0.};
+  std::vector<o2::vertexing::DCAFitterN<2>> fitters;  // 2-prong vertex fitters, one per thread
+  o2::analysis::HfDcaFitterBatch<2> vertexFits;       // batch of the 2-prong secondary-vertex fits
+  std::vector<int> kfDaughterIndices;                 // index in kfDaughters of each track of the table, -1 if not created yet
+  std::vector<std::array<KFParticle, 2>> kfDaughters; // KF daughters with pion and kaon mass hypotheses, created once per track
 
   OutputObj<TH1F> hMass2{TH1F("hMass2", "2-prong candidates;inv. mass (#pi K) (GeV/#it{c}^{2});entries", 500, 0., 5.)};
   OutputObj<TH1F> hCovPVXX{TH1F("hCovPVXX", "2-prong candidates;XX element of cov. matrix of prim. vtx. position (cm^{2});entries", 100, 0., 1.e-4)};
@@ -114,6 +123,19 @@ struct HfCandidateCreator2Prong {
     ccdb->setLocalObjectValidityChecking();
     lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->get<o2::base::MatLayerCylSet>(ccdbPathLut));
     runNumber = 0;
+
+    // 2-prong vertex fitters
+    fitters.resize(std::max(1, nThreadsFit.value));
+    for (auto& df : fitters) {
+      // df.setBz(bz);
+      df.setPropagateToPCA(propagateToPCA);
+      df.setMaxR(maxR);
+      df.setMaxDZIni(maxDZIni);
+      df.setMinParamChange(minParamChange);
+      df.setMinRelChi2Change(minRelChi2Change);
+      df.setUseAbsDCA(useAbsDCA);
+      df.setWeightedFinalPCA(useWeightedFinalPCA);
+    }
   }
 
   template <bool doPvRefit, typename CandType, typename TTracks>
@@ -122,23 +144,9 @@ struct HfCandidateCreator2Prong {
                                       TTracks const& tracks,
                                       aod::BCsWithTimestamps const& bcWithTimeStamps)
   {
-    // 2-prong vertex fitter
-    o2::vertexing::DCAFitterN<2> df;
-    // df.setBz(bz);
-    df.setPropagateToPCA(propagateToPCA);
-    df.setMaxR(maxR);
-    df.setMaxDZIni(maxDZIni);
-    df.setMinParamChange(minParamChange);
-    df.setMinRelChi2Change(minRelChi2Change);
-    df.setUseAbsDCA(useAbsDCA);
-    df.setWeightedFinalPCA(useWeightedFinalPCA);
-
-    // loop over pairs of track indices
+    // collect the candidates and fit all their secondary vertices in one go
+    vertexFits.reset(tracks.size());
     for (const auto& rowTrackIndexProng2 : rowsTrackIndexProng2) {
-      auto track0 = rowTrackIndexProng2.template prong0_as<TTracks>();
-      auto track1 = rowTrackIndexProng2.template prong1_as<TTracks>();
-      auto trackParVarPos1 = getTrackParCov(track0);
-      auto trackParVarNeg1 = getTrackParCov(track1);
       auto collision = rowTrackIndexProng2.collision();
 
       /// Set the magnetic field from ccdb.
@@ -153,21 +161,33 @@ struct HfCandidateCreator2Prong {
         // df.setBz(bz); /// put it outside the 'if'! Otherwise we have a difference wrt bz Configurable (< 1 permille) in Run2 conv. data
         // df.print();
       }
-      df.setBz(bz);
+      vertexFits.addCandidate(bz, rowTrackIndexProng2.template prong0_as<TTracks>(), rowTrackIndexProng2.template prong1_as<TTracks>());
+    }
+    vertexFits.fitAll(fitters);
 
+    // loop over pairs of track indices
+    std::size_t iCandidate = 0;
+    for (const auto& rowTrackIndexProng2 : rowsTrackIndexProng2) {
+      const auto& fit = vertexFits.getFit(iCandidate);
+      const double bzCandidate = vertexFits.getBz(iCandidate);
+      iCandidate++;
       // reconstruct the 2-prong secondary vertex
-      if (df.process(trackParVarPos1, trackParVarNeg1) == 0) {
+      if (!fit.isFitted) {
         continue;
       }
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
+      auto track0 = rowTrackIndexProng2.template prong0_as<TTracks>();
+      auto track1 = rowTrackIndexProng2.template prong1_as<TTracks>();
+      auto collision = rowTrackIndexProng2.collision();
+
+      const auto& secondaryVertex = fit.secondaryVertex;
+      auto chi2PCA = fit.chi2PCA;
+      auto covMatrixPCA = fit.covMatrixPCA;
       hCovSVXX->Fill(covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
       hCovSVYY->Fill(covMatrixPCA[2]);
       hCovSVXZ->Fill(covMatrixPCA[3]);
       hCovSVZZ->Fill(covMatrixPCA[5]);
-      auto trackParVar0 = df.getTrack(0);
-      auto trackParVar1 = df.getTrack(1);
+      auto trackParVar0 = fit.tracks[0];
+      auto trackParVar1 = fit.tracks[1];
 
       // get track momenta
       std::array<float, 3> pvec0;
@@ -201,8 +221,8 @@ struct HfCandidateCreator2Prong {
       hCovPVZZ->Fill(covMatrixPV[5]);
       o2::dataformats::DCA impactParameter0;
       o2::dataformats::DCA impactParameter1;
-      trackParVar0.propagateToDCA(primaryVertex, bz, &impactParameter0);
-      trackParVar1.propagateToDCA(primaryVertex, bz, &impactParameter1);
+      trackParVar0.propagateToDCA(primaryVertex, bzCandidate, &impactParameter0);
+      trackParVar1.propagateToDCA(primaryVertex, bzCandidate, &impactParameter1);
       hDcaXYProngs->Fill(track0.pt(), impactParameter0.getY() * toMicrometers);
       hDcaXYProngs->Fill(track1.pt(), impactParameter1.getY() * toMicrometers);
       hDcaZProngs->Fill(track0.pt(), impactParameter0.getZ() * toMicrometers);
@@ -254,6 +274,18 @@ struct HfCandidateCreator2Prong {
                                       TTracks const& tracks,
                                       aod::BCsWithTimestamps const& bcWithTimeStamps)
   {
+    // the KF daughters do not depend on the candidate, hence they are created only once for each track
+    kfDaughterIndices.assign(tracks.size(), -1);
+    kfDaughters.clear();
+    auto getKfDaughterIndex = [&](const auto& track) {
+      int& index = kfDaughterIndices[track.globalIndex()];
+      if (index < 0) {
+        index = kfDaughters.size();
+        KFPTrack kfpTrack = createKFPTrackFromTrack(track);
+        kfDaughters.push_back({KFParticle(kfpTrack, kPiPlus), KFParticle(kfpTrack, kKPlus)});
+      }
+      return index;
+    };
 
     for (const auto& rowTrackIndexProng2 : rowsTrackIndexProng2) {
       auto track0 = rowTrackIndexProng2.template prong0_as<TTracks>();
@@ -292,13 +324,13 @@ struct HfCandidateCreator2Prong {
       hCovPVXZ->Fill(covMatrixPV[3]);
       hCovPVZZ->Fill(covMatrixPV[5]);
 
-      KFPTrack kfpTrack0 = createKFPTrackFromTrack(track0);
-      KFPTrack kfpTrack1 = createKFPTrackFromTrack(track1);
+      auto indexKfDaughter0 = getKfDaughterIndex(track0);
+      auto indexKfDaughter1 = getKfDaughterIndex(track1);
 
-      KFParticle kfPosPion(kfpTrack0, kPiPlus);
-      KFParticle kfNegPion(kfpTrack1, kPiPlus);
-      KFParticle kfPosKaon(kfpTrack0, kKPlus);
-      KFParticle kfNegKaon(kfpTrack1, kKPlus);
+      const KFParticle& kfPosPion = kfDaughters[indexKfDaughter0][0];
+      const KFParticle& kfNegPion = kfDaughters[indexKfDaughter1][0];
+      const KFParticle& kfPosKaon = kfDaughters[indexKfDaughter0][1];
+      const KFParticle& kfNegKaon = kfDaughters[indexKfDaughter1][1];
 
       float impactParameter0XY = 0., errImpactParameter0XY = 0., impactParameter1XY = 0., errImpactParameter1XY = 0.;
       if (!kfPosPion.GetDistanceFromVertexXY(KFPV, impactParameter0XY, errImpactParameter0XY)) {
@@ -15,6 +15,9 @@
 ///
 /// \author Vít Kučera <vit.kucera@cern.ch>, CERN
 
+#include <algorithm>
+#include <vector>
+
 #include <TPDGCode.h>
 
 #include "CommonConstants/PhysicsConstants.h"
@@ -27,6 +30,7 @@
 
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
+#include "PWGHF/Utils/utilsDcaFitterBatch.h"
 
 using namespace o2;
 using namespace o2::analysis;
@@ -46,6 +50,7 @@ struct HfCandidateCreator3Prong {
   Configurable<double> maxDZIni{"maxDZIni", 4., "reject (if>0) PCA candidate if tracks DZ exceeds threshold"};
   Configurable<double> minParamChange{"minParamChange", 1.e-3, "stop iterations if largest change of any X is smaller than this"};
   Configurable<double> minRelChi2Change{"minRelChi2Change", 0.9, "stop iterations is chi2/chi2old > this"};
+  Configurable<int> nThreadsFit{"nThreadsFit", 1, "number of threads for the DCAFitterN secondary-vertex fits"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "do validation plots"};
   // magnetic field setting from CCDB
   Configurable<bool> isRun2{"isRun2", false, "enable Run 2 or Run 3 GRP objects for magnetic field"};
@@ -64,6 +69,8 @@ struct HfCandidateCreator3Prong {
   double massK{0.};
   double massPiKPi{0.};
   double bz{0.};
+  std::vector<o2::vertexing::DCAFitterN<3>> fitters; // 3-prong vertex fitters, one per thread
+  o2::analysis::HfDcaFitterBatch<3> vertexFits;      // batch of the 3-prong secondary-vertex fits
 
   OutputObj<TH1F> hMass3{TH1F("hMass3", "3-prong candidates;inv. mass (#pi K #pi) (GeV/#it{c}^{2});entries", 500, 1.6, 2.1)};
   OutputObj<TH1F> hCovPVXX{TH1F("hCovPVXX", "3-prong candidates;XX element of cov. matrix of prim. vtx. position (cm^{2});entries", 100, 0., 1.e-4)};
@@ -90,6 +97,19 @@ struct HfCandidateCreator3Prong {
     ccdb->setLocalObjectValidityChecking();
     lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->get<o2::base::MatLayerCylSet>(ccdbPathLut));
     runNumber = 0;
+
+    // 3-prong vertex fitters
+    fitters.resize(std::max(1, nThreadsFit.value));
+    for (auto& df : fitters) {
+      // df.setBz(bz);
+      df.setPropagateToPCA(propagateToPCA);
+      df.setMaxR(maxR);
+      df.setMaxDZIni(maxDZIni);
+      df.setMinParamChange(minParamChange);
+      df.setMinRelChi2Change(minRelChi2Change);
+      df.setUseAbsDCA(useAbsDCA);
+      df.setWeightedFinalPCA(useWeightedFinalPCA);
+    }
   }
 
   template <bool doPvRefit = false, typename Cand>
@@ -98,25 +118,9 @@ struct HfCandidateCreator3Prong {
                         aod::TracksWCovExtra const& tracks,
                         aod::BCsWithTimestamps const& bcWithTimeStamps)
   {
-    // 3-prong vertex fitter
-    o2::vertexing::DCAFitterN<3> df;
-    // df.setBz(bz);
-    df.setPropagateToPCA(propagateToPCA);
-    df.setMaxR(maxR);
-    df.setMaxDZIni(maxDZIni);
-    df.setMinParamChange(minParamChange);
-    df.setMinRelChi2Change(minRelChi2Change);
-    df.setUseAbsDCA(useAbsDCA);
-    df.setWeightedFinalPCA(useWeightedFinalPCA);
-
-    // loop over triplets of track indices
+    // collect the candidates and fit all their secondary vertices in one go
+    vertexFits.reset(tracks.size());
     for (const auto& rowTrackIndexProng3 : rowsTrackIndexProng3) {
-      auto track0 = rowTrackIndexProng3.template prong0_as<aod::TracksWCovExtra>();
-      auto track1 = rowTrackIndexProng3.template prong1_as<aod::TracksWCovExtra>();
-      auto track2 = rowTrackIndexProng3.template prong2_as<aod::TracksWCovExtra>();
-      auto trackParVar0 = getTrackParCov(track0);
-      auto trackParVar1 = getTrackParCov(track1);
-      auto trackParVar2 = getTrackParCov(track2);
       auto collision = rowTrackIndexProng3.collision();
 
       /// Set the magnetic field from ccdb.
@@ -131,22 +135,38 @@ struct HfCandidateCreator3Prong {
         // df.setBz(bz); /// put it outside the 'if'! Otherwise we have a difference wrt bz Configurable (< 1 permille) in Run2 conv. data
         // df.print();
       }
-      df.setBz(bz);
+      vertexFits.addCandidate(bz,
+                              rowTrackIndexProng3.template prong0_as<aod::TracksWCovExtra>(),
+                              rowTrackIndexProng3.template prong1_as<aod::TracksWCovExtra>(),
+                              rowTrackIndexProng3.template prong2_as<aod::TracksWCovExtra>());
+    }
+    vertexFits.fitAll(fitters);
 
+    // loop over triplets of track indices
+    std::size_t iCandidate = 0;
+    for (const auto& rowTrackIndexProng3 : rowsTrackIndexProng3) {
+      const auto& fit = vertexFits.getFit(iCandidate);
+      const double bzCandidate = vertexFits.getBz(iCandidate);
+      iCandidate++;
       // reconstruct the 3-prong secondary vertex
-      if (df.process(trackParVar0, trackParVar1, trackParVar2) == 0) {
+      if (!fit.isFitted) {
         continue;
       }
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
+      auto track0 = rowTrackIndexProng3.template prong0_as<aod::TracksWCovExtra>();
+      auto track1 = rowTrackIndexProng3.template prong1_as<aod::TracksWCovExtra>();
+      auto track2 = rowTrackIndexProng3.template prong2_as<aod::TracksWCovExtra>();
+      auto collision = rowTrackIndexProng3.collision();
+
+      const auto& secondaryVertex = fit.secondaryVertex;
+      auto chi2PCA = fit.chi2PCA;
+      auto covMatrixPCA = fit.covMatrixPCA;
       hCovSVXX->Fill(covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
       hCovSVYY->Fill(covMatrixPCA[2]);
       hCovSVXZ->Fill(covMatrixPCA[3]);
       hCovSVZZ->Fill(covMatrixPCA[5]);
-      trackParVar0 = df.getTrack(0);
-      trackParVar1 = df.getTrack(1);
-      trackParVar2 = df.getTrack(2);
+      auto trackParVar0 = fit.tracks[0];
+      auto trackParVar1 = fit.tracks[1];
+      auto trackParVar2 = fit.tracks[2];
 
       // get track momenta
       std::array<float, 3> pvec0;
@@ -183,9 +203,9 @@ struct HfCandidateCreator3Prong {
       o2::dataformats::DCA impactParameter0;
       o2::dataformats::DCA impactParameter1;
       o2::dataformats::DCA impactParameter2;
-      trackParVar0.propagateToDCA(primaryVertex, bz, &impactParameter0);
-      trackParVar1.propagateToDCA(primaryVertex, bz, &impactParameter1);
-      trackParVar2.propagateToDCA(primaryVertex, bz, &impactParameter2);
+      trackParVar0.propagateToDCA(primaryVertex, bzCandidate, &impactParameter0);
+      trackParVar1.propagateToDCA(primaryVertex, bzCandidate, &impactParameter1);
+      trackParVar2.propagateToDCA(primaryVertex, bzCandidate, &impactParameter2);
       hDcaXYProngs->Fill(track0.pt(), impactParameter0.getY() * toMicrometers);
       hDcaXYProngs->Fill(track1.pt(), impactParameter1.getY() * toMicrometers);
       hDcaXYProngs->Fill(track2.pt(), impactParameter2.getY() * toMicrometers);
@@ -26,6 +26,7 @@
 #include "PWGHF/Core/HfMlResponseD0ToKPi.h"
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
+#include "PWGHF/Utils/utilsSelectionProfiler.h"
 
 using namespace o2;
 using namespace o2::analysis;
@@ -76,14 +77,26 @@ struct HfCandidateSelectorD0 {
   Configurable<std::vector<std::string>> onnxFileNames{"onnxFileNames", std::vector<std::string>{"ModelHandler_onnx_D0ToKPi.onnx"}, "ONNX file names for each pT bin (if not from CCDB full path)"};
   Configurable<int64_t> timestampCCDB{"timestampCCDB", -1, "timestamp of the ONNX file for ML model used to query in CCDB"};
   Configurable<bool> loadModelsFromCCDB{"loadModelsFromCCDB", false, "Flag to enable or disable the loading of models from CCDB"};
+  // selection profiling
+  Configurable<bool> activateSelectionProfiling{"activateSelectionProfiling", false, "Flag to fill histograms with the rejection and the time of each selection step per pT bin"};
 
   o2::analysis::HfMlResponseD0ToKPi<float> hfMlResponse;
+  std::vector<float> inputFeatures = {}; // input features of the ML models, reused for all the candidates
   std::vector<float> outputMlD0 = {};
   std::vector<float> outputMlD0bar = {};
   o2::ccdb::CcdbApi ccdbApi;
   TrackSelectorPi selectorPion;
   TrackSelectorKa selectorKaon;
   HfHelper hfHelper;
+  HfSelectionProfiler selectionProfiler;
+  std::vector<std::array<double, hf_cuts_d0_to_pi_k::nCutVars>> cutsPerPtBin; // topological cuts per pT bin, with the columns of hf_cuts_d0_to_pi_k::CutVar
+
+  enum ProfiledStep {
+    Topol = 0,
+    TopolConjugate,
+    Pid,
+    Ml
+  };
 
   using TracksSel = soa::Join<aod::TracksWDcaExtra, aod::TracksPidPiExt, aod::TracksPidKaExt>;
 
@@ -107,6 +120,10 @@ struct HfCandidateSelectorD0 {
       registry.add("DebugBdt/hMassDmesonSel", ";#it{M}(D) (GeV/#it{c}^{2});counts", {HistType::kTH1F, {axisMassDmeson}});
     }
 
+    if (activateSelectionProfiling) {
+      selectionProfiler.init(registry, binsPt, {"topol.", "topol. conjugate", "PID", "ML"});
+    }
+
     selectorPion.setRangePtTpc(ptPidTpcMin, ptPidTpcMax);
     selectorPion.setRangeNSigmaTpc(-nSigmaTpcMax, nSigmaTpcMax);
     selectorPion.setRangeNSigmaTpcCondTof(-nSigmaTpcCombinedMax, nSigmaTpcCombinedMax);
@@ -115,6 +132,8 @@ struct HfCandidateSelectorD0 {
     selectorPion.setRangeNSigmaTofCondTpc(-nSigmaTofCombinedMax, nSigmaTofCombinedMax);
     selectorKaon = selectorPion;
 
+    cutsPerPtBin = getCutsPerPtBin<hf_cuts_d0_to_pi_k::nCutVars>(cuts.value, hf_cuts_d0_to_pi_k::labelsCutVar);
+
     if (applyMl) {
       hfMlResponse.configure(binsPtMl, cutsMl, cutDirMl, nClassesMl);
       if (loadModelsFromCCDB) {
@@ -146,19 +165,19 @@ struct HfCandidateSelectorD0 {
       return false;
     }
     // product of daughter impact parameters
-    if (candidate.impactParameterProduct() > cuts->get(pTBin, "d0d0")) {
+    if (candidate.impactParameterProduct() > cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::D0D0]) {
       return false;
     }
     // cosine of pointing angle
-    if (candidate.cpa() < cuts->get(pTBin, "cos pointing angle")) {
+    if (candidate.cpa() < cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::CosPointingAngle]) {
       return false;
     }
     // cosine of pointing angle XY
-    if (candidate.cpaXY() < cuts->get(pTBin, "cos pointing angle xy")) {
+    if (candidate.cpaXY() < cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::CosPointingAngleXY]) {
       return false;
     }
     // normalised decay length in XY plane
-    if (candidate.decayLengthXYNormalised() < cuts->get(pTBin, "min norm decay length XY")) {
+    if (candidate.decayLengthXYNormalised() < cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::MinNormDecayLengthXY]) {
       return false;
     }
     // candidate DCA
@@ -168,16 +187,16 @@ struct HfCandidateSelectorD0 {
     // if constexpr (reconstructionType == aod::hf_cand::VertexerType::KfParticle) {
     //   if (candidate.kfTopolChi2OverNdf() > cuts->get(pTBin, "topological chi2overndf as D0")) return false;
     // }
-    if (std::abs(candidate.impactParameterNormalised0()) < cuts->get(pTBin, "norm dauImpPar XY") || std::abs(candidate.impactParameterNormalised1()) < cuts->get(pTBin, "norm dauImpPar XY")) {
+    if (std::abs(candidate.impactParameterNormalised0()) < cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::NormDauImpParXY] || std::abs(candidate.impactParameterNormalised1()) < cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::NormDauImpParXY]) {
       return false;
     }
-    if (candidate.decayLength() < cuts->get(pTBin, "min decay length")) {
+    if (candidate.decayLength() < cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::MinDecayLength]) {
       return false;
     }
-    if (candidate.decayLength() > cuts->get(pTBin, "max decay length")) {
+    if (candidate.decayLength() > cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::MaxDecayLength]) {
       return false;
     }
-    if (candidate.decayLengthXY() > cuts->get(pTBin, "max decay length XY")) {
+    if (candidate.decayLengthXY() > cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::MaxDecayLengthXY]) {
       return false;
     }
 
@@ -210,32 +229,32 @@ struct HfCandidateSelectorD0 {
       massD0bar = hfHelper.invMassD0barToKPi(candidate);
     }
     if (trackPion.sign() > 0) {
-      if (std::abs(massD0 - o2::constants::physics::MassD0) > cuts->get(pTBin, "m")) {
+      if (std::abs(massD0 - o2::constants::physics::MassD0) > cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::Mass]) {
         return false;
       }
     } else {
-      if (std::abs(massD0bar - o2::constants::physics::MassD0) > cuts->get(pTBin, "m")) {
+      if (std::abs(massD0bar - o2::constants::physics::MassD0) > cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::Mass]) {
         return false;
       }
     }
 
     // cut on daughter pT
-    if (trackPion.pt() < cuts->get(pTBin, "pT Pi") || trackKaon.pt() < cuts->get(pTBin, "pT K")) {
+    if (trackPion.pt() < cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::PtPi] || trackKaon.pt() < cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::PtK]) {
       return false;
     }
 
     // cut on daughter DCA - need to add secondary vertex constraint here
-    if (std::abs(trackPion.dcaXY()) > cuts->get(pTBin, "d0pi") || std::abs(trackKaon.dcaXY()) > cuts->get(pTBin, "d0K")) {
+    if (std::abs(trackPion.dcaXY()) > cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::D0Pi] || std::abs(trackKaon.dcaXY()) > cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::D0K]) {
       return false;
     }
 
     // cut on cos(theta*)
     if (trackPion.sign() > 0) {
-      if (std::abs(hfHelper.cosThetaStarD0(candidate)) > cuts->get(pTBin, "cos theta*")) {
+      if (std::abs(hfHelper.cosThetaStarD0(candidate)) > cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::CosThetaStar]) {
         return false;
       }
     } else {
-      if (std::abs(hfHelper.cosThetaStarD0bar(candidate)) > cuts->get(pTBin, "cos theta*")) {
+      if (std::abs(hfHelper.cosThetaStarD0bar(candidate)) > cutsPerPtBin[pTBin][hf_cuts_d0_to_pi_k::CosThetaStar]) {
         return false;
       }
     }
@@ -287,7 +306,10 @@ struct HfCandidateSelectorD0 {
       auto trackNeg = candidate.template prong1_as<TracksSel>(); // negative daughter
 
       // conjugate-independent topological selection
-      if (!selectionTopol<reconstructionType>(candidate)) {
+      selectionProfiler.start();
+      bool topol = selectionTopol<reconstructionType>(candidate);
+      selectionProfiler.stop(ProfiledStep::Topol, ptCand, topol);
+      if (!topol) {
         hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
         if (applyMl) {
           hfMlD0Candidate(outputMlD0, outputMlD0bar);
@@ -299,10 +321,12 @@ struct HfCandidateSelectorD0 {
       // implement filter bit 4 cut - should be done before this task at the track selection level
       // need to add special cuts (additional cuts on decay length and d0 norm)
 
+      selectionProfiler.start();
       // conjugate-dependent topological selection for D0
       bool topolD0 = selectionTopolConjugate<reconstructionType>(candidate, trackPos, trackNeg);
       // conjugate-dependent topological selection for D0bar
       bool topolD0bar = selectionTopolConjugate<reconstructionType>(candidate, trackNeg, trackPos);
+      selectionProfiler.stop(ProfiledStep::TopolConjugate, ptCand, topolD0 || topolD0bar);
 
       if (!topolD0 && !topolD0bar) {
         hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
@@ -314,6 +338,7 @@ struct HfCandidateSelectorD0 {
       statusCand = 1;
 
       // track-level PID selection
+      selectionProfiler.start();
       int pidTrackPosKaon = -1;
       int pidTrackPosPion = -1;
       int pidTrackNegKaon = -1;
@@ -352,6 +377,7 @@ struct HfCandidateSelectorD0 {
         pidD0bar = 0; // exclude D0bar
       }
 
+      selectionProfiler.stop(ProfiledStep::Pid, ptCand, pidD0 != 0 || pidD0bar != 0);
       if (pidD0 == 0 && pidD0bar == 0) {
         hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
         if (applyMl) {
@@ -373,14 +399,16 @@ struct HfCandidateSelectorD0 {
         bool isSelectedMlD0 = false;
         bool isSelectedMlD0bar = false;
 
+        selectionProfiler.start();
         if (statusD0 > 0) {
-          std::vector<float> inputFeaturesD0 = hfMlResponse.getInputFeatures(candidate, trackPos, trackNeg, o2::constants::physics::kD0);
-          isSelectedMlD0 = hfMlResponse.isSelectedMl(inputFeaturesD0, ptCand, outputMlD0);
+          hfMlResponse.fillInputFeatures(inputFeatures, candidate, trackPos, trackNeg, o2::constants::physics::kD0);
+          isSelectedMlD0 = hfMlResponse.isSelectedMl(inputFeatures, ptCand, outputMlD0);
         }
         if (statusD0bar > 0) {
-          std::vector<float> inputFeaturesD0bar = hfMlResponse.getInputFeatures(candidate, trackPos, trackNeg, o2::constants::physics::kD0Bar);
-          isSelectedMlD0bar = hfMlResponse.isSelectedMl(inputFeaturesD0bar, ptCand, outputMlD0bar);
+          hfMlResponse.fillInputFeatures(inputFeatures, candidate, trackPos, trackNeg, o2::constants::physics::kD0Bar);
+          isSelectedMlD0bar = hfMlResponse.isSelectedMl(inputFeatures, ptCand, outputMlD0bar);
         }
+        selectionProfiler.stop(ProfiledStep::Ml, ptCand, isSelectedMlD0 || isSelectedMlD0bar);
 
         if (!isSelectedMlD0) {
           statusD0 = 0;
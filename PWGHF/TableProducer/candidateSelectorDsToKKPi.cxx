@@ -72,6 +72,7 @@ struct HfCandidateSelectorDsToKKPi {
 
   HfHelper hfHelper;
   o2::analysis::HfMlResponseDsToKKPi<float> hfMlResponse;
+  std::vector<float> inputFeatures = {}; // input features of the ML models, reused for all the candidates
   std::vector<float> outputMlDsToKKPi = {};
   std::vector<float> outputMlDsToPiKK = {};
   o2::ccdb::CcdbApi ccdbApi;
@@ -308,12 +309,12 @@ struct HfCandidateSelectorDsToKKPi {
         bool isSelectedMlDsToPiKK = false;
 
         if (topolDsToKKPi && pidDsToKKPi) {
-          std::vector<float> inputFeaturesDsToKKPi = hfMlResponse.getInputFeatures(candidate, trackPos1, trackNeg, trackPos2, true);
-          isSelectedMlDsToKKPi = hfMlResponse.isSelectedMl(inputFeaturesDsToKKPi, candidate.pt(), outputMlDsToKKPi);
+          hfMlResponse.fillInputFeatures(inputFeatures, candidate, trackPos1, trackNeg, trackPos2, true);
+          isSelectedMlDsToKKPi = hfMlResponse.isSelectedMl(inputFeatures, candidate.pt(), outputMlDsToKKPi);
         }
         if (topolDsToPiKK && pidDsToPiKK) {
-          std::vector<float> inputFeaturesDsToPiKK = hfMlResponse.getInputFeatures(candidate, trackPos1, trackNeg, trackPos2, false);
-          isSelectedMlDsToPiKK = hfMlResponse.isSelectedMl(inputFeaturesDsToPiKK, candidate.pt(), outputMlDsToPiKK);
+          hfMlResponse.fillInputFeatures(inputFeatures, candidate, trackPos1, trackNeg, trackPos2, false);
+          isSelectedMlDsToPiKK = hfMlResponse.isSelectedMl(inputFeatures, candidate.pt(), outputMlDsToPiKK);
         }
 
         hfMlDsToKKPiCandidate(outputMlDsToKKPi, outputMlDsToPiKK);
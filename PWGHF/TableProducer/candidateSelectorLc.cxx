@@ -28,6 +28,7 @@
 #include "PWGHF/Core/SelectorCuts.h"
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
+#include "PWGHF/Utils/utilsSelectionProfiler.h"
 
 using namespace o2;
 using namespace o2::analysis;
@@ -82,15 +83,26 @@ struct HfCandidateSelectorLc {
   Configurable<std::vector<std::string>> onnxFileNames{"onnxFileNames", std::vector<std::string>{"ModelHandler_onnx_LcToPKPi.onnx"}, "ONNX file names for each pT bin (if not from CCDB full path)"};
   Configurable<int64_t> timestampCCDB{"timestampCCDB", -1, "timestamp of the ONNX file for ML model used to query in CCDB"};
   Configurable<bool> loadModelsFromCCDB{"loadModelsFromCCDB", false, "Flag to enable or disable the loading of models from CCDB"};
+  // selection profiling
+  Configurable<bool> activateSelectionProfiling{"activateSelectionProfiling", false, "Flag to fill histograms with the rejection and the time of each selection step per pT bin"};
 
   HfHelper hfHelper;
   o2::analysis::HfMlResponseLcToPKPi<float> hfMlResponse;
+  std::vector<float> inputFeatures = {}; // input features of the ML models, reused for all the candidates
   std::vector<float> outputMlLcToPKPi = {};
   std::vector<float> outputMlLcToPiKP = {};
   o2::ccdb::CcdbApi ccdbApi;
   TrackSelectorPi selectorPion;
   TrackSelectorKa selectorKaon;
   TrackSelectorPr selectorProton;
+  HfSelectionProfiler selectionProfiler;
+
+  enum ProfiledStep {
+    Topol = 0,
+    TopolConjugate,
+    Pid,
+    Ml
+  };
 
   using TracksSel = soa::Join<aod::TracksWExtra,
                               aod::TracksPidPiExt, aod::TracksPidKaExt, aod::TracksPidPrExt,
@@ -125,6 +137,10 @@ struct HfCandidateSelectorLc {
       }
     }
 
+    if (activateSelectionProfiling) {
+      selectionProfiler.init(registry, binsPt, {"topol.", "topol. conjugate", "PID", "ML"});
+    }
+
     if (applyMl) {
       hfMlResponse.configure(binsPtMl, cutsMl, cutDirMl, nClassesMl);
       if (loadModelsFromCCDB) {
@@ -243,7 +259,10 @@ struct HfCandidateSelectorLc {
       // implement filter bit 4 cut - should be done before this task at the track selection level
 
       // conjugate-independent topological selection
-      if (!selectionTopol(candidate)) {
+      selectionProfiler.start();
+      bool topol = selectionTopol(candidate);
+      selectionProfiler.stop(ProfiledStep::Topol, ptCand, topol);
+      if (!topol) {
         hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
         if (applyMl) {
           hfMlLcToPKPiCandidate(outputMlLcToPKPi, outputMlLcToPiKP);
@@ -253,8 +272,10 @@ struct HfCandidateSelectorLc {
 
       // conjugate-dependent topological selection for Lc
 
+      selectionProfiler.start();
       bool topolLcToPKPi = selectionTopolConjugate(candidate, trackPos1, trackNeg, trackPos2);
       bool topolLcToPiKP = selectionTopolConjugate(candidate, trackPos2, trackNeg, trackPos1);
+      selectionProfiler.stop(ProfiledStep::TopolConjugate, ptCand, topolLcToPKPi || topolLcToPiKP);
 
       if (!topolLcToPKPi && !topolLcToPiKP) {
         hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
@@ -268,6 +289,7 @@ struct HfCandidateSelectorLc {
         registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoTopol, candidate.pt());
       }
 
+      selectionProfiler.start();
       auto pidLcToPKPi = -1;
       auto pidLcToPiKP = -1;
       auto pidBayesLcToPKPi = -1;
@@ -349,6 +371,7 @@ struct HfCandidateSelectorLc {
         }
       }
 
+      selectionProfiler.stop(ProfiledStep::Pid, ptCand, (pidLcToPKPi != 0 || pidLcToPiKP != 0) && (pidBayesLcToPKPi != 0 || pidBayesLcToPiKP != 0));
       if (pidLcToPKPi == 0 && pidLcToPiKP == 0) {
         hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
         if (applyMl) {
@@ -377,14 +400,16 @@ struct HfCandidateSelectorLc {
         bool isSelectedMlLcToPKPi = false;
         bool isSelectedMlLcToPiKP = false;
 
+        selectionProfiler.start();
         if ((pidLcToPKPi == -1 || pidLcToPKPi == 1) && (pidBayesLcToPKPi == -1 || pidBayesLcToPKPi == 1) && topolLcToPKPi) {
-          std::vector<float> inputFeaturesLcToPKPi = hfMlResponse.getInputFeatures(candidate, trackPos1, trackNeg, trackPos2);
-          isSelectedMlLcToPKPi = hfMlResponse.isSelectedMl(inputFeaturesLcToPKPi, candidate.pt(), outputMlLcToPKPi);
+          hfMlResponse.fillInputFeatures(inputFeatures, candidate, trackPos1, trackNeg, trackPos2);
+          isSelectedMlLcToPKPi = hfMlResponse.isSelectedMl(inputFeatures, candidate.pt(), outputMlLcToPKPi);
         }
         if ((pidLcToPiKP == -1 || pidLcToPiKP == 1) && (pidBayesLcToPiKP == -1 || pidBayesLcToPiKP == 1) && topolLcToPiKP) {
-          std::vector<float> inputFeaturesLcToPiKP = hfMlResponse.getInputFeatures(candidate, trackPos1, trackNeg, trackPos2);
-          isSelectedMlLcToPiKP = hfMlResponse.isSelectedMl(inputFeaturesLcToPiKP, candidate.pt(), outputMlLcToPiKP);
+          hfMlResponse.fillInputFeatures(inputFeatures, candidate, trackPos1, trackNeg, trackPos2);
+          isSelectedMlLcToPiKP = hfMlResponse.isSelectedMl(inputFeatures, candidate.pt(), outputMlLcToPiKP);
         }
+        selectionProfiler.stop(ProfiledStep::Ml, ptCand, isSelectedMlLcToPKPi || isSelectedMlLcToPiKP);
 
         hfMlLcToPKPiCandidate(outputMlLcToPKPi, outputMlLcToPiKP);
 
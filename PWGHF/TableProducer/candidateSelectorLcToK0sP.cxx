@@ -81,6 +81,8 @@ struct HfCandidateSelectorLcToK0sP {
   TrackSelectorPr selectorProtonHighP;
 
   o2::analysis::HfMlResponseLcToK0sP<float> hfMlResponse;
+  std::vector<float> inputFeatures = {}; // input features of the ML models, reused for all the candidates
+  std::vector<float> outputMl = {};
 
   o2::ccdb::CcdbApi ccdbApi;
 
@@ -225,8 +227,7 @@ struct HfCandidateSelectorLcToK0sP {
   {
 
     auto ptCand = hfCandCascade.pt();
-    std::vector<float> inputFeatures = hfMlResponse.getInputFeatures(hfCandCascade, bach);
-    std::vector<float> outputMl = {};
+    hfMlResponse.fillInputFeatures(inputFeatures, hfCandCascade, bach);
 
     bool isSelectedMl = hfMlResponse.isSelectedMl(inputFeatures, ptCand, outputMl);
 
@@ -70,6 +70,7 @@ struct HfCandidateSelectorXicToPKPi {
   Configurable<bool> loadModelsFromCCDB{"loadModelsFromCCDB", false, "Flag to enable or disable the loading of models from CCDB"};
 
   o2::analysis::HfMlResponseXicToPKPi<float> hfMlResponse;
+  std::vector<float> inputFeatures = {}; // input features of the ML models, reused for all the candidates
   std::vector<float> outputMlXicToPKPi = {};
   std::vector<float> outputMlXicToPiKP = {};
   o2::ccdb::CcdbApi ccdbApi;
@@ -313,12 +314,12 @@ struct HfCandidateSelectorXicToPKPi {
         bool isSelectedMlXicToPiKP = false;
 
         if (topolXicToPKPi && pidXicToPKPi) {
-          std::vector<float> inputFeaturesXicToPKPi = hfMlResponse.getInputFeatures(candidate, trackPos1, trackNeg, trackPos2);
-          isSelectedMlXicToPKPi = hfMlResponse.isSelectedMl(inputFeaturesXicToPKPi, ptCand, outputMlXicToPKPi);
+          hfMlResponse.fillInputFeatures(inputFeatures, candidate, trackPos1, trackNeg, trackPos2);
+          isSelectedMlXicToPKPi = hfMlResponse.isSelectedMl(inputFeatures, ptCand, outputMlXicToPKPi);
         }
         if (topolXicToPiKP && pidXicToPiKP) {
-          std::vector<float> inputFeaturesXicToPiKP = hfMlResponse.getInputFeatures(candidate, trackPos1, trackNeg, trackPos2);
-          isSelectedMlXicToPiKP = hfMlResponse.isSelectedMl(inputFeaturesXicToPiKP, ptCand, outputMlXicToPiKP);
+          hfMlResponse.fillInputFeatures(inputFeatures, candidate, trackPos1, trackNeg, trackPos2);
+          isSelectedMlXicToPiKP = hfMlResponse.isSelectedMl(inputFeatures, ptCand, outputMlXicToPiKP);
         }
 
         hfMlXicToPKPiCandidate(outputMlXicToPKPi, outputMlXicToPiKP);
@@ -32,6 +32,8 @@ using namespace o2::framework::expressions;
 
 /// Writes the full information in an output TTree
 struct HfDerivedDataCreatorD0ToKPi {
+  // Candidate column groups, filled with one row per selected mass hypothesis in the same order, such that they can be joined
+  // The ML scores (HfD0Mls) can be appended later to the stored tables with derivedDataMlD0ToKPi.cxx
   Produces<o2::aod::HfD0Bases> rowCandidateBase;
   Produces<o2::aod::HfD0Pars> rowCandidatePar;
   Produces<o2::aod::HfD0ParEs> rowCandidateParE;
@@ -0,0 +1,89 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file derivedDataMlD0ToKPi.cxx
+/// \brief Producer of the ML-score column group of existing derived tables of D0 candidates
+/// \note The scores are computed from the stored candidate parameters, without re-running the candidate reconstruction.
+///       The produced table is row-aligned with the stored candidate tables (HfD0Bases, HfD0Pars, ...).
+
+#include <string>
+#include <vector>
+
+#include "CCDB/CcdbApi.h"
+#include "Framework/AnalysisTask.h"
+#include "Framework/runDataProcessing.h"
+
+#include "PWGHF/Core/HfMlResponseD0ToKPi.h"
+#include "PWGHF/Core/SelectorCuts.h"
+#include "PWGHF/DataModel/DerivedTables.h"
+
+using namespace o2;
+using namespace o2::analysis;
+using namespace o2::framework;
+
+/// Appends the ML scores to the derived D0 candidates
+struct HfDerivedDataMlD0ToKPi {
+  Produces<o2::aod::HfD0Mls> rowCandidateMl;
+
+  // ML inference
+  Configurable<std::vector<double>> binsPtMl{"binsPtMl", std::vector<double>{hf_cuts_ml::vecBinsPt}, "pT bin limits for ML application"};
+  Configurable<std::vector<int>> cutDirMl{"cutDirMl", std::vector<int>{hf_cuts_ml::vecCutDir}, "Whether to reject score values greater or smaller than the threshold"};
+  Configurable<LabeledArray<double>> cutsMl{"cutsMl", {hf_cuts_ml::cuts[0], hf_cuts_ml::nBinsPt, hf_cuts_ml::nCutScores, hf_cuts_ml::labelsPt, hf_cuts_ml::labelsCutScore}, "ML selections per pT bin"};
+  Configurable<int8_t> nClassesMl{"nClassesMl", (int8_t)hf_cuts_ml::nCutScores, "Number of classes in ML model"};
+  Configurable<std::vector<std::string>> namesInputFeatures{"namesInputFeatures", std::vector<std::string>{"feature1", "feature2"}, "Names of ML model input features"};
+  // CCDB configuration
+  Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
+  Configurable<std::vector<std::string>> modelPathsCCDB{"modelPathsCCDB", std::vector<std::string>{"EventFiltering/PWGHF/BDTD0"}, "Paths of models on CCDB"};
+  Configurable<std::vector<std::string>> onnxFileNames{"onnxFileNames", std::vector<std::string>{"ModelHandler_onnx_D0ToKPi.onnx"}, "ONNX file names for each pT bin (if not from CCDB full path)"};
+  Configurable<int64_t> timestampCCDB{"timestampCCDB", -1, "timestamp of the ONNX file for ML model used to query in CCDB"};
+  Configurable<bool> loadModelsFromCCDB{"loadModelsFromCCDB", false, "Flag to enable or disable the loading of models from CCDB"};
+
+  o2::analysis::HfMlResponseD0ToKPi<float> hfMlResponse;
+  std::vector<float> inputFeatures = {}; // input features of the ML models, reused for all the candidates
+  std::vector<float> outputMl = {};
+  o2::ccdb::CcdbApi ccdbApi;
+
+  using StoredCandidates = soa::Join<aod::StoredHfD0Bases, aod::StoredHfD0Pars, aod::StoredHfD0ParEs>;
+
+  void init(InitContext const&)
+  {
+    hfMlResponse.configure(binsPtMl, cutsMl, cutDirMl, nClassesMl);
+    if (loadModelsFromCCDB) {
+      ccdbApi.init(ccdbUrl);
+      hfMlResponse.setModelPathsCCDB(onnxFileNames, ccdbApi, modelPathsCCDB, timestampCCDB);
+    } else {
+      hfMlResponse.setModelPathsLocal(onnxFileNames);
+    }
+    hfMlResponse.cacheInputFeaturesIndices(namesInputFeatures);
+    hfMlResponse.init();
+  }
+
+  void process(StoredCandidates const& candidates)
+  {
+    rowCandidateMl.reserve(candidates.size());
+    for (const auto& candidate : candidates) {
+      // one row per stored candidate, to keep the alignment with the other column groups
+      auto ptCand = candidate.pt();
+      if (hfMlResponse.findBin(&binsPtMl.value, ptCand) < 0) {
+        outputMl.clear();
+      } else {
+        hfMlResponse.fillInputFeaturesDerived(inputFeatures, candidate);
+        hfMlResponse.isSelectedMl(inputFeatures, ptCand, outputMl);
+      }
+      rowCandidateMl(outputMl);
+    }
+  }
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{adaptAnalysisTask<HfDerivedDataMlD0ToKPi>(cfgc)};
+}
@@ -22,7 +22,11 @@
 
 #include <algorithm> // std::find
 #include <iterator>  // std::distance
+#include <limits>    // std::numeric_limits
+#include <list>      // std::list
+#include <map>       // std::map
 #include <string>    // std::string
+#include <thread>    // std::thread
 #include <vector>    // std::vector
 
 #include "CommonConstants/PhysicsConstants.h"
@@ -38,6 +42,7 @@
 #include "ReconstructionDataFormats/V0.h"
 #include "ReconstructionDataFormats/Vertex.h" // for PV refit
 
+#include "Common/Core/ProcessTimer.h"
 #include "Common/Core/TrackSelectorPID.h"
 #include "Common/Core/trackUtilities.h"
 #include "Common/DataModel/Centrality.h"
@@ -1262,6 +1267,98 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
 
 //____________________________________________________________________________________________________________________________________________
 
+/// Secondary-vertex fits of the N-prong track combinations of a collision
+/// The fits are either computed one by one in the candidate loop, or computed all together by a pool of workers
+/// before it (in parallel mode), and then read back in the order of the candidate loop
+template <int N>
+struct HfVertexFits {
+  /// Result of a secondary-vertex fit
+  struct Fit {
+    bool isFitted{false};                       // whether the fit found a vertex
+    std::array<double, 3> secondaryVertex{};    // position of the secondary vertex
+    std::array<std::array<float, 3>, N> pVec{}; // momenta of the tracks at the secondary vertex
+  };
+
+  std::vector<std::array<int, N>> tracks; // indices of the tracks of each combination to fit, in the order of the candidate loop
+  std::vector<Fit> fits;                  // fits of the combinations, filled in parallel mode
+  std::size_t next{0};                    // next fit to be read back in parallel mode
+  bool isParallel{false};                 // whether the fits are computed before the candidate loop
+  Fit fitSerial;                          // fit of the current combination in serial mode
+
+  void clear()
+  {
+    tracks.clear();
+    fits.clear();
+    next = 0;
+  }
+
+  /// Fits the secondary vertex of a combination
+  /// \param df is the vertex fitter
+  /// \param trackParVars are the track parametrisations of the collision
+  /// \param iTracks are the indices of the tracks of the combination
+  /// \param fit is the result of the fit
+  static void fitVertex(o2::vertexing::DCAFitterN<N>& df, std::vector<o2::track::TrackParCov> const& trackParVars, std::array<int, N> const& iTracks, Fit& fit)
+  {
+    if constexpr (N == 2) {
+      fit.isFitted = (df.process(trackParVars[iTracks[0]], trackParVars[iTracks[1]]) > 0);
+    } else {
+      fit.isFitted = (df.process(trackParVars[iTracks[0]], trackParVars[iTracks[1]], trackParVars[iTracks[2]]) > 0);
+    }
+    if (!fit.isFitted) {
+      return;
+    }
+    const auto& secondaryVertex = df.getPCACandidate();
+    for (int iCoord = 0; iCoord < 3; iCoord++) {
+      fit.secondaryVertex[iCoord] = secondaryVertex[iCoord];
+    }
+    for (int iProng = 0; iProng < N; iProng++) {
+      df.getTrack(iProng).getPxPyPzGlo(fit.pVec[iProng]);
+    }
+  }
+
+  /// Computes the fits of all the combinations, splitting them in contiguous chunks over the fitters (one thread per fitter)
+  /// \param fitters are the vertex fitters, one per worker
+  /// \param trackParVars are the track parametrisations of the collision
+  void fitAll(std::vector<o2::vertexing::DCAFitterN<N>>& fitters, std::vector<o2::track::TrackParCov> const& trackParVars)
+  {
+    const std::size_t nFits = tracks.size();
+    fits.resize(nFits);
+    next = 0;
+    if (nFits == 0) {
+      return;
+    }
+    const std::size_t chunkSize = (nFits + fitters.size() - 1) / fitters.size();
+    std::vector<std::thread> workers;
+    for (std::size_t iWorker = 0; iWorker * chunkSize < nFits; iWorker++) {
+      workers.emplace_back([this, &fitters, &trackParVars, iWorker, chunkSize, nFits]() {
+        const std::size_t last = std::min(nFits, (iWorker + 1) * chunkSize);
+        for (std::size_t iFit = iWorker * chunkSize; iFit < last; iFit++) {
+          fitVertex(fitters[iWorker], trackParVars, tracks[iFit], fits[iFit]);
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  /// Returns the fit of the next combination of the candidate loop
+  /// \param df is the vertex fitter used in serial mode
+  /// \param trackParVars are the track parametrisations of the collision
+  /// \param iTracks are the indices of the tracks of the combination
+  const Fit& get(o2::vertexing::DCAFitterN<N>& df, std::vector<o2::track::TrackParCov> const& trackParVars, std::array<int, N> const& iTracks)
+  {
+    if (!isParallel) {
+      fitVertex(df, trackParVars, iTracks, fitSerial);
+      return fitSerial;
+    }
+    if (next >= tracks.size() || tracks[next] != iTracks) {
+      LOG(fatal) << "HfVertexFits: the " << N << "-prong combinations fitted in parallel do not match the ones of the candidate loop";
+    }
+    return fits[next++];
+  }
+};
+
 /// Pre-selection of 2-prong and 3-prong secondary vertices
 struct HfTrackIndexSkimCreator {
   Produces<aod::Hf2Prongs> rowTrackIndexProng2;
@@ -1279,12 +1376,15 @@ struct HfTrackIndexSkimCreator {
   Configurable<bool> doDstar{"doDstar", false, "do D* candidates"};
   Configurable<bool> debug{"debug", false, "debug mode"};
   Configurable<bool> debugPvRefit{"debugPvRefit", false, "debug lines for primary vertex refit"};
+  Configurable<int> pvRefitCacheSize{"pvRefitCacheSize", 1000, "max. number of PV refits (per set of excluded daughters) cached per collision, 0 to disable the cache"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "fill histograms"};
+  Configurable<bool> enableTimer{"enableTimer", false, "time the 2-prong and 3-prong skimming (histograms in ProcessTimer/)"};
   ConfigurableAxis axisNumTracks{"axisNumTracks", {250, -0.5f, 249.5f}, "Number of tracks"};
   ConfigurableAxis axisNumCands{"axisNumCands", {200, -0.5f, 199.f}, "Number of candidates"};
   // Configurable<int> nCollsMax{"nCollsMax", -1, "Max collisions per file"}; //can be added to run over limited collisions per file - for tesing purposes
   // preselection
   Configurable<double> ptTolerance{"ptTolerance", 0.1, "pT tolerance in GeV/c for applying preselections before vertex reconstruction"};
+  Configurable<bool> usePrePairing{"usePrePairing", true, "skip the track combinations which cannot pass the pT and impact-parameter preselections, using per-track bounds"};
   // vertexing
   // Configurable<double> bz{"bz", 5., "magnetic field kG"};
   Configurable<bool> propagateToPCA{"propagateToPCA", true, "create tracks version propagated to PCA"};
@@ -1294,6 +1394,7 @@ struct HfTrackIndexSkimCreator {
   Configurable<double> maxDZIni{"maxDZIni", 4., "reject (if>0) PCA candidate if tracks DZ exceeds threshold"};
   Configurable<double> minParamChange{"minParamChange", 1.e-3, "stop iterations if largest change of any X is smaller than this"};
   Configurable<double> minRelChi2Change{"minRelChi2Change", 0.9, "stop iterations if chi2/chi2old > this"};
+  Configurable<int> nThreadsVertexing{"nThreadsVertexing", 1, "number of threads for the secondary-vertex fits of a collision, 1 for serial fits"};
   // CCDB
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::string> ccdbPathLut{"ccdbPathLut", "GLO/Param/MatLUT", "Path for LUT parametrization"};
@@ -1334,6 +1435,15 @@ struct HfTrackIndexSkimCreator {
   o2::base::MatLayerCylSet* lut;
   o2::base::Propagator::MatCorrType noMatCorr = o2::base::Propagator::MatCorrType::USEMatCorrNONE;
   int runNumber;
+  // PV refit excluding the candidate daughters, prepared once per collision (see performPvRefitCandProngs)
+  using PvRefitKey = std::array<int, 3>; // sorted entries of the excluded PV contributors, -1 if unused
+  o2::vertexing::PVertexer pvRefitVertexer;
+  o2::dataformats::VertexBase pvRefitPrimVtx;
+  int64_t pvRefitCollisionId{-1}; // collision for which the vertexer is prepared
+  bool pvRefitDoable{false};
+  std::vector<bool> pvRefitContributorUsed;
+  std::list<std::pair<PvRefitKey, o2::dataformats::PrimaryVertex>> pvRefitCache; // refitted vertices, most recently used first
+  std::map<PvRefitKey, decltype(pvRefitCache)::iterator> pvRefitCacheIndex;
 
   double massPi{0.};
   double massK{0.};
@@ -1357,6 +1467,40 @@ struct HfTrackIndexSkimCreator {
   std::array<std::vector<double>, kN2ProngDecays> pTBins2Prong;
   std::array<LabeledArray<double>, kN3ProngDecays> cut3Prong;
   std::array<std::vector<double>, kN3ProngDecays> pTBins3Prong;
+  // bounds of the preselections over all the decay channels, used to skip track combinations before the preselections
+  double ptMinPresel2Prong{0.};                   // lower edge of the pT bins of the 2-prong decays
+  double ptMaxPresel2Prong{0.};                   // upper edge of the pT bins of the 2-prong decays
+  double d0d0MaxPresel2Prong{0.};                 // largest impact-parameter product accepted by the 2-prong decays
+  double ptMinPresel3Prong{0.};                   // lower edge of the pT bins of the 3-prong decays
+  double ptMaxPresel3Prong{0.};                   // upper edge of the pT bins of the 3-prong decays
+  static constexpr double kPtBoundMargin = 1.e-3; // margin (GeV/c) on the pT bounds, against rounding in the pT sums
+  // kinematics of the selected tracks of the current collision, propagated to it once per collision
+  std::vector<o2::track::TrackParCov> trackParCache;
+  std::vector<std::array<float, 3>> pVecCache;
+  std::vector<o2::gpu::gpustd::array<float, 2>> dcaInfoCache;
+  std::vector<float> ptCache;
+  // soft-pion candidates of the current collision, sorted by momentum, for the D* reconstruction
+  struct SoftPionCand {
+    float p;             // momentum magnitude
+    int iTrack;          // position in the caches of the collision
+    int64_t globalIndex; // global index of the track
+  };
+  std::vector<SoftPionCand> softPionsPos;
+  std::vector<SoftPionCand> softPionsNeg;
+  std::vector<SoftPionCand> softPionsInWindow;
+  double deltaMassMaxDstar{0.}; // largest D*-D0 mass difference accepted over the pT bins
+  // secondary-vertex fits of the current collision and fitters of the workers, for the parallel mode
+  HfVertexFits<2> vertexFits2Prong;
+  HfVertexFits<3> vertexFits3Prong;
+  std::vector<o2::vertexing::DCAFitterN<2>> fittersWorkers2Prong;
+  std::vector<o2::vertexing::DCAFitterN<3>> fittersWorkers3Prong;
+
+  // timed sections, counting the collisions and the fitted combinations respectively
+  enum TimerSection {
+    TimerSkim = 0,
+    TimerParallelFits
+  };
+  ProcessTimer timer;
 
   using SelectedCollisions = soa::Filtered<soa::Join<aod::Collisions, aod::HfSelCollision>>;
   using TracksWithPVRefitAndDCA = soa::Join<aod::TracksWCovDcaExtra, aod::HfPvRefitTrack>;
@@ -1389,6 +1533,8 @@ struct HfTrackIndexSkimCreator {
       return;
     }
 
+    timer.init(registry, {"skim", "parallel vertex fits"}, enableTimer);
+
     massPi = o2::constants::physics::MassPiPlus;
     massK = o2::constants::physics::MassKPlus;
     massProton = o2::constants::physics::MassProton;
@@ -1425,6 +1571,29 @@ struct HfTrackIndexSkimCreator {
     cut3Prong = {cutsDplusToPiKPi, cutsLcToPKPi, cutsDsToKKPi, cutsXicToPKPi};
     pTBins3Prong = {binsPtDplusToPiKPi, binsPtLcToPKPi, binsPtDsToKKPi, binsPtXicToPKPi};
 
+    // bounds of the preselections over all the decay channels
+    ptMinPresel2Prong = pTBins2Prong[0].front();
+    ptMaxPresel2Prong = pTBins2Prong[0].back();
+    d0d0MaxPresel2Prong = std::numeric_limits<double>::lowest();
+    for (int iDecay2P = 0; iDecay2P < kN2ProngDecays; iDecay2P++) {
+      ptMinPresel2Prong = std::min(ptMinPresel2Prong, pTBins2Prong[iDecay2P].front());
+      ptMaxPresel2Prong = std::max(ptMaxPresel2Prong, pTBins2Prong[iDecay2P].back());
+      int d0d0Index = cut2Prong[iDecay2P].colmap.find("d0d0")->second;
+      for (int iBin = 0; iBin < static_cast<int>(pTBins2Prong[iDecay2P].size()) - 1; iBin++) {
+        d0d0MaxPresel2Prong = std::max(d0d0MaxPresel2Prong, cut2Prong[iDecay2P].get(iBin, d0d0Index));
+      }
+    }
+    ptMinPresel3Prong = pTBins3Prong[0].front();
+    ptMaxPresel3Prong = pTBins3Prong[0].back();
+    for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
+      ptMinPresel3Prong = std::min(ptMinPresel3Prong, pTBins3Prong[iDecay3P].front());
+      ptMaxPresel3Prong = std::max(ptMaxPresel3Prong, pTBins3Prong[iDecay3P].back());
+    }
+    const int deltaMassIndexDstar = cutsDstarToD0Pi->colmap.find("deltaMassMax")->second;
+    for (int iBin = 0; iBin < static_cast<int>(binsPtDstarToD0Pi->size()) - 1; iBin++) {
+      deltaMassMaxDstar = std::max(deltaMassMaxDstar, cutsDstarToD0Pi->get(iBin, deltaMassIndexDstar));
+    }
+
     if (fillHistograms) {
       registry.add("hNTracks", "Number of selected tracks;# of selected tracks;entries", {HistType::kTH1F, {axisNumTracks}});
       // 2-prong histograms
@@ -1447,6 +1616,15 @@ struct HfTrackIndexSkimCreator {
       registry.add("hMassDsToKKPi", "D_{s}^{#plus} candidates;inv. mass (K K #pi) (GeV/#it{c}^{2});entries", {HistType::kTH1F, {{500, 0., 5.}}});
       registry.add("hMassXicToPKPi", "#Xi_{c}^{#plus} candidates;inv. mass (p K #pi) (GeV/#it{c}^{2});entries", {HistType::kTH1F, {{500, 0., 5.}}});
       registry.add("hMassDstarToD0Pi", "D^{*#plus} candidates;inv. mass (K #pi #pi) - mass (K #pi) (GeV/#it{c}^{2});entries", {HistType::kTH1F, {{500, 0.135, 0.185}}});
+      // track combinations skipped before the preselections
+      registry.add("hPrePairing", "track combinations;;entries", {HistType::kTH1D, {{7, 0.5, 7.5}}});
+      registry.get<TH1>(HIST("hPrePairing"))->GetXaxis()->SetBinLabel(1, "2-prong pairs");
+      registry.get<TH1>(HIST("hPrePairing"))->GetXaxis()->SetBinLabel(2, "2-prong pruned #it{p}_{T}");
+      registry.get<TH1>(HIST("hPrePairing"))->GetXaxis()->SetBinLabel(3, "2-prong pruned d_{0}d_{0}");
+      registry.get<TH1>(HIST("hPrePairing"))->GetXaxis()->SetBinLabel(4, "3-prong third-track loops");
+      registry.get<TH1>(HIST("hPrePairing"))->GetXaxis()->SetBinLabel(5, "3-prong loops pruned #it{p}_{T}");
+      registry.get<TH1>(HIST("hPrePairing"))->GetXaxis()->SetBinLabel(6, "3-prong triplets");
+      registry.get<TH1>(HIST("hPrePairing"))->GetXaxis()->SetBinLabel(7, "3-prong triplets pruned #it{p}_{T}");
 
       // needed for PV refitting
       if (doprocess2And3ProngsWithPvRefit) {
@@ -1476,6 +1654,9 @@ struct HfTrackIndexSkimCreator {
         registry.add("PvRefit/hPvRefitZChi2Minus1", "PV refit with #it{#chi}^{2}==#minus1", kTH2F, {axisCollisionZ, axisCollisionZOriginal});
         registry.add("PvRefit/hNContribPvRefitNotDoable", "N. contributors for PV refit not doable", kTH1F, {axisCollisionNContrib});
         registry.add("PvRefit/hNContribPvRefitChi2Minus1", "N. contributors original PV for PV refit #it{#chi}^{2}==#minus1", kTH1F, {axisCollisionNContrib});
+        registry.add("PvRefit/hCacheRefits", "PV refits excluding the candidate daughters", kTH1F, {{2, 0.5f, 2.5f, ""}});
+        registry.get<TH1>(HIST("PvRefit/hCacheRefits"))->GetXaxis()->SetBinLabel(1, "refitted");
+        registry.get<TH1>(HIST("PvRefit/hCacheRefits"))->GetXaxis()->SetBinLabel(2, "cached");
       }
     }
 
@@ -1566,6 +1747,25 @@ struct HfTrackIndexSkimCreator {
     }
   }
 
+  /// Method to check whether a track combination can pass the pT preselections, using only the pT of the tracks
+  /// \param ptTracks is the array of the pT of the tracks
+  /// \param ptMin is the lower edge of the pT bins of the decay channels
+  /// \param ptMax is the upper edge of the pT bins of the decay channels
+  /// \return false if the combination is outside the pT bins of all the decay channels
+  /// \note the pT of the combination is between |2 pT_max - sum(pT)| and sum(pT) of the tracks
+  template <std::size_t N>
+  bool isPtInPreselRange(std::array<float, N> const& ptTracks, double ptMin, double ptMax)
+  {
+    double ptSum = 0.;
+    double ptLargest = 0.;
+    for (const auto& ptTrack : ptTracks) {
+      ptSum += ptTrack;
+      ptLargest = std::max(ptLargest, static_cast<double>(ptTrack));
+    }
+    double ptLow = std::max(0., 2. * ptLargest - ptSum);
+    return ptSum + ptTolerance >= ptMin - kPtBoundMargin && ptLow + ptTolerance < ptMax + kPtBoundMargin;
+  }
+
   /// Method to perform selections on difference from nominal mass for phi decay
   /// \param pVecTrack0 is the momentum array of the first daughter track
   /// \param pVecTrack1 is the momentum array of the second daughter track
@@ -1864,7 +2064,49 @@ struct HfTrackIndexSkimCreator {
     return isSelected;
   }
 
+  /// Finds the soft-pion candidates which can form a D* with a D0 candidate
+  /// For a D0 of mass m, energy E and momentum P, a mass difference below deltaMassMaxDstar requires E E_pi - P p_pi <= k,
+  /// with k = ((m + deltaMassMaxDstar)^2 - m^2 - m_pi^2) / 2, which bounds the momentum of the soft pion to
+  /// (k P -+ E sqrt(k^2 - m^2 m_pi^2)) / m^2, so that only the soft pions in this range are tested with isDstarSelected.
+  /// \param softPions soft-pion candidates of the collision with the charge of the D* meson, sorted by momentum
+  /// \param pVecPion momentum of the pion of the D0 candidate
+  /// \param pVecKaon momentum of the kaon of the D0 candidate
+  /// \param iTrackExcluded position of the pion of the D0 candidate, not used as soft pion
+  /// \param useWindow if false, all the soft-pion candidates are returned
+  /// 
+ote the candidates are returned in softPionsInWindow, in the order of the tracks of the collision
+  void findSoftPionsInWindow(std::vector<SoftPionCand> const& softPions, std::array<float, 3> const& pVecPion, std::array<float, 3> const& pVecKaon, int iTrackExcluded, bool useWindow)
+  {
+    softPionsInWindow.clear();
+    auto softPionFirst = softPions.begin();
+    auto softPionLast = softPions.end();
+    if (useWindow) {
+      constexpr double kRelMargin = 1.e-3; // relative margin on the momentum bounds, against rounding in the single-precision momenta
+      const double invMassD0 = RecoDecay::m(std::array{pVecPion, pVecKaon}, std::array{massPi, massK});
+      const double pD0 = RecoDecay::p(RecoDecay::pVec(pVecPion, pVecKaon));
+      const double eD0 = RecoDecay::e(pD0, invMassD0);
+      const double k = 0.5 * ((invMassD0 + deltaMassMaxDstar) * (invMassD0 + deltaMassMaxDstar) - invMassD0 * invMassD0 - massPi * massPi);
+      const double kMin = invMassD0 * massPi; // value of E E_pi - P p_pi for a soft pion at rest in the D0 frame
+      if (k < kMin) {
+        return;
+      }
+      const double halfWidth = eD0 * std::sqrt(k * k - kMin * kMin);
+      const double pMin = (k * pD0 - halfWidth) / (invMassD0 * invMassD0) * (1. - kRelMargin) - kPtBoundMargin;
+      const double pMax = (k * pD0 + halfWidth) / (invMassD0 * invMassD0) * (1. + kRelMargin) + kPtBoundMargin;
+      softPionFirst = std::lower_bound(softPions.begin(), softPions.end(), pMin, [](const SoftPionCand& softPion, double value) { return softPion.p < value; });
+      softPionLast = std::upper_bound(softPionFirst, softPions.end(), pMax, [](double value, const SoftPionCand& softPion) { return value < softPion.p; });
+    }
+    for (auto softPion = softPionFirst; softPion != softPionLast; ++softPion) {
+      if (softPion->iTrack != iTrackExcluded) {
+        softPionsInWindow.push_back(*softPion);
+      }
+    }
+    std::sort(softPionsInWindow.begin(), softPionsInWindow.end(), [](const SoftPionCand& a, const SoftPionCand& b) { return a.iTrack < b.iTrack; });
+  }
+
   /// Method for the PV refit excluding the candidate daughters
+  /// The vertexer is prepared once per collision with all its PV contributors, then each refit only flags the excluded tracks.
+  /// The refits are cached per collision by set of excluded contributors, since the same subsets recur among 2-prong, 3-prong and D* candidates
   /// \param collision is a collision
   /// \param bcWithTimeStamps is a table of bunch crossing joined with timestamps used to query the CCDB for B and material budget
   /// \param vecPvContributorGlobId is a vector containing the global ID of PV contributors for the current collision
@@ -1874,64 +2116,102 @@ struct HfTrackIndexSkimCreator {
   /// \param pvCovMatrix is a vector where to store the covariance matrix values of refitted PV
   void performPvRefitCandProngs(SelectedCollisions::iterator const& collision,
                                 aod::BCsWithTimestamps const& bcWithTimeStamps,
-                                std::vector<int64_t> vecPvContributorGlobId,
-                                std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov,
-                                std::vector<int64_t> vecCandPvContributorGlobId,
+                                std::vector<int64_t> const& vecPvContributorGlobId,
+                                std::vector<o2::track::TrackParCov> const& vecPvContributorTrackParCov,
+                                std::vector<int64_t> const& vecCandPvContributorGlobId,
                                 std::array<float, 3>& pvCoord,
                                 std::array<float, 6>& pvCovMatrix)
   {
-    std::vector<bool> vecPvRefitContributorUsed(vecPvContributorGlobId.size(), true);
-
-    /// Prepare the vertex refitting
-    // set the magnetic field from CCDB
-    auto bc = collision.bc_as<o2::aod::BCsWithTimestamps>();
-    initCCDB(bc, runNumber, ccdb, isRun2 ? ccdbPathGrp : ccdbPathGrpMag, lut, isRun2);
+    /// Prepare the vertex refitting, once per collision
+    if (pvRefitCollisionId != collision.globalIndex()) {
+      // set the magnetic field from CCDB
+      auto bc = collision.bc_as<o2::aod::BCsWithTimestamps>();
+      initCCDB(bc, runNumber, ccdb, isRun2 ? ccdbPathGrp : ccdbPathGrpMag, lut, isRun2);
 
-    // build the VertexBase to initialize the vertexer
-    o2::dataformats::VertexBase primVtx;
-    primVtx.setX(collision.posX());
-    primVtx.setY(collision.posY());
-    primVtx.setZ(collision.posZ());
-    primVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-    // configure PVertexer
-    o2::vertexing::PVertexer vertexer;
-    o2::conf::ConfigurableParam::updateFromString("pvertexer.useMeanVertexConstraint=false"); /// remove diamond constraint (let's keep it at the moment...)
-    vertexer.init();
-    bool pvRefitDoable = vertexer.prepareVertexRefit(vecPvContributorTrackParCov, primVtx);
+      // build the VertexBase to initialize the vertexer
+      pvRefitPrimVtx.setX(collision.posX());
+      pvRefitPrimVtx.setY(collision.posY());
+      pvRefitPrimVtx.setZ(collision.posZ());
+      pvRefitPrimVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+      // configure PVertexer
+      o2::conf::ConfigurableParam::updateFromString("pvertexer.useMeanVertexConstraint=false"); /// remove diamond constraint (let's keep it at the moment...)
+      pvRefitVertexer.init();
+      pvRefitDoable = pvRefitVertexer.prepareVertexRefit(vecPvContributorTrackParCov, pvRefitPrimVtx);
+      if (!pvRefitDoable) {
+        LOG(info) << "Not enough tracks accepted for the refit";
+      }
+      if (debugPvRefit) {
+        LOG(info) << "prepareVertexRefit = " << pvRefitDoable << " Ncontrib= " << vecPvContributorTrackParCov.size() << " Ntracks= " << collision.numContrib() << " Vtx= " << pvRefitPrimVtx.asString();
+      }
+      pvRefitContributorUsed.assign(vecPvContributorGlobId.size(), true);
+      pvRefitCache.clear();
+      pvRefitCacheIndex.clear();
+      pvRefitCollisionId = collision.globalIndex();
+    }
+    const auto& primVtx = pvRefitPrimVtx;
     if (!pvRefitDoable) {
-      LOG(info) << "Not enough tracks accepted for the refit";
       if (doprocess2And3ProngsWithPvRefit && fillHistograms) {
         registry.fill(HIST("PvRefit/hNContribPvRefitNotDoable"), collision.numContrib());
       }
-    }
-    if (debugPvRefit) {
-      LOG(info) << "prepareVertexRefit = " << pvRefitDoable << " Ncontrib= " << vecPvContributorTrackParCov.size() << " Ntracks= " << collision.numContrib() << " Vtx= " << primVtx.asString();
+      return;
     }
 
     /// PV refitting, if the tracks contributed to this at the beginning
     o2::dataformats::VertexBase primVtxBaseRecalc;
     bool recalcPvRefit = false;
-    if (doprocess2And3ProngsWithPvRefit && pvRefitDoable) {
+    if (doprocess2And3ProngsWithPvRefit) {
       if (fillHistograms) {
         registry.fill(HIST("PvRefit/verticesPerCandidate"), 2);
       }
       recalcPvRefit = true;
       int nCandContr = 0;
+      PvRefitKey excludedEntries;
+      excludedEntries.fill(-1);
       for (uint64_t myGlobalID : vecCandPvContributorGlobId) {
         auto trackIterator = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), myGlobalID); /// track global index
-        if (trackIterator != vecPvContributorGlobId.end()) {
+        if (trackIterator != vecPvContributorGlobId.end() && nCandContr < static_cast<int>(excludedEntries.size())) {
           /// this is a contributor, let's remove it for the PV refit
-          const int entry = std::distance(vecPvContributorGlobId.begin(), trackIterator);
-          vecPvRefitContributorUsed[entry] = false; /// remove the track from the PV refitting
+          excludedEntries[nCandContr] = std::distance(vecPvContributorGlobId.begin(), trackIterator);
           nCandContr++;
         }
       }
+      std::sort(excludedEntries.begin(), excludedEntries.end());
 
-      /// do the PV refit excluding the candidate daughters that originally contributed to fit it
-      if (debugPvRefit) {
-        LOG(info) << "### PV refit after removing " << nCandContr << " tracks";
+      /// do the PV refit excluding the candidate daughters that originally contributed to fit it, unless it is cached
+      auto itCache = pvRefitCacheIndex.find(excludedEntries);
+      const bool isCached = (itCache != pvRefitCacheIndex.end());
+      if (isCached) {
+        pvRefitCache.splice(pvRefitCache.begin(), pvRefitCache, itCache->second); // most recently used first
+      } else {
+        if (debugPvRefit) {
+          LOG(info) << "### PV refit after removing " << nCandContr << " tracks";
+        }
+        for (const auto& entry : excludedEntries) {
+          if (entry >= 0) {
+            pvRefitContributorUsed[entry] = false; /// remove the track from the PV refitting
+          }
+        }
+        auto primVtxRefitted = pvRefitVertexer.refitVertex(pvRefitContributorUsed, primVtx); // vertex refit
+        for (const auto& entry : excludedEntries) {
+          if (entry >= 0) {
+            pvRefitContributorUsed[entry] = true; /// restore the tracks for the next PV refitting
+          }
+        }
+        pvRefitCache.emplace_front(excludedEntries, primVtxRefitted);
+        if (pvRefitCacheSize > 0) {
+          pvRefitCacheIndex[excludedEntries] = pvRefitCache.begin();
+          if (static_cast<int>(pvRefitCache.size()) > pvRefitCacheSize) {
+            pvRefitCacheIndex.erase(pvRefitCache.back().first);
+            pvRefitCache.pop_back();
+          }
+        } else if (pvRefitCache.size() > 1) {
+          pvRefitCache.pop_back();
+        }
       }
-      auto primVtxRefitted = vertexer.refitVertex(vecPvRefitContributorUsed, primVtx); // vertex refit
+      if (fillHistograms) {
+        registry.fill(HIST("PvRefit/hCacheRefits"), isCached ? 2 : 1);
+      }
+      const auto& primVtxRefitted = pvRefitCache.front().second;
       // LOG(info) << "refit " << cnt << "/" << ntr << " result = " << primVtxRefitted.asString();
       // LOG(info) << "refit for track with global index " << static_cast<int>(myTrack.globalIndex()) << " " << primVtxRefitted.asString();
       if (primVtxRefitted.getChi2() < 0) {
@@ -1953,10 +2233,6 @@ struct HfTrackIndexSkimCreator {
         registry.fill(HIST("PvRefit/hChi2vsNContrib"), primVtxRefitted.getNContributors(), primVtxRefitted.getChi2());
       }
 
-      for (size_t i = 0; i < vecPvContributorGlobId.size(); i++) {
-        vecPvRefitContributorUsed[i] = true; /// restore the tracks for the next PV refitting (probably not necessary here)
-      }
-
       if (recalcPvRefit) {
         // fill the histograms for refitted PV with good Chi2
         const double deltaX = primVtx.getX() - primVtxRefitted.getX();
@@ -1995,17 +2271,153 @@ struct HfTrackIndexSkimCreator {
 
       // cnt++;
 
-    } /// end 'if (doprocess2And3ProngsWithPvRefit && pvRefitDoable)'
+    } /// end 'if (doprocess2And3ProngsWithPvRefit)'
 
     return;
   } /// end of performPvRefitCandProngs function
 
+  /// Method to configure a secondary-vertex fitter
+  /// \param df is the vertex fitter
+  template <int N>
+  void configureFitter(o2::vertexing::DCAFitterN<N>& df)
+  {
+    df.setBz(o2::base::Propagator::Instance()->getNominalBz());
+    df.setPropagateToPCA(propagateToPCA);
+    df.setMaxR(maxR);
+    df.setMaxDZIni(maxDZIni);
+    df.setMinParamChange(minParamChange);
+    df.setMinRelChi2Change(minRelChi2Change);
+    df.setUseAbsDCA(useAbsDCA);
+    df.setWeightedFinalPCA(useWeightedFinalPCA);
+  }
+
+  /// Method to list, in the order of the candidate loop of run2And3Prongs, the track combinations which reach the secondary-vertex fit
+  /// \note it must apply the same selections as the candidate loop before the fits
+  /// \param groupedTrackIndices are the selected track indices of the collision
+  /// \param ptMaxPos3Prong is the largest pT of the positive tracks selected for 3-prongs
+  /// \param ptMaxNeg3Prong is the largest pT of the negative tracks selected for 3-prongs
+  /// \param doPrePairing is the flag to skip the combinations which cannot pass the pT and impact-parameter preselections
+  template <typename TTracks, typename TTrackIndices>
+  void listVertexFits(TTrackIndices const& groupedTrackIndices, float ptMaxPos3Prong, float ptMaxNeg3Prong, bool doPrePairing)
+  {
+    int n2ProngBit = BIT(kN2ProngDecays) - 1;
+    int n3ProngBit = BIT(kN3ProngDecays) - 1;
+    std::array<std::vector<bool>, kN2ProngDecays> cutStatus2Prong;
+    std::array<std::vector<bool>, kN3ProngDecays> cutStatus3Prong;
+    for (int iDecay2P = 0; iDecay2P < kN2ProngDecays; iDecay2P++) {
+      cutStatus2Prong[iDecay2P] = std::vector<bool>(kNCuts2Prong[iDecay2P], true);
+    }
+    for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
+      cutStatus3Prong[iDecay3P] = std::vector<bool>(kNCuts3Prong[iDecay3P], true);
+    }
+    int whichHypo2Prong[kN2ProngDecays];
+    int whichHypo3Prong[kN3ProngDecays];
+
+    vertexFits2Prong.clear();
+    vertexFits3Prong.clear();
+    int counterTrackPos1{0};
+    for (auto trackIndexPos1 = groupedTrackIndices.begin(); trackIndexPos1 != groupedTrackIndices.end(); ++trackIndexPos1) {
+      counterTrackPos1++;
+      const int iTrackPos1 = counterTrackPos1 - 1;
+      auto trackPos1 = trackIndexPos1.template track_as<TTracks>();
+      if (trackPos1.signed1Pt() < 0) {
+        continue;
+      }
+      auto isSelProngPos1 = trackIndexPos1.isSelProng();
+      bool sel2ProngStatusPos = TESTBIT(isSelProngPos1, CandidateType::Cand2Prong);
+      bool sel3ProngStatusPos1 = TESTBIT(isSelProngPos1, CandidateType::Cand3Prong);
+      if (!sel2ProngStatusPos && !sel3ProngStatusPos1) {
+        continue;
+      }
+
+      int counterTrackNeg1{0};
+      for (auto trackIndexNeg1 = groupedTrackIndices.begin(); trackIndexNeg1 != groupedTrackIndices.end(); ++trackIndexNeg1) {
+        counterTrackNeg1++;
+        const int iTrackNeg1 = counterTrackNeg1 - 1;
+        auto trackNeg1 = trackIndexNeg1.template track_as<TTracks>();
+        if (trackNeg1.signed1Pt() > 0) {
+          continue;
+        }
+        auto isSelProngNeg1 = trackIndexNeg1.isSelProng();
+        bool sel2ProngStatusNeg = TESTBIT(isSelProngNeg1, CandidateType::Cand2Prong);
+        bool sel3ProngStatusNeg1 = TESTBIT(isSelProngNeg1, CandidateType::Cand3Prong);
+        if (!sel2ProngStatusNeg && !sel3ProngStatusNeg1) {
+          continue;
+        }
+
+        // 2-prong
+        if (sel2ProngStatusPos && sel2ProngStatusNeg) {
+          int isSelected2ProngCand = n2ProngBit;
+          if (doPrePairing && (!isPtInPreselRange(std::array{ptCache[iTrackPos1], ptCache[iTrackNeg1]}, ptMinPresel2Prong, ptMaxPresel2Prong) || dcaInfoCache[iTrackPos1][0] * dcaInfoCache[iTrackNeg1][0] > d0d0MaxPresel2Prong)) {
+            isSelected2ProngCand = 0;
+          }
+          if (isSelected2ProngCand > 0) {
+            is2ProngPreselected(pVecCache[iTrackPos1], pVecCache[iTrackNeg1], dcaInfoCache[iTrackPos1][0], dcaInfoCache[iTrackNeg1][0], cutStatus2Prong, whichHypo2Prong, isSelected2ProngCand);
+          }
+          if (isSelected2ProngCand > 0) {
+            vertexFits2Prong.tracks.push_back({iTrackPos1, iTrackNeg1});
+          }
+        }
+
+        // 3-prong
+        if (do3Prong == 1) {
+          if (!sel3ProngStatusPos1 || !sel3ProngStatusNeg1) {
+            continue;
+          }
+          double ptSumPair = ptCache[iTrackPos1] + ptCache[iTrackNeg1] + ptTolerance;
+          for (int iSign = 0; iSign < 2; iSign++) { // second positive track, then second negative track
+            const bool isPos = (iSign == 0);
+            if (doPrePairing && ptSumPair + (isPos ? ptMaxPos3Prong : ptMaxNeg3Prong) < ptMinPresel3Prong - kPtBoundMargin) {
+              continue;
+            }
+            const int counterTrack1 = isPos ? counterTrackPos1 : counterTrackNeg1;
+            const int iStartTrack2 = counterTrack1; // index of the first track after the first track of the same sign
+            int counterTrack2{0};
+            for (auto trackIndex2 = groupedTrackIndices.begin() + iStartTrack2; trackIndex2 != groupedTrackIndices.end(); ++trackIndex2) {
+              counterTrack2++;
+              const int iTrack2 = iStartTrack2 + counterTrack2 - 1;
+              auto track2 = trackIndex2.template track_as<TTracks>();
+              if (isPos ? track2.signed1Pt() < 0 : track2.signed1Pt() > 0) {
+                continue;
+              }
+              int isSelected3ProngCand = n3ProngBit;
+              if (do3Prong && TESTBIT(trackIndex2.isSelProng(), CandidateType::Cand3Prong) && (sel3ProngStatusPos1 && sel3ProngStatusNeg1)) {
+                if (doPrePairing && !isPtInPreselRange(std::array{ptCache[iTrackPos1], ptCache[iTrackNeg1], ptCache[iTrack2]}, ptMinPresel3Prong, ptMaxPresel3Prong)) {
+                  continue;
+                }
+                int8_t isProtonTrack1 = isPos ? trackIndexPos1.isProton() : trackIndexNeg1.isProton();
+                int8_t isProtonTrack2 = trackIndex2.isProton();
+                if (isPos) {
+                  is3ProngPreselected(pVecCache[iTrackPos1], pVecCache[iTrackNeg1], pVecCache[iTrack2], isProtonTrack1, isProtonTrack2, cutStatus3Prong, whichHypo3Prong, isSelected3ProngCand);
+                } else {
+                  is3ProngPreselected(pVecCache[iTrackNeg1], pVecCache[iTrackPos1], pVecCache[iTrack2], isProtonTrack1, isProtonTrack2, cutStatus3Prong, whichHypo3Prong, isSelected3ProngCand);
+                }
+              } else {
+                isSelected3ProngCand = 0;
+              }
+              if (!debug && isSelected3ProngCand == 0) {
+                continue;
+              }
+              if (isPos) {
+                vertexFits3Prong.tracks.push_back({iTrackPos1, iTrackNeg1, iTrack2});
+              } else {
+                vertexFits3Prong.tracks.push_back({iTrackNeg1, iTrackPos1, iTrack2});
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
   template <bool doPvRefit = false, typename TTracks>
   void run2And3Prongs(SelectedCollisions const& collisions,
                       aod::BCsWithTimestamps const& bcWithTimeStamps,
                       FilteredTrackAssocSel const& trackIndices,
                       TTracks const& tracks)
   {
+    auto timerSkim = timer.scope(TimerSkim);
+    timer.count(TimerSkim, collisions.size());
 
     // can be added to run over limited collisions per file - for tesing purposes
     /*
@@ -2021,6 +2433,7 @@ struct HfTrackIndexSkimCreator {
     for (const auto& collision : collisions) {
 
       /// retrieve PV contributors for the current collision
+      pvRefitCollisionId = -1; // the PV refit is prepared again for each collision (indices restart in each data frame)
       std::vector<int64_t> vecPvContributorGlobId{};
       std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov{};
       std::vector<bool> vecPvRefitContributorUsed{};
@@ -2081,25 +2494,11 @@ struct HfTrackIndexSkimCreator {
 
       // 2-prong vertex fitter
       o2::vertexing::DCAFitterN<2> df2;
-      df2.setBz(o2::base::Propagator::Instance()->getNominalBz());
-      df2.setPropagateToPCA(propagateToPCA);
-      df2.setMaxR(maxR);
-      df2.setMaxDZIni(maxDZIni);
-      df2.setMinParamChange(minParamChange);
-      df2.setMinRelChi2Change(minRelChi2Change);
-      df2.setUseAbsDCA(useAbsDCA);
-      df2.setWeightedFinalPCA(useWeightedFinalPCA);
+      configureFitter(df2);
 
       // 3-prong vertex fitter
       o2::vertexing::DCAFitterN<3> df3;
-      df3.setBz(o2::base::Propagator::Instance()->getNominalBz());
-      df3.setPropagateToPCA(propagateToPCA);
-      df3.setMaxR(maxR);
-      df3.setMaxDZIni(maxDZIni);
-      df3.setMinParamChange(minParamChange);
-      df3.setMinRelChi2Change(minRelChi2Change);
-      df3.setUseAbsDCA(useAbsDCA);
-      df3.setWeightedFinalPCA(useWeightedFinalPCA);
+      configureFitter(df3);
 
       // used to calculate number of candidiates per event
       auto nCand2 = rowTrackIndexProng2.lastIndex();
@@ -2115,6 +2514,72 @@ struct HfTrackIndexSkimCreator {
 
       auto thisCollId = collision.globalIndex();
       auto groupedTrackIndices = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
+
+      // propagate the selected tracks to this collision once, instead of in each combination
+      trackParCache.clear();
+      pVecCache.clear();
+      dcaInfoCache.clear();
+      ptCache.clear();
+      softPionsPos.clear();
+      softPionsNeg.clear();
+      float ptMaxPos3Prong{-1.f}; // largest pT of the positive tracks selected for 3-prongs
+      float ptMaxNeg3Prong{-1.f}; // largest pT of the negative tracks selected for 3-prongs
+      for (const auto& trackIndex : groupedTrackIndices) {
+        auto track = trackIndex.template track_as<TTracks>();
+        auto& trackParVar = trackParCache.emplace_back(getTrackParCov(track));
+        auto& pVecTrack = pVecCache.emplace_back(std::array<float, 3>{track.px(), track.py(), track.pz()});
+        auto& dcaInfo = dcaInfoCache.emplace_back(o2::gpu::gpustd::array<float, 2>{track.dcaXY(), track.dcaZ()});
+        if (thisCollId != track.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
+          o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVar, 2.f, noMatCorr, &dcaInfo);
+          getPxPyPz(trackParVar, pVecTrack);
+        }
+        float ptTrack = ptCache.emplace_back(RecoDecay::pt(pVecTrack));
+        if (TESTBIT(trackIndex.isSelProng(), CandidateType::Cand3Prong)) {
+          if (track.signed1Pt() >= 0) {
+            ptMaxPos3Prong = std::max(ptMaxPos3Prong, ptTrack);
+          }
+          if (track.signed1Pt() <= 0) {
+            ptMaxNeg3Prong = std::max(ptMaxNeg3Prong, ptTrack);
+          }
+        }
+        if (doDstar && TESTBIT(trackIndex.isSelProng(), CandidateType::CandDstar)) {
+          SoftPionCand softPion{static_cast<float>(RecoDecay::p(pVecTrack)), static_cast<int>(pVecCache.size()) - 1, track.globalIndex()};
+          if (track.signed1Pt() >= 0) {
+            softPionsPos.push_back(softPion);
+          }
+          if (track.signed1Pt() <= 0) {
+            softPionsNeg.push_back(softPion);
+          }
+        }
+      }
+      if (doDstar) {
+        auto byMomentum = [](const SoftPionCand& a, const SoftPionCand& b) { return a.p < b.p; };
+        std::sort(softPionsPos.begin(), softPionsPos.end(), byMomentum);
+        std::sort(softPionsNeg.begin(), softPionsNeg.end(), byMomentum);
+      }
+      // numbers of track combinations tested and skipped before the preselections, see hPrePairing
+      std::array<float, 7> nPrePairing{};
+      // pruning is disabled in debug mode, where the outcome of each preselection is stored
+      bool doPrePairing = usePrePairing && !debug;
+
+      // in parallel mode, the secondary vertices of the combinations reaching the fits are computed here by the workers,
+      // and the candidate loop reads them back in the same order
+      vertexFits2Prong.isParallel = (nThreadsVertexing > 1);
+      vertexFits3Prong.isParallel = (nThreadsVertexing > 1);
+      if (nThreadsVertexing > 1) {
+        fittersWorkers2Prong.resize(nThreadsVertexing);
+        fittersWorkers3Prong.resize(nThreadsVertexing);
+        for (int iWorker = 0; iWorker < nThreadsVertexing; iWorker++) {
+          configureFitter(fittersWorkers2Prong[iWorker]);
+          configureFitter(fittersWorkers3Prong[iWorker]);
+        }
+        listVertexFits<TTracks>(groupedTrackIndices, ptMaxPos3Prong, ptMaxNeg3Prong, doPrePairing);
+        auto timerFits = timer.scope(TimerParallelFits);
+        timer.count(TimerParallelFits, vertexFits2Prong.tracks.size() + vertexFits3Prong.tracks.size());
+        vertexFits2Prong.fitAll(fittersWorkers2Prong, trackParCache);
+        vertexFits3Prong.fitAll(fittersWorkers3Prong, trackParCache);
+      }
+
       int lastFilledD0 = -1; // index to be filled in table for D* mesons
       int counterTrackPos1{0};
       for (auto trackIndexPos1 = groupedTrackIndices.begin(); trackIndexPos1 != groupedTrackIndices.end(); ++trackIndexPos1) {
@@ -2133,13 +2598,9 @@ struct HfTrackIndexSkimCreator {
           continue;
         }
 
-        auto trackParVarPos1 = getTrackParCov(trackPos1);
-        std::array<float, 3> pVecTrackPos1{trackPos1.px(), trackPos1.py(), trackPos1.pz()};
-        o2::gpu::gpustd::array<float, 2> dcaInfoPos1{trackPos1.dcaXY(), trackPos1.dcaZ()};
-        if (thisCollId != trackPos1.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos1, 2.f, noMatCorr, &dcaInfoPos1);
-          getPxPyPz(trackParVarPos1, pVecTrackPos1);
-        }
+        const int iTrackPos1 = counterTrackPos1 - 1;
+        const auto& pVecTrackPos1 = pVecCache[iTrackPos1];
+        const auto& dcaInfoPos1 = dcaInfoCache[iTrackPos1];
 
         // first loop over negative tracks
         // for (auto trackNeg1 = tracksNeg.begin(); trackNeg1 != tracksNeg.end(); ++trackNeg1) {
@@ -2159,13 +2620,9 @@ struct HfTrackIndexSkimCreator {
             continue;
           }
 
-          auto trackParVarNeg1 = getTrackParCov(trackNeg1);
-          std::array<float, 3> pVecTrackNeg1{trackNeg1.px(), trackNeg1.py(), trackNeg1.pz()};
-          o2::gpu::gpustd::array<float, 2> dcaInfoNeg1{trackNeg1.dcaXY(), trackNeg1.dcaZ()};
-          if (thisCollId != trackNeg1.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg1, 2.f, noMatCorr, &dcaInfoNeg1);
-            getPxPyPz(trackParVarNeg1, pVecTrackNeg1);
-          }
+          const int iTrackNeg1 = counterTrackNeg1 - 1;
+          const auto& pVecTrackNeg1 = pVecCache[iTrackNeg1];
+          const auto& dcaInfoNeg1 = dcaInfoCache[iTrackNeg1];
 
           int isSelected2ProngCand = n2ProngBit; // bitmap for checking status of two-prong candidates (1 is true, 0 is rejected)
 
@@ -2184,19 +2641,33 @@ struct HfTrackIndexSkimCreator {
           // 2-prong vertex reconstruction
           if (sel2ProngStatusPos && sel2ProngStatusNeg) {
 
+            // skip the pairs which cannot pass the preselections of any decay channel:
+            // the pT of the pair is within the sum and the difference of the pT of the tracks
+            nPrePairing[0]++;
+            if (doPrePairing) {
+              if (!isPtInPreselRange(std::array{ptCache[iTrackPos1], ptCache[iTrackNeg1]}, ptMinPresel2Prong, ptMaxPresel2Prong)) {
+                nPrePairing[1]++;
+                isSelected2ProngCand = 0;
+              } else if (dcaInfoPos1[0] * dcaInfoNeg1[0] > d0d0MaxPresel2Prong) {
+                nPrePairing[2]++;
+                isSelected2ProngCand = 0;
+              }
+            }
+
             // 2-prong preselections
             // TODO: in case of PV refit, the single-track DCA is calculated wrt two different PV vertices (only 1 track excluded)
-            is2ProngPreselected(pVecTrackPos1, pVecTrackNeg1, dcaInfoPos1[0], dcaInfoNeg1[0], cutStatus2Prong, whichHypo2Prong, isSelected2ProngCand);
+            if (isSelected2ProngCand > 0) {
+              is2ProngPreselected(pVecTrackPos1, pVecTrackNeg1, dcaInfoPos1[0], dcaInfoNeg1[0], cutStatus2Prong, whichHypo2Prong, isSelected2ProngCand);
+            }
 
             // secondary vertex reconstruction and further 2-prong selections
-            if (isSelected2ProngCand > 0 && df2.process(trackParVarPos1, trackParVarNeg1) > 0) { // should it be this or > 0 or are they equivalent
+            const auto* fit2Prong = (isSelected2ProngCand > 0) ? &vertexFits2Prong.get(df2, trackParCache, {iTrackPos1, iTrackNeg1}) : nullptr;
+            if (fit2Prong && fit2Prong->isFitted) {
               // get secondary vertex
-              const auto& secondaryVertex2 = df2.getPCACandidate();
+              const auto& secondaryVertex2 = fit2Prong->secondaryVertex;
               // get track momenta
-              std::array<float, 3> pvec0;
-              std::array<float, 3> pvec1;
-              df2.getTrack(0).getPxPyPzGlo(pvec0);
-              df2.getTrack(1).getPxPyPzGlo(pvec1);
+              const auto& pvec0 = fit2Prong->pVec[0];
+              const auto& pvec1 = fit2Prong->pVec[1];
 
               /// PV refit excluding the candidate daughters, if contributors
               if constexpr (doPvRefit) {
@@ -2333,66 +2804,81 @@ struct HfTrackIndexSkimCreator {
             isSelected2ProngCand = 0; // reset to 0 not to use the D0 to build a D* meson
           }
 
-          // 3-prong vertex and D* reconstruction
-          if (do3Prong == 1 || doDstar) {
-            if (!doDstar && (!sel3ProngStatusPos1 || !sel3ProngStatusNeg1)) {
+          // D* reconstruction, testing only the soft pions in the momentum window allowed by the D0 kinematics (all of them in debug mode)
+          if (doDstar && TESTBIT(isSelected2ProngCand, hf_cand_2prong::DecayType::D0ToPiK)) {
+            for (int iHypo = 0; iHypo < 2; iHypo++) { // D*+ with a positive soft pion if compatible with a D0, then D*- with a negative soft pion if compatible with a D0bar
+              if (!TESTBIT(whichHypo2Prong[0], iHypo)) {
+                continue;
+              }
+              const bool isDstarPlus = (iHypo == 0);
+              const auto& pVecPionD0 = isDstarPlus ? pVecTrackPos1 : pVecTrackNeg1;
+              const auto& pVecKaonD0 = isDstarPlus ? pVecTrackNeg1 : pVecTrackPos1;
+              findSoftPionsInWindow(isDstarPlus ? softPionsPos : softPionsNeg, pVecPionD0, pVecKaonD0, isDstarPlus ? iTrackPos1 : iTrackNeg1, !debug);
+              for (const auto& softPion : softPionsInWindow) {
+                uint8_t cutStatus{BIT(kNCutsDstar) - 1};
+                float deltaMass{-1.};
+                uint8_t isSelectedDstar = isDstarSelected(pVecPionD0, pVecKaonD0, pVecCache[softPion.iTrack], cutStatus, deltaMass); // we do not compute the D* decay vertex at this stage because we are not interested in applying topological selections
+                if (isSelectedDstar) {
+                  rowTrackIndexDstar(thisCollId, softPion.globalIndex, lastFilledD0);
+                  if (fillHistograms) {
+                    registry.fill(HIST("hMassDstarToD0Pi"), deltaMass);
+                  }
+                  if constexpr (doPvRefit) {
+                    // fill table row with coordinates of PV refit (same as 2-prong because we do not remove the soft pion)
+                    rowDstarPVrefit(pvRefitCoord2Prong[0], pvRefitCoord2Prong[1], pvRefitCoord2Prong[2],
+                                    pvRefitCovMatrix2Prong[0], pvRefitCovMatrix2Prong[1], pvRefitCovMatrix2Prong[2], pvRefitCovMatrix2Prong[3], pvRefitCovMatrix2Prong[4], pvRefitCovMatrix2Prong[5]);
+                  }
+                }
+                if (debug) {
+                  rowDstarCutStatus(cutStatus);
+                }
+              }
+            }
+          } // end of D*
+
+          // 3-prong vertex reconstruction
+          if (do3Prong == 1) {
+            if (!sel3ProngStatusPos1 || !sel3ProngStatusNeg1) {
               continue;
             }
 
+            // skip the loops over the third track if even the largest pT of a third track cannot give a 3-prong within the pT bins
+            bool skipLoopPos2{false};
+            bool skipLoopNeg2{false};
+            nPrePairing[3] += 2;
+            if (doPrePairing) {
+              double ptSumPair = ptCache[iTrackPos1] + ptCache[iTrackNeg1] + ptTolerance;
+              skipLoopPos2 = (ptSumPair + ptMaxPos3Prong < ptMinPresel3Prong - kPtBoundMargin);
+              skipLoopNeg2 = (ptSumPair + ptMaxNeg3Prong < ptMinPresel3Prong - kPtBoundMargin);
+              nPrePairing[4] += static_cast<int>(skipLoopPos2) + static_cast<int>(skipLoopNeg2);
+            }
+
             // second loop over positive tracks
             // for (auto trackPos2 = trackPos1 + 1; trackPos2 != tracksPos.end(); ++trackPos2) {
             int counterTrackPos2{0};
-            auto startTrackIndexPos2 = (doDstar) ? groupedTrackIndices.begin() : trackIndexPos1 + 1;
+            auto startTrackIndexPos2 = trackIndexPos1 + 1;
+            const int iStartTrackPos2 = iTrackPos1 + 1;
             for (auto trackIndexPos2 = startTrackIndexPos2; trackIndexPos2 != groupedTrackIndices.end(); ++trackIndexPos2) {
+              if (skipLoopPos2) {
+                break;
+              }
               counterTrackPos2++;
+              const int iTrackPos2 = iStartTrackPos2 + counterTrackPos2 - 1;
               auto trackPos2 = trackIndexPos2.template track_as<TTracks>();
               if (trackPos2.signed1Pt() < 0) {
                 continue;
               }
-              auto trackParVarPos2 = getTrackParCov(trackPos2);
-              std::array<float, 3> pVecTrackPos2{trackPos2.px(), trackPos2.py(), trackPos2.pz()};
-              o2::gpu::gpustd::array<float, 2> dcaInfoPos2{trackPos2.dcaXY(), trackPos2.dcaZ()};
-              bool propagatedPos2{false};
-
-              // first we build D*+ candidates if enabled
-              auto isSelProngPos2 = trackIndexPos2.isSelProng();
-              uint8_t isSelectedDstar{0};
-              if (doDstar && TESTBIT(isSelected2ProngCand, hf_cand_2prong::DecayType::D0ToPiK) && TESTBIT(whichHypo2Prong[0], 0)) { // the 2-prong decay is compatible with a D0
-                if (TESTBIT(isSelProngPos2, CandidateType::CandDstar) && trackPos2.globalIndex() != trackPos1.globalIndex()) {      // compatible with a soft pion
-                  if (thisCollId != trackPos2.collisionId()) {                                                                      // this is not the "default" collision for this track, we have to re-propagate it
-                    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos2, 2.f, noMatCorr, &dcaInfoPos2);
-                    getPxPyPz(trackParVarPos2, pVecTrackPos2);
-                    propagatedPos2 = true;
-                  }
-                  uint8_t cutStatus{BIT(kNCutsDstar) - 1};
-                  float deltaMass{-1.};
-                  isSelectedDstar = isDstarSelected(pVecTrackPos1, pVecTrackNeg1, pVecTrackPos2, cutStatus, deltaMass); // we do not compute the D* decay vertex at this stage because we are not interested in applying topological selections
-                  if (isSelectedDstar) {
-                    rowTrackIndexDstar(thisCollId, trackPos2.globalIndex(), lastFilledD0);
-                    if (fillHistograms) {
-                      registry.fill(HIST("hMassDstarToD0Pi"), deltaMass);
-                    }
-                    if constexpr (doPvRefit) {
-                      // fill table row with coordinates of PV refit (same as 2-prong because we do not remove the soft pion)
-                      rowDstarPVrefit(pvRefitCoord2Prong[0], pvRefitCoord2Prong[1], pvRefitCoord2Prong[2],
-                                      pvRefitCovMatrix2Prong[0], pvRefitCovMatrix2Prong[1], pvRefitCovMatrix2Prong[2], pvRefitCovMatrix2Prong[3], pvRefitCovMatrix2Prong[4], pvRefitCovMatrix2Prong[5]);
-                    }
-                  }
-                  if (debug) {
-                    rowDstarCutStatus(cutStatus);
-                  }
-                }
-              } // end of D*
+              const auto& pVecTrackPos2 = pVecCache[iTrackPos2];
 
               // preselection of 3-prong candidates
-              if (doDstar && counterTrackPos2 < counterTrackPos1 + 1) { // we avoid duplication for 3-prongs
-                continue;
-              }
+              auto isSelProngPos2 = trackIndexPos2.isSelProng();
               int isSelected3ProngCand = n3ProngBit;
               if (do3Prong && TESTBIT(isSelProngPos2, CandidateType::Cand3Prong) && (sel3ProngStatusPos1 && sel3ProngStatusNeg1)) {
-                if (thisCollId != trackPos2.collisionId() && !propagatedPos2) { // this is not the "default" collision for this track and we still did not re-propagate it, we have to re-propagate it
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos2, 2.f, noMatCorr, &dcaInfoPos2);
-                  getPxPyPz(trackParVarPos2, pVecTrackPos2);
+                // skip the triplets which cannot pass the pT preselections of any decay channel
+                nPrePairing[5]++;
+                if (doPrePairing && !isPtInPreselRange(std::array{ptCache[iTrackPos1], ptCache[iTrackNeg1], ptCache[iTrackPos2]}, ptMinPresel3Prong, ptMaxPresel3Prong)) {
+                  nPrePairing[6]++;
+                  continue;
                 }
 
                 if (debug) {
@@ -2509,18 +2995,16 @@ struct HfTrackIndexSkimCreator {
               }
 
               // reconstruct the 3-prong secondary vertex
-              if (df3.process(trackParVarPos1, trackParVarNeg1, trackParVarPos2) == 0) {
+              const auto& fit3Prong = vertexFits3Prong.get(df3, trackParCache, {iTrackPos1, iTrackNeg1, iTrackPos2});
+              if (!fit3Prong.isFitted) {
                 continue;
               }
               // get secondary vertex
-              const auto& secondaryVertex3 = df3.getPCACandidate();
+              const auto& secondaryVertex3 = fit3Prong.secondaryVertex;
               // get track momenta
-              std::array<float, 3> pvec0;
-              std::array<float, 3> pvec1;
-              std::array<float, 3> pvec2;
-              df3.getTrack(0).getPxPyPzGlo(pvec0);
-              df3.getTrack(1).getPxPyPzGlo(pvec1);
-              df3.getTrack(2).getPxPyPzGlo(pvec2);
+              const auto& pvec0 = fit3Prong.pVec[0];
+              const auto& pvec1 = fit3Prong.pVec[1];
+              const auto& pvec2 = fit3Prong.pVec[2];
               auto pVecCandProng3Pos = RecoDecay::pVec(pvec0, pvec1, pvec2);
 
               // 3-prong selections after secondary vertex
@@ -2597,58 +3081,30 @@ struct HfTrackIndexSkimCreator {
             // second loop over negative tracks
             // for (auto trackNeg2 = trackNeg1 + 1; trackNeg2 != tracksNeg.end(); ++trackNeg2) {
             int counterTrackNeg2{0};
-            auto startTrackIndexNeg2 = (doDstar) ? groupedTrackIndices.begin() : trackIndexNeg1 + 1;
+            auto startTrackIndexNeg2 = trackIndexNeg1 + 1;
+            const int iStartTrackNeg2 = iTrackNeg1 + 1;
             for (auto trackIndexNeg2 = startTrackIndexNeg2; trackIndexNeg2 != groupedTrackIndices.end(); ++trackIndexNeg2) {
+              if (skipLoopNeg2) {
+                break;
+              }
               counterTrackNeg2++;
+              const int iTrackNeg2 = iStartTrackNeg2 + counterTrackNeg2 - 1;
               auto trackNeg2 = trackIndexNeg2.template track_as<TTracks>();
               if (trackNeg2.signed1Pt() > 0) {
                 continue;
               }
 
-              auto trackParVarNeg2 = getTrackParCov(trackNeg2);
-              std::array<float, 3> pVecTrackNeg2{trackNeg2.px(), trackNeg2.py(), trackNeg2.pz()};
-              o2::gpu::gpustd::array<float, 2> dcaInfoNeg2{trackNeg2.dcaXY(), trackNeg2.dcaZ()};
-              bool propagatedNeg2{false};
-
-              // first we build D*+ candidates if enabled
-              auto isSelProngNeg2 = trackIndexNeg2.isSelProng();
-              uint8_t isSelectedDstar{0};
-              if (doDstar && TESTBIT(isSelected2ProngCand, hf_cand_2prong::DecayType::D0ToPiK) && TESTBIT(whichHypo2Prong[0], 1)) { // the 2-prong decay is compatible with a D0bar
-                if (TESTBIT(isSelProngNeg2, CandidateType::CandDstar) && trackNeg2.globalIndex() != trackNeg1.globalIndex()) {      // compatible with a soft pion
-                  if (thisCollId != trackNeg2.collisionId()) {                                                                      // this is not the "default" collision for this track, we have to re-propagate it
-                    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg2, 2.f, noMatCorr, &dcaInfoNeg2);
-                    getPxPyPz(trackParVarNeg2, pVecTrackNeg2);
-                    propagatedNeg2 = true;
-                  }
-                  uint8_t cutStatus{BIT(kNCutsDstar) - 1};
-                  float deltaMass{-1.};
-                  isSelectedDstar = isDstarSelected(pVecTrackNeg1, pVecTrackPos1, pVecTrackNeg2, cutStatus, deltaMass); // we do not compute the D* decay vertex at this stage because we are not interested in applying topological selections
-                  if (isSelectedDstar) {
-                    rowTrackIndexDstar(thisCollId, trackNeg2.globalIndex(), lastFilledD0);
-                    if (fillHistograms) {
-                      registry.fill(HIST("hMassDstarToD0Pi"), deltaMass);
-                    }
-                    if constexpr (doPvRefit) {
-                      // fill table row with coordinates of PV refit (same as 2-prong because we do not remove the soft pion)
-                      rowDstarPVrefit(pvRefitCoord2Prong[0], pvRefitCoord2Prong[1], pvRefitCoord2Prong[2],
-                                      pvRefitCovMatrix2Prong[0], pvRefitCovMatrix2Prong[1], pvRefitCovMatrix2Prong[2], pvRefitCovMatrix2Prong[3], pvRefitCovMatrix2Prong[4], pvRefitCovMatrix2Prong[5]);
-                    }
-                  }
-                  if (debug) {
-                    rowDstarCutStatus(cutStatus);
-                  }
-                }
-              } // end of D*
+              const auto& pVecTrackNeg2 = pVecCache[iTrackNeg2];
 
               // preselection of 3-prong candidates
-              if (doDstar && counterTrackNeg2 < counterTrackNeg1 + 1) { // we avoid duplication for 3-prongs
-                continue;
-              }
+              auto isSelProngNeg2 = trackIndexNeg2.isSelProng();
               int isSelected3ProngCand = n3ProngBit;
               if (do3Prong && TESTBIT(isSelProngNeg2, CandidateType::Cand3Prong) && (sel3ProngStatusPos1 && sel3ProngStatusNeg1)) {
-                if (thisCollId != trackNeg2.collisionId() && !propagatedNeg2) { // this is not the "default" collision for this track and we still did not re-propagate it, we have to re-propagate it
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg2, 2.f, noMatCorr, &dcaInfoNeg2);
-                  getPxPyPz(trackParVarNeg2, pVecTrackNeg2);
+                // skip the triplets which cannot pass the pT preselections of any decay channel
+                nPrePairing[5]++;
+                if (doPrePairing && !isPtInPreselRange(std::array{ptCache[iTrackPos1], ptCache[iTrackNeg1], ptCache[iTrackNeg2]}, ptMinPresel3Prong, ptMaxPresel3Prong)) {
+                  nPrePairing[6]++;
+                  continue;
                 }
 
                 if (debug) {
@@ -2765,18 +3221,16 @@ struct HfTrackIndexSkimCreator {
               }
 
               // reconstruct the 3-prong secondary vertex
-              if (df3.process(trackParVarNeg1, trackParVarPos1, trackParVarNeg2) == 0) {
+              const auto& fit3Prong = vertexFits3Prong.get(df3, trackParCache, {iTrackNeg1, iTrackPos1, iTrackNeg2});
+              if (!fit3Prong.isFitted) {
                 continue;
               }
               // get secondary vertex
-              const auto& secondaryVertex3 = df3.getPCACandidate();
+              const auto& secondaryVertex3 = fit3Prong.secondaryVertex;
               // get track momenta
-              std::array<float, 3> pvec0;
-              std::array<float, 3> pvec1;
-              std::array<float, 3> pvec2;
-              df3.getTrack(0).getPxPyPzGlo(pvec0);
-              df3.getTrack(1).getPxPyPzGlo(pvec1);
-              df3.getTrack(2).getPxPyPzGlo(pvec2);
+              const auto& pvec0 = fit3Prong.pVec[0];
+              const auto& pvec1 = fit3Prong.pVec[1];
+              const auto& pvec2 = fit3Prong.pVec[2];
               auto pVecCandProng3Neg = RecoDecay::pVec(pvec0, pvec1, pvec2);
 
               // 3-prong selections after secondary vertex
@@ -2859,6 +3313,9 @@ struct HfTrackIndexSkimCreator {
       nCand3 = rowTrackIndexProng3.lastIndex() - nCand3; // number of 3-prong candidates in this collision
 
       if (fillHistograms) {
+        for (size_t iBin = 0; iBin < nPrePairing.size(); iBin++) {
+          registry.fill(HIST("hPrePairing"), iBin + 1, nPrePairing[iBin]);
+        }
         registry.fill(HIST("hNTracks"), nTracks);
         registry.fill(HIST("hNCand2Prong"), nCand2);
         registry.fill(HIST("hNCand3Prong"), nCand3);
@@ -3198,6 +3655,7 @@ struct HfTrackIndexSkimCreatorLfCascades {
   Configurable<double> massOmegaPiMax{"massOmegaPiMax", 3., "Invariant mass upper limit for omega pi decay channel"};
   Configurable<double> massXiPiPiMin{"massXiPiPiMin", 2.1, "Invariant mass lower limit for xi pi pi decay channel"};
   Configurable<double> massXiPiPiMax{"massXiPiPiMax", 2.8, "Invariant mass upper limit for xi pi pi decay channel"};
+  Configurable<double> massToleranceBeforeFit{"massToleranceBeforeFit", 0.05, "Tolerance on the invariant-mass bounds from the momentum magnitudes used to skip the vertex fits, negative to fit all the combinations"};
 
   // DCAFitter settings
   Configurable<bool> propagateToPCA{"propagateToPCA", false, "create tracks version propagated to PCA"};
@@ -3324,6 +3782,40 @@ struct HfTrackIndexSkimCreatorLfCascades {
   Preslice<SelectedHfTrackAssoc> trackIndicesPerCollision = aod::track_association::collisionId; // aod::hf_track_association::collisionId
   Preslice<CascFull> cascadesPerCollision = aod::cascdata::collisionId;
 
+  std::vector<o2::track::TrackParCov> bachTrackParCache; // track parameters of the bachelor candidates of the collision
+
+  /// Checks whether the invariant mass of two particles can be in a mass window, for any opening angle
+  /// The momentum magnitudes are not changed by the propagation to the secondary vertex, apart from the energy loss
+  /// covered by the tolerance, so that the mass after the fit is between the collinear and the back-to-back ones
+  /// \param p0, p1 are the momentum magnitudes
+  /// \param masses are the mass hypotheses
+  /// \return false only if no fit can give a mass in the window
+  bool isMassWindowReachable2Prong(double p0, double p1, std::array<double, 2> const& masses, double massMin, double massMax) const
+  {
+    if (massToleranceBeforeFit < 0.) {
+      return true;
+    }
+    const double energies = std::sqrt(p0 * p0 + masses[0] * masses[0]) * std::sqrt(p1 * p1 + masses[1] * masses[1]);
+    const double sumMass2 = masses[0] * masses[0] + masses[1] * masses[1];
+    const double massCollinear = std::sqrt(sumMass2 + 2. * (energies - p0 * p1));
+    const double massBackToBack = std::sqrt(sumMass2 + 2. * (energies + p0 * p1));
+    return massCollinear <= massMax + massToleranceBeforeFit && massBackToBack >= massMin - massToleranceBeforeFit;
+  }
+
+  /// Checks whether the invariant mass of three particles can be below the upper limit of a mass window, for any opening angles
+  /// \param p0, p1, p2 are the momentum magnitudes
+  /// \param masses are the mass hypotheses
+  /// \return false only if the mass of collinear particles, i.e. the lowest one, is above the window
+  bool isMassWindowReachable3Prong(double p0, double p1, double p2, std::array<double, 3> const& masses, double massMax) const
+  {
+    if (massToleranceBeforeFit < 0.) {
+      return true;
+    }
+    const double energy = std::sqrt(p0 * p0 + masses[0] * masses[0]) + std::sqrt(p1 * p1 + masses[1] * masses[1]) + std::sqrt(p2 * p2 + masses[2] * masses[2]);
+    const double momentum = p0 + p1 + p2;
+    return std::sqrt(std::max(0., energy * energy - momentum * momentum)) <= massMax + massToleranceBeforeFit;
+  }
+
   /// Single-cascade cuts
   template <typename TCascade>
   bool isPreselectedCascade(const TCascade& casc, const float& pvx, const float& pvy, const float& pvz)
@@ -3423,6 +3915,17 @@ struct HfTrackIndexSkimCreatorLfCascades {
       auto thisCollId = collision.globalIndex();
       auto groupedCascades = cascades.sliceBy(cascadesPerCollision, thisCollId);
 
+      // the track parameters of the bachelor candidates are taken once per collision, instead of for each cascade and pion pair
+      auto groupedBachTrackIndices = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
+      bachTrackParCache.clear();
+      for (const auto& trackIdBach : groupedBachTrackIndices) {
+        if (TESTBIT(trackIdBach.isSelProng(), CandidateType::CandCascadeBachelor)) {
+          bachTrackParCache.emplace_back(getTrackParCov(trackIdBach.track_as<aod::TracksWCovDca>()));
+        } else {
+          bachTrackParCache.emplace_back();
+        }
+      }
+
       for (const auto& casc : groupedCascades) {
 
         registry.fill(HIST("hCandidateCounter"), 0.5); // all cascade candidates
@@ -3453,6 +3956,13 @@ struct HfTrackIndexSkimCreatorLfCascades {
           continue;
         }
 
+        // the cascade mass windows do not depend on the bachelor, so that the fits of a hypothesis are skipped if the cascade is outside its window
+        const bool isXiInWindow = std::abs(casc.mXi() - massXi) < cascadeMassWindow;
+        const bool isOmegaInWindow = std::abs(casc.mOmega() - massOmega) < cascadeMassWindow;
+        if (!isXiInWindow && !isOmegaInWindow) {
+          continue;
+        }
+
         std::array<float, 3> vertexCasc = {casc.x(), casc.y(), casc.z()};
         std::array<float, 3> pVecCasc = {casc.px(), casc.py(), casc.pz()};
         std::array<float, 21> covCasc = {0.};
@@ -3479,9 +3989,11 @@ struct HfTrackIndexSkimCreatorLfCascades {
         trackCascXi3Prong.setPID(o2::track::PID::XiMinus);
         trackCascOmega.setPID(o2::track::PID::OmegaMinus);
 
+        const double pCasc = RecoDecay::p(pVecCasc);
+
         //--------------combining cascade and pion tracks--------------
-        auto groupedBachTrackIndices = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
-        for (auto trackIdPion1 = groupedBachTrackIndices.begin(); trackIdPion1 != groupedBachTrackIndices.end(); ++trackIdPion1) {
+        int iPion1 = 0; // position of the pion in the bachelor candidates of the collision
+        for (auto trackIdPion1 = groupedBachTrackIndices.begin(); trackIdPion1 != groupedBachTrackIndices.end(); ++trackIdPion1, ++iPion1) {
 
           hfFlag = 0;
 
@@ -3506,11 +4018,11 @@ struct HfTrackIndexSkimCreatorLfCascades {
           }
 
           // primary pion track to be processed with DCAFitter
-          auto trackParVarPion1 = getTrackParCov(trackPion1);
+          const auto& trackParVarPion1 = bachTrackParCache[iPion1];
+          const double pPion1 = trackParVarPion1.getP();
 
           // find charm baryon decay using xi PID hypothesis
-          int nVtxFrom2ProngFitterXiHyp = df2.process(trackCascXi2Prong, trackParVarPion1);
-          if (nVtxFrom2ProngFitterXiHyp > 0) {
+          if (isXiInWindow && isMassWindowReachable2Prong(pCasc, pPion1, arrMass2Prong[hf_cand_casc_lf::DecayType2Prong::XiczeroOmegaczeroToXiPi], massXiPiMin, massXiPiMax) && df2.process(trackCascXi2Prong, trackParVarPion1) > 0) {
 
             df2.propagateTracksToVertex();
 
@@ -3523,7 +4035,7 @@ struct HfTrackIndexSkimCreatorLfCascades {
               std::array<std::array<float, 3>, 2> arrMomToXi = {pVecXi, pVecPion1XiHyp};
               auto mass2ProngXiHyp = RecoDecay::m(arrMomToXi, arrMass2Prong[hf_cand_casc_lf::DecayType2Prong::XiczeroOmegaczeroToXiPi]);
 
-              if ((std::abs(casc.mXi() - massXi) < cascadeMassWindow) && (mass2ProngXiHyp >= massXiPiMin) && (mass2ProngXiHyp <= massXiPiMax)) {
+              if ((mass2ProngXiHyp >= massXiPiMin) && (mass2ProngXiHyp <= massXiPiMax)) {
                 SETBIT(hfFlag, aod::hf_cand_casc_lf::DecayType2Prong::XiczeroOmegaczeroToXiPi);
               }
 
@@ -3537,8 +4049,7 @@ struct HfTrackIndexSkimCreatorLfCascades {
           }
 
           // find charm baryon decay using omega PID hypothesis
-          int nVtxFrom2ProngFitterOmegaHyp = df2.process(trackCascOmega, trackParVarPion1);
-          if (nVtxFrom2ProngFitterOmegaHyp > 0) {
+          if (isOmegaInWindow && isMassWindowReachable2Prong(pCasc, pPion1, arrMass2Prong[hf_cand_casc_lf::DecayType2Prong::OmegaczeroToOmegaPi], massOmegaPiMin, massOmegaPiMax) && df2.process(trackCascOmega, trackParVarPion1) > 0) {
 
             df2.propagateTracksToVertex();
 
@@ -3552,7 +4063,7 @@ struct HfTrackIndexSkimCreatorLfCascades {
               std::array<std::array<float, 3>, 2> arrMomToOmega = {pVecOmega, pVecPion1OmegaHyp};
               auto mass2ProngOmegaHyp = RecoDecay::m(arrMomToOmega, arrMass2Prong[hf_cand_casc_lf::DecayType2Prong::OmegaczeroToOmegaPi]);
 
-              if ((std::abs(casc.mOmega() - massOmega) < cascadeMassWindow) && (mass2ProngOmegaHyp >= massOmegaPiMin) && (mass2ProngOmegaHyp <= massOmegaPiMax)) {
+              if ((mass2ProngOmegaHyp >= massOmegaPiMin) && (mass2ProngOmegaHyp <= massOmegaPiMax)) {
                 SETBIT(hfFlag, aod::hf_cand_casc_lf::DecayType2Prong::OmegaczeroToOmegaPi);
               }
 
@@ -3574,10 +4085,11 @@ struct HfTrackIndexSkimCreatorLfCascades {
           }
 
           // first loop over tracks
-          if (do3Prong) {
+          if (do3Prong && isXiInWindow) {
 
             // second loop over positive tracks
-            for (auto trackIdPion2 = trackIdPion1 + 1; trackIdPion2 != groupedBachTrackIndices.end(); ++trackIdPion2) {
+            int iPion2 = iPion1 + 1;
+            for (auto trackIdPion2 = trackIdPion1 + 1; trackIdPion2 != groupedBachTrackIndices.end(); ++trackIdPion2, ++iPion2) {
 
               hfFlag = 0;
 
@@ -3602,11 +4114,10 @@ struct HfTrackIndexSkimCreatorLfCascades {
               }
 
               // primary pion track to be processed with DCAFitter
-              auto trackParVarPion2 = getTrackParCov(trackPion2);
+              const auto& trackParVarPion2 = bachTrackParCache[iPion2];
 
               // reconstruct Xic with DCAFitter
-              int nVtxFrom3ProngFitterXiHyp = df3.process(trackCascXi3Prong, trackParVarPion1, trackParVarPion2);
-              if (nVtxFrom3ProngFitterXiHyp > 0) {
+              if (isMassWindowReachable3Prong(pCasc, pPion1, trackParVarPion2.getP(), arrMass3Prong[hf_cand_casc_lf::DecayType3Prong::XicplusToXiPiPi], massXiPiPiMax) && df3.process(trackCascXi3Prong, trackParVarPion1, trackParVarPion2) > 0) {
 
                 df3.propagateTracksToVertex();
 
@@ -3622,7 +4133,7 @@ struct HfTrackIndexSkimCreatorLfCascades {
                   std::array<std::array<float, 3>, 3> arr3Mom = {pVec1, pVec2, pVec3};
                   auto mass3Prong = RecoDecay::m(arr3Mom, arrMass3Prong[hf_cand_casc_lf::DecayType3Prong::XicplusToXiPiPi]);
 
-                  if ((std::abs(casc.mXi() - massXi) < cascadeMassWindow) && (mass3Prong >= massXiPiPiMin) && (mass3Prong <= massXiPiPiMax)) {
+                  if ((mass3Prong >= massXiPiPiMin) && (mass3Prong <= massXiPiPiMax)) {
                     SETBIT(hfFlag, aod::hf_cand_casc_lf::DecayType3Prong::XicplusToXiPiPi);
                   }
 
@@ -240,96 +240,103 @@ struct HfTreeCreatorLcToPKPi {
     // Filling candidate properties
     rowCandidateFull.reserve(candidates.size());
     for (const auto& candidate : candidates) {
+      if (candidate.isSelLcToPKPi() < 1 && candidate.isSelLcToPiKP() < 1) {
+        continue;
+      }
+      // the downsampling does not depend on the mass hypothesis, so it is applied before computing the candidate properties
       auto trackPos1 = candidate.prong0_as<TracksWPid>(); // positive daughter (negative for the antiparticles)
+      double pseudoRndm = trackPos1.pt() * 1000. - (int64_t)(trackPos1.pt() * 1000);
+      if (pseudoRndm >= downSampleBkgFactor) {
+        continue;
+      }
       auto trackNeg = candidate.prong1_as<TracksWPid>();  // negative daughter (positive for the antiparticles)
       auto trackPos2 = candidate.prong2_as<TracksWPid>(); // positive daughter (negative for the antiparticles)
-      auto fillTable = [&](int CandFlag,
-                           int FunctionSelection,
-                           float FunctionInvMass,
-                           float FunctionCt,
-                           float FunctionY,
-                           float FunctionE) {
-        double pseudoRndm = trackPos1.pt() * 1000. - (int64_t)(trackPos1.pt() * 1000);
-        if (FunctionSelection >= 1 && pseudoRndm < downSampleBkgFactor) {
-          rowCandidateFull(
-            candidate.collisionId(),
-            candidate.posX(),
-            candidate.posY(),
-            candidate.posZ(),
-            candidate.nProngsContributorsPV(),
-            candidate.xSecondaryVertex(),
-            candidate.ySecondaryVertex(),
-            candidate.zSecondaryVertex(),
-            candidate.errorDecayLength(),
-            candidate.errorDecayLengthXY(),
-            candidate.chi2PCA(),
-            candidate.rSecondaryVertex(),
-            candidate.decayLength(),
-            candidate.decayLengthXY(),
-            candidate.decayLengthNormalised(),
-            candidate.decayLengthXYNormalised(),
-            candidate.impactParameterNormalised0(),
-            candidate.ptProng0(),
-            RecoDecay::p(candidate.pxProng0(), candidate.pyProng0(), candidate.pzProng0()),
-            candidate.impactParameterNormalised1(),
-            candidate.ptProng1(),
-            RecoDecay::p(candidate.pxProng1(), candidate.pyProng1(), candidate.pzProng1()),
-            candidate.impactParameterNormalised2(),
-            candidate.ptProng2(),
-            RecoDecay::p(candidate.pxProng2(), candidate.pyProng2(), candidate.pzProng2()),
-            candidate.pxProng0(),
-            candidate.pyProng0(),
-            candidate.pzProng0(),
-            candidate.pxProng1(),
-            candidate.pyProng1(),
-            candidate.pzProng1(),
-            candidate.pxProng2(),
-            candidate.pyProng2(),
-            candidate.pzProng2(),
-            candidate.impactParameter0(),
-            candidate.impactParameter1(),
-            candidate.impactParameter2(),
-            candidate.errorImpactParameter0(),
-            candidate.errorImpactParameter1(),
-            candidate.errorImpactParameter2(),
-            trackPos1.tpcNSigmaPi(),
-            trackPos1.tpcNSigmaKa(),
-            trackPos1.tpcNSigmaPr(),
-            trackPos1.tofNSigmaPi(),
-            trackPos1.tofNSigmaKa(),
-            trackPos1.tofNSigmaPr(),
-            trackNeg.tpcNSigmaPi(),
-            trackNeg.tpcNSigmaKa(),
-            trackNeg.tpcNSigmaPr(),
-            trackNeg.tofNSigmaPi(),
-            trackNeg.tofNSigmaKa(),
-            trackNeg.tofNSigmaPr(),
-            trackPos2.tpcNSigmaPi(),
-            trackPos2.tpcNSigmaKa(),
-            trackPos2.tpcNSigmaPr(),
-            trackPos2.tofNSigmaPi(),
-            trackPos2.tofNSigmaKa(),
-            trackPos2.tofNSigmaPr(),
-            1 << CandFlag,
-            FunctionInvMass,
-            candidate.pt(),
-            candidate.p(),
-            candidate.cpa(),
-            candidate.cpaXY(),
-            FunctionCt,
-            candidate.eta(),
-            candidate.phi(),
-            FunctionY,
-            FunctionE,
-            candidate.flagMcMatchRec(),
-            candidate.originMcRec(),
-            candidate.isCandidateSwapped(),
-            candidate.globalIndex());
-        }
+      const float FunctionCt = hfHelper.ctLc(candidate);
+      const float FunctionY = hfHelper.yLc(candidate);
+      const float FunctionE = hfHelper.eLc(candidate);
+      auto fillTable = [&](int CandFlag, float FunctionInvMass) {
+        rowCandidateFull(
+          candidate.collisionId(),
+          candidate.posX(),
+          candidate.posY(),
+          candidate.posZ(),
+          candidate.nProngsContributorsPV(),
+          candidate.xSecondaryVertex(),
+          candidate.ySecondaryVertex(),
+          candidate.zSecondaryVertex(),
+          candidate.errorDecayLength(),
+          candidate.errorDecayLengthXY(),
+          candidate.chi2PCA(),
+          candidate.rSecondaryVertex(),
+          candidate.decayLength(),
+          candidate.decayLengthXY(),
+          candidate.decayLengthNormalised(),
+          candidate.decayLengthXYNormalised(),
+          candidate.impactParameterNormalised0(),
+          candidate.ptProng0(),
+          RecoDecay::p(candidate.pxProng0(), candidate.pyProng0(), candidate.pzProng0()),
+          candidate.impactParameterNormalised1(),
+          candidate.ptProng1(),
+          RecoDecay::p(candidate.pxProng1(), candidate.pyProng1(), candidate.pzProng1()),
+          candidate.impactParameterNormalised2(),
+          candidate.ptProng2(),
+          RecoDecay::p(candidate.pxProng2(), candidate.pyProng2(), candidate.pzProng2()),
+          candidate.pxProng0(),
+          candidate.pyProng0(),
+          candidate.pzProng0(),
+          candidate.pxProng1(),
+          candidate.pyProng1(),
+          candidate.pzProng1(),
+          candidate.pxProng2(),
+          candidate.pyProng2(),
+          candidate.pzProng2(),
+          candidate.impactParameter0(),
+          candidate.impactParameter1(),
+          candidate.impactParameter2(),
+          candidate.errorImpactParameter0(),
+          candidate.errorImpactParameter1(),
+          candidate.errorImpactParameter2(),
+          trackPos1.tpcNSigmaPi(),
+          trackPos1.tpcNSigmaKa(),
+          trackPos1.tpcNSigmaPr(),
+          trackPos1.tofNSigmaPi(),
+          trackPos1.tofNSigmaKa(),
+          trackPos1.tofNSigmaPr(),
+          trackNeg.tpcNSigmaPi(),
+          trackNeg.tpcNSigmaKa(),
+          trackNeg.tpcNSigmaPr(),
+          trackNeg.tofNSigmaPi(),
+          trackNeg.tofNSigmaKa(),
+          trackNeg.tofNSigmaPr(),
+          trackPos2.tpcNSigmaPi(),
+          trackPos2.tpcNSigmaKa(),
+          trackPos2.tpcNSigmaPr(),
+          trackPos2.tofNSigmaPi(),
+          trackPos2.tofNSigmaKa(),
+          trackPos2.tofNSigmaPr(),
+          1 << CandFlag,
+          FunctionInvMass,
+          candidate.pt(),
+          candidate.p(),
+          candidate.cpa(),
+          candidate.cpaXY(),
+          FunctionCt,
+          candidate.eta(),
+          candidate.phi(),
+          FunctionY,
+          FunctionE,
+          candidate.flagMcMatchRec(),
+          candidate.originMcRec(),
+          candidate.isCandidateSwapped(),
+          candidate.globalIndex());
       };
 
-      fillTable(0, candidate.isSelLcToPKPi(), hfHelper.invMassLcToPKPi(candidate), hfHelper.ctLc(candidate), hfHelper.yLc(candidate), hfHelper.eLc(candidate));
-      fillTable(1, candidate.isSelLcToPiKP(), hfHelper.invMassLcToPiKP(candidate), hfHelper.ctLc(candidate), hfHelper.yLc(candidate), hfHelper.eLc(candidate));
+      if (candidate.isSelLcToPKPi() >= 1) {
+        fillTable(0, hfHelper.invMassLcToPKPi(candidate));
+      }
+      if (candidate.isSelLcToPiKP() >= 1) {
+        fillTable(1, hfHelper.invMassLcToPiKP(candidate));
+      }
     }
 
     // Filling particle properties
@@ -377,96 +384,103 @@ struct HfTreeCreatorLcToPKPi {
     // Filling candidate properties
     rowCandidateFull.reserve(candidates.size());
     for (const auto& candidate : candidates) {
+      if (candidate.isSelLcToPKPi() < 1 && candidate.isSelLcToPiKP() < 1) {
+        continue;
+      }
+      // the downsampling does not depend on the mass hypothesis, so it is applied before computing the candidate properties
       auto trackPos1 = candidate.prong0_as<TracksWPid>(); // positive daughter (negative for the antiparticles)
+      double pseudoRndm = trackPos1.pt() * 1000. - (int64_t)(trackPos1.pt() * 1000);
+      if (pseudoRndm >= downSampleBkgFactor) {
+        continue;
+      }
       auto trackNeg = candidate.prong1_as<TracksWPid>();  // negative daughter (positive for the antiparticles)
       auto trackPos2 = candidate.prong2_as<TracksWPid>(); // positive daughter (negative for the antiparticles)
-      auto fillTable = [&](int CandFlag,
-                           int FunctionSelection,
-                           float FunctionInvMass,
-                           float FunctionCt,
-                           float FunctionY,
-                           float FunctionE) {
-        double pseudoRndm = trackPos1.pt() * 1000. - (int64_t)(trackPos1.pt() * 1000);
-        if (FunctionSelection >= 1 && pseudoRndm < downSampleBkgFactor) {
-          rowCandidateFull(
-            candidate.collisionId(),
-            candidate.posX(),
-            candidate.posY(),
-            candidate.posZ(),
-            candidate.nProngsContributorsPV(),
-            candidate.xSecondaryVertex(),
-            candidate.ySecondaryVertex(),
-            candidate.zSecondaryVertex(),
-            candidate.errorDecayLength(),
-            candidate.errorDecayLengthXY(),
-            candidate.chi2PCA(),
-            candidate.rSecondaryVertex(),
-            candidate.decayLength(),
-            candidate.decayLengthXY(),
-            candidate.decayLengthNormalised(),
-            candidate.decayLengthXYNormalised(),
-            candidate.impactParameterNormalised0(),
-            candidate.ptProng0(),
-            RecoDecay::p(candidate.pxProng0(), candidate.pyProng0(), candidate.pzProng0()),
-            candidate.impactParameterNormalised1(),
-            candidate.ptProng1(),
-            RecoDecay::p(candidate.pxProng1(), candidate.pyProng1(), candidate.pzProng1()),
-            candidate.impactParameterNormalised2(),
-            candidate.ptProng2(),
-            RecoDecay::p(candidate.pxProng2(), candidate.pyProng2(), candidate.pzProng2()),
-            candidate.pxProng0(),
-            candidate.pyProng0(),
-            candidate.pzProng0(),
-            candidate.pxProng1(),
-            candidate.pyProng1(),
-            candidate.pzProng1(),
-            candidate.pxProng2(),
-            candidate.pyProng2(),
-            candidate.pzProng2(),
-            candidate.impactParameter0(),
-            candidate.impactParameter1(),
-            candidate.impactParameter2(),
-            candidate.errorImpactParameter0(),
-            candidate.errorImpactParameter1(),
-            candidate.errorImpactParameter2(),
-            trackPos1.tpcNSigmaPi(),
-            trackPos1.tpcNSigmaKa(),
-            trackPos1.tpcNSigmaPr(),
-            trackPos1.tofNSigmaPi(),
-            trackPos1.tofNSigmaKa(),
-            trackPos1.tofNSigmaPr(),
-            trackNeg.tpcNSigmaPi(),
-            trackNeg.tpcNSigmaKa(),
-            trackNeg.tpcNSigmaPr(),
-            trackNeg.tofNSigmaPi(),
-            trackNeg.tofNSigmaKa(),
-            trackNeg.tofNSigmaPr(),
-            trackPos2.tpcNSigmaPi(),
-            trackPos2.tpcNSigmaKa(),
-            trackPos2.tpcNSigmaPr(),
-            trackPos2.tofNSigmaPi(),
-            trackPos2.tofNSigmaKa(),
-            trackPos2.tofNSigmaPr(),
-            1 << CandFlag,
-            FunctionInvMass,
-            candidate.pt(),
-            candidate.p(),
-            candidate.cpa(),
-            candidate.cpaXY(),
-            FunctionCt,
-            candidate.eta(),
-            candidate.phi(),
-            FunctionY,
-            FunctionE,
-            0.,
-            0.,
-            0.,
-            candidate.globalIndex());
-        }
+      const float FunctionCt = hfHelper.ctLc(candidate);
+      const float FunctionY = hfHelper.yLc(candidate);
+      const float FunctionE = hfHelper.eLc(candidate);
+      auto fillTable = [&](int CandFlag, float FunctionInvMass) {
+        rowCandidateFull(
+          candidate.collisionId(),
+          candidate.posX(),
+          candidate.posY(),
+          candidate.posZ(),
+          candidate.nProngsContributorsPV(),
+          candidate.xSecondaryVertex(),
+          candidate.ySecondaryVertex(),
+          candidate.zSecondaryVertex(),
+          candidate.errorDecayLength(),
+          candidate.errorDecayLengthXY(),
+          candidate.chi2PCA(),
+          candidate.rSecondaryVertex(),
+          candidate.decayLength(),
+          candidate.decayLengthXY(),
+          candidate.decayLengthNormalised(),
+          candidate.decayLengthXYNormalised(),
+          candidate.impactParameterNormalised0(),
+          candidate.ptProng0(),
+          RecoDecay::p(candidate.pxProng0(), candidate.pyProng0(), candidate.pzProng0()),
+          candidate.impactParameterNormalised1(),
+          candidate.ptProng1(),
+          RecoDecay::p(candidate.pxProng1(), candidate.pyProng1(), candidate.pzProng1()),
+          candidate.impactParameterNormalised2(),
+          candidate.ptProng2(),
+          RecoDecay::p(candidate.pxProng2(), candidate.pyProng2(), candidate.pzProng2()),
+          candidate.pxProng0(),
+          candidate.pyProng0(),
+          candidate.pzProng0(),
+          candidate.pxProng1(),
+          candidate.pyProng1(),
+          candidate.pzProng1(),
+          candidate.pxProng2(),
+          candidate.pyProng2(),
+          candidate.pzProng2(),
+          candidate.impactParameter0(),
+          candidate.impactParameter1(),
+          candidate.impactParameter2(),
+          candidate.errorImpactParameter0(),
+          candidate.errorImpactParameter1(),
+          candidate.errorImpactParameter2(),
+          trackPos1.tpcNSigmaPi(),
+          trackPos1.tpcNSigmaKa(),
+          trackPos1.tpcNSigmaPr(),
+          trackPos1.tofNSigmaPi(),
+          trackPos1.tofNSigmaKa(),
+          trackPos1.tofNSigmaPr(),
+          trackNeg.tpcNSigmaPi(),
+          trackNeg.tpcNSigmaKa(),
+          trackNeg.tpcNSigmaPr(),
+          trackNeg.tofNSigmaPi(),
+          trackNeg.tofNSigmaKa(),
+          trackNeg.tofNSigmaPr(),
+          trackPos2.tpcNSigmaPi(),
+          trackPos2.tpcNSigmaKa(),
+          trackPos2.tpcNSigmaPr(),
+          trackPos2.tofNSigmaPi(),
+          trackPos2.tofNSigmaKa(),
+          trackPos2.tofNSigmaPr(),
+          1 << CandFlag,
+          FunctionInvMass,
+          candidate.pt(),
+          candidate.p(),
+          candidate.cpa(),
+          candidate.cpaXY(),
+          FunctionCt,
+          candidate.eta(),
+          candidate.phi(),
+          FunctionY,
+          FunctionE,
+          0.,
+          0.,
+          0.,
+          candidate.globalIndex());
       };
 
-      fillTable(0, candidate.isSelLcToPKPi(), hfHelper.invMassLcToPKPi(candidate), hfHelper.ctLc(candidate), hfHelper.yLc(candidate), hfHelper.eLc(candidate));
-      fillTable(1, candidate.isSelLcToPiKP(), hfHelper.invMassLcToPiKP(candidate), hfHelper.ctLc(candidate), hfHelper.yLc(candidate), hfHelper.eLc(candidate));
+      if (candidate.isSelLcToPKPi() >= 1) {
+        fillTable(0, hfHelper.invMassLcToPKPi(candidate));
+      }
+      if (candidate.isSelLcToPiKP() >= 1) {
+        fillTable(1, hfHelper.invMassLcToPiKP(candidate));
+      }
     }
   }
   PROCESS_SWITCH(HfTreeCreatorLcToPKPi, processData, "Process data tree writer", false);
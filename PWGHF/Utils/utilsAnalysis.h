@@ -16,7 +16,13 @@
 #define PWGHF_UTILS_UTILSANALYSIS_H_
 
 #include <algorithm> // std::upper_bound
+#include <array>     // std::array
+#include <cstddef>   // std::size_t
 #include <iterator>  // std::distance
+#include <string>    // std::string
+#include <vector>    // std::vector
+
+#include "Framework/Logger.h"
 
 namespace o2::analysis
 {
@@ -36,6 +42,27 @@ int findBin(T1 const& binsPt, T2 value)
   }
   return std::distance(binsPt->begin(), std::upper_bound(binsPt->begin(), binsPt->end(), value)) - 1;
 }
+
+/// Copies the cuts of a labelled array in rows per pT bin with a fixed column layout, resolving the column labels once,
+/// so that the selections read the cuts by index instead of by label for each candidate.
+/// \param cuts  labelled array of the cuts, with a row per pT bin
+/// \param labels  labels of the cut variables, in the order of the columns of the layout
+/// \return cuts per pT bin, with the columns in the order of the labels
+template <std::size_t NCutVars, typename T>
+std::vector<std::array<double, NCutVars>> getCutsPerPtBin(T const& cuts, std::vector<std::string> const& labels)
+{
+  std::vector<std::array<double, NCutVars>> cutsPerPtBin(cuts.rows());
+  for (std::size_t iCut = 0; iCut < NCutVars && iCut < labels.size(); iCut++) {
+    auto column = cuts.colmap.find(labels[iCut]);
+    if (column == cuts.colmap.end()) {
+      LOGP(fatal, "Cut variable \"{}\" not found in the cut array", labels[iCut]);
+    }
+    for (std::size_t iPtBin = 0; iPtBin < cutsPerPtBin.size(); iPtBin++) {
+      cutsPerPtBin[iPtBin][iCut] = cuts.get(iPtBin, column->second);
+    }
+  }
+  return cutsPerPtBin;
+}
 } // namespace o2::analysis
 
 #endif // PWGHF_UTILS_UTILSANALYSIS_H_
@@ -0,0 +1,153 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsDcaFitterBatch.h
+/// \brief Batched secondary-vertex fits with DCAFitterN for the candidate creators
+///
+/// The prongs of all the candidates of a data frame are collected first, with the track parametrisations
+/// converted once per track, then all the candidates are fitted in one loop (optionally split in contiguous
+/// chunks over several threads, one fitter per thread). The results are read back in the order of the candidates.
+
+#ifndef PWGHF_UTILS_UTILSDCAFITTERBATCH_H_
+#define PWGHF_UTILS_UTILSDCAFITTERBATCH_H_
+
+#include <algorithm> // std::min
+#include <array>     // std::array
+#include <thread>    // std::thread
+#include <vector>    // std::vector
+
+#include "DCAFitter/DCAFitterN.h"
+#include "ReconstructionDataFormats/Track.h"
+
+#include "Common/Core/trackUtilities.h"
+
+namespace o2::analysis
+{
+/// \brief Batched secondary-vertex fits of N-prong candidates
+template <int N>
+class HfDcaFitterBatch
+{
+ public:
+  /// Result of the secondary-vertex fit of a candidate
+  struct Fit {
+    bool isFitted{false};                           // whether the fit found a vertex
+    std::array<double, 3> secondaryVertex{};        // position of the secondary vertex
+    float chi2PCA{0.};                              // chi2 at the point of closest approach
+    std::array<float, 6> covMatrixPCA{};            // covariance matrix of the secondary vertex
+    std::array<o2::track::TrackParCov, N> tracks{}; // prongs propagated to the secondary vertex
+  };
+
+  /// Prepares the batch for a new data frame
+  /// \param nTracks is the number of rows of the track table
+  void reset(std::size_t nTracks)
+  {
+    mTrackParCovs.clear();
+    mTrackParCovIndices.assign(nTracks, -1);
+    mProngs.clear();
+    mBz.clear();
+    mFits.clear();
+  }
+
+  /// Adds a candidate to the batch
+  /// \param tracks are the prongs of the candidate
+  /// \param bz is the magnetic field for the fit
+  /// \return index of the candidate in the batch
+  template <typename... TTrack>
+  std::size_t addCandidate(double bz, TTrack const&... tracks)
+  {
+    static_assert(sizeof...(tracks) == N, "wrong number of prongs");
+    mProngs.push_back({getTrackParCovIndex(tracks)...});
+    mBz.push_back(bz);
+    return mProngs.size() - 1;
+  }
+
+  /// Fits all the candidates of the batch
+  /// \param fitters are the configured vertex fitters, one per thread
+  void fitAll(std::vector<o2::vertexing::DCAFitterN<N>>& fitters)
+  {
+    const std::size_t nCandidates = mProngs.size();
+    mFits.resize(nCandidates);
+    if (nCandidates == 0) {
+      return;
+    }
+    if (fitters.size() <= 1) {
+      fitRange(fitters[0], 0, nCandidates);
+      return;
+    }
+    const std::size_t chunkSize = (nCandidates + fitters.size() - 1) / fitters.size();
+    std::vector<std::thread> workers;
+    for (std::size_t iWorker = 0; iWorker * chunkSize < nCandidates; iWorker++) {
+      workers.emplace_back([this, &fitters, iWorker, chunkSize, nCandidates]() {
+        fitRange(fitters[iWorker], iWorker * chunkSize, std::min(nCandidates, (iWorker + 1) * chunkSize));
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  /// \return the fit of a candidate
+  /// \param iCandidate is the index of the candidate in the batch
+  const Fit& getFit(std::size_t iCandidate) const { return mFits[iCandidate]; }
+
+  /// \return the magnetic field used for the fit of a candidate
+  /// \param iCandidate is the index of the candidate in the batch
+  double getBz(std::size_t iCandidate) const { return mBz[iCandidate]; }
+
+ private:
+  std::vector<o2::track::TrackParCov> mTrackParCovs; // track parametrisations, converted once per track
+  std::vector<int> mTrackParCovIndices;              // index in mTrackParCovs of each track of the table, -1 if not converted yet
+  std::vector<std::array<int, N>> mProngs;           // indices in mTrackParCovs of the prongs of each candidate
+  std::vector<double> mBz;                           // magnetic field for each candidate
+  std::vector<Fit> mFits;                            // fits of the candidates
+
+  template <typename TTrack>
+  int getTrackParCovIndex(TTrack const& track)
+  {
+    int& index = mTrackParCovIndices[track.globalIndex()];
+    if (index < 0) {
+      index = mTrackParCovs.size();
+      mTrackParCovs.push_back(getTrackParCov(track));
+    }
+    return index;
+  }
+
+  void fitRange(o2::vertexing::DCAFitterN<N>& df, std::size_t first, std::size_t last)
+  {
+    for (std::size_t iCandidate = first; iCandidate < last; iCandidate++) {
+      const auto& prongs = mProngs[iCandidate];
+      auto& fit = mFits[iCandidate];
+      df.setBz(mBz[iCandidate]);
+      int nCand = 0;
+      if constexpr (N == 2) {
+        nCand = df.process(mTrackParCovs[prongs[0]], mTrackParCovs[prongs[1]]);
+      } else if constexpr (N == 3) {
+        nCand = df.process(mTrackParCovs[prongs[0]], mTrackParCovs[prongs[1]], mTrackParCovs[prongs[2]]);
+      }
+      fit.isFitted = (nCand > 0);
+      if (!fit.isFitted) {
+        continue;
+      }
+      const auto& secondaryVertex = df.getPCACandidate();
+      for (int iCoord = 0; iCoord < 3; iCoord++) {
+        fit.secondaryVertex[iCoord] = secondaryVertex[iCoord];
+      }
+      fit.chi2PCA = df.getChi2AtPCACandidate();
+      fit.covMatrixPCA = df.calcPCACovMatrixFlat();
+      for (int iProng = 0; iProng < N; iProng++) {
+        fit.tracks[iProng] = df.getTrack(iProng);
+      }
+    }
+  }
+};
+} // namespace o2::analysis
+
+#endif // PWGHF_UTILS_UTILSDCAFITTERBATCH_H_
@@ -0,0 +1,94 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsSelectionProfiler.h
+/// \brief Profiling of the selection steps of the HF candidate selectors
+///
+/// For each selection step and pT bin of the selector, the number of tested and rejected candidates
+/// and the time spent in the step are filled in histograms, so that the rejection rate and the cost
+/// of each step can be compared.
+
+#ifndef PWGHF_UTILS_UTILSSELECTIONPROFILER_H_
+#define PWGHF_UTILS_UTILSSELECTIONPROFILER_H_
+
+#include <chrono> // std::chrono
+#include <memory> // std::shared_ptr
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <TH2.h>
+
+#include "Framework/HistogramRegistry.h"
+
+namespace o2::analysis
+{
+/// \brief Counts and times the selection steps of a candidate selector per pT bin
+class HfSelectionProfiler
+{
+ public:
+  /// Creates the profiling histograms
+  /// \param registry is the histogram registry of the selector
+  /// \param binsPt are the pT bin limits of the selections
+  /// \param namesSteps are the names of the selection steps
+  void init(o2::framework::HistogramRegistry& registry, const std::vector<double>& binsPt, const std::vector<std::string>& namesSteps)
+  {
+    using namespace o2::framework;
+    const AxisSpec axisPt{binsPt, "#it{p}_{T} (GeV/#it{c})"};
+    const AxisSpec axisSteps{static_cast<int>(namesSteps.size()), -0.5, namesSteps.size() - 0.5, ""};
+    hTested = registry.add<TH2>("SelectionProfile/hTested", "Tested candidates;#it{p}_{T} (GeV/#it{c});selection step", {HistType::kTH2F, {axisPt, axisSteps}});
+    hRejected = registry.add<TH2>("SelectionProfile/hRejected", "Rejected candidates;#it{p}_{T} (GeV/#it{c});selection step", {HistType::kTH2F, {axisPt, axisSteps}});
+    hTime = registry.add<TH2>("SelectionProfile/hTime", "Time spent in the selection step (ns);#it{p}_{T} (GeV/#it{c});selection step", {HistType::kTH2D, {axisPt, axisSteps}});
+    for (std::size_t iStep = 0; iStep < namesSteps.size(); ++iStep) {
+      for (const auto& histo : {hTested, hRejected, hTime}) {
+        histo->GetYaxis()->SetBinLabel(iStep + 1, namesSteps[iStep].data());
+      }
+    }
+    mIsEnabled = true;
+  }
+
+  /// \return whether the profiling is enabled
+  bool isEnabled() const { return mIsEnabled; }
+
+  /// Starts the timing of a selection step
+  void start()
+  {
+    if (mIsEnabled) {
+      mStart = std::chrono::steady_clock::now();
+    }
+  }
+
+  /// Stops the timing of a selection step and counts the candidate
+  /// \param step is the index of the selection step
+  /// \param pt is the candidate pT
+  /// \param isSelected is the outcome of the selection step
+  void stop(int step, double pt, bool isSelected)
+  {
+    if (!mIsEnabled) {
+      return;
+    }
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart).count();
+    hTested->Fill(pt, step);
+    if (!isSelected) {
+      hRejected->Fill(pt, step);
+    }
+    hTime->Fill(pt, step, static_cast<double>(time));
+  }
+
+ private:
+  bool mIsEnabled{false};                         // whether the profiling is enabled
+  std::chrono::steady_clock::time_point mStart{}; // start of the timing of the current step
+  std::shared_ptr<TH2> hTested{nullptr};          // tested candidates per pT bin and step
+  std::shared_ptr<TH2> hRejected{nullptr};        // rejected candidates per pT bin and step
+  std::shared_ptr<TH2> hTime{nullptr};            // time spent per pT bin and step
+};
+} // namespace o2::analysis
+
+#endif // PWGHF_UTILS_UTILSSELECTIONPROFILER_H_
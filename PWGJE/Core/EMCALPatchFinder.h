@@ -0,0 +1,126 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   EMCALPatchFinder.h
+/// \brief  Sliding-window search of EMCAL/DCAL trigger patches on a grid of tower energies
+///
+/// The energies of an event are accumulated on the grid of towers (row in phi, column in eta) and a
+/// summed-area table of the grid is built once, so that the energy of a patch of any size (e.g. 2x2
+/// towers for gamma patches, 16x16 towers for jet patches) is obtained from four table entries.
+/// The search of the maximum patch is then a single sweep over the patch positions, independent of the
+/// patch size. Patches are searched within a range of rows, e.g. to keep EMCAL and DCAL separate.
+///
+/// Usage:
+///   EMCALPatchFinder patchFinder;
+///   // in init(): patchFinder.init(nRows, nCols);
+///   // in process():
+///   patchFinder.reset();
+///   for (...) { patchFinder.addEnergy(row, col, energy); }
+///   patchFinder.build();
+///   auto maxPatch = patchFinder.findMaxPatch(16, 4, 0, nRowsEMCAL);
+///
+
+#ifndef PWGJE_CORE_EMCALPATCHFINDER_H_
+#define PWGJE_CORE_EMCALPATCHFINDER_H_
+
+#include <algorithm>
+#include <vector>
+
+class EMCALPatchFinder
+{
+ public:
+  /**
+   * Patch with the energy and the position of its first tower
+   */
+  struct Patch {
+    double energy = 0.; // sum of the tower energies of the patch
+    int row = -1;       // first row of the patch
+    int col = -1;       // first column of the patch
+  };
+
+  /// Sets the size of the tower grid and empties it
+  void init(int nRows, int nCols)
+  {
+    mNRows = std::max(nRows, 0);
+    mNCols = std::max(nCols, 0);
+    mTowers.assign(mNRows * mNCols, 0.);
+    mSums.assign((mNRows + 1) * (mNCols + 1), 0.);
+  }
+
+  /// Empties the grid, keeping its size
+  void reset() { std::fill(mTowers.begin(), mTowers.end(), 0.); }
+
+  /// Adds energy to a tower, ignored if the tower is outside the grid
+  void addEnergy(int row, int col, double energy)
+  {
+    if (row < 0 || row >= mNRows || col < 0 || col >= mNCols) {
+      return;
+    }
+    mTowers[row * mNCols + col] += energy;
+  }
+
+  /// Builds the summed-area table of the grid, to be called after filling the towers and before the patch queries
+  void build()
+  {
+    const int stride = mNCols + 1;
+    for (int row = 0; row < mNRows; row++) {
+      double rowSum = 0.;
+      for (int col = 0; col < mNCols; col++) {
+        rowSum += mTowers[row * mNCols + col];
+        mSums[(row + 1) * stride + col + 1] = mSums[row * stride + col + 1] + rowSum;
+      }
+    }
+  }
+
+  /// @returns energy of the patch of size x size towers starting at (row, col), which must be inside the grid
+  double getPatchEnergy(int row, int col, int size) const
+  {
+    const int stride = mNCols + 1;
+    return mSums[(row + size) * stride + col + size] - mSums[row * stride + col + size] - mSums[(row + size) * stride + col] + mSums[row * stride + col];
+  }
+
+  /// Finds the patch with the highest energy among the patches contained in a range of rows
+  /// \param size size of the patch in towers, in both directions
+  /// \param step distance between the first towers of two patches, e.g. 1 for gamma patches and 4 for jet patches
+  /// \param rowMin first row of the range
+  /// \param rowMax row after the last one of the range
+  /// @returns patch with the highest energy, with row -1 if no patch fits in the range
+  Patch findMaxPatch(int size, int step, int rowMin, int rowMax) const
+  {
+    Patch maxPatch;
+    rowMin = std::max(rowMin, 0);
+    rowMax = std::min(rowMax, mNRows);
+    if (size <= 0 || step <= 0) {
+      return maxPatch;
+    }
+    for (int row = rowMin; row + size <= rowMax; row += step) {
+      for (int col = 0; col + size <= mNCols; col += step) {
+        const double energy = getPatchEnergy(row, col, size);
+        if (maxPatch.row < 0 || energy > maxPatch.energy) {
+          maxPatch = {energy, row, col};
+        }
+      }
+    }
+    return maxPatch;
+  }
+
+  int getNRows() const { return mNRows; }
+  int getNCols() const { return mNCols; }
+
+ private:
+  int mNRows = 0;              // number of rows (phi) of the grid
+  int mNCols = 0;              // number of columns (eta) of the grid
+  std::vector<double> mTowers; // tower energies, row by row
+  std::vector<double> mSums;   // summed-area table, (mNRows + 1) x (mNCols + 1) with a leading row and column of zeros
+};
+
+#endif // PWGJE_CORE_EMCALPATCHFINDER_H_
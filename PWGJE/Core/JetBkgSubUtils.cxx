@@ -80,6 +80,27 @@ std::tuple<double, double> JetBkgSubUtils::estimateRhoAreaMedian(const std::vect
   return std::make_tuple(rho, rhoM);
 }
 
+std::tuple<double, double> JetBkgSubUtils::estimateRhoGridMedian(const std::vector<fastjet::PseudoJet>& inputParticles)
+{
+
+  if (inputParticles.size() == 0) {
+    return std::make_tuple(0.0, 0.0);
+  }
+
+  // the tiles are set up once and reused for all the events
+  if (!gridEstimator) {
+    // restrict the tiles in phi only if a partial acceptance is requested
+    fastjet::Selector selTiles = (bkgPhiMax - bkgPhiMin < 2 * M_PI) ? fastjet::SelectorPhiRange(bkgPhiMin, bkgPhiMax) : fastjet::Selector();
+    fastjet::RectangularGrid grid(bkgEtaMin, bkgEtaMax, gridSpacing, gridSpacing, selTiles);
+    gridEstimator = std::make_unique<fastjet::GridMedianBackgroundEstimator>(grid);
+    gridEstimator->set_compute_rho_m(true);
+  }
+
+  gridEstimator->set_particles(removeHFCand ? selRemoveHFCand(inputParticles) : inputParticles);
+
+  return std::make_tuple(gridEstimator->rho(), gridEstimator->rho_m());
+}
+
 std::tuple<double, double> JetBkgSubUtils::estimateRhoPerpCone(const std::vector<fastjet::PseudoJet>& inputParticles, const std::vector<fastjet::PseudoJet>& jets)
 {
 
@@ -29,6 +29,8 @@
 #include "fastjet/ClusterSequenceArea.hh"
 #include "fastjet/AreaDefinition.hh"
 #include "fastjet/JetDefinition.hh"
+#include "fastjet/RectangularGrid.hh"
+#include "fastjet/tools/GridMedianBackgroundEstimator.hh"
 #include "fastjet/tools/JetMedianBackgroundEstimator.hh"
 #include "fastjet/tools/Subtractor.hh"
 #include "fastjet/contrib/ConstituentSubtractor.hh"
@@ -73,6 +75,12 @@ class JetBkgSubUtils
   /// @return Rho, RhoM the underlying event density
   std::tuple<double, double> estimateRhoAreaMedian(const std::vector<fastjet::PseudoJet>& inputParticles, bool doSparseSub);
 
+  /// @brief Method for estimating the jet background density using the median over the tiles of a fixed eta-phi grid
+  /// @param inputParticles (all particles in the event)
+  /// @return Rho, RhoM the underlying event density
+  /// @note no clustering is needed and the grid is built once for all the events; empty tiles enter the median, hence no sparse correction is needed
+  std::tuple<double, double> estimateRhoGridMedian(const std::vector<fastjet::PseudoJet>& inputParticles);
+
   /// @brief Background estimator using the perpendicular cone method
   /// @param inputParticles
   /// @param jets (all jets in the event)
@@ -106,11 +114,18 @@ class JetBkgSubUtils
   {
     bkgPhiMin = phimin_out;
     bkgPhiMax = phimax_out;
+    gridEstimator.reset();
   }
   void setEtaMinMax(float etamin_out, float etamax_out)
   {
     bkgEtaMin = etamin_out;
     bkgEtaMax = etamax_out;
+    gridEstimator.reset();
+  }
+  void setGridSpacing(float gridSpacing_out)
+  {
+    gridSpacing = gridSpacing_out;
+    gridEstimator.reset();
   }
   void setConstSubAlphaRMax(float alpha_out, float rmax_out)
   {
@@ -132,6 +147,7 @@ class JetBkgSubUtils
   float getEtaMin() const { return bkgEtaMin; }
   float getEtaMax() const { return bkgEtaMax; }
   float getEtaMaxEvent() const { return maxEtaEvent; }
+  float getGridSpacing() const { return gridSpacing; }
   float getConstSubAlpha() const { return constSubAlpha; }
   float getConstSubRMax() const { return constSubRMax; }
   float getDoRhoMassSub() const { return doRhoMassSub; }
@@ -153,6 +169,7 @@ class JetBkgSubUtils
   float constSubAlpha = 1.0;
   float constSubRMax = 0.6;
   float maxEtaEvent = 0.9;
+  float gridSpacing = 0.55; /// size of the tiles of the grid-median estimator in eta and phi
   bool doRhoMassSub = false; /// flag whether to do jet mass subtraction with the const sub
   bool removeHFCand = false; /// flag whether to remove the HF candidate from the list of particles
 
@@ -163,6 +180,7 @@ class JetBkgSubUtils
   fastjet::AreaDefinition areaDefBkg = fastjet::AreaDefinition(fastjet::active_area_explicit_ghosts, ghostAreaSpec);
   fastjet::Selector selRho = fastjet::Selector();
   fastjet::Selector selRemoveHFCand = !FastJetUtilities::SelectorIsHFCand();
+  std::unique_ptr<fastjet::GridMedianBackgroundEstimator> gridEstimator; //! grid-median estimator, built at the first use
 
 }; // class JetBkgSubUtils
 
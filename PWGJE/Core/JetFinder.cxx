@@ -62,3 +62,19 @@ fastjet::ClusterSequenceArea JetFinder::findJets(std::vector<fastjet::PseudoJet>
   }
   return clusterSeq;
 }
+
+/// Extracts the jets with radius jetR from the history of a clustering with a larger radius
+/// \note only valid for the Cambridge/Aachen algorithm
+/// \param clusterSeq ClusterSequenceArea object of the clustering with the larger radius
+/// \param jetRClustering radius used for the clustering
+/// \return vector of jets
+std::vector<fastjet::PseudoJet> JetFinder::findJets(const fastjet::ClusterSequenceArea& clusterSeq, float jetRClustering)
+{
+  setParams();
+  // for C/A d_ij = (DeltaR_ij / R)^2 and d_iB = 1, hence undoing the recombinations with DeltaR_ij > jetR gives the jets with radius jetR
+  auto jets = clusterSeq.exclusive_jets(static_cast<double>(jetR) * jetR / (static_cast<double>(jetRClustering) * jetRClustering));
+
+  jets = selJets(jets);
+  jets = fastjet::sorted_by_pt(jets);
+  return jets;
+}
@@ -74,6 +74,7 @@ class JetFinder
 
   bool isReclustering;
   bool isTriggering;
+  bool reuseClusteringHistory; // for C/A, extract the jets of all the radii from the clustering with the largest radius
 
   fastjet::JetAlgorithm algorithm;
   fastjet::RecombinationScheme recombScheme;
@@ -107,6 +108,7 @@ class JetFinder
                                                                                                                  ktScatter(0.1),
                                                                                                                  isReclustering(false),
                                                                                                                  isTriggering(false),
+                                                                                                                 reuseClusteringHistory(false),
                                                                                                                  algorithm(fastjet::antikt_algorithm),
                                                                                                                  recombScheme(fastjet::E_scheme),
                                                                                                                  strategy(fastjet::Best),
@@ -129,8 +131,15 @@ class JetFinder
   /// \return ClusterSequenceArea object needed to access constituents
   fastjet::ClusterSequenceArea findJets(std::vector<fastjet::PseudoJet>& inputParticles, std::vector<fastjet::PseudoJet>& jets); // ideally find a way of passing the cluster sequence as a reeference
 
+  /// Extracts the jets with radius jetR from the history of a clustering with a larger radius
+  /// \note only valid for the Cambridge/Aachen algorithm
+  /// \param clusterSeq ClusterSequenceArea object of the clustering with the larger radius
+  /// \param jetRClustering radius used for the clustering
+  /// \return vector of jets
+  std::vector<fastjet::PseudoJet> findJets(const fastjet::ClusterSequenceArea& clusterSeq, float jetRClustering);
+
  private:
-  ClassDefNV(JetFinder, 1);
+  ClassDefNV(JetFinder, 2);
 };
 
 #endif // PWGJE_CORE_JETFINDER_H_
@@ -0,0 +1,171 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file JetSubstructureUtilities.h
+/// \brief Jet substructure observables from a single C/A reclustering of the jet constituents
+///
+/// The constituents of a jet are reclustered once with the Cambridge/Aachen algorithm and the primary
+/// declusterings (following the harder branch, or the branch with the HF candidate) are stored, so that
+/// the soft drop grooming, the primary Lund plane and the angularities are all obtained from the same history.
+
+#ifndef PWGJE_CORE_JETSUBSTRUCTUREUTILITIES_H_
+#define PWGJE_CORE_JETSUBSTRUCTUREUTILITIES_H_
+
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "fastjet/PseudoJet.hh"
+#include "fastjet/ClusterSequence.hh"
+#include "fastjet/JetDefinition.hh"
+
+#include "PWGJE/Core/FastJetUtilities.h"
+
+namespace JetSubstructureUtilities
+{
+/**
+ * Primary declustering of a jet, with the two subjets ordered in pT
+ */
+struct Splitting {
+  double ptHarder; // pT of the harder subjet
+  double ptSofter; // pT of the softer subjet
+  double deltaR;   // distance of the two subjets in the rapidity-phi plane
+  double z;        // momentum fraction of the softer subjet
+  double kt;       // transverse momentum of the softer subjet with respect to the harder one
+
+  /// @returns ln(1/deltaR), the horizontal coordinate of the primary Lund plane
+  double lnInvDeltaR() const { return std::log(1. / deltaR); }
+  /// @returns ln(kt), the vertical coordinate of the primary Lund plane
+  double lnKt() const { return std::log(kt); }
+};
+
+/**
+ * Result of the soft drop grooming
+ */
+struct SoftDropResult {
+  bool isGroomed = false; // whether a splitting passed the soft drop condition
+  double zg = -1.0;       // momentum fraction of the first splitting passing the condition
+  double rg = -1.0;       // opening angle of the first splitting passing the condition
+  double nsd = 0.0;       // number of splittings passing the condition
+};
+
+/**
+ * Reclusters the constituents of a jet with C/A and keeps its history for the substructure observables
+ */
+class JetDeclusterer
+{
+ public:
+  /**
+   * Reclusters the constituents and stores the primary declusterings
+   *
+   * @param constituents constituents of the jet
+   * @param followHFCandidate follow the branch with the HF candidate instead of the harder branch
+   */
+  void recluster(const std::vector<fastjet::PseudoJet>& constituents, bool followHFCandidate = false)
+  {
+    splittings.clear();
+    // the previous history is only released here, so that the reclustered jet stays valid between two reclusterings
+    clusterSeq = std::make_unique<fastjet::ClusterSequence>(constituents, fastjet::JetDefinition(fastjet::cambridge_algorithm, reclusteringR));
+    auto jets = fastjet::sorted_by_pt(clusterSeq->inclusive_jets());
+    if (jets.empty()) {
+      jetReclustered = fastjet::PseudoJet();
+      return;
+    }
+    jetReclustered = jets[0];
+
+    fastjet::PseudoJet daughterSubJet = jetReclustered;
+    fastjet::PseudoJet parentSubJet1;
+    fastjet::PseudoJet parentSubJet2;
+    while (daughterSubJet.has_parents(parentSubJet1, parentSubJet2)) {
+      if (parentSubJet1.perp() < parentSubJet2.perp()) {
+        std::swap(parentSubJet1, parentSubJet2);
+      }
+      auto deltaR = parentSubJet1.delta_R(parentSubJet2);
+      splittings.push_back({parentSubJet1.perp(), parentSubJet2.perp(), deltaR,
+                            parentSubJet2.perp() / (parentSubJet1.perp() + parentSubJet2.perp()), parentSubJet2.perp() * deltaR});
+      if (followHFCandidate && !containsHFCandidate(parentSubJet1)) {
+        daughterSubJet = parentSubJet2;
+      } else {
+        daughterSubJet = parentSubJet1;
+      }
+    }
+  }
+
+  /**
+   * Soft drop grooming of the primary declusterings, z >= zCut * (deltaR / jetR)^beta
+   *
+   * @param zCut soft drop z cut
+   * @param beta soft drop angular exponent
+   * @param jetR jet resolution parameter
+   */
+  SoftDropResult softDrop(double zCut, double beta, double jetR) const
+  {
+    SoftDropResult result;
+    for (const auto& splitting : splittings) {
+      if (splitting.z >= zCut * std::pow(splitting.deltaR / jetR, beta)) {
+        if (!result.isGroomed) {
+          result.zg = splitting.z;
+          result.rg = splitting.deltaR;
+          result.isGroomed = true;
+        }
+        result.nsd++;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Generalised angularity, sum over the constituents of (pT,i / pT,jet)^kappa * (deltaR_i / jetR)^alpha
+   *
+   * @param kappa momentum exponent
+   * @param alpha angular exponent
+   * @param jetR jet resolution parameter
+   */
+  double angularity(double kappa, double alpha, double jetR) const
+  {
+    if (!jetReclustered.has_constituents() || jetReclustered.perp() <= 0.) {
+      return -1.0;
+    }
+    double lambda = 0.;
+    for (const auto& constituent : jetReclustered.constituents()) {
+      lambda += std::pow(constituent.perp() / jetReclustered.perp(), kappa) * std::pow(constituent.delta_R(jetReclustered) / jetR, alpha);
+    }
+    return lambda;
+  }
+
+  /// @returns the primary declusterings of the last reclustered jet, from the widest to the narrowest
+  const std::vector<Splitting>& getSplittings() const { return splittings; }
+  /// @returns the last reclustered jet
+  const fastjet::PseudoJet& getJet() const { return jetReclustered; }
+
+  void setReclusteringR(double reclusteringR_out) { reclusteringR = reclusteringR_out; }
+  double getReclusteringR() const { return reclusteringR; }
+
+ private:
+  double reclusteringR = 2.0;                          // large enough for all the constituents of a jet to be reclustered together
+  std::unique_ptr<fastjet::ClusterSequence> clusterSeq; // history of the last reclustering
+  fastjet::PseudoJet jetReclustered;                    // last reclustered jet
+  std::vector<Splitting> splittings;                    // primary declusterings of the last reclustered jet
+
+  static bool containsHFCandidate(const fastjet::PseudoJet& subJet)
+  {
+    for (const auto& constituent : subJet.constituents()) {
+      if (constituent.user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::candidateHF)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+}; // namespace JetSubstructureUtilities
+
+#endif // PWGJE_CORE_JETSUBSTRUCTUREUTILITIES_H_
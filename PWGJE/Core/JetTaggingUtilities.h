@@ -18,6 +18,7 @@
 #define PWGJE_CORE_JETTAGGINGUTILITIES_H_
 
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <numeric>
 #include <tuple>
@@ -99,9 +100,10 @@ int getOriginalHFMotherIndex(const typename T::iterator& hfparticle)
  * @param jet
  * @param particles table of generator level particles to be searched through
  * @param hftrack track passed as reference which is then replaced by the first track that originated from an HF shower
+ * @param originCache optional cache of the HF origin of the generator level particles, indexed by their globalIndex (-1 if not evaluated yet), so that the particles shared by several jets are evaluated once
  */
 template <typename T, typename U, typename V>
-int jetTrackFromHFShower(T const& jet, U const& tracks, V const& particles, typename U::iterator& hftrack)
+int jetTrackFromHFShower(T const& jet, U const& tracks, V const& particles, typename U::iterator& hftrack, std::vector<int8_t>* originCache = nullptr)
 {
 
   bool hasMcParticle = false;
@@ -112,7 +114,15 @@ int jetTrackFromHFShower(T const& jet, U const& tracks, V const& particles, type
     }
     hasMcParticle = true;
     auto const& particle = track.template mcParticle_as<V>();
-    origin = RecoDecay::getCharmHadronOrigin(particles, particle, true);
+    if (originCache) {
+      auto& originCached = (*originCache)[particle.globalIndex()];
+      if (originCached < 0) {
+        originCached = RecoDecay::getCharmHadronOrigin(particles, particle, true);
+      }
+      origin = originCached;
+    } else {
+      origin = RecoDecay::getCharmHadronOrigin(particles, particle, true);
+    }
     if (origin == 1 || origin == 2) { // 1=charm , 2=beauty
       hftrack = track;
       if (origin == 1) {
@@ -163,14 +173,15 @@ int jetParticleFromHFShower(T const& jet, U const& particles, typename U::iterat
  * @param jet
  * @param particles table of generator level particles to be searched through
  * @param dRMax maximum distance in eta-phi of initiating heavy-flavour quark from the jet axis
+ * @param originCache optional cache of the HF origin of the generator level particles (see jetTrackFromHFShower)
  */
 
 template <typename T, typename U, typename V>
-int mcdJetFromHFShower(T const& jet, U const& tracks, V const& particles, float dRMax = 0.25)
+int mcdJetFromHFShower(T const& jet, U const& tracks, V const& particles, float dRMax = 0.25, std::vector<int8_t>* originCache = nullptr)
 {
 
   typename U::iterator hftrack;
-  int origin = jetTrackFromHFShower(jet, tracks, particles, hftrack);
+  int origin = jetTrackFromHFShower(jet, tracks, particles, hftrack, originCache);
   if (origin == JetTaggingSpecies::charm || origin == JetTaggingSpecies::beauty) {
     if (!hftrack.has_mcParticle()) {
       return JetTaggingSpecies::none;
@@ -18,10 +18,13 @@
 #ifndef PWGJE_CORE_JETUTILITIES_H_
 #define PWGJE_CORE_JETUTILITIES_H_
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <numeric>
+#include <stdexcept>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <TKDTree.h>
@@ -280,6 +283,252 @@ std::tuple<std::vector<int>, std::vector<int>> MatchJetsGeometrically(
   return std::make_tuple(baseToTagMap, tagToBaseMap);
 }
 
+/**
+ * Eta-phi grid of the jets (or clusters, tracks) of one collection, for neighbour searches.
+ *
+ * The cells are at least as wide as the search distance, so that the neighbours of a point are searched
+ * only in the 3x3 cells around it. If phi is periodic, the grid wraps around in phi and the phi distances
+ * are taken modulo 2pi, otherwise the plain differences are used as in the KD-tree based matching.
+ * The entries are stored sorted by cell, with the offsets of the cells in a separate vector. The buffers
+ * are kept when the grid is rebuilt, so that no memory is allocated once they have grown to the typical size.
+ *
+ * NOTE: The coordinates are not copied, so they must outlive the searches.
+ */
+template <typename T>
+class EtaPhiGrid
+{
+ public:
+  /**
+   * Builds the grid.
+   *
+   * @param phiIn Phi of the entries. Assumes, but does not validate, that 0 <= phi < 2pi if phi is periodic.
+   * @param etaIn Eta of the entries.
+   * @param cellSize Minimum cell size, i.e. the maximum search distance.
+   * @param isPhiPeriodicIn Whether phi is periodic.
+   */
+  void build(const std::vector<T>& phiIn, const std::vector<T>& etaIn, double cellSize, bool isPhiPeriodicIn)
+  {
+    phi = &phiIn;
+    eta = &etaIn;
+    isPhiPeriodic = isPhiPeriodicIn;
+    // Protect against a null search distance.
+    cellSize = std::max(cellSize, 1.e-3);
+    const std::size_t nEntries = eta->size();
+    if (nEntries == 0) {
+      nCellsEta = nCellsPhi = 1;
+      cellOffsets.assign(2, 0);
+      return;
+    }
+    etaMin = etaIn[0];
+    phiMin = phiIn[0];
+    double etaMax = etaIn[0], phiMax = phiIn[0];
+    for (std::size_t iEntry = 1; iEntry < nEntries; iEntry++) {
+      etaMin = std::min(etaMin, static_cast<double>(etaIn[iEntry]));
+      etaMax = std::max(etaMax, static_cast<double>(etaIn[iEntry]));
+      phiMin = std::min(phiMin, static_cast<double>(phiIn[iEntry]));
+      phiMax = std::max(phiMax, static_cast<double>(phiIn[iEntry]));
+    }
+    // The cells must not be narrower than the search distance, but their number is limited for very small distances.
+    if (isPhiPeriodic) {
+      phiMin = 0.;
+      nCellsPhi = std::max(1, std::min(maxCellsPerAxis, static_cast<int>(2 * M_PI / cellSize)));
+      cellSizePhi = 2 * M_PI / nCellsPhi;
+    } else {
+      cellSizePhi = std::max(cellSize, (phiMax - phiMin) / maxCellsPerAxis);
+      nCellsPhi = static_cast<int>((phiMax - phiMin) / cellSizePhi) + 1;
+    }
+    cellSizeEta = std::max(cellSize, (etaMax - etaMin) / maxCellsPerAxis);
+    nCellsEta = static_cast<int>((etaMax - etaMin) / cellSizeEta) + 1;
+
+    entryCells.resize(nEntries);
+    cellOffsets.assign(nCellsEta * nCellsPhi + 1, 0);
+    for (std::size_t iEntry = 0; iEntry < nEntries; iEntry++) {
+      entryCells[iEntry] = getCell(std::min(nCellsEta - 1, getCellEta(etaIn[iEntry])), std::min(nCellsPhi - 1, getCellPhi(phiIn[iEntry])));
+      cellOffsets[entryCells[iEntry] + 1]++;
+    }
+    for (std::size_t iCell = 1; iCell < cellOffsets.size(); iCell++) {
+      cellOffsets[iCell] += cellOffsets[iCell - 1];
+    }
+    cellFill.assign(cellOffsets.begin(), cellOffsets.end() - 1);
+    entryIndices.resize(nEntries);
+    for (std::size_t iEntry = 0; iEntry < nEntries; iEntry++) {
+      entryIndices[cellFill[entryCells[iEntry]]++] = iEntry;
+    }
+  }
+
+  /**
+   * @returns index of the entry closest to (phi, eta) if closer than maxDistance, -1 otherwise.
+   */
+  int findClosest(T phiPoint, T etaPoint, double maxDistance) const
+  {
+    int indexClosest = -1;
+    double distanceClosest = maxDistance;
+    forEachNeighbour(phiPoint, etaPoint, [&](int iEntry, double distance) {
+      if (distance < distanceClosest) {
+        distanceClosest = distance;
+        indexClosest = iEntry;
+      }
+    });
+    return indexClosest;
+  }
+
+  /**
+   * Finds the entries closest to (phi, eta) and closer than maxDistance, ordered by increasing distance.
+   *
+   * @param indices Indices of the found entries, filled up to maxNumber with -1.
+   */
+  void findClosest(T phiPoint, T etaPoint, double maxDistance, int maxNumber, std::vector<int>& indices)
+  {
+    neighbours.clear();
+    forEachNeighbour(phiPoint, etaPoint, [&](int iEntry, double distance) {
+      if (distance < maxDistance) {
+        neighbours.emplace_back(distance, iEntry);
+      }
+    });
+    const std::size_t nFound = std::min(neighbours.size(), static_cast<std::size_t>(std::max(0, maxNumber)));
+    std::partial_sort(neighbours.begin(), neighbours.begin() + nFound, neighbours.end());
+    indices.assign(std::max(0, maxNumber), -1);
+    for (std::size_t iFound = 0; iFound < nFound; iFound++) {
+      indices[iFound] = neighbours[iFound].second;
+    }
+  }
+
+ private:
+  static constexpr int maxCellsPerAxis = 100;
+
+  const std::vector<T>* phi = nullptr;            // phi of the entries
+  const std::vector<T>* eta = nullptr;            // eta of the entries
+  bool isPhiPeriodic = false;                     // whether phi is periodic
+  double etaMin = 0.;                             // lower edge of the grid in eta
+  double phiMin = 0.;                             // lower edge of the grid in phi
+  double cellSizeEta = 1.;                        // cell size in eta
+  double cellSizePhi = 2 * M_PI;                  // cell size in phi
+  int nCellsEta = 1;                              // number of cells in eta
+  int nCellsPhi = 1;                              // number of cells in phi
+  std::vector<int> entryCells;                    // cell of each entry
+  std::vector<int> cellOffsets;                   // offset of the first entry of each cell in entryIndices
+  std::vector<int> cellFill;                      // next free position of each cell while filling entryIndices
+  std::vector<int> entryIndices;                  // entry indices sorted by cell
+  std::vector<std::pair<double, int>> neighbours; // distances and indices of the neighbours found in a search
+
+  int getCell(int iEta, int iPhi) const { return iEta * nCellsPhi + iPhi; }
+  int getCellEta(double etaPoint) const { return static_cast<int>(std::floor((etaPoint - etaMin) / cellSizeEta)); }
+  int getCellPhi(double phiPoint) const
+  {
+    if (isPhiPeriodic) {
+      return std::min(nCellsPhi - 1, static_cast<int>(RecoDecay::constrainAngle(phiPoint, 0.) / cellSizePhi));
+    }
+    return static_cast<int>(std::floor((phiPoint - phiMin) / cellSizePhi));
+  }
+
+  /**
+   * Calls f(index, distance) for all the entries in the 3x3 cells around (phi, eta).
+   */
+  template <typename F>
+  void forEachNeighbour(T phiPoint, T etaPoint, F&& f) const
+  {
+    const int iEta = getCellEta(etaPoint);
+    const int iPhi = getCellPhi(phiPoint);
+    // With less than 3 cells in periodic phi, all of them are neighbours.
+    const bool allCellsPhi = isPhiPeriodic && nCellsPhi < 3;
+    const int iPhiFirst = allCellsPhi ? 0 : (isPhiPeriodic ? iPhi - 1 : std::max(0, iPhi - 1));
+    const int iPhiLast = allCellsPhi ? nCellsPhi - 1 : (isPhiPeriodic ? iPhi + 1 : std::min(nCellsPhi - 1, iPhi + 1));
+    for (int iEtaCell = std::max(0, iEta - 1); iEtaCell <= std::min(nCellsEta - 1, iEta + 1); iEtaCell++) {
+      for (int iPhiCell = iPhiFirst; iPhiCell <= iPhiLast; iPhiCell++) {
+        const int iCell = getCell(iEtaCell, (iPhiCell + nCellsPhi) % nCellsPhi);
+        for (int iPos = cellOffsets[iCell]; iPos < cellOffsets[iCell + 1]; iPos++) {
+          const int iEntry = entryIndices[iPos];
+          const double dEta = etaPoint - (*eta)[iEntry];
+          const double dPhi = isPhiPeriodic ? RecoDecay::constrainAngle(phiPoint - (*phi)[iEntry], -M_PI) : phiPoint - (*phi)[iEntry];
+          f(iEntry, std::sqrt(dEta * dEta + dPhi * dPhi));
+        }
+      }
+    }
+  }
+};
+
+/**
+ * Geometrical jet matching on an eta-phi grid.
+ *
+ * Same matching as `MatchJetsGeometrically` (jets are required to match uniquely within the maximum
+ * matching distance, with phi periodic), but the jets of each collection are indexed on an eta-phi grid
+ * with cells at least as wide as the matching distance. The closest jet is then searched only in the
+ * 3x3 cells around the jet, and phi wraps around the grid instead of duplicating the jets at the boundary.
+ * The grids and the intermediate index maps are kept between calls, so that no memory is allocated
+ * once the buffers have grown to the typical number of jets.
+ *
+ * NOTE: Assumes, but does not validate, that 0 <= phi < 2pi.
+ */
+template <typename T>
+class JetGeoMatcher
+{
+ public:
+  /**
+   * Geometrical jet matching.
+   *
+   * If no unique match was found for a jet, an index of -1 is stored.
+   *
+   * @param jetsBasePhi Base jet collection phi.
+   * @param jetsBaseEta Base jet collection eta.
+   * @param jetsTagPhi Tag jet collection phi.
+   * @param jetsTagEta Tag jet collection eta.
+   * @param maxMatchingDistance Maximum matching distance.
+   * @param baseToTagMap Base to tag index map for uniquely matched jets, resized to the number of base jets.
+   * @param tagToBaseMap Tag to base index map for uniquely matched jets, resized to the number of tag jets.
+   */
+  void match(const std::vector<T>& jetsBasePhi,
+             const std::vector<T>& jetsBaseEta,
+             const std::vector<T>& jetsTagPhi,
+             const std::vector<T>& jetsTagEta,
+             double maxMatchingDistance,
+             std::vector<int>& baseToTagMap,
+             std::vector<int>& tagToBaseMap)
+  {
+    // Validation
+    const std::size_t nJetsBase = jetsBaseEta.size();
+    const std::size_t nJetsTag = jetsTagEta.size();
+    baseToTagMap.assign(nJetsBase, -1);
+    tagToBaseMap.assign(nJetsTag, -1);
+    if (!(nJetsBase && nJetsTag) || maxMatchingDistance <= 0.) {
+      // There are no jets or no jet can be matched, so nothing to be done.
+      return;
+    }
+    if (jetsBasePhi.size() != jetsBaseEta.size()) {
+      throw std::invalid_argument("Base collection eta and phi sizes don't match. Check the inputs.");
+    }
+    if (jetsTagPhi.size() != jetsTagEta.size()) {
+      throw std::invalid_argument("Tag collection eta and phi sizes don't match. Check the inputs.");
+    }
+
+    gridBase.build(jetsBasePhi, jetsBaseEta, maxMatchingDistance, true);
+    gridTag.build(jetsTagPhi, jetsTagEta, maxMatchingDistance, true);
+
+    // Find the tag jet closest to each base jet and the base jet closest to each tag jet.
+    matchIndexTag.resize(nJetsBase);
+    for (std::size_t iBase = 0; iBase < nJetsBase; iBase++) {
+      matchIndexTag[iBase] = gridTag.findClosest(jetsBasePhi[iBase], jetsBaseEta[iBase], maxMatchingDistance);
+    }
+    matchIndexBase.resize(nJetsTag);
+    for (std::size_t iTag = 0; iTag < nJetsTag; iTag++) {
+      matchIndexBase[iTag] = gridBase.findClosest(jetsTagPhi[iTag], jetsTagEta[iTag], maxMatchingDistance);
+    }
+
+    // Keep the true matches, where the base jet is the closest to the tag jet and vice versa.
+    for (std::size_t iBase = 0; iBase < nJetsBase; iBase++) {
+      if (matchIndexTag[iBase] > -1 && matchIndexBase[matchIndexTag[iBase]] == static_cast<int>(iBase)) {
+        baseToTagMap[iBase] = matchIndexTag[iBase];
+        tagToBaseMap[matchIndexTag[iBase]] = iBase;
+      }
+    }
+  }
+
+ private:
+  EtaPhiGrid<T> gridBase;          // grid of the base jets
+  EtaPhiGrid<T> gridTag;           // grid of the tag jets
+  std::vector<int> matchIndexTag;  // closest tag jet of each base jet
+  std::vector<int> matchIndexBase; // closest base jet of each tag jet
+};
+
 /**
  * Match clusters and tracks.
  *
@@ -386,6 +635,76 @@ std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>> MatchCl
   return std::make_tuple(matchIndexTrack, matchIndexCluster);
 }
 
+/**
+ * Matching of clusters and tracks on eta-phi grids.
+ *
+ * Same matching as `MatchClustersAndTracks`, but the closest tracks (clusters) within the maximum matching
+ * distance are searched only in the 3x3 grid cells around each cluster (track) instead of in a KD-tree.
+ * The grids are kept between calls, so that no memory is allocated once they have grown to the typical size.
+ */
+template <typename T>
+class ClusterTrackMatcher
+{
+ public:
+  /**
+   * Match clusters and tracks.
+   *
+   * @param clusterPhi cluster collection phi.
+   * @param clusterEta cluster collection eta.
+   * @param trackPhi track collection phi.
+   * @param trackEta track collection eta.
+   * @param maxMatchingDistance Maximum matching distance.
+   * @param maxNumberMatches Maximum number of matches (e.g. 5 closest).
+   * @param clusterToTrackMap cluster to track index map, ordered by increasing distance and filled up with -1.
+   * @param trackToClusterMap track to cluster index map, ordered by increasing distance and filled up with -1.
+   */
+  void match(const std::vector<T>& clusterPhi,
+             const std::vector<T>& clusterEta,
+             const std::vector<T>& trackPhi,
+             const std::vector<T>& trackEta,
+             double maxMatchingDistance,
+             int maxNumberMatches,
+             std::vector<std::vector<int>>& clusterToTrackMap,
+             std::vector<std::vector<int>>& trackToClusterMap)
+  {
+    // Validation
+    const std::size_t nClusters = clusterEta.size();
+    const std::size_t nTracks = trackEta.size();
+    if (clusterPhi.size() != clusterEta.size()) {
+      throw std::invalid_argument("cluster collection eta and phi sizes don't match. Check the inputs.");
+    }
+    if (trackPhi.size() != trackEta.size()) {
+      throw std::invalid_argument("track collection eta and phi sizes don't match. Check the inputs.");
+    }
+    clusterToTrackMap.resize(nClusters);
+    trackToClusterMap.resize(nTracks);
+    if (!(nClusters && nTracks)) {
+      // There are no clusters or no tracks, so nothing to be matched.
+      for (auto& indices : clusterToTrackMap) {
+        indices.assign(maxNumberMatches, -1);
+      }
+      for (auto& indices : trackToClusterMap) {
+        indices.assign(maxNumberMatches, -1);
+      }
+      return;
+    }
+
+    gridCluster.build(clusterPhi, clusterEta, maxMatchingDistance, false);
+    gridTrack.build(trackPhi, trackEta, maxMatchingDistance, false);
+    // Find the tracks closest to each cluster and the clusters closest to each track.
+    for (std::size_t iCluster = 0; iCluster < nClusters; iCluster++) {
+      gridTrack.findClosest(clusterPhi[iCluster], clusterEta[iCluster], maxMatchingDistance, maxNumberMatches, clusterToTrackMap[iCluster]);
+    }
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      gridCluster.findClosest(trackPhi[iTrack], trackEta[iTrack], maxMatchingDistance, maxNumberMatches, trackToClusterMap[iTrack]);
+    }
+  }
+
+ private:
+  EtaPhiGrid<T> gridCluster; // grid of the clusters
+  EtaPhiGrid<T> gridTrack;   // grid of the tracks
+};
+
 template <typename T, typename U>
 float deltaR(T const& A, U const& B)
 {
@@ -0,0 +1,205 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file jetFinderBenchmark.cxx
+/// \brief Executable benchmarking JetFinder::findJets for the jet finding configurations
+///
+/// The same events (synthetic Pb-Pb-like events from a fixed seed, or events read from a text file with one
+/// "pt eta phi" particle per line and a blank line between events) are clustered with each configuration
+/// (jet type, algorithm, area type, ghost area). For each configuration the events per second, the time split
+/// between ghosting, clustering and selection and the peak memory are printed, together with the number of jets
+/// and their summed pT, which must not change between two versions of FastJet or of the wrapper.
+///
+/// Usage: o2-analysis-jet-finder-benchmark [-n nEvents] [-m nParticles] [-s seed] [-r jetR] [-i inputFile]
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fastjet/ClusterSequence.hh"
+
+#include "PWGJE/Core/JetFinder.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+using Event = std::vector<fastjet::PseudoJet>;
+
+constexpr double massPion = 0.13957;
+
+/// Synthetic event with a thermal-like exponential spectrum and a power-law tail, flat in eta and phi
+/// \param nParticles number of particles of the event
+/// \param jetType charged (pion mass), neutral (massless) or full (70% charged) particles
+Event generateEvent(std::mt19937& generator, int nParticles, JetType jetType)
+{
+  std::uniform_real_distribution<double> distEta(-0.9, 0.9);
+  std::uniform_real_distribution<double> distPhi(0., 2. * M_PI);
+  std::uniform_real_distribution<double> distUniform(0., 1.);
+  std::exponential_distribution<double> distPtSoft(1. / 0.5);
+  Event event;
+  event.reserve(nParticles);
+  for (int iParticle = 0; iParticle < nParticles; iParticle++) {
+    // 1% of the particles from a pT^-5 spectrum above 2 GeV/c
+    double pt = distUniform(generator) < 0.01 ? 2. * std::pow(1. - distUniform(generator), -1. / 4.) : 0.15 + distPtSoft(generator);
+    double eta = distEta(generator);
+    double phi = distPhi(generator);
+    bool isCharged = jetType == JetType::charged || (jetType == JetType::full && distUniform(generator) < 0.7);
+    double mass = isCharged ? massPion : 0.;
+    double pz = pt * std::sinh(eta);
+    fastjet::PseudoJet particle(pt * std::cos(phi), pt * std::sin(phi), pz, std::sqrt(pt * pt + pz * pz + mass * mass));
+    particle.set_user_index(iParticle);
+    event.push_back(particle);
+  }
+  return event;
+}
+
+/// Reads the events of a text file, with one "pt eta phi" particle per line and a blank line between events
+std::vector<Event> readEvents(const std::string& fileName)
+{
+  std::vector<Event> events(1);
+  std::ifstream file(fileName);
+  if (!file.is_open()) {
+    std::fprintf(stderr, "Cannot open the input file %s\n", fileName.data());
+    std::exit(1);
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream stream(line);
+    double pt, eta, phi;
+    if (!(stream >> pt >> eta >> phi)) {
+      if (!events.back().empty()) {
+        events.emplace_back();
+      }
+      continue;
+    }
+    double pz = pt * std::sinh(eta);
+    fastjet::PseudoJet particle(pt * std::cos(phi), pt * std::sin(phi), pz, std::sqrt(pt * pt + pz * pz + massPion * massPion));
+    particle.set_user_index(events.back().size());
+    events.back().push_back(particle);
+  }
+  if (events.back().empty()) {
+    events.pop_back();
+  }
+  return events;
+}
+
+double getPeakMemoryMB()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.;
+}
+
+double getSeconds(Clock::duration duration) { return std::chrono::duration<double>(duration).count(); }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  int nEvents = 100;
+  int nParticles = 2000;
+  unsigned int seed = 12345;
+  float jetR = 0.4;
+  std::string inputFileName;
+  for (int iArg = 1; iArg + 1 < argc; iArg += 2) {
+    std::string option(argv[iArg]);
+    if (option == "-n") {
+      nEvents = std::atoi(argv[iArg + 1]);
+    } else if (option == "-m") {
+      nParticles = std::atoi(argv[iArg + 1]);
+    } else if (option == "-s") {
+      seed = std::strtoul(argv[iArg + 1], nullptr, 10);
+    } else if (option == "-r") {
+      jetR = std::atof(argv[iArg + 1]);
+    } else if (option == "-i") {
+      inputFileName = argv[iArg + 1];
+    } else {
+      std::fprintf(stderr, "Usage: %s [-n nEvents] [-m nParticles] [-s seed] [-r jetR] [-i inputFile]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  const std::vector<std::pair<const char*, JetType>> jetTypes = {{"charged", JetType::charged}, {"neutral", JetType::neutral}, {"full", JetType::full}};
+  const std::vector<std::pair<const char*, fastjet::JetAlgorithm>> algorithms = {{"kt", fastjet::kt_algorithm}, {"C/A", fastjet::cambridge_algorithm}, {"anti-kt", fastjet::antikt_algorithm}};
+  const std::vector<std::pair<const char*, fastjet::AreaType>> areaTypes = {{"active", fastjet::active_area}, {"active_explicit_ghosts", fastjet::active_area_explicit_ghosts}, {"passive", fastjet::passive_area}};
+  const std::vector<float> ghostAreas = {0.005, 0.01, 0.05};
+
+  std::printf("%-8s %-8s %-23s %-6s %10s %9s %9s %9s %10s %8s %12s\n",
+              "type", "algo", "area type", "ghost", "events/s", "ghost(s)", "clust(s)", "sel(s)", "peak(MB)", "nJets", "sum pT");
+  for (const auto& [jetTypeName, jetType] : jetTypes) {
+    // the same events are used for all the configurations of a jet type; the recorded events are used as they are
+    std::vector<Event> events;
+    if (inputFileName.empty()) {
+      std::mt19937 generator(seed);
+      for (int iEvent = 0; iEvent < nEvents; iEvent++) {
+        events.push_back(generateEvent(generator, nParticles, jetType));
+      }
+    } else {
+      if (jetType != JetType::charged) {
+        continue;
+      }
+      events = readEvents(inputFileName);
+    }
+
+    for (const auto& [algorithmName, algorithm] : algorithms) {
+      for (const auto& [areaTypeName, areaType] : areaTypes) {
+        for (const auto& ghostArea : ghostAreas) {
+          JetFinder jetFinder;
+          jetFinder.jetR = jetR;
+          jetFinder.jetEtaMin = -0.9 + jetR;
+          jetFinder.jetEtaMax = 0.9 - jetR;
+          jetFinder.algorithm = algorithm;
+          jetFinder.areaType = areaType;
+          jetFinder.ghostArea = ghostArea;
+
+          Clock::duration timeTotal{}, timeClustering{}, timeSelection{};
+          std::size_t nJets = 0;
+          double sumPt = 0.;
+          std::vector<fastjet::PseudoJet> jets;
+          for (auto& event : events) {
+            auto start = Clock::now();
+            {
+              fastjet::ClusterSequenceArea clusterSeq(jetFinder.findJets(event, jets));
+              nJets += jets.size();
+              for (const auto& jet : jets) {
+                sumPt += jet.pt();
+              }
+            }
+            timeTotal += Clock::now() - start;
+
+            // clustering of the same event without ghosts and selection of its jets, to split the time of findJets
+            start = Clock::now();
+            fastjet::ClusterSequence clusterSeqNoGhosts(event, jetFinder.jetDef);
+            auto jetsNoGhosts = clusterSeqNoGhosts.inclusive_jets();
+            auto startSelection = Clock::now();
+            timeClustering += startSelection - start;
+            jetsNoGhosts = fastjet::sorted_by_pt(jetFinder.selJets(jetsNoGhosts));
+            timeSelection += Clock::now() - startSelection;
+          }
+          double timeGhosting = std::max(0., getSeconds(timeTotal - timeClustering - timeSelection));
+          std::printf("%-8s %-8s %-23s %-6.3f %10.1f %9.3f %9.3f %9.3f %10.1f %8zu %12.4f\n",
+                      jetTypeName, algorithmName, areaTypeName, ghostArea, events.size() / getSeconds(timeTotal),
+                      timeGhosting, getSeconds(timeClustering), getSeconds(timeSelection), getPeakMemoryMB(), nJets, sumPt);
+        }
+      }
+    }
+  }
+  return 0;
+}
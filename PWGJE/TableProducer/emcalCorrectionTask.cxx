@@ -97,8 +97,17 @@ struct EmcalCorrectionTask {
   std::vector<std::unique_ptr<o2::emcal::Clusterizer<o2::emcal::Cell>>> mClusterizers;
   o2::emcal::ClusterFactory<o2::emcal::Cell> mClusterFactories;
   o2::emcal::NonlinearityHandler mNonlinearityHandler;
-  // Cells and clusters
+  // Cells and clusters, the cell buffers are reused for all the BCs
+  std::vector<o2::emcal::Cell> mCellsBC;
+  std::vector<int64_t> mCellIndicesBC;
   std::vector<o2::emcal::AnalysisCluster> mAnalysisClusters;
+  // Track matching, the track info is filled once per collision and shared by all the clusterizers
+  JetUtilities::ClusterTrackMatcher<double> mClusterTrackMatcher;
+  int64_t mTrackInfoCollisionId = -1;
+  std::vector<double> mTrackPhi, mTrackEta;
+  std::vector<int64_t> mTrackGlobalIndex;
+  std::vector<double> mClusterPhi, mClusterEta;
+  std::vector<std::vector<int>> mClusterToTrackIndexMap, mTrackToClusterIndexMap;
 
   std::vector<o2::aod::EMCALClusterDefinition> mClusterDefinitions;
   // QA
@@ -217,6 +226,7 @@ struct EmcalCorrectionTask {
   void processFull(bcEvSels const& bcs, collEventSels const& collisions, myGlobTracks const& tracks, filteredCells const& cells)
   {
     LOG(debug) << "Starting process full.";
+    mTrackInfoCollisionId = -1;
 
     int nBCsProcessed = 0;
     int nCellsProcessed = 0;
@@ -239,8 +249,10 @@ struct EmcalCorrectionTask {
       }
       // Counters for BCs with matched collisions
       countBC(collisionsInFoundBC.size(), true);
-      std::vector<o2::emcal::Cell> cellsBC;
-      std::vector<int64_t> cellIndicesBC;
+      auto& cellsBC = mCellsBC;
+      auto& cellIndicesBC = mCellIndicesBC;
+      cellsBC.clear();
+      cellIndicesBC.clear();
       for (auto& cell : cellsInBC) {
         auto amplitude = cell.amplitude();
         if (static_cast<bool>(hasShaperCorrection)) {
@@ -278,15 +290,11 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertex_pos = {col.posX(), col.posY(), col.posZ()};
 
-              std::vector<std::vector<int>> clusterToTrackIndexMap;
-              std::vector<std::vector<int>> trackToClusterIndexMap;
-              std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>> IndexMapPair{clusterToTrackIndexMap, trackToClusterIndexMap};
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<collEventSels::filtered_iterator>(col, tracks, IndexMapPair, vertex_pos, trackGlobalIndex);
+              doTrackMatching<collEventSels::filtered_iterator>(col, tracks, vertex_pos);
 
               // Store the clusters in the table where a matching collision could
               // be identified.
-              FillClusterTable<collEventSels::filtered_iterator>(col, vertex_pos, iClusterizer, cellIndicesBC, IndexMapPair, trackGlobalIndex);
+              FillClusterTable<collEventSels::filtered_iterator>(col, vertex_pos, iClusterizer, cellIndicesBC, true);
             }
           }
         } else { // ambiguous
@@ -326,6 +334,7 @@ struct EmcalCorrectionTask {
   void processMCFull(bcEvSels const& bcs, collEventSels const& collisions, myGlobTracks const& tracks, filteredMCCells const& cells, aod::StoredMcParticles_001 const& mcparticles)
   {
     LOG(debug) << "Starting process full.";
+    mTrackInfoCollisionId = -1;
 
     int nBCsProcessed = 0;
     int nCellsProcessed = 0;
@@ -345,8 +354,10 @@ struct EmcalCorrectionTask {
       }
       // Counters for BCs with matched collisions
       countBC(collisionsInFoundBC.size(), true);
-      std::vector<o2::emcal::Cell> cellsBC;
-      std::vector<int64_t> cellIndicesBC;
+      auto& cellsBC = mCellsBC;
+      auto& cellIndicesBC = mCellIndicesBC;
+      cellsBC.clear();
+      cellIndicesBC.clear();
       for (auto& cell : cellsInBC) {
         mHistManager.fill(HIST("hContributors"), cell.mcParticle().size());
         auto cellParticles = cell.mcParticle_as<aod::StoredMcParticles_001>();
@@ -389,15 +400,11 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertex_pos = {col.posX(), col.posY(), col.posZ()};
 
-              std::vector<std::vector<int>> clusterToTrackIndexMap;
-              std::vector<std::vector<int>> trackToClusterIndexMap;
-              std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>> IndexMapPair{clusterToTrackIndexMap, trackToClusterIndexMap};
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<collEventSels::filtered_iterator>(col, tracks, IndexMapPair, vertex_pos, trackGlobalIndex);
+              doTrackMatching<collEventSels::filtered_iterator>(col, tracks, vertex_pos);
 
               // Store the clusters in the table where a matching collision could
               // be identified.
-              FillClusterTable<collEventSels::filtered_iterator>(col, vertex_pos, iClusterizer, cellIndicesBC, IndexMapPair, trackGlobalIndex);
+              FillClusterTable<collEventSels::filtered_iterator>(col, vertex_pos, iClusterizer, cellIndicesBC, true);
             }
           }
         } else { // ambiguous
@@ -443,8 +450,10 @@ struct EmcalCorrectionTask {
       }
       // Counters for BCs with matched collisions
       countBC(collisionsInBC.size(), true);
-      std::vector<o2::emcal::Cell> cellsBC;
-      std::vector<int64_t> cellIndicesBC;
+      auto& cellsBC = mCellsBC;
+      auto& cellIndicesBC = mCellIndicesBC;
+      cellsBC.clear();
+      cellIndicesBC.clear();
       for (auto& cell : cellsInBC) {
         cellsBC.emplace_back(cell.cellNumber(),
                              cell.amplitude(),
@@ -532,7 +541,7 @@ struct EmcalCorrectionTask {
   }
 
   template <typename Collision>
-  void FillClusterTable(Collision const& col, math_utils::Point3D<float> const& vertex_pos, size_t iClusterizer, const gsl::span<int64_t> cellIndicesBC, std::optional<std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>>> const& IndexMapPair = std::nullopt, std::optional<std::vector<int64_t>> const& trackGlobalIndex = std::nullopt)
+  void FillClusterTable(Collision const& col, math_utils::Point3D<float> const& vertex_pos, size_t iClusterizer, const gsl::span<int64_t> cellIndicesBC, bool hasTrackMatching = false)
   {
     // we found a collision, put the clusters into the none ambiguous table
     clusters.reserve(mAnalysisClusters.size());
@@ -577,11 +586,11 @@ struct EmcalCorrectionTask {
       // fill histograms
       mHistManager.fill(HIST("hClusterE"), cluster.E());
       mHistManager.fill(HIST("hClusterEtaPhi"), pos.Eta(), TVector2::Phi_0_2pi(pos.Phi()));
-      if (IndexMapPair && trackGlobalIndex) {
-        for (unsigned int iTrack = 0; iTrack < std::get<0>(*IndexMapPair)[iCluster].size(); iTrack++) {
-          if (std::get<0>(*IndexMapPair)[iCluster][iTrack] >= 0) {
-            LOG(debug) << "Found track " << (*trackGlobalIndex)[std::get<0>(*IndexMapPair)[iCluster][iTrack]] << " in cluster " << cluster.getID();
-            matchedTracks(clusters.lastIndex(), (*trackGlobalIndex)[std::get<0>(*IndexMapPair)[iCluster][iTrack]]);
+      if (hasTrackMatching) {
+        for (const auto& iTrack : mClusterToTrackIndexMap[iCluster]) {
+          if (iTrack >= 0) {
+            LOG(debug) << "Found track " << mTrackGlobalIndex[iTrack] << " in cluster " << cluster.getID();
+            matchedTracks(clusters.lastIndex(), mTrackGlobalIndex[iTrack]);
           }
         }
       }
@@ -632,24 +641,20 @@ struct EmcalCorrectionTask {
   }
 
   template <typename Collision>
-  void doTrackMatching(Collision const& col, myGlobTracks const& tracks, std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>>& IndexMapPair, math_utils::Point3D<float>& vertex_pos, std::vector<int64_t>& trackGlobalIndex)
+  void doTrackMatching(Collision const& col, myGlobTracks const& tracks, math_utils::Point3D<float>& vertex_pos)
   {
-    auto groupedTracks = tracks.sliceBy(perCollision, col.globalIndex());
-    int NTracksInCol = groupedTracks.size();
-    std::vector<double> trackPhi;
-    std::vector<double> trackEta;
-    // reserve memory to reduce on the fly memory allocation
-    trackPhi.reserve(NTracksInCol);
-    trackEta.reserve(NTracksInCol);
-    trackGlobalIndex.reserve(NTracksInCol);
-    FillTrackInfo<decltype(groupedTracks)>(groupedTracks, trackPhi, trackEta, trackGlobalIndex);
-
-    int NClusterInCol = mAnalysisClusters.size();
-    std::vector<double> clusterPhi;
-    std::vector<double> clusterEta;
-    clusterPhi.reserve(NClusterInCol);
-    clusterEta.reserve(NClusterInCol);
+    // The tracks of the collision do not depend on the clusterizer, so they are only filled for the first one.
+    if (col.globalIndex() != mTrackInfoCollisionId) {
+      auto groupedTracks = tracks.sliceBy(perCollision, col.globalIndex());
+      mTrackPhi.clear();
+      mTrackEta.clear();
+      mTrackGlobalIndex.clear();
+      FillTrackInfo<decltype(groupedTracks)>(groupedTracks, mTrackPhi, mTrackEta, mTrackGlobalIndex);
+      mTrackInfoCollisionId = col.globalIndex();
+    }
 
+    mClusterPhi.clear();
+    mClusterEta.clear();
     // TODO one loop that could in principle be combined with the other
     // loop to improve performance
     for (const auto& cluster : mAnalysisClusters) {
@@ -659,13 +664,12 @@ struct EmcalCorrectionTask {
       pos = pos - vertex_pos;
       // Normalize the vector and rescale by energy.
       pos *= (cluster.E() / std::sqrt(pos.Mag2()));
-      clusterPhi.emplace_back(TVector2::Phi_0_2pi(pos.Phi()));
-      clusterEta.emplace_back(pos.Eta());
+      mClusterPhi.emplace_back(TVector2::Phi_0_2pi(pos.Phi()));
+      mClusterEta.emplace_back(pos.Eta());
     }
-    IndexMapPair =
-      JetUtilities::MatchClustersAndTracks(clusterPhi, clusterEta,
-                                           trackPhi, trackEta,
-                                           maxMatchingDistance, 20);
+    mClusterTrackMatcher.match(mClusterPhi, mClusterEta, mTrackPhi, mTrackEta,
+                               maxMatchingDistance, 20,
+                               mClusterToTrackIndexMap, mTrackToClusterIndexMap);
   }
 
   template <typename Tracks>
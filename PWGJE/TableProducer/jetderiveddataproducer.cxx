@@ -66,78 +66,100 @@ struct JetDerivedDataProducerTask {
   {
   }
 
-  void processBunchCossings(soa::Join<aod::BCs, aod::Timestamps>::iterator const& bc)
+  std::vector<int> mothersId; // mother indices of the current particle, reused between particles
+
+  void processBunchCossings(soa::Join<aod::BCs, aod::Timestamps> const& bcs)
   {
-    jBCsTable(bc.runNumber(), bc.globalBC(), bc.timestamp());
-    jBCParentIndexTable(bc.globalIndex());
+    jBCsTable.reserve(bcs.size());
+    jBCParentIndexTable.reserve(bcs.size());
+    for (const auto& bc : bcs) {
+      jBCsTable(bc.runNumber(), bc.globalBC(), bc.timestamp());
+      jBCParentIndexTable(bc.globalIndex());
+    }
   }
   PROCESS_SWITCH(JetDerivedDataProducerTask, processBunchCossings, "produces derived bunch crossing table", false);
 
-  void processCollisions(soa::Join<aod::Collisions, aod::EvSels>::iterator const& collision)
+  void processCollisions(soa::Join<aod::Collisions, aod::EvSels> const& collisions)
   {
-    jCollisionsTable(collision.posZ(), JetDerivedDataUtilities::setEventSelectionBit(collision), collision.alias_raw());
-    jCollisionsParentIndexTable(collision.globalIndex());
-    jCollisionsBunchCrossingIndexTable(collision.bcId());
+    jCollisionsTable.reserve(collisions.size());
+    jCollisionsParentIndexTable.reserve(collisions.size());
+    jCollisionsBunchCrossingIndexTable.reserve(collisions.size());
+    for (const auto& collision : collisions) {
+      jCollisionsTable(collision.posZ(), JetDerivedDataUtilities::setEventSelectionBit(collision), collision.alias_raw());
+      jCollisionsParentIndexTable(collision.globalIndex());
+      jCollisionsBunchCrossingIndexTable(collision.bcId());
+    }
   }
   PROCESS_SWITCH(JetDerivedDataProducerTask, processCollisions, "produces derived collision tables", true);
 
-  void processMcCollisionLabels(soa::Join<aod::Collisions, aod::McCollisionLabels>::iterator const& collision)
+  void processMcCollisionLabels(soa::Join<aod::Collisions, aod::McCollisionLabels> const& collisions)
   {
-
-    if (collision.has_mcCollision()) {
-      jMcCollisionsLabelTable(collision.mcCollisionId());
-    } else {
-      jMcCollisionsLabelTable(-1);
+    jMcCollisionsLabelTable.reserve(collisions.size());
+    for (const auto& collision : collisions) {
+      if (collision.has_mcCollision()) {
+        jMcCollisionsLabelTable(collision.mcCollisionId());
+      } else {
+        jMcCollisionsLabelTable(-1);
+      }
     }
   }
   PROCESS_SWITCH(JetDerivedDataProducerTask, processMcCollisionLabels, "produces derived MC collision labels table", false);
 
-  void processMcCollisions(aod::McCollision const& McCollision)
+  void processMcCollisions(aod::McCollisions const& mcCollisions)
   {
-    jMcCollisionsTable(McCollision.posZ(), McCollision.weight());
-    jMcCollisionsParentIndexTable(McCollision.globalIndex());
+    jMcCollisionsTable.reserve(mcCollisions.size());
+    jMcCollisionsParentIndexTable.reserve(mcCollisions.size());
+    for (const auto& mcCollision : mcCollisions) {
+      jMcCollisionsTable(mcCollision.posZ(), mcCollision.weight());
+      jMcCollisionsParentIndexTable(mcCollision.globalIndex());
+    }
   }
   PROCESS_SWITCH(JetDerivedDataProducerTask, processMcCollisions, "produces derived MC collision table", false);
 
-  void processTracks(soa::Join<aod::Tracks, aod::TrackSelection>::iterator const& track)
+  void processTracks(soa::Join<aod::Tracks, aod::TrackSelection> const& tracks)
   {
-    jTracksTable(track.collisionId(), track.pt(), track.eta(), track.phi(), JetDerivedDataUtilities::trackEnergy(track), track.sign(), JetDerivedDataUtilities::setTrackSelectionBit(track));
-    jTracksParentIndexTable(track.globalIndex());
+    jTracksTable.reserve(tracks.size());
+    jTracksParentIndexTable.reserve(tracks.size());
+    for (const auto& track : tracks) {
+      jTracksTable(track.collisionId(), track.pt(), track.eta(), track.phi(), JetDerivedDataUtilities::trackEnergy(track), track.sign(), JetDerivedDataUtilities::setTrackSelectionBit(track));
+      jTracksParentIndexTable(track.globalIndex());
+    }
   }
   PROCESS_SWITCH(JetDerivedDataProducerTask, processTracks, "produces derived track table", true);
 
-  void processMcTrackLabels(soa::Join<aod::Tracks, aod::McTrackLabels>::iterator const& track)
+  void processMcTrackLabels(soa::Join<aod::Tracks, aod::McTrackLabels> const& tracks)
   {
-    if (track.has_mcParticle()) {
-      jMcTracksLabelTable(track.mcParticleId());
-    } else {
-      jMcTracksLabelTable(-1);
+    jMcTracksLabelTable.reserve(tracks.size());
+    for (const auto& track : tracks) {
+      if (track.has_mcParticle()) {
+        jMcTracksLabelTable(track.mcParticleId());
+      } else {
+        jMcTracksLabelTable(-1);
+      }
     }
   }
   PROCESS_SWITCH(JetDerivedDataProducerTask, processMcTrackLabels, "produces derived track labels table", false);
 
-  void processParticles(aod::McParticle const& particle)
+  void processParticles(aod::McParticles const& particles)
   {
-    std::vector<int> mothersId;
-    if (particle.has_mothers()) {
-      auto mothersIdTemps = particle.mothersIds();
-      for (auto mothersIdTemp : mothersIdTemps) {
-        mothersId.push_back(mothersIdTemp);
+    jMcParticlesTable.reserve(particles.size());
+    jParticlesParentIndexTable.reserve(particles.size());
+    for (const auto& particle : particles) {
+      mothersId.clear();
+      if (particle.has_mothers()) {
+        auto mothersIdTemps = particle.mothersIds();
+        mothersId.assign(mothersIdTemps.begin(), mothersIdTemps.end());
       }
-    }
-    int daughtersId[2] = {-1, -1};
-    auto i = 0;
-    if (particle.has_daughters()) {
-      for (auto daughterId : particle.daughtersIds()) {
-        if (i > 1) {
-          break;
+      int daughtersId[2] = {-1, -1};
+      if (particle.has_daughters()) {
+        auto daughtersIdTemps = particle.daughtersIds();
+        for (std::size_t i = 0; i < 2 && i < daughtersIdTemps.size(); i++) {
+          daughtersId[i] = daughtersIdTemps[i];
         }
-        daughtersId[i] = daughterId;
-        i++;
       }
+      jMcParticlesTable(particle.mcCollisionId(), particle.pt(), particle.eta(), particle.phi(), particle.y(), particle.e(), particle.pdgCode(), particle.getGenStatusCode(), particle.getHepMCStatusCode(), particle.isPhysicalPrimary(), mothersId, daughtersId);
+      jParticlesParentIndexTable(particle.globalIndex());
     }
-    jMcParticlesTable(particle.mcCollisionId(), particle.pt(), particle.eta(), particle.phi(), particle.y(), particle.e(), particle.pdgCode(), particle.getGenStatusCode(), particle.getHepMCStatusCode(), particle.isPhysicalPrimary(), mothersId, daughtersId);
-    jParticlesParentIndexTable(particle.globalIndex());
   }
   PROCESS_SWITCH(JetDerivedDataProducerTask, processParticles, "produces derived parrticle table", false);
 
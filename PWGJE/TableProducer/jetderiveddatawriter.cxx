@@ -64,10 +64,18 @@ struct JetDerivedDataWriter {
   Preslice<soa::Join<aod::JTracks, aod::JTrackPIs, aod::JMcTrackLbs>> TracksPerCollision = aod::jtrack::collisionId;
   Preslice<soa::Join<aod::JClusters, aod::JClusterPIs, aod::JClusterTracks>> ClustersPerCollision = aod::jcluster::collisionId;
 
+  // selection bitmaps of the (MC) collisions, filled by the jet selections
   std::vector<bool> collisionFlag;
   std::vector<bool> McCollisionFlag;
-  std::vector<int> bcIndicies;
-  std::map<int32_t, int32_t> bcMapping;
+  // index maps from the input tables to the stored tables, -1 if the row is not stored (yet)
+  std::vector<int32_t> bcMapping;
+  std::vector<int32_t> particleMapping;
+  std::vector<int32_t> mcCollisionMapping;
+  // the tracks of a collision are contiguous, so their stored indices follow from the first one
+  int64_t trackIndexFirst = 0;
+  int32_t storedTrackIndexFirst = 0;
+  int32_t nStoredTracks = 0;
+  std::vector<int> clusterStoredJTrackIDs;
 
   bool acceptCollision(aod::JCollision const& collision)
   {
@@ -76,14 +84,14 @@ struct JetDerivedDataWriter {
 
   void processCollisions(aod::JCollisions const& collisions)
   {
-    collisionFlag.reserve(collisions.size());
-    std::fill(collisionFlag.begin(), collisionFlag.end(), false);
+    collisionFlag.assign(collisions.size(), false);
+    // the BC indices are only valid within the data frame
+    bcMapping.clear();
   }
 
   void processMcCollisions(aod::JMcCollisions const& Mccollisions)
   {
-    McCollisionFlag.reserve(Mccollisions.size());
-    std::fill(McCollisionFlag.begin(), McCollisionFlag.end(), false);
+    McCollisionFlag.assign(Mccollisions.size(), false);
   }
 
   template <typename T>
@@ -129,6 +137,48 @@ struct JetDerivedDataWriter {
   PROCESS_SWITCH_JKL(JetDerivedDataWriter, processJets<aod::D0ChargedJets>, processD0ChargedJets, "process D0 charged jets", false);
   PROCESS_SWITCH_JKL(JetDerivedDataWriter, processJets<aod::LcChargedJets>, processLcChargedJets, "process Lc charged jets", false);
 
+  template <typename T, typename U>
+  int32_t storeBC(T const& bc, U const& bcs)
+  {
+    if (bcMapping.empty()) {
+      bcMapping.assign(bcs.size(), -1);
+    }
+    if (bcMapping[bc.globalIndex()] < 0) {
+      storedJBCsTable(bc.runNumber(), bc.globalBC(), bc.timestamp());
+      storedJBCParentIndexTable(bc.bcId());
+      bcMapping[bc.globalIndex()] = storedJBCsTable.lastIndex();
+    }
+    return bcMapping[bc.globalIndex()];
+  }
+
+  int32_t getStoredTrackIndex(int64_t trackIndex) const
+  {
+    if (trackIndex < trackIndexFirst || trackIndex >= trackIndexFirst + nStoredTracks) {
+      return -1;
+    }
+    return storedTrackIndexFirst + static_cast<int32_t>(trackIndex - trackIndexFirst);
+  }
+
+  template <typename T>
+  void storeClusters(T const& clusters)
+  {
+    for (const auto& cluster : clusters) {
+      storedJClustersTable(storedJCollisionsTable.lastIndex(), cluster.id(), cluster.energy(), cluster.coreEnergy(), cluster.rawEnergy(),
+                           cluster.eta(), cluster.phi(), cluster.m02(), cluster.m20(), cluster.nCells(), cluster.time(), cluster.isExotic(), cluster.distanceToBadChannel(),
+                           cluster.nlm(), cluster.definition(), cluster.leadingCellEnergy(), cluster.subleadingCellEnergy(), cluster.leadingCellNumber(), cluster.subleadingCellNumber());
+      storedJClustersParentIndexTable(cluster.clusterId());
+
+      clusterStoredJTrackIDs.clear();
+      for (const auto& clusterTrackId : cluster.matchedTracksIds()) {
+        auto storedTrackIndex = getStoredTrackIndex(clusterTrackId);
+        if (storedTrackIndex >= 0) {
+          clusterStoredJTrackIDs.push_back(storedTrackIndex);
+        }
+      }
+      storedJClustersMatchedTracksTable(clusterStoredJTrackIDs);
+    }
+  }
+
   void processDummy(aod::JDummys const& Dummys)
   {
     storedJDummysTable(1);
@@ -137,50 +187,26 @@ struct JetDerivedDataWriter {
 
   void processData(soa::Join<aod::JCollisions, aod::JCollisionPIs, aod::JCollisionBCs, aod::JChTrigSels, aod::JFullTrigSels>::iterator const& collision, soa::Join<aod::JBCs, aod::JBCPIs> const& bcs, soa::Join<aod::JTracks, aod::JTrackPIs> const& tracks, soa::Join<aod::JClusters, aod::JClusterPIs, aod::JClusterTracks> const& clusters)
   {
-    std::map<int32_t, int32_t> trackMapping;
-
     if (collisionFlag[collision.globalIndex()]) {
 
       auto bc = collision.bc_as<soa::Join<aod::JBCs, aod::JBCPIs>>();
-      if (std::find(bcIndicies.begin(), bcIndicies.end(), bc.globalIndex()) == bcIndicies.end()) {
-        storedJBCsTable(bc.runNumber(), bc.globalBC(), bc.timestamp());
-        storedJBCParentIndexTable(bc.bcId());
-        bcIndicies.push_back(bc.globalIndex());
-        bcMapping.insert(std::make_pair(bc.globalIndex(), storedJBCsTable.lastIndex()));
-      }
+      int32_t storedBCID = storeBC(bc, bcs);
 
       storedJCollisionsTable(collision.posZ(), collision.eventSel(), collision.alias_raw());
       storedJCollisionsParentIndexTable(collision.collisionId());
-      int32_t storedBCID = -1;
-      auto JBCIndex = bcMapping.find(collision.bcId());
-      if (JBCIndex != bcMapping.end()) {
-        storedBCID = JBCIndex->second;
-      }
       storedJCollisionsBunchCrossingIndexTable(storedBCID);
       storedJChargedTriggerSelsTable(collision.chargedTriggerSel());
       storedJFullTriggerSelsTable(collision.fullTriggerSel());
 
+      trackIndexFirst = tracks.size() ? tracks.begin().globalIndex() : 0;
+      storedTrackIndexFirst = storedJTracksTable.lastIndex() + 1;
+      nStoredTracks = tracks.size();
       for (const auto& track : tracks) {
         storedJTracksTable(storedJCollisionsTable.lastIndex(), track.pt(), track.eta(), track.phi(), track.energy(), track.sign(), track.trackSel());
         storedJTracksParentIndexTable(track.trackId());
-        trackMapping.insert(std::make_pair(track.globalIndex(), storedJTracksTable.lastIndex()));
       }
 
-      for (const auto& cluster : clusters) {
-        storedJClustersTable(storedJCollisionsTable.lastIndex(), cluster.id(), cluster.energy(), cluster.coreEnergy(), cluster.rawEnergy(),
-                             cluster.eta(), cluster.phi(), cluster.m02(), cluster.m20(), cluster.nCells(), cluster.time(), cluster.isExotic(), cluster.distanceToBadChannel(),
-                             cluster.nlm(), cluster.definition(), cluster.leadingCellEnergy(), cluster.subleadingCellEnergy(), cluster.leadingCellNumber(), cluster.subleadingCellNumber());
-        storedJClustersParentIndexTable(cluster.clusterId());
-
-        std::vector<int> clusterStoredJTrackIDs;
-        for (const auto& clusterTrack : cluster.matchedTracks_as<soa::Join<aod::JTracks, aod::JTrackPIs>>()) {
-          auto JtrackIndex = trackMapping.find(clusterTrack.globalIndex());
-          if (JtrackIndex != trackMapping.end()) {
-            clusterStoredJTrackIDs.push_back(JtrackIndex->second);
-          }
-        }
-        storedJClustersMatchedTracksTable(clusterStoredJTrackIDs);
-      }
+      storeClusters(clusters);
     }
   }
   // process switch for output writing must be last
@@ -190,8 +216,8 @@ struct JetDerivedDataWriter {
   void processMC(soa::Join<aod::JMcCollisions, aod::JMcCollisionPIs> const& mcCollisions, soa::Join<aod::JCollisions, aod::JCollisionPIs, aod::JCollisionBCs, aod::JChTrigSels, aod::JFullTrigSels, aod::JMcCollisionLbs> const& collisions, soa::Join<aod::JBCs, aod::JBCPIs> const& bcs, soa::Join<aod::JTracks, aod::JTrackPIs, aod::JMcTrackLbs> const& tracks, soa::Join<aod::JClusters, aod::JClusterPIs, aod::JClusterTracks> const& clusters, soa::Join<aod::JMcParticles, aod::JMcParticlePIs> const& particles)
   {
 
-    std::map<int32_t, int32_t> paticleMapping;
-    std::map<int32_t, int32_t> mcCollisionMapping;
+    particleMapping.assign(particles.size(), -1);
+    mcCollisionMapping.assign(mcCollisions.size(), -1);
     int particleTableIndex = 0;
     for (auto mcCollision : mcCollisions) {
       bool collisionSelected = false;
@@ -208,10 +234,10 @@ struct JetDerivedDataWriter {
 
         storedJMcCollisionsTable(mcCollision.posZ(), mcCollision.weight());
         storedJMcCollisionsParentIndexTable(mcCollision.mcCollisionId());
-        mcCollisionMapping.insert(std::make_pair(mcCollision.globalIndex(), storedJMcCollisionsTable.lastIndex()));
+        mcCollisionMapping[mcCollision.globalIndex()] = storedJMcCollisionsTable.lastIndex();
 
         for (auto particle : particlesPerMcCollision) {
-          paticleMapping.insert(std::make_pair(particle.globalIndex(), particleTableIndex));
+          particleMapping[particle.globalIndex()] = particleTableIndex;
           particleTableIndex++;
         }
         for (auto particle : particlesPerMcCollision) {
@@ -220,10 +246,8 @@ struct JetDerivedDataWriter {
           if (particle.has_mothers()) {
             auto mothersIdTemps = particle.mothersIds();
             for (auto mothersIdTemp : mothersIdTemps) {
-
-              auto JMotherIndex = paticleMapping.find(mothersIdTemp);
-              if (JMotherIndex != paticleMapping.end()) {
-                mothersId.push_back(JMotherIndex->second);
+              if (particleMapping[mothersIdTemp] >= 0) {
+                mothersId.push_back(particleMapping[mothersIdTemp]);
               }
             }
           }
@@ -234,9 +258,8 @@ struct JetDerivedDataWriter {
               if (i > 1) {
                 break;
               }
-              auto JDaughterIndex = paticleMapping.find(daughterId);
-              if (JDaughterIndex != paticleMapping.end()) {
-                daughtersId[i] = JDaughterIndex->second;
+              if (particleMapping[daughterId] >= 0) {
+                daughtersId[i] = particleMapping[daughterId];
               }
               i++;
             }
@@ -248,78 +271,39 @@ struct JetDerivedDataWriter {
     }
 
     for (auto mcCollision : mcCollisions) {
-      bool collisionSelected = false;
+      // the MC collisions with a selected reconstructed collision were all stored in the loop above
+      if (mcCollisionMapping[mcCollision.globalIndex()] < 0) {
+        continue;
+      }
       const auto collisionsPerMcCollision = collisions.sliceBy(CollisionsPerMcCollision, mcCollision.globalIndex());
       for (auto collision : collisionsPerMcCollision) {
-        if (collisionFlag[collision.globalIndex()]) {
-          collisionSelected = true;
-        }
-      }
-
-      if (McCollisionFlag[mcCollision.globalIndex()] || collisionSelected) {
-
-        for (auto collision : collisionsPerMcCollision) {
-          std::map<int32_t, int32_t> trackMapping;
-
-          auto bc = collision.bc_as<soa::Join<aod::JBCs, aod::JBCPIs>>();
-          if (std::find(bcIndicies.begin(), bcIndicies.end(), bc.globalIndex()) == bcIndicies.end()) {
-            storedJBCsTable(bc.runNumber(), bc.globalBC(), bc.timestamp());
-            storedJBCParentIndexTable(bc.bcId());
-            bcIndicies.push_back(bc.globalIndex());
-            bcMapping.insert(std::make_pair(bc.globalIndex(), storedJBCsTable.lastIndex()));
-          }
-
-          storedJCollisionsTable(collision.posZ(), collision.eventSel(), collision.alias_raw());
-          storedJCollisionsParentIndexTable(collision.collisionId());
-
-          auto JMcCollisionIndex = mcCollisionMapping.find(mcCollision.globalIndex());
-          if (JMcCollisionIndex != mcCollisionMapping.end()) {
-            storedJMcCollisionsLabelTable(JMcCollisionIndex->second);
-          }
-          int32_t storedBCID = -1;
-          auto JBCIndex = bcMapping.find(collision.bcId());
-          if (JBCIndex != bcMapping.end()) {
-            storedBCID = JBCIndex->second;
-          }
-          storedJCollisionsBunchCrossingIndexTable(storedBCID);
-          storedJChargedTriggerSelsTable(collision.chargedTriggerSel());
-          storedJFullTriggerSelsTable(collision.fullTriggerSel());
-
-          const auto tracksPerCollision = tracks.sliceBy(TracksPerCollision, collision.globalIndex());
-          for (const auto& track : tracksPerCollision) {
-            storedJTracksTable(storedJCollisionsTable.lastIndex(), track.pt(), track.eta(), track.phi(), track.energy(), track.sign(), track.trackSel());
-            storedJTracksParentIndexTable(track.trackId());
-
-            if (track.has_mcParticle()) {
-              auto JParticleIndex = paticleMapping.find(track.mcParticleId());
-              if (JParticleIndex != paticleMapping.end()) {
-                storedJMcTracksLabelTable(JParticleIndex->second);
-              } else {
-                storedJMcTracksLabelTable(-1); // this can happen because there are some tracks that are reconstucted in a wrong collision, but their original McCollision did not pass the required cuts so that McParticle is not saved. These are very few but we should look into them further and see what to do about them
-              }
-            } else {
-              storedJMcTracksLabelTable(-1);
-            }
-            trackMapping.insert(std::make_pair(track.globalIndex(), storedJTracksTable.lastIndex()));
-          }
-
-          const auto clustersPerCollision = clusters.sliceBy(ClustersPerCollision, collision.globalIndex());
-          for (const auto& cluster : clustersPerCollision) {
-            storedJClustersTable(storedJCollisionsTable.lastIndex(), cluster.id(), cluster.energy(), cluster.coreEnergy(), cluster.rawEnergy(),
-                                 cluster.eta(), cluster.phi(), cluster.m02(), cluster.m20(), cluster.nCells(), cluster.time(), cluster.isExotic(), cluster.distanceToBadChannel(),
-                                 cluster.nlm(), cluster.definition(), cluster.leadingCellEnergy(), cluster.subleadingCellEnergy(), cluster.leadingCellNumber(), cluster.subleadingCellNumber());
-            storedJClustersParentIndexTable(cluster.clusterId());
-
-            std::vector<int> clusterStoredJTrackIDs;
-            for (const auto& clusterTrack : cluster.matchedTracks_as<soa::Join<aod::JTracks, aod::JTrackPIs>>()) {
-              auto JtrackIndex = trackMapping.find(clusterTrack.globalIndex());
-              if (JtrackIndex != trackMapping.end()) {
-                clusterStoredJTrackIDs.push_back(JtrackIndex->second);
-              }
-            }
-            storedJClustersMatchedTracksTable(clusterStoredJTrackIDs);
+        auto bc = collision.bc_as<soa::Join<aod::JBCs, aod::JBCPIs>>();
+        int32_t storedBCID = storeBC(bc, bcs);
+
+        storedJCollisionsTable(collision.posZ(), collision.eventSel(), collision.alias_raw());
+        storedJCollisionsParentIndexTable(collision.collisionId());
+        storedJMcCollisionsLabelTable(mcCollisionMapping[mcCollision.globalIndex()]);
+        storedJCollisionsBunchCrossingIndexTable(storedBCID);
+        storedJChargedTriggerSelsTable(collision.chargedTriggerSel());
+        storedJFullTriggerSelsTable(collision.fullTriggerSel());
+
+        const auto tracksPerCollision = tracks.sliceBy(TracksPerCollision, collision.globalIndex());
+        trackIndexFirst = tracksPerCollision.size() ? tracksPerCollision.begin().globalIndex() : 0;
+        storedTrackIndexFirst = storedJTracksTable.lastIndex() + 1;
+        nStoredTracks = tracksPerCollision.size();
+        for (const auto& track : tracksPerCollision) {
+          storedJTracksTable(storedJCollisionsTable.lastIndex(), track.pt(), track.eta(), track.phi(), track.energy(), track.sign(), track.trackSel());
+          storedJTracksParentIndexTable(track.trackId());
+
+          if (track.has_mcParticle()) {
+            // this can be -1 because there are some tracks that are reconstucted in a wrong collision, but their original McCollision did not pass the required cuts so that McParticle is not saved. These are very few but we should look into them further and see what to do about them
+            storedJMcTracksLabelTable(particleMapping[track.mcParticleId()]);
+          } else {
+            storedJMcTracksLabelTable(-1);
           }
         }
+
+        storeClusters(clusters.sliceBy(ClustersPerCollision, collision.globalIndex()));
       }
     }
   }
@@ -330,10 +314,10 @@ struct JetDerivedDataWriter {
   void processMCP(soa::Join<aod::JMcCollisions, aod::JMcCollisionPIs> const& mcCollisions, soa::Join<aod::JMcParticles, aod::JMcParticlePIs> const& particles)
   {
 
+    particleMapping.assign(particles.size(), -1);
     int particleTableIndex = 0;
     for (auto mcCollision : mcCollisions) {
       if (McCollisionFlag[mcCollision.globalIndex()]) { // you can also check if any of its detector level counterparts are correct
-        std::map<int32_t, int32_t> paticleMapping;
 
         storedJMcCollisionsTable(mcCollision.posZ(), mcCollision.weight());
         storedJMcCollisionsParentIndexTable(mcCollision.mcCollisionId());
@@ -341,19 +325,17 @@ struct JetDerivedDataWriter {
         const auto particlesPerMcCollision = particles.sliceBy(ParticlesPerMcCollision, mcCollision.globalIndex());
 
         for (auto particle : particlesPerMcCollision) {
-          paticleMapping.insert(std::make_pair(particle.globalIndex(), particleTableIndex));
+          particleMapping[particle.globalIndex()] = particleTableIndex;
           particleTableIndex++;
         }
         for (auto particle : particlesPerMcCollision) {
 
           std::vector<int> mothersId;
-          int daughtersId[2];
+          int daughtersId[2] = {-1, -1};
           if (particle.has_mothers()) {
-            for (auto const& mother : particle.template mothers_as<soa::Join<aod::JMcParticles, aod::JMcParticlePIs>>()) {
-
-              auto JMotherIndex = paticleMapping.find(mother.globalIndex());
-              if (JMotherIndex != paticleMapping.end()) {
-                mothersId.push_back(JMotherIndex->second);
+            for (auto const& motherId : particle.mothersIds()) {
+              if (particleMapping[motherId] >= 0) {
+                mothersId.push_back(particleMapping[motherId]);
               }
             }
           }
@@ -363,9 +345,8 @@ struct JetDerivedDataWriter {
               if (i > 1) {
                 break;
               }
-              auto JDaughterIndex = paticleMapping.find(daughter.globalIndex());
-              if (JDaughterIndex != paticleMapping.end()) {
-                daughtersId[i] = JDaughterIndex->second;
+              if (particleMapping[daughter.globalIndex()] >= 0) {
+                daughtersId[i] = particleMapping[daughter.globalIndex()];
               }
               i++;
             }
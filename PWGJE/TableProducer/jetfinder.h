@@ -17,6 +17,7 @@
 #ifndef PWGJE_TABLEPRODUCER_JETFINDER_H_
 #define PWGJE_TABLEPRODUCER_JETFINDER_H_
 
+#include <algorithm>
 #include <array>
 #include <vector>
 #include <string>
@@ -127,60 +128,83 @@ bool analyseCandidateMC(std::vector<fastjet::PseudoJet>& inputParticles, int can
   return analyseCandidate(inputParticles, candMass, candPtMin, candPtMax, candYMin, candYMax, candidate);
 }
 
-// function that calls the jet finding and fills the relevant tables
+// function that fills the jet tables with the jets found for one jet radius
+// the constituents of each jet are retrieved and sorted once and their user info is decoded once for both the HF tag and the index columns
 template <typename T, typename U, typename V, typename W>
-void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputParticles, std::vector<double> jetRadius, T const& collision, U& jetsTable, V& constituentsTable, W& constituentsSubTable, bool DoConstSub, bool doHFJetFinding = false)
+void fillJetTables(std::vector<fastjet::PseudoJet> const& jets, double R, T const& collision, U& jetsTable, V& constituentsTable, W& constituentsSubTable, bool DoConstSub, bool doHFJetFinding)
 {
   // auto candidatepT = 0.0;
-  auto jetRValues = static_cast<std::vector<double>>(jetRadius);
-  for (auto R : jetRValues) {
+  std::vector<fastjet::PseudoJet> constituents;
+  std::vector<int> trackconst;
+  std::vector<int> candconst;
+  std::vector<int> clusterconst;
+  for (const auto& jet : jets) {
+    constituents = sorted_by_pt(jet.constituents());
+    trackconst.clear();
+    candconst.clear();
+    clusterconst.clear();
+    trackconst.reserve(constituents.size());
+    bool isHFJet = false;
+    for (const auto& constituent : constituents) {
+      const auto& userInfo = constituent.template user_info<FastJetUtilities::fastjet_user_info>();
+      if (userInfo.getStatus() == static_cast<int>(JetConstituentStatus::track)) {
+        trackconst.push_back(userInfo.getIndex());
+      }
+      if (userInfo.getStatus() == static_cast<int>(JetConstituentStatus::cluster)) {
+        clusterconst.push_back(userInfo.getIndex());
+      }
+      if (userInfo.getStatus() == static_cast<int>(JetConstituentStatus::candidateHF)) {
+        candconst.push_back(userInfo.getIndex());
+        isHFJet = true;
+        // candidatepT = constituent.pt();
+      }
+    }
+    if (doHFJetFinding && !isHFJet) {
+      continue;
+    }
+    jetsTable(collision.globalIndex(), jet.pt(), jet.eta(), jet.phi(),
+              jet.E(), jet.m(), jet.has_area() ? jet.area() : -1., std::round(R * 100));
+    // need to add seperate thing for constituent subtraction
+    if (DoConstSub) {
+      for (const auto& constituent : constituents) {
+        constituentsSubTable(jetsTable.lastIndex(), constituent.pt(), constituent.eta(), constituent.phi(),
+                             constituent.E(), constituent.m(), constituent.user_index());
+      }
+    }
+    constituentsTable(jetsTable.lastIndex(), trackconst, clusterconst, candconst);
+  }
+}
+
+// function that calls the jet finding and fills the relevant tables
+template <typename T, typename U, typename V, typename W>
+void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputParticles, std::vector<double> const& jetRadius, T const& collision, U& jetsTable, V& constituentsTable, W& constituentsSubTable, bool DoConstSub, bool doHFJetFinding = false)
+{
+  // with C/A, the jets of all the radii are extracted from a single clustering with the largest radius
+  if (jetFinder.reuseClusteringHistory && jetFinder.algorithm == fastjet::cambridge_algorithm && !jetFinder.isReclustering && jetRadius.size() > 1) {
+    jetFinder.jetR = *std::max_element(jetRadius.begin(), jetRadius.end());
+    std::vector<fastjet::PseudoJet> jetsMaxR;
+    fastjet::ClusterSequenceArea clusterSeq(jetFinder.findJets(inputParticles, jetsMaxR));
+    const float jetRClustering = jetFinder.jetR;
+    for (auto R : jetRadius) {
+      jetFinder.jetR = R;
+      if (static_cast<float>(R) == jetRClustering) {
+        fillJetTables(jetsMaxR, R, collision, jetsTable, constituentsTable, constituentsSubTable, DoConstSub, doHFJetFinding);
+      } else {
+        fillJetTables(jetFinder.findJets(clusterSeq, jetRClustering), R, collision, jetsTable, constituentsTable, constituentsSubTable, DoConstSub, doHFJetFinding);
+      }
+    }
+    return;
+  }
+
+  for (auto R : jetRadius) {
     jetFinder.jetR = R;
     std::vector<fastjet::PseudoJet> jets;
     fastjet::ClusterSequenceArea clusterSeq(jetFinder.findJets(inputParticles, jets));
 
-    // JetBkgSubUtils bkgSub(jetFinder.jetR, 1., 0.6, jetFinder.jetEtaMin, jetFinder.jetEtaMax, jetFinder.jetPhiMin, jetFinder.jetPhiMax, jetFinder.ghostAreaSpec);
-    // bkgSub.setMaxEtaEvent(jetFinder.etaMax);
-    // auto[rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, false);
-    // jets = jetFinder.selJets(bkgSub.doRhoAreaSub(jets, rho, rhoM));
-
-    for (const auto& jet : jets) {
-      bool isHFJet = false;
-      if (doHFJetFinding) {
-        for (const auto& constituent : jet.constituents()) {
-          if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::candidateHF)) {
-            isHFJet = true;
-            // candidatepT = constituent.pt();
-            break;
-          }
-        }
-        if (!isHFJet) {
-          continue;
-        }
-      }
-      std::vector<int> trackconst;
-      std::vector<int> candconst;
-      std::vector<int> clusterconst;
-      jetsTable(collision.globalIndex(), jet.pt(), jet.eta(), jet.phi(),
-                jet.E(), jet.m(), jet.has_area() ? jet.area() : -1., std::round(R * 100));
-      for (const auto& constituent : sorted_by_pt(jet.constituents())) {
-        // need to add seperate thing for constituent subtraction
-        if (DoConstSub) {
-          constituentsSubTable(jetsTable.lastIndex(), constituent.pt(), constituent.eta(), constituent.phi(),
-                               constituent.E(), constituent.m(), constituent.user_index());
-        }
+    // the background density is not estimated here: it is produced once per collision by the rho-estimator in the JCollisionRhos table,
+    // which the analyses subtracting the background (and the constituent subtraction in JetBkgSubUtils) take their rho and rho_m from
 
-        if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::track)) {
-          trackconst.push_back(constituent.template user_info<FastJetUtilities::fastjet_user_info>().getIndex());
-        }
-        if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::cluster)) {
-          clusterconst.push_back(constituent.template user_info<FastJetUtilities::fastjet_user_info>().getIndex());
-        }
-        if (constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::candidateHF)) {
-          candconst.push_back(constituent.template user_info<FastJetUtilities::fastjet_user_info>().getIndex());
-        }
-      }
-      constituentsTable(jetsTable.lastIndex(), trackconst, clusterconst, candconst);
-    }
+    fillJetTables(jets, R, collision, jetsTable, constituentsTable, constituentsSubTable, DoConstSub, doHFJetFinding);
   }
 }
 
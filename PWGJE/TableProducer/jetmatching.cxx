@@ -61,6 +61,11 @@ struct JetMatching {
   std::vector<std::vector<int>> geojetidBaseToTag, ptjetidBaseToTag, hfjetidBaseToTag;
   std::vector<std::vector<int>> geojetidTagToBase, ptjetidTagToBase, hfjetidTagToBase;
 
+  // grid-based geometric matching and jet coordinates, kept between collisions to reuse the memory
+  JetUtilities::JetGeoMatcher<double> geoMatcher;
+  std::vector<double> jetsBasePhi, jetsBaseEta;
+  std::vector<double> jetsTagPhi, jetsTagEta;
+
   static constexpr int8_t getHfFlag()
   {
     if (std::is_same<BaseToTagMatchingTable, aod::D0ChargedMCDetectorLevelJetsMatchedToD0ChargedMCParticleLevelJets>::value &&
@@ -86,19 +91,19 @@ struct JetMatching {
   template <typename T, typename U>
   void MatchGeo(T const& jetsBasePerColl, U const& jetsTagPerColl, std::vector<int>& baseToTagGeo, std::vector<int>& tagToBaseGeo)
   {
-    std::vector<double> jetsBasePhi;
-    std::vector<double> jetsBaseEta;
+    jetsBasePhi.clear();
+    jetsBaseEta.clear();
     for (const auto& jet : jetsBasePerColl) {
       jetsBasePhi.emplace_back(jet.phi());
       jetsBaseEta.emplace_back(jet.eta());
     }
-    std::vector<double> jetsTagPhi;
-    std::vector<double> jetsTagEta;
+    jetsTagPhi.clear();
+    jetsTagEta.clear();
     for (const auto& jet : jetsTagPerColl) {
       jetsTagPhi.emplace_back(jet.phi());
       jetsTagEta.emplace_back(jet.eta());
     }
-    std::tie(baseToTagGeo, tagToBaseGeo) = JetUtilities::MatchJetsGeometrically(jetsBasePhi, jetsBaseEta, jetsTagPhi, jetsTagEta, maxMatchingDistance);
+    geoMatcher.match(jetsBasePhi, jetsBaseEta, jetsTagPhi, jetsTagEta, maxMatchingDistance, baseToTagGeo, tagToBaseGeo);
     LOGF(debug, "geometric matching: %d - %d jets", baseToTagGeo.size(), tagToBaseGeo.size());
     for (std::size_t i = 0; i < baseToTagGeo.size(); ++i) {
       LOGF(debug, "bjet %i -> %i", i, baseToTagGeo[i]);
@@ -39,6 +39,9 @@ struct JetTaggerHFTask {
   Configurable<bool> doAlgorithm3{"doAlgorithm3", false, "fill table for algoithm 3"};
   Configurable<float> maxDeltaR{"maxDeltaR", 0.25, "maximum distance of jet axis from flavour initiating parton"};
 
+  // HF origin of the generator level particles, evaluated once per data frame for the particles shared by several jets (e.g. of different radii)
+  std::vector<int8_t> particleOrigins;
+
   void processDummy(aod::Collision const& collision)
   {
   }
@@ -59,11 +62,13 @@ struct JetTaggerHFTask {
   }
   PROCESS_SWITCH(JetTaggerHFTask, processData, "Fill tagging decision for data jets", false);
 
-  void processMCD(aod::JCollision const& collision, JetTableMCD const& mcdjets, soa::Join<aod::JTracks, aod::McTrackLabels> const& tracks, aod::JMcParticles const& particles)
+  // the jets of all the collisions are processed at once, in the order of the jet table, so that the particle origins are cached for the whole data frame
+  void processMCD(JetTableMCD const& mcdjets, soa::Join<aod::JTracks, aod::McTrackLabels> const& tracks, aod::JMcParticles const& particles)
   {
+    particleOrigins.assign(particles.size(), -1);
     for (auto& mcdjet : mcdjets) {
 
-      int origin = JetTaggingUtilities::mcdJetFromHFShower(mcdjet, tracks, particles, maxDeltaR);
+      int origin = JetTaggingUtilities::mcdJetFromHFShower(mcdjet, tracks, particles, maxDeltaR, &particleOrigins);
       int algorithm1 = 0;
       int algorithm2 = 0;
       int algorithm3 = 0;
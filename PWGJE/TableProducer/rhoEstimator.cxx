@@ -10,12 +10,15 @@
 // or submit itself to any jurisdiction.
 
 // Task to produce a table joinable to the collision table with the mean background pT density
+// This is the only place where the background density is estimated: the jet finders do not recompute it and the
+// tasks subtracting the background join JCollisionRhos to the collisions instead
 //
 /// \author Nima Zardoshti <nima.zardoshti@cern.ch>
 
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/ASoA.h"
+#include "Framework/HistogramRegistry.h"
 #include "Framework/O2DatabasePDGPlugin.h"
 
 #include "PWGJE/Core/FastJetUtilities.h"
@@ -38,8 +41,12 @@ struct RhoEstimatorTask {
   Configurable<float> bkgPhiMin{"bkgPhiMin", -99., "minimim phi for determining background density"};
   Configurable<float> bkgPhiMax{"bkgPhiMax", 99., "maximum phi for determining background density"};
   Configurable<bool> doSparse{"doSparse", false, "perfom sparse estimation"};
+  Configurable<bool> useGridMedian{"useGridMedian", false, "estimate the background density as the median over the tiles of an eta-phi grid instead of the kT jets"};
+  Configurable<float> bkgGridSpacing{"bkgGridSpacing", 0.55, "size of the eta-phi tiles for the grid-median estimation"};
+  Configurable<bool> doValidation{"doValidation", false, "fill histograms comparing the grid-median and the area-median estimations"};
 
   JetBkgSubUtils bkgSub;
+  HistogramRegistry registry{"registry"};
   std::vector<fastjet::PseudoJet> inputParticles;
   int trackSelection = -1;
 
@@ -50,6 +57,12 @@ struct RhoEstimatorTask {
     bkgSub.setJetBkgR(bkgjetR);
     bkgSub.setEtaMinMax(bkgEtaMin, bkgEtaMax);
     bkgSub.setPhiMinMax(bkgPhiMin, bkgPhiMax);
+    bkgSub.setGridSpacing(bkgGridSpacing);
+
+    if (doValidation) {
+      registry.add("h2_rho_grid_rho_areamedian", ";#it{#rho}_{area median} (GeV/#it{c});#it{#rho}_{grid} (GeV/#it{c})", {HistType::kTH2F, {{200, 0., 200.}, {200, 0., 200.}}});
+      registry.add("h2_rhom_grid_rhom_areamedian", ";#it{#rho}_{m, area median} (GeV/#it{c}^{2});#it{#rho}_{m, grid} (GeV/#it{c}^{2})", {HistType::kTH2F, {{100, 0., 10.}, {100, 0., 10.}}});
+    }
   }
 
   void processCollisions(aod::JCollisions const& collision, aod::JTracks const& tracks)
@@ -62,8 +75,15 @@ struct RhoEstimatorTask {
       FastJetUtilities::fillTracks(track, inputParticles, track.globalIndex());
     }
 
-    auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, doSparse);
+    auto [rho, rhoM] = useGridMedian ? bkgSub.estimateRhoGridMedian(inputParticles) : bkgSub.estimateRhoAreaMedian(inputParticles, doSparse);
     rhoTable(rho, rhoM);
+
+    if (doValidation) {
+      auto [rhoGrid, rhoMGrid] = useGridMedian ? std::make_tuple(rho, rhoM) : bkgSub.estimateRhoGridMedian(inputParticles);
+      auto [rhoAreaMedian, rhoMAreaMedian] = useGridMedian ? bkgSub.estimateRhoAreaMedian(inputParticles, doSparse) : std::make_tuple(rho, rhoM);
+      registry.fill(HIST("h2_rho_grid_rho_areamedian"), rhoAreaMedian, rhoGrid);
+      registry.fill(HIST("h2_rhom_grid_rhom_areamedian"), rhoMAreaMedian, rhoMGrid);
+    }
   }
   PROCESS_SWITCH(RhoEstimatorTask, processCollisions, "Fill rho tables for collisions", true);
 };
@@ -15,7 +15,6 @@
 //
 
 #include "fastjet/PseudoJet.hh"
-#include "fastjet/ClusterSequenceArea.hh"
 
 #include "CommonConstants/PhysicsConstants.h"
 #include "Framework/AnalysisTask.h"
@@ -34,6 +33,7 @@
 #include "PWGJE/DataModel/Jet.h"
 #include "PWGJE/DataModel/JetSubstructure.h"
 #include "PWGJE/Core/JetFinder.h"
+#include "PWGJE/Core/JetSubstructureUtilities.h"
 #include "PWGJE/Core/FastJetUtilities.h"
 
 using namespace o2;
@@ -58,8 +58,7 @@ struct JetSubstructureHFTask {
   int candPDG;
 
   std::vector<fastjet::PseudoJet> jetConstituents;
-  std::vector<fastjet::PseudoJet> jetReclustered;
-  JetFinder jetReclusterer;
+  JetSubstructureUtilities::JetDeclusterer jetDeclusterer;
 
   void init(InitContext const&)
   {
@@ -70,9 +69,6 @@ struct JetSubstructureHFTask {
     hNsd.setObject(new TH2F("h_jet_nsd_jet_pt", ";n_{SD}; #it{p}_{T,jet} (GeV/#it{c})",
                             7, -0.5, 6.5, 200, 0.0, 200.0));
 
-    jetReclusterer.isReclustering = true;
-    jetReclusterer.algorithm = fastjet::JetAlgorithm::cambridge_algorithm;
-
     if constexpr (std::is_same_v<std::decay_t<JetTableMCP>, soa::Join<aod::D0ChargedMCParticleLevelJets, aod::D0ChargedMCParticleLevelJetConstituents>>) {
       candPDG = static_cast<int>(o2::constants::physics::Pdg::kD0);
     }
@@ -87,47 +83,14 @@ struct JetSubstructureHFTask {
   template <typename T>
   void jetReclustering(T const& jet)
   {
-    jetReclustered.clear();
-    fastjet::ClusterSequenceArea clusterSeq(jetReclusterer.findJets(jetConstituents, jetReclustered));
-    jetReclustered = sorted_by_pt(jetReclustered);
-    fastjet::PseudoJet daughterSubJet = jetReclustered[0];
-    fastjet::PseudoJet parentSubJet1;
-    fastjet::PseudoJet parentSubJet2;
-    bool softDropped = false;
-    auto nsd = 0.0;
-    auto zg = -1.0;
-    auto rg = -1.0;
-    while (daughterSubJet.has_parents(parentSubJet1, parentSubJet2)) {
-      if (parentSubJet1.perp() < parentSubJet2.perp()) {
-        std::swap(parentSubJet1, parentSubJet2);
-      }
-      auto z = parentSubJet2.perp() / (parentSubJet1.perp() + parentSubJet2.perp());
-      auto theta = parentSubJet1.delta_R(parentSubJet2);
-      if (z >= zCut * TMath::Power(theta / (jet.r() / 100.f), beta)) {
-        if (!softDropped) {
-          zg = z;
-          rg = theta;
-          hZg->Fill(zg, jet.pt());
-          hRg->Fill(rg, jet.pt());
-          softDropped = true;
-        }
-        nsd++;
-      }
-      bool isHFInSubjet1 = false;
-      for (auto& subjet1Constituent : parentSubJet1.constituents()) {
-        if (subjet1Constituent.template user_info<FastJetUtilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::candidateHF)) {
-          isHFInSubjet1 = true;
-          break;
-        }
-      }
-      if (isHFInSubjet1) {
-        daughterSubJet = parentSubJet1;
-      } else {
-        daughterSubJet = parentSubJet2;
-      }
+    jetDeclusterer.recluster(jetConstituents, true);
+    auto softDrop = jetDeclusterer.softDrop(zCut, beta, jet.r() / 100.f);
+    if (softDrop.isGroomed) {
+      hZg->Fill(softDrop.zg, jet.pt());
+      hRg->Fill(softDrop.rg, jet.pt());
     }
-    hNsd->Fill(nsd, jet.pt());
-    jetSubstructurehfTable(zg, rg, nsd);
+    hNsd->Fill(softDrop.nsd, jet.pt());
+    jetSubstructurehfTable(softDrop.zg, softDrop.rg, softDrop.nsd);
   }
 
   void processDummy(aod::JTracks const& track)
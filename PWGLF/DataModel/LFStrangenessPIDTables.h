@@ -39,6 +39,90 @@ DECLARE_SOA_TABLE(DauTrackTPCPIDs, "AOD", "DAUTRACKTPCPID", // nsigma table (for
                   dautrack::TPCNSigmaPi, dautrack::TPCNSigmaKa,
                   dautrack::TPCNSigmaPr, dautrack::TPCNSigmaHe);
 
+namespace dautrack_tiny
+{
+// ==== TPC INFORMATION, REDUCED SIZE ===
+// nsigmas in 8 bits, in steps of 0.1 in [-12.7, 12.7]
+struct binning {
+ public:
+  typedef int8_t binned_t;
+  static constexpr int nbins = (1 << 8 * sizeof(binned_t)) - 2;
+  static constexpr binned_t overflowBin = nbins >> 1;
+  static constexpr binned_t underflowBin = -(nbins >> 1);
+  static constexpr float binned_max = 12.7;
+  static constexpr float binned_min = -12.7;
+  static constexpr float bin_width = (binned_max - binned_min) / nbins;
+};
+
+// TPC signal in 16 bits, in steps of 0.05 in [0, 3276.7]
+struct signalBinning {
+ public:
+  typedef uint16_t binned_t;
+  static constexpr binned_t overflowBin = 65534;
+  static constexpr float binned_max = 3276.7;
+  static constexpr float bin_width = 0.05;
+};
+
+inline binning::binned_t packNSigma(float nsigma)
+{
+  if (nsigma <= binning::binned_min) {
+    return binning::underflowBin;
+  }
+  if (nsigma >= binning::binned_max) {
+    return binning::overflowBin;
+  }
+  if (nsigma >= 0) {
+    return static_cast<binning::binned_t>((nsigma / binning::bin_width) + 0.5f);
+  }
+  return static_cast<binning::binned_t>((nsigma / binning::bin_width) - 0.5f);
+}
+
+inline signalBinning::binned_t packSignal(float signal)
+{
+  if (signal <= 0.f) {
+    return 0;
+  }
+  if (signal >= signalBinning::binned_max) {
+    return signalBinning::overflowBin;
+  }
+  return static_cast<signalBinning::binned_t>((signal / signalBinning::bin_width) + 0.5f);
+}
+
+DECLARE_SOA_COLUMN(TPCSignalStore, tpcSignalStore, signalBinning::binned_t); //! Stored binned track signal
+DECLARE_SOA_COLUMN(TPCNSigmaStoreEl, tpcNSigmaStoreEl, binning::binned_t);   //! Stored binned nsigma electron
+DECLARE_SOA_COLUMN(TPCNSigmaStorePi, tpcNSigmaStorePi, binning::binned_t);   //! Stored binned nsigma pion
+DECLARE_SOA_COLUMN(TPCNSigmaStoreKa, tpcNSigmaStoreKa, binning::binned_t);   //! Stored binned nsigma kaon
+DECLARE_SOA_COLUMN(TPCNSigmaStorePr, tpcNSigmaStorePr, binning::binned_t);   //! Stored binned nsigma proton
+DECLARE_SOA_COLUMN(TPCNSigmaStoreHe, tpcNSigmaStoreHe, binning::binned_t);   //! Stored binned nsigma helium3
+
+// Unwrapped (float) values, same getters as in DauTrackTPCPIDs
+DECLARE_SOA_DYNAMIC_COLUMN(TPCSignal, tpcSignal, //! track signal
+                           [](signalBinning::binned_t signal) -> float { return signalBinning::bin_width * static_cast<float>(signal); });
+#define DEFINE_UNWRAP_DAUTRACK_NSIGMA_COLUMN(COLUMN, COLUMN_NAME) \
+  DECLARE_SOA_DYNAMIC_COLUMN(COLUMN, COLUMN_NAME,                 \
+                             [](binning::binned_t nsigma) -> float { return binning::bin_width * static_cast<float>(nsigma); });
+DEFINE_UNWRAP_DAUTRACK_NSIGMA_COLUMN(TPCNSigmaEl, tpcNSigmaEl); //! Nsigma electron
+DEFINE_UNWRAP_DAUTRACK_NSIGMA_COLUMN(TPCNSigmaPi, tpcNSigmaPi); //! Nsigma pion
+DEFINE_UNWRAP_DAUTRACK_NSIGMA_COLUMN(TPCNSigmaKa, tpcNSigmaKa); //! Nsigma kaon
+DEFINE_UNWRAP_DAUTRACK_NSIGMA_COLUMN(TPCNSigmaPr, tpcNSigmaPr); //! Nsigma proton
+DEFINE_UNWRAP_DAUTRACK_NSIGMA_COLUMN(TPCNSigmaHe, tpcNSigmaHe); //! Nsigma helium3
+#undef DEFINE_UNWRAP_DAUTRACK_NSIGMA_COLUMN
+} // namespace dautrack_tiny
+
+// reduced size version of DauTrackTPCPIDs: 7 instead of 24 bytes per daughter track
+DECLARE_SOA_TABLE(DauTrackTinyTPCPIDs, "AOD", "DAUTRACKTPCPIDT", // nsigma table (for analysis)
+                  dautrack_tiny::TPCSignalStore, dautrack_tiny::TPCNSigmaStoreEl,
+                  dautrack_tiny::TPCNSigmaStorePi, dautrack_tiny::TPCNSigmaStoreKa,
+                  dautrack_tiny::TPCNSigmaStorePr, dautrack_tiny::TPCNSigmaStoreHe,
+
+                  // Dynamic columns for reading the physical values
+                  dautrack_tiny::TPCSignal<dautrack_tiny::TPCSignalStore>,
+                  dautrack_tiny::TPCNSigmaEl<dautrack_tiny::TPCNSigmaStoreEl>,
+                  dautrack_tiny::TPCNSigmaPi<dautrack_tiny::TPCNSigmaStorePi>,
+                  dautrack_tiny::TPCNSigmaKa<dautrack_tiny::TPCNSigmaStoreKa>,
+                  dautrack_tiny::TPCNSigmaPr<dautrack_tiny::TPCNSigmaStorePr>,
+                  dautrack_tiny::TPCNSigmaHe<dautrack_tiny::TPCNSigmaStoreHe>);
+
 namespace v0data
 {
 // ==== TOF INFORMATION ===
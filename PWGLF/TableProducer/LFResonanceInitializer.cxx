@@ -32,6 +32,7 @@
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/DataModel/LFResonanceTables.h"
 #include "PWGLF/Utils/collisionCuts.h"
+#include "PWGLF/Utils/eventShape.h"
 #include "ReconstructionDataFormats/Track.h"
 #include "DataFormatsParameters/GRPObject.h"
 #include "DataFormatsParameters/GRPMagField.h"
@@ -372,42 +373,13 @@ struct reso2initializer {
       return -99.;
 
     // start computing spherocity
-
-    float ptSum = 0.;
-    for (auto const& track : tracks) {
-      if (ConfFillQA) {
+    if (ConfFillQA) {
+      for (auto const& track : tracks) {
         qaRegistry.fill(HIST("Phi"), track.phi());
       }
-      if (spdef == 0) {
-        ptSum += 1.;
-      } else {
-        ptSum += track.pt();
-      }
-    }
-
-    float tempSph = 1.;
-    for (int i = 0; i < 360 / 0.1; ++i) {
-      float sum = 0., pt = 0.;
-      float phiparm = (TMath::Pi() * i * 0.1) / 180.;
-      float nx = TMath::Cos(phiparm);
-      float ny = TMath::Sin(phiparm);
-      for (auto const& trk : tracks) {
-        pt = trk.pt();
-        if (spdef == 0) {
-          pt = 1.;
-        }
-        float phi = trk.phi();
-        float px = pt * TMath::Cos(phi);
-        float py = pt * TMath::Sin(phi);
-        // sum += pt * abs(sin(phiparm - phi));
-        sum += TMath::Abs(px * ny - py * nx);
-      }
-      float sph = TMath::Power((sum / ptSum), 2);
-      if (sph < tempSph)
-        tempSph = sph;
     }
 
-    return TMath::Power(TMath::Pi() / 2., 2) * tempSph;
+    return o2::analysis::getTransverseSpherocity(tracks, spdef == 0);
   }
 
   // Filter for all tracks
@@ -42,6 +42,7 @@
 #include <map>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 #include "Framework/runDataProcessing.h"
 #include "Framework/RunningWorkflowInfo.h"
@@ -261,6 +262,19 @@ struct cascadeBuilder {
   o2::track::TrackParCov lV0Track;
   o2::track::TrackParCov lCascadeTrack;
 
+  // V0 track parametrisations at the V0 decay point of the lambdakzerobuilder fit, indexed by V0,
+  // built once per time frame and shared by all the cascades using the same V0
+  struct V0TrackFromBuilder {
+    bool isFilled = false;
+    o2::track::TrackParCov track;
+  };
+  std::vector<V0TrackFromBuilder> v0TracksFromBuilder;
+
+  void resetV0TracksFromBuilder(std::size_t nV0s)
+  {
+    v0TracksFromBuilder.assign(nV0s, V0TrackFromBuilder{});
+  }
+
   // Helper struct to do bookkeeping of building parameters
   struct {
     std::array<long, kNCascSteps> cascstats;
@@ -863,19 +877,25 @@ struct cascadeBuilder {
     // Do actual minimization
     lBachelorTrack = getTrackParCov(bachTrack);
 
-    // Set up covariance matrices (should in fact be optional)
-    std::array<float, 21> covV = {0.};
-    constexpr int MomInd[6] = {9, 13, 14, 18, 19, 20}; // cov matrix elements for momentum component
-    for (int i = 0; i < 6; i++) {
-      covV[MomInd[i]] = v0.momentumCovMat()[i];
-      covV[i] = v0.positionCovMat()[i];
+    // V0 as fitted by the lambdakzerobuilder, no refit of the V0 daughters needed
+    auto& v0TrackFromBuilder = v0TracksFromBuilder[cascade.v0Id()];
+    if (!v0TrackFromBuilder.isFilled) {
+      // Set up covariance matrices (should in fact be optional)
+      std::array<float, 21> covV = {0.};
+      constexpr int MomInd[6] = {9, 13, 14, 18, 19, 20}; // cov matrix elements for momentum component
+      for (int i = 0; i < 6; i++) {
+        covV[MomInd[i]] = v0.momentumCovMat()[i];
+        covV[i] = v0.positionCovMat()[i];
+      }
+      v0TrackFromBuilder.track = o2::track::TrackParCov(
+        {v0.x(), v0.y(), v0.z()},
+        {v0.pxpos() + v0.pxneg(), v0.pypos() + v0.pyneg(), v0.pzpos() + v0.pzneg()},
+        covV, 0, true);
+      v0TrackFromBuilder.track.setAbsCharge(0);
+      v0TrackFromBuilder.track.setPID(o2::track::PID::Lambda);
+      v0TrackFromBuilder.isFilled = true;
     }
-    lV0Track = o2::track::TrackParCov(
-      {v0.x(), v0.y(), v0.z()},
-      {v0.pxpos() + v0.pxneg(), v0.pypos() + v0.pyneg(), v0.pzpos() + v0.pzneg()},
-      covV, 0, true);
-    lV0Track.setAbsCharge(0);
-    lV0Track.setPID(o2::track::PID::Lambda);
+    lV0Track = v0TrackFromBuilder.track;
 
     //---/---/---/
     // Move close to minima
@@ -1621,8 +1641,9 @@ struct cascadeBuilder {
     resetHistos();
   }
 
-  void processRun2(aod::Collisions const& collisions, aod::V0sLinked const&, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExt const&, aod::BCsWithTimestamps const&)
+  void processRun2(aod::Collisions const& collisions, aod::V0sLinked const& v0sLinked, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExt const&, aod::BCsWithTimestamps const&)
   {
+    resetV0TracksFromBuilder(v0sLinked.size());
     for (const auto& collision : collisions) {
       // Fire up CCDB
       auto bc = collision.bc_as<aod::BCsWithTimestamps>();
@@ -1635,8 +1656,9 @@ struct cascadeBuilder {
   }
   PROCESS_SWITCH(cascadeBuilder, processRun2, "Produce Run 2 cascade tables", false);
 
-  void processRun3(aod::Collisions const& collisions, aod::V0sLinked const&, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&)
+  void processRun3(aod::Collisions const& collisions, aod::V0sLinked const& v0sLinked, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&)
   {
+    resetV0TracksFromBuilder(v0sLinked.size());
     for (const auto& collision : collisions) {
       // Fire up CCDB
       auto bc = collision.bc_as<aod::BCsWithTimestamps>();
@@ -1663,8 +1685,9 @@ struct cascadeBuilder {
   }
   PROCESS_SWITCH(cascadeBuilder, processRun3withKFParticle, "Produce Run 3 KF cascade tables", false);
 
-  void processRun3withStrangenessTracking(aod::Collisions const& collisions, aod::V0sLinked const&, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&, aod::TrackedCascades const& trackedCascades)
+  void processRun3withStrangenessTracking(aod::Collisions const& collisions, aod::V0sLinked const& v0sLinked, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&, aod::TrackedCascades const& trackedCascades)
   {
+    resetV0TracksFromBuilder(v0sLinked.size());
     for (const auto& collision : collisions) {
       // Fire up CCDB
       auto bc = collision.bc_as<aod::BCsWithTimestamps>();
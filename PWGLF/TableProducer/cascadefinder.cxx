@@ -40,6 +40,7 @@
 #include "Common/DataModel/PIDResponse.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/DataModel/LFStrangenessFinderTables.h"
+#include "PWGLF/Utils/trackPairPretests.h"
 #include "Common/Core/TrackSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/DataModel/EventSelection.h"
@@ -56,6 +57,7 @@
 #include <cmath>
 #include <array>
 #include <cstdlib>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -141,12 +143,18 @@ struct cascadefinder {
   // Configurables
   Configurable<double> d_bz{"d_bz", +5.0, "bz field"};
   Configurable<double> d_UseAbsDCA{"d_UseAbsDCA", kTRUE, "Use Abs DCAs"};
+  Configurable<float> d_maxDXYIni{"d_maxDXYIni", 4, "Dont consider a cascade seed (V0 line and bachelor circle intersection) if XY distance exceeds this"};
+  Configurable<bool> d_UseCirclePretest{"d_UseCirclePretest", true, "reject the V0-bachelor pairs further apart than d_maxDXYIni before fitting them"};
 
   // Selection criteria
   Configurable<double> v0cospa{"casccospa", 0.998, "Casc CosPA"}; // double -> N.B. dcos(x)/dx = 0 at x=0)
   Configurable<float> dcav0dau{"dcacascdau", 1.0, "DCA Casc Daughters"};
   Configurable<float> v0radius{"cascradius", 1.0, "cascradius"};
 
+  // bachelor tracks with their circles, converted once per collision
+  std::vector<o2::analysis::FinderTrack> posBachFinderTracks;
+  std::vector<o2::analysis::FinderTrack> negBachFinderTracks;
+
   // Process: subscribes to a lot of things!
   void process(aod::Collision const& collision,
                soa::Join<aod::FullTracks, aod::TracksCov> const& tracks,
@@ -173,6 +181,7 @@ struct cascadefinder {
     fitterCasc.setMinParamChange(1e-3);
     fitterCasc.setMinRelChi2Change(0.9);
     fitterCasc.setMaxDZIni(1e9);
+    fitterCasc.setMaxDXYIni(d_maxDXYIni);
     fitterCasc.setMaxChi2(1e9);
     fitterCasc.setUseAbsDCA(d_UseAbsDCA);
 
@@ -184,6 +193,15 @@ struct cascadefinder {
     std::array<float, 3> pvecneg = {0.};
     std::array<float, 3> pvecbach = {0.};
 
+    negBachFinderTracks.clear();
+    for (auto& t0id : nBachtracks) {
+      negBachFinderTracks.emplace_back(getTrackParCov(t0id.goodNegTrack_as<soa::Join<aod::FullTracks, aod::TracksCov>>()), d_bz);
+    }
+    posBachFinderTracks.clear();
+    for (auto& t0id : pBachtracks) {
+      posBachFinderTracks.emplace_back(getTrackParCov(t0id.goodPosTrack_as<soa::Join<aod::FullTracks, aod::TracksCov>>()), d_bz);
+    }
+
     // Cascades first
     for (auto& v0id : lambdas) {
       // required: de-reference the tracks for cascade building
@@ -227,9 +245,15 @@ struct cascadefinder {
         auto tV0 = o2::track::TrackParCov(vertex, momentum, covV0, 0);
         tV0.setQ2Pt(0); // No bending, please
 
+        std::size_t iBach = 0;
         for (auto& t0id : nBachtracks) {
+          auto const& bachFinderTrack = negBachFinderTracks[iBach++];
+          // the fitter would not find a seed for a V0 line this far from the bachelor circle
+          if (d_UseCirclePretest && o2::analysis::getLineCircleDistanceXY(vertex[0], vertex[1], momentum[0], momentum[1], bachFinderTrack.circle) > d_maxDXYIni) {
+            continue;
+          }
           auto t0 = t0id.goodNegTrack_as<soa::Join<aod::FullTracks, aod::TracksCov>>();
-          auto bTrack = getTrackParCov(t0);
+          auto const& bTrack = bachFinderTrack.trackParCov;
 
           int nCand2 = fitterCasc.process(tV0, bTrack);
           if (nCand2 != 0) {
@@ -317,9 +341,15 @@ struct cascadefinder {
         auto tV0 = o2::track::TrackParCov(vertex, momentum, covV0, 0);
         tV0.setQ2Pt(0); // No bending, please
 
+        std::size_t iBach = 0;
         for (auto& t0id : pBachtracks) {
+          auto const& bachFinderTrack = posBachFinderTracks[iBach++];
+          // the fitter would not find a seed for a V0 line this far from the bachelor circle
+          if (d_UseCirclePretest && o2::analysis::getLineCircleDistanceXY(vertex[0], vertex[1], momentum[0], momentum[1], bachFinderTrack.circle) > d_maxDXYIni) {
+            continue;
+          }
           auto t0 = t0id.goodPosTrack_as<soa::Join<aod::FullTracks, aod::TracksCov>>();
-          auto bTrack = getTrackParCov(t0);
+          auto const& bTrack = bachFinderTrack.trackParCov;
 
           int nCand2 = fitterCasc.process(tV0, bTrack);
           if (nCand2 != 0) {
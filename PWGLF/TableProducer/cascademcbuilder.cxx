@@ -34,6 +34,7 @@
 #include "Common/Core/RecoDecay.h"
 #include "Common/Core/trackUtilities.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
+#include "PWGLF/Utils/mcMothers.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -57,7 +58,7 @@ struct cascademcbuilder {
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   // build cascade labels
-  void processCascades(aod::CascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& v0table, aod::McTrackLabels const&, aod::McParticles const&)
+  void processCascades(aod::CascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& v0table, aod::McTrackLabels const&, aod::McParticles const& particlesMC)
   {
     for (auto& casc : casctable) {
       int pdgCode = -1, pdgCodeMother = -1;
@@ -97,43 +98,35 @@ struct cascademcbuilder {
         pzbachmc = lMCBachTrack.pz();
 
         // Step 1: check if the mother is the same, go up a level
-        if (lMCNegTrack.has_mothers() && lMCPosTrack.has_mothers()) {
-          for (auto& lNegMother : lMCNegTrack.mothers_as<aod::McParticles>()) {
-            for (auto& lPosMother : lMCPosTrack.mothers_as<aod::McParticles>()) {
-              if (lNegMother == lPosMother) {
-                // acquire information
-                xlmc = lMCPosTrack.vx();
-                ylmc = lMCPosTrack.vy();
-                zlmc = lMCPosTrack.vz();
-                pdgCodeV0 = lNegMother.pdgCode();
+        int lV0MotherId = o2::analysis::getCommonMotherId(lMCNegTrack, lMCPosTrack);
+        if (lV0MotherId >= 0) {
+          auto lV0Particle = particlesMC.rawIteratorAt(lV0MotherId);
+          // acquire information
+          xlmc = lMCPosTrack.vx();
+          ylmc = lMCPosTrack.vy();
+          zlmc = lMCPosTrack.vz();
+          pdgCodeV0 = lV0Particle.pdgCode();
 
-                // if we got to this level, it means the mother particle exists and is the same
-                // now we have to go one level up and compare to the bachelor mother too
-                for (auto& lV0Mother : lNegMother.mothers_as<aod::McParticles>()) {
-                  for (auto& lBachMother : lMCBachTrack.mothers_as<aod::McParticles>()) {
-                    if (lV0Mother == lBachMother) {
-                      lLabel = lV0Mother.globalIndex();
-                      pdgCode = lV0Mother.pdgCode();
-                      isPhysicalPrimary = lV0Mother.isPhysicalPrimary();
-                      xmc = lMCBachTrack.vx();
-                      ymc = lMCBachTrack.vy();
-                      zmc = lMCBachTrack.vz();
-                      px = lV0Mother.px();
-                      py = lV0Mother.py();
-                      pz = lV0Mother.pz();
-                      if (lV0Mother.has_mothers()) {
-                        for (auto& lV0GrandMother : lV0Mother.mothers_as<aod::McParticles>()) {
-                          pdgCodeMother = lV0GrandMother.pdgCode();
-                          lMotherLabel = lV0GrandMother.globalIndex();
-                        }
-                      }
-                    }
-                  }
-                } // end conditional V0-bach pair
-              }   // end neg = pos mother conditional
+          // if we got to this level, it means the mother particle exists and is the same
+          // now we have to go one level up and compare to the bachelor mother too
+          int lCascMotherId = o2::analysis::getCommonMotherId(lV0Particle, lMCBachTrack);
+          if (lCascMotherId >= 0) {
+            auto lV0Mother = particlesMC.rawIteratorAt(lCascMotherId);
+            lLabel = lCascMotherId;
+            pdgCode = lV0Mother.pdgCode();
+            isPhysicalPrimary = lV0Mother.isPhysicalPrimary();
+            xmc = lMCBachTrack.vx();
+            ymc = lMCBachTrack.vy();
+            zmc = lMCBachTrack.vz();
+            px = lV0Mother.px();
+            py = lV0Mother.py();
+            pz = lV0Mother.pz();
+            lMotherLabel = o2::analysis::getLastMotherId(lV0Mother);
+            if (lMotherLabel >= 0) {
+              pdgCodeMother = particlesMC.rawIteratorAt(lMotherLabel).pdgCode();
             }
-          } // end loop neg/pos mothers
-        }   // end conditional of mothers existing
+          } // end conditional V0-bach pair
+        }   // end neg = pos mother conditional
       }     // end association check
       // Construct label table (note: this will be joinable with CascDatas)
       casclabels(
@@ -153,7 +146,7 @@ struct cascademcbuilder {
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   // build kf cascade labels
-  void processKFCascades(aod::KFCascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& v0table, aod::McTrackLabels const&, aod::McParticles const&)
+  void processKFCascades(aod::KFCascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& v0table, aod::McTrackLabels const&, aod::McParticles const& particlesMC)
   {
     for (auto& casc : casctable) {
       int lLabel = -1;
@@ -170,24 +163,13 @@ struct cascademcbuilder {
         auto lMCNegTrack = lNegTrack.mcParticle_as<aod::McParticles>();
         auto lMCPosTrack = lPosTrack.mcParticle_as<aod::McParticles>();
         // Step 1: check if the mother is the same, go up a level
-        if (lMCNegTrack.has_mothers() && lMCPosTrack.has_mothers()) {
-          for (auto& lNegMother : lMCNegTrack.mothers_as<aod::McParticles>()) {
-            for (auto& lPosMother : lMCPosTrack.mothers_as<aod::McParticles>()) {
-              if (lNegMother == lPosMother) {
-                // if we got to this level, it means the mother particle exists and is the same
-                // now we have to go one level up and compare to the bachelor mother too
-                for (auto& lV0Mother : lNegMother.mothers_as<aod::McParticles>()) {
-                  for (auto& lBachMother : lMCBachTrack.mothers_as<aod::McParticles>()) {
-                    if (lV0Mother == lBachMother) {
-                      lLabel = lV0Mother.globalIndex();
-                    }
-                  }
-                } // end conditional V0-bach pair
-              }   // end neg = pos mother conditional
-            }
-          } // end loop neg/pos mothers
-        }   // end conditional of mothers existing
-      }     // end association check
+        int lV0MotherId = o2::analysis::getCommonMotherId(lMCNegTrack, lMCPosTrack);
+        if (lV0MotherId >= 0) {
+          // if we got to this level, it means the mother particle exists and is the same
+          // now we have to go one level up and compare to the bachelor mother too
+          lLabel = o2::analysis::getCommonMotherId(particlesMC.rawIteratorAt(lV0MotherId), lMCBachTrack);
+        } // end neg = pos mother conditional
+      }   // end association check
       // Construct label table (note: this will be joinable with CascDatas)
       kfcasclabels(
         lLabel);
@@ -196,7 +178,7 @@ struct cascademcbuilder {
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   // build tracked cascade labels
-  void processTrackedCascades(aod::TraCascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& v0table, aod::McTrackLabels const&, aod::McParticles const&)
+  void processTrackedCascades(aod::TraCascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& v0table, aod::McTrackLabels const&, aod::McParticles const& particlesMC)
   {
     for (auto& casc : casctable) {
       int lLabel = -1;
@@ -213,24 +195,13 @@ struct cascademcbuilder {
         auto lMCNegTrack = lNegTrack.mcParticle_as<aod::McParticles>();
         auto lMCPosTrack = lPosTrack.mcParticle_as<aod::McParticles>();
         // Step 1: check if the mother is the same, go up a level
-        if (lMCNegTrack.has_mothers() && lMCPosTrack.has_mothers()) {
-          for (auto& lNegMother : lMCNegTrack.mothers_as<aod::McParticles>()) {
-            for (auto& lPosMother : lMCPosTrack.mothers_as<aod::McParticles>()) {
-              if (lNegMother == lPosMother) {
-                // if we got to this level, it means the mother particle exists and is the same
-                // now we have to go one level up and compare to the bachelor mother too
-                for (auto& lV0Mother : lNegMother.mothers_as<aod::McParticles>()) {
-                  for (auto& lBachMother : lMCBachTrack.mothers_as<aod::McParticles>()) {
-                    if (lV0Mother == lBachMother) {
-                      lLabel = lV0Mother.globalIndex();
-                    }
-                  }
-                } // end conditional V0-bach pair
-              }   // end neg = pos mother conditional
-            }
-          } // end loop neg/pos mothers
-        }   // end conditional of mothers existing
-      }     // end association check
+        int lV0MotherId = o2::analysis::getCommonMotherId(lMCNegTrack, lMCPosTrack);
+        if (lV0MotherId >= 0) {
+          // if we got to this level, it means the mother particle exists and is the same
+          // now we have to go one level up and compare to the bachelor mother too
+          lLabel = o2::analysis::getCommonMotherId(particlesMC.rawIteratorAt(lV0MotherId), lMCBachTrack);
+        } // end neg = pos mother conditional
+      }   // end association check
       // Construct label table (note: this will be joinable with CascDatas)
       tracasclabels(
         lLabel);
@@ -239,7 +210,7 @@ struct cascademcbuilder {
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   // build cascade labels
-  void processBBTags(aod::CascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& v0table, aod::McTrackLabels const&, aod::McParticles const&)
+  void processBBTags(aod::CascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& v0table, aod::McTrackLabels const&, aod::McParticles const& particlesMC)
   {
     for (auto& casc : casctable) {
       bool bbTag = false; // bachelor-baryon correlation tag to pass
@@ -258,11 +229,9 @@ struct cascademcbuilder {
           if (lNegTrack.has_mcParticle()) {
             auto baryonParticle = lNegTrack.mcParticle_as<aod::McParticles>();
             if (baryonParticle.has_mothers() && bachelorParticle.has_mothers() && baryonParticle.pdgCode() == -2212) {
-              for (auto& baryonMother : baryonParticle.mothers_as<aod::McParticles>()) {
-                for (auto& pionMother : bachelorParticle.mothers_as<aod::McParticles>()) {
-                  if (baryonMother.globalIndex() == pionMother.globalIndex() && baryonMother.pdgCode() == -3122) {
-                    bbTag = true;
-                  }
+              for (const auto& baryonMotherId : baryonParticle.mothersIds()) {
+                if (baryonMotherId >= 0 && o2::analysis::hasMotherId(bachelorParticle, baryonMotherId) && particlesMC.rawIteratorAt(baryonMotherId).pdgCode() == -3122) {
+                  bbTag = true;
                 }
               }
             }
@@ -272,11 +241,9 @@ struct cascademcbuilder {
           if (lNegTrack.has_mcParticle()) {
             auto baryonParticle = lPosTrack.mcParticle_as<aod::McParticles>();
             if (baryonParticle.has_mothers() && bachelorParticle.has_mothers() && baryonParticle.pdgCode() == 2212) {
-              for (auto& baryonMother : baryonParticle.mothers_as<aod::McParticles>()) {
-                for (auto& pionMother : bachelorParticle.mothers_as<aod::McParticles>()) {
-                  if (baryonMother.globalIndex() == pionMother.globalIndex() && baryonMother.pdgCode() == 3122) {
-                    bbTag = true;
-                  }
+              for (const auto& baryonMotherId : baryonParticle.mothersIds()) {
+                if (baryonMotherId >= 0 && o2::analysis::hasMotherId(bachelorParticle, baryonMotherId) && particlesMC.rawIteratorAt(baryonMotherId).pdgCode() == 3122) {
+                  bbTag = true;
                 }
               }
             }
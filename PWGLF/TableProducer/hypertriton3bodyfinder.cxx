@@ -16,6 +16,7 @@
 #include <array>
 #include <cstdlib>
 #include <iterator>
+#include <vector>
 
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
@@ -27,6 +28,7 @@
 #include "Common/Core/trackUtilities.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/DataModel/Vtx3BodyTables.h"
+#include "PWGLF/Utils/mcMothers.h"
 #include "Common/Core/TrackSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/DataModel/EventSelection.h"
@@ -436,8 +438,8 @@ struct hypertriton3bodyFinder {
         continue;
       }
       bool flag_H3L = false;
-      for (auto& mothertrack : mcgoodtrack.template mothers_as<aod::McParticles>()) {
-        if (is3bodyDecayedH3L<aod::McParticles>(mothertrack)) {
+      for (const auto& motherId : mcgoodtrack.mothersIds()) {
+        if (motherId >= 0 && is3bodyDecayedH3L<aod::McParticles>(mcparticles.rawIteratorAt(motherId))) {
           flag_H3L = true;
         }
       }
@@ -453,22 +455,63 @@ struct hypertriton3bodyFinder {
     }
   }
 
+  //------------------------------------------------------------------
+  // Candidate daughters of the current collision: the track parametrisations are converted once per
+  // collision instead of once per combination, the DCAs to the PV are propagated at most once per track
+  struct DaughterTrack {
+    o2::track::TrackParCov trackParCov;
+    float dcaXY;
+    bool hasDcaXY;
+  };
+  std::vector<DaughterTrack> posDaughters;
+  std::vector<DaughterTrack> negDaughters;
+  std::vector<DaughterTrack> goodDaughters;
+
+  template <class TTrackTo, typename TTrackIdTable>
+  void fillDaughterTracks(TTrackIdTable const& dTrackIds, std::vector<DaughterTrack>& daughters)
+  {
+    daughters.clear();
+    for (auto& trackId : dTrackIds) {
+      daughters.push_back({getTrackParCov(trackId.template goodTrack_as<TTrackTo>()), 0.f, false});
+    }
+  }
+
+  // Calculate DCA with respect to the collision associated to the V0, not individual tracks
+  template <typename TCollisionTable>
+  float getDaughterDcaXY(TCollisionTable const& dCollision, DaughterTrack& daughter)
+  {
+    if (!daughter.hasDcaXY) {
+      gpu::gpustd::array<float, 2> dcaInfo;
+      o2::track::TrackPar trackPar = daughter.trackParCov;
+      o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, trackPar, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
+      daughter.dcaXY = dcaInfo[0];
+      daughter.hasDcaXY = true;
+    }
+    return daughter.dcaXY;
+  }
+
   o2::dataformats::VertexBase mMeanVertex{{0., 0., 0.}, {0.1 * 0.1, 0., 0.1 * 0.1, 0., 0., 6. * 6.}};
   //------------------------------------------------------------------
   // 3body decay finder
   template <class TTrackTo, typename TCollisionTable, typename TPosTrackTable, typename TNegTrackTable, typename TGoodTrackTable>
   void DecayFinder(TCollisionTable const& dCollision, TPosTrackTable const& dPtracks, TNegTrackTable const& dNtracks, TGoodTrackTable const& dGoodtracks)
   {
+    fillDaughterTracks<TTrackTo>(dPtracks, posDaughters);
+    fillDaughterTracks<TTrackTo>(dNtracks, negDaughters);
+    fillDaughterTracks<TTrackTo>(dGoodtracks, goodDaughters);
+
+    std::size_t iPos = 0;
     for (auto& t0id : dPtracks) { // FIXME: turn into combination(...)
       auto t0 = t0id.template goodTrack_as<TTrackTo>();
-      auto Track0 = getTrackParCov(t0);
+      auto& daughter0 = posDaughters[iPos++];
 
+      std::size_t iNeg = 0;
       for (auto& t1id : dNtracks) {
+        auto& daughter1 = negDaughters[iNeg++];
 
         FillV0Counter(kV0All);
         auto t1 = t1id.template goodTrack_as<TTrackTo>();
-        auto Track1 = getTrackParCov(t1);
-        int nCand = fitter.process(Track0, Track1);
+        int nCand = fitter.process(daughter0.trackParCov, daughter1.trackParCov);
         if (nCand == 0) {
           continue;
         }
@@ -541,23 +584,23 @@ struct hypertriton3bodyFinder {
         }
         FillV0Counter(kV0CosPA);
 
+        std::size_t iGood = 0;
         for (auto& t2id : dGoodtracks) {
+          auto& daughter2 = goodDaughters[iGood++];
           if (t2id.globalIndex() == t0id.globalIndex()) {
             continue; // skip the track used by V0
           }
           FillVtxCounter(kVtxAll);
 
           auto t2 = t2id.template goodTrack_as<TTrackTo>();
-          auto track0 = getTrackParCov(t0);
-          auto track1 = getTrackParCov(t1);
-          auto bach = getTrackParCov(t2);
+          auto const& bach = daughter2.trackParCov;
 
           if (bach.getPt() < 0.6) {
             continue;
           }
           FillVtxCounter(kVtxbachPt);
 
-          int n3bodyVtx = fitter3body.process(track0, track1, bach);
+          int n3bodyVtx = fitter3body.process(daughter0.trackParCov, daughter1.trackParCov, bach);
           if (n3bodyVtx == 0) { // discard this pair
             continue;
           }
@@ -611,20 +654,9 @@ struct hypertriton3bodyFinder {
           }
           FillVtxCounter(kVtxDcaDau);
 
-          // Calculate DCA with respect to the collision associated to the V0, not individual tracks
-          gpu::gpustd::array<float, 2> dcaInfo;
-
-          auto Track0Par = getTrackPar(t0);
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, Track0Par, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
-          auto Track0dcaXY = dcaInfo[0];
-
-          auto Track1Par = getTrackPar(t1);
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, Track1Par, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
-          auto Track1dcaXY = dcaInfo[0];
-
-          auto Track2Par = getTrackPar(t2);
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, Track2Par, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
-          auto Track2dcaXY = dcaInfo[0];
+          auto Track0dcaXY = getDaughterDcaXY(dCollision, daughter0);
+          auto Track1dcaXY = getDaughterDcaXY(dCollision, daughter1);
+          auto Track2dcaXY = getDaughterDcaXY(dCollision, daughter2);
 
           //  Not involved: H3L DCA Check
           vtx3bodydata(
@@ -642,18 +674,24 @@ struct hypertriton3bodyFinder {
   //------------------------------------------------------------------
   // MC 3body decay finder
   template <class TTrackTo, typename TCollisionTable, typename TPosTrackTable, typename TNegTrackTable, typename TGoodTrackTable>
-  void DecayFinderMC(TCollisionTable const& dCollision, TPosTrackTable const& dPtracks, TNegTrackTable const& dNtracks, TGoodTrackTable const& dGoodtracks)
+  void DecayFinderMC(TCollisionTable const& dCollision, TPosTrackTable const& dPtracks, TNegTrackTable const& dNtracks, TGoodTrackTable const& dGoodtracks, aod::McParticles const& mcparticles)
   {
+    fillDaughterTracks<TTrackTo>(dPtracks, posDaughters);
+    fillDaughterTracks<TTrackTo>(dNtracks, negDaughters);
+    fillDaughterTracks<TTrackTo>(dGoodtracks, goodDaughters);
+
+    std::size_t iPos = 0;
     for (auto& t0id : dPtracks) { // FIXME: turn into combination(...)
       auto t0 = t0id.template goodTrack_as<TTrackTo>();
-      auto Track0 = getTrackParCov(t0);
+      auto& daughter0 = posDaughters[iPos++];
+      std::size_t iNeg = 0;
       for (auto& t1id : dNtracks) {
+        auto& daughter1 = negDaughters[iNeg++];
 
         if (t0id.collisionId() != t1id.collisionId()) {
           continue;
         }
         auto t1 = t1id.template goodTrack_as<TTrackTo>();
-        auto Track1 = getTrackParCov(t1);
 
         bool isTrue3bodyV0 = false;
         if (t0.has_mcParticle() && t1.has_mcParticle()) {
@@ -661,11 +699,9 @@ struct hypertriton3bodyFinder {
           auto t1mc = t1.template mcParticle_as<aod::McParticles>();
           if ((t0mc.pdgCode() == 2212 && t1mc.pdgCode() == -211) || (t0mc.pdgCode() == 211 && t1mc.pdgCode() == -2212)) {
             if (t0mc.has_mothers() && t1mc.has_mothers()) {
-              for (auto& t0mother : t0mc.template mothers_as<aod::McParticles>()) {
-                for (auto& t1mother : t1mc.template mothers_as<aod::McParticles>()) {
-                  if (t0mother.globalIndex() == t1mother.globalIndex() && std::abs(t0mother.pdgCode()) == 1010010030) {
-                    isTrue3bodyV0 = true;
-                  }
+              for (const auto& t0motherId : t0mc.mothersIds()) {
+                if (t0motherId >= 0 && o2::analysis::hasMotherId(t1mc, t0motherId) && std::abs(mcparticles.rawIteratorAt(t0motherId).pdgCode()) == 1010010030) {
+                  isTrue3bodyV0 = true;
                 }
               }
             }
@@ -677,7 +713,7 @@ struct hypertriton3bodyFinder {
           continue;
         }
 
-        int nCand = fitter.process(Track0, Track1);
+        int nCand = fitter.process(daughter0.trackParCov, daughter1.trackParCov);
         if (nCand == 0) {
           continue;
         }
@@ -750,14 +786,14 @@ struct hypertriton3bodyFinder {
         }
         FillV0Counter(kV0CosPA, isTrue3bodyV0);
 
+        std::size_t iGood = 0;
         for (auto& t2id : dGoodtracks) {
+          auto& daughter2 = goodDaughters[iGood++];
           if (t2id.globalIndex() == t0id.globalIndex()) {
             continue; // skip the track used by V0
           }
           auto t2 = t2id.template goodTrack_as<TTrackTo>();
-          auto track0 = getTrackParCov(t0);
-          auto track1 = getTrackParCov(t1);
-          auto bach = getTrackParCov(t2);
+          auto const& bach = daughter2.trackParCov;
 
           bool isTrue3bodyVtx = false;
           if (t0.has_mcParticle() && t1.has_mcParticle() && t2.has_mcParticle()) {
@@ -766,13 +802,9 @@ struct hypertriton3bodyFinder {
             auto t2mc = t2.template mcParticle_as<aod::McParticles>();
             if ((t0mc.pdgCode() == 2212 && t1mc.pdgCode() == -211 && t2mc.pdgCode() == 1000010020) || (t0mc.pdgCode() == 211 && t1mc.pdgCode() == -2212 && t2mc.pdgCode() == -1000010020)) {
               if (t0mc.has_mothers() && t1mc.has_mothers() && t2mc.has_mothers()) {
-                for (auto& t0mother : t0mc.template mothers_as<aod::McParticles>()) {
-                  for (auto& t1mother : t1mc.template mothers_as<aod::McParticles>()) {
-                    for (auto& t2mother : t2mc.template mothers_as<aod::McParticles>()) {
-                      if (t0mother.globalIndex() == t1mother.globalIndex() && t0mother.globalIndex() == t2mother.globalIndex() && std::abs(t0mother.pdgCode()) == 1010010030) {
-                        isTrue3bodyVtx = true;
-                      }
-                    }
+                for (const auto& t0motherId : t0mc.mothersIds()) {
+                  if (t0motherId >= 0 && o2::analysis::hasMotherId(t1mc, t0motherId) && o2::analysis::hasMotherId(t2mc, t0motherId) && std::abs(mcparticles.rawIteratorAt(t0motherId).pdgCode()) == 1010010030) {
+                    isTrue3bodyVtx = true;
                   }
                 }
               }
@@ -789,7 +821,7 @@ struct hypertriton3bodyFinder {
           }
           FillVtxCounter(kVtxbachPt, isTrue3bodyVtx);
 
-          int n3bodyVtx = fitter3body.process(track0, track1, bach);
+          int n3bodyVtx = fitter3body.process(daughter0.trackParCov, daughter1.trackParCov, bach);
           if (n3bodyVtx == 0) { // discard this pair
             continue;
           }
@@ -844,20 +876,9 @@ struct hypertriton3bodyFinder {
           }
           FillVtxCounter(kVtxDcaDau, isTrue3bodyVtx);
 
-          // Calculate DCA with respect to the collision associated to the V0, not individual tracks
-          gpu::gpustd::array<float, 2> dcaInfo;
-
-          auto Track0Par = getTrackPar(t0);
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, Track0Par, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
-          auto Track0dcaXY = dcaInfo[0];
-
-          auto Track1Par = getTrackPar(t1);
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, Track1Par, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
-          auto Track1dcaXY = dcaInfo[0];
-
-          auto Track2Par = getTrackPar(t2);
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, Track2Par, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
-          auto Track2dcaXY = dcaInfo[0];
+          auto Track0dcaXY = getDaughterDcaXY(dCollision, daughter0);
+          auto Track1dcaXY = getDaughterDcaXY(dCollision, daughter1);
+          auto Track2dcaXY = getDaughterDcaXY(dCollision, daughter2);
 
           //  Not involved: H3L DCA Check
           // auto track3B = o2::track::TrackParCov(vertexXYZ, p3B, fitter3body.calcPCACovMatrixFlat(cand3B), t2.sign());
@@ -885,7 +906,7 @@ struct hypertriton3bodyFinder {
   //------------------------------------------------------------------
   // MC virtual lambda check
   template <class TTrackTo, typename TCollisionTable, typename TV0DataTable>
-  void VirtualLambdaCheck(TCollisionTable const& dCollision, TV0DataTable const& fullV0s, int bin)
+  void VirtualLambdaCheck(TCollisionTable const& dCollision, TV0DataTable const& fullV0s, int bin, aod::McParticles const& mcparticles)
   {
     for (auto& v0 : fullV0s) {
       statisticsRegistry.virtLambdastats[bin]++;
@@ -897,14 +918,13 @@ struct hypertriton3bodyFinder {
 
         if ((postrackmc.pdgCode() == 2212 && negtrackmc.pdgCode() == -211) || (postrackmc.pdgCode() == 211 && negtrackmc.pdgCode() == -2212)) {
           if (postrackmc.has_mothers() && negtrackmc.has_mothers()) {
-            for (auto& posmother : postrackmc.template mothers_as<aod::McParticles>()) {
-              for (auto& negmother : negtrackmc.template mothers_as<aod::McParticles>()) {
-                if (posmother.globalIndex() == negmother.globalIndex()) {
-                  if (posmother.pdgCode() == 1010010030)
-                    statisticsRegistry.virtLambdastats[bin + 1]++;
-                  else if (posmother.pdgCode() == -1010010030)
-                    statisticsRegistry.virtLambdastats[bin + 2]++;
-                }
+            for (const auto& posmotherId : postrackmc.mothersIds()) {
+              if (posmotherId >= 0 && o2::analysis::hasMotherId(negtrackmc, posmotherId)) {
+                auto posmother = mcparticles.rawIteratorAt(posmotherId);
+                if (posmother.pdgCode() == 1010010030)
+                  statisticsRegistry.virtLambdastats[bin + 1]++;
+                else if (posmother.pdgCode() == -1010010030)
+                  statisticsRegistry.virtLambdastats[bin + 2]++;
               }
             }
           }
@@ -957,7 +977,7 @@ struct hypertriton3bodyFinder {
     registry.fill(HIST("hEventCounter"), 0.5);
 
     CheckGoodTracks<FullTracksExtMCIU>(goodtracks, mcparticles);
-    DecayFinderMC<FullTracksExtMCIU>(collision, ptracks, ntracks, goodtracks);
+    DecayFinderMC<FullTracksExtMCIU>(collision, ptracks, ntracks, goodtracks, mcparticles);
   }
   PROCESS_SWITCH(hypertriton3bodyFinder, processMC, "Produce StoredVtx3BodyDatas with MC", false);
 
@@ -974,8 +994,8 @@ struct hypertriton3bodyFinder {
       CheckGoodTracks<FullTracksExtMCIU>(goodtracks, mcparticles);
       auto v0s = V0s.sliceBy(perCollisionV0s, collision.globalIndex());
       auto fullv0s = fullV0s.sliceBy(perCollisionV0Datas, collision.globalIndex());
-      VirtualLambdaCheck<FullTracksExtMCIU>(collision, v0s, 0);
-      VirtualLambdaCheck<FullTracksExtMCIU>(collision, fullv0s, 3);
+      VirtualLambdaCheck<FullTracksExtMCIU>(collision, v0s, 0, mcparticles);
+      VirtualLambdaCheck<FullTracksExtMCIU>(collision, fullv0s, 3, mcparticles);
 
       if (!cffilter.hasLD() && UseCFFilter) {
         continue;
@@ -985,9 +1005,9 @@ struct hypertriton3bodyFinder {
       auto ptracks = Ptracks.sliceBy(perCollisionGoodPosTracks, collision.globalIndex());
       auto ntracks = Ntracks.sliceBy(perCollisionGoodNegTracks, collision.globalIndex());
 
-      VirtualLambdaCheck<FullTracksExtMCIU>(collision, v0s, 6);
-      VirtualLambdaCheck<FullTracksExtMCIU>(collision, fullv0s, 9);
-      DecayFinderMC<FullTracksExtMCIU>(collision, ptracks, ntracks, goodtracks);
+      VirtualLambdaCheck<FullTracksExtMCIU>(collision, v0s, 6, mcparticles);
+      VirtualLambdaCheck<FullTracksExtMCIU>(collision, fullv0s, 9, mcparticles);
+      DecayFinderMC<FullTracksExtMCIU>(collision, ptracks, ntracks, goodtracks, mcparticles);
     }
   }
   PROCESS_SWITCH(hypertriton3bodyFinder, processCFFilteredMC, "Produce StoredVtx3BodyDatas with MC using CFtriggers", false);
@@ -1073,18 +1093,14 @@ struct hypertriton3bodyLabelBuilder {
         continue;
       }
 
-      for (auto& lMother0 : lMCTrack0.mothers_as<aod::McParticles>()) {
-        for (auto& lMother1 : lMCTrack1.mothers_as<aod::McParticles>()) {
-          for (auto& lMother2 : lMCTrack2.mothers_as<aod::McParticles>()) {
-            if (lMother0.globalIndex() == lMother1.globalIndex() && lMother0.globalIndex() == lMother2.globalIndex()) {
-              lGlobalIndex = lMother1.globalIndex();
-              lPt = lMother1.pt();
-              lPDG = lMother1.pdgCode();
-              MClifetime = RecoDecay::sqrtSumOfSquares(lMCTrack2.vx() - lMother2.vx(), lMCTrack2.vy() - lMother2.vy(), lMCTrack2.vz() - lMother2.vz()) * o2::constants::physics::MassHyperTriton / lMother2.p();
-              is3bodyDecay = true; // vtxs with the same mother
-            }
-          }
-        }
+      int lMotherId = o2::analysis::getCommonMotherId(lMCTrack0, lMCTrack1, lMCTrack2);
+      if (lMotherId >= 0) {
+        auto lMother = particlesMC.rawIteratorAt(lMotherId);
+        lGlobalIndex = lMotherId;
+        lPt = lMother.pt();
+        lPDG = lMother.pdgCode();
+        MClifetime = RecoDecay::sqrtSumOfSquares(lMCTrack2.vx() - lMother.vx(), lMCTrack2.vy() - lMother.vy(), lMCTrack2.vz() - lMother.vz()) * o2::constants::physics::MassHyperTriton / lMother.p();
+        is3bodyDecay = true; // vtxs with the same mother
       } // end association check
       if (!is3bodyDecay) {
         vtxlabels(-1);
@@ -37,11 +37,14 @@
 //
 
 #include <cmath>
+#include <algorithm>
 #include <array>
 #include <cstdlib>
 #include <map>
 #include <iterator>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "Framework/runDataProcessing.h"
 #include "Framework/RunningWorkflowInfo.h"
@@ -50,6 +53,7 @@
 #include "Framework/ASoAHelpers.h"
 #include "DCAFitter/DCAFitterN.h"
 #include "ReconstructionDataFormats/Track.h"
+#include "Common/Core/ProcessTimer.h"
 #include "Common/Core/RecoDecay.h"
 #include "Common/Core/trackUtilities.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
@@ -133,6 +137,7 @@ struct lambdakzeroBuilder {
   Configurable<float> d_maxDZIni{"d_maxDZIni", 1e9, "Dont consider a seed (circles intersection) if Z distance exceeds this"};
   Configurable<float> d_maxDXYIni{"d_maxDXYIni", 4, "Dont consider a seed (circles intersection) if XY distance exceeds this"};
   Configurable<int> useMatCorrType{"useMatCorrType", 2, "0: none, 1: TGeo, 2: LUT"};
+  Configurable<int> nThreadsV0Fit{"nThreadsV0Fit", 1, "number of threads for the V0 fits (1: fit the V0s one by one while building them)"};
   Configurable<int> rejDiffCollTracks{"rejDiffCollTracks", 0, "rejDiffCollTracks"};
   Configurable<bool> d_doTrackQA{"d_doTrackQA", false, "do track QA"};
   Configurable<bool> d_QA_checkMC{"d_QA_checkMC", true, "check MC truth in QA"};
@@ -155,6 +160,7 @@ struct lambdakzeroBuilder {
 
   // generate and fill extra QA histograms if requested
   Configurable<bool> d_doQA{"d_doQA", false, "Do basic QA"};
+  Configurable<bool> enableTimer{"enableTimer", false, "time the V0 building (histograms in ProcessTimer/)"};
   Configurable<int> dQANBinsRadius{"dQANBinsRadius", 500, "Number of radius bins in QA histo"};
   Configurable<int> dQANBinsPtCoarse{"dQANBinsPtCoarse", 10, "Number of pT bins in QA histo"};
   Configurable<int> dQANBinsMass{"dQANBinsMass", 400, "Number of mass bins for QA histograms"};
@@ -189,6 +195,7 @@ struct lambdakzeroBuilder {
 
   // Define o2 fitter, 2-prong, active memory (no need to redefine per event)
   o2::vertexing::DCAFitterN<2> fitter;
+  std::vector<o2::vertexing::DCAFitterN<2>> threadFitters; // one fitter per thread if nThreadsV0Fit > 1
 
   Filter taggedFilter = aod::v0tag::isInteresting == true;
 
@@ -221,8 +228,37 @@ struct lambdakzeroBuilder {
     float V0radius;
     float lambdaMass;
     float antilambdaMass;
+    std::array<float, 6> positionCovariance;
   } v0candidate;
 
+  // Helper struct with the daughter DCAs to the PV and the V0 fit, obtained before the selections
+  struct V0Fit {
+    o2::track::TrackPar posTrackPar; // at the DCA to the PV
+    o2::track::TrackPar negTrackPar; // at the DCA to the PV
+    gpu::gpustd::array<float, 2> negDCAInfo;
+    float posDCAxy;
+    float negDCAxy;
+    bool passesDCAxy;
+    bool caughtException;
+    bool isFitted;
+    o2::track::TrackParCov posTrack; // at the PCA
+    o2::track::TrackParCov negTrack; // at the PCA
+    std::array<float, 3> pos;
+    float chi2PCA;
+    std::array<float, 6> covPCA;
+  };
+  V0Fit v0fit; // fit of the V0 being built if nThreadsV0Fit == 1
+
+  // V0 fits of the time frame, in the V0 order, if nThreadsV0Fit > 1
+  struct V0FitInput {
+    std::array<float, 3> primaryVertex;
+    bool passesTPCrefit;
+    o2::track::TrackParCov posTrack;
+    o2::track::TrackParCov negTrack;
+  };
+  std::vector<V0FitInput> v0fitInputs;
+  std::vector<V0Fit> v0fits;
+
   // Helper struct to do bookkeeping of building parameters
   struct {
     std::array<int32_t, kNV0Steps> v0stats;
@@ -239,6 +275,12 @@ struct lambdakzeroBuilder {
      {"hPositiveITSClusters", "hPositiveITSClusters", {HistType::kTH1D, {{10, -0.5f, 9.5f}}}},
      {"hNegativeITSClusters", "hNegativeITSClusters", {HistType::kTH1D, {{10, -0.5f, 9.5f}}}}}};
 
+  // timed section, counting the V0s
+  enum TimerSection {
+    TimerBuild = 0
+  };
+  o2::analysis::ProcessTimer timer;
+
   float CalculateDCAStraightToPV(float X, float Y, float Z, float Px, float Py, float Pz, float pvX, float pvY, float pvZ)
   {
     return std::sqrt((std::pow((pvY - Y) * Pz - (pvZ - Z) * Py, 2) + std::pow((pvX - X) * Pz - (pvZ - Z) * Px, 2) + std::pow((pvX - X) * Py - (pvY - Y) * Px, 2)) / (Px * Px + Py * Py + Pz * Pz));
@@ -293,6 +335,7 @@ struct lambdakzeroBuilder {
   void init(InitContext& context)
   {
     resetHistos();
+    timer.init(registry, {"V0 building"}, enableTimer);
 
     auto h = registry.add<TH1>("hV0Criteria", "hV0Criteria", kTH1D, {{10, -0.5f, 9.5f}});
     h->GetXaxis()->SetBinLabel(1, "All sel");
@@ -484,24 +527,43 @@ struct lambdakzeroBuilder {
     }
     //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
 
-    // initialize O2 2-prong fitter (only once)
-    fitter.setPropagateToPCA(true);
-    fitter.setMaxR(200.);
-    fitter.setMinParamChange(1e-3);
-    fitter.setMinRelChi2Change(0.9);
-    fitter.setMaxDZIni(d_maxDZIni);
-    fitter.setMaxDXYIni(d_maxDXYIni);
-    fitter.setMaxChi2(1e9);
-    fitter.setUseAbsDCA(d_UseAbsDCA);
-    fitter.setWeightedFinalPCA(d_UseWeightedPCA);
-
     // Material correction in the DCA fitter
     o2::base::Propagator::MatCorrType matCorr = o2::base::Propagator::MatCorrType::USEMatCorrNONE;
     if (useMatCorrType == 1)
       matCorr = o2::base::Propagator::MatCorrType::USEMatCorrTGeo;
     if (useMatCorrType == 2)
       matCorr = o2::base::Propagator::MatCorrType::USEMatCorrLUT;
-    fitter.setMatCorrType(matCorr);
+
+    if (nThreadsV0Fit > 1) {
+      if (useMatCorrType == 1) {
+        LOGF(fatal, "The TGeo material correction is not thread safe. Please use the LUT or set nThreadsV0Fit to 1.");
+      }
+      LOGF(info, " ---+*> V0 fits will run in %d threads", nThreadsV0Fit.value);
+      threadFitters.resize(nThreadsV0Fit);
+    }
+
+    // initialize O2 2-prong fitters (only once)
+    for (auto* df : getFitters()) {
+      df->setPropagateToPCA(true);
+      df->setMaxR(200.);
+      df->setMinParamChange(1e-3);
+      df->setMinRelChi2Change(0.9);
+      df->setMaxDZIni(d_maxDZIni);
+      df->setMaxDXYIni(d_maxDXYIni);
+      df->setMaxChi2(1e9);
+      df->setUseAbsDCA(d_UseAbsDCA);
+      df->setWeightedFinalPCA(d_UseWeightedPCA);
+      df->setMatCorrType(matCorr);
+    }
+  }
+
+  std::vector<o2::vertexing::DCAFitterN<2>*> getFitters()
+  {
+    std::vector<o2::vertexing::DCAFitterN<2>*> fitters{&fitter};
+    for (auto& df : threadFitters) {
+      fitters.push_back(&df);
+    }
+    return fitters;
   }
 
   void initCCDB(aod::BCsWithTimestamps::iterator const& bc)
@@ -513,7 +575,9 @@ struct lambdakzeroBuilder {
     // In case override, don't proceed, please - no CCDB access required
     if (d_bz_input > -990) {
       d_bz = d_bz_input;
-      fitter.setBz(d_bz);
+      for (auto* df : getFitters()) {
+        df->setBz(d_bz);
+      }
       o2::parameters::GRPMagField grpmag;
       if (fabs(d_bz) > 1e-5) {
         grpmag.setL3Current(30000.f / (d_bz / 5.0f));
@@ -547,7 +611,9 @@ struct lambdakzeroBuilder {
     mVtx = ccdb->getForTimeStamp<o2::dataformats::MeanVertexObject>(mVtxPath, bc.timestamp());
     mRunNumber = bc.runNumber();
     // Set magnetic field value once known
-    fitter.setBz(d_bz);
+    for (auto* df : getFitters()) {
+      df->setBz(d_bz);
+    }
 
     if (useMatCorrType == 2) {
       // setMatLUT only after magfield has been initalized
@@ -556,13 +622,9 @@ struct lambdakzeroBuilder {
     }
   }
 
-  template <class TTrackTo, typename TV0Object>
-  bool buildV0Candidate(TV0Object const& V0)
+  template <typename TV0Object>
+  o2::dataformats::VertexBase getPrimaryVertex(TV0Object const& V0)
   {
-    // Get tracks
-    auto const& posTrack = V0.template posTrack_as<TTrackTo>();
-    auto const& negTrack = V0.template negTrack_as<TTrackTo>();
-
     // for storing whatever is the relevant quantity for the PV
     o2::dataformats::VertexBase primaryVertex;
     if (V0.has_collision()) {
@@ -572,76 +634,166 @@ struct lambdakzeroBuilder {
     } else {
       primaryVertex.setPos({mVtx->getX(), mVtx->getY(), mVtx->getZ()});
     }
+    return primaryVertex;
+  }
 
-    // value 0.5: any considered V0
-    statisticsRegistry.v0stats[kV0All]++;
-    if (tpcrefit) {
-      if (!(posTrack.trackType() & o2::aod::track::TPCrefit)) {
-        return false;
+  template <typename TTrack>
+  bool passesTPCrefit(TTrack const& posTrack, TTrack const& negTrack)
+  {
+    return !tpcrefit || ((posTrack.trackType() & o2::aod::track::TPCrefit) && (negTrack.trackType() & o2::aod::track::TPCrefit));
+  }
+
+  // Calculates the daughter DCAs with respect to the collision associated to the V0, not individual tracks,
+  // and fits the V0 if they pass the DCAxy selection. Only the given fitter is modified, so that several
+  // V0s can be fitted at the same time with one fitter per thread
+  void fitV0(o2::vertexing::DCAFitterN<2>& df, std::array<float, 3> const& primaryVertex, o2::track::TrackParCov const& posTrack, o2::track::TrackParCov const& negTrack, V0Fit& fit)
+  {
+    fit.passesDCAxy = false;
+    fit.caughtException = false;
+    fit.isFitted = false;
+
+    gpu::gpustd::array<float, 2> dcaInfo;
+    fit.posTrackPar = posTrack;
+    o2::base::Propagator::Instance()->propagateToDCABxByBz({primaryVertex[0], primaryVertex[1], primaryVertex[2]}, fit.posTrackPar, 2.f, df.getMatCorrType(), &dcaInfo);
+    fit.posDCAxy = dcaInfo[0];
+
+    fit.negTrackPar = negTrack;
+    o2::base::Propagator::Instance()->propagateToDCABxByBz({primaryVertex[0], primaryVertex[1], primaryVertex[2]}, fit.negTrackPar, 2.f, df.getMatCorrType(), &fit.negDCAInfo);
+    fit.negDCAxy = fit.negDCAInfo[0];
+
+    if (fabs(fit.posDCAxy) < dcapostopv || fabs(fit.negDCAxy) < dcanegtopv) {
+      return;
+    }
+    fit.passesDCAxy = true;
+
+    //---/---/---/
+    // Move close to minima
+    int nCand = 0;
+    try {
+      nCand = df.process(posTrack, negTrack);
+    } catch (...) {
+      fit.caughtException = true;
+      return;
+    }
+    if (nCand == 0) {
+      return;
+    }
+    fit.isFitted = true;
+
+    fit.posTrack = df.getTrack(0);
+    fit.negTrack = df.getTrack(1);
+
+    // get decay vertex coordinates
+    const auto& vtx = df.getPCACandidate();
+    for (int i = 0; i < 3; i++) {
+      fit.pos[i] = vtx[i];
+    }
+    fit.chi2PCA = df.getChi2AtPCACandidate();
+    if (createV0CovMats) {
+      fit.covPCA = df.calcPCACovMatrixFlat();
+    }
+  }
+
+  // Fits all the V0s to be built in the time frame, split in contiguous chunks over the threads.
+  // The track tables are only read here, the fits themselves use the threadFitters
+  template <class TTrackTo, typename TV0Table>
+  void fitV0s(TV0Table const& V0s)
+  {
+    v0fitInputs.clear();
+    for (auto& V0 : V0s) {
+      // downscale some V0s if requested to do so: same sequence as in buildStrangenessTables
+      if (downscaleFactor < 1.f && (static_cast<float>(rand_r(&randomSeed)) / static_cast<float>(RAND_MAX)) > downscaleFactor) {
+        break;
       }
-      if (!(negTrack.trackType() & o2::aod::track::TPCrefit)) {
-        return false;
+      auto const& posTrack = V0.template posTrack_as<TTrackTo>();
+      auto const& negTrack = V0.template negTrack_as<TTrackTo>();
+      auto primaryVertex = getPrimaryVertex(V0);
+      auto& input = v0fitInputs.emplace_back();
+      input.primaryVertex = {primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()};
+      input.passesTPCrefit = passesTPCrefit(posTrack, negTrack);
+      if (input.passesTPCrefit) {
+        input.posTrack = getTrackParCov(posTrack);
+        input.negTrack = getTrackParCov(negTrack);
       }
     }
 
-    // Passes TPC refit
-    statisticsRegistry.v0stats[kV0TPCrefit]++;
+    const std::size_t nV0s = v0fitInputs.size();
+    v0fits.resize(nV0s);
+    const std::size_t chunkSize = (nV0s + threadFitters.size() - 1) / threadFitters.size();
+    std::vector<std::thread> workers;
+    for (std::size_t iWorker = 0; iWorker * chunkSize < nV0s; iWorker++) {
+      workers.emplace_back([this, iWorker, chunkSize, nV0s]() {
+        for (std::size_t iV0 = iWorker * chunkSize; iV0 < std::min(nV0s, (iWorker + 1) * chunkSize); iV0++) {
+          auto const& input = v0fitInputs[iV0];
+          if (input.passesTPCrefit) {
+            fitV0(threadFitters[iWorker], input.primaryVertex, input.posTrack, input.negTrack, v0fits[iV0]);
+          }
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
 
-    // Calculate DCA with respect to the collision associated to the V0, not individual tracks
-    gpu::gpustd::array<float, 2> dcaInfo;
+  template <class TTrackTo, typename TV0Object>
+  bool buildV0Candidate(TV0Object const& V0, V0Fit const* fitResult = nullptr)
+  {
+    // Get tracks
+    auto const& posTrack = V0.template posTrack_as<TTrackTo>();
+    auto const& negTrack = V0.template negTrack_as<TTrackTo>();
+
+    auto primaryVertex = getPrimaryVertex(V0);
+
+    // value 0.5: any considered V0
+    statisticsRegistry.v0stats[kV0All]++;
+    if (!passesTPCrefit(posTrack, negTrack)) {
+      return false;
+    }
 
-    auto posTrackPar = getTrackPar(posTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, posTrackPar, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    auto posTrackdcaXY = dcaInfo[0];
+    // Passes TPC refit
+    statisticsRegistry.v0stats[kV0TPCrefit]++;
 
-    auto negTrackPar = getTrackPar(negTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, negTrackPar, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    auto negTrackdcaXY = dcaInfo[0];
+    // fit here unless all the V0s were already fitted in parallel
+    if (fitResult == nullptr) {
+      fitV0(fitter, {primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, getTrackParCov(posTrack), getTrackParCov(negTrack), v0fit);
+      fitResult = &v0fit;
+    }
+    auto const& fit = *fitResult;
 
-    if (fabs(posTrackdcaXY) < dcapostopv || fabs(negTrackdcaXY) < dcanegtopv) {
+    if (!fit.passesDCAxy) {
       return false;
     }
 
     // Initialize properly, please
-    v0candidate.posDCAxy = posTrackdcaXY;
-    v0candidate.negDCAxy = negTrackdcaXY;
+    v0candidate.posDCAxy = fit.posDCAxy;
+    v0candidate.negDCAxy = fit.negDCAxy;
 
     // passes DCAxy
     statisticsRegistry.v0stats[kV0DCAxy]++;
 
-    // Change strangenessBuilder tracks
-    lPositiveTrack = getTrackParCov(posTrack);
-    lNegativeTrack = getTrackParCov(negTrack);
-
-    //---/---/---/
-    // Move close to minima
-    int nCand = 0;
-    try {
-      nCand = fitter.process(lPositiveTrack, lNegativeTrack);
-    } catch (...) {
+    if (fit.caughtException) {
       statisticsRegistry.exceptions++;
       LOG(error) << "Exception caught in DCA fitter process call!";
       return false;
     }
-    if (nCand == 0) {
+    if (!fit.isFitted) {
       return false;
     }
 
-    v0candidate.posTrackX = fitter.getTrack(0).getX();
-    v0candidate.negTrackX = fitter.getTrack(1).getX();
+    v0candidate.posTrackX = fit.posTrack.getX();
+    v0candidate.negTrackX = fit.negTrack.getX();
 
-    lPositiveTrack = fitter.getTrack(0);
-    lNegativeTrack = fitter.getTrack(1);
+    // Change strangenessBuilder tracks
+    lPositiveTrack = fit.posTrack;
+    lNegativeTrack = fit.negTrack;
     lPositiveTrack.getPxPyPzGlo(v0candidate.posP);
     lNegativeTrack.getPxPyPzGlo(v0candidate.negP);
 
-    // get decay vertex coordinates
-    const auto& vtx = fitter.getPCACandidate();
-    for (int i = 0; i < 3; i++) {
-      v0candidate.pos[i] = vtx[i];
-    }
+    v0candidate.pos = fit.pos;
+    v0candidate.positionCovariance = fit.covPCA;
 
-    v0candidate.dcaV0dau = TMath::Sqrt(fitter.getChi2AtPCACandidate());
+    v0candidate.dcaV0dau = TMath::Sqrt(fit.chi2PCA);
 
     // Apply selections so a skimmed table is created only
     if (v0candidate.dcaV0dau > dcav0dau) {
@@ -763,8 +915,8 @@ struct lambdakzeroBuilder {
 
       o2::math_utils::CircleXYf_t trcCircle1, trcCircle2;
       float sna, csa;
-      posTrackPar.getCircleParams(d_bz, trcCircle1, sna, csa);
-      negTrackPar.getCircleParams(d_bz, trcCircle2, sna, csa);
+      fit.posTrackPar.getCircleParams(d_bz, trcCircle1, sna, csa);
+      fit.negTrackPar.getCircleParams(d_bz, trcCircle2, sna, csa);
 
       // distance between circle centers (one circle is at origin -> easy)
       float centerDistance = std::hypot(trcCircle1.xC - trcCircle2.xC, trcCircle1.yC - trcCircle2.yC);
@@ -781,15 +933,15 @@ struct lambdakzeroBuilder {
       // let's just use tagged, cause we can
       if (!posTrack.hasITS() && !posTrack.hasTRD() && !posTrack.hasTOF() && !negTrack.hasITS() && !negTrack.hasTRD() && !negTrack.hasTOF()) {
         if (V0.isTrueGamma()) {
-          registry.fill(HIST("h2d_pcm_DCAXY_True"), lPt, std::hypot(dcaInfo[0], dcaInfo[1]));
-          registry.fill(HIST("h2d_pcm_DCACHI2_True"), lPt, fitter.getChi2AtPCACandidate());
+          registry.fill(HIST("h2d_pcm_DCAXY_True"), lPt, std::hypot(fit.negDCAInfo[0], fit.negDCAInfo[1]));
+          registry.fill(HIST("h2d_pcm_DCACHI2_True"), lPt, fit.chi2PCA);
           registry.fill(HIST("h2d_pcm_DeltaDistanceRadii_True"), lPt, centerDistance - trcCircle1.rC - trcCircle2.rC);
           registry.fill(HIST("h2d_pcm_PositionGuess_True"), lPt, delta2);
           registry.fill(HIST("h2d_pcm_RadiallyOutgoingAtThisRadius1_True"), lPt, delta3_track1);
           registry.fill(HIST("h2d_pcm_RadiallyOutgoingAtThisRadius2_True"), lPt, delta3_track2);
         } else {
-          registry.fill(HIST("h2d_pcm_DCAXY_Bg"), lPt, std::hypot(dcaInfo[0], dcaInfo[1]));
-          registry.fill(HIST("h2d_pcm_DCACHI2_Bg"), lPt, fitter.getChi2AtPCACandidate());
+          registry.fill(HIST("h2d_pcm_DCAXY_Bg"), lPt, std::hypot(fit.negDCAInfo[0], fit.negDCAInfo[1]));
+          registry.fill(HIST("h2d_pcm_DCACHI2_Bg"), lPt, fit.chi2PCA);
           registry.fill(HIST("h2d_pcm_DeltaDistanceRadii_Bg"), lPt, centerDistance - trcCircle1.rC - trcCircle2.rC);
           registry.fill(HIST("h2d_pcm_PositionGuess_Bg"), lPt, delta2);
           registry.fill(HIST("h2d_pcm_RadiallyOutgoingAtThisRadius1_Bg"), lPt, delta3_track1);
@@ -804,15 +956,22 @@ struct lambdakzeroBuilder {
   template <class TTrackTo, typename TV0Table>
   void buildStrangenessTables(TV0Table const& V0s)
   {
+    const bool fitInThreads = nThreadsV0Fit > 1;
+    if (fitInThreads) {
+      fitV0s<TTrackTo>(V0s);
+    }
+
     // Loops over all V0s in the time frame
+    std::size_t iV0 = 0;
     for (auto& V0 : V0s) {
-      // downscale some V0s if requested to do so
-      if (downscaleFactor < 1.f && (static_cast<float>(rand_r(&randomSeed)) / static_cast<float>(RAND_MAX)) > downscaleFactor) {
+      // downscale some V0s if requested to do so (already decided while fitting in threads)
+      if (fitInThreads ? iV0 == v0fits.size() : (downscaleFactor < 1.f && (static_cast<float>(rand_r(&randomSeed)) / static_cast<float>(RAND_MAX)) > downscaleFactor)) {
         return;
       }
 
       // populates v0candidate struct declared inside strangenessbuilder
-      bool validCandidate = buildV0Candidate<TTrackTo>(V0);
+      bool validCandidate = buildV0Candidate<TTrackTo>(V0, fitInThreads ? &v0fits[iV0] : nullptr);
+      iV0++;
 
       if (!validCandidate) {
         continue; // doesn't pass selections
@@ -864,16 +1023,11 @@ struct lambdakzeroBuilder {
 
       // populate V0 covariance matrices if required by any other task
       if (createV0CovMats) {
-        // Calculate position covariance matrix
-        auto covVtxV = fitter.calcPCACovMatrix(0);
-        // std::array<float, 6> positionCovariance;
+        // position covariance matrix, calculated with the fit
         float positionCovariance[6];
-        positionCovariance[0] = covVtxV(0, 0);
-        positionCovariance[1] = covVtxV(1, 0);
-        positionCovariance[2] = covVtxV(1, 1);
-        positionCovariance[3] = covVtxV(2, 0);
-        positionCovariance[4] = covVtxV(2, 1);
-        positionCovariance[5] = covVtxV(2, 2);
+        for (int i = 0; i < 6; i++) {
+          positionCovariance[i] = v0candidate.positionCovariance[i];
+        }
         // store momentum covariance matrix
         std::array<float, 21> covTpositive = {0.};
         std::array<float, 21> covTnegative = {0.};
@@ -906,6 +1060,8 @@ struct lambdakzeroBuilder {
     auto collision = collisions.begin();
     auto bc = collision.bc_as<aod::BCsWithTimestamps>();
     initCCDB(bc);
+    auto timerBuild = timer.scope(TimerBuild);
+    timer.count(TimerBuild, V0s.size());
     buildStrangenessTables<FullTracksExt>(V0s);
   }
   PROCESS_SWITCH(lambdakzeroBuilder, processRun2, "Produce Run 2 V0 tables", false);
@@ -920,6 +1076,8 @@ struct lambdakzeroBuilder {
       return;
     }
     initCCDB(bc);
+    auto timerBuild = timer.scope(TimerBuild);
+    timer.count(TimerBuild, V0s.size());
     buildStrangenessTables<FullTracksExtIU>(V0s);
   }
   PROCESS_SWITCH(lambdakzeroBuilder, processRun3, "Produce Run 3 V0 tables", true);
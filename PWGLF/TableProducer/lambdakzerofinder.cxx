@@ -39,6 +39,7 @@
 #include "Common/DataModel/PIDResponse.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/DataModel/LFStrangenessFinderTables.h"
+#include "PWGLF/Utils/trackPairPretests.h"
 #include "Common/Core/TrackSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/DataModel/EventSelection.h"
@@ -59,6 +60,7 @@
 #include <cmath>
 #include <array>
 #include <cstdlib>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -139,6 +141,8 @@ struct lambdakzerofinder {
   // Configurables
   Configurable<double> d_UseAbsDCA{"d_UseAbsDCA", kTRUE, "Use Abs DCAs"};
   Configurable<double> d_bz_input{"d_bz", -999, "bz field, -999 is automatic"};
+  Configurable<float> d_maxDXYIni{"d_maxDXYIni", 4, "Dont consider a seed (circles intersection) if XY distance exceeds this"};
+  Configurable<bool> d_UseCirclePretest{"d_UseCirclePretest", true, "reject the pairs whose circles are further apart than d_maxDXYIni before fitting them"};
 
   // Selection criteria
   Configurable<double> v0cospa{"v0cospa", 0.995, "V0 CosPA"}; // double -> N.B. dcos(x)/dx = 0 at x=0)
@@ -166,6 +170,10 @@ struct lambdakzerofinder {
   int mRunNumber;
   float d_bz;
 
+  // daughter tracks with their circles, converted once per time frame
+  std::vector<o2::analysis::FinderTrack> posFinderTracks;
+  std::vector<o2::analysis::FinderTrack> negFinderTracks;
+
   void init(InitContext& context)
   {
     mRunNumber = 0;
@@ -178,6 +186,7 @@ struct lambdakzerofinder {
     fitter.setMinParamChange(1e-3);
     fitter.setMinRelChi2Change(0.9);
     fitter.setMaxDZIni(1e9);
+    fitter.setMaxDXYIni(d_maxDXYIni);
     fitter.setMaxChi2(1e9);
     fitter.setUseAbsDCA(d_UseAbsDCA);
   }
@@ -230,11 +239,8 @@ struct lambdakzerofinder {
   }
 
   template <class TTrack, class TCollisions>
-  int buildV0Candidate(TTrack const& t1, TTrack const& t2, TCollisions const& collisions)
+  int buildV0Candidate(TTrack const& t1, TTrack const& t2, o2::track::TrackParCov const& Track1, o2::track::TrackParCov const& Track2, TCollisions const& collisions)
   {
-    auto Track1 = getTrackParCov(t1);
-    auto Track2 = getTrackParCov(t2);
-
     // Try to progate to dca
     int nCand = fitter.process(Track1, Track2);
     if (nCand == 0) {
@@ -303,8 +309,21 @@ struct lambdakzerofinder {
 
     Long_t lNCand = 0;
 
+    posFinderTracks.clear();
+    for (auto& pTrack : pTracks) {
+      posFinderTracks.emplace_back(getTrackParCov(pTrack.track_as<FullTracksExtIU>()), d_bz);
+    }
+    negFinderTracks.clear();
+    for (auto& nTrack : nTracks) {
+      negFinderTracks.emplace_back(getTrackParCov(nTrack.track_as<FullTracksExtIU>()), d_bz);
+    }
+
+    std::size_t iPos = 0;
     for (auto& pTrack : pTracks) { // FIXME: turn into combination(...)
+      auto const& posFinderTrack = posFinderTracks[iPos++];
+      std::size_t iNeg = 0;
       for (auto& nTrack : nTracks) {
+        auto const& negFinderTrack = negFinderTracks[iNeg++];
         // Check compatibility with certain hypotheses and desired building
         bool keepCandidate = false;
         if (pTrack.compatiblePi() && nTrack.compatiblePi() && findK0Short)
@@ -316,10 +335,14 @@ struct lambdakzerofinder {
         if (!keepCandidate)
           continue;
 
+        // the fitter would not find a seed for circles further apart than its maxDXYIni
+        if (d_UseCirclePretest && o2::analysis::getCirclesDistanceXY(posFinderTrack.circle, negFinderTrack.circle) > d_maxDXYIni)
+          continue;
+
         auto t1 = pTrack.track_as<FullTracksExtIU>();
         auto t2 = nTrack.track_as<FullTracksExtIU>();
 
-        lNCand += buildV0Candidate(t1, t2, collisions);
+        lNCand += buildV0Candidate(t1, t2, posFinderTrack.trackParCov, negFinderTrack.trackParCov, collisions);
       }
     }
     registry.fill(HIST("hCandPerEvent"), lNCand);
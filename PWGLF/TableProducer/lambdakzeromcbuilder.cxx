@@ -34,6 +34,7 @@
 #include "Common/Core/RecoDecay.h"
 #include "Common/Core/trackUtilities.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
+#include "PWGLF/Utils/mcMothers.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -77,25 +78,19 @@ struct lambdakzeromcbuilder {
         pxnegmc = lMCNegTrack.px();
         pynegmc = lMCNegTrack.py();
         pznegmc = lMCNegTrack.pz();
-        if (lMCNegTrack.has_mothers() && lMCPosTrack.has_mothers()) {
-          for (auto& lNegMother : lMCNegTrack.mothers_as<aod::McParticles>()) {
-            for (auto& lPosMother : lMCPosTrack.mothers_as<aod::McParticles>()) {
-              if (lNegMother.globalIndex() == lPosMother.globalIndex()) {
-                lLabel = lNegMother.globalIndex();
-                // acquire information
-                xmc = lMCPosTrack.vx();
-                ymc = lMCPosTrack.vy();
-                zmc = lMCPosTrack.vz();
-                pdgCode = lNegMother.pdgCode();
-                isPhysicalPrimary = lNegMother.isPhysicalPrimary();
-                if (lNegMother.has_mothers()) {
-                  for (auto& lNegGrandMother : lNegMother.mothers_as<aod::McParticles>()) {
-                    pdgCodeMother = lNegGrandMother.pdgCode();
-                    lMotherLabel = lNegGrandMother.globalIndex();
-                  }
-                }
-              }
-            }
+        int lMotherId = o2::analysis::getCommonMotherId(lMCNegTrack, lMCPosTrack);
+        if (lMotherId >= 0) {
+          auto lMother = particlesMC.rawIteratorAt(lMotherId);
+          lLabel = lMotherId;
+          // acquire information
+          xmc = lMCPosTrack.vx();
+          ymc = lMCPosTrack.vy();
+          zmc = lMCPosTrack.vz();
+          pdgCode = lMother.pdgCode();
+          isPhysicalPrimary = lMother.isPhysicalPrimary();
+          lMotherLabel = o2::analysis::getLastMotherId(lMother);
+          if (lMotherLabel >= 0) {
+            pdgCodeMother = particlesMC.rawIteratorAt(lMotherLabel).pdgCode();
           }
         }
       } // end association check
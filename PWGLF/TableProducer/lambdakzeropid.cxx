@@ -112,36 +112,45 @@ struct lambdakzeropid {
   float maxSnp;  // max sine phi for propagation
   float maxStep; // max step size (cm) for propagation
 
+  static constexpr int nTOFSegments = 18; // TOF sectors in the xy plane
+
+  // end points of the TOF sectors in the xy plane (x1, y1, x2, y2), computed once from the TOF radius
+  std::array<std::array<float, 4>, nTOFSegments> tofSegments;
+
+  /// function to calculate the end points of the TOF segments from the TOF radius
+  void initTOFSegments()
+  {
+    float segmentAngle = 20.0f / 180.0f * TMath::Pi();
+    float halfWidth = tofPosition * TMath::Tan(0.5f * segmentAngle);
+    for (int iSeg = 0; iSeg < nTOFSegments; iSeg++) {
+      float theta = static_cast<float>(iSeg) * 20.0f / 180.0f * TMath::Pi();
+      tofSegments[iSeg][0] = TMath::Cos(theta) * (-halfWidth) + TMath::Sin(theta) * tofPosition;
+      tofSegments[iSeg][1] = -TMath::Sin(theta) * (-halfWidth) + TMath::Cos(theta) * tofPosition;
+      tofSegments[iSeg][2] = TMath::Cos(theta) * (+halfWidth) + TMath::Sin(theta) * tofPosition;
+      tofSegments[iSeg][3] = -TMath::Sin(theta) * (+halfWidth) + TMath::Cos(theta) * tofPosition;
+    }
+  }
+
   /// function to calculate track length of this track up to a certain segment of a detector
   /// to be used internally in another funcrtion that calculates length until it finds the proper one
-  /// warning: this could be optimised further for speed
-  /// \param track the input track
+  /// the circle, the momentum and the start point of the track do not depend on the segment and are passed precomputed
+  /// \param trcCircle the circle of the track in the xy plane
+  /// \param mom the momentum of the track at its start point
+  /// \param startPoint the start point of the track
+  /// \param tgl the tangent of the dip angle of the track
   /// \param x1 x of the first point of the detector segment
   /// \param y1 y of the first point of the detector segment
   /// \param x2 x of the first point of the detector segment
   /// \param y2 y of the first point of the detector segment
-  /// \param magneticField the magnetic field to use when propagating
-  float trackLengthToSegment(o2::track::TrackPar track, float x1, float y1, float x2, float y2, float magneticField)
+  float trackLengthToSegment(o2::math_utils::CircleXYf_t const& trcCircle, std::array<float, 3> const& mom, std::array<float, 3> const& startPoint, float tgl, float x1, float y1, float x2, float y2)
   {
     // don't make use of the track parametrization
     float length = -104;
 
-    // causality protection
-    std::array<float, 3> mom;
-    track.getPxPyPzGlo(mom);
-    // get start point
-    std::array<float, 3> startPoint;
-    track.getXYZGlo(startPoint);
-
     // better replaced with scalar momentum check later
     // if (((x1 + x2) * mom[0] + (y1 + y2) * mom[1]) < 0.0f)
     //   return -101;
 
-    // get circle X, Y please
-    o2::math_utils::CircleXYf_t trcCircle;
-    float sna, csa;
-    track.getCircleParams(magneticField, trcCircle, sna, csa);
-
     // Calculate necessary inner product
     float segmentModulus = std::hypot(x2 - x1, y2 - y1);
     float alongSegment = ((trcCircle.xC - x1) * (x2 - x1) + (trcCircle.yC - y1) * (y2 - y1)) / segmentModulus;
@@ -158,60 +167,39 @@ struct lambdakzeropid {
 
     float pcaToIntercept = TMath::Sqrt(TMath::Abs(trcCircle.rC * trcCircle.rC - centerDistToPC * centerDistToPC));
 
-    float interceptX1 = pcaX + (x2 - x1) / segmentModulus * pcaToIntercept;
-    float interceptY1 = pcaY + (y2 - y1) / segmentModulus * pcaToIntercept;
-    float interceptX2 = pcaX - (x2 - x1) / segmentModulus * pcaToIntercept;
-    float interceptY2 = pcaY - (y2 - y1) / segmentModulus * pcaToIntercept;
-
-    float scalarCheck1 = ((x2 - x1) * (interceptX1 - x1) + (y2 - y1) * (interceptY1 - y1)) / segmentModulus;
-    float scalarCheck2 = ((x2 - x1) * (interceptX2 - x1) + (y2 - y1) * (interceptY2 - y1)) / segmentModulus;
-
-    float cosAngle1 = -1000, sinAngle1 = -1000, modulus1 = -1000;
-    float cosAngle2 = -1000, sinAngle2 = -1000, modulus2 = -1000;
-    float length1 = -1000, length2 = -1000;
-
-    modulus1 = std::hypot(interceptX1 - trcCircle.xC, interceptY1 - trcCircle.yC) * std::hypot(startPoint[0] - trcCircle.xC, startPoint[1] - trcCircle.yC);
-    cosAngle1 = (interceptX1 - trcCircle.xC) * (startPoint[0] - trcCircle.xC) + (interceptY1 - trcCircle.yC) * (startPoint[1] - trcCircle.yC);
-    sinAngle1 = (interceptX1 - trcCircle.xC) * (startPoint[1] - trcCircle.yC) - (interceptY1 - trcCircle.yC) * (startPoint[0] - trcCircle.xC);
-    cosAngle1 /= modulus1;
-    sinAngle1 /= modulus1;
-    length1 = trcCircle.rC * TMath::ACos(cosAngle1);
-    length1 *= sqrt(1.0f + track.getTgl() * track.getTgl());
-
-    modulus2 = std::hypot(interceptX2 - trcCircle.xC, interceptY2 - trcCircle.yC) * std::hypot(startPoint[0] - trcCircle.xC, startPoint[1] - trcCircle.yC);
-    cosAngle2 = (interceptX2 - trcCircle.xC) * (startPoint[0] - trcCircle.xC) + (interceptY2 - trcCircle.yC) * (startPoint[1] - trcCircle.yC);
-    sinAngle2 = (interceptX2 - trcCircle.xC) * (startPoint[1] - trcCircle.yC) - (interceptY2 - trcCircle.yC) * (startPoint[0] - trcCircle.xC);
-    cosAngle2 /= modulus2;
-    sinAngle2 /= modulus2;
-    length2 = trcCircle.rC * TMath::ACos(cosAngle2);
-    length2 *= sqrt(1.0f + track.getTgl() * track.getTgl());
-
-    // rotate transverse momentum vector such that it is at intercepts
-    float angle1 = TMath::ACos(cosAngle1);
-    if (sinAngle1 < 0)
-      angle1 *= -1.0f;
-    float px1 = +TMath::Cos(angle1) * mom[0] + TMath::Sin(angle1) * mom[1];
-    float py1 = -TMath::Sin(angle1) * mom[0] + TMath::Cos(angle1) * mom[1];
-
-    float angle2 = TMath::ACos(cosAngle2);
-    if (sinAngle2 < 0)
-      angle2 *= -1.0f;
-    float px2 = +TMath::Cos(angle2) * mom[0] + TMath::Sin(angle2) * mom[1];
-    float py2 = -TMath::Sin(angle2) * mom[0] + TMath::Cos(angle2) * mom[1];
-
     float midSegX = 0.5f * (x2 + x1);
     float midSegY = 0.5f * (y2 + y1);
-
-    float scalarMomentumCheck1 = px1 * midSegX + py1 * midSegY;
-    float scalarMomentumCheck2 = px2 * midSegX + py2 * midSegY;
-
-    if (scalarCheck1 > 0.0f && scalarCheck1 < segmentModulus && scalarMomentumCheck1 > 0.0f) {
-      length = length1;
-      // X = interceptX1; Y = interceptY1;
-    }
-    if (scalarCheck2 > 0.0f && scalarCheck2 < segmentModulus && scalarMomentumCheck2 > 0.0f) {
-      length = length2;
-      // X = interceptX2; Y = interceptY2;
+    float startModulus = std::hypot(startPoint[0] - trcCircle.xC, startPoint[1] - trcCircle.yC);
+
+    // the two intercepts are checked in turn, the second one is kept if both are valid
+    for (int iIntercept = 0; iIntercept < 2; iIntercept++) {
+      float sign = iIntercept == 0 ? +1.0f : -1.0f;
+      float interceptX = pcaX + sign * (x2 - x1) / segmentModulus * pcaToIntercept;
+      float interceptY = pcaY + sign * (y2 - y1) / segmentModulus * pcaToIntercept;
+
+      // the intercept has to be in the segment, before computing any angle
+      float scalarCheck = ((x2 - x1) * (interceptX - x1) + (y2 - y1) * (interceptY - y1)) / segmentModulus;
+      if (scalarCheck <= 0.0f || scalarCheck >= segmentModulus)
+        continue;
+
+      float modulus = std::hypot(interceptX - trcCircle.xC, interceptY - trcCircle.yC) * startModulus;
+      float cosAngle = ((interceptX - trcCircle.xC) * (startPoint[0] - trcCircle.xC) + (interceptY - trcCircle.yC) * (startPoint[1] - trcCircle.yC)) / modulus;
+      float sinAngle = ((interceptX - trcCircle.xC) * (startPoint[1] - trcCircle.yC) - (interceptY - trcCircle.yC) * (startPoint[0] - trcCircle.xC)) / modulus;
+
+      // rotate transverse momentum vector such that it is at the intercept
+      // cos and sin of the rotation angle follow from cosAngle, with the sign of sinAngle, without further trigonometric calls
+      float angle = TMath::ACos(cosAngle);
+      float cosRotation = TMath::Min(1.0f, TMath::Max(-1.0f, cosAngle));
+      float sinRotation = TMath::Sqrt(TMath::Max(0.0f, 1.0f - cosRotation * cosRotation));
+      if (sinAngle < 0)
+        sinRotation *= -1.0f;
+      float px = +cosRotation * mom[0] + sinRotation * mom[1];
+      float py = -sinRotation * mom[0] + cosRotation * mom[1];
+
+      float scalarMomentumCheck = px * midSegX + py * midSegY;
+      if (scalarMomentumCheck > 0.0f) {
+        length = trcCircle.rC * angle * std::sqrt(1.0f + tgl * tgl);
+      }
     }
     return length;
   }
@@ -219,19 +207,23 @@ struct lambdakzeropid {
   /// function to calculate track length of this track up to a certain segmented detector
   /// \param track the input track
   /// \param magneticField the magnetic field to use when propagating
-  float findInterceptLength(o2::track::TrackPar track, float magneticField)
+  float findInterceptLength(o2::track::TrackPar const& track, float magneticField)
   {
+    // get circle X, Y please, once for all the segments
+    o2::math_utils::CircleXYf_t trcCircle;
+    float sna, csa;
+    track.getCircleParams(magneticField, trcCircle, sna, csa);
+    std::array<float, 3> mom;
+    track.getPxPyPzGlo(mom);
+    // get start point
+    std::array<float, 3> startPoint;
+    track.getXYZGlo(startPoint);
+
     float length = 1e+6;
-    for (int iSeg = 0; iSeg < 18; iSeg++) {
+    for (int iSeg = 0; iSeg < nTOFSegments; iSeg++) {
       // Detector segmentation loop
-      float segmentAngle = 20.0f / 180.0f * TMath::Pi();
-      float theta = static_cast<float>(iSeg) * 20.0f / 180.0f * TMath::Pi();
-      float halfWidth = tofPosition * TMath::Tan(0.5f * segmentAngle);
-      float x1 = TMath::Cos(theta) * (-halfWidth) + TMath::Sin(theta) * tofPosition;
-      float y1 = -TMath::Sin(theta) * (-halfWidth) + TMath::Cos(theta) * tofPosition;
-      float x2 = TMath::Cos(theta) * (+halfWidth) + TMath::Sin(theta) * tofPosition;
-      float y2 = -TMath::Sin(theta) * (+halfWidth) + TMath::Cos(theta) * tofPosition;
-      float thisLength = trackLengthToSegment(track, x1, y1, x2, y2, magneticField);
+      const auto& segment = tofSegments[iSeg];
+      float thisLength = trackLengthToSegment(trcCircle, mom, startPoint, track.getTgl(), segment[0], segment[1], segment[2], segment[3]);
       if (thisLength < length && thisLength > 0)
         length = thisLength;
     }
@@ -246,6 +238,7 @@ struct lambdakzeropid {
     d_bz = 0;
     maxSnp = 0.85f;  // could be changed later
     maxStep = 2.00f; // could be changed later
+    initTOFSegments();
 
     ccdb->setURL(ccdburl);
     ccdb->setCaching(true);
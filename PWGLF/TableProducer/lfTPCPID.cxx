@@ -502,28 +502,31 @@ struct lfTpcPid {
   {
     static constexpr float invmass = 1.f / o2::track::pid_constants::sMasses2Z[id];
     static constexpr float charge = o2::track::pid_constants::sCharges[id];
+    const float innerParam = track.tpcInnerParam();
     float corr = 0.f;
-    if (params.postCorrection != nullptr) {
-      corr = params.postCorrection->Eval(track.tpcInnerParam());
-    }
-    if (params.postCorrectionFun != nullptr) {
-      corr = params.postCorrectionFun->Eval(track.tpcInnerParam());
+    if (params.postCorrectionFun != nullptr) { // the function takes precedence over the graph
+      corr = params.postCorrectionFun->Eval(innerParam);
+    } else if (params.postCorrection != nullptr) {
+      corr = params.postCorrection->Eval(innerParam);
     }
+    const float bethe = o2::tpc::BetheBlochAleph(innerParam * invmass, params.bb1, params.bb2, params.bb3, params.bb4, params.bb5);
     if (params.isSimple) {
-      return o2::tpc::BetheBlochAleph(track.tpcInnerParam() * invmass, params.bb1, params.bb2, params.bb3, params.bb4, params.bb5) + corr;
+      return bethe + corr;
+    }
+    if constexpr (charge == 1.f) { // the charge factor is 1 whatever the exponent
+      return params.mip * bethe + corr;
     }
-    return params.mip * o2::tpc::BetheBlochAleph(track.tpcInnerParam() * invmass, params.bb1, params.bb2, params.bb3, params.bb4, params.bb5) * std::pow(charge, params.exp) + corr;
+    return params.mip * bethe * std::pow(charge, params.exp) + corr;
   }
 
   template <o2::track::PID::ID id, typename T>
   float BetheBlochResolutionLf(const T& track, const bbParams& params, const float bb) const
   {
     float corr = 1.f;
-    if (params.postCorrectionSigma != nullptr) {
-      corr = params.postCorrectionSigma->Eval(track.tpcInnerParam());
-    }
-    if (params.postCorrectionFunSigma != nullptr) {
+    if (params.postCorrectionFunSigma != nullptr) { // the function takes precedence over the graph
       corr = params.postCorrectionFunSigma->Eval(track.tpcInnerParam());
+    } else if (params.postCorrectionSigma != nullptr) {
+      corr = params.postCorrectionSigma->Eval(track.tpcInnerParam());
     }
     return params.res * bb * corr;
   }
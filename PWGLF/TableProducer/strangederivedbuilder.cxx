@@ -73,11 +73,12 @@ struct strangederivedbuilder {
 
   //__________________________________________________
   // track extra references
-  Produces<aod::DauTrackExtras> dauTrackExtras;   // daughter track detector properties
-  Produces<aod::DauTrackTPCPIDs> dauTrackTPCPIDs; // daughter track TPC PID
-  Produces<aod::V0Extras> v0Extras;               // references DauTracks from V0s
-  Produces<aod::CascExtras> cascExtras;           // references DauTracks from cascades
-  Produces<aod::StraTrackExtras> straTrackExtras; // references DauTracks from tracked cascades
+  Produces<aod::DauTrackExtras> dauTrackExtras;           // daughter track detector properties
+  Produces<aod::DauTrackTPCPIDs> dauTrackTPCPIDs;         // daughter track TPC PID
+  Produces<aod::DauTrackTinyTPCPIDs> dauTrackTinyTPCPIDs; // daughter track TPC PID, reduced size
+  Produces<aod::V0Extras> v0Extras;                       // references DauTracks from V0s
+  Produces<aod::CascExtras> cascExtras;                   // references DauTracks from cascades
+  Produces<aod::StraTrackExtras> straTrackExtras;         // references DauTracks from tracked cascades
 
   //__________________________________________________
   // cascade interlinks
@@ -129,6 +130,7 @@ struct strangederivedbuilder {
   // variables that are rounded include the DCAs but not the CosPA (precision needed)
   Configurable<bool> roundNSigmaVariables{"roundNSigmaVariables", false, "round NSigma variables"};
   Configurable<float> precisionNSigmas{"precisionNSigmas", 0.1f, "precision to keep NSigmas"};
+  Configurable<bool> storeTinyTPCPIDs{"storeTinyTPCPIDs", false, "store the daughter TPC PID in DauTrackTinyTPCPIDs (8-bit NSigmas in steps of 0.1, 16-bit signal) instead of DauTrackTPCPIDs"};
 
   // For manual sliceBy
   Preslice<aod::V0Datas> V0perCollision = o2::aod::v0data::collisionId;
@@ -345,8 +347,15 @@ struct strangederivedbuilder {
         dauTrackExtras(tr.detectorMap(), tr.itsClusterSizes(),
                        tr.tpcNClsFound(), tr.tpcNClsCrossedRows());
 
-        // round if requested
-        if (roundNSigmaVariables) {
+        // reduced size or round if requested
+        if (storeTinyTPCPIDs) {
+          dauTrackTinyTPCPIDs(aod::dautrack_tiny::packSignal(tr.tpcSignal()),
+                              aod::dautrack_tiny::packNSigma(tr.tpcNSigmaEl()),
+                              aod::dautrack_tiny::packNSigma(tr.tpcNSigmaPi()),
+                              aod::dautrack_tiny::packNSigma(tr.tpcNSigmaKa()),
+                              aod::dautrack_tiny::packNSigma(tr.tpcNSigmaPr()),
+                              aod::dautrack_tiny::packNSigma(tr.tpcNSigmaHe()));
+        } else if (roundNSigmaVariables) {
           dauTrackTPCPIDs(tr.tpcSignal(),
                           roundToPrecision(tr.tpcNSigmaEl(), precisionNSigmas),
                           roundToPrecision(tr.tpcNSigmaPi(), precisionNSigmas),
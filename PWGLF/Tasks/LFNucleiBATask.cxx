@@ -136,6 +136,14 @@ struct LFNucleiBATask {
   TF1* fShiftTPCmomantiHe = 0;
 
   TF1* fShiftAntiD = 0;
+
+  // Histograms filled for each event or for each track before the selections, filled through their handle
+  std::shared_ptr<TH1> hVtxZ;
+  std::shared_ptr<TH1> hFT0M;
+  std::shared_ptr<TH1> hFV0M;
+  std::shared_ptr<TH1> hTrackPt;
+  std::shared_ptr<TH1> hTrackP;
+
   Configurable<bool> enableTPCmomShift{"enableTPCmomShift", false, "Flag to enable TPC momentum shift (for He only)"};
   Configurable<bool> enablePShift{"enablePShift", false, "Flag to enable P shift (for He only)"};
   Configurable<bool> enablePtShift{"enablePtShift", false, "Flag to enable Pt shift (for He only)"};
@@ -182,12 +190,55 @@ struct LFNucleiBATask {
       LOG(fatal) << "Can't enable processData and processMCReco in the same time, pick one!";
     }
 
-    histos.add<TH1>("event/h1VtxZ", "V_{z};V_{z} (in cm); counts", HistType::kTH1F, {{1500, -15, 15}});
-    histos.add<TH1>("event/hFT0M", "hFT0M", HistType::kTH1F, {{binsPercentile, "Centrality FT0M"}});
-    histos.add<TH1>("event/hFV0M", "hFV0M", HistType::kTH1F, {{binsPercentile, "Centrality FV0M"}});
+    // pT-shift calibration functions, created once instead of being tested for each track
+    if (enablePtShift && !fShiftPtHe) {
+      fShiftPtHe = new TF1("fShiftPtHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
+      auto par = (std::vector<float>)parShiftPtHe;
+      fShiftPtHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
+    }
+
+    if (enablePtShift && !fShiftPtantiHe) {
+      fShiftPtantiHe = new TF1("fShiftPtantiHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
+      auto par = (std::vector<float>)parShiftPtantiHe;
+      fShiftPtantiHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
+    }
+
+    if (enablePShift && !fShiftPHe) {
+      fShiftPHe = new TF1("fShiftPHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
+      auto par = (std::vector<float>)parShiftPHe;
+      fShiftPHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
+    }
+
+    if (enablePShift && !fShiftPantiHe) {
+      fShiftPantiHe = new TF1("fShiftPantiHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
+      auto par = (std::vector<float>)parShiftPantiHe;
+      fShiftPantiHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
+    }
+
+    if (enableTPCmomShift && !fShiftTPCmomHe) {
+      fShiftTPCmomHe = new TF1("fShiftTPCmomHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
+      auto par = (std::vector<float>)parShiftPHe;
+      fShiftTPCmomHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
+    }
+
+    if (enableTPCmomShift && !fShiftTPCmomantiHe) {
+      fShiftTPCmomantiHe = new TF1("fShiftTPCmomantiHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
+      auto par = (std::vector<float>)parShiftPantiHe;
+      fShiftTPCmomantiHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
+    }
+
+    if (enablePtShiftAntiD && !fShiftAntiD) {
+      fShiftAntiD = new TF1("fShiftAntiD", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
+      auto par = (std::vector<float>)parShiftPtAntiD;
+      fShiftAntiD->SetParameters(par[0], par[1], par[2], par[3], par[4]);
+    }
+
+    hVtxZ = histos.add<TH1>("event/h1VtxZ", "V_{z};V_{z} (in cm); counts", HistType::kTH1F, {{1500, -15, 15}});
+    hFT0M = histos.add<TH1>("event/hFT0M", "hFT0M", HistType::kTH1F, {{binsPercentile, "Centrality FT0M"}});
+    hFV0M = histos.add<TH1>("event/hFV0M", "hFV0M", HistType::kTH1F, {{binsPercentile, "Centrality FV0M"}});
 
-    histos.add<TH1>("tracks/h1pT", "Track #it{p}_{T}; #it{p}_{T} (GeV/#it{c}); counts", HistType::kTH1F, {{500, 0., 10.}});
-    histos.add<TH1>("tracks/h1p", "Track momentum; p (GeV/#it{c}); counts", HistType::kTH1F, {{500, 0., 10.}});
+    hTrackPt = histos.add<TH1>("tracks/h1pT", "Track #it{p}_{T}; #it{p}_{T} (GeV/#it{c}); counts", HistType::kTH1F, {{500, 0., 10.}});
+    hTrackP = histos.add<TH1>("tracks/h1p", "Track momentum; p (GeV/#it{c}); counts", HistType::kTH1F, {{500, 0., 10.}});
 
     histos.add<TH1>("qa/h1ITSncr", "number of crossed rows in ITS; ITSncr; counts", HistType::kTH1F, {{12, 0, 12}});
     histos.add<TH1>("qa/h1TPCncr", "number of crossed rows in TPC; TPCncr; counts", HistType::kTH1F, {{150, 60, 170}});
@@ -1374,16 +1425,16 @@ struct LFNucleiBATask {
     bool alRapCut = kFALSE;
 
     // Event histos fill
-    histos.fill(HIST("event/h1VtxZ"), event.posZ());
+    hVtxZ->Fill(event.posZ());
     if (enableDebug)
-      histos.fill(HIST("event/hFT0M"), event.centFT0M());
+      hFT0M->Fill(event.centFT0M());
     if constexpr (IsFilteredData) {
-      histos.fill(HIST("event/hFV0M"), event.centFV0M());
+      hFV0M->Fill(event.centFV0M());
     }
 
     for (auto& track : tracks) {
-      histos.fill(HIST("tracks/h1pT"), track.pt());
-      histos.fill(HIST("tracks/h1p"), track.p());
+      hTrackPt->Fill(track.pt());
+      hTrackP->Fill(track.p());
 
       if constexpr (!IsFilteredData) {
         if (!track.isGlobalTrackWoDCA()) {
@@ -1416,48 +1467,6 @@ struct LFNucleiBATask {
       float shiftTPCmomPos = 0.f;
       float shiftTPCmomNeg = 0.f;
 
-      if (enablePtShift && !fShiftPtHe) {
-        fShiftPtHe = new TF1("fShiftPtHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto par = (std::vector<float>)parShiftPtHe;
-        fShiftPtHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
-      }
-
-      if (enablePtShift && !fShiftPtantiHe) {
-        fShiftPtantiHe = new TF1("fShiftPtantiHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto par = (std::vector<float>)parShiftPtantiHe;
-        fShiftPtantiHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
-      }
-
-      if (enablePShift && !fShiftPHe) {
-        fShiftPHe = new TF1("fShiftPHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto par = (std::vector<float>)parShiftPHe;
-        fShiftPHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
-      }
-
-      if (enablePShift && !fShiftPantiHe) {
-        fShiftPantiHe = new TF1("fShiftPantiHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto par = (std::vector<float>)parShiftPantiHe;
-        fShiftPantiHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
-      }
-
-      if (enableTPCmomShift && !fShiftTPCmomHe) {
-        fShiftTPCmomHe = new TF1("fShiftTPCmomHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto par = (std::vector<float>)parShiftPHe;
-        fShiftTPCmomHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
-      }
-
-      if (enableTPCmomShift && !fShiftTPCmomantiHe) {
-        fShiftTPCmomantiHe = new TF1("fShiftTPCmomantiHe", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto par = (std::vector<float>)parShiftPantiHe;
-        fShiftTPCmomantiHe->SetParameters(par[0], par[1], par[2], par[3], par[4]);
-      }
-
-      if (enablePtShiftAntiD && !fShiftAntiD) {
-        fShiftAntiD = new TF1("fShiftAntiD", "[0] * TMath::Exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto par = (std::vector<float>)parShiftPtAntiD;
-        fShiftAntiD->SetParameters(par[0], par[1], par[2], par[3], par[4]);
-      }
-
       switch (antiDeuteronPt) {
         case 0:
           if (enablePtShiftAntiD && fShiftAntiD) {
@@ -1518,12 +1527,19 @@ struct LFNucleiBATask {
       if (TMath::Abs(track.tpcInnerParam()) < pCut)
         continue;
 
+      // rapidities in the mass hypotheses, computed once for the cuts and the histograms
+      const float yProton = track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Proton));
+      const float yDeuteron = track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Deuteron));
+      const float yTriton = track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Triton));
+      const float yHelium = track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Helium3));
+      const float yAlpha = track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Alpha));
+
       // debug on helium rapidity cut
-      prRapCut = track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Proton)) > yLowCut && track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Proton)) < yHighCut;
-      deRapCut = track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Deuteron)) > yLowCut && track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Deuteron)) < yHighCut;
-      trRapCut = track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Triton)) > yLowCut && track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Triton)) < yHighCut;
-      heRapCut = track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Helium3)) > yLowCut && track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Helium3)) < yHighCut;
-      alRapCut = track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Alpha)) > yLowCut && track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Alpha)) < yHighCut;
+      prRapCut = yProton > yLowCut && yProton < yHighCut;
+      deRapCut = yDeuteron > yLowCut && yDeuteron < yHighCut;
+      trRapCut = yTriton > yLowCut && yTriton < yHighCut;
+      heRapCut = yHelium > yLowCut && yHelium < yHighCut;
+      alRapCut = yAlpha > yLowCut && yAlpha < yHighCut;
 
       // Tracks DCA histos fill
       if (makeDCABeforeCutPlots) {
@@ -2473,7 +2489,7 @@ struct LFNucleiBATask {
               histos.fill(HIST("tracks/eff/proton/h2pVsTPCmomentumPr"), track.tpcInnerParam(), track.p());
             }
             histos.fill(HIST("tracks/proton/h1ProtonSpectra"), track.pt());
-            histos.fill(HIST("tracks/proton/h2ProtonYvsPt"), track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Proton)), track.pt());
+            histos.fill(HIST("tracks/proton/h2ProtonYvsPt"), yProton, track.pt());
             histos.fill(HIST("tracks/proton/h2ProtonEtavsPt"), track.eta(), track.pt());
 
             if (enablePIDplot)
@@ -2488,7 +2504,7 @@ struct LFNucleiBATask {
               histos.fill(HIST("tracks/eff/proton/h2pVsTPCmomentumantiPr"), track.tpcInnerParam(), track.p());
             }
             histos.fill(HIST("tracks/proton/h1antiProtonSpectra"), track.pt());
-            histos.fill(HIST("tracks/proton/h2antiProtonYvsPt"), track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Proton)), track.pt());
+            histos.fill(HIST("tracks/proton/h2antiProtonYvsPt"), yProton, track.pt());
             histos.fill(HIST("tracks/proton/h2antiProtonEtavsPt"), track.eta(), track.pt());
 
             if (enablePIDplot)
@@ -2508,7 +2524,7 @@ struct LFNucleiBATask {
               histos.fill(HIST("tracks/eff/deuteron/h2pVsTPCmomentumDe"), track.tpcInnerParam(), track.p());
             }
             histos.fill(HIST("tracks/deuteron/h1DeuteronSpectra"), track.pt());
-            histos.fill(HIST("tracks/deuteron/h2DeuteronYvsPt"), track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Deuteron)), track.pt());
+            histos.fill(HIST("tracks/deuteron/h2DeuteronYvsPt"), yDeuteron, track.pt());
             if (enablePIDplot)
               histos.fill(HIST("tracks/deuteron/h2TPCsignVsTPCmomentumDeuteron"), track.tpcInnerParam(), track.tpcSignal());
             if (enableNucleiHardCut && (std::abs(track.tpcNSigmaPi()) > 2) && (std::abs(track.tpcNSigmaKa()) > 2) && (std::abs(track.tpcNSigmaPr()) > 1) && (std::abs(track.tpcNSigmaTr()) > 1) && (std::abs(track.tpcNSigmaDe()) < nsigmaTPCStrongCut)) {
@@ -2520,7 +2536,7 @@ struct LFNucleiBATask {
               histos.fill(HIST("tracks/eff/deuteron/h2pVsTPCmomentumantiDe"), track.tpcInnerParam(), track.p());
             }
             histos.fill(HIST("tracks/deuteron/h1antiDeuteronSpectra"), track.pt());
-            histos.fill(HIST("tracks/deuteron/h2antiDeuteronYvsPt"), track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Deuteron)), track.pt());
+            histos.fill(HIST("tracks/deuteron/h2antiDeuteronYvsPt"), yDeuteron, track.pt());
             if (enablePIDplot)
               histos.fill(HIST("tracks/deuteron/h2TPCsignVsTPCmomentumantiDeuteron"), track.tpcInnerParam(), track.tpcSignal());
             if (enableNucleiHardCut && (std::abs(track.tpcNSigmaPi()) > 2) && (std::abs(track.tpcNSigmaKa()) > 2) && (std::abs(track.tpcNSigmaPr()) > 1) && (std::abs(track.tpcNSigmaTr()) > 1) && (std::abs(track.tpcNSigmaDe()) < nsigmaTPCStrongCut)) {
@@ -2531,7 +2547,7 @@ struct LFNucleiBATask {
       }
 
       if (enableTr) {
-        if ((isTriton) && (TMath::Abs(track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Triton))) < yCut)) {
+        if ((isTriton) && (TMath::Abs(yTriton) < yCut)) {
           if (track.sign() > 0) {
             if (enablePtSpectra) {
               histos.fill(HIST("tracks/eff/triton/hPtTr"), track.pt());
@@ -2566,8 +2582,8 @@ struct LFNucleiBATask {
             }
             histos.fill(HIST("tracks/helium/h1HeliumSpectra"), hePt);
             histos.fill(HIST("tracks/helium/h1HeliumSpectra_Z2"), 2 * hePt);
-            histos.fill(HIST("tracks/helium/h2HeliumYvsPt"), track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Helium3)), hePt);
-            histos.fill(HIST("tracks/helium/h2HeliumYvsPt_Z2"), track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Helium3)), 2 * hePt);
+            histos.fill(HIST("tracks/helium/h2HeliumYvsPt"), yHelium, hePt);
+            histos.fill(HIST("tracks/helium/h2HeliumYvsPt_Z2"), yHelium, 2 * hePt);
             histos.fill(HIST("tracks/helium/h2HeliumEtavsPt"), track.eta(), hePt);
             histos.fill(HIST("tracks/helium/h2HeliumEtavsPt_Z2"), track.eta(), 2 * hePt);
 
@@ -2583,8 +2599,8 @@ struct LFNucleiBATask {
             }
             histos.fill(HIST("tracks/helium/h1antiHeliumSpectra"), antihePt);
             histos.fill(HIST("tracks/helium/h1antiHeliumSpectra_Z2"), 2 * antihePt);
-            histos.fill(HIST("tracks/helium/h2antiHeliumYvsPt"), track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Helium3)), hePt);
-            histos.fill(HIST("tracks/helium/h2antiHeliumYvsPt_Z2"), track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Helium3)), 2 * hePt);
+            histos.fill(HIST("tracks/helium/h2antiHeliumYvsPt"), yHelium, hePt);
+            histos.fill(HIST("tracks/helium/h2antiHeliumYvsPt_Z2"), yHelium, 2 * hePt);
             histos.fill(HIST("tracks/helium/h2antiHeliumEtavsPt"), track.eta(), hePt);
             histos.fill(HIST("tracks/helium/h2antiHeliumEtavsPt_Z2"), track.eta(), 2 * hePt);
             if (enablePIDplot)
@@ -2921,7 +2937,7 @@ struct LFNucleiBATask {
           }
 
           if (enableTr) {
-            if ((isTriton) && (TMath::Abs(track.rapidity(o2::track::PID::getMass2Z(o2::track::PID::Triton))) < yCut)) {
+            if ((isTriton) && (TMath::Abs(yTriton) < yCut)) {
               if (track.sign() > 0) {
                 if (enablePtSpectra)
                   histos.fill(HIST("tracks/eff/triton/hPtTrTOF"), track.pt());
@@ -20,6 +20,10 @@
 /// \author David Dobrigkeit Chinellato (david.dobrigkeit.chinellato@cern.ch)
 /// \author Zhongbao Yin (Zhong-Bao.Yin@cern.ch)
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
 #include "Common/DataModel/TrackSelectionTables.h"
@@ -93,12 +97,6 @@ struct correlateStrangeness {
   using BinningType = ColumnBinningPolicy<aod::collision::PosZ, aod::cent::CentFT0M>;
   BinningType colBinning{{axisVtxZ, axisMult}, true}; // true is for 'ignore overflows' (true by default). Underflows and overflows will have bin -1.
 
-  // collision slicing for mixed events
-  Preslice<aod::TriggerTracks> collisionSliceTracks = aod::triggerTracks::collisionId;
-  Preslice<aod::AssocV0s> collisionSliceV0s = aod::assocV0s::collisionId;
-  Preslice<aod::AssocCascades> collisionSliceCascades = aod::assocCascades::collisionId;
-  Preslice<aod::AssocPions> collisionSlicePions = aod::assocPions::collisionId;
-
   static constexpr std::string_view v0names[] = {"K0Short", "Lambda", "AntiLambda"};
   static constexpr std::string_view cascadenames[] = {"XiMinus", "XiPlus", "OmegaMinus", "OmegaPlus"};
 
@@ -148,174 +146,258 @@ struct correlateStrangeness {
     LOG(info) << "Efficiencies now loaded for " << mRunNumber;
   }
 
-  void fillCorrelationsV0(aod::TriggerTracks const& triggers, aod::AssocV0s const& assocs, bool mixing, float pvz, float mult)
+  /// Trigger tracks or associated particles of a collision (same event) or of the time frame (mixed event), stored per
+  /// quantity so that the table rows are read and the efficiency weights are looked up once per particle, and not per pair
+  struct ParticleCache {
+    std::vector<float> pt;
+    std::vector<float> eta;
+    std::vector<float> phi;
+    std::vector<std::array<int64_t, 3>> trackIds;  // global index of the track (trigger, pion) or of the daughters (V0, cascade), -1 if none
+    std::array<std::vector<int8_t>, 4> massRegion; // mass region of each species, 0 if the particle is not selected for the species
+    std::array<std::vector<float>, 4> weight;      // efficiency weight of each species
+    std::vector<int> collisionFirst;               // first particle of each collision, when filled for the time frame
+    std::vector<int> collisionLast;                // particle after the last one of each collision, when filled for the time frame
+
+    void clear(int nCollisions)
+    {
+      pt.clear();
+      eta.clear();
+      phi.clear();
+      trackIds.clear();
+      for (int iSpecies = 0; iSpecies < 4; iSpecies++) {
+        massRegion[iSpecies].clear();
+        weight[iSpecies].clear();
+      }
+      collisionFirst.assign(nCollisions, 0);
+      collisionLast.assign(nCollisions, 0);
+    }
+
+    /// \return index of the added particle
+    int add(float ptParticle, float etaParticle, float phiParticle, std::array<int64_t, 3> const& ids, int64_t collisionId)
+    {
+      const int iParticle = pt.size();
+      pt.push_back(ptParticle);
+      eta.push_back(etaParticle);
+      phi.push_back(phiParticle);
+      trackIds.push_back(ids);
+      for (int iSpecies = 0; iSpecies < 4; iSpecies++) {
+        massRegion[iSpecies].push_back(0);
+        weight[iSpecies].push_back(1.f);
+      }
+      // the tables of the filter are grouped by collision
+      if (collisionId >= 0 && collisionId < static_cast<int64_t>(collisionFirst.size())) {
+        if (collisionLast[collisionId] == collisionFirst[collisionId]) {
+          collisionFirst[collisionId] = iParticle;
+        }
+        collisionLast[collisionId] = iParticle + 1;
+      }
+      return iParticle;
+    }
+
+    int size() const { return pt.size(); }
+  };
+
+  // caches of the trigger tracks and of the associated particles
+  ParticleCache triggerCache;
+  ParticleCache assocCache;
+
+  /// Function to get the efficiency weight of a particle
+  /// \param hEfficiency efficiency map in pT and eta
+  float getEfficiencyWeight(TH2F* hEfficiency, float pt, float eta)
+  {
+    return applyEfficiencyCorrection ? 1. / hEfficiency->GetBinContent(hEfficiency->GetXaxis()->FindBin(pt), hEfficiency->GetYaxis()->FindBin(eta)) : 1.0f;
+  }
+
+  /// Fills the cache with the trigger tracks
+  /// \param nCollisions number of collisions of the time frame, to keep the range of each collision, or 0
+  void fillTriggerCache(aod::TriggerTracks const& triggers, ParticleCache& cache, int nCollisions = 0)
   {
-    for (auto& triggerTrack : triggers) {
+    cache.clear(nCollisions);
+    for (auto const& triggerTrack : triggers) {
       auto trigg = triggerTrack.track_as<TracksComplete>();
-      if (!mixing)
-        histos.fill(HIST("sameEvent/TriggerParticlesV0"), trigg.pt(), mult);
-      for (auto& assocCandidate : assocs) {
-        auto assoc = assocCandidate.v0Data();
-
-        //---] removing autocorrelations [---
-        auto postrack = assoc.posTrack_as<TracksComplete>();
-        auto negtrack = assoc.negTrack_as<TracksComplete>();
-        if (doAutocorrelationRejection) {
-          if (trigg.globalIndex() == postrack.globalIndex()) {
-            histos.fill(HIST("hNumberOfRejectedPairsV0"), 0.5);
-            continue;
-          }
-          if (trigg.globalIndex() == negtrack.globalIndex()) {
+      cache.add(trigg.pt(), trigg.eta(), trigg.phi(), {trigg.globalIndex(), -1, -1}, triggerTrack.collisionId());
+    }
+  }
+
+  /// Fills the cache with the associated V0s, with the mass region and the weight of the requested species
+  void fillAssocCacheV0(aod::AssocV0s const& assocs, ParticleCache& cache, int nCollisions = 0)
+  {
+    cache.clear(nCollisions);
+    TH2F* hEfficiencyV0[3];
+    hEfficiencyV0[0] = hEfficiencyK0Short;
+    hEfficiencyV0[1] = hEfficiencyLambda;
+    hEfficiencyV0[2] = hEfficiencyAntiLambda;
+
+    for (auto const& assocCandidate : assocs) {
+      auto assoc = assocCandidate.v0Data();
+      const int iParticle = cache.add(assoc.pt(), assoc.eta(), assoc.phi(), {assoc.posTrackId(), assoc.negTrackId(), -1}, assocCandidate.collisionId());
+      static_for<0, 2>([&](auto i) {
+        constexpr int index = i.value;
+        if (bitcheck(doCorrelation, index) && assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index))) {
+          cache.massRegion[index][iParticle] = assocCandidate.invMassRegion(index);
+          cache.weight[index][iParticle] = getEfficiencyWeight(hEfficiencyV0[index], assoc.pt(), assoc.eta());
+        }
+      });
+    }
+  }
+
+  /// Fills the cache with the associated cascades, with the mass region and the weight of the requested species
+  void fillAssocCacheCascade(aod::AssocCascades const& assocs, ParticleCache& cache, int nCollisions = 0)
+  {
+    cache.clear(nCollisions);
+    TH2F* hEfficiencyCascade[4];
+    hEfficiencyCascade[0] = hEfficiencyXiMinus;
+    hEfficiencyCascade[1] = hEfficiencyXiPlus;
+    hEfficiencyCascade[2] = hEfficiencyOmegaMinus;
+    hEfficiencyCascade[3] = hEfficiencyOmegaPlus;
+
+    for (auto const& assocCandidate : assocs) {
+      auto assoc = assocCandidate.cascData();
+      const int iParticle = cache.add(assoc.pt(), assoc.eta(), assoc.phi(), {assoc.posTrackId(), assoc.negTrackId(), assoc.bachelorId()}, assocCandidate.collisionId());
+      static_for<0, 3>([&](auto i) {
+        constexpr int index = i.value;
+        if (bitcheck(doCorrelation, index + 3) && assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index))) {
+          cache.massRegion[index][iParticle] = assocCandidate.invMassRegion(index);
+          cache.weight[index][iParticle] = getEfficiencyWeight(hEfficiencyCascade[index], assoc.pt(), assoc.eta());
+        }
+      });
+    }
+  }
+
+  /// Fills the cache with the associated pions
+  void fillAssocCachePion(aod::AssocPions const& assocs, ParticleCache& cache, int nCollisions = 0)
+  {
+    cache.clear(nCollisions);
+    for (auto const& assocTrack : assocs) {
+      auto assoc = assocTrack.track_as<TracksComplete>();
+      cache.add(assoc.pt(), assoc.eta(), assoc.phi(), {assoc.globalIndex(), -1, -1}, assocTrack.collisionId());
+    }
+  }
+
+  /// Checks the autocorrelation and the axis ranges of a pair and computes its delta-phi and delta-eta
+  /// \param nDaughters number of daughter tracks of the associated particle to compare with the trigger
+  /// \return false if the pair is rejected
+  bool checkPair(ParticleCache const& triggers, int iTrigger, ParticleCache const& assocs, int iAssoc, int nDaughters, float& deltaphi, float& deltaeta)
+  {
+    //---] removing autocorrelations [---
+    if (doAutocorrelationRejection) {
+      for (int iDaughter = 0; iDaughter < nDaughters; iDaughter++) {
+        if (triggers.trackIds[iTrigger][0] == assocs.trackIds[iAssoc][iDaughter]) {
+          if (nDaughters == 1) {
+            histos.fill(HIST("hNumberOfRejectedPairsPions"), 0.5);
+          } else if (nDaughters == 2) {
             histos.fill(HIST("hNumberOfRejectedPairsV0"), 0.5);
-            continue;
+          } else {
+            histos.fill(HIST("hNumberOfRejectedPairsCascades"), 0.5);
           }
+          return false;
         }
+      }
+    }
 
-        float deltaphi = ComputeDeltaPhi(trigg.phi(), assoc.phi());
-        float deltaeta = trigg.eta() - assoc.eta();
-        float ptassoc = assoc.pt();
-        float pttrigger = trigg.pt();
+    deltaphi = ComputeDeltaPhi(triggers.phi[iTrigger], assocs.phi[iAssoc]);
+    deltaeta = triggers.eta[iTrigger] - assocs.eta[iAssoc];
+    float ptassoc = assocs.pt[iAssoc];
+    float pttrigger = triggers.pt[iTrigger];
+
+    // skip if basic ranges not met
+    if (deltaphi < axisRanges[0][0] || deltaphi > axisRanges[0][1])
+      return false;
+    if (deltaeta < axisRanges[1][0] || deltaeta > axisRanges[1][1])
+      return false;
+    if (ptassoc < axisRanges[2][0] || ptassoc > axisRanges[2][1])
+      return false;
+    if (pttrigger < axisRanges[3][0] || pttrigger > axisRanges[3][1])
+      return false;
+    return true;
+  }
 
-        // skip if basic ranges not met
-        if (deltaphi < axisRanges[0][0] || deltaphi > axisRanges[0][1])
-          continue;
-        if (deltaeta < axisRanges[1][0] || deltaeta > axisRanges[1][1])
-          continue;
-        if (ptassoc < axisRanges[2][0] || ptassoc > axisRanges[2][1])
-          continue;
-        if (pttrigger < axisRanges[3][0] || pttrigger > axisRanges[3][1])
+  /// Correlates the trigger tracks of a collision with the associated V0s of a collision, for all the species in one pass
+  /// \param firstTrigger, lastTrigger range of the trigger tracks in their cache
+  /// \param firstAssoc, lastAssoc range of the associated V0s in their cache
+  void fillCorrelationsV0(ParticleCache const& triggers, int firstTrigger, int lastTrigger, ParticleCache const& assocs, int firstAssoc, int lastAssoc, bool mixing, float pvz, float mult)
+  {
+    for (int iTrigger = firstTrigger; iTrigger < lastTrigger; iTrigger++) {
+      float pttrigger = triggers.pt[iTrigger];
+      if (!mixing)
+        histos.fill(HIST("sameEvent/TriggerParticlesV0"), pttrigger, mult);
+      for (int iAssoc = firstAssoc; iAssoc < lastAssoc; iAssoc++) {
+        float deltaphi, deltaeta;
+        if (!checkPair(triggers, iTrigger, assocs, iAssoc, 2, deltaphi, deltaeta))
           continue;
-
-        TH2F* hEfficiencyV0[3];
-        hEfficiencyV0[0] = hEfficiencyK0Short;
-        hEfficiencyV0[1] = hEfficiencyLambda;
-        hEfficiencyV0[2] = hEfficiencyAntiLambda;
+        float ptassoc = assocs.pt[iAssoc];
 
         static_for<0, 2>([&](auto i) {
           constexpr int index = i.value;
-          if (bitcheck(doCorrelation, index)) {
-            float weight = applyEfficiencyCorrection ? 1. / hEfficiencyV0[index]->GetBinContent(hEfficiencyV0[index]->GetXaxis()->FindBin(ptassoc), hEfficiencyV0[index]->GetYaxis()->FindBin(assoc.eta())) : 1.0f;
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && !mixing && assocCandidate.invMassRegionCheck(index, 1))
-              histos.fill(HIST("sameEvent/LeftBg/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && !mixing && assocCandidate.invMassRegionCheck(index, 2))
-              histos.fill(HIST("sameEvent/Signal/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && !mixing && assocCandidate.invMassRegionCheck(index, 3))
-              histos.fill(HIST("sameEvent/RightBg/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && mixing && assocCandidate.invMassRegionCheck(index, 1))
-              histos.fill(HIST("mixedEvent/LeftBg/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && mixing && assocCandidate.invMassRegionCheck(index, 2))
-              histos.fill(HIST("mixedEvent/Signal/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && mixing && assocCandidate.invMassRegionCheck(index, 3))
-              histos.fill(HIST("mixedEvent/RightBg/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-          }
+          const int region = assocs.massRegion[index][iAssoc];
+          const float weight = assocs.weight[index][iAssoc];
+          if (region == 1 && !mixing)
+            histos.fill(HIST("sameEvent/LeftBg/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
+          if (region == 2 && !mixing)
+            histos.fill(HIST("sameEvent/Signal/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
+          if (region == 3 && !mixing)
+            histos.fill(HIST("sameEvent/RightBg/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
+          if (region == 1 && mixing)
+            histos.fill(HIST("mixedEvent/LeftBg/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
+          if (region == 2 && mixing)
+            histos.fill(HIST("mixedEvent/Signal/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
+          if (region == 3 && mixing)
+            histos.fill(HIST("mixedEvent/RightBg/") + HIST(v0names[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
         });
       }
     }
   }
 
-  void fillCorrelationsCascade(aod::TriggerTracks const& triggers, aod::AssocCascades const& assocs, bool mixing, float pvz, float mult)
+  /// Correlates the trigger tracks of a collision with the associated cascades of a collision, for all the species in one pass
+  /// \param firstTrigger, lastTrigger range of the trigger tracks in their cache
+  /// \param firstAssoc, lastAssoc range of the associated cascades in their cache
+  void fillCorrelationsCascade(ParticleCache const& triggers, int firstTrigger, int lastTrigger, ParticleCache const& assocs, int firstAssoc, int lastAssoc, bool mixing, float pvz, float mult)
   {
-    for (auto& triggerTrack : triggers) {
-      auto trigg = triggerTrack.track_as<TracksComplete>();
+    for (int iTrigger = firstTrigger; iTrigger < lastTrigger; iTrigger++) {
+      float pttrigger = triggers.pt[iTrigger];
       if (!mixing)
-        histos.fill(HIST("sameEvent/TriggerParticlesCascade"), trigg.pt(), mult);
-      for (auto& assocCandidate : assocs) {
-        auto assoc = assocCandidate.cascData();
-
-        //---] removing autocorrelations [---
-        auto postrack = assoc.posTrack_as<TracksComplete>();
-        auto negtrack = assoc.negTrack_as<TracksComplete>();
-        auto bachtrack = assoc.bachelor_as<TracksComplete>();
-        if (doAutocorrelationRejection) {
-          if (trigg.globalIndex() == postrack.globalIndex()) {
-            histos.fill(HIST("hNumberOfRejectedPairsCascades"), 0.5);
-            continue;
-          }
-          if (trigg.globalIndex() == negtrack.globalIndex()) {
-            histos.fill(HIST("hNumberOfRejectedPairsCascades"), 0.5);
-            continue;
-          }
-          if (trigg.globalIndex() == bachtrack.globalIndex()) {
-            histos.fill(HIST("hNumberOfRejectedPairsCascades"), 0.5);
-            continue;
-          }
-        }
-
-        float deltaphi = ComputeDeltaPhi(trigg.phi(), assoc.phi());
-        float deltaeta = trigg.eta() - assoc.eta();
-        float ptassoc = assoc.pt();
-        float pttrigger = trigg.pt();
-
-        // skip if basic ranges not met
-        if (deltaphi < axisRanges[0][0] || deltaphi > axisRanges[0][1])
-          continue;
-        if (deltaeta < axisRanges[1][0] || deltaeta > axisRanges[1][1])
-          continue;
-        if (ptassoc < axisRanges[2][0] || ptassoc > axisRanges[2][1])
-          continue;
-        if (pttrigger < axisRanges[3][0] || pttrigger > axisRanges[3][1])
+        histos.fill(HIST("sameEvent/TriggerParticlesCascade"), pttrigger, mult);
+      for (int iAssoc = firstAssoc; iAssoc < lastAssoc; iAssoc++) {
+        float deltaphi, deltaeta;
+        if (!checkPair(triggers, iTrigger, assocs, iAssoc, 3, deltaphi, deltaeta))
           continue;
-
-        TH2F* hEfficiencyCascade[4];
-        hEfficiencyCascade[0] = hEfficiencyXiMinus;
-        hEfficiencyCascade[1] = hEfficiencyXiPlus;
-        hEfficiencyCascade[2] = hEfficiencyOmegaMinus;
-        hEfficiencyCascade[3] = hEfficiencyOmegaPlus;
+        float ptassoc = assocs.pt[iAssoc];
 
         static_for<0, 3>([&](auto i) {
           constexpr int index = i.value;
-          if (bitcheck(doCorrelation, index + 3)) {
-            float weight = applyEfficiencyCorrection ? 1. / hEfficiencyCascade[index]->GetBinContent(hEfficiencyCascade[index]->GetXaxis()->FindBin(ptassoc), hEfficiencyCascade[index]->GetYaxis()->FindBin(assoc.eta())) : 1.0f;
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && !mixing && assocCandidate.invMassRegionCheck(index, 1))
-              histos.fill(HIST("sameEvent/LeftBg/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && !mixing && assocCandidate.invMassRegionCheck(index, 2))
-              histos.fill(HIST("sameEvent/Signal/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && !mixing && assocCandidate.invMassRegionCheck(index, 3))
-              histos.fill(HIST("sameEvent/RightBg/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && mixing && assocCandidate.invMassRegionCheck(index, 1))
-              histos.fill(HIST("mixedEvent/LeftBg/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && mixing && assocCandidate.invMassRegionCheck(index, 2))
-              histos.fill(HIST("mixedEvent/Signal/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-            if (assocCandidate.compatible(index) && (!doMCassociation || assocCandidate.mcTrue(index)) && mixing && assocCandidate.invMassRegionCheck(index, 3))
-              histos.fill(HIST("mixedEvent/RightBg/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
-          }
+          const int region = assocs.massRegion[index][iAssoc];
+          const float weight = assocs.weight[index][iAssoc];
+          if (region == 1 && !mixing)
+            histos.fill(HIST("sameEvent/LeftBg/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
+          if (region == 2 && !mixing)
+            histos.fill(HIST("sameEvent/Signal/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
+          if (region == 3 && !mixing)
+            histos.fill(HIST("sameEvent/RightBg/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
+          if (region == 1 && mixing)
+            histos.fill(HIST("mixedEvent/LeftBg/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
+          if (region == 2 && mixing)
+            histos.fill(HIST("mixedEvent/Signal/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
+          if (region == 3 && mixing)
+            histos.fill(HIST("mixedEvent/RightBg/") + HIST(cascadenames[index]), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult, weight);
         });
       }
     }
   }
 
-  void fillCorrelationsPion(aod::TriggerTracks const& triggers, aod::AssocPions const& assocs, bool mixing, float pvz, float mult)
+  /// Correlates the trigger tracks of a collision with the associated pions of a collision
+  /// \param firstTrigger, lastTrigger range of the trigger tracks in their cache
+  /// \param firstAssoc, lastAssoc range of the associated pions in their cache
+  void fillCorrelationsPion(ParticleCache const& triggers, int firstTrigger, int lastTrigger, ParticleCache const& assocs, int firstAssoc, int lastAssoc, bool mixing, float pvz, float mult)
   {
-
-    for (auto& triggerTrack : triggers) {
-      auto trigg = triggerTrack.track_as<TracksComplete>();
+    for (int iTrigger = firstTrigger; iTrigger < lastTrigger; iTrigger++) {
+      float pttrigger = triggers.pt[iTrigger];
       if (!mixing)
-        histos.fill(HIST("sameEvent/TriggerParticlesPion"), trigg.pt(), mult);
-      for (auto& assocTrack : assocs) {
-        auto assoc = assocTrack.track_as<TracksComplete>();
-
-        //---] removing autocorrelations [---
-        if (doAutocorrelationRejection) {
-          if (trigg.globalIndex() == assoc.globalIndex()) {
-            histos.fill(HIST("hNumberOfRejectedPairsPions"), 0.5);
-            continue;
-          }
-        }
-
-        float deltaphi = ComputeDeltaPhi(trigg.phi(), assoc.phi());
-        float deltaeta = trigg.eta() - assoc.eta();
-        float ptassoc = assoc.pt();
-        float pttrigger = trigg.pt();
-
-        // skip if basic ranges not met
-        if (deltaphi < axisRanges[0][0] || deltaphi > axisRanges[0][1])
-          continue;
-        if (deltaeta < axisRanges[1][0] || deltaeta > axisRanges[1][1])
-          continue;
-        if (ptassoc < axisRanges[2][0] || ptassoc > axisRanges[2][1])
-          continue;
-        if (pttrigger < axisRanges[3][0] || pttrigger > axisRanges[3][1])
+        histos.fill(HIST("sameEvent/TriggerParticlesPion"), pttrigger, mult);
+      for (int iAssoc = firstAssoc; iAssoc < lastAssoc; iAssoc++) {
+        float deltaphi, deltaeta;
+        if (!checkPair(triggers, iTrigger, assocs, iAssoc, 1, deltaphi, deltaeta))
           continue;
+        float ptassoc = assocs.pt[iAssoc];
 
         if (!mixing)
           histos.fill(HIST("sameEvent/Pion"), deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult);
@@ -689,7 +771,9 @@ struct correlateStrangeness {
 
     // ________________________________________________
     // Do hadron - V0 correlations
-    fillCorrelationsV0(triggerTracks, associatedV0s, false, collision.posZ(), collision.centFT0M());
+    fillTriggerCache(triggerTracks, triggerCache);
+    fillAssocCacheV0(associatedV0s, assocCache);
+    fillCorrelationsV0(triggerCache, 0, triggerCache.size(), assocCache, 0, assocCache.size(), false, collision.posZ(), collision.centFT0M());
   }
 
   void processSameEventHCascades(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Ms>::iterator const& collision,
@@ -742,7 +826,9 @@ struct correlateStrangeness {
 
     // ________________________________________________
     // Do hadron - cascade correlations
-    fillCorrelationsCascade(triggerTracks, associatedCascades, false, collision.posZ(), collision.centFT0M());
+    fillTriggerCache(triggerTracks, triggerCache);
+    fillAssocCacheCascade(associatedCascades, assocCache);
+    fillCorrelationsCascade(triggerCache, 0, triggerCache.size(), assocCache, 0, assocCache.size(), false, collision.posZ(), collision.centFT0M());
   }
   void processSameEventHPions(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Ms>::iterator const& collision,
                               aod::AssocPions const& associatedPions, aod::TriggerTracks const& triggerTracks,
@@ -779,12 +865,17 @@ struct correlateStrangeness {
 
     // ________________________________________________
     // Do hadron - Pion correlations
-    fillCorrelationsPion(triggerTracks, associatedPions, false, collision.posZ(), collision.centFT0M());
+    fillTriggerCache(triggerTracks, triggerCache);
+    fillAssocCachePion(associatedPions, assocCache);
+    fillCorrelationsPion(triggerCache, 0, triggerCache.size(), assocCache, 0, assocCache.size(), false, collision.posZ(), collision.centFT0M());
   }
   void processMixedEventHV0s(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Ms> const& collisions,
                              aod::AssocV0s const& associatedV0s, aod::TriggerTracks const& triggerTracks,
                              aod::V0Datas const&, aod::V0sLinked const&, TracksComplete const&)
   {
+    // the particles of the time frame are cached once, the mixed collisions read their ranges
+    fillTriggerCache(triggerTracks, triggerCache, collisions.size());
+    fillAssocCacheV0(associatedV0s, assocCache, collisions.size());
     for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, mixingParameter, -1, collisions, collisions)) {
       // ________________________________________________
       // Perform basic event selection on both collisions
@@ -806,18 +897,19 @@ struct correlateStrangeness {
         histos.fill(HIST("MixingQA/hMECollisionBins"), colBinning.getBin({collision1.posZ(), collision1.centFT0M()}));
       }
       // ________________________________________________
-      // Do slicing
-      auto slicedTriggerTracks = triggerTracks.sliceBy(collisionSliceTracks, collision1.globalIndex());
-      auto slicedAssocV0s = associatedV0s.sliceBy(collisionSliceV0s, collision2.globalIndex());
-      // ________________________________________________
       // Do hadron - V0 correlations
-      fillCorrelationsV0(slicedTriggerTracks, slicedAssocV0s, true, collision1.posZ(), collision1.centFT0M());
+      auto iColl1 = collision1.globalIndex();
+      auto iColl2 = collision2.globalIndex();
+      fillCorrelationsV0(triggerCache, triggerCache.collisionFirst[iColl1], triggerCache.collisionLast[iColl1], assocCache, assocCache.collisionFirst[iColl2], assocCache.collisionLast[iColl2], true, collision1.posZ(), collision1.centFT0M());
     }
   }
   void processMixedEventHCascades(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Ms> const& collisions,
                                   aod::AssocV0s const& associatedV0s, aod::AssocCascades const& associatedCascades, aod::TriggerTracks const& triggerTracks,
                                   aod::V0Datas const&, aod::V0sLinked const&, aod::CascDatas const&, TracksComplete const&)
   {
+    // the particles of the time frame are cached once, the mixed collisions read their ranges
+    fillTriggerCache(triggerTracks, triggerCache, collisions.size());
+    fillAssocCacheCascade(associatedCascades, assocCache, collisions.size());
     for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, mixingParameter, -1, collisions, collisions)) {
       // ________________________________________________
       // Perform basic event selection on both collisions
@@ -838,18 +930,19 @@ struct correlateStrangeness {
       histos.fill(HIST("MixingQA/hMEpvz2"), collision2.posZ());
       histos.fill(HIST("MixingQA/hMECollisionBins"), colBinning.getBin({collision1.posZ(), collision1.centFT0M()}));
       // ________________________________________________
-      // Do slicing
-      auto slicedTriggerTracks = triggerTracks.sliceBy(collisionSliceTracks, collision1.globalIndex());
-      auto slicedAssocCascades = associatedCascades.sliceBy(collisionSliceCascades, collision2.globalIndex());
-      // ________________________________________________
       // Do hadron - cascade correlations
-      fillCorrelationsCascade(slicedTriggerTracks, slicedAssocCascades, true, collision1.posZ(), collision1.centFT0M());
+      auto iColl1 = collision1.globalIndex();
+      auto iColl2 = collision2.globalIndex();
+      fillCorrelationsCascade(triggerCache, triggerCache.collisionFirst[iColl1], triggerCache.collisionLast[iColl1], assocCache, assocCache.collisionFirst[iColl2], assocCache.collisionLast[iColl2], true, collision1.posZ(), collision1.centFT0M());
     }
   }
   void processMixedEventHPions(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Ms> const& collisions,
                                aod::AssocPions const& assocPions, aod::TriggerTracks const& triggerTracks,
                                TracksComplete const&)
   {
+    // the particles of the time frame are cached once, the mixed collisions read their ranges
+    fillTriggerCache(triggerTracks, triggerCache, collisions.size());
+    fillAssocCachePion(assocPions, assocCache, collisions.size());
     for (auto& [collision1, collision2] : soa::selfCombinations(colBinning, mixingParameter, -1, collisions, collisions)) {
       // ________________________________________________
       // Perform basic event selection on both collisions
@@ -870,12 +963,10 @@ struct correlateStrangeness {
       histos.fill(HIST("MixingQA/hMEpvz2"), collision2.posZ());
       histos.fill(HIST("MixingQA/hMECollisionBins"), colBinning.getBin({collision1.posZ(), collision1.centFT0M()}));
       // ________________________________________________
-      // Do slicing
-      auto slicedTriggerTracks = triggerTracks.sliceBy(collisionSliceTracks, collision1.globalIndex());
-      auto slicedAssocPions = assocPions.sliceBy(collisionSlicePions, collision2.globalIndex());
-      // ________________________________________________
-      // Do hadron - cascade correlations
-      fillCorrelationsPion(slicedTriggerTracks, slicedAssocPions, true, collision1.posZ(), collision1.centFT0M());
+      // Do hadron - pion correlations
+      auto iColl1 = collision1.globalIndex();
+      auto iColl2 = collision2.globalIndex();
+      fillCorrelationsPion(triggerCache, triggerCache.collisionFirst[iColl1], triggerCache.collisionLast[iColl1], assocCache, assocCache.collisionFirst[iColl2], assocCache.collisionLast[iColl2], true, collision1.posZ(), collision1.centFT0M());
     }
   }
   void processMCGenerated(aod::McCollision const& mcCollision, soa::SmallGroups<soa::Join<aod::McCollisionLabels, aod::Collisions, aod::EvSels, aod::CentFT0Ms>> const& collisions, aod::McParticles const& mcParticles)
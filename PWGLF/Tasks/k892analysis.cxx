@@ -26,12 +26,14 @@
 #include "PWGLF/DataModel/LFResonanceTables.h"
 #include "DataFormatsParameters/GRPObject.h"
 #include "CommonConstants/PhysicsConstants.h"
+#include "PWGLF/Utils/resonanceEventMixing.h"
 
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::soa;
 using namespace o2::constants::physics;
+using namespace o2::analysis;
 
 struct k892analysis {
   SliceCache cache;
@@ -150,6 +152,9 @@ struct k892analysis {
 
   double massKa = MassKaonCharged;
   double massPi = MassPionCharged;
+  // Daughter candidates of the event mixing
+  ResoMixingDaughters mixingPions;
+  ResoMixingDaughters mixingKaons;
 
   template <typename TrackType>
   bool trackCut(const TrackType track)
@@ -403,8 +408,28 @@ struct k892analysis {
     BinningTypeVtxZT0M colBinning{{CfgVtxBins, CfgMultBins}, true};
     SameKindPair<aod::ResoCollisions, aod::ResoTracks, BinningTypeVtxZT0M> pairs{colBinning, nEvtMixing, -1, collisions, tracksTuple, &cache}; // -1 is the number of the bin to skip
 
+    // the daughter selections do not depend on the paired collision, they are evaluated once per track
+    mixingPions.fill(resotracks, collisions.size(), [this](const auto& track) { return trackCut(track) && (!cUseOnlyTOFTrackPi || track.hasTOF()) && selectionPIDPion(track); });
+    mixingKaons.fill(resotracks, collisions.size(), [this](const auto& track) { return trackCut(track) && (!cUseOnlyTOFTrackKa || track.hasTOF()) && selectionPIDKaon(track); });
+
     for (auto& [collision1, tracks1, collision2, tracks2] : pairs) {
-      fillHistograms<false, true>(collision1, tracks1, tracks2);
+      auto multiplicity = collision1.cent();
+      forEachResoMixingPair(mixingPions.get(collision1.globalIndex()), massPi, mixingKaons.get(collision2.globalIndex()), massKa, [&](const auto& pion, const auto& kaon, const ResoMixingPair& resonance) {
+        // Rapidity cut
+        if (std::abs(resonance.rapidity) > 0.5) {
+          return;
+        }
+        if (pion.sign * kaon.sign < 0) {
+          histos.fill(HIST("k892invmassME"), resonance.mass);
+          histos.fill(HIST("h3k892invmassME"), multiplicity, resonance.pt, resonance.mass);
+        } else if (pion.sign > 0) {
+          histos.fill(HIST("k892invmassLS"), resonance.mass);
+          histos.fill(HIST("h3k892invmassLS"), multiplicity, resonance.pt, resonance.mass);
+        } else {
+          histos.fill(HIST("k892invmassLSAnti"), resonance.mass);
+          histos.fill(HIST("h3k892invmassLSAnti"), multiplicity, resonance.pt, resonance.mass);
+        }
+      });
     }
   };
   PROCESS_SWITCH(k892analysis, processMELight, "Process EventMixing light without partition", false);
@@ -18,11 +18,13 @@
 #include "Framework/AnalysisTask.h"
 #include "PWGLF/DataModel/LFResonanceTables.h"
 #include "CommonConstants/PhysicsConstants.h"
+#include "PWGLF/Utils/resonanceEventMixing.h"
 
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::soa;
 using namespace o2::constants::physics;
+using namespace o2::analysis;
 
 struct lambda1520analysis {
   // Define slice per Resocollision
@@ -97,6 +99,18 @@ struct lambda1520analysis {
 
   void init(o2::framework::InitContext&)
   {
+    // converted once instead of for each collision
+    vKaonTPCPIDpTintv = static_cast<std::vector<double>>(kaonTPCPIDpTintv);
+    vKaonTPCPIDpTintv.insert(vKaonTPCPIDpTintv.begin(), cMinPtcut);
+    vKaonTPCPIDcuts = static_cast<std::vector<double>>(kaonTPCPIDcuts);
+    vKaonTOFPIDpTintv = static_cast<std::vector<double>>(kaonTOFPIDpTintv);
+    vKaonTOFPIDcuts = static_cast<std::vector<double>>(kaonTOFPIDcuts);
+    vProtonTPCPIDpTintv = static_cast<std::vector<double>>(protonTPCPIDpTintv);
+    vProtonTPCPIDpTintv.insert(vProtonTPCPIDpTintv.begin(), cMinPtcut);
+    vProtonTPCPIDcuts = static_cast<std::vector<double>>(protonTPCPIDcuts);
+    vProtonTOFPIDpTintv = static_cast<std::vector<double>>(protonTOFPIDpTintv);
+    vProtonTOFPIDcuts = static_cast<std::vector<double>>(protonTOFPIDcuts);
+
     // axes
     AxisSpec axisPt{binsPt, "#it{p}_{T} (GeV/#it{c})"};
     AxisSpec axisEta{binsEta, ""};
@@ -206,6 +220,12 @@ struct lambda1520analysis {
 
   double massKa = MassKaonCharged;
   double massPr = MassProton;
+  // Daughter candidates of the event mixing
+  ResoMixingDaughters mixingProtons;
+  ResoMixingDaughters mixingKaons;
+  // pT intervals and nSigma cuts of the pT-dependent PID selections
+  std::vector<double> vKaonTPCPIDpTintv, vKaonTPCPIDcuts, vKaonTOFPIDpTintv, vKaonTOFPIDcuts;
+  std::vector<double> vProtonTPCPIDpTintv, vProtonTPCPIDcuts, vProtonTOFPIDpTintv, vProtonTOFPIDcuts;
 
   template <typename TrackType>
   bool trackCut(const TrackType track)
@@ -266,26 +286,90 @@ struct lambda1520analysis {
     return false;
   }
 
-  template <bool IsMC, bool IsMix, typename CollisionType, typename TracksType>
-  void fillHistograms(const CollisionType& collision, const TracksType& dTracks1, const TracksType& dTracks2)
+  // pT-dependent PID selection
+  template <typename T>
+  bool selectionPIDProtonPtDependent(const T& candidate, bool hasTOF)
   {
-    TLorentzVector lDecayDaughter1, lDecayDaughter2, lResonance;
-
-    auto vKaonTPCPIDpTintv = static_cast<std::vector<double>>(kaonTPCPIDpTintv);
-    vKaonTPCPIDpTintv.insert(vKaonTPCPIDpTintv.begin(), cMinPtcut);
-    auto vKaonTPCPIDcuts = static_cast<std::vector<double>>(kaonTPCPIDcuts);
-    auto vKaonTOFPIDpTintv = static_cast<std::vector<double>>(kaonTOFPIDpTintv);
-    auto vKaonTOFPIDcuts = static_cast<std::vector<double>>(kaonTOFPIDcuts);
+    auto pt = candidate.pt();
+    auto nSigmaTPC = candidate.tpcNSigmaPr();
+    auto nSigmaTOF = hasTOF ? candidate.tofNSigmaPr() : -999.;
+    auto lengthOfprotonTPCPIDpTintv = static_cast<int>(vProtonTPCPIDpTintv.size());
+    auto lengthOfprotonTOFPIDpTintv = static_cast<int>(vProtonTOFPIDpTintv.size());
+    if (hasTOF) {
+      if (lengthOfprotonTOFPIDpTintv > 0) {
+        if (pt > vProtonTOFPIDpTintv[lengthOfprotonTOFPIDpTintv - 1]) {
+          return false;
+        } else {
+          for (int i = 0; i < lengthOfprotonTOFPIDpTintv; i++) {
+            if (pt < vProtonTOFPIDpTintv[i]) {
+              if (std::abs(nSigmaTOF) > vProtonTOFPIDcuts[i])
+                return false;
+              if (std::abs(nSigmaTPC) > cMaxTPCnSigmaProtonVETO)
+                return false;
+            }
+          }
+        }
+      }
+    } else {
+      if (lengthOfprotonTPCPIDpTintv > 0) {
+        if (pt > vProtonTPCPIDpTintv[lengthOfprotonTPCPIDpTintv - 1]) {
+          return false;
+        } else {
+          for (int i = 0; i < lengthOfprotonTPCPIDpTintv; i++) {
+            if (pt > vProtonTPCPIDpTintv[i] && pt < vProtonTPCPIDpTintv[i + 1]) {
+              if (std::abs(nSigmaTPC) > vProtonTPCPIDcuts[i])
+                return false;
+            }
+          }
+        }
+      }
+    }
+    return true;
+  }
+  template <typename T>
+  bool selectionPIDKaonPtDependent(const T& candidate, bool hasTOF)
+  {
+    auto pt = candidate.pt();
+    auto nSigmaTPC = candidate.tpcNSigmaKa();
+    auto nSigmaTOF = hasTOF ? candidate.tofNSigmaKa() : -999.;
     auto lengthOfkaonTPCPIDpTintv = static_cast<int>(vKaonTPCPIDpTintv.size());
     auto lengthOfkaonTOFPIDpTintv = static_cast<int>(vKaonTOFPIDpTintv.size());
+    if (hasTOF) {
+      if (lengthOfkaonTOFPIDpTintv > 0) {
+        if (pt > vKaonTOFPIDpTintv[lengthOfkaonTOFPIDpTintv - 1]) {
+          return false;
+        } else {
+          for (int i = 0; i < lengthOfkaonTOFPIDpTintv; i++) {
+            if (pt < vKaonTOFPIDpTintv[i]) {
+              if (std::abs(nSigmaTOF) > vKaonTOFPIDcuts[i])
+                return false;
+              if (std::abs(nSigmaTPC) > cMaxTPCnSigmaKaonVETO)
+                return false;
+            }
+          }
+        }
+      }
+    } else {
+      if (lengthOfkaonTPCPIDpTintv > 0) {
+        if (pt > vKaonTPCPIDpTintv[lengthOfkaonTPCPIDpTintv - 1]) {
+          return false;
+        } else {
+          for (int i = 0; i < lengthOfkaonTPCPIDpTintv; i++) {
+            if (pt > vKaonTPCPIDpTintv[i] && pt < vKaonTPCPIDpTintv[i + 1]) {
+              if (std::abs(nSigmaTPC) > vKaonTPCPIDcuts[i])
+                return false;
+            }
+          }
+        }
+      }
+    }
+    return true;
+  }
 
-    auto vProtonTPCPIDpTintv = static_cast<std::vector<double>>(protonTPCPIDpTintv);
-    vProtonTPCPIDpTintv.insert(vProtonTPCPIDpTintv.begin(), cMinPtcut);
-    auto vProtonTPCPIDcuts = static_cast<std::vector<double>>(protonTPCPIDcuts);
-    auto vProtonTOFPIDpTintv = static_cast<std::vector<double>>(protonTOFPIDpTintv);
-    auto vProtonTOFPIDcuts = static_cast<std::vector<double>>(protonTOFPIDcuts);
-    auto lengthOfprotonTPCPIDpTintv = static_cast<int>(vProtonTPCPIDpTintv.size());
-    auto lengthOfprotonTOFPIDpTintv = static_cast<int>(vProtonTOFPIDpTintv.size());
+  template <bool IsMC, bool IsMix, typename CollisionType, typename TracksType>
+  void fillHistograms(const CollisionType& collision, const TracksType& dTracks1, const TracksType& dTracks2)
+  {
+    TLorentzVector lDecayDaughter1, lDecayDaughter2, lResonance;
 
     for (auto& [trk1, trk2] : combinations(CombinationsFullIndexPolicy(dTracks1, dTracks2))) {
       // Full index policy is needed to consider all possible combinations
@@ -298,8 +382,6 @@ struct lambda1520analysis {
 
       //// Initialize variables
       // Trk1: Proton, Trk2: Kaon
-      bool isTrk1Selected{true}, isTrk2Selected{true}; //, isTrk1hasTOF{false}, isTrk2hasTOF{false};
-
       auto isTrk1hasTOF = trk1.hasTOF();
       auto isTrk2hasTOF = trk2.hasTOF();
 
@@ -312,69 +394,8 @@ struct lambda1520analysis {
 
       //// PID selections
       // we can apply pT-dependent PID cuts
-      // For Proton candidate:
-      if (isTrk1hasTOF) {
-        trk1NSigmaPrTOF = trk1.tofNSigmaPr();
-        if (lengthOfprotonTOFPIDpTintv > 0) {
-          if (trk1ptPr > vProtonTOFPIDpTintv[lengthOfprotonTOFPIDpTintv - 1]) {
-            isTrk1Selected = false;
-          } else {
-            for (int i = 0; i < lengthOfprotonTOFPIDpTintv; i++) {
-              if (trk1ptPr < vProtonTOFPIDpTintv[i]) {
-                if (std::abs(trk1NSigmaPrTOF) > vProtonTOFPIDcuts[i])
-                  isTrk1Selected = false;
-                if (std::abs(trk1NSigmaPrTPC) > cMaxTPCnSigmaProtonVETO)
-                  isTrk1Selected = false;
-              }
-            }
-          }
-        }
-      } else {
-        if (lengthOfprotonTPCPIDpTintv > 0) {
-          if (trk1ptPr > vProtonTPCPIDpTintv[lengthOfprotonTPCPIDpTintv - 1]) {
-            isTrk1Selected = false;
-          } else {
-            for (int i = 0; i < lengthOfprotonTPCPIDpTintv; i++) {
-              if (trk1ptPr > vProtonTPCPIDpTintv[i] && trk1ptPr < vProtonTPCPIDpTintv[i + 1]) {
-                if (std::abs(trk1NSigmaPrTPC) > vProtonTPCPIDcuts[i])
-                  isTrk1Selected = false;
-              }
-            }
-          }
-        }
-      }
-
-      // For Kaon candidate:
-      if (isTrk2hasTOF) {
-        trk2NSigmaKaTOF = trk2.tofNSigmaKa();
-        if (lengthOfkaonTOFPIDpTintv > 0) {
-          if (trk2ptKa > vKaonTOFPIDpTintv[lengthOfkaonTOFPIDpTintv - 1]) {
-            isTrk2Selected = false;
-          } else {
-            for (int i = 0; i < lengthOfkaonTOFPIDpTintv; i++) {
-              if (trk2ptKa < vKaonTOFPIDpTintv[i]) {
-                if (std::abs(trk2NSigmaKaTOF) > vKaonTOFPIDcuts[i])
-                  isTrk2Selected = false;
-                if (std::abs(trk2NSigmaKaTPC) > cMaxTPCnSigmaKaonVETO)
-                  isTrk2Selected = false;
-              }
-            }
-          }
-        }
-      } else {
-        if (lengthOfkaonTPCPIDpTintv > 0) {
-          if (trk2ptKa > vKaonTPCPIDpTintv[lengthOfkaonTPCPIDpTintv - 1]) {
-            isTrk2Selected = false;
-          } else {
-            for (int i = 0; i < lengthOfkaonTPCPIDpTintv; i++) {
-              if (trk2ptKa > vKaonTPCPIDpTintv[i] && trk2ptKa < vKaonTPCPIDpTintv[i + 1]) {
-                if (std::abs(trk2NSigmaKaTPC) > vKaonTPCPIDcuts[i])
-                  isTrk2Selected = false;
-              }
-            }
-          }
-        }
-      }
+      bool isTrk1Selected = selectionPIDProtonPtDependent(trk1, isTrk1hasTOF);
+      bool isTrk2Selected = selectionPIDKaonPtDependent(trk2, isTrk2hasTOF);
 
       //// QA plots before the selection
       //  --- Track QA all
@@ -575,8 +596,27 @@ struct lambda1520analysis {
     BinningTypeVtxZT0M colBinning{{CfgVtxBins, CfgMultBins}, true};
     SameKindPair<aod::ResoCollisions, aod::ResoTracks, BinningTypeVtxZT0M> pairs{colBinning, nEvtMixing, -1, collisions, tracksTuple, &cache}; // -1 is the number of the bin to skip
 
+    // the daughter selections do not depend on the paired collision, they are evaluated once per track
+    mixingProtons.fill(resotracks, collisions.size(), [this](const auto& track) { return trackCut(track) && (IsOldPIDcut ? selectionPIDProtonPtDependent(track, track.hasTOF()) : selectionPIDProton(track, track.hasTOF())); });
+    mixingKaons.fill(resotracks, collisions.size(), [this](const auto& track) { return trackCut(track) && (IsOldPIDcut ? selectionPIDKaonPtDependent(track, track.hasTOF()) : selectionPIDKaon(track, track.hasTOF())); });
+
     for (auto& [collision1, tracks1, collision2, tracks2] : pairs) {
-      fillHistograms<false, true>(collision1, tracks1, tracks2);
+      auto multiplicity = collision1.cent();
+      forEachResoMixingPair(mixingProtons.get(collision1.globalIndex()), massPr, mixingKaons.get(collision2.globalIndex()), massKa, [&](const auto& proton, const auto& kaon, const ResoMixingPair& resonance) {
+        // Rapidity cut and un-like sign pairs only
+        if (std::abs(resonance.rapidity) > 0.5 || proton.sign * kaon.sign > 0) {
+          return;
+        }
+        histos.fill(HIST("Result/Data/lambda1520invmassME"), resonance.mass);
+        histos.fill(HIST("Result/Data/h3lambda1520invmassME"), multiplicity, resonance.pt, resonance.mass);
+        if (isEtaAssym && proton.eta > 0.2 && proton.eta < 0.8 && kaon.eta > 0.2 && kaon.eta < 0.8) { // Eta-range will be updated
+          histos.fill(HIST("Result/Data/hlambda1520invmassMixedAside"), resonance.mass);
+          histos.fill(HIST("Result/Data/h3lambda1520invmassMixedAside"), multiplicity, resonance.pt, resonance.mass);
+        } else if (isEtaAssym && proton.eta > -0.6 && proton.eta < 0.0 && kaon.eta > -0.6 && kaon.eta < 0.0) { // Eta-range will be updated
+          histos.fill(HIST("Result/Data/hlambda1520invmassMixedCside"), resonance.mass);
+          histos.fill(HIST("Result/Data/h3lambda1520invmassMixedCside"), multiplicity, resonance.pt, resonance.mass);
+        }
+      });
     }
   };
   PROCESS_SWITCH(lambda1520analysis, processME, "Process EventMixing light without partition", false);
@@ -26,12 +26,14 @@
 #include "PWGLF/DataModel/LFResonanceTables.h"
 #include "DataFormatsParameters/GRPObject.h"
 #include "CommonConstants/PhysicsConstants.h"
+#include "PWGLF/Utils/resonanceEventMixing.h"
 
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::soa;
 using namespace o2::constants::physics;
+using namespace o2::analysis;
 
 struct phianalysis {
   SliceCache cache;
@@ -124,6 +126,8 @@ struct phianalysis {
   }
 
   double massKa = MassKaonCharged;
+  // Daughter candidates of the event mixing
+  ResoMixingDaughters mixingKaons;
 
   template <typename TrackType>
   bool trackCut(const TrackType track)
@@ -312,8 +316,24 @@ struct phianalysis {
     BinningTypeVtxZT0M colBinning{{CfgVtxBins, CfgMultBins}, true};
     SameKindPair<aod::ResoCollisions, aod::ResoTracks, BinningTypeVtxZT0M> pairs{colBinning, nEvtMixing, -1, collisions, tracksTuple, &cache}; // -1 is the number of the bin to skip
 
+    // the daughter selections do not depend on the paired collision, they are evaluated once per track
+    mixingKaons.fill(resotracks, collisions.size(), [this](const auto& track) { return trackCut(track) && (!cUseOnlyTOFTrackKa || track.hasTOF()) && selectionPIDKaon(track); });
+
     for (auto& [collision1, tracks1, collision2, tracks2] : pairs) {
-      fillHistograms<false, true>(collision1, tracks1, tracks2);
+      auto multiplicity = collision1.cent();
+      forEachResoMixingPair(mixingKaons.get(collision1.globalIndex()), massKa, mixingKaons.get(collision2.globalIndex()), massKa, [&](const auto& kaon1, const auto& kaon2, const ResoMixingPair& resonance) {
+        // Rapidity cut
+        if (std::abs(resonance.rapidity) > 0.5) {
+          return;
+        }
+        if (kaon1.sign * kaon2.sign < 0) {
+          histos.fill(HIST("phiinvmassME"), resonance.mass);
+          histos.fill(HIST("h3phiinvmassME"), multiplicity, resonance.pt, resonance.mass);
+        } else if (kaon1.sign > 0) {
+          histos.fill(HIST("phiinvmassLS"), resonance.mass);
+          histos.fill(HIST("h3phiinvmassLS"), multiplicity, resonance.pt, resonance.mass);
+        }
+      });
     }
   };
   PROCESS_SWITCH(phianalysis, processMELight, "Process EventMixing light without partition", false);
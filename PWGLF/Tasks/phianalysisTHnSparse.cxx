@@ -15,6 +15,7 @@
 #include "Framework/AnalysisTask.h"
 #include "Framework/runDataProcessing.h"
 
+#include "Common/Core/SparseHistogramBuffer.h"
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/Multiplicity.h"
 #include "Common/DataModel/PIDResponse.h"
@@ -45,6 +46,7 @@ struct phianalysisTHnSparse {
   Configurable<int> dauther2{"dauther2", 3, "Particle type of the second dauther according to ReconstructionDataFormats/PID.h (Default = Kaon)"};
   Configurable<float> zVertex{"zvertex", 10.0f, "Z vertex range."};
   Configurable<float> rapidityCut{"rapidity-max", 0.5, "Rapidity cut."};
+  Configurable<int> fillBufferSize{"fill-buffer-size", 1 << 16, "Number of bins of a THnSparse buffered before filling it."};
 
   ConfigurableAxis invaxis{"invAxis", {130, 0.97, 1.1}, "Invariant mass axis binning."};
   ConfigurableAxis ptaxis{"ptAxis", {20, 0., 20.}, "Pt axis binning."};
@@ -89,6 +91,9 @@ struct phianalysisTHnSparse {
 
   TLorentzVector d1, d2, mother;
 
+  // the pair fills are summed by bin and added to the THnSparse at the end of each process call
+  o2::analysis::SparseHistogramBuffer unlikepm, likepp, likemm, unlikepmTrue, unlikepmGen;
+
   void init(o2::framework::InitContext&)
   {
     AxisSpec invAxis = {invaxis, "Inv. mass (GeV/c^{2})", "im"};
@@ -102,9 +107,14 @@ struct phianalysisTHnSparse {
     registry.add("unlikepm", "Unlike PM", pairHisto);
     registry.add("likepp", "Like PP", pairHisto);
     registry.add("likemm", "Like MM", pairHisto);
+    unlikepm.init(registry.get<THnSparse>(HIST("unlikepm")), fillBufferSize);
+    likepp.init(registry.get<THnSparse>(HIST("likepp")), fillBufferSize);
+    likemm.init(registry.get<THnSparse>(HIST("likemm")), fillBufferSize);
     if (produceTrue) {
       registry.add("unlikepmTrue", "Unlike True PM", pairHisto);
       registry.add("unlikepmGen", "Unlike Gen PM", pairHisto);
+      unlikepmTrue.init(registry.get<THnSparse>(HIST("unlikepmTrue")), fillBufferSize);
+      unlikepmGen.init(registry.get<THnSparse>(HIST("unlikepmGen")), fillBufferSize);
     }
   }
 
@@ -165,7 +175,7 @@ struct phianalysisTHnSparse {
       if (verboselevel > 1)
         LOGF(info, "Unlike-sign: d1=%ld , d2=%ld , mother=%f", track1.globalIndex(), track2.globalIndex(), mother.Mag());
 
-      registry.fill(HIST("unlikepm"), mother.Mag(), mother.Pt(), multiplicity, std::abs(track1.tpcNSigmaKa()), std::abs(track2.tpcNSigmaKa()), mother.Rapidity());
+      unlikepm.fill(mother.Mag(), mother.Pt(), multiplicity, std::abs(track1.tpcNSigmaKa()), std::abs(track2.tpcNSigmaKa()), mother.Rapidity());
     }
 
     for (auto& [track1, track2] : combinations(o2::soa::CombinationsStrictlyUpperIndexPolicy(posDauthers, posDauthers))) {
@@ -181,7 +191,7 @@ struct phianalysisTHnSparse {
       if (verboselevel > 1)
         LOGF(info, "Like-sign positive: d1=%ld , d2=%ld , mother=%f", track1.globalIndex(), track2.globalIndex(), mother.Mag());
 
-      registry.fill(HIST("likepp"), mother.Mag(), mother.Pt(), multiplicity, std::abs(track1.tpcNSigmaKa()), std::abs(track2.tpcNSigmaKa()), mother.Rapidity());
+      likepp.fill(mother.Mag(), mother.Pt(), multiplicity, std::abs(track1.tpcNSigmaKa()), std::abs(track2.tpcNSigmaKa()), mother.Rapidity());
     }
 
     for (auto& [track1, track2] : combinations(o2::soa::CombinationsStrictlyUpperIndexPolicy(negDauthers, negDauthers))) {
@@ -197,8 +207,12 @@ struct phianalysisTHnSparse {
       if (verboselevel > 1)
         LOGF(info, "Like-sign negative: d1=%ld , d2=%ld , mother=%f", track1.globalIndex(), track2.globalIndex(), mother.Mag());
 
-      registry.fill(HIST("likemm"), mother.Mag(), mother.Pt(), multiplicity, std::abs(track1.tpcNSigmaKa()), std::abs(track2.tpcNSigmaKa()), mother.Rapidity());
+      likemm.fill(mother.Mag(), mother.Pt(), multiplicity, std::abs(track1.tpcNSigmaKa()), std::abs(track2.tpcNSigmaKa()), mother.Rapidity());
     }
+
+    unlikepm.flush();
+    likepp.flush();
+    likemm.flush();
   }
 
   PROCESS_SWITCH(phianalysisTHnSparse, processData, "Process Event for Data", true);
@@ -270,10 +284,11 @@ struct phianalysisTHnSparse {
 
           if (!selectedPair(mother, mctrack1, mctrack2))
             continue;
-          registry.fill(HIST("unlikepmTrue"), mother.Mag(), mother.Pt(), multiplicityMC, std::abs(track1.tpcNSigmaKa()), std::abs(track2.tpcNSigmaKa()), mother.Rapidity());
+          unlikepmTrue.fill(mother.Mag(), mother.Pt(), multiplicityMC, std::abs(track1.tpcNSigmaKa()), std::abs(track2.tpcNSigmaKa()), mother.Rapidity());
         }
       }
     }
+    unlikepmTrue.flush();
   }
 
   PROCESS_SWITCH(phianalysisTHnSparse, processTrue, "Process Event for MC reconstruction.", false);
@@ -319,7 +334,7 @@ struct phianalysisTHnSparse {
 
         mother = d1 + d2;
 
-        registry.fill(HIST("unlikepmGen"), mother.Mag(), mother.Pt(), multiplicityMC, tpcnSigma1 / 2.0, tpcnSigma2 / 2.0, mother.Rapidity());
+        unlikepmGen.fill(mother.Mag(), mother.Pt(), multiplicityMC, tpcnSigma1 / 2.0, tpcnSigma2 / 2.0, mother.Rapidity());
 
         nuberofPhi++;
         numberofEntries++;
@@ -328,6 +343,7 @@ struct phianalysisTHnSparse {
           LOGF(info, "Gen:  %d, #Phi =%d, mother=%d (%ld), Inv.mass:%f, Pt= %f", numberofEntries, nuberofPhi, particle.pdgCode(), particle.globalIndex(), mother.Mag(), mother.Pt());
       }
     }
+    unlikepmGen.flush();
   }
 
   PROCESS_SWITCH(phianalysisTHnSparse, processGen, "Process generated.", false);
@@ -0,0 +1,80 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file eventShape.h
+/// \brief Event shape observables of the LF table producers
+///
+/// The transverse spherocity is S0 = (pi/2)^2 * min_n (sum_i |pT,i x n| / sum_i pT,i)^2. Between two
+/// track directions the sum is a positive sinusoid of the angle of n, so its minimum is reached for n
+/// along one of the tracks. The tracks are sorted by direction and the sum is updated while sweeping
+/// over them, which gives the exact minimum in O(N log N).
+
+#ifndef PWGLF_UTILS_EVENTSHAPE_H_
+#define PWGLF_UTILS_EVENTSHAPE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace o2::analysis
+{
+
+/// \return the transverse spherocity of the tracks
+/// \param tracks are the tracks of the event
+/// \param useUnitWeights uses |pT| = 1 for all the tracks instead of their pT
+template <typename TTracks>
+float getTransverseSpherocity(TTracks const& tracks, bool useUnitWeights)
+{
+  // track direction in [0, pi), as the sum only depends on the direction modulo pi
+  struct Direction {
+    double angle;
+    double cosAngle;
+    double sinAngle;
+    double weight;
+  };
+  std::vector<Direction> directions;
+  directions.reserve(tracks.size());
+  double weightSum = 0.;
+  for (auto const& track : tracks) {
+    const double weight = useUnitWeights ? 1. : track.pt();
+    double angle = std::fmod(static_cast<double>(track.phi()), M_PI);
+    if (angle < 0.) {
+      angle += M_PI;
+    }
+    directions.push_back({angle, std::cos(angle), std::sin(angle), weight});
+    weightSum += weight;
+  }
+  if (directions.empty() || weightSum <= 0.) {
+    return M_PI * M_PI / 4.;
+  }
+  std::sort(directions.begin(), directions.end(), [](const Direction& a, const Direction& b) { return a.angle < b.angle; });
+
+  // with n along the first direction, all the tracks are at an angle in [0, pi) from n
+  double sumCos = 0., sumSin = 0.;
+  for (const auto& direction : directions) {
+    sumCos += direction.weight * direction.cosAngle;
+    sumSin += direction.weight * direction.sinAngle;
+  }
+  double minSum = weightSum;
+  for (const auto& direction : directions) {
+    // sum_i w_i * sin(angle_i - angle_n), with all the angle differences in [0, pi)
+    minSum = std::min(minSum, std::max(0., direction.cosAngle * sumSin - direction.sinAngle * sumCos));
+    // beyond this direction, the track is at a negative angle from n: it is reversed to keep the angle in [0, pi)
+    sumCos -= 2. * direction.weight * direction.cosAngle;
+    sumSin -= 2. * direction.weight * direction.sinAngle;
+  }
+  const double ratio = minSum / weightSum;
+  return M_PI * M_PI / 4. * ratio * ratio;
+}
+
+} // namespace o2::analysis
+
+#endif // PWGLF_UTILS_EVENTSHAPE_H_
@@ -0,0 +1,80 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file mcMothers.h
+/// \brief Mother matching of the MC particles of the LF label builders
+///
+/// The mothers of a particle are already stored as an array of indices in McParticles. The daughters
+/// are matched on these indices, without building the iterators of all their mothers, and only the
+/// common mother, when found, is then accessed in the table.
+
+#ifndef PWGLF_UTILS_MCMOTHERS_H_
+#define PWGLF_UTILS_MCMOTHERS_H_
+
+namespace o2::analysis
+{
+
+/// \return whether the particle has the mother
+/// \param particle is the MC particle
+/// \param motherId is the index of the mother in McParticles
+template <typename TParticle>
+bool hasMotherId(TParticle const& particle, int motherId)
+{
+  for (const auto& particleMotherId : particle.mothersIds()) {
+    if (particleMotherId == motherId) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// \return the index of the last common mother of two particles in McParticles, -1 if there is none
+template <typename TParticle1, typename TParticle2>
+int getCommonMotherId(TParticle1 const& particle1, TParticle2 const& particle2)
+{
+  int commonMotherId = -1;
+  for (const auto& motherId : particle1.mothersIds()) {
+    if (motherId >= 0 && hasMotherId(particle2, motherId)) {
+      commonMotherId = motherId;
+    }
+  }
+  return commonMotherId;
+}
+
+/// \return the index of the last common mother of three particles in McParticles, -1 if there is none
+template <typename TParticle1, typename TParticle2, typename TParticle3>
+int getCommonMotherId(TParticle1 const& particle1, TParticle2 const& particle2, TParticle3 const& particle3)
+{
+  int commonMotherId = -1;
+  for (const auto& motherId : particle1.mothersIds()) {
+    if (motherId >= 0 && hasMotherId(particle2, motherId) && hasMotherId(particle3, motherId)) {
+      commonMotherId = motherId;
+    }
+  }
+  return commonMotherId;
+}
+
+/// \return the index of the last mother of a particle in McParticles, -1 if it has none
+template <typename TParticle>
+int getLastMotherId(TParticle const& particle)
+{
+  int lastMotherId = -1;
+  for (const auto& motherId : particle.mothersIds()) {
+    if (motherId >= 0) {
+      lastMotherId = motherId;
+    }
+  }
+  return lastMotherId;
+}
+
+} // namespace o2::analysis
+
+#endif // PWGLF_UTILS_MCMOTHERS_H_
@@ -0,0 +1,121 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file resonanceEventMixing.h
+/// \brief Daughter candidates and pairing of the event mixing of the resonance tasks
+///
+/// In the event mixing each collision is paired with several others of the same bin, so the daughter
+/// selections are evaluated once per data frame and the selected daughters are kept, reduced to their
+/// momentum and sign, grouped by collision. The mixed pairs are then built from these groups.
+
+#ifndef PWGLF_UTILS_RESONANCEEVENTMIXING_H_
+#define PWGLF_UTILS_RESONANCEEVENTMIXING_H_
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace o2::analysis
+{
+
+/// \brief Daughter candidate of the event mixing, reduced to its momentum and sign
+struct ResoMixingDaughter {
+  float px;
+  float py;
+  float pz;
+  float eta;
+  int8_t sign;
+};
+
+/// \brief Kinematics of a pair of daughter candidates
+struct ResoMixingPair {
+  double mass;
+  double pt;
+  double rapidity;
+};
+
+/// \brief Daughter candidates of the event mixing, selected once per data frame and grouped by collision
+class ResoMixingDaughters
+{
+ public:
+  /// Selects the daughter candidates and groups them by collision
+  /// \param tracks are the resonance daughter tracks of the data frame
+  /// \param nCollisions is the number of resonance collisions of the data frame
+  /// \param isSelected is the selection of the daughter candidates
+  template <typename TTracks, typename TSelection>
+  void fill(TTracks const& tracks, int nCollisions, TSelection const& isSelected)
+  {
+    // the vectors of the previous data frame are cleared, not released, to reuse their memory
+    if (static_cast<int>(mDaughters.size()) < nCollisions) {
+      mDaughters.resize(nCollisions);
+    }
+    for (auto& daughters : mDaughters) {
+      daughters.clear();
+    }
+    for (auto const& track : tracks) {
+      if (!isSelected(track)) {
+        continue;
+      }
+      mDaughters[track.resoCollisionId()].push_back({track.px(), track.py(), track.pz(), track.eta(), static_cast<int8_t>(track.sign())});
+    }
+  }
+
+  /// \return the daughter candidates of a collision
+  /// \param collisionIndex is the index of the resonance collision
+  const std::vector<ResoMixingDaughter>& get(int collisionIndex) const { return mDaughters[collisionIndex]; }
+
+ private:
+  std::vector<std::vector<ResoMixingDaughter>> mDaughters; // daughter candidates per collision
+};
+
+/// \return the energy of a daughter candidate in a mass hypothesis
+inline double getResoMixingEnergy(const ResoMixingDaughter& daughter, double mass)
+{
+  const double px = daughter.px, py = daughter.py, pz = daughter.pz;
+  return std::sqrt(px * px + py * py + pz * pz + mass * mass);
+}
+
+/// \brief Loops over the pairs of daughter candidates of two collisions
+/// \param daughters1 are the first daughter candidates
+/// \param mass1 is the mass hypothesis of the first daughter candidates
+/// \param daughters2 are the second daughter candidates
+/// \param mass2 is the mass hypothesis of the second daughter candidates
+/// \param function is called with the two daughters and the pair kinematics
+template <typename TFunction>
+void forEachResoMixingPair(const std::vector<ResoMixingDaughter>& daughters1, double mass1,
+                           const std::vector<ResoMixingDaughter>& daughters2, double mass2, TFunction&& function)
+{
+  std::vector<double> energies2;
+  energies2.reserve(daughters2.size());
+  for (const auto& daughter2 : daughters2) {
+    energies2.push_back(getResoMixingEnergy(daughter2, mass2));
+  }
+  for (const auto& daughter1 : daughters1) {
+    const double energy1 = getResoMixingEnergy(daughter1, mass1);
+    for (std::size_t iDaughter2 = 0; iDaughter2 < daughters2.size(); ++iDaughter2) {
+      const auto& daughter2 = daughters2[iDaughter2];
+      const double px = static_cast<double>(daughter1.px) + daughter2.px;
+      const double py = static_cast<double>(daughter1.py) + daughter2.py;
+      const double pz = static_cast<double>(daughter1.pz) + daughter2.pz;
+      const double energy = energy1 + energies2[iDaughter2];
+      const double massSquared = energy * energy - px * px - py * py - pz * pz;
+      // same conventions as TLorentzVector::M() and TLorentzVector::Rapidity()
+      const ResoMixingPair pair{massSquared < 0. ? -std::sqrt(-massSquared) : std::sqrt(massSquared),
+                                std::sqrt(px * px + py * py),
+                                0.5 * std::log((energy + pz) / (energy - pz))};
+      function(daughter1, daughter2, pair);
+    }
+  }
+}
+
+} // namespace o2::analysis
+
+#endif // PWGLF_UTILS_RESONANCEEVENTMIXING_H_
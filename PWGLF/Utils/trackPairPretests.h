@@ -0,0 +1,61 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file trackPairPretests.h
+/// \brief Transverse-plane pretests of the track pairs of the V0 and cascade finders
+///
+/// The DCAFitterN seeds are the crossings of the track circles (or of the circle and the line of a
+/// neutral track) in the transverse plane. When the circles do not cross, the fitter only keeps the
+/// pair if their distance in xy is below its maxDXYIni. The same distance is computed here from the
+/// circle parameters, obtained once per track, so that these pairs are rejected without calling the fitter.
+
+#ifndef PWGLF_UTILS_TRACKPAIRPRETESTS_H_
+#define PWGLF_UTILS_TRACKPAIRPRETESTS_H_
+
+#include <algorithm>
+#include <cmath>
+
+#include "ReconstructionDataFormats/Track.h"
+
+namespace o2::analysis
+{
+
+/// \brief Track parametrisation of a finder track with its circle in the transverse plane
+struct FinderTrack {
+  o2::track::TrackParCov trackParCov;
+  o2::math_utils::CircleXYf_t circle;
+
+  FinderTrack(o2::track::TrackParCov const& track, float bz) : trackParCov(track)
+  {
+    float sna, csa;
+    trackParCov.getCircleParams(bz, circle, sna, csa);
+  }
+};
+
+/// \return distance in xy of two circles, negative if they cross
+inline float getCirclesDistanceXY(o2::math_utils::CircleXYf_t const& circle1, o2::math_utils::CircleXYf_t const& circle2)
+{
+  float centerDistance = std::hypot(circle1.xC - circle2.xC, circle1.yC - circle2.yC);
+  return std::max(centerDistance - (circle1.rC + circle2.rC), std::abs(circle1.rC - circle2.rC) - centerDistance);
+}
+
+/// \return distance in xy of a straight line and a circle, negative if they cross
+/// \param x, y point of the line
+/// \param px, py direction of the line
+inline float getLineCircleDistanceXY(float x, float y, float px, float py, o2::math_utils::CircleXYf_t const& circle)
+{
+  float centerDistance = std::abs((circle.xC - x) * py - (circle.yC - y) * px) / std::hypot(px, py);
+  return centerDistance - circle.rC;
+}
+
+} // namespace o2::analysis
+
+#endif // PWGLF_UTILS_TRACKPAIRPRETESTS_H_
@@ -127,13 +127,9 @@ struct LumiFDDFT0 {
       {"vertexx", "", {HistType::kTH1F, {{1000, -1, 1, "x"}}}},                                         //
       {"vertexy", "", {HistType::kTH1F, {{1000, -1, 1, "y"}}}},                                         //
       {"timestamp", "", {HistType::kTH1F, {{20000, 0, 2e7, "t"}}}},                                     //
-      {"vertexx_timestamp", "", {HistType::kTH2F, {{10000, 130e9, 140e9, "t"}, {2000, -1, 1, "x"}}}},   //
-      {"vertexy_timestamp", "", {HistType::kTH2F, {{10000, 130e9, 140e9, "t"}, {2000, -1, 1, "y"}}}},   //
       {"chisquare", "", {HistType::kTH1F, {{1000, 0, 100, "#chi^{2}"}}}},                               //
       {"vertexx_Refitted", "", {HistType::kTH1F, {{1000, -1, 1, "x"}}}},                                //
       {"vertexy_Refitted", "", {HistType::kTH1F, {{1000, -1, 1, "y"}}}},                                //
-      {"vertexx_Refitted_timestamp", "", {HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "x"}}}}, //
-      {"vertexy_Refitted_timestamp", "", {HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "y"}}}}, //
       {"chisquare_Refitted", "", {HistType::kTH1F, {{1000, 0, 100, "#chi^{2}"}}}},                      //
       {"vertexx_Refitted_vertexx", "", {HistType::kTH2F, {{1000, -1, 1, "x"}, {1000, -1, 1, "rx"}}}},   //
       {"vertexy_Refitted_vertexy", "", {HistType::kTH2F, {{1000, -1, 1, "y"}, {1000, -1, 1, "ry"}}}}    //
@@ -148,12 +144,34 @@ struct LumiFDDFT0 {
 
   bool doPVrefit = true;
 
+  Configurable<bool> fillTimestampHistos{"fillTimestampHistos", false, "Fill the dense vertex position vs timestamp histograms"};
+  ConfigurableAxis timeSliceBinning{"timeSliceBinning", {1000, 0, 4e6}, "Time slices of the vertex moments (ms)"};
+
+  // sums of the vertex positions per BC and time slice
+  std::shared_ptr<THnSparse> hVertexMoments;
+  std::shared_ptr<THnSparse> hVertexMomentsRefitted;
+
   void init(InitContext&)
   {
     if (doprocessLite == true && doprocessFull == true) {
       LOG(fatal) << "Select one process function from  processLite and processFull";
     }
 
+    // only the filled (BC, time slice) pairs are stored, and the sums add up when merging the outputs
+    if (doprocessFull) {
+      const AxisSpec bcAxis{nBCsPerOrbit, -0.5, nBCsPerOrbit - 0.5, "BC"};
+      const AxisSpec timeSliceAxis{timeSliceBinning, "t"};
+      const AxisSpec momentAxis{5, -0.5, 4.5, "N, #Sigma x, #Sigma x^{2}, #Sigma y, #Sigma y^{2}"};
+      hVertexMoments = histos.add<THnSparse>("vertexMoments", "", HistType::kTHnSparseD, {bcAxis, timeSliceAxis, momentAxis});
+      hVertexMomentsRefitted = histos.add<THnSparse>("vertexMoments_Refitted", "", HistType::kTHnSparseD, {bcAxis, timeSliceAxis, momentAxis});
+      if (fillTimestampHistos) {
+        histos.add("vertexx_timestamp", "", HistType::kTH2F, {{10000, 130e9, 140e9, "t"}, {2000, -1, 1, "x"}});
+        histos.add("vertexy_timestamp", "", HistType::kTH2F, {{10000, 130e9, 140e9, "t"}, {2000, -1, 1, "y"}});
+        histos.add("vertexx_Refitted_timestamp", "", HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "x"}});
+        histos.add("vertexy_Refitted_timestamp", "", HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "y"}});
+      }
+    }
+
     ccdb->setURL(ccdburl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
@@ -162,6 +180,15 @@ struct LumiFDDFT0 {
     mRunNumber = 0;
   }
 
+  void fillVertexMoments(std::shared_ptr<THnSparse> const& hist, int localBC, double relTS, double x, double y)
+  {
+    const double moments[5]{1., x, x * x, y, y * y};
+    for (int iM = 0; iM < 5; iM++) {
+      const double coordinates[3]{static_cast<double>(localBC), relTS, static_cast<double>(iM)};
+      hist->Fill(coordinates, moments[iM]);
+    }
+  }
+
   void processFull(soa::Join<aod::Collisions, aod::EvSels>::iterator const& collision, aod::FDDs const& fdds, aod::FT0s const& ft0s, aod::BCsWithTimestamps const&,
                    o2::soa::Join<o2::aod::Tracks, o2::aod::TracksCov,
                                  o2::aod::TracksExtra> const& unfiltered_tracks)
@@ -169,6 +196,7 @@ struct LumiFDDFT0 {
     auto bc = collision.bc_as<aod::BCsWithTimestamps>();
     Long64_t relTS = bc.timestamp() - fttimestamp;
     Long64_t globalBC = bc.globalBC();
+    int localBC = globalBC % nBCsPerOrbit;
     std::vector<int64_t> vec_globID_contr = {};
     std::vector<o2::track::TrackParCov> vec_TrkContributos = {};
 
@@ -285,8 +313,11 @@ struct LumiFDDFT0 {
       histos.fill(HIST("vertexx_Refitted"), refitX);
       histos.fill(HIST("vertexy_Refitted"), refitY);
 
-      histos.fill(HIST("vertexx_Refitted_timestamp"), relTS, refitX);
-      histos.fill(HIST("vertexy_Refitted_timestamp"), relTS, refitY);
+      fillVertexMoments(hVertexMomentsRefitted, localBC, relTS, refitX, refitY);
+      if (fillTimestampHistos) {
+        histos.fill(HIST("vertexx_Refitted_timestamp"), relTS, refitX);
+        histos.fill(HIST("vertexy_Refitted_timestamp"), relTS, refitY);
+      }
     }
     histos.fill(HIST("chisquare"), collision.chi2());
     if (collision.chi2() / collision.numContrib() > 4)
@@ -298,8 +329,11 @@ struct LumiFDDFT0 {
     histos.fill(HIST("vertexy"), collision.posY());
     histos.fill(HIST("timestamp"), relTS);
 
-    histos.fill(HIST("vertexx_timestamp"), relTS, collision.posX());
-    histos.fill(HIST("vertexy_timestamp"), relTS, collision.posY());
+    fillVertexMoments(hVertexMoments, localBC, relTS, collision.posX(), collision.posY());
+    if (fillTimestampHistos) {
+      histos.fill(HIST("vertexx_timestamp"), relTS, collision.posX());
+      histos.fill(HIST("vertexy_timestamp"), relTS, collision.posY());
+    }
 
     if (nContrib > nContribMin && nContrib < nContribMax &&
         (chi2 / nContrib) < 4.0 && chi2 > 0) {
@@ -25,6 +25,7 @@
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 
+#include "CommonConstants/LHCConstants.h"
 #include "CommonUtils/NameConf.h"
 
 #include "Framework/ASoAHelpers.h"
@@ -98,25 +99,13 @@ struct lumiTask {
   HistogramRegistry histos{
     "histos",
     {
-      {"vertexx", "", {HistType::kTH1F, {{1000, -1, 1, "x"}}}},     //
-      {"vertexy", "", {HistType::kTH1F, {{1000, -1, 1, "y"}}}},     //
-      {"timestamp", "", {HistType::kTH1F, {{20000, 0, 2e7, "t"}}}}, //
-      {"vertexx_timestamp",
-       "",
-       {HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "x"}}}}, //
-      {"vertexy_timestamp",
-       "",
-       {HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "y"}}}},     //
+      {"vertexx", "", {HistType::kTH1F, {{1000, -1, 1, "x"}}}},           //
+      {"vertexy", "", {HistType::kTH1F, {{1000, -1, 1, "y"}}}},           //
+      {"timestamp", "", {HistType::kTH1F, {{20000, 0, 2e7, "t"}}}},       //
       {"chisquare", "", {HistType::kTH1F, {{1000, 0, 100, "#chi^{2}"}}}}, //
 
       {"vertexx_Refitted", "", {HistType::kTH1F, {{1000, -1, 1, "x"}}}}, //
       {"vertexy_Refitted", "", {HistType::kTH1F, {{1000, -1, 1, "y"}}}}, //
-      {"vertexx_Refitted_timestamp",
-       "",
-       {HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "x"}}}}, //
-      {"vertexy_Refitted_timestamp",
-       "",
-       {HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "y"}}}}, //
       {"chisquare_Refitted",
        "",
        {HistType::kTH1F, {{1000, 0, 100, "#chi^{2}"}}}}, //
@@ -130,8 +119,28 @@ struct lumiTask {
     }};
   bool doPVrefit = true;
 
+  Configurable<bool> fillTimestampHistos{"fillTimestampHistos", false, "Fill the dense vertex position vs timestamp histograms"};
+  ConfigurableAxis timeSliceBinning{"timeSliceBinning", {1000, 0, 4e6}, "Time slices of the vertex moments (ms)"};
+
+  // sums of the vertex positions per BC and time slice
+  std::shared_ptr<THnSparse> hVertexMoments;
+  std::shared_ptr<THnSparse> hVertexMomentsRefitted;
+
   void init(InitContext&)
   {
+    // only the filled (BC, time slice) pairs are stored, and the sums add up when merging the outputs
+    const AxisSpec bcAxis{o2::constants::lhc::LHCMaxBunches, -0.5, o2::constants::lhc::LHCMaxBunches - 0.5, "BC"};
+    const AxisSpec timeSliceAxis{timeSliceBinning, "t"};
+    const AxisSpec momentAxis{5, -0.5, 4.5, "N, #Sigma x, #Sigma x^{2}, #Sigma y, #Sigma y^{2}"};
+    hVertexMoments = histos.add<THnSparse>("vertexMoments", "", HistType::kTHnSparseD, {bcAxis, timeSliceAxis, momentAxis});
+    hVertexMomentsRefitted = histos.add<THnSparse>("vertexMoments_Refitted", "", HistType::kTHnSparseD, {bcAxis, timeSliceAxis, momentAxis});
+    if (fillTimestampHistos) {
+      histos.add("vertexx_timestamp", "", HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "x"}});
+      histos.add("vertexy_timestamp", "", HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "y"}});
+      histos.add("vertexx_Refitted_timestamp", "", HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "x"}});
+      histos.add("vertexy_Refitted_timestamp", "", HistType::kTH2F, {{1000, 0, 4e6, "t"}, {2000, -1, 1, "y"}});
+    }
+
     ccdb->setURL(ccdburl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
@@ -140,6 +149,15 @@ struct lumiTask {
     mRunNumber = 0;
   }
 
+  void fillVertexMoments(std::shared_ptr<THnSparse> const& hist, int localBC, double relTS, double x, double y)
+  {
+    const double moments[5]{1., x, x * x, y, y * y};
+    for (int iM = 0; iM < 5; iM++) {
+      const double coordinates[3]{static_cast<double>(localBC), relTS, static_cast<double>(iM)};
+      hist->Fill(coordinates, moments[iM]);
+    }
+  }
+
   void process(aod::Collision const& collision, aod::BCsWithTimestamps const&,
                o2::soa::Join<o2::aod::Tracks, o2::aod::TrackSelection,
                              o2::aod::TracksCov, o2::aod::TracksExtra,
@@ -150,6 +168,7 @@ struct lumiTask {
 
     auto bc = collision.bc_as<aod::BCsWithTimestamps>();
     uint64_t relTS = bc.timestamp() - ftts;
+    int localBC = bc.globalBC() % o2::constants::lhc::LHCMaxBunches;
 
     std::vector<int64_t> vec_globID_contr = {};
     std::vector<o2::track::TrackParCov> vec_TrkContributos = {};
@@ -231,8 +250,11 @@ struct lumiTask {
       histos.fill(HIST("vertexx_Refitted"), refitX);
       histos.fill(HIST("vertexy_Refitted"), refitY);
 
-      histos.fill(HIST("vertexx_Refitted_timestamp"), relTS, refitX);
-      histos.fill(HIST("vertexy_Refitted_timestamp"), relTS, refitY);
+      fillVertexMoments(hVertexMomentsRefitted, localBC, relTS, refitX, refitY);
+      if (fillTimestampHistos) {
+        histos.fill(HIST("vertexx_Refitted_timestamp"), relTS, refitX);
+        histos.fill(HIST("vertexy_Refitted_timestamp"), relTS, refitY);
+      }
     }
     histos.fill(HIST("chisquare"), collision.chi2());
     if (collision.chi2() / collision.numContrib() > 4)
@@ -245,8 +267,11 @@ struct lumiTask {
     histos.fill(HIST("vertexy"), collision.posY());
     histos.fill(HIST("timestamp"), relTS);
 
-    histos.fill(HIST("vertexx_timestamp"), relTS, collision.posX());
-    histos.fill(HIST("vertexy_timestamp"), relTS, collision.posY());
+    fillVertexMoments(hVertexMoments, localBC, relTS, collision.posX(), collision.posY());
+    if (fillTimestampHistos) {
+      histos.fill(HIST("vertexx_timestamp"), relTS, collision.posX());
+      histos.fill(HIST("vertexy_timestamp"), relTS, collision.posY());
+    }
 
     if (nContrib > nContribMin && nContrib < nContribMax &&
         (chi2 / nContrib) < 4.0 && chi2 > 0) {
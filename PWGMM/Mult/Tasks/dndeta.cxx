@@ -21,6 +21,9 @@
 #include <TDatabasePDG.h>
 #include <TPDGCode.h>
 
+#include <unordered_set>
+#include <vector>
+
 #include "Index.h"
 #include "bestCollisionTable.h"
 
@@ -78,10 +81,11 @@ struct MultiplicityCounter {
     false,
     true};
 
-  std::vector<int> usedTracksIds;
-  std::vector<int> usedTracksIdsDF;
-  std::vector<int> usedTracksIdsDFMC;
-  std::vector<int> usedTracksIdsDFMCEff;
+  std::unordered_set<int> usedTracksIds;
+  std::unordered_set<int> usedTracksIdsDF;
+  std::unordered_set<int> usedTracksIdsDFMC;
+  std::unordered_set<int> usedTracksIdsDFMCEff;
+  std::vector<float> countedTracksEtas; // eta of the tracks seen while counting, for the INEL>0 histograms
 
   void init(InitContext&)
   {
@@ -265,30 +269,36 @@ struct MultiplicityCounter {
   template <typename C>
   void processEventStatGeneral(FullBCs const& bcs, C const& collisions)
   {
-    std::vector<typename std::decay_t<decltype(collisions)>::iterator> cols;
+    // collisions of each BC (the found BC if any), grouped once instead of scanning the collisions for each BC
+    std::vector<int> colsFirst(bcs.size() + 1, 0);
+    for (auto& collision : collisions) {
+      ++colsFirst[(collision.has_foundBC() ? collision.foundBCId() : collision.bcId()) + 1];
+    }
+    for (auto i = 0u; i < bcs.size(); ++i) {
+      colsFirst[i + 1] += colsFirst[i];
+    }
+    std::vector<int> colsIds(collisions.size());
+    {
+      std::vector<int> colsNext(colsFirst.begin(), colsFirst.end() - 1);
+      for (auto& collision : collisions) {
+        colsIds[colsNext[collision.has_foundBC() ? collision.foundBCId() : collision.bcId()]++] = collision.globalIndex();
+      }
+    }
     for (auto& bc : bcs) {
       if (!useEvSel || (bc.selection_bit(aod::evsel::kNoITSROFrameBorder) &&
                         bc.selection_bit(aod::evsel::kIsBBT0A) &&
                         bc.selection_bit(aod::evsel::kIsBBT0C)) != 0) {
         commonRegistry.fill(HIST(BCSelection), 1.);
-        cols.clear();
-        for (auto& collision : collisions) {
-          if (collision.has_foundBC()) {
-            if (collision.foundBCId() == bc.globalIndex()) {
-              cols.emplace_back(collision);
-            }
-          } else if (collision.bcId() == bc.globalIndex()) {
-            cols.emplace_back(collision);
-          }
-        }
-        LOGP(debug, "BC {} has {} collisions", bc.globalBC(), cols.size());
-        if (!cols.empty()) {
+        auto nCols = colsFirst[bc.globalIndex() + 1] - colsFirst[bc.globalIndex()];
+        LOGP(debug, "BC {} has {} collisions", bc.globalBC(), nCols);
+        if (nCols > 0) {
           commonRegistry.fill(HIST(BCSelection), 2.);
-          if (cols.size() > 1) {
+          if (nCols > 1) {
             commonRegistry.fill(HIST(BCSelection), 3.);
           }
         }
-        for (auto& col : cols) {
+        for (auto iCol = colsFirst[bc.globalIndex()]; iCol < colsFirst[bc.globalIndex() + 1]; ++iCol) {
+          auto col = collisions.iteratorAt(colsIds[iCol]);
           if constexpr (hasRecoCent<C>()) {
             float c = -1;
             if constexpr (C::template contains<aod::CentFT0Cs>()) {
@@ -367,11 +377,13 @@ struct MultiplicityCounter {
   int countTracks(T const& tracks, float z, float c)
   {
     auto Ntrks = 0;
+    countedTracksEtas.clear();
     for (auto& track : tracks) {
       if (std::abs(track.eta()) < estimatorEta) {
         ++Ntrks;
       }
       if constexpr (fillHistos) {
+        countedTracksEtas.push_back(track.eta());
         if constexpr (hasRecoCent<C>()) {
           binnedRegistry.fill(HIST(EtaZvtx), track.eta(), z, c);
           binnedRegistry.fill(HIST(PhiEta), track.phi(), track.eta(), c);
@@ -430,12 +442,12 @@ struct MultiplicityCounter {
           if (Ntrks > 0) {
             inclusiveRegistry.fill(HIST(EventSelection), static_cast<float>(EvSelBins::kSelectedgt0));
           }
-          for (auto& track : tracks) {
+          for (auto eta : countedTracksEtas) {
             if (Ntrks > 0) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_gt0), track.eta(), z);
+              inclusiveRegistry.fill(HIST(EtaZvtx_gt0), eta, z);
             }
             if (INELgt0PV) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_PVgt0), track.eta(), z);
+              inclusiveRegistry.fill(HIST(EtaZvtx_PVgt0), eta, z);
             }
           }
         }
@@ -454,8 +466,12 @@ struct MultiplicityCounter {
   int countTracksAmbiguous(T const& tracks, AT const& atracks, float z, float c)
   {
     auto Ntrks = 0;
+    countedTracksEtas.clear();
     for (auto& track : atracks) {
       auto otrack = track.template track_as<T>();
+      if constexpr (fillHistos) {
+        countedTracksEtas.push_back(otrack.eta());
+      }
       // same filtering for ambiguous as for general
       if (!otrack.hasITS()) {
         continue;
@@ -468,7 +484,7 @@ struct MultiplicityCounter {
           continue;
         }
       }
-      usedTracksIds.emplace_back(track.trackId());
+      usedTracksIds.insert(track.trackId());
       if (std::abs(otrack.eta()) < estimatorEta) {
         ++Ntrks;
       }
@@ -488,7 +504,7 @@ struct MultiplicityCounter {
         }
       }
       if (otrack.collisionId() != track.bestCollisionId()) {
-        usedTracksIdsDF.emplace_back(track.trackId());
+        usedTracksIdsDF.insert(track.trackId());
         if constexpr (fillHistos) {
           if constexpr (hasRecoCent<C>()) {
             binnedRegistry.fill(HIST(ReassignedEtaZvtx), otrack.eta(), z, c);
@@ -522,16 +538,17 @@ struct MultiplicityCounter {
     }
 
     for (auto& track : tracks) {
-      if (std::find(usedTracksIds.begin(), usedTracksIds.end(), track.globalIndex()) != usedTracksIds.end()) {
+      if (usedTracksIds.count(track.globalIndex()) != 0) {
         continue;
       }
-      if (std::find(usedTracksIdsDF.begin(), usedTracksIdsDF.end(), track.globalIndex()) != usedTracksIdsDF.end()) {
+      if (usedTracksIdsDF.count(track.globalIndex()) != 0) {
         continue;
       }
       if (std::abs(track.eta()) < estimatorEta) {
         ++Ntrks;
       }
       if constexpr (fillHistos) {
+        countedTracksEtas.push_back(track.eta());
         if constexpr (hasRecoCent<C>()) {
           binnedRegistry.fill(HIST(EtaZvtx), track.eta(), z, c);
           binnedRegistry.fill(HIST(PhiEta), track.phi(), track.eta(), c);
@@ -591,26 +608,13 @@ struct MultiplicityCounter {
           if (Ntrks > 0) {
             inclusiveRegistry.fill(HIST(EventSelection), static_cast<float>(EvSelBins::kSelectedgt0));
           }
-          for (auto& track : atracks) {
-            if (Ntrks > 0) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_gt0), track.track_as<FiTracks>().eta(), z);
-            }
-            if (INELgt0PV) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_PVgt0), track.track_as<FiTracks>().eta(), z);
-            }
-          }
-          for (auto& track : tracks) {
-            if (std::find(usedTracksIds.begin(), usedTracksIds.end(), track.globalIndex()) != usedTracksIds.end()) {
-              continue;
-            }
-            if (std::find(usedTracksIdsDF.begin(), usedTracksIdsDF.end(), track.globalIndex()) != usedTracksIdsDF.end()) {
-              continue;
-            }
+          // same tracks as counted, without walking over the tracks and the ambiguous tracks again
+          for (auto eta : countedTracksEtas) {
             if (Ntrks > 0) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_gt0), track.eta(), z);
+              inclusiveRegistry.fill(HIST(EtaZvtx_gt0), eta, z);
             }
             if (INELgt0PV) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_PVgt0), track.eta(), z);
+              inclusiveRegistry.fill(HIST(EtaZvtx_PVgt0), eta, z);
             }
           }
         }
@@ -837,9 +841,9 @@ struct MultiplicityCounter {
     usedTracksIds.clear();
     for (auto const& track : atracks) {
       auto otrack = track.template track_as<FiLTracks>();
-      usedTracksIds.emplace_back(track.trackId());
+      usedTracksIds.insert(track.trackId());
       if (otrack.collisionId() != track.bestCollisionId()) {
-        usedTracksIdsDFMCEff.emplace_back(track.trackId());
+        usedTracksIdsDFMCEff.insert(track.trackId());
       }
       if (otrack.has_mcParticle()) {
         auto particle = otrack.mcParticle_as<Particles>();
@@ -861,10 +865,10 @@ struct MultiplicityCounter {
       }
     }
     for (auto const& track : tracks) {
-      if (std::find(usedTracksIds.begin(), usedTracksIds.end(), track.globalIndex()) != usedTracksIds.end()) {
+      if (usedTracksIds.count(track.globalIndex()) != 0) {
         continue;
       }
-      if (std::find(usedTracksIdsDFMCEff.begin(), usedTracksIdsDFMCEff.end(), track.globalIndex()) != usedTracksIdsDFMCEff.end()) {
+      if (usedTracksIdsDFMCEff.count(track.globalIndex()) != 0) {
         continue;
       }
       if (track.has_mcParticle()) {
@@ -348,87 +348,3 @@ int DGPIDSelector::pid2ind(int pid)
 };
 
 // -----------------------------------------------------------------------------
-// find selections of np out of n0
-void DGPIDSelector::combinations(int n0, std::vector<int>& pool, int np, std::vector<int>& inds, int n,
-                                 std::vector<std::vector<int>>& combs)
-{
-  // loop over pool
-  for (auto ii = 0; ii < n0 - n; ii++) {
-
-    inds[n] = pool[ii];
-
-    // if all inds are defined then print them out
-    // else get next inds
-    if (np == 1) {
-
-      std::vector<int> comb(n + 1, 0);
-      for (uint ii = 0; ii < inds.size(); ii++) {
-        comb[ii] = inds[ii];
-      }
-      combs.push_back(comb);
-
-    } else {
-
-      auto n0new = n0 - ii;
-      std::vector<int> newpool(n0new, 0);
-      for (auto kk = 0; kk < n0new; kk++) {
-        newpool[kk] = pool[kk + ii + 1];
-      }
-
-      auto npnew = np - 1;
-      auto nnew = n + 1;
-      combinations(n0new, newpool, npnew, inds, nnew, combs);
-    }
-  }
-}
-
-// -----------------------------------------------------------------------------
-// find all possible selections of np out of n0
-int DGPIDSelector::combinations(int n0, int np, std::vector<std::vector<int>>& combs)
-{
-  // initialisations
-  combs.clear();
-  if (n0 < np) {
-    return 0;
-  }
-
-  std::vector<int> pool(n0, 0);
-  for (auto ii = 0; ii < n0; ii++) {
-    pool[ii] = ii;
-  }
-  std::vector<int> inds(np, 0);
-
-  // iterate recursively
-  combinations(n0, pool, np, inds, 0, combs);
-
-  return combs.size();
-}
-
-// -----------------------------------------------------------------------------
-std::vector<std::vector<int>> DGPIDSelector::combinations(int nPool)
-{
-  // get the unique permutations
-  auto uniquePerms = mAnaPars.uniquePermutations();
-  auto numUniquePerms = uniquePerms.size() / mAnaPars.nCombine();
-
-  // all selections of nCombine elements from nPool elements
-  std::vector<std::vector<int>> combs;
-  combinations(nPool, mAnaPars.nCombine(), combs);
-
-  // permute the combinations
-  std::vector<std::vector<int>> copes;
-  for (auto comb : combs) {
-    for (auto ii = 0u; ii < numUniquePerms; ii++) {
-      std::vector<int> cope(mAnaPars.nCombine(), 0);
-      for (auto jj = 0; jj < mAnaPars.nCombine(); jj++) {
-        auto ind = ii * mAnaPars.nCombine() + jj;
-        cope[uniquePerms[ind]] = comb[jj];
-      }
-      copes.push_back(cope);
-    }
-  }
-
-  return copes;
-}
-
-// -----------------------------------------------------------------------------
@@ -13,6 +13,9 @@
 #define PWGUD_CORE_DGPIDSELECTOR_H_
 
 #include <gandiva/projector.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <string>
 #include <vector>
 #include <TVector3.h>
@@ -407,35 +410,45 @@ struct DGPIDSelector {
     mUnlikeIVMs.clear();
     mLikeIVMs.clear();
 
-    // create combinations including permutations
-    auto combs = combinations(tracks.size());
-
-    // loop over unique combinations
-    for (auto comb : combs) {
-      // are tracks compatible with PID requirements?
-      bool isGoodTracks = true;
-      auto cnt = -1;
-      for (auto ind : comb) {
-        cnt++;
-        if (!isGoodTrack(tracks.begin() + ind, cnt)) {
-          isGoodTracks = false;
-          break;
-        }
-      }
+    auto nCombine = mAnaPars.nCombine();
+    int nTracks = tracks.size();
+    if (nCombine <= 0 || nTracks < nCombine) {
+      return std::vector<int>{0, 0};
+    }
 
-      // is combination compatible with netCharge requirements?
-      if (isGoodTracks) {
-        DGParticle IVM(fPDG, mAnaPars, tracks, comb);
-        // unlike sign
-        if (isGoodCombination(comb, tracks, mAnaPars.unlikeCharges())) {
-          mUnlikeIVMs.push_back(IVM);
-        }
-        if (isGoodCombination(comb, tracks, mAnaPars.likeCharges())) {
-          mLikeIVMs.push_back(IVM);
+    // which PID hypotheses is each track compatible with?
+    // bit cnt of mGoodMasks[ind] is set if track ind passes the requirements of particle cnt
+    mGoodMasks.assign(nTracks, 0);
+    mSigns.assign(nTracks, 0);
+    for (auto ind = 0; ind < nTracks; ind++) {
+      auto track = tracks.begin() + ind;
+      mSigns[ind] = track.sign();
+      for (auto cnt = 0; cnt < nCombine; cnt++) {
+        if (isGoodTrack(track, cnt)) {
+          mGoodMasks[ind] |= (1u << cnt);
         }
       }
     }
 
+    // accepted net charges
+    mUnlikeCharges = mAnaPars.unlikeCharges();
+    mLikeCharges = mAnaPars.likeCharges();
+    mAcceptedCharges = mUnlikeCharges;
+    mAcceptedCharges.insert(mAcceptedCharges.end(), mLikeCharges.begin(), mLikeCharges.end());
+
+    // search the combinations of tracks, in increasing order of the track indices, with backtracking;
+    // a branch is abandoned as soon as no unique permutation is compatible with the PID masks of its tracks
+    // or no accepted net charge can be reached anymore
+    mUniquePerms = mAnaPars.uniquePermutations();
+    int numUniquePerms = mUniquePerms.size() / nCombine;
+    mComb.assign(nCombine, 0);
+    mAlivePerms.resize(nCombine + 1);
+    mAlivePerms[0].resize(numUniquePerms);
+    for (auto ii = 0; ii < numUniquePerms; ii++) {
+      mAlivePerms[0][ii] = ii;
+    }
+    searchCombinations(tracks, 0, 0, 0);
+
     return std::vector<int>{static_cast<int>(mUnlikeIVMs.size()), static_cast<int>(mLikeIVMs.size())};
   }
 
@@ -494,11 +507,78 @@ struct DGPIDSelector {
   // particle properties
   TDatabasePDG* fPDG;
 
-  // helper functions for computeIVMs
-  void combinations(int n0, std::vector<int>& pool, int np, std::vector<int>& inds, int n,
-                    std::vector<std::vector<int>>& combs);
-  int combinations(int n0, int np, std::vector<std::vector<int>>& combs);
-  std::vector<std::vector<int>> combinations(int nPool);
+  // buffers of computeIVMs
+  std::vector<uint32_t> mGoodMasks;          // PID hypotheses compatible with each track
+  std::vector<int> mSigns;                   // charge of each track
+  std::vector<int> mUnlikeCharges;           // accepted net charges of the unlike sign combinations
+  std::vector<int> mLikeCharges;             // accepted net charges of the like sign combinations
+  std::vector<int> mAcceptedCharges;         // accepted net charges (unlike and like sign)
+  std::vector<int> mUniquePerms;             // unique permutations, nCombine entries per permutation
+  std::vector<std::vector<int>> mAlivePerms; // permutations compatible with the first tracks of the combination, per depth
+  std::vector<int> mComb;                    // current combination of tracks
+
+  // backtracking over the combinations of tracks, adding the track combinations which pass all the requirements
+  template <typename TTrack>
+  void searchCombinations(TTrack const& tracks, int depth, int firstTrack, int netCharge)
+  {
+    auto nCombine = mAnaPars.nCombine();
+    int nTracks = mGoodMasks.size();
+
+    if (depth == nCombine) {
+      // is combination compatible with netCharge requirements?
+      bool isGoodUnlike = std::find(mUnlikeCharges.begin(), mUnlikeCharges.end(), netCharge) != mUnlikeCharges.end();
+      bool isGoodLike = std::find(mLikeCharges.begin(), mLikeCharges.end(), netCharge) != mLikeCharges.end();
+      if (!isGoodUnlike && !isGoodLike) {
+        return;
+      }
+      // permute the combination
+      std::vector<int> cope(nCombine, 0);
+      for (auto ii : mAlivePerms[depth]) {
+        for (auto jj = 0; jj < nCombine; jj++) {
+          cope[mUniquePerms[ii * nCombine + jj]] = mComb[jj];
+        }
+        DGParticle IVM(fPDG, mAnaPars, tracks, cope);
+        if (isGoodUnlike) {
+          mUnlikeIVMs.push_back(IVM);
+        }
+        if (isGoodLike) {
+          mLikeIVMs.push_back(IVM);
+        }
+      }
+      return;
+    }
+
+    auto nRemaining = nCombine - depth - 1;
+    for (auto ind = firstTrack; ind < nTracks - nRemaining; ind++) {
+      // can an accepted net charge still be reached?
+      auto charge = netCharge + mSigns[ind];
+      bool isReachable = false;
+      for (auto accepted : mAcceptedCharges) {
+        if (std::abs(accepted - charge) <= nRemaining) {
+          isReachable = true;
+          break;
+        }
+      }
+      if (!isReachable) {
+        continue;
+      }
+
+      // permutations which put this track on a compatible PID hypothesis
+      auto& alive = mAlivePerms[depth + 1];
+      alive.clear();
+      for (auto ii : mAlivePerms[depth]) {
+        if (mGoodMasks[ind] & (1u << mUniquePerms[ii * nCombine + depth])) {
+          alive.push_back(ii);
+        }
+      }
+      if (alive.empty()) {
+        continue;
+      }
+
+      mComb[depth] = ind;
+      searchCombinations(tracks, depth + 1, ind + 1, charge);
+    }
+  }
 
   // ClassDefNV(DGPIDSelector, 1);
 };
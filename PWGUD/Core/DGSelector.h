@@ -29,6 +29,10 @@ class DGSelector
   DGSelector() { fPDG = TDatabasePDG::Instance(); }
   ~DGSelector() { delete fPDG; }
 
+  // counts the FIT activity in the ranges of compatible BCs from fitActivity, which
+  // must be filled with the BC table of these ranges, instead of checking each BC
+  void SetFITActivity(const udhelpers::FITActivity* fitActivity) { fFITActivity = fitActivity; }
+
   template <typename CC, typename BCs, typename TCs, typename FWs>
   int Print(DGCutparHolder diffCuts, CC& collision, BCs& bcRange, TCs& tracks, FWs& fwdtracks)
   {
@@ -60,7 +64,12 @@ class DGSelector
     } else if (diffCuts.withTOR()) {
       vetoToApply = 3;
     }
-    if (vetoToApply >= 0) {
+    if (vetoToApply >= 0 && fFITActivity) {
+      constexpr udhelpers::FITActivity::Activity vetoes[4] = {udhelpers::FITActivity::kTVX, udhelpers::FITActivity::kTSC, udhelpers::FITActivity::kTCE, udhelpers::FITActivity::kNotCleanFIT};
+      if (fFITActivity->count(bcRange, vetoes[vetoToApply]) > 0) {
+        return 1;
+      }
+    } else if (vetoToApply >= 0) {
       for (auto const& bc : bcRange) {
         switch (vetoToApply) {
           case 0:
@@ -190,10 +199,16 @@ class DGSelector
   {
     // check that there are no FIT signals in bcRange
     // Double Gap (DG) condition
-    for (auto const& bc : bcRange) {
-      if (!udhelpers::cleanFIT(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
+    if (fFITActivity) {
+      if (fFITActivity->count(bcRange, udhelpers::FITActivity::kNotCleanFIT) > 0) {
         return 1;
       }
+    } else {
+      for (auto const& bc : bcRange) {
+        if (!udhelpers::cleanFIT(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
+          return 1;
+        }
+      }
     }
 
     // no activity in muon arm
@@ -260,6 +275,7 @@ class DGSelector
 
  private:
   TDatabasePDG* fPDG;
+  const udhelpers::FITActivity* fFITActivity = nullptr;
 
   ClassDefNV(DGSelector, 1);
 };
@@ -27,6 +27,10 @@ class SGSelector
   SGSelector() { fPDG = TDatabasePDG::Instance(); }
   ~SGSelector() { delete fPDG; }
 
+  // counts the FIT activity in the ranges of compatible BCs from fitActivity, which
+  // must be filled with the BC table of these ranges, instead of checking each BC
+  void SetFITActivity(const udhelpers::FITActivity* fitActivity) { fFITActivity = fitActivity; }
+
   template <typename CC, typename BCs, typename TCs, typename FWs>
   int Print(SGCutParHolder diffCuts, CC& collision, BCs& bcRange, TCs& tracks, FWs& fwdtracks)
   {
@@ -44,12 +48,17 @@ class SGSelector
     // Single Gap (SG) condition
     bool gA = true;
     bool gC = true;
-    for (auto const& bc : bcRange) {
-      if (!udhelpers::cleanFITA(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
-        gA = false;
-      }
-      if (!udhelpers::cleanFITC(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
-        gC = false;
+    if (fFITActivity) {
+      gA = fFITActivity->count(bcRange, udhelpers::FITActivity::kNotCleanFITA) == 0;
+      gC = fFITActivity->count(bcRange, udhelpers::FITActivity::kNotCleanFITC) == 0;
+    } else {
+      for (auto const& bc : bcRange) {
+        if (!udhelpers::cleanFITA(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
+          gA = false;
+        }
+        if (!udhelpers::cleanFITC(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
+          gC = false;
+        }
       }
     }
     if (!gA && !gC)
@@ -161,12 +170,17 @@ class SGSelector
     // Single Gap (SG) condition
     bool gA = true;
     bool gC = true;
-    for (auto const& bc : bcRange) {
-      if (!udhelpers::cleanFITA(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
-        gA = false;
-      }
-      if (!udhelpers::cleanFITC(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
-        gC = false;
+    if (fFITActivity) {
+      gA = fFITActivity->count(bcRange, udhelpers::FITActivity::kNotCleanFITA) == 0;
+      gC = fFITActivity->count(bcRange, udhelpers::FITActivity::kNotCleanFITC) == 0;
+    } else {
+      for (auto const& bc : bcRange) {
+        if (!udhelpers::cleanFITA(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
+          gA = false;
+        }
+        if (!udhelpers::cleanFITC(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits())) {
+          gC = false;
+        }
       }
     }
     if (!gA && !gC)
@@ -244,6 +258,7 @@ class SGSelector
 
  private:
   TDatabasePDG* fPDG;
+  const udhelpers::FITActivity* fFITActivity = nullptr;
 };
 
 #endif // PWGUD_CORE_SGSELECTOR_H_
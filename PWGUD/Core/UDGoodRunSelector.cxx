@@ -35,6 +35,8 @@ void UDGoodRunSelector::clear()
   mrunMap.clear();
   mrnMin = -1;
   mrnMax = -1;
+  mlastRun = -1;
+  mlastRunIsGood = false;
   misActive = false;
 }
 
@@ -58,9 +60,12 @@ bool UDGoodRunSelector::isGoodRun(int runNumber)
   // search for runNumber in mgoodRuns
   if (!misActive) {
     return true;
-  } else {
-    return std::find(mgoodRuns.begin(), mgoodRuns.end(), runNumber) != mgoodRuns.end();
   }
+  if (runNumber != mlastRun) {
+    mlastRun = runNumber;
+    mlastRunIsGood = runNumber >= mrnMin && runNumber <= mrnMax && std::binary_search(mgoodRuns.begin(), mgoodRuns.end(), runNumber);
+  }
+  return mlastRunIsGood;
 }
 
 std::vector<int> UDGoodRunSelector::goodRuns(std::string runPeriod)
@@ -89,7 +94,7 @@ bool UDGoodRunSelector::init(std::string const& goodRunsFile)
   //      }
   //    ]
   //  }
-  misActive = false;
+  clear();
   if (goodRunsFile.empty()) {
     LOGF(info, "goodRuns was not specified!");
     return true;
@@ -158,9 +163,10 @@ bool UDGoodRunSelector::init(std::string const& goodRunsFile)
       // update goodRuns and mrunMap
       for (auto& item2 : item1[itemName].GetArray()) {
         runNumber = item2.GetInt();
-        if (runNumber < mrnMin) {
+        if (mgoodRuns.empty() || runNumber < mrnMin) {
           mrnMin = runNumber;
-        } else if (runNumber > mrnMax) {
+        }
+        if (mgoodRuns.empty() || runNumber > mrnMax) {
           mrnMax = runNumber;
         }
         mgoodRuns.push_back(runNumber);
@@ -38,10 +38,13 @@ struct UDGoodRunSelector {
   int rnumMax() { return mrnMax; }
 
  private:
-  bool misActive;
+  bool misActive = false;
   std::string mgoodRunsFile;
   int mrnMin = -1, mrnMax = -1;
-  std::vector<int> mgoodRuns;
+  std::vector<int> mgoodRuns; // sorted and unique
+  // result of the last isGoodRun, since consecutive collisions mostly belong to the same run
+  int mlastRun = -1;
+  bool mlastRunIsGood = false;
   std::map<std::string, std::vector<int>> mrunMap;
 };
 
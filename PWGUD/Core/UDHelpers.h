@@ -515,6 +515,57 @@ bool TOR(T& bc, float maxFITtime, std::vector<float> lims)
   return torA || torC;
 }
 
+// -----------------------------------------------------------------------------
+// Numbers of BCs with FIT activity, summed over the rows of a BC table.
+// The ranges of compatible BCs are slices of the BC table, so that the number of
+// BCs with activity in a range is the difference of two sums, instead of checking
+// each BC of the range. The sums are filled once for the BC table of a time frame
+// and must be refilled when the BC table or the FIT cuts change.
+class FITActivity
+{
+ public:
+  enum Activity {
+    kNotCleanFIT = 0, // !cleanFIT
+    kNotCleanFITA,    // !cleanFITA
+    kNotCleanFITC,    // !cleanFITC
+    kTVX,
+    kTSC,
+    kTCE,
+    kNActivities
+  };
+
+  template <typename T>
+  void fill(T const& bcs, float maxFITtime, std::vector<float> lims)
+  {
+    for (auto& sums : fSums) {
+      sums.assign(bcs.size() + 1, 0);
+    }
+    int32_t ind = 0;
+    for (auto const& bc : bcs) {
+      bool active[kNActivities] = {!cleanFIT(bc, maxFITtime, lims), !cleanFITA(bc, maxFITtime, lims), !cleanFITC(bc, maxFITtime, lims),
+                                   TVX(bc), TSC(bc), TCE(bc)};
+      for (int i = 0; i < kNActivities; i++) {
+        fSums[i][ind + 1] = fSums[i][ind] + active[i];
+      }
+      ind++;
+    }
+  }
+
+  // number of BCs of bcRange, a slice of the BC table used in fill, with the given activity
+  template <typename BCR>
+  int32_t count(BCR const& bcRange, Activity activity) const
+  {
+    if (bcRange.size() == 0) {
+      return 0;
+    }
+    auto first = bcRange.begin().globalIndex();
+    return fSums[activity][first + bcRange.size()] - fSums[activity][first];
+  }
+
+ private:
+  std::vector<int32_t> fSums[kNActivities];
+};
+
 // -----------------------------------------------------------------------------
 // fill BB and BG information into FITInfo
 template <typename BCR>
@@ -625,6 +676,23 @@ bool cleanZDC(T const& bc, aod::Zdcs& zdcs, std::vector<float>& lims, SliceCache
   return (ZdcBC.size() == 0);
 }
 
+// -----------------------------------------------------------------------------
+// fill the ZDC information of a UD collision
+// the BCs with a ZDC row but without any channel are not written, since their row would only contain empty lists
+template <typename TZdc, typename TCursor>
+void fillUDZdc(TCursor& outputZdcs, int64_t udCollisionId, TZdc const& zdc)
+{
+  if (zdc.channelE().size() == 0 && zdc.channelT().size() == 0) {
+    return;
+  }
+  auto enes = std::vector(zdc.energy().begin(), zdc.energy().end());
+  auto chEs = std::vector(zdc.channelE().begin(), zdc.channelE().end());
+  auto amps = std::vector(zdc.amplitude().begin(), zdc.amplitude().end());
+  auto times = std::vector(zdc.time().begin(), zdc.time().end());
+  auto chTs = std::vector(zdc.channelT().begin(), zdc.channelT().end());
+  outputZdcs(udCollisionId, enes, chEs, amps, times, chTs);
+}
+
 // -----------------------------------------------------------------------------
 template <typename T>
 bool cleanCalo(T const& bc, aod::Calos& calos, std::vector<float>& lims, SliceCache& cache)
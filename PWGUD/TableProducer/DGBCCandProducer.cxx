@@ -257,6 +257,9 @@ struct DGBCCandProducer {
   // DG selector
   DGSelector dgSelector;
 
+  // FIT activity in the BCs table, used for the ranges of compatible BCs in processFull
+  udhelpers::FITActivity fitActivity;
+
   HistogramRegistry registry{
     "registry",
     {}};
@@ -535,6 +538,10 @@ struct DGBCCandProducer {
       return;
     }
 
+    // the FIT activity of each BC is evaluated once for all the ranges of compatible BCs it is in
+    fitActivity.fill(bcs, diffCuts.maxFITtime(), diffCuts.FITAmpLimits());
+    dgSelector.SetFITActivity(&fitActivity);
+
     // run over all BC in bcs and tibcs
     int64_t lastCollision = 0;
     float vpos[3];
@@ -616,13 +623,7 @@ struct DGBCCandProducer {
                            col.numContrib(), nCharge, rtrwTOF, colTracks, fitInfo);
             // fill UDZdcs
             if (bc.has_zdc()) {
-              auto zdc = bc.zdc();
-              auto enes = std::vector(zdc.energy().begin(), zdc.energy().end());
-              auto chEs = std::vector(zdc.channelE().begin(), zdc.channelE().end());
-              auto amps = std::vector(zdc.amplitude().begin(), zdc.amplitude().end());
-              auto times = std::vector(zdc.time().begin(), zdc.time().end());
-              auto chTs = std::vector(zdc.channelT().begin(), zdc.channelT().end());
-              outputZdcs(outputCollisions.lastIndex(), enes, chEs, amps, times, chTs);
+              udhelpers::fillUDZdc(outputZdcs, outputCollisions.lastIndex(), bc.zdc());
             }
           }
         }
@@ -686,13 +687,7 @@ struct DGBCCandProducer {
             // fill UDZdcs
             if (bc.globalBC() == bcnum) {
               if (bc.has_zdc()) {
-                auto zdc = bc.zdc();
-                auto enes = std::vector(zdc.energy().begin(), zdc.energy().end());
-                auto chEs = std::vector(zdc.channelE().begin(), zdc.channelE().end());
-                auto amps = std::vector(zdc.amplitude().begin(), zdc.amplitude().end());
-                auto times = std::vector(zdc.time().begin(), zdc.time().end());
-                auto chTs = std::vector(zdc.channelT().begin(), zdc.channelT().end());
-                outputZdcs(outputCollisions.lastIndex(), enes, chEs, amps, times, chTs);
+                udhelpers::fillUDZdc(outputZdcs, outputCollisions.lastIndex(), bc.zdc());
               }
             }
           }
@@ -732,6 +727,7 @@ struct DGBCCandProducer {
         }
       }
     }
+    dgSelector.SetFITActivity(nullptr);
   }
 
   PROCESS_SWITCH(DGBCCandProducer, processFull, "Produce UDTables", true);
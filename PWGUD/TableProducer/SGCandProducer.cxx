@@ -197,13 +197,7 @@ struct SGCandProducer {
 
       // fill UDZdcs
       if (bc.has_zdc()) {
-        auto zdc = bc.zdc();
-        auto enes = std::vector(zdc.energy().begin(), zdc.energy().end());
-        auto chEs = std::vector(zdc.channelE().begin(), zdc.channelE().end());
-        auto amps = std::vector(zdc.amplitude().begin(), zdc.amplitude().end());
-        auto times = std::vector(zdc.time().begin(), zdc.time().end());
-        auto chTs = std::vector(zdc.channelT().begin(), zdc.channelT().end());
-        outputZdcs(outputCollisions.lastIndex(), enes, chEs, amps, times, chTs);
+        udhelpers::fillUDZdc(outputZdcs, outputCollisions.lastIndex(), bc.zdc());
       }
 
       // produce TPC signal histograms for 2-track events
@@ -9,6 +9,10 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
@@ -90,6 +94,7 @@ struct UpcCandProducer {
                                      o2::aod::pidTOFFullEl, o2::aod::pidTOFFullMu, o2::aod::pidTOFFullPi, o2::aod::pidTOFFullKa, o2::aod::pidTOFFullPr>;
 
   typedef std::pair<uint64_t, std::vector<int64_t>> BCTracksPair;
+  typedef std::pair<uint64_t, int32_t> BCIndexPair; // global BC and row index in a FIT table
 
   void init(InitContext&)
   {
@@ -202,17 +207,34 @@ struct UpcCandProducer {
     return true;
   }
 
-  auto findClosestBC(uint64_t globalBC, std::map<uint64_t, int32_t>& bcs)
+  // sorts by global BC and keeps only the last row of each BC
+  void sortBCIndices(std::vector<BCIndexPair>& bcs)
   {
-    auto it = bcs.lower_bound(globalBC);
+    std::stable_sort(bcs.begin(), bcs.end(),
+                     [](const auto& left, const auto& right) { return left.first < right.first; });
+    auto itFirstKept = std::unique(bcs.rbegin(), bcs.rend(),
+                                   [](const auto& left, const auto& right) { return left.first == right.first; });
+    bcs.erase(bcs.begin(), itFirstKept.base());
+  }
+
+  // bcs must be sorted and not empty
+  auto findClosestBC(uint64_t globalBC, std::vector<BCIndexPair>& bcs)
+  {
+    auto it = std::lower_bound(bcs.begin(), bcs.end(), globalBC,
+                               [](const BCIndexPair& p, uint64_t bc) {
+                                 return p.first < bc;
+                               });
+    if (it == bcs.end())
+      return --it;
     auto bc1 = it->first;
+    auto it1 = it;
     if (it != bcs.begin())
       --it;
+    auto it2 = it;
     auto bc2 = it->first;
     auto dbc1 = bc1 >= globalBC ? bc1 - globalBC : globalBC - bc1;
     auto dbc2 = bc2 >= globalBC ? bc2 - globalBC : globalBC - bc2;
-    auto bc = (dbc1 <= dbc2) ? bc1 : bc2;
-    return bc;
+    return (dbc1 <= dbc2) ? it1 : it2;
   }
 
   auto findClosestTrackBCiter(uint64_t globalBC, std::vector<BCTracksPair>& bcs)
@@ -710,34 +732,43 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsITSTPC.begin(), bcsMatchedTrIdsITSTPC.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithTOR{};
-    std::map<uint64_t, int32_t> mapGlobalBcWithTVX{};
-    std::map<uint64_t, int32_t> mapGlobalBcWithTSC{};
+    // pairs of global BCs and FIT row indices, sorted by global BC
+    std::vector<BCIndexPair> bcsWithTOR;
+    std::vector<BCIndexPair> bcsWithTVX;
+    std::vector<BCIndexPair> bcsWithTSC;
+    bcsWithTOR.reserve(ft0s.size());
+    bcsWithTVX.reserve(ft0s.size());
+    bcsWithTSC.reserve(ft0s.size());
     for (auto ft0 : ft0s) {
       uint64_t globalBC = ft0.bc_as<BCsWithBcSels>().globalBC();
       int32_t globalIndex = ft0.globalIndex();
       if (!(std::abs(ft0.timeA()) > 2.f && std::abs(ft0.timeC()) > 2.f))
-        mapGlobalBcWithTOR[globalBC] = globalIndex;
+        bcsWithTOR.emplace_back(globalBC, globalIndex);
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex)) // TVX
-        mapGlobalBcWithTVX[globalBC] = globalIndex;
+        bcsWithTVX.emplace_back(globalBC, globalIndex);
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex) &&
           (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitCen) ||
            TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitSCen))) // TVX & (TSC | TCE)
-        mapGlobalBcWithTSC[globalBC] = globalIndex;
+        bcsWithTSC.emplace_back(globalBC, globalIndex);
     }
+    sortBCIndices(bcsWithTOR);
+    sortBCIndices(bcsWithTVX);
+    sortBCIndices(bcsWithTSC);
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
+    std::vector<BCIndexPair> bcsWithV0A;
+    bcsWithV0A.reserve(fv0as.size());
     for (auto fv0a : fv0as) {
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<BCsWithBcSels>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      bcsWithV0A.emplace_back(globalBC, fv0a.globalIndex());
     }
+    sortBCIndices(bcsWithV0A);
 
-    auto nTORs = mapGlobalBcWithTOR.size();
-    auto nTSCs = mapGlobalBcWithTSC.size();
-    auto nTVXs = mapGlobalBcWithTVX.size();
-    auto nFV0As = mapGlobalBcWithV0A.size();
+    auto nTORs = bcsWithTOR.size();
+    auto nTSCs = bcsWithTSC.size();
+    auto nTVXs = bcsWithTVX.size();
+    auto nFV0As = bcsWithV0A.size();
     auto nBcsWithITSTPC = bcsMatchedTrIdsITSTPC.size();
 
     // todo: calculate position of UD collision?
@@ -761,12 +792,11 @@ struct UpcCandProducer {
       fitInfo.distClosestBcTVX = 999;
       fitInfo.distClosestBcV0A = 999;
       if (nTORs > 0) {
-        uint64_t closestBcTOR = findClosestBC(globalBC, mapGlobalBcWithTOR);
-        fitInfo.distClosestBcTOR = globalBC - static_cast<int64_t>(closestBcTOR);
+        auto itClosestBcTOR = findClosestBC(globalBC, bcsWithTOR);
+        fitInfo.distClosestBcTOR = globalBC - static_cast<int64_t>(itClosestBcTOR->first);
         if (std::abs(fitInfo.distClosestBcTOR) <= fFilterFT0)
           return false;
-        auto ft0Id = mapGlobalBcWithTOR.at(closestBcTOR);
-        auto ft0 = ft0s.iteratorAt(ft0Id);
+        auto ft0 = ft0s.iteratorAt(itClosestBcTOR->second);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
         const auto& t0AmpsA = ft0.amplitudeA();
@@ -777,24 +807,23 @@ struct UpcCandProducer {
           fitInfo.ampFT0C += amp;
       }
       if (nTSCs > 0) {
-        uint64_t closestBcTSC = findClosestBC(globalBC, mapGlobalBcWithTSC);
+        uint64_t closestBcTSC = findClosestBC(globalBC, bcsWithTSC)->first;
         fitInfo.distClosestBcTSC = globalBC - static_cast<int64_t>(closestBcTSC);
         if (std::abs(fitInfo.distClosestBcTSC) <= fFilterTSC)
           return false;
       }
       if (nTVXs > 0) {
-        uint64_t closestBcTVX = findClosestBC(globalBC, mapGlobalBcWithTVX);
+        uint64_t closestBcTVX = findClosestBC(globalBC, bcsWithTVX)->first;
         fitInfo.distClosestBcTVX = globalBC - static_cast<int64_t>(closestBcTVX);
         if (std::abs(fitInfo.distClosestBcTVX) <= fFilterTVX)
           return false;
       }
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
-        fitInfo.distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
+        auto itClosestBcV0A = findClosestBC(globalBC, bcsWithV0A);
+        fitInfo.distClosestBcV0A = globalBC - static_cast<int64_t>(itClosestBcV0A->first);
         if (std::abs(fitInfo.distClosestBcV0A) <= fFilterFV0)
           return false;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
-        auto fv0a = fv0as.iteratorAt(fv0aId);
+        auto fv0a = fv0as.iteratorAt(itClosestBcV0A->second);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
         for (auto amp : v0Amps)
@@ -1125,24 +1154,29 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsMCH.begin(), bcsMatchedTrIdsMCH.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithT0{};
+    // pairs of global BCs and FIT row indices, sorted by global BC
+    std::vector<BCIndexPair> bcsWithT0;
+    bcsWithT0.reserve(ft0s.size());
     for (auto ft0 : ft0s) {
       if (std::abs(ft0.timeA()) > 2.f)
         continue;
       uint64_t globalBC = ft0.bc_as<BCsWithBcSels>().globalBC();
-      mapGlobalBcWithT0[globalBC] = ft0.globalIndex();
+      bcsWithT0.emplace_back(globalBC, ft0.globalIndex());
     }
+    sortBCIndices(bcsWithT0);
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
+    std::vector<BCIndexPair> bcsWithV0A;
+    bcsWithV0A.reserve(fv0as.size());
     for (auto fv0a : fv0as) {
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<BCsWithBcSels>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      bcsWithV0A.emplace_back(globalBC, fv0a.globalIndex());
     }
+    sortBCIndices(bcsWithV0A);
 
-    auto nFT0s = mapGlobalBcWithT0.size();
-    auto nFV0As = mapGlobalBcWithV0A.size();
+    auto nFT0s = bcsWithT0.size();
+    auto nFV0As = bcsWithV0A.size();
     auto nBcsWithMCH = bcsMatchedTrIdsMCH.size();
 
     // todo: calculate position of UD collision?
@@ -1188,13 +1222,12 @@ struct UpcCandProducer {
       fitInfo.BBFT0Apf = -999;
       fitInfo.BBFV0Apf = -999;
       if (nFT0s > 0) {
-        uint64_t closestBcT0 = findClosestBC(globalBC, mapGlobalBcWithT0);
-        int64_t distClosestBcT0 = globalBC - static_cast<int64_t>(closestBcT0);
+        auto itClosestBcT0 = findClosestBC(globalBC, bcsWithT0);
+        int64_t distClosestBcT0 = globalBC - static_cast<int64_t>(itClosestBcT0->first);
         if (std::abs(distClosestBcT0) < fFilterFT0)
           continue;
         fitInfo.BBFT0Apf = distClosestBcT0;
-        auto ft0Id = mapGlobalBcWithT0.at(closestBcT0);
-        auto ft0 = ft0s.iteratorAt(ft0Id);
+        auto ft0 = ft0s.iteratorAt(itClosestBcT0->second);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
         const auto& t0AmpsA = ft0.amplitudeA();
@@ -1205,13 +1238,12 @@ struct UpcCandProducer {
           fitInfo.ampFT0C += amp;
       }
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
-        int64_t distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
+        auto itClosestBcV0A = findClosestBC(globalBC, bcsWithV0A);
+        int64_t distClosestBcV0A = globalBC - static_cast<int64_t>(itClosestBcV0A->first);
         if (std::abs(distClosestBcV0A) < fFilterFV0)
           continue;
         fitInfo.BBFV0Apf = distClosestBcV0A;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
-        auto fv0a = fv0as.iteratorAt(fv0aId);
+        auto fv0a = fv0as.iteratorAt(itClosestBcV0A->second);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
         for (auto amp : v0Amps)
@@ -1240,8 +1272,8 @@ struct UpcCandProducer {
     ambFwdTrBCs.clear();
     bcsMatchedTrIdsMID.clear();
     bcsMatchedTrIdsMCH.clear();
-    mapGlobalBcWithT0.clear();
-    mapGlobalBcWithV0A.clear();
+    bcsWithT0.clear();
+    bcsWithV0A.clear();
   }
 
   // data processors
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+
+# Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+# See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+# All rights not expressly granted are reserved.
+#
+# This software is distributed under the terms of the GNU General Public
+# License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+#
+# In applying this license CERN does not waive the privileges and immunities
+# granted to it by virtue of its status as an Intergovernmental Organization
+# or submit itself to any jurisdiction.
+
+"""!
+@brief  Throughput benchmark of the common production chain of workflows on a fixed AO2D input.
+
+The script runs the chain of the production train (common tables, PID, multiplicity and centrality,
+V0 building, HF 2-prong skimming, D0 candidate creation and selection, DQ table maker) as a single
+DPL topology with the DPL resource monitoring enabled, and summarises the performanceMetrics.json
+written by DPL in a machine-readable JSON report with, for each device:
+- CPU time: last value of the accumulated CPU usage of the device,
+- wall time: time between the first and the last metric sample of the device,
+- peak RSS: maximum of the sampled memory size of the device,
+- I/O bytes: last values of the bytes read from the AOD file and of the bytes of the created messages.
+The totals of the whole chain (wall time, user and system CPU time, peak RSS of the largest process
+and block I/O) are measured from the resource usage of the child processes.
+
+The same input, configuration and options must be used to compare two builds.
+Workflows can be added to the chain (e.g. converters needed by the input) with --add.
+
+@date   2026-10-14
+"""
+
+import argparse
+import json
+import os
+import resource
+import subprocess as sp  # nosec B404
+import sys
+import time
+
+# Production chain, in the order of the pipe
+WORKFLOWS = [
+    "o2-analysis-timestamp",
+    "o2-analysis-event-selection",
+    "o2-analysis-track-propagation",
+    "o2-analysis-trackselection",
+    "o2-analysis-pid-tpc-base",
+    "o2-analysis-pid-tpc",
+    "o2-analysis-pid-tof-base",
+    "o2-analysis-pid-tof",
+    "o2-analysis-multiplicity-table",
+    "o2-analysis-centrality-table",
+    "o2-analysis-lf-lambdakzerobuilder",
+    "o2-analysis-hf-track-index-skim-creator",
+    "o2-analysis-hf-candidate-creator-2prong",
+    "o2-analysis-hf-candidate-selector-d0",
+    "o2-analysis-dq-table-maker",
+]
+
+# DPL metrics used for the report, first found name is used
+METRICS_CPU = ["cpuUsedAbsolute"]
+METRICS_RSS = ["proportionalSetSize", "resident-set-size"]
+METRICS_BYTES_READ = ["aod-bytes-read-uncompressed", "aod-bytes-read-compressed"]
+METRICS_BYTES_CREATED = ["arrow-bytes-created"]
+
+
+def eprint(*args, **kwargs):
+    """Print to stderr."""
+    print(*args, file=sys.stderr, **kwargs)
+
+
+def msg_fatal(message: str):
+    """Print an error message and exit."""
+    eprint("\x1b[1;31mError: %s\x1b[0m" % message)
+    sys.exit(1)
+
+
+def get_samples(metrics: dict, names: list):
+    """Return the values of the first metric found in the list of names, in the time order."""
+    for name in names:
+        if name in metrics:
+            samples = sorted(metrics[name], key=lambda s: float(s["timestamp"]))
+            return [float(s["value"]) for s in samples]
+    return []
+
+
+def get_time_range(metrics: dict):
+    """Return the first and last timestamps of all the samples of a device."""
+    timestamps = [float(s["timestamp"]) for samples in metrics.values() for s in samples]
+    if not timestamps:
+        return 0.0, 0.0
+    return min(timestamps), max(timestamps)
+
+
+def summarise_device(metrics: dict) -> dict:
+    """Summarise the performance metrics of a device."""
+    cpu = get_samples(metrics, METRICS_CPU)
+    rss = get_samples(metrics, METRICS_RSS)
+    bytes_read = get_samples(metrics, METRICS_BYTES_READ)
+    bytes_created = get_samples(metrics, METRICS_BYTES_CREATED)
+    time_first, time_last = get_time_range(metrics)
+    return {
+        "cpu_time": cpu[-1] if cpu else None,
+        "wall_time_ms": time_last - time_first,
+        "peak_rss": max(rss) if rss else None,
+        "bytes_read": bytes_read[-1] if bytes_read else None,
+        "bytes_created": bytes_created[-1] if bytes_created else None,
+    }
+
+
+def make_command(workflows: list, options: str, config: str, n_readers: int) -> str:
+    """Make the command of the chain of workflows."""
+    if config:
+        options += f" --configuration json://{os.path.abspath(config)}"
+    options += f" --readers {n_readers}"
+    return " | ".join(f"{wf} {options}" for wf in workflows)
+
+
+def main():
+    """Main function"""
+    parser = argparse.ArgumentParser(description="Throughput benchmark of the production chain of workflows.")
+    parser.add_argument("-i", dest="input", type=str, default="AO2D.root", help="input AO2D file")
+    parser.add_argument("-c", dest="config", type=str, help="DPL JSON configuration file")
+    parser.add_argument("-o", dest="output", type=str, default="benchmark.json", help="output JSON report")
+    parser.add_argument("-l", dest="log", type=str, default="stdout.log", help="log file of the workflows")
+    parser.add_argument("-r", dest="readers", type=int, default=1, help="number of AOD readers")
+    parser.add_argument("-m", dest="monitoring", type=int, default=2, help="resource monitoring interval [s]")
+    parser.add_argument("--add", type=str, nargs="+", default=[], help="additional workflows in the chain")
+    parser.add_argument(
+        "--options",
+        type=str,
+        default="--aod-memory-rate-limit 2000000000 --shm-segment-size 16000000000 --min-failure-level error",
+        help="additional command line options of the workflows",
+    )
+    args = parser.parse_args()
+
+    if not os.path.isfile(args.input):
+        msg_fatal(f"Input file {args.input} not found.")
+    if args.config and not os.path.isfile(args.config):
+        msg_fatal(f"Configuration file {args.config} not found.")
+    path_metrics = "performanceMetrics.json"
+    if os.path.isfile(path_metrics):
+        os.remove(path_metrics)  # written by DPL at the end of the run
+
+    workflows = WORKFLOWS + args.add
+    options = f"-b --aod-file {os.path.abspath(args.input)} --resources-monitoring {args.monitoring} {args.options}"
+    cmd = make_command(workflows, options, args.config, args.readers)
+    print(f"Running {len(workflows)} workflows on {args.input}")
+    time_start = time.monotonic()
+    with open(args.log, "w") as file_log:
+        rc = sp.run(cmd, shell=True, stdout=file_log, stderr=sp.STDOUT).returncode  # nosec B602
+    wall_time = time.monotonic() - time_start
+    usage = resource.getrusage(resource.RUSAGE_CHILDREN)
+    if rc != 0:
+        msg_fatal(f"Exit code {rc}, check the log file {args.log}")
+
+    try:
+        with open(path_metrics, "r") as file_metrics:
+            metrics = json.load(file_metrics)
+    except (IOError, ValueError):
+        msg_fatal(f"Failed to read {path_metrics}")
+    devices = {device: summarise_device(metrics_device) for device, metrics_device in sorted(metrics.items())}
+
+    report = {
+        "input": os.path.abspath(args.input),
+        "input_bytes": os.path.getsize(args.input),
+        "config": os.path.abspath(args.config) if args.config else None,
+        "workflows": workflows,
+        "total": {
+            "wall_time_s": wall_time,
+            "user_cpu_time_s": usage.ru_utime,
+            "system_cpu_time_s": usage.ru_stime,
+            "max_process_rss_kb": usage.ru_maxrss,
+            "blocks_read": usage.ru_inblock,
+            "blocks_written": usage.ru_oublock,
+        },
+        "devices": devices,
+    }
+    try:
+        with open(args.output, "w") as file_out:
+            json.dump(report, file_out, indent=2)
+    except IOError:
+        msg_fatal(f"Failed to open file {args.output}")
+    print(f"Wall time {wall_time:.1f} s, CPU time {usage.ru_utime + usage.ru_stime:.1f} s, {len(devices)} devices")
+    print(f"Report written in {args.output}")
+
+
+if __name__ == "__main__":
+    main()
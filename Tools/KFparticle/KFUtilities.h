@@ -21,10 +21,13 @@
 #define HomogeneousField
 #endif
 
+#include <vector>
+
 #include <TDatabasePDG.h> // FIXME
 
 #include "KFParticle.h"
 #include "KFPTrack.h"
+#include "KFPTrackVector.h"
 #include "KFPVertex.h"
 #include "KFParticleBase.h"
 #include "KFVertex.h"
@@ -93,6 +96,60 @@ KFPTrack createKFPTrackFromTrack(const T& track)
   return kfpTrack;
 }
 
+/// @brief Function to create the KFPTracks of all the tracks of a table, e.g. of a collision, so that the tracks
+/// are converted once and not for each combination they enter. The Covariance matrix is needed.
+/// @tparam T
+/// @param tracks Tracks from aod::Tracks, aod::TracksExtra, aod::TracksCov, grouped by collision and possibly filtered
+/// @param kfpTracks KFPTracks, indexed by the global index of the track minus the one of the first track of the table
+template <typename T>
+void createKFPTracksFromTracks(const T& tracks, std::vector<KFPTrack>& kfpTracks)
+{
+  kfpTracks.clear();
+  if (tracks.size() == 0) {
+    return;
+  }
+  const int64_t firstIndex = tracks.begin().globalIndex();
+  for (const auto& track : tracks) {
+    const std::size_t index = track.globalIndex() - firstIndex;
+    if (index >= kfpTracks.size()) {
+      kfpTracks.resize(index + 1);
+    }
+    kfpTracks[index] = createKFPTrackFromTrack(track);
+  }
+}
+
+/// @brief Function to fill a KFPTrackVector, the structure of arrays of tracks of the KFParticle finder, from AO2D tracks.
+/// The Covariance matrix is needed.
+/// @tparam T
+/// @param tracks Tracks from aod::Tracks, aod::TracksExtra, aod::TracksCov
+/// @param trackVector KFPTrackVector with the tracks in the order of the table, with the global index of the track as id
+template <typename T>
+void createKFPTrackVectorFromTracks(const T& tracks, KFPTrackVector& trackVector)
+{
+  trackVector.Resize(tracks.size());
+  std::array<float, 3> trkpos_par;
+  std::array<float, 3> trkmom_par;
+  std::array<float, 21> trk_cov;
+  int iTrack = 0;
+  for (const auto& track : tracks) {
+    auto trackparCov = getTrackParCov(track);
+    trackparCov.getXYZGlo(trkpos_par);
+    trackparCov.getPxPyPzGlo(trkmom_par);
+    trackparCov.getCovXYZPxPyPzGlo(trk_cov);
+    for (int i = 0; i < 3; i++) {
+      trackVector.SetParameter(trkpos_par[i], i, iTrack);
+      trackVector.SetParameter(trkmom_par[i], i + 3, iTrack);
+    }
+    for (int i = 0; i < 21; i++) {
+      trackVector.SetCovariance(trk_cov[i], i, iTrack);
+    }
+    trackVector.SetId(track.globalIndex(), iTrack);
+    trackVector.SetQ(track.sign(), iTrack);
+    trackVector.SetPVIndex(-1, iTrack);
+    iTrack++;
+  }
+}
+
 /// @brief Function to create a KFPTrack from o2::track::TrackParametrizationWithError tracks. The Covariance matrix is needed.
 /// @param track Track from o2::track::TrackParametrizationWithError
 /// @return KFPTrack
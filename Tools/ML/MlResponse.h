@@ -19,6 +19,7 @@
 
 #include <onnxruntime/core/session/experimental_onnxruntime_cxx_api.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -107,13 +108,32 @@ class MlResponse
   /// Initialize class instance (initialize OnnxModels)
   /// \param enableOptimizations is a switch no enable optimizations
   /// \param threads is the number of active threads
+  /// \note identical models are deduplicated by o2::ml::OnnxSessionPool and share the same session
   void init(bool enableOptimizations = false, int threads = 0)
   {
     uint8_t counterModel{0};
     for (const auto& path : mPaths) {
+      mModels[counterModel].setExecutionProvider(mExecutionProvider, mDeviceId);
       mModels[counterModel].initModel(path, enableOptimizations, threads);
       ++counterModel;
     }
+    LOG(info) << "Number of ONNX sessions in the process: " << o2::ml::OnnxSessionPool::instance().getNSessions();
+  }
+
+  /// Set the execution provider of the models, falling back to CPU if not available
+  /// \param provider is the name of the provider ("cpu", "cuda" or "rocm"), to be set before init
+  /// \param deviceId is the index of the GPU device
+  void setExecutionProvider(const std::string& provider, int deviceId = 0)
+  {
+    mExecutionProvider = provider;
+    mDeviceId = deviceId;
+  }
+
+  /// Set the number of threads shared by all the ONNX sessions of the process, replacing the per-model threads
+  /// \param threads is the total number of intra-op threads, to be set before init
+  void setGlobalThreadBudget(int threads)
+  {
+    o2::ml::OnnxSessionPool::instance().setGlobalThreadBudget(threads);
   }
 
   /// Method to translate configurable input-feature strings into integers
@@ -167,20 +187,7 @@ class MlResponse
   {
     auto nModel = findBin(&mBinsLimits, pt);
     auto output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
-        }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
-        }
-      }
-      ++iClass;
-    }
-    return true;
+    return passScoreCuts(output.data(), nModel);
   }
 
   /// ML selections
@@ -192,35 +199,142 @@ class MlResponse
   bool isSelectedMl(T1& input, const T2& pt, std::vector<TypeOutputScore>& output)
   {
     auto nModel = findBin(&mBinsLimits, pt);
-    output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
+    TypeOutputScore* outputPtr = mModels[nModel].evalModel(input);
+    output.assign(outputPtr, outputPtr + mNClasses); // reuses the memory of output
+    return passScoreCuts(output.data(), nModel);
+  }
+
+  /// Batched ML selections: candidates are first collected with addToBatch, then all the candidates
+  /// belonging to the same model are evaluated with a single inference call by evalBatch.
+  /// The results are finally retrieved per candidate with isSelectedMlBatch.
+
+  /// Clear the candidates collected for the batched evaluation (buffer capacities are kept)
+  void clearBatch()
+  {
+    mBatchModel.clear();
+    mBatchRow.clear();
+    mBatchInputs.resize(mNModels);
+    mBatchOutputs.resize(mNModels);
+    mBatchNRows.assign(mNModels, 0);
+    for (auto iModel{0}; iModel < mNModels; ++iModel) {
+      mBatchInputs[iModel].clear();
+      mBatchOutputs[iModel].clear();
+    }
+  }
+
+  /// Add a candidate to the batch
+  /// \param input is the input features
+  /// \param pt is the candidate transverse momentum
+  /// \return index of the candidate in the batch, to be used in isSelectedMlBatch
+  template <typename T1, typename T2>
+  std::size_t addToBatch(T1 const& input, const T2& pt)
+  {
+    if (mBatchNRows.size() != mNModels) {
+      clearBatch();
+    }
+    auto nModel = findBin(&mBinsLimits, pt);
+    mBatchModel.emplace_back(nModel);
+    if (nModel < 0) {
+      mBatchRow.emplace_back(-1);
+    } else {
+      mBatchRow.emplace_back(mBatchNRows[nModel]++);
+      mBatchInputs[nModel].insert(mBatchInputs[nModel].end(), input.begin(), input.end());
+    }
+    return mBatchModel.size() - 1;
+  }
+
+  /// Evaluate the collected candidates, one inference call per model and chunk
+  /// \param chunkSize is the maximum number of candidates evaluated per inference call (0 means no limit)
+  void evalBatch(std::size_t chunkSize = 0)
+  {
+    std::vector<TypeOutputScore> chunkOutput;
+    for (auto iModel{0}; iModel < static_cast<int>(mBatchNRows.size()); ++iModel) {
+      int64_t nRows = mBatchNRows[iModel];
+      if (nRows == 0) {
+        continue;
+      }
+      int64_t nFeatures = mBatchInputs[iModel].size() / nRows;
+      int64_t nRowsChunk = (chunkSize > 0) ? static_cast<int64_t>(chunkSize) : nRows;
+      mBatchOutputs[iModel].clear();
+      mBatchOutputs[iModel].reserve(nRows * mNClasses);
+      for (int64_t firstRow{0}; firstRow < nRows; firstRow += nRowsChunk) {
+        int64_t nRowsEval = std::min(nRowsChunk, nRows - firstRow);
+        int64_t nScores = mModels[iModel].evalModelBatch(mBatchInputs[iModel].data() + firstRow * nFeatures, nRowsEval, chunkOutput);
+        if (nScores != mNClasses) {
+          LOG(fatal) << "Model " << iModel << " returned " << nScores << " scores per candidate, while " << static_cast<int>(mNClasses) << " classes are expected!";
+        }
+        mBatchOutputs[iModel].insert(mBatchOutputs[iModel].end(), chunkOutput.begin(), chunkOutput.end());
+      }
+    }
+  }
+
+  /// ML selections for a candidate evaluated in batch
+  /// \param iCandidate is the index returned by addToBatch
+  /// \param output is a container to be filled with model output
+  /// \return boolean telling if model predictions pass the cuts
+  bool isSelectedMlBatch(std::size_t iCandidate, std::vector<TypeOutputScore>& output)
+  {
+    auto nModel = mBatchModel[iCandidate];
+    if (nModel < 0) {
+      output.clear();
+      return false;
+    }
+    const TypeOutputScore* scores = mBatchOutputs[nModel].data() + mBatchRow[iCandidate] * mNClasses;
+    output.assign(scores, scores + mNClasses);
+    return passScoreCuts(scores, nModel);
+  }
+
+  /// Total time spent in inference calls, summed over all the models
+  /// \return time in seconds
+  double getInferenceTime() const
+  {
+    double time{0.};
+    for (const auto& model : mModels) {
+      time += model.getInferenceTime();
+    }
+    return time;
+  }
+
+ protected:
+  std::vector<o2::ml::OnnxModel> mModels;                  // OnnxModel objects, one for each bin
+  uint8_t mNModels = 1;                                    // number of bins
+  uint8_t mNClasses = 3;                                   // number of model classes
+  std::vector<double> mBinsLimits = {};                    // bin limits of the variable (e.g. pT) used to select which model to use
+  std::vector<std::string> mPaths = {""};                  // paths to the models, one for each bin
+  std::vector<int> mCutDir = {};                           // direction of the cuts on the model scores (no cut is also supported)
+  o2::framework::LabeledArray<double> mCuts = {};          // array of cut values to apply on the model scores
+  std::map<std::string, uint8_t> mAvailableInputFeatures;  // map of available input features
+  std::vector<uint8_t> mCachedIndices;                     // vector of indices correspondance between configurable and available input features
+  std::vector<std::vector<TypeOutputScore>> mBatchInputs;  // input features of the batched candidates, one flat buffer for each model
+  std::vector<std::vector<TypeOutputScore>> mBatchOutputs; // model scores of the batched candidates, one flat buffer for each model
+  std::vector<int64_t> mBatchNRows;                        // number of batched candidates for each model
+  std::vector<int> mBatchModel;                            // model index of each batched candidate (-1 if outside the bins)
+  std::vector<int64_t> mBatchRow;                          // row of each batched candidate in the buffers of its model
+  std::string mExecutionProvider = "cpu";                  // execution provider requested for the models
+  int mDeviceId = 0;                                       // GPU device of the execution provider
+
+  virtual void setAvailableInputFeatures() { return; } // method to fill the map of available input features
+
+  /// Apply the score cuts of a given model
+  /// \param scores is a pointer to the mNClasses scores of a candidate
+  /// \param nModel is the model index
+  /// \return boolean telling if the scores pass the cuts
+  template <typename T>
+  bool passScoreCuts(const TypeOutputScore* scores, const T& nModel)
+  {
+    for (uint8_t iClass{0}; iClass < mNClasses; ++iClass) {
       uint8_t dir = mCutDir.at(iClass);
       if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
+        if (dir == o2::cuts_ml::CutDirection::CutGreater && scores[iClass] > mCuts.get(nModel, iClass)) {
           return false;
         }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
+        if (dir == o2::cuts_ml::CutDirection::CutSmaller && scores[iClass] < mCuts.get(nModel, iClass)) {
           return false;
         }
       }
-      ++iClass;
     }
     return true;
   }
-
- protected:
-  std::vector<o2::ml::OnnxModel> mModels;                 // OnnxModel objects, one for each bin
-  uint8_t mNModels = 1;                                   // number of bins
-  uint8_t mNClasses = 3;                                  // number of model classes
-  std::vector<double> mBinsLimits = {};                   // bin limits of the variable (e.g. pT) used to select which model to use
-  std::vector<std::string> mPaths = {""};                 // paths to the models, one for each bin
-  std::vector<int> mCutDir = {};                          // direction of the cuts on the model scores (no cut is also supported)
-  o2::framework::LabeledArray<double> mCuts = {};         // array of cut values to apply on the model scores
-  std::map<std::string, uint8_t> mAvailableInputFeatures; // map of available input features
-  std::vector<uint8_t> mCachedIndices;                    // vector of indices correspondance between configurable and available input features
-
-  virtual void setAvailableInputFeatures() { return; } // method to fill the map of available input features
 };
 
 } // namespace analysis
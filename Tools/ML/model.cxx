@@ -20,12 +20,100 @@
 // ONNX includes
 #include "Tools/ML/model.h"
 
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <functional>
+#include <iterator>
+
 namespace o2
 {
 
 namespace ml
 {
 
+OnnxSessionPool& OnnxSessionPool::instance()
+{
+  static OnnxSessionPool pool;
+  return pool;
+}
+
+void OnnxSessionPool::setGlobalThreadBudget(int threads)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mEnv) {
+    LOGP(warning, "ONNX environment already created, the global thread budget ({}) cannot be changed to {}.", mGlobalThreads, threads);
+    return;
+  }
+  if (threads > 0 && gSystem->Getenv("ALIEN_JDL_CPUCORES") != NULL) {
+    LOGP(info, "Hyperloop test/Grid job detected! Setting global thread budget anyway to 1.");
+    threads = 1;
+  }
+  mGlobalThreads = threads;
+}
+
+std::shared_ptr<Ort::Env> OnnxSessionPool::createEnv()
+{
+  if (mGlobalThreads > 0) {
+    LOGP(info, "Creating ONNX environment with a global pool of {} intra-op threads.", mGlobalThreads);
+    Ort::ThreadingOptions threadingOptions;
+    threadingOptions.SetGlobalIntraOpNumThreads(mGlobalThreads);
+    threadingOptions.SetGlobalInterOpNumThreads(1);
+    return std::make_shared<Ort::Env>(threadingOptions, ORT_LOGGING_LEVEL_WARNING, "onnx-model");
+  }
+  return std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "onnx-model");
+}
+
+std::shared_ptr<Ort::Env> OnnxSessionPool::getEnv()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (!mEnv) {
+    mEnv = createEnv();
+  }
+  return mEnv;
+}
+
+std::string OnnxSessionPool::hashFile(const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return path;
+  }
+  std::string content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  return std::to_string(std::hash<std::string>{}(content)) + "_" + std::to_string(content.size());
+}
+
+std::shared_ptr<Ort::Experimental::Session> OnnxSessionPool::getSession(const std::string& path, Ort::SessionOptions& options, const std::string& optionsKey, uint64_t from, uint64_t until)
+{
+  const std::string key = fmt::format("{}:{}:{}:{}", hashFile(path), optionsKey, from, until);
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (!mEnv) {
+    mEnv = createEnv();
+  }
+  auto found = mSessions.find(key);
+  if (found != mSessions.end()) {
+    if (auto session = found->second.lock()) {
+      LOGP(info, "Reusing ONNX session of identical model ({}).", path);
+      return session;
+    }
+  }
+  auto session = std::make_shared<Ort::Experimental::Session>(*mEnv, path, options);
+  mSessions[key] = session;
+  return session;
+}
+
+std::size_t OnnxSessionPool::getNSessions()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  std::size_t nSessions{0};
+  for (const auto& [key, session] : mSessions) {
+    if (!session.expired()) {
+      ++nSessions;
+    }
+  }
+  return nSessions;
+}
+
 std::string OnnxModel::printShape(const std::vector<int64_t>& v)
 {
   std::stringstream ss("");
@@ -55,6 +143,52 @@ bool OnnxModel::checkHyperloop(bool verbose)
   return alienCoresFound;
 }
 
+void OnnxModel::setExecutionProvider(const std::string& provider, int deviceId)
+{
+  std::string name = provider;
+  std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+  if (name == "cuda") {
+    setExecutionProvider(ExecutionProvider::CUDA, deviceId);
+  } else if (name == "rocm") {
+    setExecutionProvider(ExecutionProvider::ROCM, deviceId);
+  } else {
+    if (name != "cpu") {
+      LOGP(warning, "Unknown ONNX execution provider \"{}\", using CPU.", provider);
+    }
+    setExecutionProvider(ExecutionProvider::CPU, deviceId);
+  }
+}
+
+ExecutionProvider OnnxModel::appendExecutionProvider()
+{
+  if (mRequestedProvider == ExecutionProvider::CPU) {
+    return ExecutionProvider::CPU;
+  }
+  const bool isCuda = (mRequestedProvider == ExecutionProvider::CUDA);
+  const std::string providerName = isCuda ? "CUDAExecutionProvider" : "ROCMExecutionProvider";
+  const auto availableProviders = Ort::GetAvailableProviders();
+  if (std::find(availableProviders.begin(), availableProviders.end(), providerName) == availableProviders.end()) {
+    LOGP(warning, "{} not available in this ONNX runtime build, falling back to CPU.", providerName);
+    return ExecutionProvider::CPU;
+  }
+  try {
+    if (isCuda) {
+      OrtCUDAProviderOptions cudaOptions{};
+      cudaOptions.device_id = mDeviceId;
+      sessionOptions.AppendExecutionProvider_CUDA(cudaOptions);
+    } else {
+      OrtROCMProviderOptions rocmOptions{};
+      rocmOptions.device_id = mDeviceId;
+      sessionOptions.AppendExecutionProvider_ROCM(rocmOptions);
+    }
+  } catch (const Ort::Exception& exception) {
+    LOGP(warning, "Cannot initialise {} on device {} ({}), falling back to CPU.", providerName, mDeviceId, exception.what());
+    return ExecutionProvider::CPU;
+  }
+  LOGP(info, "Using {} on device {}.", providerName, mDeviceId);
+  return mRequestedProvider;
+}
+
 void OnnxModel::initModel(std::string localPath, bool enableOptimizations, int threads, uint64_t from, uint64_t until)
 {
 
@@ -64,8 +198,14 @@ void OnnxModel::initModel(std::string localPath, bool enableOptimizations, int t
   modelPath = localPath;
   activeThreads = threads;
 
-  /// Running on Hyperloop
-  if (!checkHyperloop(true)) {
+  auto& sessionPool = OnnxSessionPool::instance();
+
+  /// Global thread pool shared by all sessions, otherwise check if running on Hyperloop
+  if (sessionPool.getGlobalThreadBudget() > 0) {
+    LOGP(info, "Using the global ONNX thread pool ({} threads), ignoring per-model threads.", sessionPool.getGlobalThreadBudget());
+    sessionOptions.DisablePerSessionThreads();
+    activeThreads = 0;
+  } else if (!checkHyperloop(true)) {
     sessionOptions.SetIntraOpNumThreads(activeThreads);
   }
 
@@ -74,8 +214,11 @@ void OnnxModel::initModel(std::string localPath, bool enableOptimizations, int t
     sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
   }
 
-  mEnv = std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "onnx-model");
-  mSession = std::make_shared<Ort::Experimental::Session>(*mEnv, modelPath, sessionOptions);
+  /// Execution provider, the CPU one is always appended by the runtime as fallback for unsupported nodes
+  mProvider = appendExecutionProvider();
+
+  mEnv = sessionPool.getEnv();
+  mSession = sessionPool.getSession(modelPath, sessionOptions, fmt::format("{}:{}:{}:{}", enableOptimizations, activeThreads, static_cast<int>(mProvider), mDeviceId), from, until);
 
   mInputNames = mSession->GetInputNames();
   mInputShapes = mSession->GetInputShapes();
@@ -102,6 +245,10 @@ void OnnxModel::initModel(std::string localPath, bool enableOptimizations, int t
 
 void OnnxModel::setActiveThreads(int threads)
 {
+  if (OnnxSessionPool::instance().getGlobalThreadBudget() > 0) {
+    LOGP(warning, "Global ONNX thread pool in use, ignoring setActiveThreads({}).", threads);
+    return;
+  }
   activeThreads = threads;
   if (!checkHyperloop(false)) {
     sessionOptions.SetIntraOpNumThreads(activeThreads);
@@ -26,6 +26,8 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <chrono>
+#include <mutex>
 
 // ROOT includes
 #include "TSystem.h"
@@ -39,6 +41,42 @@ namespace o2
 namespace ml
 {
 
+/// Process-wide pool of ONNX sessions
+/// All the models share one Ort::Env and identical models (same file content, session options and validity)
+/// share one session. If a global thread budget is set, the sessions use the global thread pool of the Ort::Env
+/// instead of owning their own threads.
+class OnnxSessionPool
+{
+ public:
+  static OnnxSessionPool& instance();
+
+  /// Set the total number of intra-op threads shared by all the sessions, to be called before the first model is initialised
+  void setGlobalThreadBudget(int);
+  int getGlobalThreadBudget() const { return mGlobalThreads; }
+
+  std::shared_ptr<Ort::Env> getEnv();
+  std::shared_ptr<Ort::Experimental::Session> getSession(const std::string&, Ort::SessionOptions&, const std::string&, uint64_t, uint64_t);
+  std::size_t getNSessions();
+
+ private:
+  OnnxSessionPool() = default;
+
+  std::mutex mMutex;
+  std::shared_ptr<Ort::Env> mEnv = nullptr;
+  int mGlobalThreads = 0;
+  std::map<std::string, std::weak_ptr<Ort::Experimental::Session>> mSessions; // sessions keyed by model hash, options and validity
+
+  std::shared_ptr<Ort::Env> createEnv();
+  static std::string hashFile(const std::string&);
+};
+
+/// Execution providers which can be requested for a model, the CPU one being the fallback
+enum class ExecutionProvider : int {
+  CPU = 0,
+  CUDA,
+  ROCM
+};
+
 class OnnxModel
 {
 
@@ -49,6 +87,17 @@ class OnnxModel
   // Inferencing
   void initModel(std::string, bool = false, int = 0, uint64_t = 0, uint64_t = 0);
 
+  /// Request an execution provider for the session, to be called before initModel
+  /// If the provider is not available in the ONNX runtime build or cannot be initialised, the model runs on CPU
+  /// \param provider is the name of the provider ("cpu", "cuda" or "rocm", case insensitive)
+  /// \param deviceId is the index of the GPU device
+  void setExecutionProvider(const std::string&, int = 0);
+  void setExecutionProvider(ExecutionProvider provider, int deviceId = 0)
+  {
+    mRequestedProvider = provider;
+    mDeviceId = deviceId;
+  }
+
   // template methods -- best to define them in header
   template <typename T>
   T* evalModel(std::vector<Ort::Value>& input)
@@ -57,7 +106,11 @@ class OnnxModel
     // assert(input[0].GetTensorTypeAndShapeInfo().GetShape() == getNumInputNodes()); --> Fails build in debug mode, TODO: assertion should be checked somehow
 
     try {
+      auto start = std::chrono::steady_clock::now();
       auto outputTensors = mSession->Run(mInputNames, input, mOutputNames);
+      mInferenceTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      mNInferenceCalls++;
+      mNInferenceRows += input[0].GetTensorTypeAndShapeInfo().GetShape()[0];
       LOG(debug) << "Number of output tensors: " << outputTensors.size();
       if (outputTensors.size() != mOutputNames.size()) {
         LOG(fatal) << "Number of output tensors: " << outputTensors.size() << " does not agree with the model specified size: " << mOutputNames.size();
@@ -88,6 +141,47 @@ class OnnxModel
     return evalModel<T>(inputTensors);
   }
 
+  /// Batched inference: evaluate nRows rows of row-major input features with a single session call
+  /// \param input pointer to nRows * getNumInputNodes() contiguous values (not copied)
+  /// \param nRows number of rows to evaluate
+  /// \param output container filled with the scores of the last output node, row after row; its capacity is reused between calls
+  /// \return number of scores per row (0 in case of failure)
+  template <typename T>
+  int64_t evalModelBatch(T* input, int64_t nRows, std::vector<T>& output)
+  {
+    output.clear();
+    if (nRows <= 0) {
+      return 0;
+    }
+    const int64_t nFeatures = mInputShapes[0][1];
+    mBatchInputShape[0] = nRows;
+    mBatchInputShape[1] = nFeatures;
+    mBatchInputTensors.clear();
+    mBatchInputTensors.emplace_back(Ort::Experimental::Value::CreateTensor<T>(input, nRows * nFeatures, mBatchInputShape));
+
+    try {
+      auto start = std::chrono::steady_clock::now();
+      auto outputTensors = mSession->Run(mInputNames, mBatchInputTensors, mOutputNames);
+      mInferenceTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      mNInferenceCalls++;
+      mNInferenceRows += nRows;
+      if (outputTensors.size() != mOutputNames.size()) {
+        LOG(fatal) << "Number of output tensors: " << outputTensors.size() << " does not agree with the model specified size: " << mOutputNames.size();
+      }
+      auto outputInfo = outputTensors.back().GetTensorTypeAndShapeInfo();
+      const int64_t nValues = outputInfo.GetElementCount();
+      if (nValues % nRows != 0) {
+        LOG(fatal) << "Output tensor shape " << printShape(outputInfo.GetShape()) << " not compatible with batch size " << nRows;
+      }
+      const T* outputValues = outputTensors.back().GetTensorMutableData<T>();
+      output.assign(outputValues, outputValues + nValues);
+      return nValues / nRows;
+    } catch (const Ort::Exception& exception) {
+      LOG(error) << "Error running batched model inference: " << exception.what();
+    }
+    return 0;
+  }
+
   // Reset session
   void resetSession() { mSession.reset(new Ort::Experimental::Session{*mEnv, modelPath, sessionOptions}); }
 
@@ -98,8 +192,21 @@ class OnnxModel
   int getNumOutputNodes() const { return mOutputShapes[0][1]; }
   uint64_t getValidityFrom() const { return validFrom; }
   uint64_t getValidityUntil() const { return validUntil; }
+  ExecutionProvider getExecutionProvider() const { return mProvider; } // provider used by the session, after the fallback
+  int getDeviceId() const { return mDeviceId; }
   void setActiveThreads(int);
 
+  // Inference timing counters
+  double getInferenceTime() const { return mInferenceTime; } // total time spent in session Run calls (s)
+  uint64_t getNInferenceCalls() const { return mNInferenceCalls; }
+  uint64_t getNInferenceRows() const { return mNInferenceRows; }
+  void resetInferenceCounters()
+  {
+    mInferenceTime = 0.;
+    mNInferenceCalls = 0;
+    mNInferenceRows = 0;
+  }
+
  private:
   // Environment variables for the ONNX runtime
   std::shared_ptr<Ort::Env> mEnv = nullptr;
@@ -112,15 +219,28 @@ class OnnxModel
   std::vector<std::string> mOutputNames;
   std::vector<std::vector<int64_t>> mOutputShapes;
 
+  // Buffers reused by the batched inference
+  std::vector<int64_t> mBatchInputShape{0, 0};
+  std::vector<Ort::Value> mBatchInputTensors;
+
+  // Inference timing counters
+  double mInferenceTime = 0.;
+  uint64_t mNInferenceCalls = 0;
+  uint64_t mNInferenceRows = 0;
+
   // Environment settings
   std::string modelPath;
   int activeThreads = 0;
   uint64_t validFrom = 0;
   uint64_t validUntil = 0;
+  ExecutionProvider mRequestedProvider = ExecutionProvider::CPU;
+  ExecutionProvider mProvider = ExecutionProvider::CPU;
+  int mDeviceId = 0;
 
   // Internal function for printing the shape of tensors
   std::string printShape(const std::vector<int64_t>&);
   bool checkHyperloop(bool = true);
+  ExecutionProvider appendExecutionProvider();
 };
 
 } // namespace ml
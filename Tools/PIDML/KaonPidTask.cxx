@@ -14,6 +14,7 @@
 
 #include <cmath>
 #include <memory>
+#include <vector>
 #include "Framework/AnalysisTask.h"
 #include "Framework/runDataProcessing.h"
 #include "Common/DataModel/EventSelection.h"
@@ -93,41 +94,57 @@ struct KaonPidTask {
     histos.add("hdEdXvsMomentum", ";P_{K^{+}K^{-}}; dE/dx in TPC (keV/cm)", kTH2F, {{100, 0., 4.}, {200, 20., 400.}});
   }
 
+  std::vector<float> certaintiesPositive; // model certainties of the positive tracks of the collision
+  std::vector<float> certaintiesNegative; // model certainties of the negative tracks of the collision
+
   void process(MyFilteredCollision const& coll, o2::aod::MyTracks const& tracks)
   {
     auto groupPositive = positive->sliceByCached(aod::track::collisionId, coll.globalIndex(), cache);
     auto groupNegative = negative->sliceByCached(aod::track::collisionId, coll.globalIndex(), cache);
+
+    // the model is evaluated once per track, and not again for each pair
+    pidModel->applyModelBatch(groupPositive, certaintiesPositive);
+    pidModel->applyModelBatch(groupNegative, certaintiesNegative);
+
+    size_t iPos = 0;
     for (auto track : groupPositive) {
       histos.fill(HIST("hChargePos"), track.sign());
-      if (pidModel.get()->applyModelBoolean(track)) {
+      if (certaintiesPositive[iPos++] >= pidModel->mMinCertainty) {
         histos.fill(HIST("hdEdXvsMomentum"), track.p(), track.tpcSignal());
       }
     }
 
+    size_t iNeg = 0;
     for (auto track : groupNegative) {
       histos.fill(HIST("hChargeNeg"), track.sign());
-      if (pidModel.get()->applyModelBoolean(track)) {
+      if (certaintiesNegative[iNeg++] >= pidModel->mMinCertainty) {
         histos.fill(HIST("hdEdXvsMomentum"), track.p(), track.tpcSignal());
       }
     }
 
-    for (auto& [pos, neg] : combinations(soa::CombinationsFullIndexPolicy(groupPositive, groupNegative))) {
-      if (!(pidModel.get()->applyModelBoolean(pos)) || !(pidModel.get()->applyModelBoolean(neg))) {
+    const float mass = TDatabasePDG::Instance()->GetParticle(cfgPid.value)->Mass();
+    iPos = 0;
+    for (auto const& pos : groupPositive) {
+      if (certaintiesPositive[iPos++] < pidModel->mMinCertainty) {
         continue;
       }
+      iNeg = 0;
+      for (auto const& neg : groupNegative) {
+        if (certaintiesNegative[iNeg++] < pidModel->mMinCertainty) {
+          continue;
+        }
 
-      TLorentzVector part1Vec;
-      TLorentzVector part2Vec;
-      float mMassOne = TDatabasePDG::Instance()->GetParticle(cfgPid.value)->Mass();
-      float mMassTwo = TDatabasePDG::Instance()->GetParticle(cfgPid.value)->Mass();
+        TLorentzVector part1Vec;
+        TLorentzVector part2Vec;
 
-      part1Vec.SetPtEtaPhiM(pos.pt(), pos.eta(), pos.phi(), mMassOne);
-      part2Vec.SetPtEtaPhiM(neg.pt(), neg.eta(), neg.phi(), mMassTwo);
+        part1Vec.SetPtEtaPhiM(pos.pt(), pos.eta(), pos.phi(), mass);
+        part2Vec.SetPtEtaPhiM(neg.pt(), neg.eta(), neg.phi(), mass);
 
-      TLorentzVector sumVec(part1Vec);
-      sumVec += part2Vec;
+        TLorentzVector sumVec(part1Vec);
+        sumVec += part2Vec;
 
-      histos.fill(HIST("hInvariantMass"), sumVec.M());
+        histos.fill(HIST("hInvariantMass"), sumVec.M());
+      }
     }
   }
 };
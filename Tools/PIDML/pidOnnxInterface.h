@@ -112,7 +112,76 @@ struct PidONNXInterface {
     return false;
   }
 
+  /// Evaluates the models of all the pids on all the tracks of a table. The inputs of a track depend
+  /// only on the detector configuration: they are scaled once per configuration and shared by the models of all the pids.
+  /// \param tracks table of the tracks
+  /// \param certainties filled with one vector per pid, in the order of the pids, holding the certainty of each track
+  ///        in the order of the table, -1 if no model of the pid applies to the track pT
+  template <typename T>
+  void applyModelBatch(const T& tracks, std::vector<std::vector<float>>& certainties)
+  {
+    const std::size_t nTracks = tracks.size();
+    certainties.resize(mNPids);
+    for (auto& pidCertainties : certainties) {
+      pidCertainties.assign(nTracks, -1.0f);
+    }
+    for (uint32_t j = 0; j < kNDetectors; j++) {
+      // inputs of the tracks evaluated by the models of this detector configuration for at least one pid
+      auto& inputModel = mModels[j];
+      const int64_t nInputs = inputModel.getNInputs();
+      mBatchRows.clear();
+      mBatchPts.clear();
+      std::size_t iTrack = 0;
+      for (const auto& track : tracks) {
+        for (std::size_t i = 0; i < mNPids; i++) {
+          if (isInPtRange(i, j, track.pt())) {
+            mBatchRows.push_back(iTrack);
+            mBatchPts.push_back(track.pt());
+            mBatchInputs.resize(mBatchRows.size() * nInputs);
+            inputModel.fillInputs(track, mBatchInputs.data() + (mBatchRows.size() - 1) * nInputs);
+            break;
+          }
+        }
+        iTrack++;
+      }
+      if (mBatchRows.empty()) {
+        continue;
+      }
+      for (std::size_t i = 0; i < mNPids; i++) {
+        mModels[i * kNDetectors + j].applyModelOnInputs(mBatchInputs.data(), mBatchRows.size(), mBatchCertainties);
+        for (std::size_t row = 0; row < mBatchRows.size(); row++) {
+          if (isInPtRange(i, j, mBatchPts[row])) {
+            certainties[i][mBatchRows[row]] = mBatchCertainties[row];
+          }
+        }
+      }
+    }
+  }
+
+  /// \return the index of the pid in the certainties of applyModelBatch, -1 if the pid is not predicted
+  int getPidIndex(int pid) const
+  {
+    for (std::size_t i = 0; i < mNPids; i++) {
+      if (mModels[i * kNDetectors].mPid == pid) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /// \return whether a certainty from applyModelBatch passes the min certainty of the pid with index iPid
+  bool isAccepted(std::size_t iPid, float certainty) const
+  {
+    return certainty >= mModels[iPid * kNDetectors].mMinCertainty;
+  }
+
  private:
+  /// \return whether the model of detector configuration j is the one used for pid i at this pT
+  bool isInPtRange(std::size_t i, uint32_t j, float pt)
+  {
+    return pt >= mPTLimits[i][j] && (j == kNDetectors - 1 || pt < mPTLimits[i][j + 1]);
+  }
+
   void fillDefaultConfiguration(std::vector<double>& minCertainties)
   {
     // FIXME: A more sophisticated strategy should be based on pid values as well
@@ -123,5 +192,10 @@ struct PidONNXInterface {
   std::vector<PidONNXModel> mModels;
   std::size_t mNPids;
   o2::framework::LabeledArray<double> mPTLimits;
+
+  std::vector<std::size_t> mBatchRows;  // rows in the table of the tracks of the batch
+  std::vector<float> mBatchPts;         // pT of the tracks of the batch
+  std::vector<float> mBatchInputs;      // inputs of the tracks of the batch, shared by the models of all the pids
+  std::vector<float> mBatchCertainties; // certainties of the tracks of the batch for one model
 };
 #endif // TOOLS_PIDML_PIDONNXINTERFACE_H_
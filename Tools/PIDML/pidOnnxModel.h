@@ -107,6 +107,88 @@ struct PidONNXModel {
     return getModelOutput(track) >= mMinCertainty;
   }
 
+  /// Evaluates the model on all the tracks of a table, with one inference per chunk of tracks
+  /// if the model accepts a variable batch size, one per track otherwise
+  /// \param tracks table of the tracks
+  /// \param certainties filled with the certainty of each track, in the order of the table
+  /// \param maxBatchSize maximum number of tracks evaluated in one inference
+  template <typename T>
+  void applyModelBatch(const T& tracks, std::vector<float>& certainties, int64_t maxBatchSize = 1024)
+  {
+    const int64_t nInputs = getNInputs();
+    const int64_t batchSize = mInputShapes[0][0] > 0 ? mInputShapes[0][0] : maxBatchSize;
+    certainties.clear();
+    certainties.reserve(tracks.size());
+    mInputBuffer.resize(batchSize * nInputs);
+    int64_t nRows = 0;
+    for (const auto& track : tracks) {
+      fillInputs(track, mInputBuffer.data() + nRows * nInputs);
+      if (++nRows == batchSize) {
+        runModel(mInputBuffer.data(), nRows, certainties);
+        nRows = 0;
+      }
+    }
+    if (nRows > 0) {
+      runModel(mInputBuffer.data(), nRows, certainties);
+    }
+  }
+
+  /// Evaluates the model on inputs already filled with fillInputs, e.g. shared by the models
+  /// of several pids with the same detector configuration
+  /// \param inputs row-major inputs, getNInputs() values per track
+  /// \param nRows number of tracks
+  /// \param certainties filled with the certainty of each track
+  /// \param maxBatchSize maximum number of tracks evaluated in one inference
+  void applyModelOnInputs(float* inputs, int64_t nRows, std::vector<float>& certainties, int64_t maxBatchSize = 1024)
+  {
+    const int64_t nInputs = getNInputs();
+    const int64_t batchSize = mInputShapes[0][0] > 0 ? mInputShapes[0][0] : maxBatchSize;
+    certainties.clear();
+    certainties.reserve(nRows);
+    for (int64_t firstRow = 0; firstRow < nRows; firstRow += batchSize) {
+      runModel(inputs + firstRow * nInputs, std::min(batchSize, nRows - firstRow), certainties);
+    }
+  }
+
+  /// \return the number of inputs of the model for the detector configuration
+  int64_t getNInputs() const
+  {
+    return 14 + (mDetector >= kTPCTOF ? 2 : 0) + (mDetector >= kTPCTOFTRD ? 2 : 0);
+  }
+
+  /// Writes the scaled inputs of the model for a track
+  /// \param inputs row of getNInputs() values in the input buffer
+  template <typename T>
+  void fillInputs(const T& track, float* inputs)
+  {
+    // TODO: Hardcoded for now. Planning to implement RowView extension to get runtime access to selected columns
+    // sign is short, trackType and tpcNClsShared uint8_t
+    inputs[0] = track.px();
+    inputs[1] = track.py();
+    inputs[2] = track.pz();
+    inputs[3] = static_cast<float>(track.sign());
+    inputs[4] = scale(kX, track.x());
+    inputs[5] = scale(kY, track.y());
+    inputs[6] = scale(kZ, track.z());
+    inputs[7] = scale(kAlpha, track.alpha());
+    inputs[8] = static_cast<float>(track.trackType());
+    inputs[9] = scale(kTPCNClsShared, static_cast<float>(track.tpcNClsShared()));
+    inputs[10] = scale(kDcaXY, track.dcaXY());
+    inputs[11] = scale(kDcaZ, track.dcaZ());
+    inputs[12] = track.p();
+    inputs[13] = scale(kTPCSignal, track.tpcSignal());
+
+    if (mDetector >= kTPCTOF) {
+      inputs[14] = scale(kTOFSignal, track.tofSignal());
+      inputs[15] = scale(kBeta, track.beta());
+    }
+
+    if (mDetector >= kTPCTOFTRD) {
+      inputs[16] = scale(kTRDSignal, track.trdSignal());
+      inputs[17] = scale(kTRDPattern, track.trdPattern());
+    }
+  }
+
   PidMLDetector mDetector;
   int mPid;
   double mMinCertainty;
@@ -177,40 +259,22 @@ struct PidONNXModel {
         mScalingParams[param[0].GetString()] = std::make_pair(param[1].GetFloat(), param[2].GetFloat());
       }
     }
-  }
-
-  template <typename T>
-  std::vector<float> createInputsSingle(const T& track)
-  {
-    // TODO: Hardcoded for now. Planning to implement RowView extension to get runtime access to selected columns
-    // sign is short, trackType and tpcNClsShared uint8_t
-    float scaledX = (track.x() - mScalingParams.at("fX").first) / mScalingParams.at("fX").second;
-    float scaledY = (track.y() - mScalingParams.at("fY").first) / mScalingParams.at("fY").second;
-    float scaledZ = (track.z() - mScalingParams.at("fZ").first) / mScalingParams.at("fZ").second;
-    float scaledAlpha = (track.alpha() - mScalingParams.at("fAlpha").first) / mScalingParams.at("fAlpha").second;
-    float scaledTPCNClsShared = (static_cast<float>(track.tpcNClsShared()) - mScalingParams.at("fTPCNClsShared").first) / mScalingParams.at("fTPCNClsShared").second;
-    float scaledDcaXY = (track.dcaXY() - mScalingParams.at("fDcaXY").first) / mScalingParams.at("fDcaXY").second;
-    float scaledDcaZ = (track.dcaZ() - mScalingParams.at("fDcaZ").first) / mScalingParams.at("fDcaZ").second;
-
-    float scaledTPCSignal = (track.tpcSignal() - mScalingParams.at("fTPCSignal").first) / mScalingParams.at("fTPCSignal").second;
 
-    std::vector<float> inputValues{track.px(), track.py(), track.pz(), static_cast<float>(track.sign()), scaledX, scaledY, scaledZ, scaledAlpha, static_cast<float>(track.trackType()), scaledTPCNClsShared, scaledDcaXY, scaledDcaZ, track.p(), scaledTPCSignal};
-
-    if (mDetector >= kTPCTOF) {
-      float scaledTOFSignal = (track.tofSignal() - mScalingParams.at("fTOFSignal").first) / mScalingParams.at("fTOFSignal").second;
-      float scaledBeta = (track.beta() - mScalingParams.at("fBeta").first) / mScalingParams.at("fBeta").second;
-      inputValues.push_back(scaledTOFSignal);
-      inputValues.push_back(scaledBeta);
-    }
-
-    if (mDetector >= kTPCTOFTRD) {
-      float scaledTRDSignal = (track.trdSignal() - mScalingParams.at("fTRDSignal").first) / mScalingParams.at("fTRDSignal").second;
-      float scaledTRDPattern = (track.trdPattern() - mScalingParams.at("fTRDPattern").first) / mScalingParams.at("fTRDPattern").second;
-      inputValues.push_back(scaledTRDSignal);
-      inputValues.push_back(scaledTRDPattern);
+    // bake the scaling parameters of the inputs used by the detector configuration into arrays
+    const int nScaledInputs = mDetector >= kTPCTOFTRD ? kNScaledInputs : (mDetector >= kTPCTOF ? kTRDSignal : kTOFSignal);
+    for (int i = 0; i < nScaledInputs; i++) {
+      auto param = mScalingParams.find(kScaledInputNames[i]);
+      if (param == mScalingParams.end()) {
+        LOG(fatal) << "Missing scaling parameters of " << kScaledInputNames[i] << " in " << localScalingParamsPath;
+      }
+      mScalingMean[i] = param->second.first;
+      mScalingScale[i] = param->second.second;
     }
+  }
 
-    return inputValues;
+  float scale(int input, float value) const
+  {
+    return (value - mScalingMean[input]) / mScalingScale[input];
   }
 
   // FIXME: Temporary solution, new networks will have sigmoid layer added
@@ -220,34 +284,41 @@ struct PidONNXModel {
     return 1.0f / (1.0f + std::exp(-value));
   }
 
-  template <typename T>
-  float getModelOutput(const T& track)
+  /// Runs the model on nRows rows of inputs and appends their certainties
+  void runModel(float* inputs, int64_t nRows, std::vector<float>& certainties)
   {
-    auto input_shape = mInputShapes[0];
-    std::vector<float> inputTensorValues = createInputsSingle(track);
+    auto inputShape = mInputShapes[0];
+    inputShape[0] = nRows;
     std::vector<Ort::Value> inputTensors;
-    inputTensors.emplace_back(Ort::Experimental::Value::CreateTensor<float>(inputTensorValues.data(), inputTensorValues.size(), input_shape));
-
-    // Double-check the dimensions of the input tensor
-    assert(inputTensors[0].IsTensor() &&
-           inputTensors[0].GetTensorTypeAndShapeInfo().GetShape() == input_shape);
+    inputTensors.emplace_back(Ort::Experimental::Value::CreateTensor<float>(inputs, nRows * getNInputs(), inputShape));
     LOG(debug) << "input tensor shape: " << printShape(inputTensors[0].GetTensorTypeAndShapeInfo().GetShape());
 
     try {
       auto outputTensors = mSession->Run(mInputNames, inputTensors, mOutputNames);
 
-      // Double-check the dimensions of the output tensors
       // The number of output tensors is equal to the number of output nodes specified in the Run() call
       assert(outputTensors.size() == mOutputNames.size() && outputTensors[0].IsTensor());
       LOG(debug) << "output tensor shape: " << printShape(outputTensors[0].GetTensorTypeAndShapeInfo().GetShape());
 
-      const float* output_value = outputTensors[0].GetTensorData<float>();
-      float certainty = sigmoid(*output_value); // FIXME: Temporary, sigmoid will be added as network layer
-      return certainty;
+      const float* outputValues = outputTensors[0].GetTensorData<float>();
+      for (int64_t i = 0; i < nRows; i++) {
+        certainties.push_back(sigmoid(outputValues[i])); // FIXME: Temporary, sigmoid will be added as network layer
+      }
+      return;
     } catch (const Ort::Exception& exception) {
       LOG(error) << "Error running model inference: " << exception.what();
     }
-    return false; // unreachable code
+    certainties.resize(certainties.size() + nRows, 0.f);
+  }
+
+  template <typename T>
+  float getModelOutput(const T& track)
+  {
+    mInputBuffer.resize(getNInputs());
+    fillInputs(track, mInputBuffer.data());
+    mCertainties.clear();
+    runModel(mInputBuffer.data(), 1, mCertainties);
+    return mCertainties[0];
   }
 
   // Pretty prints a shape dimension vector
@@ -260,8 +331,31 @@ struct PidONNXModel {
     return ss.str();
   }
 
+  // inputs scaled with the parameters of scaling_params
+  enum ScaledInput {
+    kX = 0,
+    kY,
+    kZ,
+    kAlpha,
+    kTPCNClsShared,
+    kDcaXY,
+    kDcaZ,
+    kTPCSignal,
+    kTOFSignal,
+    kBeta,
+    kTRDSignal,
+    kTRDPattern,
+    kNScaledInputs
+  };
+  static constexpr const char* kScaledInputNames[kNScaledInputs] = {"fX", "fY", "fZ", "fAlpha", "fTPCNClsShared", "fDcaXY", "fDcaZ", "fTPCSignal", "fTOFSignal", "fBeta", "fTRDSignal", "fTRDPattern"};
+
   std::vector<std::string> mTrainColumns;
   std::map<std::string, std::pair<float, float>> mScalingParams;
+  float mScalingMean[kNScaledInputs] = {0.f};  // mean of each scaled input
+  float mScalingScale[kNScaledInputs] = {0.f}; // scale of each scaled input
+
+  std::vector<float> mInputBuffer; // row-major inputs of the tracks evaluated in one inference
+  std::vector<float> mCertainties; // output of the single-track evaluation
 
   std::shared_ptr<Ort::Env> mEnv = nullptr;
   // No empty constructors for Session, we need a pointer
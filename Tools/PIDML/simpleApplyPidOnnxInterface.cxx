@@ -22,6 +22,7 @@
 #include "Tools/PIDML/pidOnnxInterface.h"
 
 #include <string>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -56,6 +57,7 @@ struct SimpleApplyOnnxInterface {
 
   o2::ccdb::CcdbApi ccdbApi;
   int currentRunNumber = -1;
+  std::vector<std::vector<float>> certainties; // certainties of the tracks of the data frame for each pid
 
   Produces<o2::aod::MlPidResults> pidMLResults;
 
@@ -80,28 +82,39 @@ struct SimpleApplyOnnxInterface {
     if (cfgUseCCDB && bc.runNumber() != currentRunNumber) {
       uint64_t timestamp = cfgUseFixedTimestamp ? cfgTimestamp.value : bc.timestamp();
       pidInterface = PidONNXInterface(cfgPathLocal.value, cfgPathCCDB.value, cfgUseCCDB.value, ccdbApi, timestamp, cfgPids.value, cfgPTCuts.value, cfgCertainties.value, cfgAutoMode.value);
+      currentRunNumber = bc.runNumber();
     }
 
+    pidInterface.applyModelBatch(tracks, certainties);
+    pidMLResults.reserve(tracks.size() * cfgPids->size());
+    size_t iTrack = 0;
     for (auto& track : tracks) {
-      for (int pid : cfgPids.value) {
-        bool accepted = pidInterface.applyModelBoolean(track, pid);
+      for (size_t iPid = 0; iPid < cfgPids->size(); iPid++) {
+        const int pid = cfgPids->at(iPid);
+        bool accepted = pidInterface.isAccepted(iPid, certainties[iPid][iTrack]);
         LOGF(info, "collision id: %d track id: %d pid: %d accepted: %d p: %.3f; x: %.3f, y: %.3f, z: %.3f",
              track.collisionId(), track.index(), pid, accepted, track.p(), track.x(), track.y(), track.z());
         pidMLResults(track.index(), pid, accepted);
       }
+      iTrack++;
     }
   }
   PROCESS_SWITCH(SimpleApplyOnnxInterface, processCollisions, "Process with collisions and bcs for CCDB", true);
 
   void processTracksOnly(BigTracks const& tracks)
   {
+    pidInterface.applyModelBatch(tracks, certainties);
+    pidMLResults.reserve(tracks.size() * cfgPids->size());
+    size_t iTrack = 0;
     for (auto& track : tracks) {
-      for (int pid : cfgPids.value) {
-        bool accepted = pidInterface.applyModelBoolean(track, pid);
+      for (size_t iPid = 0; iPid < cfgPids->size(); iPid++) {
+        const int pid = cfgPids->at(iPid);
+        bool accepted = pidInterface.isAccepted(iPid, certainties[iPid][iTrack]);
         LOGF(info, "collision id: %d track id: %d pid: %d accepted: %d p: %.3f; x: %.3f, y: %.3f, z: %.3f",
              track.collisionId(), track.index(), pid, accepted, track.p(), track.x(), track.y(), track.z());
         pidMLResults(track.index(), pid, accepted);
       }
+      iTrack++;
     }
   }
   PROCESS_SWITCH(SimpleApplyOnnxInterface, processTracksOnly, "Process with tracks only -- faster but no CCDB", false);
@@ -22,6 +22,7 @@
 #include "Tools/PIDML/pidOnnxModel.h"
 
 #include <string>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -54,6 +55,7 @@ struct SimpleApplyOnnxModel {
 
   o2::ccdb::CcdbApi ccdbApi;
   int currentRunNumber = -1;
+  std::vector<float> certainties; // certainties of the tracks of the data frame
 
   Produces<o2::aod::MlPidResults> pidMLResults;
 
@@ -78,10 +80,14 @@ struct SimpleApplyOnnxModel {
     if (cfgUseCCDB && bc.runNumber() != currentRunNumber) {
       uint64_t timestamp = cfgUseFixedTimestamp ? cfgTimestamp.value : bc.timestamp();
       pidModel = PidONNXModel(cfgPathLocal.value, cfgPathCCDB.value, cfgUseCCDB.value, ccdbApi, timestamp, cfgPid.value, static_cast<PidMLDetector>(cfgDetector.value), cfgCertainty.value);
+      currentRunNumber = bc.runNumber();
     }
 
+    pidModel.applyModelBatch(tracks, certainties);
+    pidMLResults.reserve(tracks.size());
+    size_t iTrack = 0;
     for (auto& track : tracks) {
-      bool accepted = pidModel.applyModelBoolean(track);
+      bool accepted = certainties[iTrack++] >= pidModel.mMinCertainty;
       LOGF(info, "collision id: %d track id: %d accepted: %d p: %.3f; x: %.3f, y: %.3f, z: %.3f",
            track.collisionId(), track.index(), accepted, track.p(), track.x(), track.y(), track.z());
       pidMLResults(track.index(), cfgPid.value, accepted);
@@ -91,8 +97,11 @@ struct SimpleApplyOnnxModel {
 
   void processTracksOnly(BigTracks const& tracks)
   {
+    pidModel.applyModelBatch(tracks, certainties);
+    pidMLResults.reserve(tracks.size());
+    size_t iTrack = 0;
     for (auto& track : tracks) {
-      bool accepted = pidModel.applyModelBoolean(track);
+      bool accepted = certainties[iTrack++] >= pidModel.mMinCertainty;
       LOGF(info, "collision id: %d track id: %d accepted: %d p: %.3f; x: %.3f, y: %.3f, z: %.3f",
            track.collisionId(), track.index(), accepted, track.p(), track.x(), track.y(), track.z());
       pidMLResults(track.index(), cfgPid.value, accepted);